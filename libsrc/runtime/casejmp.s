@@ -0,0 +1,68 @@
+;
+; The cc65 Authors, 17.10.2026
+;
+; CC65 runtime: Jump table dispatch for switch statements
+;
+; The compiler uses this routine for large switch statements when optimizing
+; for size. On entry, Y contains the value to switch on, and AX points to a
+; table with the following layout:
+;
+;       .byte   lowest case value
+;       .byte   number of entries - 1
+;       .addr   default label
+;       .lobytes labels
+;       .hibytes labels
+;
+
+        .export         casejmp
+        .importzp       ptr1, ptr2
+
+casejmp:
+        sta     ptr1
+        stx     ptr1+1          ; Save the table address
+        tya
+        ldy     #0
+        sec
+        sbc     (ptr1),y        ; Make the value zero based
+        iny
+        cmp     (ptr1),y        ; Compare against the last entry
+        beq     @L1
+        bcs     @L3             ; Jump if out of range
+
+; Get the low byte of the target. ptr2 is the address of the entry
+
+@L1:    clc
+        adc     ptr1
+        sta     ptr2
+        lda     ptr1+1
+        adc     #0
+        sta     ptr2+1
+        ldy     #4
+        lda     (ptr2),y
+        tax
+
+; The high byte is located one table size after the low byte
+
+        ldy     #1
+        lda     (ptr1),y
+        sec
+        adc     ptr2
+        sta     ptr2
+        bcc     @L2
+        inc     ptr2+1
+@L2:    stx     ptr1
+        ldy     #4
+        lda     (ptr2),y
+        sta     ptr1+1
+        jmp     (ptr1)          ; Jump to the case label
+
+; Value not found, jump to the default label
+
+@L3:    ldy     #2
+        lda     (ptr1),y
+        tax
+        iny
+        lda     (ptr1),y
+        sta     ptr1+1
+        stx     ptr1
+        jmp     (ptr1)
@@ -37,6 +37,7 @@
 
 /* common */
 #include "hashfunc.h"
+#include "hashtab.h"
 #include "xmalloc.h"
 
 /* ar65 */
@@ -47,23 +48,82 @@
 
 
 
+/*****************************************************************************/
+/*                                 Forwards                                  */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key);
+/* Generate the hash over a key. */
+
+static const void* HT_GetKey (const void* Entry);
+/* Given a pointer to the user entry data, return a pointer to the key */
+
+static int HT_Compare (const void* Key1, const void* Key2);
+/* Compare two keys. */
+
+
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
 
 
 
-/* A hash table entry */
+/* A hash table entry. Modules exporting the same name are chained to the
+** entry of the first one.
+*/
 typedef struct HashEntry HashEntry;
 struct HashEntry {
-    HashEntry*          Next;           /* Next in list */
+    HashNode            Node;           /* Node in the hash table */
+    HashEntry*          Next;           /* Next module with the same name */
     const ObjData*      Module;         /* Pointer to object module */
     char                Name [1];       /* Name of identifier */
 };
 
+/* Hash table functions */
+static const HashFunctions HashFunc = {
+    HT_GenHash,
+    HT_GetKey,
+    HT_Compare
+};
+
 /* Hash table */
-#define HASHTAB_SIZE    4783
-static HashEntry*       HashTab [HASHTAB_SIZE];
+static HashTable        HashTab = STATIC_HASHTABLE_INITIALIZER (1024, &HashFunc);
+
+
+
+/*****************************************************************************/
+/*                           Hash table functions                            */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key)
+/* Generate the hash over a key. */
+{
+    return HashStr (Key);
+}
+
+
+
+static const void* HT_GetKey (const void* Entry)
+/* Given a pointer to the user entry data, return a pointer to the key */
+{
+    return ((const HashEntry*) Entry)->Name;
+}
+
+
+
+static int HT_Compare (const void* Key1, const void* Key2)
+/* Compare two keys. The function must return a value less than zero if
+** Key1 is smaller than Key2, zero if both are equal, and a value greater
+** than zero if Key1 is greater then Key2.
+*/
+{
+    return strcmp (Key1, Key2);
+}
 
 
 
@@ -83,6 +143,7 @@ static HashEntry* NewHashEntry (const char* Name, const ObjData* Module)
     HashEntry* H = xmalloc (sizeof (HashEntry) + Len);
 
     /* Initialize the fields and return it */
+    InitHashNode (&H->Node);
     H->Next     = 0;
     H->Module   = Module;
     memcpy (H->Name, Name, Len);
@@ -95,33 +156,25 @@ static HashEntry* NewHashEntry (const char* Name, const ObjData* Module)
 void ExpInsert (const char* Name, const ObjData* Module)
 /* Insert an exported identifier and check if it's already in the list */
 {
-    HashEntry* L;
-
-    /* Create a hash value for the given name */
-    unsigned HashVal = HashStr (Name) % HASHTAB_SIZE;
-
     /* Create a new hash entry */
     HashEntry* H = NewHashEntry (Name, Module);
 
-    /* Search through the list in that slot and print matching duplicates */
-    if (HashTab [HashVal] == 0) {
-        /* The slot is empty */
-        HashTab [HashVal] = H;
+    /* Search for the name. If it's not there, just add the entry */
+    HashEntry* L = HT_Find (&HashTab, Name);
+    if (L == 0) {
+        HT_Insert (&HashTab, H);
         return;
     }
-    L = HashTab [HashVal];
+
+    /* Print all duplicates and add the entry to the end of the chain */
     while (1) {
-        if (strcmp (L->Name, Name) == 0) {
-            /* Duplicate entry */
-            Warning ("External symbol '%s' in module '%s', library '%s', "
-                     "is duplicated in module '%s'",
-                     Name, L->Module->Name, LibName, Module->Name);
-        }
+        Warning ("External symbol '%s' in module '%s', library '%s', "
+                 "is duplicated in module '%s'",
+                 Name, L->Module->Name, LibName, Module->Name);
         if (L->Next == 0) {
             break;
-        } else {
-            L = L->Next;
         }
+        L = L->Next;
     }
     L->Next = H;
 }
@@ -133,17 +186,7 @@ const ObjData* ExpFind (const char* Name)
 ** return a pointer to the module, that exports the identifer.
 */
 {
-    /* Get a pointer to the list with the symbols hash value */
-    HashEntry* L = HashTab [HashStr (Name) % HASHTAB_SIZE];
-    while (L) {
-        /* Search through the list in that slot */
-        if (strcmp (L->Name, Name) == 0) {
-            /* Entry found */
-            return L->Module;
-        }
-        L = L->Next;
-    }
-
-    /* Not found */
-    return 0;
+    /* Search for the name */
+    const HashEntry* L = HT_Find (&HashTab, Name);
+    return L? L->Module : 0;
 }
@@ -34,6 +34,7 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
@@ -66,10 +67,24 @@
 const char*             LibName = 0;
 static char*            NewLibName = 0;
 
+/* Name of the temporary file a new library is built in. It is renamed to
+** the library name when the library is closed without errors.
+*/
+static char*            CreateName = 0;
+
 /* File descriptor for the library file */
 static FILE*            Lib = 0;
 static FILE*            NewLib = 0;
 
+/* True if the library is updated */
+static int              Update = 0;
+
+/* Position where new data is appended to the library */
+static unsigned long    AppendPos = 0;
+
+/* Number of bytes in the library that are no longer used */
+static unsigned long    FreeBytes = 0;
+
 /* The library header */
 static LibHeader        Header = {
     LIB_MAGIC,
@@ -98,7 +113,7 @@ static void ReadHeader (void)
         Error ("'%s' is not a valid library file", LibName);
     }
     Header.Version = Read16 (Lib);
-    if (Header.Version != LIB_VERSION) {
+    if (Header.Version < LIB_VERSION_MIN || Header.Version > LIB_VERSION) {
         Error ("Wrong data version in '%s'", LibName);
     }
     Header.Flags   = Read16 (Lib);
@@ -139,6 +154,11 @@ static void ReadIndex (void)
         ReadIndexEntry ();
     }
 
+    /* Newer versions remember the space no longer used */
+    if (Header.Version >= LIB_VERSION_FREEBYTES) {
+        FreeBytes = ReadVar (Lib);
+    }
+
     /* Read basic object file data from the actual entries */
     for (I = 0; I < CollCount (&ObjPool); ++I) {
 
@@ -158,52 +178,55 @@ static void ReadIndex (void)
 
 
 
-static void WriteHeader (void)
-/* Write the header to the library file */
+static void WriteHeader (FILE* F)
+/* Write the header to the given library file */
 {
     /* Seek to position zero */
-    fseek (NewLib, 0, SEEK_SET);
+    fseek (F, 0, SEEK_SET);
 
     /* Write the header fields */
-    Write32 (NewLib, Header.Magic);
-    Write16 (NewLib, Header.Version);
-    Write16 (NewLib, Header.Flags);
-    Write32 (NewLib, Header.IndexOffs);
+    Write32 (F, Header.Magic);
+    Write16 (F, Header.Version);
+    Write16 (F, Header.Flags);
+    Write32 (F, Header.IndexOffs);
 }
 
 
 
-static void WriteIndexEntry (const ObjData* O)
+static void WriteIndexEntry (FILE* F, const ObjData* O)
 /* Write one index entry */
 {
     /* Module name/flags/MTime/start/size */
-    WriteStr (NewLib, O->Name);
-    Write16  (NewLib, O->Flags & ~OBJ_HAVEDATA);
-    Write32  (NewLib, O->MTime);
-    Write32  (NewLib, O->Start);
-    Write32  (NewLib, O->Size);
+    WriteStr (F, O->Name);
+    Write16  (F, O->Flags);
+    Write32  (F, O->MTime);
+    Write32  (F, O->Start);
+    Write32  (F, O->Size);
 }
 
 
 
-static void WriteIndex (void)
-/* Write the index of a library file */
+static void WriteIndex (FILE* F)
+/* Write the index of a library file at the current file position */
 {
     unsigned I;
 
     /* Sync I/O in case the last operation was a read */
-    fseek (NewLib, 0, SEEK_CUR);
+    fseek (F, 0, SEEK_CUR);
 
     /* Remember the current offset in the header */
-    Header.IndexOffs = ftell (NewLib);
+    Header.IndexOffs = ftell (F);
 
     /* Write the object file count */
-    WriteVar (NewLib, CollCount (&ObjPool));
+    WriteVar (F, CollCount (&ObjPool));
 
     /* Write the object files */
     for (I = 0; I < CollCount (&ObjPool); ++I) {
-        WriteIndexEntry (CollConstAt (&ObjPool, I));
+        WriteIndexEntry (F, CollConstAt (&ObjPool, I));
     }
+
+    /* Write the amount of unused space in the file */
+    WriteVar (F, FreeBytes);
 }
 
 
@@ -214,21 +237,65 @@ static void WriteIndex (void)
 
 
 
-void LibOpen (const char* Name, int MustExist, int NeedTemp)
-/* Open an existing library and a temporary copy. If MustExist is true, the
-** old library is expected to exist. If NeedTemp is true, a temporary library
-** is created.
+static char* MakeTempName (const char* Name)
+/* Return the name of a temporary file for the given library name. The
+** result is allocated on the heap.
+*/
+{
+    char* TempName = xmalloc (strlen (Name) + strlen (".temp") + 1);
+    strcpy (TempName, Name);
+    strcat (TempName, ".temp");
+    return TempName;
+}
+
+
+
+static void RemoveCreateFile (void)
+/* Remove the temporary file of a new library if ar65 exits with an error */
+{
+    if (CreateName) {
+        if (Lib) {
+            fclose (Lib);
+        }
+        remove (CreateName);
+    }
+}
+
+
+
+static void CopyData (FILE* From, FILE* To, unsigned long Bytes)
+/* Copy data between two files at their current positions */
+{
+    unsigned char Buf [4096];
+
+    while (Bytes) {
+        unsigned Count = (Bytes > sizeof (Buf))? sizeof (Buf) : Bytes;
+        ReadData (From, Buf, Count);
+        WriteData (To, Buf, Count);
+        Bytes -= Count;
+    }
+}
+
+
+
+void LibOpen (const char* Name, int MustExist, int NeedUpdate)
+/* Open an existing library. If MustExist is true, the old library is
+** expected to exist. If NeedUpdate is true, the library is opened for
+** writing and created if it doesn't exist.
 */
 {
     /* Remember the name */
     LibName = xstrdup (Name);
+    Update  = NeedUpdate;
 
-    /* Open the existing library for reading */
-    Lib = fopen (Name, "rb");
+    /* Open the existing library */
+    Lib = fopen (Name, Update? "r+b" : "rb");
     if (Lib == 0) {
 
-        /* File does not exist */
-        if (MustExist) {
+        /* File does not exist or cannot be opened */
+        if (errno != ENOENT) {
+            Error ("Cannot open library '%s': %s", Name, strerror (errno));
+        } else if (MustExist) {
             Error ("Library '%s' does not exist", Name);
         } else {
             /* Announce the library's creation if ar65 is verbose. */
@@ -236,6 +303,19 @@ void LibOpen (const char* Name, int MustExist, int NeedTemp)
                    "%s: Library '%s' will be created.\n", ProgName, Name);
         }
 
+        /* Build the library in a temporary file and write a dummy header.
+        ** This way no broken library is left behind if an error occurs.
+        */
+        if (Update) {
+            CreateName = MakeTempName (Name);
+            atexit (RemoveCreateFile);
+            Lib = fopen (CreateName, "w+b");
+            if (Lib == 0) {
+                Error ("Cannot create library '%s': %s", Name, strerror (errno));
+            }
+            WriteHeader (Lib);
+        }
+
     } else {
 
         /* We have an existing file: Read the header */
@@ -246,43 +326,34 @@ void LibOpen (const char* Name, int MustExist, int NeedTemp)
 
     }
 
-    if (NeedTemp) {
-
-        /* Create the temporary library name */
-        NewLibName = xmalloc (strlen (Name) + strlen (".temp") + 1);
-        strcpy (NewLibName, Name);
-        strcat (NewLibName, ".temp");
-
-        /* Create the temporary library */
-        NewLib = fopen (NewLibName, "w+b");
-        if (NewLib == 0) {
-            Error ("Cannot create temporary library file: %s", strerror (errno));
+    if (Update) {
+        /* New data is appended to the end of the file. Since the index is
+        ** always the last thing written, the old index is kept intact until
+        ** the header is updated to point to the new one, and becomes unused
+        ** space after that.
+        */
+        fseek (Lib, 0, SEEK_END);
+        AppendPos = ftell (Lib);
+        if (Header.IndexOffs != 0) {
+            FreeBytes += AppendPos - Header.IndexOffs;
         }
-
-        /* Write a dummy header to the temp file */
-        WriteHeader ();
     }
 }
 
 
 
 unsigned long LibCopyTo (FILE* F, unsigned long Bytes)
-/* Copy data from F to the temp library file, return the start position in
-** the temporary library file.
+/* Append data from F to the library file, return the start position of the
+** data in the library file.
 */
 {
-    unsigned char Buf [4096];
-
     /* Remember the position */
-    unsigned long Pos = ftell (NewLib);
+    unsigned long Pos = AppendPos;
 
-    /* Copy loop */
-    while (Bytes) {
-        unsigned Count = (Bytes > sizeof (Buf))? sizeof (Buf) : Bytes;
-        ReadData (F, Buf, Count);
-        WriteData (NewLib, Buf, Count);
-        Bytes -= Count;
-    }
+    /* Copy the data */
+    fseek (Lib, AppendPos, SEEK_SET);
+    CopyData (F, Lib, Bytes);
+    AppendPos += Bytes;
 
     /* Return the start position */
     return Pos;
@@ -293,18 +364,21 @@ unsigned long LibCopyTo (FILE* F, unsigned long Bytes)
 void LibCopyFrom (unsigned long Pos, unsigned long Bytes, FILE* F)
 /* Copy data from the library file into another file */
 {
-    unsigned char Buf [4096];
-
     /* Seek to the correct position */
     fseek (Lib, Pos, SEEK_SET);
 
-    /* Copy loop */
-    while (Bytes) {
-        unsigned Count = (Bytes > sizeof (Buf))? sizeof (Buf) : Bytes;
-        ReadData (Lib, Buf, Count);
-        WriteData (F, Buf, Count);
-        Bytes -= Count;
-    }
+    /* Copy the data */
+    CopyData (Lib, F, Bytes);
+}
+
+
+
+void LibDropData (const ObjData* O)
+/* Tell the library module that the data of a module is no longer used
+** because the module was deleted or replaced.
+*/
+{
+    FreeBytes += O->Size;
 }
 
 
@@ -333,21 +407,87 @@ static void LibCheckExports (ObjData* O)
 
 
 
-void LibClose (void)
-/* Write remaining data, close both files and copy the temp file to the old
-** filename
+static void LibCompact (void)
+/* Rewrite the library without the unused space. The library is built in a
+** temporary file which is then copied over the old library.
 */
 {
-    /* Do we have a temporary library? */
-    if (NewLib) {
+    unsigned I;
+    unsigned char Buf [4096];
+    size_t Count;
+    const char* FileName;
+
+    Print (stdout, 1, "%s: Compacting library '%s' (%lu bytes unused).\n",
+           ProgName, LibName, FreeBytes);
+
+    /* Create the temporary library. A new library is itself still in a
+    ** temporary file, which is the file that gets rewritten.
+    */
+    FileName   = CreateName? CreateName : LibName;
+    NewLibName = MakeTempName (FileName);
+    NewLib = fopen (NewLibName, "w+b");
+    if (NewLib == 0) {
+        Error ("Cannot create temporary library file: %s", strerror (errno));
+    }
+
+    /* Write a dummy header to the temp file */
+    WriteHeader (NewLib);
+
+    /* Copy the data of all modules */
+    for (I = 0; I < CollCount (&ObjPool); ++I) {
+        ObjData* O = CollAtUnchecked (&ObjPool, I);
+        fseek (Lib, O->Start, SEEK_SET);
+        O->Start = ftell (NewLib);
+        CopyData (Lib, NewLib, O->Size);
+    }
+
+    /* Write the index and the updated header */
+    FreeBytes = 0;
+    WriteIndex (NewLib);
+    WriteHeader (NewLib);
+
+    /* Reopen the library and truncate it */
+    if (fclose (Lib) != 0) {
+        Error ("Error closing library: %s", strerror (errno));
+    }
+    Lib = fopen (FileName, "wb");
+    if (Lib == 0) {
+        Error ("Cannot open library '%s' for writing: %s",
+               FileName, strerror (errno));
+    }
+
+    /* Copy the temporary library to the new one */
+    fseek (NewLib, 0, SEEK_SET);
+    while ((Count = fread (Buf, 1, sizeof (Buf), NewLib)) != 0) {
+        if (fwrite (Buf, 1, Count, Lib) != Count) {
+            Error ("Cannot write to '%s': %s", LibName, strerror (errno));
+        }
+    }
+
+    /* Remove the temporary library */
+    if (fclose (NewLib) != 0) {
+        Error ("Problem closing temporary library file '%s': %s",
+               NewLibName, strerror (errno));
+    }
+    if (remove (NewLibName) != 0) {
+        Error ("Problem deleting temporary library file '%s': %s",
+               NewLibName, strerror (errno));
+    }
+}
+
+
+
+void LibClose (void)
+/* Write the index of an updated library and close the library file */
+{
+    /* Was the library updated? */
+    if (Update) {
 
         unsigned I;
-        unsigned char Buf [4096];
-        size_t Count;
+        unsigned long UsedBytes = 0;
 
         /* Walk through the object file list, inserting exports into the
-        ** export list checking for duplicates. Copy any data that is still
-        ** in the old library into the new one.
+        ** export list checking for duplicates.
         */
         for (I = 0; I < CollCount (&ObjPool); ++I) {
 
@@ -357,53 +497,41 @@ void LibClose (void)
             /* Check exports, make global export table */
             LibCheckExports (O);
 
-            /* Copy data if needed */
-            if ((O->Flags & OBJ_HAVEDATA) == 0) {
-                /* Data is still in the old library */
-                fseek (Lib, O->Start, SEEK_SET);
-                O->Start = ftell (NewLib);
-                LibCopyTo (Lib, O->Size);
-                O->Flags |= OBJ_HAVEDATA;
-            }
-        }
-
-        /* Write the index */
-        WriteIndex ();
-
-        /* Write the updated header */
-        WriteHeader ();
-
-        /* Close the file */
-        if (Lib && fclose (Lib) != 0) {
-            Error ("Error closing library: %s", strerror (errno));
+            /* Count the bytes in use */
+            UsedBytes += O->Size;
         }
 
-        /* Reopen the library and truncate it */
-        Lib = fopen (LibName, "wb");
-        if (Lib == 0) {
-            Error ("Cannot open library '%s' for writing: %s",
-                   LibName, strerror (errno));
-        }
+        /* The library is written in the current format */
+        Header.Version = LIB_VERSION;
 
-        /* Copy the temporary library to the new one */
-        fseek (NewLib, 0, SEEK_SET);
-        while ((Count = fread (Buf, 1, sizeof (Buf), NewLib)) != 0) {
-            if (fwrite (Buf, 1, Count, Lib) != Count) {
+        /* If more than half of the file is unused, rewrite it. Otherwise
+        ** append the new index and make the header point to it.
+        */
+        if (FreeBytes > UsedBytes) {
+            LibCompact ();
+        } else {
+            fseek (Lib, AppendPos, SEEK_SET);
+            WriteIndex (Lib);
+            if (fflush (Lib) != 0) {
                 Error ("Cannot write to '%s': %s", LibName, strerror (errno));
             }
+            WriteHeader (Lib);
         }
     }
 
-    /* Close both files */
+    /* Close the file */
     if (Lib && fclose (Lib) != 0) {
+        Lib = 0;
         Error ("Problem closing '%s': %s", LibName, strerror (errno));
     }
-    if (NewLib && fclose (NewLib) != 0) {
-        Error ("Problem closing temporary library file '%s': %s",
-               NewLibName, strerror (errno));
-    }
-    if (NewLibName && remove (NewLibName) != 0) {
-        Error ("Problem deleting temporary library file '%s': %s",
-               NewLibName, strerror (errno));
+    Lib = 0;
+
+    /* A new library was built in a temporary file. Give it its real name */
+    if (CreateName) {
+        if (rename (CreateName, LibName) != 0) {
+            Error ("Cannot create library '%s': %s", LibName, strerror (errno));
+        }
+        xfree (CreateName);
+        CreateName = 0;
     }
 }
@@ -42,6 +42,16 @@
 
 
 
+/*****************************************************************************/
+/*                                 Forwards                                  */
+/*****************************************************************************/
+
+
+
+struct ObjData;
+
+
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
@@ -59,25 +69,28 @@ extern const char* LibName;
 
 
 
-void LibOpen (const char* Name, int MustExist, int NeedTemp);
-/* Open an existing library and a temporary copy. If MustExist is true, the
-** old library is expected to exist. If NeedTemp is true, a temporary library
-** is created.
+void LibOpen (const char* Name, int MustExist, int NeedUpdate);
+/* Open an existing library. If MustExist is true, the old library is
+** expected to exist. If NeedUpdate is true, the library is opened for
+** writing and created if it doesn't exist.
 */
 
 unsigned long LibCopyTo (FILE* F, unsigned long Bytes);
-/* Copy data from F to the temp library file, return the start position in
-** the temporary library file.
+/* Append data from F to the library file, return the start position of the
+** data in the library file.
 */
 
 void LibCopyFrom (unsigned long Pos, unsigned long Bytes, FILE* F);
 /* Copy data from the library file into another file */
 
-void LibClose (void);
-/* Write remaining data, close both files and copy the temp file to the old
-** filename
+void LibDropData (const struct ObjData* O);
+/* Tell the library module that the data of a module is no longer used
+** because the module was deleted or replaced.
 */
 
+void LibClose (void);
+/* Write the index of an updated library and close the library file */
+
 
 
 /* End of library.h */
@@ -156,6 +156,7 @@ void DelObjData (const char* Module)
         if (strcmp (O->Name, Module) == 0) {
 
             /* Free the entry */
+            LibDropData (O);
             CollDelete (&ObjPool, I);
             FreeObjData (O);
 
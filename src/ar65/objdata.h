@@ -50,10 +50,6 @@
 
 
 
-/* Values for the Flags field */
-#define OBJ_HAVEDATA    0x0001          /* The object data is in the tmp file */
-
-
 /* Internal structure holding object file data */
 typedef struct ObjData ObjData;
 struct ObjData {
@@ -271,13 +271,16 @@ void ObjAdd (const char* Name)
                      O->Name, LibName);
         }
 
+        /* The old data in the library is no longer used */
+        LibDropData (O);
+
         /* Free data */
         ClearObjData (O);
     }
 
     /* Initialize the object module data structure */
     O->Name     = xstrdup (Module);
-    O->Flags    = OBJ_HAVEDATA;
+    O->Flags    = 0;
     O->MTime    = (unsigned long) StatBuf.st_mtime;
     O->Start    = 0;
 
@@ -0,0 +1,308 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 hashtab.c                                 */
+/*                                                                           */
+/*                 Micro benchmark for the hash table module                 */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+/* Compares the hash table in common/hashtab.c against a chained table with a
+** fixed number of slots, as it was used by ld65 and ar65 before. The keys are
+** string pool like ids (consecutive numbers) and strings. Run with
+**
+**      make bench
+**
+** An optional argument gives the number of entries (default 100000).
+*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* common */
+#include "hashfunc.h"
+#include "hashtab.h"
+#include "xmalloc.h"
+#include "xsprintf.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Number of lookup rounds per test */
+#define ROUNDS          10
+
+/* Slot count of the chained table */
+#define CHAIN_SLOTS     0x1000U
+
+/* An entry in the benchmark */
+typedef struct Entry Entry;
+struct Entry {
+    HashNode            Node;           /* Node for the hash table */
+    Entry*              Next;           /* Link for the chained table */
+    unsigned            Id;             /* Numeric key */
+    char                Name[16];       /* String key */
+};
+
+/* The chained table */
+static Entry*           Chain[CHAIN_SLOTS];
+
+/* Keys used by a test */
+typedef enum { KEY_ID, KEY_STR } KeyType;
+
+
+
+/*****************************************************************************/
+/*                           Hash table functions                            */
+/*****************************************************************************/
+
+
+
+static unsigned IdHash (const void* Key)
+/* Generate the hash over a numeric key */
+{
+    return *(const unsigned*) Key;
+}
+
+
+
+static const void* IdKey (const void* Entry)
+/* Return the numeric key of an entry */
+{
+    return &((const struct Entry*) Entry)->Id;
+}
+
+
+
+static int IdCompare (const void* Key1, const void* Key2)
+/* Compare two numeric keys */
+{
+    unsigned K1 = *(const unsigned*) Key1;
+    unsigned K2 = *(const unsigned*) Key2;
+    return (K1 < K2)? -1 : (K1 > K2);
+}
+
+
+
+static unsigned StrHash (const void* Key)
+/* Generate the hash over a string key */
+{
+    return HashStr (Key);
+}
+
+
+
+static const void* StrKey (const void* Entry)
+/* Return the string key of an entry */
+{
+    return ((const struct Entry*) Entry)->Name;
+}
+
+
+
+static int StrCompare (const void* Key1, const void* Key2)
+/* Compare two string keys */
+{
+    return strcmp (Key1, Key2);
+}
+
+
+
+static const HashFunctions IdFunc  = { IdHash,  IdKey,  IdCompare  };
+static const HashFunctions StrFunc = { StrHash, StrKey, StrCompare };
+
+
+
+/*****************************************************************************/
+/*                               Chained table                               */
+/*****************************************************************************/
+
+
+
+static unsigned ChainSlot (KeyType K, const void* Key)
+/* Return the slot for a key */
+{
+    if (K == KEY_ID) {
+        return *(const unsigned*) Key & (CHAIN_SLOTS - 1);
+    } else {
+        return HashStr (Key) & (CHAIN_SLOTS - 1);
+    }
+}
+
+
+
+static void ChainInsert (KeyType K, Entry* E)
+/* Insert an entry into the chained table */
+{
+    unsigned Slot = ChainSlot (K, K == KEY_ID? (const void*) &E->Id : E->Name);
+    E->Next = Chain[Slot];
+    Chain[Slot] = E;
+}
+
+
+
+static Entry* ChainFind (KeyType K, const void* Key)
+/* Search for a key in the chained table */
+{
+    Entry* E = Chain[ChainSlot (K, Key)];
+    while (E) {
+        if (K == KEY_ID? E->Id == *(const unsigned*) Key
+                       : strcmp (E->Name, Key) == 0) {
+            break;
+        }
+        E = E->Next;
+    }
+    return E;
+}
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static double Seconds (clock_t Start)
+/* Return the time elapsed since Start */
+{
+    return (double) (clock () - Start) / CLOCKS_PER_SEC;
+}
+
+
+
+static void Bench (KeyType K, Entry* Entries, unsigned Count)
+/* Run the benchmark for one key type and print the results */
+{
+    HashTable   T;
+    clock_t     Start;
+    double      Insert[2], Find[2];
+    unsigned    Found[2];
+    unsigned    I, R;
+
+    /* Chained table */
+    memset (Chain, 0, sizeof (Chain));
+    Start = clock ();
+    for (I = 0; I < Count; ++I) {
+        ChainInsert (K, Entries + I);
+    }
+    Insert[0] = Seconds (Start);
+    Found[0] = 0;
+    Start = clock ();
+    for (R = 0; R < ROUNDS; ++R) {
+        /* Keys in the upper half of the array are never inserted */
+        for (I = 0; I < Count * 2; ++I) {
+            const Entry* E = Entries + I;
+            Found[0] += ChainFind (K, K == KEY_ID? (const void*) &E->Id : E->Name) != 0;
+        }
+    }
+    Find[0] = Seconds (Start);
+
+    /* Open addressing table, starting small so it has to grow */
+    InitHashTable (&T, 16, K == KEY_ID? &IdFunc : &StrFunc);
+    Start = clock ();
+    for (I = 0; I < Count; ++I) {
+        InitHashNode (&Entries[I].Node);
+        HT_Insert (&T, Entries + I);
+    }
+    Insert[1] = Seconds (Start);
+    Found[1] = 0;
+    Start = clock ();
+    for (R = 0; R < ROUNDS; ++R) {
+        for (I = 0; I < Count * 2; ++I) {
+            const Entry* E = Entries + I;
+            Found[1] += HT_Find (&T, K == KEY_ID? (const void*) &E->Id : E->Name) != 0;
+        }
+    }
+    Find[1] = Seconds (Start);
+
+    /* Remove every other entry and check that the rest is still there */
+    for (I = 0; I < Count; I += 2) {
+        HT_Remove (&T, Entries + I);
+    }
+    for (I = 0; I < Count; ++I) {
+        const Entry* E = Entries + I;
+        const void* Key = K == KEY_ID? (const void*) &E->Id : E->Name;
+        if ((HT_Find (&T, Key) != 0) != (I & 1)) {
+            fprintf (stderr, "HT_Remove failed for entry %u\n", I);
+            exit (EXIT_FAILURE);
+        }
+    }
+    DoneHashTable (&T);
+
+    if (Found[0] != Found[1] || Found[0] != Count * ROUNDS) {
+        fprintf (stderr, "Lookup results differ: %u/%u\n", Found[0], Found[1]);
+        exit (EXIT_FAILURE);
+    }
+
+    printf ("%-8s chained: insert %7.3fs, find %7.3fs\n",
+            K == KEY_ID? "ids" : "strings", Insert[0], Find[0]);
+    printf ("%-8s hashtab: insert %7.3fs, find %7.3fs\n",
+            "", Insert[1], Find[1]);
+}
+
+
+
+int main (int argc, char* argv[])
+{
+    unsigned I;
+    unsigned Count = 100000;
+    Entry*   Entries;
+
+    if (argc > 1) {
+        Count = strtoul (argv[1], 0, 0);
+        if (Count == 0) {
+            fprintf (stderr, "Invalid entry count: %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Create twice as many entries as needed, so we have keys for lookups
+    ** that fail.
+    */
+    Entries = xmalloc (Count * 2 * sizeof (Entry));
+    for (I = 0; I < Count * 2; ++I) {
+        Entries[I].Id = I;
+        xsprintf (Entries[I].Name, sizeof (Entries[I].Name), "_sym%u", I * 7);
+    }
+
+    printf ("%u entries, %u lookup rounds\n", Count, ROUNDS);
+    Bench (KEY_ID, Entries, Count);
+    Bench (KEY_STR, Entries, Count);
+
+    xfree (Entries);
+    return EXIT_SUCCESS;
+}
@@ -73,14 +73,10 @@
 
 
 /* Since all expressions are first packed into expression trees, and each
-** expression tree node is allocated on the heap, we add some type of special
-** purpose memory allocation here: Instead of freeing the nodes, we save some
-** number of freed nodes for later and remember them in a single linked list
-** using the Left link.
+** expression tree node is allocated on the heap, the nodes are allocated
+** from a pool which keeps freed nodes for later.
 */
-#define MAX_FREE_NODES  64
-static ExprNode*        FreeExprNodes = 0;
-static unsigned         FreeNodeCount = 0;
+static MemPool ExprNodePool = STATIC_MEMPOOL_INITIALIZER ("ExprNode", sizeof (ExprNode));
 
 
 
@@ -93,18 +89,7 @@ static unsigned         FreeNodeCount = 0;
 static ExprNode* NewExprNode (unsigned Op)
 /* Create a new expression node */
 {
-    ExprNode* N;
-
-    /* Do we have some nodes in the list already? */
-    if (FreeNodeCount) {
-        /* Use first node from list */
-        N = FreeExprNodes;
-        FreeExprNodes = N->Left;
-        --FreeNodeCount;
-    } else {
-        /* Allocate fresh memory */
-        N = xmalloc (sizeof (ExprNode));
-    }
+    ExprNode* N = PoolAlloc (&ExprNodePool);
     N->Op = Op;
     N->Left = N->Right = 0;
     N->Obj = 0;
@@ -122,16 +107,8 @@ static void FreeExprNode (ExprNode* E)
             /* Remove the symbol reference */
             SymDelExprRef (E->V.Sym, E);
         }
-        /* Place the symbol into the free nodes list if possible */
-        if (FreeNodeCount < MAX_FREE_NODES) {
-            /* Remember this node for later */
-            E->Left = FreeExprNodes;
-            FreeExprNodes = E;
-            ++FreeNodeCount;
-        } else {
-            /* Free the memory */
-            xfree (E);
-        }
+        /* Return the node to the pool */
+        PoolFree (&ExprNodePool, E);
     }
 }
 
@@ -41,6 +41,17 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Fragments are never freed, so a pool is cheaper than xmalloc */
+static MemPool FragmentPool = STATIC_MEMPOOL_INITIALIZER ("Fragment", sizeof (Fragment));
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
@@ -53,7 +64,7 @@ Fragment* NewFragment (unsigned char Type, unsigned short Len)
 */
 {
     /* Create a new fragment */
-    Fragment* F = xmalloc (sizeof (*F));
+    Fragment* F = PoolAlloc (&FragmentPool);
 
     /* Initialize it */
     F->Next     = 0;
@@ -212,14 +212,13 @@ static void FreeLineInfo (LineInfo* LI)
 
 
 static int CheckLineInfo (void* Entry, void* Data attribute ((unused)))
-/* Called from HT_Walk. Remembers used line infos and assigns them an id */
+/* Called from HT_Walk. Remembers used line infos. */
 {
     /* Entry is actually a line info */
     LineInfo* LI = Entry;
 
     /* The entry is used if there are spans or the ref counter is non zero */
     if (LI->RefCount > 0 || CollCount (&LI->Spans) > 0) {
-        LI->Id = CollCount (&LineInfoList);
         CollAppend (&LineInfoList, LI);
         return 0;       /* Keep the entry */
     } else {
@@ -230,6 +229,27 @@ static int CheckLineInfo (void* Entry, void* Data attribute ((unused)))
 
 
 
+static int CompareLineInfo (void* Data attribute ((unused)),
+                            const void* Left, const void* Right)
+/* Compare two line infos by file, line and type */
+{
+    const LineInfoKey* K1 = &((const LineInfo*) Left)->Key;
+    const LineInfoKey* K2 = &((const LineInfo*) Right)->Key;
+
+    if (K1->Pos.Name != K2->Pos.Name) {
+        return (K1->Pos.Name < K2->Pos.Name)? -1 : 1;
+    }
+    if (K1->Pos.Line != K2->Pos.Line) {
+        return (K1->Pos.Line < K2->Pos.Line)? -1 : 1;
+    }
+    if (K1->Type != K2->Type) {
+        return (K1->Type < K2->Type)? -1 : 1;
+    }
+    return 0;
+}
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
@@ -289,10 +309,18 @@ void DoneLineInfo (void)
     }
 
     /* Walk over the entries in the hash table and sort them into used and
-    ** unused ones. Add the used ones to the line info list and assign them
-    ** an id.
+    ** unused ones. Add the used ones to the line info list.
     */
     HT_Walk (&LineInfoTab, CheckLineInfo, 0);
+
+    /* The walk order depends on the hash table, so sort the list by source
+    ** position before assigning the ids. This keeps the object files the
+    ** same whatever the layout of the hash table is.
+    */
+    CollSort (&LineInfoList, CompareLineInfo, 0);
+    for (Count = 0; Count < CollCount (&LineInfoList); ++Count) {
+        ((LineInfo*) CollAt (&LineInfoList, Count))->Id = Count;
+    }
 }
 
 
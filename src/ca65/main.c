@@ -50,6 +50,7 @@
 #include "target.h"
 #include "tgttrans.h"
 #include "version.h"
+#include "xmalloc.h"
 
 /* ca65 */
 #include "abend.h"
@@ -123,6 +124,7 @@ static void Usage (void)
             "  --large-alignment\t\tDon't warn about large alignments\n"
             "  --listing name\t\tCreate a listing file if assembly was ok\n"
             "  --list-bytes n\t\tMaximum number of bytes per listing line\n"
+            "  --mem-stats\t\t\tPrint memory statistics\n"
             "  --memory-model model\t\tSet the memory model\n"
             "  --pagelength n\t\tSet the page length for the listing\n"
             "  --relax-checks\t\tRelax some checks (see docs)\n"
@@ -563,6 +565,15 @@ static void OptListing (const char* Opt, const char* Arg)
 
 
 
+static void OptMemStats (const char* Opt attribute ((unused)),
+                        const char* Arg attribute ((unused)))
+/* Print memory statistics when done */
+{
+    MemStats = 1;
+}
+
+
+
 static void OptMemoryModel (const char* Opt, const char* Arg)
 /* Set the memory model */
 {
@@ -921,6 +932,7 @@ int main (int argc, char* argv [])
         { "--large-alignment",  0,      OptLargeAlignment       },
         { "--list-bytes",       1,      OptListBytes            },
         { "--listing",          1,      OptListing              },
+        { "--mem-stats",        0,      OptMemStats             },
         { "--memory-model",     1,      OptMemoryModel          },
         { "--pagelength",       1,      OptPageLength           },
         { "--relax-checks",     0,      OptRelaxChecks          },
@@ -964,8 +976,8 @@ int main (int argc, char* argv [])
         /* Get the argument */
         const char* Arg = ArgVec [I];
 
-        /* Check for an option */
-        if (Arg[0] == '-') {
+        /* Check for an option. A single "-" is stdin. */
+        if (Arg[0] == '-' && Arg[1] != '\0') {
             switch (Arg[1]) {
 
                 case '-':
@@ -1062,6 +1074,13 @@ int main (int argc, char* argv [])
         exit (EXIT_FAILURE);
     }
 
+    /* The name of the object file cannot be derived from stdin */
+    if (strcmp (InFile, "-") == 0 && OutFile == 0) {
+        fprintf (stderr, "%s: An output file name is required when reading "
+                 "from stdin\n", ProgName);
+        exit (EXIT_FAILURE);
+    }
+
     /* Add the default include search paths. */
     FinishIncludePaths ();
 
@@ -1149,6 +1168,11 @@ int main (int argc, char* argv [])
     /* Close the input file */
     DoneScanner ();
 
+    /* Print memory statistics if requested */
+    if (MemStats) {
+        PrintMemStats (stdout);
+    }
+
     /* Return an apropriate exit code */
     return (ErrorCount == 0)? EXIT_SUCCESS : EXIT_FAILURE;
 }
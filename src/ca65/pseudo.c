@@ -1578,22 +1578,14 @@ static void DoPopCPU (void)
 static void DoPopSeg (void)
 /* Pop an old segment from the segment stack */
 {
-    SegDef* Def;
-
     /* Must have a segment on the stack */
     if (CollCount (&SegStack) == 0) {
         ErrorSkip ("Segment stack is empty");
         return;
     }
 
-    /* Pop the last element */
-    Def = CollPop (&SegStack);
-
-    /* Restore this segment */
-    UseSeg (Def);
-
-    /* Delete the segment definition */
-    FreeSegDef (Def);
+    /* Restore the last segment. This may be a sub-section. */
+    ActiveSeg = CollPop (&SegStack);
 }
 
 
@@ -1673,8 +1665,8 @@ static void DoPushSeg (void)
         return;
     }
 
-    /* Get the current segment and push it */
-    CollAppend (&SegStack, DupSegDef (GetCurrentSegDef ()));
+    /* Push the current segment */
+    CollAppend (&SegStack, ActiveSeg);
 }
 
 
@@ -1773,6 +1765,7 @@ static void DoSegment (void)
 {
     StrBuf Name = STATIC_STRBUF_INITIALIZER;
     SegDef Def;
+    unsigned SubName;
 
     if (CurTok.Tok != TOK_STRCON) {
         ErrorSkip ("String constant expected");
@@ -1789,8 +1782,20 @@ static void DoSegment (void)
         /* Check for an optional address size modifier */
         Def.AddrSize = OptionalAddrSize ();
 
+        /* Check for an optional sub-section name */
+        SubName = EMPTY_STRING_ID;
+        if (CurTok.Tok == TOK_COMMA) {
+            NextTok ();
+            if (CurTok.Tok != TOK_STRCON) {
+                ErrorSkip ("String constant expected");
+            } else {
+                SubName = GetStrBufId (&CurTok.SVal);
+                NextTok ();
+            }
+        }
+
         /* Set the segment */
-        UseSeg (&Def);
+        UseSubSeg (&Def, SubName);
     }
 
     /* Free memory for Name */
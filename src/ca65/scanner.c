@@ -46,6 +46,7 @@
 #include "check.h"
 #include "filestat.h"
 #include "fname.h"
+#include "textfile.h"
 #include "xmalloc.h"
 
 /* ca65 */
@@ -75,7 +76,7 @@ Token CurTok = STATIC_TOKEN_INITIALIZER;
 /* Struct to handle include files. */
 typedef struct InputFile InputFile;
 struct InputFile {
-    FILE*           F;                  /* Input file descriptor */
+    TextFile*       F;                  /* Input file */
     FilePos         Pos;                /* Position in file */
     token_t         Tok;                /* Last token */
     int             C;                  /* Last character */
@@ -374,39 +375,21 @@ static void IFNextChar (CharSource* S)
 
         unsigned Len;
 
-        /* End of current line reached, read next line */
-        SB_Clear (&S->V.File.Line);
-        while (1) {
-
-            int N = fgetc (S->V.File.F);
-            if (N == EOF) {
-                /* End of file. Accept files without a newline at the end */
-                if (SB_NotEmpty (&S->V.File.Line)) {
-                    break;
-                }
-
-                /* No more data - add an empty line to the listing. This
-                ** is a small hack needed to keep the PC output in sync.
-                */
-                NewListingLine (&EmptyStrBuf, S->V.File.Pos.Name, FCount);
-                C = EOF;
-                return;
-
-            /* Check for end of line */
-            } else if (N == '\n') {
-
-                /* End of line */
-                break;
-
-            /* Collect other stuff */
-            } else {
-
-                /* Append data to line */
-                SB_AppendChar (&S->V.File.Line, N);
+        /* End of current line reached, read next line. The last line of the
+        ** file is accepted without a newline at the end.
+        */
+        const char* Data = TF_NextLine (S->V.File.F, &Len);
+        if (Data == 0) {
 
-            }
+            /* No more data - add an empty line to the listing. This
+            ** is a small hack needed to keep the PC output in sync.
+            */
+            NewListingLine (&EmptyStrBuf, S->V.File.Pos.Name, FCount);
+            C = EOF;
+            return;
         }
-
+        SB_Clear (&S->V.File.Line);
+        SB_AppendBuf (&S->V.File.Line, Data, Len);
 
         /* If we come here, we have a new input line. To avoid problems
         ** with strange line terminators, remove all whitespace from the
@@ -464,7 +447,7 @@ void IFDone (CharSource* S)
     /* Close the input file and decrement the file count. We will ignore
     ** errors here, since we were just reading from the file.
     */
-    (void) fclose (S->V.File.F);
+    CloseTextFile (S->V.File.F);
     --FCount;
 }
 
@@ -486,10 +469,11 @@ int NewInputFile (const char* Name)
 {
     int         RetCode = 0;            /* Return code. Assume an error. */
     char*       PathName = 0;
-    FILE*       F;
+    TextFile*   F;
     struct stat Buf;
     StrBuf      NameBuf;                /* No need to initialize */
     StrBuf      Path = AUTO_STRBUF_INITIALIZER;
+    int         IsStdin = 0;
     unsigned    FileIdx;
     CharSource* S;
 
@@ -498,8 +482,9 @@ int NewInputFile (const char* Name)
     ** search for it using the include path list.
     */
     if (FCount == 0) {
-        /* Main file */
-        F = fopen (Name, "r");
+        /* Main file. A name of "-" means stdin. */
+        IsStdin = (strcmp (Name, "-") == 0);
+        F = IsStdin? OpenTextStream (stdin) : OpenTextFile (Name);
         if (F == 0) {
             Fatal ("Cannot open input file '%s': %s", Name, strerror (errno));
         }
@@ -508,7 +493,7 @@ int NewInputFile (const char* Name)
         ** directories.
         */
         PathName = SearchFile (IncSearchPath, Name);
-        if (PathName == 0 || (F = fopen (PathName, "r")) == 0) {
+        if (PathName == 0 || (F = OpenTextFile (PathName)) == 0) {
             /* Not found or cannot open, print an error and bail out */
             Error ("Cannot open include file '%s': %s", Name, strerror (errno));
             goto ExitPoint;
@@ -524,9 +509,12 @@ int NewInputFile (const char* Name)
     ** file name, there's a risk that the file was deleted and recreated
     ** while it was open. Since mtime and size are only used to check
     ** if a file has changed in the debugger, we will ignore this problem
-    ** here.
+    ** here. stdin has the size of its contents and no modification time.
     */
-    if (FileStat (Name, &Buf) != 0) {
+    if (IsStdin) {
+        Buf.st_size  = F->End - F->Pos;
+        Buf.st_mtime = 0;
+    } else if (FileStat (Name, &Buf) != 0) {
         Fatal ("Cannot stat input file '%s': %s", Name, strerror (errno));
     }
 
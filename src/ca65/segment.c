@@ -114,6 +114,7 @@ static Segment* NewSegFromDef (SegDef* Def)
     S->PC        = 0;
     S->AbsPC     = 0;
     S->Def       = Def;
+    S->SubName   = EMPTY_STRING_ID;
 
     /* Insert it into the segment list */
     CollAppend (&SegmentList, S);
@@ -190,8 +191,22 @@ Fragment* GenFragment (unsigned char Type, unsigned short Len)
 
 void UseSeg (const SegDef* D)
 /* Use the segment with the given name */
+{
+    UseSubSeg (D, EMPTY_STRING_ID);
+}
+
+
+
+void UseSubSeg (const SegDef* D, unsigned SubName)
+/* Use a sub-section of the given segment. All code for sub-sections with the
+** same name is collected in one section, which is written to the object file
+** separately, so the linker may remove it if it is unused. A SubName of
+** EMPTY_STRING_ID denotes the segment itself.
+*/
 {
     unsigned I;
+    unsigned char AddrSize = D->AddrSize;
+
     for (I = 0; I < CollCount (&SegmentList); ++I) {
         Segment* Seg = CollAtUnchecked (&SegmentList, I);
         if (strcmp (Seg->Def->Name, D->Name) == 0) {
@@ -202,16 +217,24 @@ void UseSeg (const SegDef* D)
                 /* Use the new attribute to avoid errors */
                 Seg->Def->AddrSize = D->AddrSize;
             }
-            ActiveSeg = Seg;
-            return;
+            if (Seg->SubName == SubName) {
+                ActiveSeg = Seg;
+                return;
+            }
+            /* A new sub-section inherits the type of the segment */
+            AddrSize = Seg->Def->AddrSize;
         }
     }
 
     /* Segment is not in list, create a new one */
-    if (D->AddrSize == ADDR_SIZE_DEFAULT) {
+    if (AddrSize == ADDR_SIZE_DEFAULT) {
         ActiveSeg = NewSegment (D->Name, ADDR_SIZE_ABS);
     } else {
-        ActiveSeg = NewSegment (D->Name, D->AddrSize);
+        ActiveSeg = NewSegment (D->Name, AddrSize);
+    }
+    if (SubName != EMPTY_STRING_ID) {
+        ActiveSeg->SubName = SubName;
+        ActiveSeg->Flags  |= SEG_FLAG_SUBSEC;
     }
 }
 
@@ -538,6 +561,9 @@ static void WriteOneSeg (Segment* Seg)
     /* Write the segment data */
     ObjWriteVar (GetStringId (Seg->Def->Name)); /* Name of the segment */
     ObjWriteVar (Seg->Flags);                   /* Segment flags */
+    if (Seg->Flags & SEG_FLAG_SUBSEC) {
+        ObjWriteVar (Seg->SubName);             /* Name of the sub-section */
+    }
     ObjWriteVar (Seg->PC);                      /* Size */
     ObjWriteVar (Seg->Align);                   /* Segment alignment */
     ObjWrite8 (Seg->Def->AddrSize);             /* Address size of the segment */
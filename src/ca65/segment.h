@@ -69,6 +69,7 @@ struct Segment {
     unsigned long   AbsPC;              /* PC if in local absolute mode */
                                         /* (OrgPerSeg is true) */
     SegDef*         Def;                /* Segment definition (name and type) */
+    unsigned        SubName;            /* Name of sub-section or empty */
 };
 
 /* Definitions for predefined segments */
@@ -99,6 +100,13 @@ Fragment* GenFragment (unsigned char Type, unsigned short Len);
 void UseSeg (const SegDef* D);
 /* Use the given segment */
 
+void UseSubSeg (const SegDef* D, unsigned SubName);
+/* Use a sub-section of the given segment. All code for sub-sections with the
+** same name is collected in one section, which is written to the object file
+** separately, so the linker may remove it if it is unused. A SubName of
+** EMPTY_STRING_ID denotes the segment itself.
+*/
+
 #if defined(HAVE_INLINE)
 INLINE const SegDef* GetCurrentSegDef (void)
 /* Get a pointer to the segment defininition of the current segment */
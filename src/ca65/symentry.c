@@ -82,8 +82,7 @@ SymEntry* NewSymEntry (const StrBuf* Name, unsigned Flags)
     SymEntry* S = xmalloc (sizeof (SymEntry));
 
     /* Initialize the entry */
-    S->Left       = 0;
-    S->Right      = 0;
+    InitHashNode (&S->Node);
     S->Locals     = 0;
     S->Sym.Tab    = 0;
     S->DefLines   = EmptyCollection;
@@ -113,43 +112,6 @@ SymEntry* NewSymEntry (const StrBuf* Name, unsigned Flags)
 
 
 
-int SymSearchTree (SymEntry* T, const StrBuf* Name, SymEntry** E)
-/* Search in the given tree for a name. If we find the symbol, the function
-** will return 0 and put the entry pointer into E. If we did not find the
-** symbol, and the tree is empty, E is set to NULL. If the tree is not empty,
-** E will be set to the last entry, and the result of the function is <0 if
-** the entry should be inserted on the left side, and >0 if it should get
-** inserted on the right side.
-*/
-{
-    /* Is there a tree? */
-    if (T == 0) {
-        *E = 0;
-        return 1;
-    }
-
-    /* We have a table, search it */
-    while (1) {
-
-        /* Get the symbol name */
-        const StrBuf* SymName = GetStrBuf (T->Name);
-
-        /* Choose next entry */
-        int Cmp = SB_Compare (Name, SymName);
-        if (Cmp < 0 && T->Left) {
-            T = T->Left;
-        } else if (Cmp > 0 && T->Right) {
-            T = T->Right;
-        } else {
-            /* Found or end of search, return the result */
-            *E = T;
-            return Cmp;
-        }
-    }
-}
-
-
-
 void SymTransferExprRefs (SymEntry* From, SymEntry* To)
 /* Transfer all expression references from one symbol to another. */
 {
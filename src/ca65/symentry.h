@@ -42,6 +42,7 @@
 #include "cddefs.h"
 #include "coll.h"
 #include "filepos.h"
+#include "hashtab.h"
 #include "inline.h"
 #include "strbuf.h"
 
@@ -81,10 +82,9 @@ struct HLLDbgSym;
 /* Structure of a symbol table entry */
 typedef struct SymEntry SymEntry;
 struct SymEntry {
-    SymEntry*           Left;           /* Lexically smaller entry */
-    SymEntry*           Right;          /* Lexically larger entry */
+    HashNode            Node;           /* Node in the scope or locals table */
     SymEntry*           List;           /* List of all entries */
-    SymEntry*           Locals;         /* Root of subtree for local symbols */
+    HashTable*          Locals;         /* Table with cheap local symbols */
     union {
         struct SymTable*    Tab;        /* Table this symbol is in */
         struct SymEntry*    Entry;      /* Parent for cheap locals */
@@ -128,15 +128,6 @@ extern SymEntry* SymLast;
 SymEntry* NewSymEntry (const StrBuf* Name, unsigned Flags);
 /* Allocate a symbol table entry, initialize and return it */
 
-int SymSearchTree (SymEntry* T, const StrBuf* Name, SymEntry** E);
-/* Search in the given tree for a name. If we find the symbol, the function
-** will return 0 and put the entry pointer into E. If we did not find the
-** symbol, and the tree is empty, E is set to NULL. If the tree is not empty,
-** E will be set to the last entry, and the result of the function is <0 if
-** the entry should be inserted on the left side, and >0 if it should get
-** inserted on the right side.
-*/
-
 #if defined(HAVE_INLINE)
 INLINE void SymAddExprRef (SymEntry* Sym, struct ExprNode* Expr)
 /* Add an expression reference to this symbol */
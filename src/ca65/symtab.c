@@ -60,12 +60,48 @@
 
 
 
+/*****************************************************************************/
+/*                                 Forwards                                  */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key);
+/* Generate the hash over a key. */
+
+static const void* HT_GetSymKey (const void* Entry);
+/* Given a pointer to a symbol, return a pointer to the key */
+
+static const void* HT_GetScopeKey (const void* Entry);
+/* Given a pointer to a scope, return a pointer to the key */
+
+static int HT_Compare (const void* Key1, const void* Key2);
+/* Compare two keys. */
+
+
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
 
 
 
+/* Hash functions for the symbol and cheap local tables. Both are keyed by
+** the symbol name.
+*/
+static const HashFunctions SymFunc = {
+    HT_GenHash,
+    HT_GetSymKey,
+    HT_Compare
+};
+
+/* Hash functions for the tables with child scopes */
+static const HashFunctions ScopeFunc = {
+    HT_GenHash,
+    HT_GetScopeKey,
+    HT_Compare
+};
+
 /* Combined symbol entry flags used within this module */
 #define SF_UNDEFMASK    (SF_REFERENCED | SF_DEFINED | SF_IMPORT)
 #define SF_UNDEFVAL     (SF_REFERENCED)
@@ -82,6 +118,47 @@ static unsigned     ExportCount = 0;    /* Counter for export symbols */
 
 
 
+/*****************************************************************************/
+/*                           Hash table functions                            */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key)
+/* Generate the hash over a key. */
+{
+    return HashBuf (Key);
+}
+
+
+
+static const void* HT_GetSymKey (const void* Entry)
+/* Given a pointer to a symbol, return a pointer to the key */
+{
+    return GetStrBuf (((const SymEntry*) Entry)->Name);
+}
+
+
+
+static const void* HT_GetScopeKey (const void* Entry)
+/* Given a pointer to a scope, return a pointer to the key */
+{
+    return GetStrBuf (((const SymTable*) Entry)->Name);
+}
+
+
+
+static int HT_Compare (const void* Key1, const void* Key2)
+/* Compare two keys. The function must return a value less than zero if
+** Key1 is smaller than Key2, zero if both are equal, and a value greater
+** than zero if Key1 is greater then Key2.
+*/
+{
+    return SB_Compare (Key1, Key2);
+}
+
+
+
 /*****************************************************************************/
 /*                         Internally used functions                         */
 /*****************************************************************************/
@@ -103,12 +180,14 @@ static int IsDbgSym (const SymEntry* S)
 
 
 static unsigned ScopeTableSize (unsigned Level)
-/* Get the size of a table for the given lexical level */
+/* Get the expected number of symbols for the given lexical level. The tables
+** grow as needed, so this is just a hint for the initial allocation.
+*/
 {
     switch (Level) {
-        case 0:         return 213;
-        case 1:         return  53;
-        default:        return  29;
+        case 0:         return 256;
+        case 1:         return  32;
+        default:        return   8;
     }
 }
 
@@ -117,18 +196,15 @@ static unsigned ScopeTableSize (unsigned Level)
 static SymTable* NewSymTable (SymTable* Parent, const StrBuf* Name)
 /* Allocate a symbol table on the heap and return it */
 {
-    /* Determine the lexical level and the number of table slots */
+    /* Determine the lexical level */
     unsigned Level = Parent? Parent->Level + 1 : 0;
-    unsigned Slots = ScopeTableSize (Level);
 
     /* Allocate memory */
-    SymTable* S = xmalloc (sizeof (SymTable) + (Slots-1) * sizeof (SymEntry*));
+    SymTable* S = xmalloc (sizeof (SymTable));
 
-    /* Set variables and clear hash table entries */
+    /* Set variables and initialize the hash tables */
+    InitHashNode (&S->Node);
     S->Next         = 0;
-    S->Left         = 0;
-    S->Right        = 0;
-    S->Childs       = 0;
     S->Label        = 0;
     S->Spans        = AUTO_COLLECTION_INITIALIZER;
     S->Id           = ScopeCount++;
@@ -136,13 +212,10 @@ static SymTable* NewSymTable (SymTable* Parent, const StrBuf* Name)
     S->AddrSize     = ADDR_SIZE_DEFAULT;
     S->Type         = SCOPE_UNDEF;
     S->Level        = Level;
-    S->TableSlots   = Slots;
-    S->TableEntries = 0;
     S->Parent       = Parent;
     S->Name         = GetStrBufId (Name);
-    while (Slots--) {
-        S->Table[Slots] = 0;
-    }
+    InitHashTable (&S->Childs, 0, &ScopeFunc);
+    InitHashTable (&S->Table, ScopeTableSize (Level), &SymFunc);
 
     /* Insert the symbol table into the list of all symbol tables */
     if (RootScope == 0) {
@@ -152,36 +225,9 @@ static SymTable* NewSymTable (SymTable* Parent, const StrBuf* Name)
     }
     LastScope = S;
 
-    /* Insert the symbol table into the child tree of the parent */
+    /* Insert the symbol table into the child table of the parent */
     if (Parent) {
-        SymTable* T = Parent->Childs;
-        if (T == 0) {
-            /* First entry */
-            Parent->Childs = S;
-        } else {
-            while (1) {
-                /* Choose next entry */
-                int Cmp = SB_Compare (Name, GetStrBuf (T->Name));
-                if (Cmp < 0) {
-                    if (T->Left) {
-                        T = T->Left;
-                    } else {
-                        T->Left = S;
-                        break;
-                    }
-                } else if (Cmp > 0) {
-                    if (T->Right) {
-                        T = T->Right;
-                    } else {
-                        T->Right = S;
-                        break;
-                    }
-                } else {
-                    /* Duplicate scope name */
-                    Internal ("Duplicate scope name: '%m%p'", Name);
-                }
-            }
-        }
+        HT_Insert (&Parent->Childs, S);
     }
 
     /* Return the prepared struct */
@@ -278,26 +324,15 @@ void SymLeaveLevel (void)
 SymTable* SymFindScope (SymTable* Parent, const StrBuf* Name, SymFindAction Action)
 /* Find a scope in the given enclosing scope */
 {
-    SymTable** T = &Parent->Childs;
-    while (*T) {
-        int Cmp = SB_Compare (Name, GetStrBuf ((*T)->Name));
-        if (Cmp < 0) {
-            T = &(*T)->Left;
-        } else if (Cmp > 0) {
-            T = &(*T)->Right;
-        } else {
-            /* Found the scope */
-            return *T;
-        }
-    }
+    SymTable* T = HT_Find (&Parent->Childs, Name);
 
     /* Create a new scope if requested and we didn't find one */
-    if (*T == 0 && (Action & SYM_ALLOC_NEW) != 0) {
-        *T = NewSymTable (Parent, Name);
+    if (T == 0 && (Action & SYM_ALLOC_NEW) != 0) {
+        T = NewSymTable (Parent, Name);
     }
 
     /* Return the scope */
-    return *T;
+    return T;
 }
 
 
@@ -331,7 +366,6 @@ SymEntry* SymFindLocal (SymEntry* Parent, const StrBuf* Name, SymFindAction Acti
 
 {
     SymEntry* S;
-    int Cmp;
 
     /* Local symbol, get the table */
     if (!Parent) {
@@ -345,25 +379,24 @@ SymEntry* SymFindLocal (SymEntry* Parent, const StrBuf* Name, SymFindAction Acti
     }
 
     /* Search for the symbol if we have a table */
-    Cmp = SymSearchTree (Parent->Locals, Name, &S);
+    S = Parent->Locals? HT_Find (Parent->Locals, Name) : 0;
 
     /* If we found an entry, return it */
-    if (Cmp == 0) {
+    if (S) {
         return S;
     }
 
     if (Action & SYM_ALLOC_NEW) {
 
-        /* Otherwise create a new entry, insert and return it */
+        /* Otherwise create a new entry, insert and return it. The table is
+        ** created when the first local symbol is added.
+        */
         SymEntry* N = NewSymEntry (Name, SF_LOCAL);
         N->Sym.Entry = Parent;
-        if (S == 0) {
-            Parent->Locals = N;
-        } else if (Cmp < 0) {
-            S->Left = N;
-        } else {
-            S->Right = N;
+        if (Parent->Locals == 0) {
+            Parent->Locals = NewHashTable (0, &SymFunc);
         }
+        HT_Insert (Parent->Locals, N);
         return N;
     }
 
@@ -380,16 +413,11 @@ SymEntry* SymFind (SymTable* Scope, const StrBuf* Name, SymFindAction Action)
 ** SYM_FIND_EXISTING - return 0.
 */
 {
-    SymEntry* S;
-
-    /* Global symbol: Get the hash value for the name */
-    unsigned Hash = HashBuf (Name) % Scope->TableSlots;
-
     /* Search for the entry */
-    int Cmp = SymSearchTree (Scope->Table[Hash], Name, &S);
+    SymEntry* S = HT_Find (&Scope->Table, Name);
 
     /* If we found an entry, return it */
-    if (Cmp == 0) {
+    if (S) {
         if ((Action & SYM_CHECK_ONLY) == 0 && SymTabIsClosed (Scope)) {
             S->Flags |= SF_FIXED;
         }
@@ -407,14 +435,7 @@ SymEntry* SymFind (SymTable* Scope, const StrBuf* Name, SymFindAction Action)
             N->Flags |= SF_FIXED;
         }
         N->Sym.Tab = Scope;
-        if (S == 0) {
-            Scope->Table[Hash] = N;
-        } else if (Cmp < 0) {
-            S->Left = N;
-        } else {
-            S->Right = N;
-        }
-        ++Scope->TableEntries;
+        HT_Insert (&Scope->Table, N);
         return N;
 
     }
@@ -441,15 +462,14 @@ SymEntry* SymFindAny (SymTable* Scope, const StrBuf* Name)
         ** because for such symbols there is a real entry in one of the parent
         ** scopes.
         */
-        if (SymSearchTree (Scope->Table[Hash % Scope->TableSlots], Name, &Sym) == 0) {
+        Sym = (SymEntry*) HT_FindHash (&Scope->Table, Name, Hash);
+        if (Sym) {
             if (Sym->Flags & SF_UNUSED) {
                 Sym = 0;
             } else {
                 /* Found, return it */
                 break;
             }
-        } else {
-            Sym = 0;
         }
 
         /* Not found, search in the parent scope, if we have one */
@@ -42,6 +42,7 @@
 
 /* common */
 #include "exprdefs.h"
+#include "hashtab.h"
 #include "inline.h"
 
 /* ca65 */
@@ -70,11 +71,10 @@ typedef enum {
 /* A symbol table */
 typedef struct SymTable SymTable;
 struct SymTable {
+    HashNode            Node;           /* Node in the parent's child table */
     SymTable*           Next;           /* Pointer to next table in list */
-    SymTable*           Left;           /* Pointer to smaller entry */
-    SymTable*           Right;          /* Pointer to greater entry */
     SymTable*           Parent;         /* Link to enclosing scope if any */
-    SymTable*           Childs;         /* Pointer to child scopes */
+    HashTable           Childs;         /* Child scopes */
     SymEntry*           Label;          /* Scope label */
     Collection          Spans;          /* Spans for this scope */
     unsigned            Id;             /* Scope id */
@@ -82,10 +82,8 @@ struct SymTable {
     unsigned char       AddrSize;       /* Address size */
     unsigned char       Type;           /* Type of the scope */
     unsigned            Level;          /* Lexical level */
-    unsigned            TableSlots;     /* Number of hash table slots */
-    unsigned            TableEntries;   /* Number of entries in the table */
     unsigned            Name;           /* Name of the scope */
-    SymEntry*           Table[1];       /* Dynamic allocation */
+    HashTable           Table;          /* Symbols in this scope */
 };
 
 /* Symbol tables */
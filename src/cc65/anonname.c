@@ -42,6 +42,7 @@
 /* cc65 */
 #include "anonname.h"
 #include "ident.h"
+#include "pch.h"
 
 
 
@@ -53,6 +54,9 @@
 
 static const char AnonTag[] = "$anon";
 
+/* Counter for unique names */
+static unsigned ACount = 0;
+
 
 
 /*****************************************************************************/
@@ -66,7 +70,6 @@ char* AnonName (char* Buf, const char* Spec)
 ** to be IDENTSIZE characters long. A pointer to the buffer is returned.
 */
 {
-    static unsigned ACount = 0;
     xsprintf (Buf, IDENTSIZE, "%s-%s-%04X", AnonTag, Spec, ++ACount);
     return Buf;
 }
@@ -78,3 +81,19 @@ int IsAnonName (const char* Name)
 {
     return (strncmp (Name, AnonTag, sizeof (AnonTag) - 1) == 0);
 }
+
+
+
+void WriteAnonNames (void)
+/* Write the state of the name generator to a precompiled header */
+{
+    PCHWriteVar (ACount);
+}
+
+
+
+void ReadAnonNames (void)
+/* Read the state of the name generator from a precompiled header */
+{
+    ACount = PCHReadVar ();
+}
@@ -52,6 +52,12 @@ char* AnonName (char* Buf, const char* Spec);
 int IsAnonName (const char* Name);
 /* Check if the given symbol name is that of an anonymous symbol */
 
+void WriteAnonNames (void);
+/* Write the state of the name generator to a precompiled header */
+
+void ReadAnonNames (void);
+/* Read the state of the name generator from a precompiled header */
+
 
 
 /* End of anonname.h */
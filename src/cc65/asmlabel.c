@@ -38,10 +38,23 @@
 
 /* common */
 #include "chartype.h"
+#include "thread.h"
 
 /* cc65 */
 #include "asmlabel.h"
 #include "error.h"
+#include "pch.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Number to generate unique labels */
+static unsigned NextLabel = 0;
 
 
 
@@ -54,16 +67,40 @@
 unsigned GetLocalLabel (void)
 /* Get an unused label. Will never return zero. */
 {
-    /* Number to generate unique labels */
-    static unsigned NextLabel = 0;
+    return GetLocalLabels (1);
+}
 
+
+
+unsigned GetLocalLabels (unsigned Count)
+/* Reserve Count consecutive unused labels and return the first one. Will
+** never return zero.
+*/
+{
     /* Check for an overflow */
-    if (NextLabel >= 0xFFFF) {
+    if (Count > 0xFFFF - NextLabel) {
         Internal ("Local label overflow");
     }
 
-    /* Return the next label */
-    return ++NextLabel;
+    /* Return the first of the labels */
+    NextLabel += Count;
+    return NextLabel - Count + 1;
+}
+
+
+
+void WriteLocalLabels (void)
+/* Write the label counter to a precompiled header */
+{
+    PCHWriteVar (NextLabel);
+}
+
+
+
+void ReadLocalLabels (void)
+/* Read the label counter from a precompiled header */
+{
+    NextLabel = PCHReadVar ();
 }
 
 
@@ -74,7 +111,7 @@ const char* LocalLabelName (unsigned L)
 ** again.
 */
 {
-    static char Buf[64];
+    static THREAD_LOCAL char Buf[64];
     sprintf (Buf, "L%04X", L);
     return Buf;
 }
@@ -47,10 +47,21 @@
 unsigned GetLocalLabel (void);
 /* Get an unused assembler label. Will never return zero. */
 
+unsigned GetLocalLabels (unsigned Count);
+/* Reserve Count consecutive unused labels and return the first one. Will
+** never return zero.
+*/
+
+void WriteLocalLabels (void);
+/* Write the label counter to a precompiled header */
+
+void ReadLocalLabels (void);
+/* Read the label counter from a precompiled header */
+
 const char* LocalLabelName (unsigned L);
 /* Make a label name from the given label number. The label name will be
-** created in static storage and overwritten when calling the function
-** again.
+** created in static storage (one per thread) and overwritten when calling
+** the function again.
 */
 
 int IsLocalLabelName (const char* Name);
@@ -39,6 +39,7 @@
 #include "chartype.h"
 #include "check.h"
 #include "debugflag.h"
+#include "thread.h"
 #include "xmalloc.h"
 #include "xsprintf.h"
 
@@ -62,6 +63,12 @@
 /* Empty argument */
 static char EmptyArg[] = "";
 
+/* Pool for code entries. Optimizer threads use pools of their own which are
+** merged into the shared one when the threads are done.
+*/
+static MemPool EntryPool = STATIC_MEMPOOL_INITIALIZER ("CodeEntry", sizeof (CodeEntry));
+static THREAD_LOCAL MemPool* CurEntryPool = &EntryPool;
+
 
 
 /*****************************************************************************/
@@ -220,11 +227,10 @@ const char* MakeHexArg (unsigned Num)
 /* Convert Num into a string in the form $XY, suitable for passing it as an
 ** argument to NewCodeEntry, and return a pointer to the string.
 ** BEWARE: The function returns a pointer to a static buffer, so the value is
-** gone if you call it twice (and apart from that it's not thread and signal
-** safe).
+** gone if you call it twice (and apart from that it's not signal safe).
 */
 {
-    static char Buf[16];
+    static THREAD_LOCAL char Buf[16];
     xsprintf (Buf, sizeof (Buf), "$%02X", (unsigned char) Num);
     return Buf;
 }
@@ -239,7 +245,7 @@ CodeEntry* NewCodeEntry (opc_t OPC, am_t AM, const char* Arg,
     const OPCDesc* D = GetOPCDesc (OPC);
 
     /* Allocate memory */
-    CodeEntry* E = xmalloc (sizeof (CodeEntry));
+    CodeEntry* E = PoolAlloc (CurEntryPool);
 
     /* Initialize the fields */
     E->OPC    = D->OPC;
@@ -251,12 +257,19 @@ CodeEntry* NewCodeEntry (opc_t OPC, am_t AM, const char* Arg,
     E->JumpTo = JumpTo;
     E->LI     = UseLineInfo (LI);
     E->RI     = 0;
+    E->Block  = 0;
+    E->Live   = REG_NONE;
+    E->Index  = 0;
+    E->PrevLabels = 0;
     SetUseChgInfo (E, D);
     InitCollection (&E->Labels);
 
     /* If we have a label given, add this entry to the label */
     if (JumpTo) {
         CollAppend (&JumpTo->JumpFrom, E);
+        if (JumpTo->Owner) {
+            CE_InvalidateRegInfo (JumpTo->Owner);
+        }
     }
 
     /* Return the initialized struct */
@@ -281,7 +294,28 @@ void FreeCodeEntry (CodeEntry* E)
     CE_FreeRegInfo (E);
 
     /* Free the entry */
-    xfree (E);
+    PoolFree (CurEntryPool, E);
+}
+
+
+
+void CE_UsePool (MemPool* P)
+/* Allocate and free code entries in the current thread using the pool P,
+** which must be initialized for objects of type CodeEntry. It must be merged
+** into the shared pool by CE_MergePool after the thread has terminated.
+*/
+{
+    CurEntryPool = P;
+}
+
+
+
+void CE_MergePool (MemPool* P)
+/* Move all memory of a pool passed to CE_UsePool into the shared pool. The
+** thread that used the pool must have terminated.
+*/
+{
+    PoolMerge (&EntryPool, P);
 }
 
 
@@ -299,6 +333,9 @@ void CE_ReplaceOPC (CodeEntry* E, opc_t OPC)
     E->Info = D->Info;
     E->Size = GetInsnSize (E->OPC, E->AM);
     SetUseChgInfo (E, D);
+
+    /* The register info for this entry is outdated */
+    CE_InvalidateRegInfo (E);
 }
 
 
@@ -319,6 +356,9 @@ void CE_AttachLabel (CodeEntry* E, CodeLabel* L)
 
     /* Tell the label about it's owner */
     L->Owner = E;
+
+    /* Jumps to the label do now influence the register info of E */
+    CE_InvalidateRegInfo (E);
 }
 
 
@@ -335,6 +375,9 @@ void CE_ClearJumpTo (CodeEntry* E)
     /* Clear the argument and assign the empty one */
     FreeArg (E->Arg);
     E->Arg = EmptyArg;
+
+    /* The register info for this entry is outdated */
+    CE_InvalidateRegInfo (E);
 }
 
 
@@ -344,10 +387,12 @@ void CE_MoveLabel (CodeLabel* L, CodeEntry* E)
 {
     /* Delete the label from the owner */
     CollDeleteItem (&L->Owner->Labels, L);
+    CE_InvalidateRegInfo (L->Owner);
 
     /* Set the new owner */
     CollAppend (&E->Labels, L);
     L->Owner = E;
+    CE_InvalidateRegInfo (E);
 }
 
 
@@ -364,6 +409,9 @@ void CE_SetArg (CodeEntry* E, const char* Arg)
     /* Update the Use and Chg in E */
     const OPCDesc* D = GetOPCDesc (E->OPC);
     SetUseChgInfo (E, D);
+
+    /* The register info for this entry is outdated */
+    CE_InvalidateRegInfo (E);
 }
 
 
@@ -482,6 +530,58 @@ int CE_UseLoadFlags (CodeEntry* E)
 
 
 
+CodeBlock* NewCodeBlock (CodeEntry* E, Collection* Changed)
+/* Create a new block that starts with E and return it */
+{
+    /* Allocate memory */
+    CodeBlock* B = xmalloc (sizeof (CodeBlock));
+
+    /* Initialize the fields */
+    B->First   = E;
+    B->Changed = Changed;
+    B->Index   = 0;
+    B->Flags   = 0;
+
+    /* E is now part of the block */
+    E->Block = B;
+
+    /* Return the new struct */
+    return B;
+}
+
+
+
+void CE_InvalidateRegInfo (CodeEntry* E)
+/* Mark the register info of the given entry as outdated. If the entry isn't
+** the first one of its block, it is made the first one of a new block.
+*/
+{
+    CodeBlock* B = E->Block;
+
+    /* Nothing to do if there is no register info */
+    if (B == 0) {
+        return;
+    }
+
+    /* The register liveness is updated starting with the first entries of
+    ** the changed blocks, so E must be one of them. The block boundaries
+    ** are corrected when the register info is updated.
+    */
+    if (B->First != E) {
+        B = NewCodeBlock (E, B->Changed);
+    }
+
+    /* Add the block to the list of changed blocks. If the liveness was
+    ** already updated for it, it is added once more.
+    */
+    if ((B->Flags & (CBF_CHANGED | CBF_LIVECHANGED)) != (CBF_CHANGED | CBF_LIVECHANGED)) {
+        B->Flags |= (CBF_CHANGED | CBF_LIVECHANGED);
+        CollAppend (B->Changed, B);
+    }
+}
+
+
+
 void CE_FreeRegInfo (CodeEntry* E)
 /* Free an existing register info struct */
 {
@@ -1404,6 +1504,10 @@ void CE_Output (const CodeEntry* E)
     unsigned I;
     for (I = 0; I < LabelCount; ++I) {
         CL_Output (CollConstAt (&E->Labels, I));
+        if (I + 1 < LabelCount) {
+            /* More labels follow, each one needs a line of its own */
+            WriteOutput ("\n");
+        }
     }
 
     /* Get the opcode description */
@@ -43,6 +43,7 @@
 /* common */
 #include "coll.h"
 #include "inline.h"
+#include "xmalloc.h"
 
 /* cc65 */
 #include "codelab.h"
@@ -62,6 +63,29 @@
 #define CEF_USERMARK    0x0001U         /* Generic mark by user functions */
 #define CEF_NUMARG      0x0002U         /* Insn has numerical argument */
 #define CEF_DONT_REMOVE 0x0004U         /* Insn shouldn't be removed, marked by user functions */
+#define CEF_LIVEQUEUED  0x0008U         /* Queued for the liveness update */
+
+/* Flags for the code blocks */
+#define CBF_CHANGED     0x01U           /* Code in the block was changed */
+#define CBF_QUEUED      0x02U           /* Queued for the first run */
+#define CBF_QUEUED2     0x04U           /* Queued for the second run */
+#define CBF_BACKREF     0x08U           /* Block is target of a backward jump */
+#define CBF_LIVECHANGED 0x10U           /* Changed since the liveness update */
+
+/* Basic block used to keep the register info up to date. A block starts with
+** the first entry of a code segment or with an entry that has labels, and
+** it ends before the next such entry. Between two updates of the register
+** info, First may also point to an entry inside of a block that was changed.
+** Each changed entry is the first one of a block in the list of changed
+** blocks, so the register liveness can be updated from that list.
+*/
+typedef struct CodeBlock CodeBlock;
+struct CodeBlock {
+    struct CodeEntry*   First;          /* First entry, NULL if unused */
+    Collection*         Changed;        /* List of changed blocks */
+    unsigned            Index;          /* Index of First when queued */
+    unsigned char       Flags;          /* Flags */
+};
 
 /* Code entry structure */
 typedef struct CodeEntry CodeEntry;
@@ -79,6 +103,10 @@ struct CodeEntry {
     Collection          Labels;         /* Labels for this instruction */
     LineInfo*           LI;             /* Source line info for this insn */
     RegInfo*            RI;             /* Register info for this insn */
+    CodeBlock*          Block;          /* Block containing this insn */
+    unsigned short      Live;           /* CS_LIVE_REGS live before this insn */
+    unsigned            Index;          /* Cached index in the code segment */
+    unsigned            PrevLabels;     /* Cached number of labeled entries before */
 };
 
 
@@ -104,6 +132,17 @@ CodeEntry* NewCodeEntry (opc_t OPC, am_t AM, const char* Arg,
 void FreeCodeEntry (CodeEntry* E);
 /* Free the given code entry */
 
+void CE_UsePool (MemPool* P);
+/* Allocate and free code entries in the current thread using the pool P,
+** which must be initialized for objects of type CodeEntry. It must be merged
+** into the shared pool by CE_MergePool after the thread has terminated.
+*/
+
+void CE_MergePool (MemPool* P);
+/* Move all memory of a pool passed to CE_UsePool into the shared pool. The
+** thread that used the pool must have terminated.
+*/
+
 void CE_ReplaceOPC (CodeEntry* E, opc_t OPC);
 /* Replace the opcode of the instruction. This will also replace related info,
 ** Size, Use and Chg, but it will NOT update any arguments or labels.
@@ -184,6 +223,14 @@ INLINE void CE_ResetMark (CodeEntry* E)
 #  define CE_ResetMark(E)       ((E)->Flags &= ~CEF_USERMARK)
 #endif
 
+CodeBlock* NewCodeBlock (CodeEntry* E, Collection* Changed);
+/* Create a new block that starts with E and return it */
+
+void CE_InvalidateRegInfo (CodeEntry* E);
+/* Mark the register info of the given entry as outdated. If the entry isn't
+** the first one of its block, it is made the first one of a new block.
+*/
+
 #if defined(HAVE_INLINE)
 INLINE int CE_HasNumArg (const CodeEntry* E)
 /* Return true if the instruction has a numeric argument */
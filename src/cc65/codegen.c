@@ -244,7 +244,12 @@ void g_segname (segment_t Seg)
         default:         S = 0;          break;
     }
     if (S) {
-        DS_AddLine (S, ".segment\t\"%s\"", GetSegName (Seg));
+        if (FunctionSections && S->Func) {
+            DS_AddLine (S, ".segment\t\"%s\", \"%s\"",
+                        GetSegName (Seg), S->Func->Name);
+        } else {
+            DS_AddLine (S, ".segment\t\"%s\"", GetSegName (Seg));
+        }
     }
 }
 
@@ -444,7 +449,7 @@ void g_enter (unsigned flags, unsigned argsize)
         funcargs = argsize;
     } else {
         funcargs = -1;
-        AddCodeLine ("jsr enter");
+        AddCode (OP65_JSR, AM65_ABS, "enter", 0);
     }
 }
 
@@ -467,21 +472,21 @@ void g_leave (void)
         /* We've a stack frame to drop */
         if (ToDrop > 255) {
             g_drop (ToDrop);            /* Inlines the code */
-            AddCodeLine ("jsr leave");
+            AddCode (OP65_JSR, AM65_ABS, "leave", 0);
         } else {
-            AddCodeLine ("ldy #$%02X", ToDrop);
-            AddCodeLine ("jsr leavey");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", ToDrop);
+            AddCode (OP65_JSR, AM65_ABS, "leavey", 0);
         }
 
     } else {
 
         /* Nothing to drop */
-        AddCodeLine ("jsr leave");
+        AddCode (OP65_JSR, AM65_ABS, "leave", 0);
 
     }
 
     /* Add the final rts */
-    AddCodeLine ("rts");
+    AddCodeImp (OP65_RTS);
 }
 
 
@@ -500,30 +505,30 @@ void g_swap_regvars (int StackOffs, int RegOffs, unsigned Bytes)
     CheckLocalOffs (StackOffs);
 
     /* Generate code */
-    AddCodeLine ("ldy #$%02X", StackOffs & 0xFF);
+    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", StackOffs & 0xFF);
     if (Bytes == 1) {
 
         if (IS_Get (&CodeSizeFactor) < 165) {
-            AddCodeLine ("ldx #$%02X", RegOffs & 0xFF);
-            AddCodeLine ("jsr regswap1");
+            AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", RegOffs & 0xFF);
+            AddCode (OP65_JSR, AM65_ABS, "regswap1", 0);
         } else {
-            AddCodeLine ("lda (sp),y");
-            AddCodeLine ("ldx regbank%+d", RegOffs);
-            AddCodeLine ("sta regbank%+d", RegOffs);
-            AddCodeLine ("txa");
-            AddCodeLine ("sta (sp),y");
+            AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+            AddCodeArg (OP65_LDX, AM65_ABS, "regbank%+d", RegOffs);
+            AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs);
+            AddCodeImp (OP65_TXA);
+            AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
         }
 
     } else if (Bytes == 2) {
 
-        AddCodeLine ("ldx #$%02X", RegOffs & 0xFF);
-        AddCodeLine ("jsr regswap2");
+        AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", RegOffs & 0xFF);
+        AddCode (OP65_JSR, AM65_ABS, "regswap2", 0);
 
     } else {
 
-        AddCodeLine ("ldx #$%02X", RegOffs & 0xFF);
-        AddCodeLine ("lda #$%02X", Bytes & 0xFF);
-        AddCodeLine ("jsr regswap");
+        AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", RegOffs & 0xFF);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", Bytes & 0xFF);
+        AddCode (OP65_JSR, AM65_ABS, "regswap", 0);
     }
 }
 
@@ -535,28 +540,28 @@ void g_save_regvars (int RegOffs, unsigned Bytes)
     /* Don't loop for up to two bytes */
     if (Bytes == 1) {
 
-        AddCodeLine ("lda regbank%+d", RegOffs);
-        AddCodeLine ("jsr pusha");
+        AddCodeArg (OP65_LDA, AM65_ABS, "regbank%+d", RegOffs);
+        AddCode (OP65_JSR, AM65_ABS, "pusha", 0);
 
     } else if (Bytes == 2) {
 
-        AddCodeLine ("lda regbank%+d", RegOffs);
-        AddCodeLine ("ldx regbank%+d", RegOffs+1);
-        AddCodeLine ("jsr pushax");
+        AddCodeArg (OP65_LDA, AM65_ABS, "regbank%+d", RegOffs);
+        AddCodeArg (OP65_LDX, AM65_ABS, "regbank%+d", RegOffs+1);
+        AddCode (OP65_JSR, AM65_ABS, "pushax", 0);
 
     } else {
 
         /* More than two bytes - loop */
         unsigned Label = GetLocalLabel ();
         g_space (Bytes);
-        AddCodeLine ("ldy #$%02X", (unsigned char) (Bytes - 1));
-        AddCodeLine ("ldx #$%02X", (unsigned char) Bytes);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Bytes - 1));
+        AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) Bytes);
         g_defcodelabel (Label);
-        AddCodeLine ("lda regbank%+d,x", RegOffs-1);
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("dey");
-        AddCodeLine ("dex");
-        AddCodeLine ("bne %s", LocalLabelName (Label));
+        AddCodeArg (OP65_LDA, AM65_ABSX, "regbank%+d", RegOffs-1);
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_DEY);
+        AddCodeImp (OP65_DEX);
+        AddCodeBranch (OP65_BNE, Label);
 
     }
 
@@ -576,30 +581,30 @@ void g_restore_regvars (int StackOffs, int RegOffs, unsigned Bytes)
     /* Don't loop for up to two bytes */
     if (Bytes == 1) {
 
-        AddCodeLine ("ldy #$%02X", StackOffs);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", StackOffs);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs);
 
     } else if (Bytes == 2) {
 
-        AddCodeLine ("ldy #$%02X", StackOffs);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs);
-        AddCodeLine ("iny");
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs+1);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", StackOffs);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs);
+        AddCodeImp (OP65_INY);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs+1);
 
     } else if (Bytes == 3 && IS_Get (&CodeSizeFactor) >= 133) {
 
-        AddCodeLine ("ldy #$%02X", StackOffs);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs);
-        AddCodeLine ("iny");
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs+1);
-        AddCodeLine ("iny");
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d", RegOffs+2);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", StackOffs);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs);
+        AddCodeImp (OP65_INY);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs+1);
+        AddCodeImp (OP65_INY);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABS, "regbank%+d", RegOffs+2);
 
     } else if (StackOffs <= RegOffs) {
 
@@ -608,13 +613,13 @@ void g_restore_regvars (int StackOffs, int RegOffs, unsigned Bytes)
         ** code that uses just one index register.
         */
         unsigned Label = GetLocalLabel ();
-        AddCodeLine ("ldy #$%02X", StackOffs);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", StackOffs);
         g_defcodelabel (Label);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d,y", RegOffs - StackOffs);
-        AddCodeLine ("iny");
-        AddCodeLine ("cpy #$%02X", StackOffs + Bytes);
-        AddCodeLine ("bne %s", LocalLabelName (Label));
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABSY, "regbank%+d", RegOffs - StackOffs);
+        AddCodeImp (OP65_INY);
+        AddCodeArg (OP65_CPY, AM65_IMM, "$%02X", StackOffs + Bytes);
+        AddCodeBranch (OP65_BNE, Label);
 
     } else {
 
@@ -622,16 +627,16 @@ void g_restore_regvars (int StackOffs, int RegOffs, unsigned Bytes)
         ** caller will only save A.
         */
         unsigned Label = GetLocalLabel ();
-        AddCodeLine ("stx tmp1");
-        AddCodeLine ("ldy #$%02X", (unsigned char) (StackOffs + Bytes - 1));
-        AddCodeLine ("ldx #$%02X", (unsigned char) (Bytes - 1));
+        AddCode (OP65_STX, AM65_ZP, "tmp1", 0);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (StackOffs + Bytes - 1));
+        AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) (Bytes - 1));
         g_defcodelabel (Label);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta regbank%+d,x", RegOffs);
-        AddCodeLine ("dey");
-        AddCodeLine ("dex");
-        AddCodeLine ("bpl %s", LocalLabelName (Label));
-        AddCodeLine ("ldx tmp1");
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCodeArg (OP65_STA, AM65_ABSX, "regbank%+d", RegOffs);
+        AddCodeImp (OP65_DEY);
+        AddCodeImp (OP65_DEX);
+        AddCodeBranch (OP65_BPL, Label);
+        AddCode (OP65_LDX, AM65_ZP, "tmp1", 0);
 
     }
 }
@@ -658,13 +663,13 @@ void g_getimmed (unsigned Flags, unsigned long Val, long Offs)
 
             case CF_CHAR:
                 if ((Flags & CF_FORCECHAR) != 0) {
-                    AddCodeLine ("lda #$%02X", (unsigned char) Val);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Val);
                     break;
                 }
                 /* FALL THROUGH */
             case CF_INT:
-                AddCodeLine ("ldx #$%02X", (unsigned char) (Val >> 8));
-                AddCodeLine ("lda #$%02X", (unsigned char) Val);
+                AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) (Val >> 8));
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Val);
                 break;
 
             case CF_LONG:
@@ -678,35 +683,35 @@ void g_getimmed (unsigned Flags, unsigned long Val, long Offs)
                 Done = 0;
 
                 /* Load the value */
-                AddCodeLine ("ldx #$%02X", B2);
+                AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", B2);
                 Done |= 0x02;
                 if (B2 == B3) {
-                    AddCodeLine ("stx sreg");
+                    AddCode (OP65_STX, AM65_ZP, "sreg", 0);
                     Done |= 0x04;
                 }
                 if (B2 == B4) {
-                    AddCodeLine ("stx sreg+1");
+                    AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
                     Done |= 0x08;
                 }
                 if ((Done & 0x04) == 0 && B1 != B3) {
-                    AddCodeLine ("lda #$%02X", B3);
-                    AddCodeLine ("sta sreg");
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", B3);
+                    AddCode (OP65_STA, AM65_ZP, "sreg", 0);
                     Done |= 0x04;
                 }
                 if ((Done & 0x08) == 0 && B1 != B4) {
-                    AddCodeLine ("lda #$%02X", B4);
-                    AddCodeLine ("sta sreg+1");
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", B4);
+                    AddCode (OP65_STA, AM65_ZP, "sreg+1", 0);
                     Done |= 0x08;
                 }
-                AddCodeLine ("lda #$%02X", B1);
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", B1);
                 Done |= 0x01;
                 if ((Done & 0x04) == 0) {
                     CHECK (B1 == B3);
-                    AddCodeLine ("sta sreg");
+                    AddCode (OP65_STA, AM65_ZP, "sreg", 0);
                 }
                 if ((Done & 0x08) == 0) {
                     CHECK (B1 == B4);
-                    AddCodeLine ("sta sreg+1");
+                    AddCode (OP65_STA, AM65_ZP, "sreg+1", 0);
                 }
                 break;
 
@@ -722,8 +727,8 @@ void g_getimmed (unsigned Flags, unsigned long Val, long Offs)
         const char* Label = GetLabelName (Flags, Val, Offs);
 
         /* Load the address into the primary */
-        AddCodeLine ("lda #<(%s)", Label);
-        AddCodeLine ("ldx #>(%s)", Label);
+        AddCodeArg (OP65_LDA, AM65_IMM, "<(%s)", Label);
+        AddCodeArg (OP65_LDX, AM65_IMM, ">(%s)", Label);
 
     }
 }
@@ -741,42 +746,42 @@ void g_getstatic (unsigned flags, uintptr_t label, long offs)
 
         case CF_CHAR:
             if ((flags & CF_FORCECHAR) || (flags & CF_TEST)) {
-                AddCodeLine ("lda %s", lbuf);   /* load A from the label */
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);   /* load A from the label */
             } else {
-                AddCodeLine ("ldx #$00");
-                AddCodeLine ("lda %s", lbuf);   /* load A from the label */
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);   /* load A from the label */
                 if (!(flags & CF_UNSIGNED)) {
                     /* Must sign extend */
                     unsigned L = GetLocalLabel ();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
             }
             break;
 
         case CF_INT:
-            AddCodeLine ("lda %s", lbuf);
+            AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
             if (flags & CF_TEST) {
-                AddCodeLine ("ora %s+1", lbuf);
+                AddCodeArg (OP65_ORA, AM65_ABS, "%s+1", lbuf);
             } else {
-                AddCodeLine ("ldx %s+1", lbuf);
+                AddCodeArg (OP65_LDX, AM65_ABS, "%s+1", lbuf);
             }
             break;
 
         case CF_LONG:
             if (flags & CF_TEST) {
-                AddCodeLine ("lda %s+3", lbuf);
-                AddCodeLine ("ora %s+2", lbuf);
-                AddCodeLine ("ora %s+1", lbuf);
-                AddCodeLine ("ora %s+0", lbuf);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s+3", lbuf);
+                AddCodeArg (OP65_ORA, AM65_ABS, "%s+2", lbuf);
+                AddCodeArg (OP65_ORA, AM65_ABS, "%s+1", lbuf);
+                AddCodeArg (OP65_ORA, AM65_ABS, "%s+0", lbuf);
             } else {
-                AddCodeLine ("lda %s+3", lbuf);
-                AddCodeLine ("sta sreg+1");
-                AddCodeLine ("lda %s+2", lbuf);
-                AddCodeLine ("sta sreg");
-                AddCodeLine ("ldx %s+1", lbuf);
-                AddCodeLine ("lda %s", lbuf);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s+3", lbuf);
+                AddCode (OP65_STA, AM65_ZP, "sreg+1", 0);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s+2", lbuf);
+                AddCode (OP65_STA, AM65_ZP, "sreg", 0);
+                AddCodeArg (OP65_LDX, AM65_ABS, "%s+1", lbuf);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
             }
             break;
 
@@ -797,16 +802,16 @@ void g_getlocal (unsigned Flags, int Offs)
         case CF_CHAR:
             CheckLocalOffs (Offs);
             if ((Flags & CF_FORCECHAR) || (Flags & CF_TEST)) {
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("lda (sp),y");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
             } else {
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("ldx #$00");
-                AddCodeLine ("lda (sp),y");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
                 if ((Flags & CF_UNSIGNED) == 0) {
                     unsigned L = GetLocalLabel();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
             }
@@ -814,20 +819,20 @@ void g_getlocal (unsigned Flags, int Offs)
 
         case CF_INT:
             CheckLocalOffs (Offs + 1);
-            AddCodeLine ("ldy #$%02X", (unsigned char) (Offs+1));
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Offs+1));
             if (Flags & CF_TEST) {
-                AddCodeLine ("lda (sp),y");
-                AddCodeLine ("dey");
-                AddCodeLine ("ora (sp),y");
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                AddCodeImp (OP65_DEY);
+                AddCode (OP65_ORA, AM65_ZP_INDY, "sp", 0);
             } else {
-                AddCodeLine ("jsr ldaxysp");
+                AddCode (OP65_JSR, AM65_ABS, "ldaxysp", 0);
             }
             break;
 
         case CF_LONG:
             CheckLocalOffs (Offs + 3);
-            AddCodeLine ("ldy #$%02X", (unsigned char) (Offs+3));
-            AddCodeLine ("jsr ldeaxysp");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Offs+3));
+            AddCode (OP65_JSR, AM65_ABS, "ldeaxysp", 0);
             if (Flags & CF_TEST) {
                 g_test (Flags);
             }
@@ -856,31 +861,31 @@ void g_getind (unsigned Flags, unsigned Offs)
 
         case CF_CHAR:
             /* Character sized */
-            AddCodeLine ("ldy #$%02X", Offs);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
             if (Flags & CF_UNSIGNED) {
-                AddCodeLine ("jsr ldauidx");
+                AddCode (OP65_JSR, AM65_ABS, "ldauidx", 0);
             } else {
-                AddCodeLine ("jsr ldaidx");
+                AddCode (OP65_JSR, AM65_ABS, "ldaidx", 0);
             }
             break;
 
         case CF_INT:
             if (Flags & CF_TEST) {
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("sta ptr1");
-                AddCodeLine ("stx ptr1+1");
-                AddCodeLine ("lda (ptr1),y");
-                AddCodeLine ("iny");
-                AddCodeLine ("ora (ptr1),y");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+                AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "ptr1", 0);
+                AddCodeImp (OP65_INY);
+                AddCode (OP65_ORA, AM65_ZP_INDY, "ptr1", 0);
             } else {
-                AddCodeLine ("ldy #$%02X", Offs+1);
-                AddCodeLine ("jsr ldaxidx");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs+1);
+                AddCode (OP65_JSR, AM65_ABS, "ldaxidx", 0);
             }
             break;
 
         case CF_LONG:
-            AddCodeLine ("ldy #$%02X", Offs+3);
-            AddCodeLine ("jsr ldeaxidx");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs+3);
+            AddCode (OP65_JSR, AM65_ABS, "ldeaxidx", 0);
             if (Flags & CF_TEST) {
                 g_test (Flags);
             }
@@ -909,50 +914,50 @@ void g_leasp (int Offs)
     /* Generate code */
     if (Lo == 0) {
         if (Hi <= 3) {
-            AddCodeLine ("lda sp");
-            AddCodeLine ("ldx sp+1");
+            AddCode (OP65_LDA, AM65_ZP, "sp", 0);
+            AddCode (OP65_LDX, AM65_ZP, "sp+1", 0);
             while (Hi--) {
-                AddCodeLine ("inx");
+                AddCodeImp (OP65_INX);
             }
         } else {
-            AddCodeLine ("lda sp+1");
-            AddCodeLine ("clc");
-            AddCodeLine ("adc #$%02X", Hi);
-            AddCodeLine ("tax");
-            AddCodeLine ("lda sp");
+            AddCode (OP65_LDA, AM65_ZP, "sp+1", 0);
+            AddCodeImp (OP65_CLC);
+            AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", Hi);
+            AddCodeImp (OP65_TAX);
+            AddCode (OP65_LDA, AM65_ZP, "sp", 0);
         }
     } else if (Hi == 0) {
         /* 8 bit offset */
         if (IS_Get (&CodeSizeFactor) < 200) {
             /* 8 bit offset with subroutine call */
-            AddCodeLine ("lda #$%02X", Lo);
-            AddCodeLine ("jsr leaa0sp");
+            AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", Lo);
+            AddCode (OP65_JSR, AM65_ABS, "leaa0sp", 0);
         } else {
             /* 8 bit offset inlined */
             unsigned L = GetLocalLabel ();
-            AddCodeLine ("lda sp");
-            AddCodeLine ("ldx sp+1");
-            AddCodeLine ("clc");
-            AddCodeLine ("adc #$%02X", Lo);
-            AddCodeLine ("bcc %s", LocalLabelName (L));
-            AddCodeLine ("inx");
+            AddCode (OP65_LDA, AM65_ZP, "sp", 0);
+            AddCode (OP65_LDX, AM65_ZP, "sp+1", 0);
+            AddCodeImp (OP65_CLC);
+            AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", Lo);
+            AddCodeBranch (OP65_BCC, L);
+            AddCodeImp (OP65_INX);
             g_defcodelabel (L);
         }
     } else if (IS_Get (&CodeSizeFactor) < 170) {
         /* Full 16 bit offset with subroutine call */
-        AddCodeLine ("lda #$%02X", Lo);
-        AddCodeLine ("ldx #$%02X", Hi);
-        AddCodeLine ("jsr leaaxsp");
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", Lo);
+        AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", Hi);
+        AddCode (OP65_JSR, AM65_ABS, "leaaxsp", 0);
     } else {
         /* Full 16 bit offset inlined */
-        AddCodeLine ("lda sp");
-        AddCodeLine ("clc");
-        AddCodeLine ("adc #$%02X", Lo);
-        AddCodeLine ("pha");
-        AddCodeLine ("lda sp+1");
-        AddCodeLine ("adc #$%02X", Hi);
-        AddCodeLine ("tax");
-        AddCodeLine ("pla");
+        AddCode (OP65_LDA, AM65_ZP, "sp", 0);
+        AddCodeImp (OP65_CLC);
+        AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", Lo);
+        AddCodeImp (OP65_PHA);
+        AddCode (OP65_LDA, AM65_ZP, "sp+1", 0);
+        AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", Hi);
+        AddCodeImp (OP65_TAX);
+        AddCodeImp (OP65_PLA);
     }
 }
 
@@ -976,21 +981,21 @@ void g_leavariadic (int Offs)
     CheckLocalOffs (ArgSizeOffs);
 
     /* Get the size of all parameters. */
-    AddCodeLine ("ldy #$%02X", ArgSizeOffs);
-    AddCodeLine ("lda (sp),y");
+    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", ArgSizeOffs);
+    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
 
     /* Add the value of the stackpointer */
     if (IS_Get (&CodeSizeFactor) > 250) {
         unsigned L = GetLocalLabel();
-        AddCodeLine ("ldx sp+1");
-        AddCodeLine ("clc");
-        AddCodeLine ("adc sp");
-        AddCodeLine ("bcc %s", LocalLabelName (L));
-        AddCodeLine ("inx");
+        AddCode (OP65_LDX, AM65_ZP, "sp+1", 0);
+        AddCodeImp (OP65_CLC);
+        AddCode (OP65_ADC, AM65_ZP, "sp", 0);
+        AddCodeBranch (OP65_BCC, L);
+        AddCodeImp (OP65_INX);
         g_defcodelabel (L);
     } else {
-        AddCodeLine ("ldx #$00");
-        AddCodeLine ("jsr leaaxsp");
+        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+        AddCode (OP65_JSR, AM65_ABS, "leaaxsp", 0);
     }
 
     /* Add the offset to the primary */
@@ -1019,21 +1024,21 @@ void g_putstatic (unsigned flags, uintptr_t label, long offs)
     switch (flags & CF_TYPEMASK) {
 
         case CF_CHAR:
-            AddCodeLine ("sta %s", lbuf);
+            AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
             break;
 
         case CF_INT:
-            AddCodeLine ("sta %s", lbuf);
-            AddCodeLine ("stx %s+1", lbuf);
+            AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
+            AddCodeArg (OP65_STX, AM65_ABS, "%s+1", lbuf);
             break;
 
         case CF_LONG:
-            AddCodeLine ("sta %s", lbuf);
-            AddCodeLine ("stx %s+1", lbuf);
-            AddCodeLine ("ldy sreg");
-            AddCodeLine ("sty %s+2", lbuf);
-            AddCodeLine ("ldy sreg+1");
-            AddCodeLine ("sty %s+3", lbuf);
+            AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
+            AddCodeArg (OP65_STX, AM65_ABS, "%s+1", lbuf);
+            AddCode (OP65_LDY, AM65_ZP, "sreg", 0);
+            AddCodeArg (OP65_STY, AM65_ABS, "%s+2", lbuf);
+            AddCode (OP65_LDY, AM65_ZP, "sreg+1", 0);
+            AddCodeArg (OP65_STY, AM65_ABS, "%s+3", lbuf);
             break;
 
         default:
@@ -1053,39 +1058,39 @@ void g_putlocal (unsigned Flags, int Offs, long Val)
 
         case CF_CHAR:
             if (Flags & CF_CONST) {
-                AddCodeLine ("lda #$%02X", (unsigned char) Val);
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Val);
             }
-            AddCodeLine ("ldy #$%02X", Offs);
-            AddCodeLine ("sta (sp),y");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+            AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
             break;
 
         case CF_INT:
             if (Flags & CF_CONST) {
-                AddCodeLine ("ldy #$%02X", Offs+1);
-                AddCodeLine ("lda #$%02X", (unsigned char) (Val >> 8));
-                AddCodeLine ("sta (sp),y");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs+1);
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) (Val >> 8));
+                AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
                 if ((Flags & CF_NOKEEP) == 0) {
                     /* Place high byte into X */
-                    AddCodeLine ("tax");
+                    AddCodeImp (OP65_TAX);
                 }
                 if ((Val & 0xFF) == Offs+1) {
                     /* The value we need is already in Y */
-                    AddCodeLine ("tya");
-                    AddCodeLine ("dey");
+                    AddCodeImp (OP65_TYA);
+                    AddCodeImp (OP65_DEY);
                 } else {
-                    AddCodeLine ("dey");
-                    AddCodeLine ("lda #$%02X", (unsigned char) Val);
+                    AddCodeImp (OP65_DEY);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Val);
                 }
-                AddCodeLine ("sta (sp),y");
+                AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
             } else {
-                AddCodeLine ("ldy #$%02X", Offs);
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
                 if ((Flags & CF_NOKEEP) == 0 || IS_Get (&CodeSizeFactor) < 160) {
-                    AddCodeLine ("jsr staxysp");
+                    AddCode (OP65_JSR, AM65_ABS, "staxysp", 0);
                 } else {
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("iny");
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sta (sp),y");
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_INY);
+                    AddCodeImp (OP65_TXA);
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
                 }
             }
             break;
@@ -1094,8 +1099,8 @@ void g_putlocal (unsigned Flags, int Offs, long Val)
             if (Flags & CF_CONST) {
                 g_getimmed (Flags, Val, 0);
             }
-            AddCodeLine ("ldy #$%02X", Offs);
-            AddCodeLine ("jsr steaxysp");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+            AddCode (OP65_JSR, AM65_ABS, "steaxysp", 0);
             break;
 
         default:
@@ -1119,17 +1124,17 @@ void g_putind (unsigned Flags, unsigned Offs)
     if ((Offs & 0xFF) > 256 - sizeofarg (Flags | CF_FORCECHAR)) {
 
         /* Overflow - we need to add the low byte also */
-        AddCodeLine ("ldy #$00");
-        AddCodeLine ("clc");
-        AddCodeLine ("pha");
-        AddCodeLine ("lda #$%02X", Offs & 0xFF);
-        AddCodeLine ("adc (sp),y");
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("iny");
-        AddCodeLine ("lda #$%02X", (Offs >> 8) & 0xFF);
-        AddCodeLine ("adc (sp),y");
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("pla");
+        AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+        AddCodeImp (OP65_CLC);
+        AddCodeImp (OP65_PHA);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", Offs & 0xFF);
+        AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_INY);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (Offs >> 8) & 0xFF);
+        AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_PLA);
 
         /* Complete address is on stack, new offset is zero */
         Offs = 0;
@@ -1137,32 +1142,32 @@ void g_putind (unsigned Flags, unsigned Offs)
     } else if ((Offs & 0xFF00) != 0) {
 
         /* We can just add the high byte */
-        AddCodeLine ("ldy #$01");
-        AddCodeLine ("clc");
-        AddCodeLine ("pha");
-        AddCodeLine ("lda #$%02X", (Offs >> 8) & 0xFF);
-        AddCodeLine ("adc (sp),y");
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("pla");
+        AddCode (OP65_LDY, AM65_IMM, "$01", 0);
+        AddCodeImp (OP65_CLC);
+        AddCodeImp (OP65_PHA);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (Offs >> 8) & 0xFF);
+        AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_PLA);
 
         /* Offset is now just the low byte */
         Offs &= 0x00FF;
     }
 
     /* Check the size and determine operation */
-    AddCodeLine ("ldy #$%02X", Offs);
+    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
     switch (Flags & CF_TYPEMASK) {
 
         case CF_CHAR:
-            AddCodeLine ("jsr staspidx");
+            AddCode (OP65_JSR, AM65_ABS, "staspidx", 0);
             break;
 
         case CF_INT:
-            AddCodeLine ("jsr staxspidx");
+            AddCode (OP65_JSR, AM65_ABS, "staxspidx", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr steaxspidx");
+            AddCode (OP65_JSR, AM65_ABS, "steaxspidx", 0);
             break;
 
         default:
@@ -1190,9 +1195,9 @@ void g_toslong (unsigned flags)
         case CF_CHAR:
         case CF_INT:
             if (flags & CF_UNSIGNED) {
-                AddCodeLine ("jsr tosulong");
+                AddCode (OP65_JSR, AM65_ABS, "tosulong", 0);
             } else {
-                AddCodeLine ("jsr toslong");
+                AddCode (OP65_JSR, AM65_ABS, "toslong", 0);
             }
             push (CF_INT);
             break;
@@ -1217,7 +1222,7 @@ void g_tosint (unsigned flags)
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr tosint");
+            AddCode (OP65_JSR, AM65_ABS, "tosint", 0);
             pop (CF_INT);
             break;
 
@@ -1233,14 +1238,14 @@ static void g_regchar (unsigned Flags)
 {
     unsigned L;
 
-    AddCodeLine ("ldx #$00");
+    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
 
     if ((Flags & CF_UNSIGNED) == 0) {
         /* Sign extend */
         L = GetLocalLabel();
-        AddCodeLine ("cmp #$80");
-        AddCodeLine ("bcc %s", LocalLabelName (L));
-        AddCodeLine ("dex");
+        AddCode (OP65_CMP, AM65_IMM, "$80", 0);
+        AddCodeBranch (OP65_BCC, L);
+        AddCodeImp (OP65_DEX);
         g_defcodelabel (L);
     }
 }
@@ -1280,19 +1285,19 @@ void g_reglong (unsigned Flags)
                 /* Conversion is from char */
                 if (Flags & CF_UNSIGNED) {
                     if (IS_Get (&CodeSizeFactor) >= 200) {
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("stx sreg");
-                        AddCodeLine ("stx sreg+1");
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCode (OP65_STX, AM65_ZP, "sreg", 0);
+                        AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
                     } else {
-                        AddCodeLine ("jsr aulong");
+                        AddCode (OP65_JSR, AM65_ABS, "aulong", 0);
                     }
                 } else {
                     if (IS_Get (&CodeSizeFactor) >= 366) {
                         g_regchar (Flags);
-                        AddCodeLine ("stx sreg");
-                        AddCodeLine ("stx sreg+1");
+                        AddCode (OP65_STX, AM65_ZP, "sreg", 0);
+                        AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
                     } else {
-                        AddCodeLine ("jsr along");
+                        AddCode (OP65_JSR, AM65_ABS, "along", 0);
                     }
                 }
             }
@@ -1301,14 +1306,14 @@ void g_reglong (unsigned Flags)
         case CF_INT:
             if (Flags & CF_UNSIGNED) {
                 if (IS_Get (&CodeSizeFactor) >= 200) {
-                    AddCodeLine ("ldy #$00");
-                    AddCodeLine ("sty sreg");
-                    AddCodeLine ("sty sreg+1");
+                    AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg+1", 0);
                 } else {
-                    AddCodeLine ("jsr axulong");
+                    AddCode (OP65_JSR, AM65_ABS, "axulong", 0);
                 }
             } else {
-                AddCodeLine ("jsr axlong");
+                AddCode (OP65_JSR, AM65_ABS, "axlong", 0);
             }
             break;
 
@@ -1441,7 +1446,7 @@ void g_scale (unsigned flags, long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         while (p2--) {
-                            AddCodeLine ("asl a");
+                            AddCodeImp (OP65_ASL);
                         }
                         break;
                     }
@@ -1449,17 +1454,17 @@ void g_scale (unsigned flags, long val)
 
                 case CF_INT:
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shlax%d", p2);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shlax%d", p2);
                     } else {
-                        AddCodeLine ("jsr aslax%d", p2);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "aslax%d", p2);
                     }
                     break;
 
                 case CF_LONG:
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shleax%d", p2);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shleax%d", p2);
                     } else {
-                        AddCodeLine ("jsr asleax%d", p2);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "asleax%d", p2);
                     }
                     break;
 
@@ -1509,24 +1514,24 @@ void g_addlocal (unsigned flags, int offs)
 
         case CF_CHAR:
             L = GetLocalLabel();
-            AddCodeLine ("ldy #$%02X", NewOff & 0xFF);
-            AddCodeLine ("clc");
-            AddCodeLine ("adc (sp),y");
-            AddCodeLine ("bcc %s", LocalLabelName (L));
-            AddCodeLine ("inx");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", NewOff & 0xFF);
+            AddCodeImp (OP65_CLC);
+            AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+            AddCodeBranch (OP65_BCC, L);
+            AddCodeImp (OP65_INX);
             g_defcodelabel (L);
             break;
 
         case CF_INT:
-            AddCodeLine ("ldy #$%02X", NewOff & 0xFF);
-            AddCodeLine ("clc");
-            AddCodeLine ("adc (sp),y");
-            AddCodeLine ("pha");
-            AddCodeLine ("txa");
-            AddCodeLine ("iny");
-            AddCodeLine ("adc (sp),y");
-            AddCodeLine ("tax");
-            AddCodeLine ("pla");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", NewOff & 0xFF);
+            AddCodeImp (OP65_CLC);
+            AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+            AddCodeImp (OP65_PHA);
+            AddCodeImp (OP65_TXA);
+            AddCodeImp (OP65_INY);
+            AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+            AddCodeImp (OP65_TAX);
+            AddCodeImp (OP65_PLA);
             break;
 
         case CF_LONG:
@@ -1556,21 +1561,21 @@ void g_addstatic (unsigned flags, uintptr_t label, long offs)
 
         case CF_CHAR:
             L = GetLocalLabel();
-            AddCodeLine ("clc");
-            AddCodeLine ("adc %s", lbuf);
-            AddCodeLine ("bcc %s", LocalLabelName (L));
-            AddCodeLine ("inx");
+            AddCodeImp (OP65_CLC);
+            AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+            AddCodeBranch (OP65_BCC, L);
+            AddCodeImp (OP65_INX);
             g_defcodelabel (L);
             break;
 
         case CF_INT:
-            AddCodeLine ("clc");
-            AddCodeLine ("adc %s", lbuf);
-            AddCodeLine ("tay");
-            AddCodeLine ("txa");
-            AddCodeLine ("adc %s+1", lbuf);
-            AddCodeLine ("tax");
-            AddCodeLine ("tya");
+            AddCodeImp (OP65_CLC);
+            AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+            AddCodeImp (OP65_TAY);
+            AddCodeImp (OP65_TXA);
+            AddCodeArg (OP65_ADC, AM65_ABS, "%s+1", lbuf);
+            AddCodeImp (OP65_TAX);
+            AddCodeImp (OP65_TYA);
             break;
 
         case CF_LONG:
@@ -1606,26 +1611,26 @@ void g_addeqstatic (unsigned flags, uintptr_t label, long offs,
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("ldx #$00");
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                 if (flags & CF_CONST) {
                     if (val == 1) {
-                        AddCodeLine ("inc %s", lbuf);
-                        AddCodeLine ("lda %s", lbuf);
+                        AddCodeArg (OP65_INC, AM65_ABS, "%s", lbuf);
+                        AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
                     } else {
-                        AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-                        AddCodeLine ("clc");
-                        AddCodeLine ("adc %s", lbuf);
-                        AddCodeLine ("sta %s", lbuf);
+                        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                        AddCodeImp (OP65_CLC);
+                        AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                        AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                     }
                 } else {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc %s", lbuf);
-                    AddCodeLine ("sta %s", lbuf);
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                    AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                 }
                 if ((flags & CF_UNSIGNED) == 0) {
                     unsigned L = GetLocalLabel();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
                 break;
@@ -1636,54 +1641,54 @@ void g_addeqstatic (unsigned flags, uintptr_t label, long offs,
             if (flags & CF_CONST) {
                 if (val == 1) {
                     unsigned L = GetLocalLabel ();
-                    AddCodeLine ("inc %s", lbuf);
-                    AddCodeLine ("bne %s", LocalLabelName (L));
-                    AddCodeLine ("inc %s+1", lbuf);
+                    AddCodeArg (OP65_INC, AM65_ABS, "%s", lbuf);
+                    AddCodeBranch (OP65_BNE, L);
+                    AddCodeArg (OP65_INC, AM65_ABS, "%s+1", lbuf);
                     g_defcodelabel (L);
-                    AddCodeLine ("lda %s", lbuf);               /* Hmmm... */
-                    AddCodeLine ("ldx %s+1", lbuf);
+                    AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);               /* Hmmm... */
+                    AddCodeArg (OP65_LDX, AM65_ABS, "%s+1", lbuf);
                 } else {
-                    AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc %s", lbuf);
-                    AddCodeLine ("sta %s", lbuf);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                    AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                     if (val < 0x100) {
                         unsigned L = GetLocalLabel ();
-                        AddCodeLine ("bcc %s", LocalLabelName (L));
-                        AddCodeLine ("inc %s+1", lbuf);
+                        AddCodeBranch (OP65_BCC, L);
+                        AddCodeArg (OP65_INC, AM65_ABS, "%s+1", lbuf);
                         g_defcodelabel (L);
-                        AddCodeLine ("ldx %s+1", lbuf);
+                        AddCodeArg (OP65_LDX, AM65_ABS, "%s+1", lbuf);
                     } else {
-                        AddCodeLine ("lda #$%02X", (unsigned char)(val >> 8));
-                        AddCodeLine ("adc %s+1", lbuf);
-                        AddCodeLine ("sta %s+1", lbuf);
-                        AddCodeLine ("tax");
-                        AddCodeLine ("lda %s", lbuf);
+                        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                        AddCodeArg (OP65_ADC, AM65_ABS, "%s+1", lbuf);
+                        AddCodeArg (OP65_STA, AM65_ABS, "%s+1", lbuf);
+                        AddCodeImp (OP65_TAX);
+                        AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
                     }
                 }
             } else {
-                AddCodeLine ("clc");
-                AddCodeLine ("adc %s", lbuf);
-                AddCodeLine ("sta %s", lbuf);
-                AddCodeLine ("txa");
-                AddCodeLine ("adc %s+1", lbuf);
-                AddCodeLine ("sta %s+1", lbuf);
-                AddCodeLine ("tax");
-                AddCodeLine ("lda %s", lbuf);
+                AddCodeImp (OP65_CLC);
+                AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
+                AddCodeImp (OP65_TXA);
+                AddCodeArg (OP65_ADC, AM65_ABS, "%s+1", lbuf);
+                AddCodeArg (OP65_STA, AM65_ABS, "%s+1", lbuf);
+                AddCodeImp (OP65_TAX);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
             }
             break;
 
         case CF_LONG:
             if (flags & CF_CONST) {
                 if (val < 0x100) {
-                    AddCodeLine ("ldy #<(%s)", lbuf);
-                    AddCodeLine ("sty ptr1");
-                    AddCodeLine ("ldy #>(%s)", lbuf);
+                    AddCodeArg (OP65_LDY, AM65_IMM, "<(%s)", lbuf);
+                    AddCode (OP65_STY, AM65_ZP, "ptr1", 0);
+                    AddCodeArg (OP65_LDY, AM65_IMM, ">(%s)", lbuf);
                     if (val == 1) {
-                        AddCodeLine ("jsr laddeq1");
+                        AddCode (OP65_JSR, AM65_ABS, "laddeq1", 0);
                     } else {
-                        AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-                        AddCodeLine ("jsr laddeqa");
+                        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                        AddCode (OP65_JSR, AM65_ABS, "laddeqa", 0);
                     }
                 } else {
                     g_getstatic (flags, label, offs);
@@ -1691,10 +1696,10 @@ void g_addeqstatic (unsigned flags, uintptr_t label, long offs,
                     g_putstatic (flags, label, offs);
                 }
             } else {
-                AddCodeLine ("ldy #<(%s)", lbuf);
-                AddCodeLine ("sty ptr1");
-                AddCodeLine ("ldy #>(%s)", lbuf);
-                AddCodeLine ("jsr laddeq");
+                AddCodeArg (OP65_LDY, AM65_IMM, "<(%s)", lbuf);
+                AddCode (OP65_STY, AM65_ZP, "ptr1", 0);
+                AddCodeArg (OP65_LDY, AM65_IMM, ">(%s)", lbuf);
+                AddCode (OP65_JSR, AM65_ABS, "laddeq", 0);
             }
             break;
 
@@ -1717,22 +1722,22 @@ void g_addeqlocal (unsigned flags, int Offs, unsigned long val)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("ldx #$00");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                 if (flags & CF_CONST) {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-                    AddCodeLine ("adc (sp),y");
-                    AddCodeLine ("sta (sp),y");
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                    AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
                 } else {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc (sp),y");
-                    AddCodeLine ("sta (sp),y");
+                    AddCodeImp (OP65_CLC);
+                    AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
                 }
                 if ((flags & CF_UNSIGNED) == 0) {
                     unsigned L = GetLocalLabel();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
                 break;
@@ -1740,26 +1745,26 @@ void g_addeqlocal (unsigned flags, int Offs, unsigned long val)
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("ldy #$%02X", Offs);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
             if (flags & CF_CONST) {
                 if (IS_Get (&CodeSizeFactor) >= 400) {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-                    AddCodeLine ("adc (sp),y");
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("iny");
-                    AddCodeLine ("lda #$%02X", (int) ((val >> 8) & 0xFF));
-                    AddCodeLine ("adc (sp),y");
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("tax");
-                    AddCodeLine ("dey");
-                    AddCodeLine ("lda (sp),y");
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                    AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_INY);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int) ((val >> 8) & 0xFF));
+                    AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_TAX);
+                    AddCodeImp (OP65_DEY);
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
                 } else {
                     g_getimmed (flags, val, 0);
-                    AddCodeLine ("jsr addeqysp");
+                    AddCode (OP65_JSR, AM65_ABS, "addeqysp", 0);
                 }
             } else {
-                AddCodeLine ("jsr addeqysp");
+                AddCode (OP65_JSR, AM65_ABS, "addeqysp", 0);
             }
             break;
 
@@ -1767,8 +1772,8 @@ void g_addeqlocal (unsigned flags, int Offs, unsigned long val)
             if (flags & CF_CONST) {
                 g_getimmed (flags, val, 0);
             }
-            AddCodeLine ("ldy #$%02X", Offs);
-            AddCodeLine ("jsr laddeqysp");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+            AddCode (OP65_JSR, AM65_ABS, "laddeqysp", 0);
             break;
 
         default:
@@ -1791,19 +1796,19 @@ void g_addeqind (unsigned flags, unsigned offs, unsigned long val)
     switch (flags & CF_TYPEMASK) {
 
         case CF_CHAR:
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
-            AddCodeLine ("ldy #$%02X", offs);
-            AddCodeLine ("ldx #$00");
-            AddCodeLine ("lda #$%02X", (int)(val & 0xFF));
-            AddCodeLine ("clc");
-            AddCodeLine ("adc (ptr1),y");
-            AddCodeLine ("sta (ptr1),y");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", offs);
+            AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+            AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (int)(val & 0xFF));
+            AddCodeImp (OP65_CLC);
+            AddCode (OP65_ADC, AM65_ZP_INDY, "ptr1", 0);
+            AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
             break;
 
         case CF_INT:
         case CF_LONG:
-            AddCodeLine ("jsr pushax");         /* Push the address */
+            AddCode (OP65_JSR, AM65_ABS, "pushax", 0);         /* Push the address */
             push (CF_PTR);                      /* Correct the internal sp */
             g_getind (flags, offs);             /* Fetch the value */
             g_inc (flags, val);                 /* Increment value in primary */
@@ -1829,27 +1834,27 @@ void g_subeqstatic (unsigned flags, uintptr_t label, long offs,
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("ldx #$00");
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                 if (flags & CF_CONST) {
                     if (val == 1) {
-                        AddCodeLine ("dec %s", lbuf);
-                        AddCodeLine ("lda %s", lbuf);
+                        AddCodeArg (OP65_DEC, AM65_ABS, "%s", lbuf);
+                        AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
                     } else {
-                        AddCodeLine ("lda %s", lbuf);
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (int)(val & 0xFF));
-                        AddCodeLine ("sta %s", lbuf);
+                        AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (int)(val & 0xFF));
+                        AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                     }
                 } else {
-                    AddCodeLine ("eor #$FF");
-                    AddCodeLine ("sec");
-                    AddCodeLine ("adc %s", lbuf);
-                    AddCodeLine ("sta %s", lbuf);
+                    AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
+                    AddCodeImp (OP65_SEC);
+                    AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                    AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                 }
                 if ((flags & CF_UNSIGNED) == 0) {
                     unsigned L = GetLocalLabel();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
                 break;
@@ -1858,55 +1863,55 @@ void g_subeqstatic (unsigned flags, uintptr_t label, long offs,
 
         case CF_INT:
             if (flags & CF_CONST) {
-                AddCodeLine ("lda %s", lbuf);
-                AddCodeLine ("sec");
-                AddCodeLine ("sbc #$%02X", (unsigned char)val);
-                AddCodeLine ("sta %s", lbuf);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
+                AddCodeImp (OP65_SEC);
+                AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
+                AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
                 if (val < 0x100) {
                     unsigned L = GetLocalLabel ();
-                    AddCodeLine ("bcs %s", LocalLabelName (L));
-                    AddCodeLine ("dec %s+1", lbuf);
+                    AddCodeBranch (OP65_BCS, L);
+                    AddCodeArg (OP65_DEC, AM65_ABS, "%s+1", lbuf);
                     g_defcodelabel (L);
-                    AddCodeLine ("ldx %s+1", lbuf);
+                    AddCodeArg (OP65_LDX, AM65_ABS, "%s+1", lbuf);
                 } else {
-                    AddCodeLine ("lda %s+1", lbuf);
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("sta %s+1", lbuf);
-                    AddCodeLine ("tax");
-                    AddCodeLine ("lda %s", lbuf);
+                    AddCodeArg (OP65_LDA, AM65_ABS, "%s+1", lbuf);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCodeArg (OP65_STA, AM65_ABS, "%s+1", lbuf);
+                    AddCodeImp (OP65_TAX);
+                    AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
                 }
             } else {
-                AddCodeLine ("eor #$FF");
-                AddCodeLine ("sec");
-                AddCodeLine ("adc %s", lbuf);
-                AddCodeLine ("sta %s", lbuf);
-                AddCodeLine ("txa");
-                AddCodeLine ("eor #$FF");
-                AddCodeLine ("adc %s+1", lbuf);
-                AddCodeLine ("sta %s+1", lbuf);
-                AddCodeLine ("tax");
-                AddCodeLine ("lda %s", lbuf);
+                AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
+                AddCodeImp (OP65_SEC);
+                AddCodeArg (OP65_ADC, AM65_ABS, "%s", lbuf);
+                AddCodeArg (OP65_STA, AM65_ABS, "%s", lbuf);
+                AddCodeImp (OP65_TXA);
+                AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
+                AddCodeArg (OP65_ADC, AM65_ABS, "%s+1", lbuf);
+                AddCodeArg (OP65_STA, AM65_ABS, "%s+1", lbuf);
+                AddCodeImp (OP65_TAX);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", lbuf);
             }
             break;
 
         case CF_LONG:
             if (flags & CF_CONST) {
                 if (val < 0x100) {
-                    AddCodeLine ("ldy #<(%s)", lbuf);
-                    AddCodeLine ("sty ptr1");
-                    AddCodeLine ("ldy #>(%s)", lbuf);
-                    AddCodeLine ("lda #$%02X", (unsigned char)val);
-                    AddCodeLine ("jsr lsubeqa");
+                    AddCodeArg (OP65_LDY, AM65_IMM, "<(%s)", lbuf);
+                    AddCode (OP65_STY, AM65_ZP, "ptr1", 0);
+                    AddCodeArg (OP65_LDY, AM65_IMM, ">(%s)", lbuf);
+                    AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCode (OP65_JSR, AM65_ABS, "lsubeqa", 0);
                 } else {
                     g_getstatic (flags, label, offs);
                     g_dec (flags, val);
                     g_putstatic (flags, label, offs);
                 }
             } else {
-                AddCodeLine ("ldy #<(%s)", lbuf);
-                AddCodeLine ("sty ptr1");
-                AddCodeLine ("ldy #>(%s)", lbuf);
-                AddCodeLine ("jsr lsubeq");
+                AddCodeArg (OP65_LDY, AM65_IMM, "<(%s)", lbuf);
+                AddCode (OP65_STY, AM65_ZP, "ptr1", 0);
+                AddCodeArg (OP65_LDY, AM65_IMM, ">(%s)", lbuf);
+                AddCode (OP65_JSR, AM65_ABS, "lsubeq", 0);
             }
             break;
 
@@ -1929,22 +1934,22 @@ void g_subeqlocal (unsigned flags, int Offs, unsigned long val)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("ldx #$00");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                 if (flags & CF_CONST) {
-                    AddCodeLine ("lda (sp),y");
-                    AddCodeLine ("sec");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)val);
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_SEC);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
                 } else {
-                    AddCodeLine ("eor #$FF");
-                    AddCodeLine ("sec");
-                    AddCodeLine ("adc (sp),y");
+                    AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
+                    AddCodeImp (OP65_SEC);
+                    AddCode (OP65_ADC, AM65_ZP_INDY, "sp", 0);
                 }
-                AddCodeLine ("sta (sp),y");
+                AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
                 if ((flags & CF_UNSIGNED) == 0) {
                     unsigned L = GetLocalLabel();
-                    AddCodeLine ("bpl %s", LocalLabelName (L));
-                    AddCodeLine ("dex");
+                    AddCodeBranch (OP65_BPL, L);
+                    AddCodeImp (OP65_DEX);
                     g_defcodelabel (L);
                 }
                 break;
@@ -1955,16 +1960,16 @@ void g_subeqlocal (unsigned flags, int Offs, unsigned long val)
             if (flags & CF_CONST) {
                 g_getimmed (flags, val, 0);
             }
-            AddCodeLine ("ldy #$%02X", Offs);
-            AddCodeLine ("jsr subeqysp");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+            AddCode (OP65_JSR, AM65_ABS, "subeqysp", 0);
             break;
 
         case CF_LONG:
             if (flags & CF_CONST) {
                 g_getimmed (flags, val, 0);
             }
-            AddCodeLine ("ldy #$%02X", Offs);
-            AddCodeLine ("jsr lsubeqysp");
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+            AddCode (OP65_JSR, AM65_ABS, "lsubeqysp", 0);
             break;
 
         default:
@@ -1987,19 +1992,19 @@ void g_subeqind (unsigned flags, unsigned offs, unsigned long val)
     switch (flags & CF_TYPEMASK) {
 
         case CF_CHAR:
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
-            AddCodeLine ("ldy #$%02X", offs);
-            AddCodeLine ("ldx #$00");
-            AddCodeLine ("lda (ptr1),y");
-            AddCodeLine ("sec");
-            AddCodeLine ("sbc #$%02X", (unsigned char)val);
-            AddCodeLine ("sta (ptr1),y");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", offs);
+            AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+            AddCode (OP65_LDA, AM65_ZP_INDY, "ptr1", 0);
+            AddCodeImp (OP65_SEC);
+            AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
+            AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
             break;
 
         case CF_INT:
         case CF_LONG:
-            AddCodeLine ("jsr pushax");         /* Push the address */
+            AddCode (OP65_JSR, AM65_ABS, "pushax", 0);         /* Push the address */
             push (CF_PTR);                      /* Correct the internal sp */
             g_getind (flags, offs);             /* Fetch the value */
             g_dec (flags, val);                 /* Increment value in primary */
@@ -2030,25 +2035,25 @@ void g_addaddr_local (unsigned flags attribute ((unused)), int offs)
         /* We cannot address more then 256 bytes of locals anyway */
         L = GetLocalLabel();
         CheckLocalOffs (offs);
-        AddCodeLine ("clc");
-        AddCodeLine ("adc #$%02X", offs & 0xFF);
+        AddCodeImp (OP65_CLC);
+        AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", offs & 0xFF);
         /* Do also skip the CLC insn below */
-        AddCodeLine ("bcc %s", LocalLabelName (L));
-        AddCodeLine ("inx");
+        AddCodeBranch (OP65_BCC, L);
+        AddCodeImp (OP65_INX);
     }
 
     /* Add the current stackpointer value */
-    AddCodeLine ("clc");
+    AddCodeImp (OP65_CLC);
     if (L != 0) {
         /* Label was used above */
         g_defcodelabel (L);
     }
-    AddCodeLine ("adc sp");
-    AddCodeLine ("tay");
-    AddCodeLine ("txa");
-    AddCodeLine ("adc sp+1");
-    AddCodeLine ("tax");
-    AddCodeLine ("tya");
+    AddCode (OP65_ADC, AM65_ZP, "sp", 0);
+    AddCodeImp (OP65_TAY);
+    AddCodeImp (OP65_TXA);
+    AddCode (OP65_ADC, AM65_ZP, "sp+1", 0);
+    AddCodeImp (OP65_TAX);
+    AddCodeImp (OP65_TYA);
 }
 
 
@@ -2060,13 +2065,13 @@ void g_addaddr_static (unsigned flags, uintptr_t label, long offs)
     const char* lbuf = GetLabelName (flags, label, offs);
 
     /* Add the address to the current ax value */
-    AddCodeLine ("clc");
-    AddCodeLine ("adc #<(%s)", lbuf);
-    AddCodeLine ("tay");
-    AddCodeLine ("txa");
-    AddCodeLine ("adc #>(%s)", lbuf);
-    AddCodeLine ("tax");
-    AddCodeLine ("tya");
+    AddCodeImp (OP65_CLC);
+    AddCodeArg (OP65_ADC, AM65_IMM, "<(%s)", lbuf);
+    AddCodeImp (OP65_TAY);
+    AddCodeImp (OP65_TXA);
+    AddCodeArg (OP65_ADC, AM65_IMM, ">(%s)", lbuf);
+    AddCodeImp (OP65_TAX);
+    AddCodeImp (OP65_TYA);
 }
 
 
@@ -2085,18 +2090,18 @@ void g_save (unsigned flags)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("pha");
+                AddCodeImp (OP65_PHA);
                 break;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("sta regsave");
-            AddCodeLine ("stx regsave+1");
+            AddCode (OP65_STA, AM65_ZP, "regsave", 0);
+            AddCode (OP65_STX, AM65_ZP, "regsave+1", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr saveeax");
+            AddCode (OP65_JSR, AM65_ABS, "saveeax", 0);
             break;
 
         default:
@@ -2114,18 +2119,18 @@ void g_restore (unsigned flags)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("pla");
+                AddCodeImp (OP65_PLA);
                 break;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("lda regsave");
-            AddCodeLine ("ldx regsave+1");
+            AddCode (OP65_LDA, AM65_ZP, "regsave", 0);
+            AddCode (OP65_LDX, AM65_ZP, "regsave+1", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr resteax");
+            AddCode (OP65_JSR, AM65_ABS, "resteax", 0);
             break;
 
         default:
@@ -2147,16 +2152,16 @@ void g_cmp (unsigned flags, unsigned long val)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("cmp #$%02X", (unsigned char)val);
+                AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
                 break;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
             L = GetLocalLabel();
-            AddCodeLine ("cmp #$%02X", (unsigned char)val);
-            AddCodeLine ("bne %s", LocalLabelName (L));
-            AddCodeLine ("cpx #$%02X", (unsigned char)(val >> 8));
+            AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+            AddCodeBranch (OP65_BNE, L);
+            AddCodeArg (OP65_CPX, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
             g_defcodelabel (L);
             break;
 
@@ -2194,7 +2199,7 @@ static void oper (unsigned Flags, unsigned long Val, const char* const* Subs)
     }
 
     /* Output the operation */
-    AddCodeLine ("jsr %s", *Subs);
+    AddCodeArg (OP65_JSR, AM65_ABS, "%s", *Subs);
 
     /* The operation will pop it's argument */
     pop (Flags);
@@ -2209,21 +2214,21 @@ void g_test (unsigned flags)
 
         case CF_CHAR:
             if (flags & CF_FORCECHAR) {
-                AddCodeLine ("tax");
+                AddCodeImp (OP65_TAX);
                 break;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("stx tmp1");
-            AddCodeLine ("ora tmp1");
+            AddCode (OP65_STX, AM65_ZP, "tmp1", 0);
+            AddCode (OP65_ORA, AM65_ZP, "tmp1", 0);
             break;
 
         case CF_LONG:
             if (flags & CF_UNSIGNED) {
-                AddCodeLine ("jsr utsteax");
+                AddCode (OP65_JSR, AM65_ABS, "utsteax", 0);
             } else {
-                AddCodeLine ("jsr tsteax");
+                AddCode (OP65_JSR, AM65_ABS, "tsteax", 0);
             }
             break;
 
@@ -2244,14 +2249,14 @@ void g_push (unsigned flags, unsigned long val)
         if ((flags & CF_TYPEMASK) == CF_CHAR && (flags & CF_FORCECHAR)) {
 
             /* Handle as 8 bit value */
-            AddCodeLine ("lda #$%02X", (unsigned char) val);
-            AddCodeLine ("jsr pusha");
+            AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) val);
+            AddCode (OP65_JSR, AM65_ABS, "pusha", 0);
 
         } else {
 
             /* Handle as 16 bit value */
             g_getimmed (flags, val, 0);
-            AddCodeLine ("jsr pushax");
+            AddCode (OP65_JSR, AM65_ABS, "pushax", 0);
         }
 
     } else {
@@ -2268,16 +2273,16 @@ void g_push (unsigned flags, unsigned long val)
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
                     /* Handle as char */
-                    AddCodeLine ("jsr pusha");
+                    AddCode (OP65_JSR, AM65_ABS, "pusha", 0);
                     break;
                 }
                 /* FALL THROUGH */
             case CF_INT:
-                AddCodeLine ("jsr pushax");
+                AddCode (OP65_JSR, AM65_ABS, "pushax", 0);
                 break;
 
             case CF_LONG:
-                AddCodeLine ("jsr pusheax");
+                AddCode (OP65_JSR, AM65_ABS, "pusheax", 0);
                 break;
 
             default:
@@ -2302,11 +2307,11 @@ void g_swap (unsigned flags)
 
         case CF_CHAR:
         case CF_INT:
-            AddCodeLine ("jsr swapstk");
+            AddCode (OP65_JSR, AM65_ABS, "swapstk", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr swapestk");
+            AddCode (OP65_JSR, AM65_ABS, "swapestk", 0);
             break;
 
         default:
@@ -2322,9 +2327,9 @@ void g_call (unsigned Flags, const char* Label, unsigned ArgSize)
 {
     if ((Flags & CF_FIXARGC) == 0) {
         /* Pass the argument count */
-        AddCodeLine ("ldy #$%02X", ArgSize);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", ArgSize);
     }
-    AddCodeLine ("jsr _%s", Label);
+    AddCodeArg (OP65_JSR, AM65_ABS, "_%s", Label);
     StackPtr += ArgSize;                /* callee pops args */
 }
 
@@ -2337,22 +2342,22 @@ void g_callind (unsigned Flags, unsigned ArgSize, int Offs)
         /* Address is in a/x */
         if ((Flags & CF_FIXARGC) == 0) {
             /* Pass arg count */
-            AddCodeLine ("ldy #$%02X", ArgSize);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", ArgSize);
         }
-        AddCodeLine ("jsr callax");
+        AddCode (OP65_JSR, AM65_ABS, "callax", 0);
     } else {
         /* The address is on stack, offset is on Val */
         Offs -= StackPtr;
         CheckLocalOffs (Offs);
-        AddCodeLine ("pha");
-        AddCodeLine ("ldy #$%02X", Offs);
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta jmpvec+1");
-        AddCodeLine ("iny");
-        AddCodeLine ("lda (sp),y");
-        AddCodeLine ("sta jmpvec+2");
-        AddCodeLine ("pla");
-        AddCodeLine ("jsr jmpvec");
+        AddCodeImp (OP65_PHA);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCode (OP65_STA, AM65_ABS, "jmpvec+1", 0);
+        AddCodeImp (OP65_INY);
+        AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+        AddCode (OP65_STA, AM65_ABS, "jmpvec+2", 0);
+        AddCodeImp (OP65_PLA);
+        AddCode (OP65_JSR, AM65_ABS, "jmpvec", 0);
     }
 
     /* Callee pops args */
@@ -2364,7 +2369,7 @@ void g_callind (unsigned Flags, unsigned ArgSize, int Offs)
 void g_jump (unsigned Label)
 /* Jump to specified internal label number */
 {
-    AddCodeLine ("jmp %s", LocalLabelName (Label));
+    AddCodeBranch (OP65_JMP, Label);
 }
 
 
@@ -2372,7 +2377,7 @@ void g_jump (unsigned Label)
 void g_truejump (unsigned flags attribute ((unused)), unsigned label)
 /* Jump to label if zero flag clear */
 {
-    AddCodeLine ("jne %s", LocalLabelName (label));
+    AddCodeBranch (OP65_JNE, label);
 }
 
 
@@ -2380,22 +2385,22 @@ void g_truejump (unsigned flags attribute ((unused)), unsigned label)
 void g_falsejump (unsigned flags attribute ((unused)), unsigned label)
 /* Jump to label if zero flag set */
 {
-    AddCodeLine ("jeq %s", LocalLabelName (label));
+    AddCodeBranch (OP65_JEQ, label);
 }
 
 
 void g_lateadjustSP (unsigned label)
 /* Adjust stack based on non-immediate data */
 {
-    AddCodeLine ("pha");
-    AddCodeLine ("lda %s", LocalLabelName (label));
-    AddCodeLine ("clc");
-    AddCodeLine ("adc sp");
-    AddCodeLine ("sta sp");
-    AddCodeLine ("lda %s+1", LocalLabelName (label));
-    AddCodeLine ("adc sp+1");
-    AddCodeLine ("sta sp+1");
-    AddCodeLine ("pla");
+    AddCodeImp (OP65_PHA);
+    AddCodeArg (OP65_LDA, AM65_ABS, "%s", LocalLabelName (label));
+    AddCodeImp (OP65_CLC);
+    AddCode (OP65_ADC, AM65_ZP, "sp", 0);
+    AddCode (OP65_STA, AM65_ZP, "sp", 0);
+    AddCodeArg (OP65_LDA, AM65_ABS, "%s+1", LocalLabelName (label));
+    AddCode (OP65_ADC, AM65_ZP, "sp+1", 0);
+    AddCode (OP65_STA, AM65_ZP, "sp+1", 0);
+    AddCodeImp (OP65_PLA);
 }
 
 void g_drop (unsigned Space)
@@ -2405,20 +2410,20 @@ void g_drop (unsigned Space)
         /* Inline the code since calling addysp repeatedly is quite some
         ** overhead.
         */
-        AddCodeLine ("pha");
-        AddCodeLine ("lda #$%02X", (unsigned char) Space);
-        AddCodeLine ("clc");
-        AddCodeLine ("adc sp");
-        AddCodeLine ("sta sp");
-        AddCodeLine ("lda #$%02X", (unsigned char) (Space >> 8));
-        AddCodeLine ("adc sp+1");
-        AddCodeLine ("sta sp+1");
-        AddCodeLine ("pla");
+        AddCodeImp (OP65_PHA);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Space);
+        AddCodeImp (OP65_CLC);
+        AddCode (OP65_ADC, AM65_ZP, "sp", 0);
+        AddCode (OP65_STA, AM65_ZP, "sp", 0);
+        AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) (Space >> 8));
+        AddCode (OP65_ADC, AM65_ZP, "sp+1", 0);
+        AddCode (OP65_STA, AM65_ZP, "sp+1", 0);
+        AddCodeImp (OP65_PLA);
     } else if (Space > 8) {
-        AddCodeLine ("ldy #$%02X", Space);
-        AddCodeLine ("jsr addysp");
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Space);
+        AddCode (OP65_JSR, AM65_ABS, "addysp", 0);
     } else if (Space != 0) {
-        AddCodeLine ("jsr incsp%u", Space);
+        AddCodeArg (OP65_JSR, AM65_ABS, "incsp%u", Space);
     }
 }
 
@@ -2434,20 +2439,20 @@ void g_space (int Space)
         /* Inline the code since calling subysp repeatedly is quite some
         ** overhead.
         */
-        AddCodeLine ("pha");
-        AddCodeLine ("lda sp");
-        AddCodeLine ("sec");
-        AddCodeLine ("sbc #$%02X", (unsigned char) Space);
-        AddCodeLine ("sta sp");
-        AddCodeLine ("lda sp+1");
-        AddCodeLine ("sbc #$%02X", (unsigned char) (Space >> 8));
-        AddCodeLine ("sta sp+1");
-        AddCodeLine ("pla");
+        AddCodeImp (OP65_PHA);
+        AddCode (OP65_LDA, AM65_ZP, "sp", 0);
+        AddCodeImp (OP65_SEC);
+        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) Space);
+        AddCode (OP65_STA, AM65_ZP, "sp", 0);
+        AddCode (OP65_LDA, AM65_ZP, "sp+1", 0);
+        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) (Space >> 8));
+        AddCode (OP65_STA, AM65_ZP, "sp+1", 0);
+        AddCodeImp (OP65_PLA);
     } else if (Space > 8) {
-        AddCodeLine ("ldy #$%02X", Space);
-        AddCodeLine ("jsr subysp");
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Space);
+        AddCode (OP65_JSR, AM65_ABS, "subysp", 0);
     } else if (Space != 0) {
-        AddCodeLine ("jsr decsp%u", Space);
+        AddCodeArg (OP65_JSR, AM65_ABS, "decsp%u", Space);
     }
 }
 
@@ -2456,7 +2461,7 @@ void g_space (int Space)
 void g_cstackcheck (void)
 /* Check for a C stack overflow */
 {
-    AddCodeLine ("jsr cstkchk");
+    AddCode (OP65_JSR, AM65_ABS, "cstkchk", 0);
 }
 
 
@@ -2464,7 +2469,7 @@ void g_cstackcheck (void)
 void g_stackcheck (void)
 /* Check for a stack overflow */
 {
-    AddCodeLine ("jsr stkchk");
+    AddCode (OP65_JSR, AM65_ABS, "stkchk", 0);
 }
 
 
@@ -2541,35 +2546,35 @@ void g_mul (unsigned flags, unsigned long val)
                     switch (val) {
 
                         case 3:
-                            AddCodeLine ("sta tmp1");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("clc");
-                            AddCodeLine ("adc tmp1");
+                            AddCode (OP65_STA, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_CLC);
+                            AddCode (OP65_ADC, AM65_ZP, "tmp1", 0);
                             return;
 
                         case 5:
-                            AddCodeLine ("sta tmp1");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("clc");
-                            AddCodeLine ("adc tmp1");
+                            AddCode (OP65_STA, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_CLC);
+                            AddCode (OP65_ADC, AM65_ZP, "tmp1", 0);
                             return;
 
                         case 6:
-                            AddCodeLine ("sta tmp1");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("clc");
-                            AddCodeLine ("adc tmp1");
-                            AddCodeLine ("asl a");
+                            AddCode (OP65_STA, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_CLC);
+                            AddCode (OP65_ADC, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
                             return;
 
                         case 10:
-                            AddCodeLine ("sta tmp1");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("asl a");
-                            AddCodeLine ("clc");
-                            AddCodeLine ("adc tmp1");
-                            AddCodeLine ("asl a");
+                            AddCode (OP65_STA, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_ASL);
+                            AddCodeImp (OP65_CLC);
+                            AddCode (OP65_ADC, AM65_ZP, "tmp1", 0);
+                            AddCodeImp (OP65_ASL);
                             return;
                     }
                 }
@@ -2578,22 +2583,22 @@ void g_mul (unsigned flags, unsigned long val)
             case CF_INT:
                 switch (val) {
                     case 3:
-                        AddCodeLine ("jsr mulax3");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax3", 0);
                         return;
                     case 5:
-                        AddCodeLine ("jsr mulax5");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax5", 0);
                         return;
                     case 6:
-                        AddCodeLine ("jsr mulax6");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax6", 0);
                         return;
                     case 7:
-                        AddCodeLine ("jsr mulax7");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax7", 0);
                         return;
                     case 9:
-                        AddCodeLine ("jsr mulax9");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax9", 0);
                         return;
                     case 10:
-                        AddCodeLine ("jsr mulax10");
+                        AddCode (OP65_JSR, AM65_ABS, "mulax10", 0);
                         return;
                 }
                 break;
@@ -2656,22 +2661,22 @@ void g_div (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         MaskedVal &= 0xFF;
-                        AddCodeLine ("cmp #$00");
-                        AddCodeLine ("bpl %s", LocalLabelName (DoShiftLabel));
+                        AddCode (OP65_CMP, AM65_IMM, "$00", 0);
+                        AddCodeBranch (OP65_BPL, DoShiftLabel);
                         break;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     MaskedVal &= 0xFFFF;
-                    AddCodeLine ("cpx #$00");
-                    AddCodeLine ("bpl %s", LocalLabelName (DoShiftLabel));
+                    AddCode (OP65_CPX, AM65_IMM, "$00", 0);
+                    AddCodeBranch (OP65_BPL, DoShiftLabel);
                     break;
 
                 case CF_LONG:
                     MaskedVal &= 0xFFFFFFFF;
-                    AddCodeLine ("ldy sreg+1");
-                    AddCodeLine ("bpl %s", LocalLabelName (DoShiftLabel));
+                    AddCode (OP65_LDY, AM65_ZP, "sreg+1", 0);
+                    AddCodeBranch (OP65_BPL, DoShiftLabel);
                     break;
 
                 default:
@@ -2687,9 +2692,9 @@ void g_div (unsigned flags, unsigned long val)
                 */
                 g_save (flags);
                 g_le (flags | CF_UNSIGNED, MaskedVal);
-                AddCodeLine ("lsr a");
+                AddCodeImp (OP65_LSR);
                 g_restore (flags);
-                AddCodeLine ("bcs %s", LocalLabelName (DoShiftLabel));
+                AddCodeBranch (OP65_BCS, DoShiftLabel);
  
                 /* The result is 0. We can just load 0 and skip the shifting. */
                 g_getimmed (flags | CF_ABSOLUTE, 0, 0);
@@ -2769,7 +2774,7 @@ void g_or (unsigned flags, unsigned long val)
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("ora #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                     return;
                 }
@@ -2778,27 +2783,27 @@ void g_or (unsigned flags, unsigned long val)
             case CF_INT:
                 if (val <= 0xFF) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("ora #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                 } else if ((val & 0xFF00) == 0xFF00) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("ora #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)val);
                     }
-                    AddCodeLine ("ldx #$FF");
+                    AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
                 } else if (val != 0) {
-                    AddCodeLine ("ora #$%02X", (unsigned char)val);
-                    AddCodeLine ("pha");
-                    AddCodeLine ("txa");
-                    AddCodeLine ("ora #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("tax");
-                    AddCodeLine ("pla");
+                    AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_PHA);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCodeImp (OP65_TAX);
+                    AddCodeImp (OP65_PLA);
                 }
                 return;
 
             case CF_LONG:
                 if (val <= 0xFF) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("ora #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_ORA, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                     return;
                 }
@@ -2840,7 +2845,7 @@ void g_xor (unsigned flags, unsigned long val)
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("eor #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_EOR, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                     return;
                 }
@@ -2849,24 +2854,24 @@ void g_xor (unsigned flags, unsigned long val)
             case CF_INT:
                 if (val <= 0xFF) {
                     if (val != 0) {
-                        AddCodeLine ("eor #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_EOR, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                 } else if (val != 0) {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("eor #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_EOR, AM65_IMM, "$%02X", (unsigned char)val);
                     }
-                    AddCodeLine ("pha");
-                    AddCodeLine ("txa");
-                    AddCodeLine ("eor #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("tax");
-                    AddCodeLine ("pla");
+                    AddCodeImp (OP65_PHA);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_EOR, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCodeImp (OP65_TAX);
+                    AddCodeImp (OP65_PLA);
                 }
                 return;
 
             case CF_LONG:
                 if (val <= 0xFF) {
                     if (val != 0) {
-                        AddCodeLine ("eor #$%02X", (unsigned char)val);
+                        AddCodeArg (OP65_EOR, AM65_IMM, "$%02X", (unsigned char)val);
                     }
                     return;
                 }
@@ -2907,9 +2912,9 @@ void g_and (unsigned Flags, unsigned long Val)
             case CF_CHAR:
                 if (Flags & CF_FORCECHAR) {
                     if ((Val & 0xFF) == 0x00) {
-                        AddCodeLine ("lda #$00");
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                     } else if ((Val & 0xFF) != 0xFF) {
-                        AddCodeLine ("and #$%02X", (unsigned char)Val);
+                        AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)Val);
                     }
                     return;
                 }
@@ -2917,31 +2922,31 @@ void g_and (unsigned Flags, unsigned long Val)
             case CF_INT:
                 if ((Val & 0xFFFF) != 0xFFFF) {
                     if (Val <= 0xFF) {
-                        AddCodeLine ("ldx #$00");
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                         if (Val == 0) {
-                            AddCodeLine ("lda #$00");
+                            AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                         } else if (Val != 0xFF) {
-                            AddCodeLine ("and #$%02X", (unsigned char)Val);
+                            AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)Val);
                         }
                     } else if ((Val & 0xFFFF) == 0xFF00) {
-                        AddCodeLine ("lda #$00");
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                     } else if ((Val & 0xFF00) == 0xFF00) {
-                        AddCodeLine ("and #$%02X", (unsigned char)Val);
+                        AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)Val);
                     } else if ((Val & 0x00FF) == 0x0000) {
-                        AddCodeLine ("txa");
-                        AddCodeLine ("and #$%02X", (unsigned char)(Val >> 8));
-                        AddCodeLine ("tax");
-                        AddCodeLine ("lda #$00");
+                        AddCodeImp (OP65_TXA);
+                        AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)(Val >> 8));
+                        AddCodeImp (OP65_TAX);
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                     } else {
-                        AddCodeLine ("tay");
-                        AddCodeLine ("txa");
-                        AddCodeLine ("and #$%02X", (unsigned char)(Val >> 8));
-                        AddCodeLine ("tax");
-                        AddCodeLine ("tya");
+                        AddCodeImp (OP65_TAY);
+                        AddCodeImp (OP65_TXA);
+                        AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)(Val >> 8));
+                        AddCodeImp (OP65_TAX);
+                        AddCodeImp (OP65_TYA);
                         if ((Val & 0x00FF) == 0x0000) {
-                            AddCodeLine ("lda #$00");
+                            AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                         } else if ((Val & 0x00FF) != 0x00FF) {
-                            AddCodeLine ("and #$%02X", (unsigned char)Val);
+                            AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)Val);
                         }
                     }
                 }
@@ -2949,17 +2954,17 @@ void g_and (unsigned Flags, unsigned long Val)
 
             case CF_LONG:
                 if (Val <= 0xFF) {
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("stx sreg+1");
-                    AddCodeLine ("stx sreg");
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STX, AM65_ZP, "sreg", 0);
                     if ((Val & 0xFF) != 0xFF) {
-                         AddCodeLine ("and #$%02X", (unsigned char)Val);
+                         AddCodeArg (OP65_AND, AM65_IMM, "$%02X", (unsigned char)Val);
                     }
                     return;
                 } else if (Val == 0xFF00) {
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("sta sreg+1");
-                    AddCodeLine ("sta sreg");
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_STA, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STA, AM65_ZP, "sreg", 0);
                     return;
                 }
                 break;
@@ -3000,13 +3005,13 @@ void g_asr (unsigned flags, unsigned long val)
                 if (flags & CF_FORCECHAR) {
                     if ((flags & CF_UNSIGNED) != 0 && val <= 4) {
                         while (val--) {
-                            AddCodeLine ("lsr a");
+                            AddCodeImp (OP65_LSR);
                         }
                         return;
                     } else if (val <= 2) {
                         while (val--) {
-                            AddCodeLine ("cmp #$80");
-                            AddCodeLine ("ror a");
+                            AddCode (OP65_CMP, AM65_IMM, "$80", 0);
+                            AddCodeImp (OP65_ROR);
                         }
                         return;
                     }
@@ -3017,32 +3022,32 @@ void g_asr (unsigned flags, unsigned long val)
                 val &= 0x0F;
                 if (val >= 8) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("txa");
-                        AddCodeLine ("ldx #$00");
+                        AddCodeImp (OP65_TXA);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
                     } else {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("cpx #$80");   /* Sign bit into carry */
-                        AddCodeLine ("txa");
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("bcc %s", LocalLabelName (L));
-                        AddCodeLine ("dex");        /* Make $FF */
+                        AddCode (OP65_CPX, AM65_IMM, "$80", 0);   /* Sign bit into carry */
+                        AddCodeImp (OP65_TXA);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCodeBranch (OP65_BCC, L);
+                        AddCodeImp (OP65_DEX);        /* Make $FF */
                         g_defcodelabel (L);
                     }
                     val -= 8;
                 }
                 if (val >= 4) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shrax4");
+                        AddCode (OP65_JSR, AM65_ABS, "shrax4", 0);
                     } else {
-                        AddCodeLine ("jsr asrax4");
+                        AddCode (OP65_JSR, AM65_ABS, "asrax4", 0);
                     }
                     val -= 4;
                 }
                 if (val > 0) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shrax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shrax%ld", val);
                     } else {
-                        AddCodeLine ("jsr asrax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "asrax%ld", val);
                     }
                 }
                 return;
@@ -3050,63 +3055,63 @@ void g_asr (unsigned flags, unsigned long val)
             case CF_LONG:
                 val &= 0x1F;
                 if (val >= 24) {
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("lda sreg+1");
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDA, AM65_ZP, "sreg+1", 0);
                     if ((flags & CF_UNSIGNED) == 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("bpl %s", LocalLabelName (L));
-                        AddCodeLine ("dex");
+                        AddCodeBranch (OP65_BPL, L);
+                        AddCodeImp (OP65_DEX);
                         g_defcodelabel (L);
                     }
-                    AddCodeLine ("stx sreg");
-                    AddCodeLine ("stx sreg+1");
+                    AddCode (OP65_STX, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
                     val -= 24;
                 }
                 if (val >= 16) {
-                    AddCodeLine ("ldy #$00");
-                    AddCodeLine ("ldx sreg+1");
+                    AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_ZP, "sreg+1", 0);
                     if ((flags & CF_UNSIGNED) == 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("bpl %s", LocalLabelName (L));
-                        AddCodeLine ("dey");
+                        AddCodeBranch (OP65_BPL, L);
+                        AddCodeImp (OP65_DEY);
                         g_defcodelabel (L);
                     }
-                    AddCodeLine ("lda sreg");
-                    AddCodeLine ("sty sreg+1");
-                    AddCodeLine ("sty sreg");
+                    AddCode (OP65_LDA, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg", 0);
                     val -= 16;
                 }
                 if (val >= 8) {
-                    AddCodeLine ("txa");
-                    AddCodeLine ("ldx sreg");
-                    AddCodeLine ("ldy sreg+1");
-                    AddCodeLine ("sty sreg");
+                    AddCodeImp (OP65_TXA);
+                    AddCode (OP65_LDX, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_LDY, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg", 0);
                     if ((flags & CF_UNSIGNED) == 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("cpy #$80");
-                        AddCodeLine ("ldy #$00");
-                        AddCodeLine ("bcc %s", LocalLabelName (L));
-                        AddCodeLine ("dey");
+                        AddCode (OP65_CPY, AM65_IMM, "$80", 0);
+                        AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+                        AddCodeBranch (OP65_BCC, L);
+                        AddCodeImp (OP65_DEY);
                         g_defcodelabel (L);
                     } else {
-                        AddCodeLine ("ldy #$00");
+                        AddCode (OP65_LDY, AM65_IMM, "$00", 0);
                     }
-                    AddCodeLine ("sty sreg+1");
+                    AddCode (OP65_STY, AM65_ZP, "sreg+1", 0);
                     val -= 8;
                 }
                 if (val >= 4) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shreax4");
+                        AddCode (OP65_JSR, AM65_ABS, "shreax4", 0);
                     } else {
-                        AddCodeLine ("jsr asreax4");
+                        AddCode (OP65_JSR, AM65_ABS, "asreax4", 0);
                     }
                     val -= 4;
                 }
                 if (val > 0) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shreax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shreax%ld", val);
                     } else {
-                        AddCodeLine ("jsr asreax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "asreax%ld", val);
                     }
                 }
                 return;
@@ -3148,23 +3153,23 @@ void g_asl (unsigned flags, unsigned long val)
             case CF_INT:
                 val &= 0x0F;
                 if (val >= 8) {
-                    AddCodeLine ("tax");
-                    AddCodeLine ("lda #$00");
+                    AddCodeImp (OP65_TAX);
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                     val -= 8;
                 }
                 if (val >= 4) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shlax4");
+                        AddCode (OP65_JSR, AM65_ABS, "shlax4", 0);
                     } else {
-                        AddCodeLine ("jsr aslax4");
+                        AddCode (OP65_JSR, AM65_ABS, "aslax4", 0);
                     }
                     val -= 4;
                 }
                 if (val > 0) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shlax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shlax%ld", val);
                     } else {
-                        AddCodeLine ("jsr aslax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "aslax%ld", val);
                     }
                 }
                 return;
@@ -3172,40 +3177,40 @@ void g_asl (unsigned flags, unsigned long val)
             case CF_LONG:
                 val &= 0x1F;
                 if (val >= 24) {
-                    AddCodeLine ("sta sreg+1");
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("tax");
-                    AddCodeLine ("sta sreg");
+                    AddCode (OP65_STA, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_TAX);
+                    AddCode (OP65_STA, AM65_ZP, "sreg", 0);
                     val -= 24;
                 }
                 if (val >= 16) {
-                    AddCodeLine ("stx sreg+1");
-                    AddCodeLine ("sta sreg");
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("tax");
+                    AddCode (OP65_STX, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STA, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_TAX);
                     val -= 16;
                 }
                 if (val >= 8) {
-                    AddCodeLine ("ldy sreg");
-                    AddCodeLine ("sty sreg+1");
-                    AddCodeLine ("stx sreg");
-                    AddCodeLine ("tax");
-                    AddCodeLine ("lda #$00");
+                    AddCode (OP65_LDY, AM65_ZP, "sreg", 0);
+                    AddCode (OP65_STY, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_STX, AM65_ZP, "sreg", 0);
+                    AddCodeImp (OP65_TAX);
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
                     val -= 8;
                 }
                 if (val > 4) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shleax4");
+                        AddCode (OP65_JSR, AM65_ABS, "shleax4", 0);
                     } else {
-                        AddCodeLine ("jsr asleax4");
+                        AddCode (OP65_JSR, AM65_ABS, "asleax4", 0);
                     }
                     val -= 4;
                 }
                 if (val > 0) {
                     if (flags & CF_UNSIGNED) {
-                        AddCodeLine ("jsr shleax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "shleax%ld", val);
                     } else {
-                        AddCodeLine ("jsr asleax%ld", val);
+                        AddCodeArg (OP65_JSR, AM65_ABS, "asleax%ld", val);
                     }
                 }
                 return;
@@ -3235,19 +3240,19 @@ void g_neg (unsigned Flags)
 
         case CF_CHAR:
             if (Flags & CF_FORCECHAR) {
-                AddCodeLine ("eor #$FF");
-                AddCodeLine ("clc");
-                AddCodeLine ("adc #$01");
+                AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
+                AddCodeImp (OP65_CLC);
+                AddCode (OP65_ADC, AM65_IMM, "$01", 0);
                 return;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("jsr negax");
+            AddCode (OP65_JSR, AM65_ABS, "negax", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr negeax");
+            AddCode (OP65_JSR, AM65_ABS, "negeax", 0);
             break;
 
         default:
@@ -3263,15 +3268,15 @@ void g_bneg (unsigned flags)
     switch (flags & CF_TYPEMASK) {
 
         case CF_CHAR:
-            AddCodeLine ("jsr bnega");
+            AddCode (OP65_JSR, AM65_ABS, "bnega", 0);
             break;
 
         case CF_INT:
-            AddCodeLine ("jsr bnegax");
+            AddCode (OP65_JSR, AM65_ABS, "bnegax", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr bnegeax");
+            AddCode (OP65_JSR, AM65_ABS, "bnegeax", 0);
             break;
 
         default:
@@ -3288,17 +3293,17 @@ void g_com (unsigned Flags)
 
         case CF_CHAR:
             if (Flags & CF_FORCECHAR) {
-                AddCodeLine ("eor #$FF");
+                AddCode (OP65_EOR, AM65_IMM, "$FF", 0);
                 return;
             }
             /* FALLTHROUGH */
 
         case CF_INT:
-            AddCodeLine ("jsr complax");
+            AddCode (OP65_JSR, AM65_ABS, "complax", 0);
             break;
 
         case CF_LONG:
-            AddCodeLine ("jsr compleax");
+            AddCode (OP65_JSR, AM65_ABS, "compleax", 0);
             break;
 
         default:
@@ -3324,11 +3329,11 @@ void g_inc (unsigned flags, unsigned long val)
             if (flags & CF_FORCECHAR) {
                 if ((CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && val <= 2) {
                     while (val--) {
-                        AddCodeLine ("ina");
+                        AddCodeImp (OP65_INA);
                     }
                 } else {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc #$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", (unsigned char)val);
                 }
                 break;
             }
@@ -3337,17 +3342,17 @@ void g_inc (unsigned flags, unsigned long val)
         case CF_INT:
             if ((CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && val == 1) {
                 unsigned L = GetLocalLabel();
-                AddCodeLine ("ina");
-                AddCodeLine ("bne %s", LocalLabelName (L));
-                AddCodeLine ("inx");
+                AddCodeImp (OP65_INA);
+                AddCodeBranch (OP65_BNE, L);
+                AddCodeImp (OP65_INX);
                 g_defcodelabel (L);
             } else if (IS_Get (&CodeSizeFactor) < 200) {
                 /* Use jsr calls */
                 if (val <= 8) {
-                    AddCodeLine ("jsr incax%lu", val);
+                    AddCodeArg (OP65_JSR, AM65_ABS, "incax%lu", val);
                 } else if (val <= 255) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) val);
-                    AddCodeLine ("jsr incaxy");
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) val);
+                    AddCode (OP65_JSR, AM65_ABS, "incaxy", 0);
                 } else {
                     g_add (flags | CF_CONST, val);
                 }
@@ -3356,44 +3361,44 @@ void g_inc (unsigned flags, unsigned long val)
                 if (val <= 0x300) {
                     if ((val & 0xFF) != 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("clc");
-                        AddCodeLine ("adc #$%02X", (unsigned char) val);
-                        AddCodeLine ("bcc %s", LocalLabelName (L));
-                        AddCodeLine ("inx");
+                        AddCodeImp (OP65_CLC);
+                        AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", (unsigned char) val);
+                        AddCodeBranch (OP65_BCC, L);
+                        AddCodeImp (OP65_INX);
                         g_defcodelabel (L);
                     }
                     if (val >= 0x100) {
-                        AddCodeLine ("inx");
+                        AddCodeImp (OP65_INX);
                     }
                     if (val >= 0x200) {
-                        AddCodeLine ("inx");
+                        AddCodeImp (OP65_INX);
                     }
                     if (val >= 0x300) {
-                        AddCodeLine ("inx");
+                        AddCodeImp (OP65_INX);
                     }
                 } else if ((val & 0xFF) != 0) {
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc #$%02X", (unsigned char) val);
-                    AddCodeLine ("pha");
-                    AddCodeLine ("txa");
-                    AddCodeLine ("adc #$%02X", (unsigned char) (val >> 8));
-                    AddCodeLine ("tax");
-                    AddCodeLine ("pla");
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", (unsigned char) val);
+                    AddCodeImp (OP65_PHA);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", (unsigned char) (val >> 8));
+                    AddCodeImp (OP65_TAX);
+                    AddCodeImp (OP65_PLA);
                 } else {
-                    AddCodeLine ("pha");
-                    AddCodeLine ("txa");
-                    AddCodeLine ("clc");
-                    AddCodeLine ("adc #$%02X", (unsigned char) (val >> 8));
-                    AddCodeLine ("tax");
-                    AddCodeLine ("pla");
+                    AddCodeImp (OP65_PHA);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeImp (OP65_CLC);
+                    AddCodeArg (OP65_ADC, AM65_IMM, "$%02X", (unsigned char) (val >> 8));
+                    AddCodeImp (OP65_TAX);
+                    AddCodeImp (OP65_PLA);
                 }
             }
             break;
 
         case CF_LONG:
             if (val <= 255) {
-                AddCodeLine ("ldy #$%02X", (unsigned char) val);
-                AddCodeLine ("jsr inceaxy");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) val);
+                AddCode (OP65_JSR, AM65_ABS, "inceaxy", 0);
             } else {
                 g_add (flags | CF_CONST, val);
             }
@@ -3423,11 +3428,11 @@ void g_dec (unsigned flags, unsigned long val)
             if (flags & CF_FORCECHAR) {
                 if ((CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && val <= 2) {
                     while (val--) {
-                        AddCodeLine ("dea");
+                        AddCodeImp (OP65_DEA);
                     }
                 } else {
-                    AddCodeLine ("sec");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_SEC);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
                 }
                 break;
             }
@@ -3437,10 +3442,10 @@ void g_dec (unsigned flags, unsigned long val)
             if (IS_Get (&CodeSizeFactor) < 200) {
                 /* Use subroutines */
                 if (val <= 8) {
-                    AddCodeLine ("jsr decax%d", (int) val);
+                    AddCodeArg (OP65_JSR, AM65_ABS, "decax%d", (int) val);
                 } else if (val <= 255) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) val);
-                    AddCodeLine ("jsr decaxy");
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) val);
+                    AddCode (OP65_JSR, AM65_ABS, "decaxy", 0);
                 } else {
                     g_sub (flags | CF_CONST, val);
                 }
@@ -3449,34 +3454,34 @@ void g_dec (unsigned flags, unsigned long val)
                 if (val < 0x300) {
                     if ((val & 0xFF) != 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (unsigned char) val);
-                        AddCodeLine ("bcs %s", LocalLabelName (L));
-                        AddCodeLine ("dex");
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) val);
+                        AddCodeBranch (OP65_BCS, L);
+                        AddCodeImp (OP65_DEX);
                         g_defcodelabel (L);
                     }
                     if (val >= 0x100) {
-                        AddCodeLine ("dex");
+                        AddCodeImp (OP65_DEX);
                     }
                     if (val >= 0x200) {
-                        AddCodeLine ("dex");
+                        AddCodeImp (OP65_DEX);
                     }
                 } else {
                     if ((val & 0xFF) != 0) {
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (unsigned char) val);
-                        AddCodeLine ("pha");
-                        AddCodeLine ("txa");
-                        AddCodeLine ("sbc #$%02X", (unsigned char) (val >> 8));
-                        AddCodeLine ("tax");
-                        AddCodeLine ("pla");
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) val);
+                        AddCodeImp (OP65_PHA);
+                        AddCodeImp (OP65_TXA);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) (val >> 8));
+                        AddCodeImp (OP65_TAX);
+                        AddCodeImp (OP65_PLA);
                     } else {
-                        AddCodeLine ("pha");
-                        AddCodeLine ("txa");
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (unsigned char) (val >> 8));
-                        AddCodeLine ("tax");
-                        AddCodeLine ("pla");
+                        AddCodeImp (OP65_PHA);
+                        AddCodeImp (OP65_TXA);
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char) (val >> 8));
+                        AddCodeImp (OP65_TAX);
+                        AddCodeImp (OP65_PLA);
                     }
                 }
             }
@@ -3484,8 +3489,8 @@ void g_dec (unsigned flags, unsigned long val)
 
         case CF_LONG:
             if (val <= 255) {
-                AddCodeLine ("ldy #$%02X", (unsigned char) val);
-                AddCodeLine ("jsr deceaxy");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) val);
+                AddCode (OP65_JSR, AM65_ABS, "deceaxy", 0);
             } else {
                 g_sub (flags | CF_CONST, val);
             }
@@ -3525,19 +3530,19 @@ void g_eq (unsigned flags, unsigned long val)
 
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("jsr booleq");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCode (OP65_JSR, AM65_ABS, "booleq", 0);
                     return;
                 }
                 /* FALLTHROUGH */
 
             case CF_INT:
                 L = GetLocalLabel();
-                AddCodeLine ("cpx #$%02X", (unsigned char)(val >> 8));
-                AddCodeLine ("bne %s", LocalLabelName (L));
-                AddCodeLine ("cmp #$%02X", (unsigned char)val);
+                AddCodeArg (OP65_CPX, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                AddCodeBranch (OP65_BNE, L);
+                AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
                 g_defcodelabel (L);
-                AddCodeLine ("jsr booleq");
+                AddCode (OP65_JSR, AM65_ABS, "booleq", 0);
                 return;
 
             case CF_LONG:
@@ -3579,19 +3584,19 @@ void g_ne (unsigned flags, unsigned long val)
 
             case CF_CHAR:
                 if (flags & CF_FORCECHAR) {
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("jsr boolne");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCode (OP65_JSR, AM65_ABS, "boolne", 0);
                     return;
                 }
                 /* FALLTHROUGH */
 
             case CF_INT:
                 L = GetLocalLabel();
-                AddCodeLine ("cpx #$%02X", (unsigned char)(val >> 8));
-                AddCodeLine ("bne %s", LocalLabelName (L));
-                AddCodeLine ("cmp #$%02X", (unsigned char)val);
+                AddCodeArg (OP65_CPX, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                AddCodeBranch (OP65_BNE, L);
+                AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
                 g_defcodelabel (L);
-                AddCodeLine ("jsr boolne");
+                AddCode (OP65_JSR, AM65_ABS, "boolne", 0);
                 return;
 
             case CF_LONG:
@@ -3638,7 +3643,7 @@ void g_lt (unsigned flags, unsigned long val)
             /* Give a warning in some special cases */
             if (val == 0) {
                 Warning ("Condition is never true");
-                AddCodeLine ("jsr return0");
+                AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                 return;
             }
 
@@ -3647,34 +3652,34 @@ void g_lt (unsigned flags, unsigned long val)
 
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
-                        AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                        AddCodeLine ("jsr boolult");
+                        AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                        AddCode (OP65_JSR, AM65_ABS, "boolult", 0);
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     /* If the low byte is zero, we must only test the high byte */
-                    AddCodeLine ("cpx #$%02X", (unsigned char)(val >> 8));
+                    AddCodeArg (OP65_CPX, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
                     if ((val & 0xFF) != 0) {
                         unsigned L = GetLocalLabel();
-                        AddCodeLine ("bne %s", LocalLabelName (L));
-                        AddCodeLine ("cmp #$%02X", (unsigned char)val);
+                        AddCodeBranch (OP65_BNE, L);
+                        AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
                         g_defcodelabel (L);
                     }
-                    AddCodeLine ("jsr boolult");
+                    AddCode (OP65_JSR, AM65_ABS, "boolult", 0);
                     return;
 
                 case CF_LONG:
                     /* Do a subtraction */
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("lda sreg");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 16));
-                    AddCodeLine ("lda sreg+1");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 24));
-                    AddCodeLine ("jsr boolult");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCode (OP65_LDA, AM65_ZP, "sreg", 0);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 16));
+                    AddCode (OP65_LDA, AM65_ZP, "sreg+1", 0);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 24));
+                    AddCode (OP65_JSR, AM65_ABS, "boolult", 0);
                     return;
 
                 default:
@@ -3688,29 +3693,29 @@ void g_lt (unsigned flags, unsigned long val)
 
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
-                        AddCodeLine ("asl a");          /* Bit 7 -> carry */
-                        AddCodeLine ("lda #$00");
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("rol a");
+                        AddCodeImp (OP65_ASL);          /* Bit 7 -> carry */
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCodeImp (OP65_ROL);
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     /* Just check the high byte */
-                    AddCodeLine ("cpx #$80");           /* Bit 7 -> carry */
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCode (OP65_CPX, AM65_IMM, "$80", 0);           /* Bit 7 -> carry */
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 case CF_LONG:
                     /* Just check the high byte */
-                    AddCodeLine ("lda sreg+1");
-                    AddCodeLine ("asl a");              /* Bit 7 -> carry */
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCode (OP65_LDA, AM65_ZP, "sreg+1", 0);
+                    AddCodeImp (OP65_ASL);              /* Bit 7 -> carry */
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 default:
@@ -3725,15 +3730,15 @@ void g_lt (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         Label = GetLocalLabel ();
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (unsigned char)val);
-                        AddCodeLine ("bvc %s", LocalLabelName (Label));
-                        AddCodeLine ("eor #$80");
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
+                        AddCodeBranch (OP65_BVC, Label);
+                        AddCode (OP65_EOR, AM65_IMM, "$80", 0);
                         g_defcodelabel (Label);
-                        AddCodeLine ("asl a");          /* Bit 7 -> carry */
-                        AddCodeLine ("lda #$00");
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("rol a");
+                        AddCodeImp (OP65_ASL);          /* Bit 7 -> carry */
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCodeImp (OP65_ROL);
                         return;
                     }
                     /* FALLTHROUGH */
@@ -3741,16 +3746,16 @@ void g_lt (unsigned flags, unsigned long val)
                 case CF_INT:
                     /* Do a subtraction */
                     Label = GetLocalLabel ();
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("bvc %s", LocalLabelName (Label));
-                    AddCodeLine ("eor #$80");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCodeBranch (OP65_BVC, Label);
+                    AddCode (OP65_EOR, AM65_IMM, "$80", 0);
                     g_defcodelabel (Label);
-                    AddCodeLine ("asl a");          /* Bit 7 -> carry */
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCodeImp (OP65_ASL);          /* Bit 7 -> carry */
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 case CF_LONG:
@@ -3805,7 +3810,7 @@ void g_le (unsigned flags, unsigned long val)
                         } else {
                             /* Always true */
                             Warning ("Condition is always true");
-                            AddCodeLine ("jsr return1");
+                            AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                         }
                     } else {
                         /* Signed compare */
@@ -3817,7 +3822,7 @@ void g_le (unsigned flags, unsigned long val)
                         } else {
                             /* Always true */
                             Warning ("Condition is always true");
-                            AddCodeLine ("jsr return1");
+                            AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                         }
                     }
                     return;
@@ -3835,7 +3840,7 @@ void g_le (unsigned flags, unsigned long val)
                     } else {
                         /* Always true */
                         Warning ("Condition is always true");
-                        AddCodeLine ("jsr return1");
+                        AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                     }
                 } else {
                     /* Signed compare */
@@ -3844,7 +3849,7 @@ void g_le (unsigned flags, unsigned long val)
                     } else {
                         /* Always true */
                         Warning ("Condition is always true");
-                        AddCodeLine ("jsr return1");
+                        AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                     }
                 }
                 return;
@@ -3860,7 +3865,7 @@ void g_le (unsigned flags, unsigned long val)
                     } else {
                         /* Always true */
                         Warning ("Condition is always true");
-                        AddCodeLine ("jsr return1");
+                        AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                     }
                 } else {
                     /* Signed compare */
@@ -3869,7 +3874,7 @@ void g_le (unsigned flags, unsigned long val)
                     } else {
                         /* Always true */
                         Warning ("Condition is always true");
-                        AddCodeLine ("jsr return1");
+                        AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                     }
                 }
                 return;
@@ -3925,7 +3930,7 @@ void g_gt (unsigned flags, unsigned long val)
                         } else {
                             /* Never true */
                             Warning ("Condition is never true");
-                            AddCodeLine ("jsr return0");
+                            AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                         }
                     } else {
                         if ((long) val < 0x7F) {
@@ -3936,7 +3941,7 @@ void g_gt (unsigned flags, unsigned long val)
                         } else {
                             /* Never true */
                             Warning ("Condition is never true");
-                            AddCodeLine ("jsr return0");
+                            AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                         }
                     }
                     return;
@@ -3960,7 +3965,7 @@ void g_gt (unsigned flags, unsigned long val)
                     } else {
                         /* Never true */
                         Warning ("Condition is never true");
-                        AddCodeLine ("jsr return0");
+                        AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                     }
                 } else {
                     /* Signed compare */
@@ -3969,7 +3974,7 @@ void g_gt (unsigned flags, unsigned long val)
                     } else {
                         /* Never true */
                         Warning ("Condition is never true");
-                        AddCodeLine ("jsr return0");
+                        AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                     }
                 }
                 return;
@@ -3991,7 +3996,7 @@ void g_gt (unsigned flags, unsigned long val)
                     } else {
                         /* Never true */
                         Warning ("Condition is never true");
-                        AddCodeLine ("jsr return0");
+                        AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                     }
                 } else {
                     /* Signed compare */
@@ -4000,7 +4005,7 @@ void g_gt (unsigned flags, unsigned long val)
                     } else {
                         /* Never true */
                         Warning ("Condition is never true");
-                        AddCodeLine ("jsr return0");
+                        AddCode (OP65_JSR, AM65_ABS, "return0", 0);
                     }
                 }
                 return;
@@ -4047,7 +4052,7 @@ void g_ge (unsigned flags, unsigned long val)
             /* Give a warning in some special cases */
             if (val == 0) {
                 Warning ("Condition is always true");
-                AddCodeLine ("jsr return1");
+                AddCode (OP65_JSR, AM65_ABS, "return1", 0);
                 return;
             }
 
@@ -4057,36 +4062,36 @@ void g_ge (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         /* Do a subtraction. Condition is true if carry set */
-                        AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                        AddCodeLine ("lda #$00");
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("rol a");
+                        AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCodeImp (OP65_ROL);
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     /* Do a subtraction. Condition is true if carry set */
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 case CF_LONG:
                     /* Do a subtraction. Condition is true if carry set */
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("lda sreg");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 16));
-                    AddCodeLine ("lda sreg+1");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 24));
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCode (OP65_LDA, AM65_ZP, "sreg", 0);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 16));
+                    AddCode (OP65_LDA, AM65_ZP, "sreg+1", 0);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 24));
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 default:
@@ -4100,22 +4105,22 @@ void g_ge (unsigned flags, unsigned long val)
 
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
-                        AddCodeLine ("tax");
-                        AddCodeLine ("jsr boolge");
+                        AddCodeImp (OP65_TAX);
+                        AddCode (OP65_JSR, AM65_ABS, "boolge", 0);
                         return;
                     }
                     /* FALLTHROUGH */
 
                 case CF_INT:
                     /* Just test the high byte */
-                    AddCodeLine ("txa");
-                    AddCodeLine ("jsr boolge");
+                    AddCodeImp (OP65_TXA);
+                    AddCode (OP65_JSR, AM65_ABS, "boolge", 0);
                     return;
 
                 case CF_LONG:
                     /* Just test the high byte */
-                    AddCodeLine ("lda sreg+1");
-                    AddCodeLine ("jsr boolge");
+                    AddCode (OP65_LDA, AM65_ZP, "sreg+1", 0);
+                    AddCode (OP65_JSR, AM65_ABS, "boolge", 0);
                     return;
 
                 default:
@@ -4130,15 +4135,15 @@ void g_ge (unsigned flags, unsigned long val)
                 case CF_CHAR:
                     if (flags & CF_FORCECHAR) {
                         Label = GetLocalLabel ();
-                        AddCodeLine ("sec");
-                        AddCodeLine ("sbc #$%02X", (unsigned char)val);
-                        AddCodeLine ("bvs %s", LocalLabelName (Label));
-                        AddCodeLine ("eor #$80");
+                        AddCodeImp (OP65_SEC);
+                        AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)val);
+                        AddCodeBranch (OP65_BVS, Label);
+                        AddCode (OP65_EOR, AM65_IMM, "$80", 0);
                         g_defcodelabel (Label);
-                        AddCodeLine ("asl a");          /* Bit 7 -> carry */
-                        AddCodeLine ("lda #$00");
-                        AddCodeLine ("ldx #$00");
-                        AddCodeLine ("rol a");
+                        AddCodeImp (OP65_ASL);          /* Bit 7 -> carry */
+                        AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                        AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                        AddCodeImp (OP65_ROL);
                         return;
                     }
                     /* FALLTHROUGH */
@@ -4146,16 +4151,16 @@ void g_ge (unsigned flags, unsigned long val)
                 case CF_INT:
                     /* Do a subtraction */
                     Label = GetLocalLabel ();
-                    AddCodeLine ("cmp #$%02X", (unsigned char)val);
-                    AddCodeLine ("txa");
-                    AddCodeLine ("sbc #$%02X", (unsigned char)(val >> 8));
-                    AddCodeLine ("bvs %s", LocalLabelName (Label));
-                    AddCodeLine ("eor #$80");
+                    AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", (unsigned char)val);
+                    AddCodeImp (OP65_TXA);
+                    AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", (unsigned char)(val >> 8));
+                    AddCodeBranch (OP65_BVS, Label);
+                    AddCode (OP65_EOR, AM65_IMM, "$80", 0);
                     g_defcodelabel (Label);
-                    AddCodeLine ("asl a");          /* Bit 7 -> carry */
-                    AddCodeLine ("lda #$00");
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("rol a");
+                    AddCodeImp (OP65_ASL);          /* Bit 7 -> carry */
+                    AddCode (OP65_LDA, AM65_IMM, "$00", 0);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeImp (OP65_ROL);
                     return;
 
                 case CF_LONG:
@@ -4285,12 +4290,12 @@ void g_initregister (unsigned Label, unsigned Reg, unsigned Size)
 {
     /* Register variables do always have less than 128 bytes */
     unsigned CodeLabel = GetLocalLabel ();
-    AddCodeLine ("ldx #$%02X", (unsigned char) (Size - 1));
+    AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) (Size - 1));
     g_defcodelabel (CodeLabel);
-    AddCodeLine ("lda %s,x", GetLabelName (CF_STATIC, Label, 0));
-    AddCodeLine ("sta %s,x", GetLabelName (CF_REGVAR, Reg, 0));
-    AddCodeLine ("dex");
-    AddCodeLine ("bpl %s", LocalLabelName (CodeLabel));
+    AddCodeArg (OP65_LDA, AM65_ABSX, "%s", GetLabelName (CF_STATIC, Label, 0));
+    AddCodeArg (OP65_STA, AM65_ABSX, "%s", GetLabelName (CF_REGVAR, Reg, 0));
+    AddCodeImp (OP65_DEX);
+    AddCodeBranch (OP65_BPL, CodeLabel);
 }
 
 
@@ -4302,20 +4307,20 @@ void g_initauto (unsigned Label, unsigned Size)
 
     CheckLocalOffs (Size);
     if (Size <= 128) {
-        AddCodeLine ("ldy #$%02X", Size-1);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Size-1);
         g_defcodelabel (CodeLabel);
-        AddCodeLine ("lda %s,y", GetLabelName (CF_STATIC, Label, 0));
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("dey");
-        AddCodeLine ("bpl %s", LocalLabelName (CodeLabel));
+        AddCodeArg (OP65_LDA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, Label, 0));
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_DEY);
+        AddCodeBranch (OP65_BPL, CodeLabel);
     } else if (Size <= 256) {
-        AddCodeLine ("ldy #$00");
+        AddCode (OP65_LDY, AM65_IMM, "$00", 0);
         g_defcodelabel (CodeLabel);
-        AddCodeLine ("lda %s,y", GetLabelName (CF_STATIC, Label, 0));
-        AddCodeLine ("sta (sp),y");
-        AddCodeLine ("iny");
-        AddCmpCodeIfSizeNot256 ("cpy #$%02X", Size);
-        AddCodeLine ("bne %s", LocalLabelName (CodeLabel));
+        AddCodeArg (OP65_LDA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, Label, 0));
+        AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+        AddCodeImp (OP65_INY);
+        AddCmpCodeIfSizeNot256 (OP65_CPY, Size);
+        AddCodeBranch (OP65_BNE, CodeLabel);
     }
 }
 
@@ -4326,29 +4331,29 @@ void g_initstatic (unsigned InitLabel, unsigned VarLabel, unsigned Size)
 {
     if (Size <= 128) {
         unsigned CodeLabel = GetLocalLabel ();
-        AddCodeLine ("ldy #$%02X", Size-1);
+        AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Size-1);
         g_defcodelabel (CodeLabel);
-        AddCodeLine ("lda %s,y", GetLabelName (CF_STATIC, InitLabel, 0));
-        AddCodeLine ("sta %s,y", GetLabelName (CF_STATIC, VarLabel, 0));
-        AddCodeLine ("dey");
-        AddCodeLine ("bpl %s", LocalLabelName (CodeLabel));
+        AddCodeArg (OP65_LDA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, InitLabel, 0));
+        AddCodeArg (OP65_STA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, VarLabel, 0));
+        AddCodeImp (OP65_DEY);
+        AddCodeBranch (OP65_BPL, CodeLabel);
     } else if (Size <= 256) {
         unsigned CodeLabel = GetLocalLabel ();
-        AddCodeLine ("ldy #$00");
+        AddCode (OP65_LDY, AM65_IMM, "$00", 0);
         g_defcodelabel (CodeLabel);
-        AddCodeLine ("lda %s,y", GetLabelName (CF_STATIC, InitLabel, 0));
-        AddCodeLine ("sta %s,y", GetLabelName (CF_STATIC, VarLabel, 0));
-        AddCodeLine ("iny");
-        AddCmpCodeIfSizeNot256 ("cpy #$%02X", Size);
-        AddCodeLine ("bne %s", LocalLabelName (CodeLabel));
+        AddCodeArg (OP65_LDA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, InitLabel, 0));
+        AddCodeArg (OP65_STA, AM65_ABSY, "%s", GetLabelName (CF_STATIC, VarLabel, 0));
+        AddCodeImp (OP65_INY);
+        AddCmpCodeIfSizeNot256 (OP65_CPY, Size);
+        AddCodeBranch (OP65_BNE, CodeLabel);
     } else {
         /* Use the easy way here: memcpy() */
         g_getimmed (CF_STATIC, VarLabel, 0);
-        AddCodeLine ("jsr pushax");
+        AddCode (OP65_JSR, AM65_ABS, "pushax", 0);
         g_getimmed (CF_STATIC, InitLabel, 0);
-        AddCodeLine ("jsr pushax");
+        AddCode (OP65_JSR, AM65_ABS, "pushax", 0);
         g_getimmed (CF_INT | CF_UNSIGNED | CF_CONST, Size, 0);
-        AddCodeLine ("jsr %s", GetLabelName (CF_EXTERNAL, (uintptr_t) "memcpy", 0));
+        AddCodeArg (OP65_JSR, AM65_ABS, "%s", GetLabelName (CF_EXTERNAL, (uintptr_t) "memcpy", 0));
     }
 }
 
@@ -4360,6 +4365,263 @@ void g_initstatic (unsigned InitLabel, unsigned VarLabel, unsigned Size)
 
 
 
+/* Ways to dispatch on the last byte of a switch expression */
+typedef enum {
+    SWITCH_LINEAR,                      /* Chain of compares */
+    SWITCH_BINARY,                      /* Binary search over the case values */
+    SWITCH_TABLE,                       /* Inline jump table */
+    SWITCH_CASEJMP,                     /* Jump table used by the casejmp routine */
+    SWITCH_COUNT                        /* Number of strategies */
+} SwitchKind;
+
+/* Switches with less cases than this use a chain of compares */
+#define SWITCH_MIN_CASES        4
+
+/* Ranges of case values with at most this many entries are searched
+** linearly when doing a binary search.
+*/
+#define SWITCH_LINEAR_COUNT     3
+
+
+
+static SwitchKind ChooseSwitch (const Collection* Nodes)
+/* Choose the code for the last level of a switch statement. The size and
+** speed of each strategy is estimated. The smallest code is used, unless
+** the code size factor allows faster code that is larger.
+*/
+{
+    unsigned Size[SWITCH_COUNT];
+    unsigned Time[SWITCH_COUNT];
+    unsigned Min;
+    unsigned Span;
+    unsigned Check;
+    unsigned Depth;
+    unsigned I;
+    SwitchKind Kind;
+
+    /* Small switches are always done with compares */
+    unsigned Count = CollCount (Nodes);
+    if (Count < SWITCH_MIN_CASES) {
+        return SWITCH_LINEAR;
+    }
+
+    /* Get the range of the case values. The nodes are sorted. */
+    Min  = CN_GetValue ((const CaseNode*) CollConstAt (Nodes, 0));
+    Span = CN_GetValue ((const CaseNode*) CollConstLast (Nodes)) - Min + 1;
+
+    /* Compare chain: cmp/jeq for each case, jmp to the default label */
+    Size[SWITCH_LINEAR] = Count * 5 + 3;
+    Time[SWITCH_LINEAR] = (Count + 1) * 2 + 3;
+
+    /* Binary search: One more conditional jump per compare, but only a
+    ** logarithmic number of compares.
+    */
+    Depth = 0;
+    for (I = Count; I > SWITCH_LINEAR_COUNT; I /= 2) {
+        ++Depth;
+    }
+    Size[SWITCH_BINARY] = Count * 6 + 3;
+    Time[SWITCH_BINARY] = Depth * 7 + SWITCH_LINEAR_COUNT * 4 + 3;
+
+    /* Both jump tables need code for the subtraction of the lowest value and
+    ** the range check.
+    */
+    Check = (Min != 0? 3 : 0) + (Span < 256? 4 : 0);
+
+    /* Inline table. On the 65C02, a single table and jmp (abs,x) is used. */
+    if ((CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && Span <= 128) {
+        Size[SWITCH_TABLE] = Check + 5 + Span * 2;
+        Time[SWITCH_TABLE] = Check + 10;
+    } else {
+        Size[SWITCH_TABLE] = Check + 10 + Span * 2;
+        Time[SWITCH_TABLE] = Check + 26;
+    }
+
+    /* Table handled by the runtime: Call and a four byte header */
+    Size[SWITCH_CASEJMP] = 12 + Span * 2;
+    Time[SWITCH_CASEJMP] = 85;
+
+    /* Determine the smallest code */
+    Kind = SWITCH_LINEAR;
+    for (I = 1; I < SWITCH_COUNT; ++I) {
+        if (Size[I] < Size[Kind]) {
+            Kind = (SwitchKind) I;
+        }
+    }
+
+    /* Replace it by faster code if that is allowed to be larger */
+    if (IS_Get (&CodeSizeFactor) > 100) {
+        unsigned Limit = Size[Kind] * IS_Get (&CodeSizeFactor);
+        for (I = 0; I < SWITCH_COUNT; ++I) {
+            if (Size[I] * 100 <= Limit && Time[I] < Time[Kind]) {
+                Kind = (SwitchKind) I;
+            }
+        }
+    }
+    return Kind;
+}
+
+
+
+static void SwitchLinear (const Collection* Nodes, unsigned First, unsigned Last,
+                          unsigned DefaultLabel)
+/* Generate a chain of compares for the nodes First to Last (inclusive) */
+{
+    unsigned I;
+    for (I = First; I <= Last; ++I) {
+        const CaseNode* N = CollConstAt (Nodes, I);
+        AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", CN_GetValue (N));
+        g_falsejump (0, CN_GetLabel (N));
+    }
+    g_jump (DefaultLabel);
+}
+
+
+
+static void SwitchBinary (const Collection* Nodes, unsigned First, unsigned Last,
+                          unsigned DefaultLabel)
+/* Generate a binary search over the nodes First to Last (inclusive) */
+{
+    if (Last - First < SWITCH_LINEAR_COUNT) {
+
+        /* Not worth another split */
+        SwitchLinear (Nodes, First, Last, DefaultLabel);
+
+    } else {
+
+        /* Compare against the value in the middle */
+        unsigned Mid   = (First + Last) / 2;
+        unsigned Lower = GetLocalLabel ();
+        const CaseNode* N = CollConstAt (Nodes, Mid);
+        AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", CN_GetValue (N));
+        g_falsejump (0, CN_GetLabel (N));
+        AddCodeBranch (OP65_JCC, Lower);
+
+        /* Search the upper and the lower half */
+        SwitchBinary (Nodes, Mid + 1, Last, DefaultLabel);
+        g_defcodelabel (Lower);
+        SwitchBinary (Nodes, First, Mid - 1, DefaultLabel);
+    }
+}
+
+
+
+static void OutputTableLabels (const char* Directive, const unsigned* Labels,
+                               unsigned Count)
+/* Output a list of code labels as data using the given directive */
+{
+    unsigned Chunk;
+    char Buf [128];
+    char* B;
+
+    while (Count) {
+
+        /* How many go into this line? */
+        if ((Chunk = Count) > 8) {
+            Chunk = 8;
+        }
+        Count -= Chunk;
+
+        /* Output one line */
+        B = Buf + sprintf (Buf, "\t%s\t", Directive);
+        do {
+            B += sprintf (B, "%s", LocalLabelName (*Labels++));
+            if (--Chunk) {
+                *B++ = ',';
+            }
+        } while (Chunk);
+
+        /* Output the line */
+        AddDataLine ("%s", Buf);
+    }
+}
+
+
+
+static void SwitchTable (const Collection* Nodes, unsigned DefaultLabel,
+                         SwitchKind Kind)
+/* Generate a jump table for the last level of a switch statement. The labels
+** in the table are only referenced from data, so they are marked for the
+** optimizer.
+*/
+{
+    unsigned I;
+    unsigned* Labels;
+    segment_t OldSeg;
+
+    /* Get the range of the case values and a label for the table */
+    unsigned Min   = CN_GetValue ((const CaseNode*) CollConstAt (Nodes, 0));
+    unsigned Span  = CN_GetValue ((const CaseNode*) CollConstLast (Nodes)) - Min + 1;
+    unsigned Table = GetLocalLabel ();
+
+    /* Build the table contents. Values without a case go to the default. */
+    Labels = xmalloc (Span * sizeof (Labels[0]));
+    for (I = 0; I < Span; ++I) {
+        Labels[I] = DefaultLabel;
+    }
+    CS_MarkIndirectLabel (CS->Code, LocalLabelName (DefaultLabel));
+    for (I = 0; I < CollCount (Nodes); ++I) {
+        const CaseNode* N = CollConstAt (Nodes, I);
+        Labels[CN_GetValue (N) - Min] = CN_GetLabel (N);
+        CS_MarkIndirectLabel (CS->Code, LocalLabelName (CN_GetLabel (N)));
+    }
+
+    /* Generate the dispatch code */
+    if (Kind == SWITCH_CASEJMP) {
+
+        /* The runtime routine does the range check */
+        AddCodeImp (OP65_TAY);
+        AddCodeArg (OP65_LDA, AM65_IMM, "<(%s)", LocalLabelName (Table));
+        AddCodeArg (OP65_LDX, AM65_IMM, ">(%s)", LocalLabelName (Table));
+        AddCodeArg (OP65_JMP, AM65_BRA, "casejmp");
+
+    } else {
+
+        /* Make the value zero based and check the range */
+        if (Min != 0) {
+            AddCodeImp (OP65_SEC);
+            AddCodeArg (OP65_SBC, AM65_IMM, "$%02X", Min);
+        }
+        if (Span < 256) {
+            AddCodeArg (OP65_CMP, AM65_IMM, "$%02X", Span);
+            AddCodeBranch (OP65_JCS, DefaultLabel);
+        }
+
+        /* Jump indirect through the table */
+        if ((CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && Span <= 128) {
+            AddCodeImp (OP65_ASL);
+            AddCodeImp (OP65_TAX);
+            AddCodeArg (OP65_JMP, AM65_ZPX_IND, ".loword(%s)", LocalLabelName (Table));
+        } else {
+            AddCodeImp (OP65_TAY);
+            AddCodeArg (OP65_LDX, AM65_ABSY, "%s+$%02X", LocalLabelName (Table), Span);
+            AddCodeArg (OP65_LDA, AM65_ABSY, "%s", LocalLabelName (Table));
+            AddCodeArg (OP65_JMP, AM65_BRA, "callax");
+        }
+    }
+
+    /* Output the table into the read only data segment */
+    OldSeg = CS->CurDSeg;
+    g_userodata ();
+    g_defdatalabel (Table);
+    if (Kind == SWITCH_CASEJMP) {
+        AddDataLine ("\t.byte\t$%02X,$%02X", Min, Span - 1);
+        AddDataLine ("\t.addr\t%s", LocalLabelName (DefaultLabel));
+    }
+    if (Kind == SWITCH_TABLE && (CPUIsets[CPU] & CPU_ISET_65SC02) != 0 && Span <= 128) {
+        OutputTableLabels (".addr", Labels, Span);
+    } else {
+        OutputTableLabels (".lobytes", Labels, Span);
+        OutputTableLabels (".hibytes", Labels, Span);
+    }
+    UseDataSeg (OldSeg);
+
+    /* Free the table contents */
+    xfree (Labels);
+}
+
+
+
 void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth)
 /* Generate code for a switch statement */
 {
@@ -4367,21 +4629,37 @@ void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth)
     unsigned I;
 
     /* Setup registers and determine which compare insn to use */
-    const char* Compare;
+    opc_t Compare;
     switch (Depth) {
         case 1:
-            Compare = "cmp #$%02X";
+            /* The last level has the value in A, so we have several choices
+            ** for the dispatch code.
+            */
+            switch (ChooseSwitch (Nodes)) {
+                case SWITCH_BINARY:
+                    SwitchBinary (Nodes, 0, CollCount (Nodes) - 1, DefaultLabel);
+                    return;
+                case SWITCH_TABLE:
+                    SwitchTable (Nodes, DefaultLabel, SWITCH_TABLE);
+                    return;
+                case SWITCH_CASEJMP:
+                    SwitchTable (Nodes, DefaultLabel, SWITCH_CASEJMP);
+                    return;
+                default:
+                    break;
+            }
+            Compare = OP65_CMP;
             break;
         case 2:
-            Compare = "cpx #$%02X";
+            Compare = OP65_CPX;
             break;
         case 3:
-            AddCodeLine ("ldy sreg");
-            Compare = "cpy #$%02X";
+            AddCode (OP65_LDY, AM65_ZP, "sreg", 0);
+            Compare = OP65_CPY;
             break;
         case 4:
-            AddCodeLine ("ldy sreg+1");
-            Compare = "cpy #$%02X";
+            AddCode (OP65_LDY, AM65_ZP, "sreg+1", 0);
+            Compare = OP65_CPY;
             break;
         default:
             Internal ("Invalid depth in g_switch: %u", Depth);
@@ -4400,7 +4678,7 @@ void g_switch (Collection* Nodes, unsigned DefaultLabel, unsigned Depth)
         }
 
         /* Do the compare */
-        AddCodeLine (Compare, CN_GetValue (N));
+        AddCodeArg (Compare, AM65_IMM, "$%02X", CN_GetValue (N));
 
         /* If this is the last level, jump directly to the case code if found */
         if (Depth == 1) {
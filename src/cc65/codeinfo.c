@@ -114,6 +114,7 @@ static const FuncInfo FuncInfoTable[] = {
     { "boolule",        REG_NONE,             REG_AX                         },
     { "boolult",        REG_NONE,             REG_AX                         },
     { "callax",         REG_AX,               REG_ALL                        },
+    { "casejmp",        REG_AXY,              REG_ALL                        },
     { "complax",        REG_AX,               REG_AX                         },
     { "decax1",         REG_AX,               REG_AX                         },
     { "decax2",         REG_AX,               REG_AX                         },
@@ -716,10 +717,45 @@ unsigned GetRegInfo (struct CodeSeg* S, unsigned Index, unsigned Wanted)
 
 
 
+int RegUsed (CodeSeg* S, unsigned Index, unsigned Reg)
+/* Check if the value in the single register Reg is used, starting with the
+** instruction at Index.
+*/
+{
+    int Used;
+
+    /* There is no such code entry */
+    if (Index >= CS_GetEntryCount (S)) {
+        return 0;
+    }
+
+    /* Without register info, changes to the code aren't tracked, so follow
+    ** the code flow. The same is true for registers without liveness info.
+    ** Otherwise bring the liveness up to date.
+    */
+    if (!S->HaveBlocks || (Reg & ~CS_LIVE_REGS) != 0) {
+        return (GetRegInfo (S, Index, Reg) & Reg) != 0;
+    }
+    CS_GenLiveInfo (S);
+
+    /* Look up the liveness */
+    Used = (CS_GetEntry (S, Index)->Live & Reg) != 0;
+
+    /* Cross check the result if requested */
+    if (DebugOptRegInfo && Used != ((GetRegInfo (S, Index, Reg) & Reg) != 0)) {
+        Internal ("RegUsed: Liveness of register $%04X at index %u is wrong",
+                  Reg, Index);
+    }
+
+    return Used;
+}
+
+
+
 int RegAUsed (struct CodeSeg* S, unsigned Index)
 /* Check if the value in A is used. */
 {
-    return (GetRegInfo (S, Index, REG_A) & REG_A) != 0;
+    return RegUsed (S, Index, REG_A);
 }
 
 
@@ -727,7 +763,7 @@ int RegAUsed (struct CodeSeg* S, unsigned Index)
 int RegXUsed (struct CodeSeg* S, unsigned Index)
 /* Check if the value in X is used. */
 {
-    return (GetRegInfo (S, Index, REG_X) & REG_X) != 0;
+    return RegUsed (S, Index, REG_X);
 }
 
 
@@ -735,7 +771,7 @@ int RegXUsed (struct CodeSeg* S, unsigned Index)
 int RegYUsed (struct CodeSeg* S, unsigned Index)
 /* Check if the value in Y is used. */
 {
-    return (GetRegInfo (S, Index, REG_Y) & REG_Y) != 0;
+    return RegUsed (S, Index, REG_Y);
 }
 
 
@@ -153,6 +153,11 @@ unsigned GetRegInfo (struct CodeSeg* S, unsigned Index, unsigned Wanted);
 ** given index.
 */
 
+int RegUsed (struct CodeSeg* S, unsigned Index, unsigned Reg);
+/* Check if the value in the single register Reg is used, starting with the
+** instruction at Index.
+*/
+
 int RegAUsed (struct CodeSeg* S, unsigned Index);
 /* Check if the value in A is used. */
 
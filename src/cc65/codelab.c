@@ -62,6 +62,7 @@ CodeLabel* NewCodeLabel (const char* Name, unsigned Hash)
     L->Hash  = Hash;
     L->Owner = 0;
     InitCollection (&L->JumpFrom);
+    L->Flags = 0;
 
     /* Return the new label */
     return L;
@@ -95,6 +96,11 @@ void CL_AddRef (CodeLabel* L, struct CodeEntry* E)
 
     /* Remember that in the label */
     CollAppend (&L->JumpFrom, E);
+
+    /* The register info at the label target must be updated */
+    if (L->Owner) {
+        CE_InvalidateRegInfo (L->Owner);
+    }
 }
 
 
@@ -119,6 +125,9 @@ void CL_MoveRefs (CodeLabel* OldLabel, CodeLabel* NewLabel)
 
     /* There are no more references to the old label */
     CollDeleteAll (&OldLabel->JumpFrom);
+    if (OldLabel->Owner) {
+        CE_InvalidateRegInfo (OldLabel->Owner);
+    }
 }
 
 
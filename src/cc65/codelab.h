@@ -59,6 +59,9 @@ struct CodeEntry;
 
 
 
+/* Label flags */
+#define CLF_INDIRECT    0x01U           /* Target of an indirect jump */
+
 /* Label structure */
 typedef struct CodeLabel CodeLabel;
 struct CodeLabel {
@@ -67,6 +70,7 @@ struct CodeLabel {
     unsigned            Hash;           /* Hash over the name */
     struct CodeEntry*   Owner;          /* Owner entry */
     Collection          JumpFrom;       /* Entries that jump here */
+    unsigned char       Flags;          /* Label flags */
 };
 
 
@@ -103,6 +107,19 @@ INLINE struct CodeEntry* CL_GetRef (CodeLabel* L, unsigned Index)
 #  define CL_GetRef(L, Index)   CollAt (&(L)->JumpFrom, (Index))
 #endif
 
+#if defined(HAVE_INLINE)
+INLINE int CL_IsIndirect (const CodeLabel* L)
+/* Return true if the label is the target of an indirect jump. The address of
+** such a label is used in data, so the label must never be removed or
+** renamed, even if there are no references from code.
+*/
+{
+    return (L->Flags & CLF_INDIRECT) != 0;
+}
+#else
+#  define CL_IsIndirect(L)      (((L)->Flags & CLF_INDIRECT) != 0)
+#endif
+
 void CL_AddRef (CodeLabel* L, struct CodeEntry* E);
 /* Let the CodeEntry E reference the label L */
 
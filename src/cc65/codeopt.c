@@ -44,6 +44,7 @@
 #include "debugflag.h"
 #include "print.h"
 #include "strbuf.h"
+#include "thread.h"
 #include "xmalloc.h"
 #include "xsprintf.h"
 
@@ -57,6 +58,7 @@
 #include "coptcmp.h"
 #include "coptind.h"
 #include "coptneg.h"
+#include "coptpat.h"
 #include "coptptrload.h"
 #include "coptptrstore.h"
 #include "coptpush.h"
@@ -740,6 +742,7 @@ struct OptFunc {
     unsigned long  TotalChanges;        /* Total number of changes */
     unsigned long  LastChanges;         /* Last number of changes */
     char           Disabled;            /* True if function disabled */
+    unsigned       Index;               /* Index into OptFuncs */
 };
 
 
@@ -751,104 +754,104 @@ struct OptFunc {
 
 
 /* A list of all the function descriptions */
-static OptFunc DOpt65C02BitOps  = { Opt65C02BitOps,  "Opt65C02BitOps",   66, 0, 0, 0, 0, 0 };
-static OptFunc DOpt65C02Ind     = { Opt65C02Ind,     "Opt65C02Ind",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOpt65C02Stores  = { Opt65C02Stores,  "Opt65C02Stores",  100, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd1         = { OptAdd1,         "OptAdd1",         125, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd2         = { OptAdd2,         "OptAdd2",         200, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd3         = { OptAdd3,         "OptAdd3",          65, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd4         = { OptAdd4,         "OptAdd4",          90, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd5         = { OptAdd5,         "OptAdd5",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptAdd6         = { OptAdd6,         "OptAdd6",          40, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegA1       = { OptBNegA1,       "OptBNegA1",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegA2       = { OptBNegA2,       "OptBNegA2",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegAX1      = { OptBNegAX1,      "OptBNegAX1",      100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegAX2      = { OptBNegAX2,      "OptBNegAX2",      100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegAX3      = { OptBNegAX3,      "OptBNegAX3",      100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBNegAX4      = { OptBNegAX4,      "OptBNegAX4",      100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBoolTrans    = { OptBoolTrans,    "OptBoolTrans",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptBranchDist   = { OptBranchDist,   "OptBranchDist",     0, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp1         = { OptCmp1,         "OptCmp1",          42, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp2         = { OptCmp2,         "OptCmp2",          85, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp3         = { OptCmp3,         "OptCmp3",          75, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp4         = { OptCmp4,         "OptCmp4",          75, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp5         = { OptCmp5,         "OptCmp5",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp6         = { OptCmp6,         "OptCmp6",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp7         = { OptCmp7,         "OptCmp7",          85, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp8         = { OptCmp8,         "OptCmp8",          50, 0, 0, 0, 0, 0 };
-static OptFunc DOptCmp9         = { OptCmp9,         "OptCmp9",          85, 0, 0, 0, 0, 0 };
-static OptFunc DOptComplAX1     = { OptComplAX1,     "OptComplAX1",      65, 0, 0, 0, 0, 0 };
-static OptFunc DOptCondBranches1= { OptCondBranches1,"OptCondBranches1", 80, 0, 0, 0, 0, 0 };
-static OptFunc DOptCondBranches2= { OptCondBranches2,"OptCondBranches2",  0, 0, 0, 0, 0, 0 };
-static OptFunc DOptDeadCode     = { OptDeadCode,     "OptDeadCode",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptDeadJumps    = { OptDeadJumps,    "OptDeadJumps",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptDecouple     = { OptDecouple,     "OptDecouple",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptDupLoads     = { OptDupLoads,     "OptDupLoads",       0, 0, 0, 0, 0, 0 };
-static OptFunc DOptGotoSPAdj    = { OptGotoSPAdj,    "OptGotoSPAdj",      0, 0, 0, 0, 0, 0 };
-static OptFunc DOptIndLoads1    = { OptIndLoads1,    "OptIndLoads1",      0, 0, 0, 0, 0, 0 };
-static OptFunc DOptIndLoads2    = { OptIndLoads2,    "OptIndLoads2",      0, 0, 0, 0, 0, 0 };
-static OptFunc DOptJumpCascades = { OptJumpCascades, "OptJumpCascades", 100, 0, 0, 0, 0, 0 };
-static OptFunc DOptJumpTarget1  = { OptJumpTarget1,  "OptJumpTarget1",  100, 0, 0, 0, 0, 0 };
-static OptFunc DOptJumpTarget2  = { OptJumpTarget2,  "OptJumpTarget2",  100, 0, 0, 0, 0, 0 };
-static OptFunc DOptJumpTarget3  = { OptJumpTarget3,  "OptJumpTarget3",  100, 0, 0, 0, 0, 0 };
-static OptFunc DOptLoad1        = { OptLoad1,        "OptLoad1",        100, 0, 0, 0, 0, 0 };
-static OptFunc DOptLoad2        = { OptLoad2,        "OptLoad2",        200, 0, 0, 0, 0, 0 };
-static OptFunc DOptLoad3        = { OptLoad3,        "OptLoad3",          0, 0, 0, 0, 0, 0 };
-static OptFunc DOptNegAX1       = { OptNegAX1,       "OptNegAX1",       165, 0, 0, 0, 0, 0 };
-static OptFunc DOptNegAX2       = { OptNegAX2,       "OptNegAX2",       200, 0, 0, 0, 0, 0 };
-static OptFunc DOptRTS          = { OptRTS,          "OptRTS",          100, 0, 0, 0, 0, 0 };
-static OptFunc DOptRTSJumps1    = { OptRTSJumps1,    "OptRTSJumps1",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptRTSJumps2    = { OptRTSJumps2,    "OptRTSJumps2",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPrecalc      = { OptPrecalc,      "OptPrecalc",      100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad1     = { OptPtrLoad1,     "OptPtrLoad1",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad2     = { OptPtrLoad2,     "OptPtrLoad2",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad3     = { OptPtrLoad3,     "OptPtrLoad3",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad4     = { OptPtrLoad4,     "OptPtrLoad4",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad5     = { OptPtrLoad5,     "OptPtrLoad5",      50, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad6     = { OptPtrLoad6,     "OptPtrLoad6",      60, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad7     = { OptPtrLoad7,     "OptPtrLoad7",     140, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad11    = { OptPtrLoad11,    "OptPtrLoad11",     92, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad12    = { OptPtrLoad12,    "OptPtrLoad12",     50, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad13    = { OptPtrLoad13,    "OptPtrLoad13",     65, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad14    = { OptPtrLoad14,    "OptPtrLoad14",    108, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad15    = { OptPtrLoad15,    "OptPtrLoad15",     86, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad16    = { OptPtrLoad16,    "OptPtrLoad16",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad17    = { OptPtrLoad17,    "OptPtrLoad17",    190, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad18    = { OptPtrLoad18,    "OptPtrLoad18",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrLoad19    = { OptPtrLoad19,    "OptPtrLoad19",     65, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrStore1    = { OptPtrStore1,    "OptPtrStore1",     65, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrStore2    = { OptPtrStore2,    "OptPtrStore2",     65, 0, 0, 0, 0, 0 };
-static OptFunc DOptPtrStore3    = { OptPtrStore3,    "OptPtrStore3",    100, 0, 0, 0, 0, 0 };
-static OptFunc DOptPush1        = { OptPush1,        "OptPush1",         65, 0, 0, 0, 0, 0 };
-static OptFunc DOptPush2        = { OptPush2,        "OptPush2",         50, 0, 0, 0, 0, 0 };
-static OptFunc DOptPushPop      = { OptPushPop,      "OptPushPop",        0, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift1       = { OptShift1,       "OptShift1",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift2       = { OptShift2,       "OptShift2",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift3       = { OptShift3,       "OptShift3",        17, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift4       = { OptShift4,       "OptShift4",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift5       = { OptShift5,       "OptShift5",       110, 0, 0, 0, 0, 0 };
-static OptFunc DOptShift6       = { OptShift6,       "OptShift6",       200, 0, 0, 0, 0, 0 };
-static OptFunc DOptSize1        = { OptSize1,        "OptSize1",        100, 0, 0, 0, 0, 0 };
-static OptFunc DOptSize2        = { OptSize2,        "OptSize2",        100, 0, 0, 0, 0, 0 };
-static OptFunc DOptStackOps     = { OptStackOps,     "OptStackOps",     100, 0, 0, 0, 0, 0 };
-static OptFunc DOptStackPtrOps  = { OptStackPtrOps,  "OptStackPtrOps",   50, 0, 0, 0, 0, 0 };
-static OptFunc DOptStore1       = { OptStore1,       "OptStore1",        70, 0, 0, 0, 0, 0 };
-static OptFunc DOptStore2       = { OptStore2,       "OptStore2",       115, 0, 0, 0, 0, 0 };
-static OptFunc DOptStore3       = { OptStore3,       "OptStore3",       120, 0, 0, 0, 0, 0 };
-static OptFunc DOptStore4       = { OptStore4,       "OptStore4",        50, 0, 0, 0, 0, 0 };
-static OptFunc DOptStore5       = { OptStore5,       "OptStore5",       100, 0, 0, 0, 0, 0 };
-static OptFunc DOptStoreLoad    = { OptStoreLoad,    "OptStoreLoad",      0, 0, 0, 0, 0, 0 };
-static OptFunc DOptSub1         = { OptSub1,         "OptSub1",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptSub2         = { OptSub2,         "OptSub2",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptSub3         = { OptSub3,         "OptSub3",         100, 0, 0, 0, 0, 0 };
-static OptFunc DOptTest1        = { OptTest1,        "OptTest1",         65, 0, 0, 0, 0, 0 };
-static OptFunc DOptTest2        = { OptTest2,        "OptTest2",         50, 0, 0, 0, 0, 0 };
-static OptFunc DOptTransfers1   = { OptTransfers1,   "OptTransfers1",     0, 0, 0, 0, 0, 0 };
-static OptFunc DOptTransfers2   = { OptTransfers2,   "OptTransfers2",    60, 0, 0, 0, 0, 0 };
-static OptFunc DOptTransfers3   = { OptTransfers3,   "OptTransfers3",    65, 0, 0, 0, 0, 0 };
-static OptFunc DOptTransfers4   = { OptTransfers4,   "OptTransfers4",    65, 0, 0, 0, 0, 0 };
-static OptFunc DOptUnusedLoads  = { OptUnusedLoads,  "OptUnusedLoads",    0, 0, 0, 0, 0, 0 };
-static OptFunc DOptUnusedStores = { OptUnusedStores, "OptUnusedStores",   0, 0, 0, 0, 0, 0 };
+static OptFunc DOpt65C02BitOps  = { Opt65C02BitOps,  "Opt65C02BitOps",   66, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOpt65C02Ind     = { Opt65C02Ind,     "Opt65C02Ind",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOpt65C02Stores  = { Opt65C02Stores,  "Opt65C02Stores",  100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd1         = { OptAdd1,         "OptAdd1",         125, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd2         = { OptAdd2,         "OptAdd2",         200, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd3         = { OptAdd3,         "OptAdd3",          65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd4         = { OptAdd4,         "OptAdd4",          90, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd5         = { OptAdd5,         "OptAdd5",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptAdd6         = { OptAdd6,         "OptAdd6",          40, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegA1       = { OptBNegA1,       "OptBNegA1",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegA2       = { OptBNegA2,       "OptBNegA2",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegAX1      = { OptBNegAX1,      "OptBNegAX1",      100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegAX2      = { OptBNegAX2,      "OptBNegAX2",      100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegAX3      = { OptBNegAX3,      "OptBNegAX3",      100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBNegAX4      = { OptBNegAX4,      "OptBNegAX4",      100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBoolTrans    = { OptBoolTrans,    "OptBoolTrans",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptBranchDist   = { OptBranchDist,   "OptBranchDist",     0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp1         = { OptCmp1,         "OptCmp1",          42, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp2         = { OptCmp2,         "OptCmp2",          85, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp3         = { OptCmp3,         "OptCmp3",          75, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp4         = { OptCmp4,         "OptCmp4",          75, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp5         = { OptCmp5,         "OptCmp5",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp6         = { OptCmp6,         "OptCmp6",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp7         = { OptCmp7,         "OptCmp7",          85, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp8         = { OptCmp8,         "OptCmp8",          50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCmp9         = { OptCmp9,         "OptCmp9",          85, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptComplAX1     = { OptComplAX1,     "OptComplAX1",      65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCondBranches1= { OptCondBranches1,"OptCondBranches1", 80, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptCondBranches2= { OptCondBranches2,"OptCondBranches2",  0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptDeadCode     = { OptDeadCode,     "OptDeadCode",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptDeadJumps    = { OptDeadJumps,    "OptDeadJumps",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptDecouple     = { OptDecouple,     "OptDecouple",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptDupLoads     = { OptDupLoads,     "OptDupLoads",       0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptGotoSPAdj    = { OptGotoSPAdj,    "OptGotoSPAdj",      0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptIndLoads1    = { OptIndLoads1,    "OptIndLoads1",      0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptIndLoads2    = { OptIndLoads2,    "OptIndLoads2",      0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptJumpCascades = { OptJumpCascades, "OptJumpCascades", 100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptJumpTarget1  = { OptJumpTarget1,  "OptJumpTarget1",  100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptJumpTarget2  = { OptJumpTarget2,  "OptJumpTarget2",  100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptJumpTarget3  = { OptJumpTarget3,  "OptJumpTarget3",  100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptLoad1        = { OptLoad1,        "OptLoad1",        100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptLoad2        = { OptLoad2,        "OptLoad2",        200, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptLoad3        = { OptLoad3,        "OptLoad3",          0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptNegAX1       = { OptNegAX1,       "OptNegAX1",       165, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptNegAX2       = { OptNegAX2,       "OptNegAX2",       200, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptRTS          = { OptRTS,          "OptRTS",          100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptRTSJumps1    = { OptRTSJumps1,    "OptRTSJumps1",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptRTSJumps2    = { OptRTSJumps2,    "OptRTSJumps2",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPrecalc      = { OptPrecalc,      "OptPrecalc",      100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad1     = { OptPtrLoad1,     "OptPtrLoad1",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad2     = { OptPtrLoad2,     "OptPtrLoad2",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad3     = { OptPtrLoad3,     "OptPtrLoad3",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad4     = { OptPtrLoad4,     "OptPtrLoad4",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad5     = { OptPtrLoad5,     "OptPtrLoad5",      50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad6     = { OptPtrLoad6,     "OptPtrLoad6",      60, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad7     = { OptPtrLoad7,     "OptPtrLoad7",     140, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad11    = { OptPtrLoad11,    "OptPtrLoad11",     92, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad12    = { OptPtrLoad12,    "OptPtrLoad12",     50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad13    = { OptPtrLoad13,    "OptPtrLoad13",     65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad14    = { OptPtrLoad14,    "OptPtrLoad14",    108, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad15    = { OptPtrLoad15,    "OptPtrLoad15",     86, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad16    = { OptPtrLoad16,    "OptPtrLoad16",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad17    = { OptPtrLoad17,    "OptPtrLoad17",    190, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad18    = { OptPtrLoad18,    "OptPtrLoad18",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrLoad19    = { OptPtrLoad19,    "OptPtrLoad19",     65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrStore1    = { OptPtrStore1,    "OptPtrStore1",     65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrStore2    = { OptPtrStore2,    "OptPtrStore2",     65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPtrStore3    = { OptPtrStore3,    "OptPtrStore3",    100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPush1        = { OptPush1,        "OptPush1",         65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPush2        = { OptPush2,        "OptPush2",         50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptPushPop      = { OptPushPop,      "OptPushPop",        0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift1       = { OptShift1,       "OptShift1",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift2       = { OptShift2,       "OptShift2",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift3       = { OptShift3,       "OptShift3",        17, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift4       = { OptShift4,       "OptShift4",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift5       = { OptShift5,       "OptShift5",       110, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptShift6       = { OptShift6,       "OptShift6",       200, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptSize1        = { OptSize1,        "OptSize1",        100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptSize2        = { OptSize2,        "OptSize2",        100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStackOps     = { OptStackOps,     "OptStackOps",     100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStackPtrOps  = { OptStackPtrOps,  "OptStackPtrOps",   50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStore1       = { OptStore1,       "OptStore1",        70, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStore2       = { OptStore2,       "OptStore2",       115, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStore3       = { OptStore3,       "OptStore3",       120, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStore4       = { OptStore4,       "OptStore4",        50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStore5       = { OptStore5,       "OptStore5",       100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptStoreLoad    = { OptStoreLoad,    "OptStoreLoad",      0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptSub1         = { OptSub1,         "OptSub1",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptSub2         = { OptSub2,         "OptSub2",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptSub3         = { OptSub3,         "OptSub3",         100, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTest1        = { OptTest1,        "OptTest1",         65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTest2        = { OptTest2,        "OptTest2",         50, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTransfers1   = { OptTransfers1,   "OptTransfers1",     0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTransfers2   = { OptTransfers2,   "OptTransfers2",    60, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTransfers3   = { OptTransfers3,   "OptTransfers3",    65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptTransfers4   = { OptTransfers4,   "OptTransfers4",    65, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptUnusedLoads  = { OptUnusedLoads,  "OptUnusedLoads",    0, 0, 0, 0, 0, 0, 0 };
+static OptFunc DOptUnusedStores = { OptUnusedStores, "OptUnusedStores",   0, 0, 0, 0, 0, 0, 0 };
 
 
 /* Table containing all the steps in alphabetical order */
@@ -954,6 +957,53 @@ static OptFunc* OptFuncs[] = {
 };
 #define OPTFUNC_COUNT  (sizeof(OptFuncs) / sizeof(OptFuncs[0]))
 
+/* The pattern based optimizer steps, indexed by their pattern group */
+static OptFunc* const PatternFuncs[PAT_GROUP_COUNT] = {
+    &DOptBNegA1,
+    &DOptBNegA2,
+    &DOptBNegAX1,
+    &DOptBNegAX2,
+    &DOptBNegAX3,
+    &DOptBNegAX4,
+    &DOptCmp1,
+    &DOptCmp2,
+    &DOptCmp7,
+    &DOptCmp9,
+    &DOptComplAX1,
+    &DOptNegAX1,
+    &DOptNegAX2,
+    &DOptStoreLoad,
+    &DOptSub1,
+    &DOptTransfers1,
+};
+
+/* Statistics collected by one optimizer thread */
+typedef struct OptStats OptStats;
+struct OptStats {
+    unsigned long  Runs[OPTFUNC_COUNT];         /* Number of runs */
+    unsigned long  Changes[OPTFUNC_COUNT];      /* Number of changes */
+};
+
+/* Statistics for the current thread */
+static THREAD_LOCAL OptStats* Stats;
+
+/* Shared data for the optimizer threads */
+typedef struct OptQueue OptQueue;
+struct OptQueue {
+    const Collection*   Segs;           /* Code segments to optimize */
+    unsigned            Next;           /* Index of next segment */
+    Mutex*              Lock;           /* Lock for Next */
+};
+
+/* Data for one optimizer thread */
+typedef struct OptWorker OptWorker;
+struct OptWorker {
+    Thread*             T;              /* The thread */
+    OptQueue*           Queue;          /* Shared work queue */
+    OptStats            Stats;          /* Statistics of this thread */
+    MemPool             Pool;           /* Pool for code entries */
+};
+
 
 
 static int CmpOptStep (const void* Key, const void* Func)
@@ -1206,10 +1256,8 @@ static unsigned RunOptFunc (CodeSeg* S, OptFunc* F, unsigned Max)
         Changes += C;
 
         /* Do statistics */
-        ++F->TotalRuns;
-        ++F->LastRuns;
-        F->TotalChanges += C;
-        F->LastChanges  += C;
+        ++Stats->Runs[F->Index];
+        Stats->Changes[F->Index] += C;
 
         /* If we had changes, output stuff and regenerate register info */
         if (C) {
@@ -1228,6 +1276,71 @@ static unsigned RunOptFunc (CodeSeg* S, OptFunc* F, unsigned Max)
 
 
 
+static unsigned RunOptPatterns (CodeSeg* S, unsigned long Groups)
+/* Run the pattern based optimizer steps of the pattern groups in Groups with
+** one walk over the code. Steps that are disabled or prohibited by the code
+** size factor are left out, and the statistics are kept for each step.
+*/
+{
+    unsigned      Changes[PAT_GROUP_COUNT];
+    unsigned long Enabled;
+    unsigned      Total;
+    unsigned      G;
+
+    /* Determine the steps that may run */
+    Enabled = 0;
+    for (G = 0; G < PAT_GROUP_COUNT; ++G) {
+        const OptFunc* F = PatternFuncs[G];
+        if ((Groups & PAT_GROUP (G)) != 0   &&
+            !F->Disabled                    &&
+            F->CodeSizeFactor <= S->CodeSizeFactor) {
+            Enabled |= PAT_GROUP (G);
+        }
+    }
+    if (Enabled == 0) {
+        return 0;
+    }
+
+    /* Run the patterns of all these steps */
+    Total = CS_ApplyPatterns (S, Enabled, Changes);
+
+    /* Do statistics */
+    for (G = 0; G < PAT_GROUP_COUNT; ++G) {
+        if ((Enabled & PAT_GROUP (G)) != 0) {
+            const OptFunc* F = PatternFuncs[G];
+            ++Stats->Runs[F->Index];
+            Stats->Changes[F->Index] += Changes[G];
+            if (Changes[G] && Debug) {
+                printf ("Applied %s: %u changes\n", F->Name, Changes[G]);
+            }
+        }
+    }
+
+    /* If we had changes, output stuff and regenerate register info */
+    if (Total) {
+        if (DebugOptOutput) {
+            StrBuf Names = STATIC_STRBUF_INITIALIZER;
+            for (G = 0; G < PAT_GROUP_COUNT; ++G) {
+                if (Changes[G]) {
+                    if (SB_GetLen (&Names) > 0) {
+                        SB_AppendStr (&Names, ", ");
+                    }
+                    SB_AppendStr (&Names, PatternFuncs[G]->Name);
+                }
+            }
+            SB_Terminate (&Names);
+            WriteDebugOutput (S, SB_GetConstBuf (&Names));
+            SB_Done (&Names);
+        }
+        CS_GenRegInfo (S);
+    }
+
+    /* Return the number of changes */
+    return Total;
+}
+
+
+
 static unsigned RunOptGroup1 (CodeSeg* S)
 /* Run the first group of optimization steps. These steps translate known
 ** patterns emitted by the code generator into more optimal patterns. Order
@@ -1259,16 +1372,16 @@ static unsigned RunOptGroup1 (CodeSeg* S)
     Changes += RunOptFunc (S, &DOptPtrLoad15, 1);
     Changes += RunOptFunc (S, &DOptPtrLoad16, 1);
     Changes += RunOptFunc (S, &DOptPtrLoad17, 1);
-    Changes += RunOptFunc (S, &DOptBNegAX1, 1);
-    Changes += RunOptFunc (S, &DOptBNegAX2, 1);
-    Changes += RunOptFunc (S, &DOptBNegAX3, 1);
-    Changes += RunOptFunc (S, &DOptBNegAX4, 1);
+    Changes += RunOptPatterns (S, PAT_GROUP (PAT_BNEGAX1));
+    Changes += RunOptPatterns (S, PAT_GROUP (PAT_BNEGAX2));
+    Changes += RunOptPatterns (S, PAT_GROUP (PAT_BNEGAX3));
+    Changes += RunOptPatterns (S, PAT_GROUP (PAT_BNEGAX4));
     Changes += RunOptFunc (S, &DOptAdd1, 1);
     Changes += RunOptFunc (S, &DOptAdd2, 1);
     Changes += RunOptFunc (S, &DOptAdd4, 1);
     Changes += RunOptFunc (S, &DOptAdd5, 1);
     Changes += RunOptFunc (S, &DOptAdd6, 1);
-    Changes += RunOptFunc (S, &DOptSub1, 1);
+    Changes += RunOptPatterns (S, PAT_GROUP (PAT_SUB1));
     Changes += RunOptFunc (S, &DOptSub3, 1);
     Changes += RunOptFunc (S, &DOptStore4, 1);
     Changes += RunOptFunc (S, &DOptStore5, 1);
@@ -1315,15 +1428,15 @@ static unsigned RunOptGroup3 (CodeSeg* S)
     do {
         C = 0;
 
-        C += RunOptFunc (S, &DOptBNegA1, 1);
-        C += RunOptFunc (S, &DOptBNegA2, 1);
-        C += RunOptFunc (S, &DOptNegAX1, 1);
-        C += RunOptFunc (S, &DOptNegAX2, 1);
+        C += RunOptPatterns (S, PAT_GROUP (PAT_BNEGA1));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_BNEGA2));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_NEGAX1));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_NEGAX2));
         C += RunOptFunc (S, &DOptStackOps, 3);
         C += RunOptFunc (S, &DOptShift1, 1);
         C += RunOptFunc (S, &DOptShift4, 1);
-        C += RunOptFunc (S, &DOptComplAX1, 1);
-        C += RunOptFunc (S, &DOptSub1, 1);
+        C += RunOptPatterns (S, PAT_GROUP (PAT_COMPLAX1));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_SUB1));
         C += RunOptFunc (S, &DOptSub2, 1);
         C += RunOptFunc (S, &DOptSub3, 1);
         C += RunOptFunc (S, &DOptAdd5, 1);
@@ -1338,23 +1451,23 @@ static unsigned RunOptGroup3 (CodeSeg* S)
         C += RunOptFunc (S, &DOptCondBranches1, 1);
         C += RunOptFunc (S, &DOptCondBranches2, 1);
         C += RunOptFunc (S, &DOptRTSJumps1, 1);
-        C += RunOptFunc (S, &DOptCmp1, 1);
-        C += RunOptFunc (S, &DOptCmp2, 1);
+        C += RunOptPatterns (S, PAT_GROUP (PAT_CMP1));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_CMP2));
         C += RunOptFunc (S, &DOptCmp8, 1);      /* Must run before OptCmp3 */
         C += RunOptFunc (S, &DOptCmp3, 1);
         C += RunOptFunc (S, &DOptCmp4, 1);
         C += RunOptFunc (S, &DOptCmp5, 1);
         C += RunOptFunc (S, &DOptCmp6, 1);
-        C += RunOptFunc (S, &DOptCmp7, 1);
-        C += RunOptFunc (S, &DOptCmp9, 1);
+        C += RunOptPatterns (S, PAT_GROUP (PAT_CMP7));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_CMP9));
         C += RunOptFunc (S, &DOptTest1, 1);
         C += RunOptFunc (S, &DOptLoad1, 1);
         C += RunOptFunc (S, &DOptJumpTarget3, 1);       /* After OptCondBranches2 */
         C += RunOptFunc (S, &DOptUnusedLoads, 1);
         C += RunOptFunc (S, &DOptUnusedStores, 1);
         C += RunOptFunc (S, &DOptDupLoads, 1);
-        C += RunOptFunc (S, &DOptStoreLoad, 1);
-        C += RunOptFunc (S, &DOptTransfers1, 1);
+        C += RunOptPatterns (S, PAT_GROUP (PAT_STORELOAD));
+        C += RunOptPatterns (S, PAT_GROUP (PAT_TRANSFERS1));
         C += RunOptFunc (S, &DOptTransfers3, 1);
         C += RunOptFunc (S, &DOptTransfers4, 1);
         C += RunOptFunc (S, &DOptStore1, 1);
@@ -1500,22 +1613,14 @@ static unsigned RunOptGroup7 (CodeSeg* S)
 
 
 
-void RunOpt (CodeSeg* S)
-/* Run the optimizer */
+static void OptimizeCodeSeg (CodeSeg* S)
+/* Run the optimizer for one code segment */
 {
-    const char* StatFileName;
-
     /* If we shouldn't run the optimizer, bail out */
     if (!S->Optimize) {
         return;
     }
 
-    /* Check if we are requested to write optimizer statistics */
-    StatFileName = getenv ("CC65_OPTSTATS");
-    if (StatFileName) {
-        ReadOptStats (StatFileName);
-    }
-
     /* Print the name of the function we are working on */
     if (S->Func) {
         Print (stdout, 1, "Running optimizer for function '%s'\n", S->Func->Name);
@@ -1546,6 +1651,137 @@ void RunOpt (CodeSeg* S)
     if (DebugOptOutput) {
         CloseOutputFile ();
     }
+}
+
+
+
+static void OptWorkerMain (void* Data)
+/* Main function of an optimizer thread. Optimizes code segments from the
+** queue until it is empty.
+*/
+{
+    OptWorker* W = Data;
+    OptQueue*  Q = W->Queue;
+
+    /* Use the statistics of this thread */
+    Stats = &W->Stats;
+
+    /* Use the pool of this thread for code entries */
+    CE_UsePool (&W->Pool);
+
+    while (1) {
+
+        /* Get the index of the next code segment */
+        unsigned I;
+        LockMutex (Q->Lock);
+        I = Q->Next++;
+        UnlockMutex (Q->Lock);
+
+        /* Bail out if there are no more segments */
+        if (I >= CollCount (Q->Segs)) {
+            break;
+        }
+
+        /* Optimize this segment */
+        OptimizeCodeSeg (CollAtUnchecked (Q->Segs, I));
+    }
+}
+
+
+
+static void AddOptStats (const OptStats* S)
+/* Add the statistics from one thread to the totals */
+{
+    unsigned I;
+    for (I = 0; I < OPTFUNC_COUNT; ++I) {
+        OptFunc* F = OptFuncs[I];
+        F->TotalRuns    += S->Runs[I];
+        F->LastRuns     += S->Runs[I];
+        F->TotalChanges += S->Changes[I];
+        F->LastChanges  += S->Changes[I];
+    }
+}
+
+
+
+void RunOpt (const Collection* Segs)
+/* Run the optimizer for all code segments in the given collection. If
+** OptimizerJobs is greater than one, several code segments are optimized
+** at the same time. The generated code is the same in both cases.
+*/
+{
+    const char* StatFileName;
+    unsigned    Jobs;
+    unsigned    I;
+
+    /* Check if we are requested to write optimizer statistics */
+    StatFileName = getenv ("CC65_OPTSTATS");
+    if (StatFileName) {
+        ReadOptStats (StatFileName);
+    }
+
+    /* Remember the table index of each function for the statistics */
+    for (I = 0; I < OPTFUNC_COUNT; ++I) {
+        OptFuncs[I]->Index = I;
+    }
+
+    /* Compile the patterns used by the pattern based optimizer steps */
+    InitPatterns ();
+
+    /* Don't use more threads than there are code segments */
+    Jobs = OptimizerJobs;
+    if (Jobs > CollCount (Segs)) {
+        Jobs = CollCount (Segs);
+    }
+
+    if (Jobs <= 1) {
+
+        /* Optimize all segments in this thread */
+        Stats = xmalloc (sizeof (OptStats));
+        memset (Stats, 0, sizeof (OptStats));
+        for (I = 0; I < CollCount (Segs); ++I) {
+            OptimizeCodeSeg (CollAtUnchecked (Segs, I));
+        }
+        AddOptStats (Stats);
+        xfree (Stats);
+        Stats = 0;
+
+    } else {
+
+        /* Setup the queue shared by all threads */
+        OptQueue   Queue;
+        OptWorker* Workers = xmalloc (Jobs * sizeof (OptWorker));
+        Queue.Segs = Segs;
+        Queue.Next = 0;
+        Queue.Lock = NewMutex ();
+
+        /* Start the threads */
+        for (I = 0; I < Jobs; ++I) {
+            OptWorker* W = Workers + I;
+            memset (&W->Stats, 0, sizeof (W->Stats));
+            InitMemPool (&W->Pool, 0, sizeof (CodeEntry));
+            W->Queue = &Queue;
+            W->T = NewThread (OptWorkerMain, W);
+        }
+
+        /* Wait until all of them are done */
+        for (I = 0; I < Jobs; ++I) {
+            JoinThread (Workers[I].T);
+            AddOptStats (&Workers[I].Stats);
+            CE_MergePool (&Workers[I].Pool);
+        }
+
+        /* Cleanup */
+        FreeMutex (Queue.Lock);
+        xfree (Workers);
+    }
+
+    /* Assign the final names for the labels generated by the optimizer. This
+    ** must be done in output order to get deterministic label names.
+    */
+    for (I = 0; I < CollCount (Segs); ++I) {
+        CS_NameGenLabels (CollAtUnchecked (Segs, I));
+    }
 
     /* Write statistics */
     if (StatFileName) {
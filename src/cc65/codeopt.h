@@ -38,6 +38,9 @@
 
 
 
+/* common */
+#include "coll.h"
+
 /* cc65 */
 #include "codeseg.h"
 
@@ -58,8 +61,11 @@ void EnableOpt (const char* Name);
 void ListOptSteps (FILE* F);
 /* List all optimization steps */
 
-void RunOpt (CodeSeg* S);
-/* Run the optimizer */
+void RunOpt (const Collection* Segs);
+/* Run the optimizer for all code segments in the given collection. If
+** OptimizerJobs is greater than one, several code segments are optimized
+** at the same time. The generated code is the same in both cases.
+*/
 
 
 
@@ -33,6 +33,7 @@
 
 
 
+#include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 
@@ -45,6 +46,7 @@
 #include "strbuf.h"
 #include "strutil.h"
 #include "xmalloc.h"
+#include "xsprintf.h"
 
 /* cc65 */
 #include "asmlabel.h"
@@ -60,6 +62,17 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Format for the temporary names of labels created by CS_GenLabel */
+#define GEN_LABEL_FORMAT        "L.%u"
+
+
+
 /*****************************************************************************/
 /*                             Helper functions                              */
 /*****************************************************************************/
@@ -85,6 +98,131 @@ static void CS_PrintFunctionHeader (const CodeSeg* S)
 
 
 
+static CodeBlock* CS_NewBlock (CodeSeg* S, CodeEntry* E)
+/* Create a new block that starts with E and return it */
+{
+    return NewCodeBlock (E, &S->ChangedBlocks);
+}
+
+
+
+static void CS_KillBlock (CodeSeg* S, CodeBlock* B)
+/* Mark the block as no longer in use. Since entries may still point to it,
+** it is freed after the next update of the register info.
+*/
+{
+    if (B->Flags & CBF_BACKREF) {
+        B->Flags &= ~CBF_BACKREF;
+        --S->BackRefBlocks;
+    }
+    B->First = 0;
+    CollAppend (&S->DeadBlocks, B);
+}
+
+
+
+static void CS_MarkEntry (CodeSeg* S, CodeEntry* E)
+/* Mark the register info of E as outdated. A new entry gets a block of its
+** own. The boundaries are corrected when the register info is updated.
+*/
+{
+    if (E->Block == 0) {
+        CS_NewBlock (S, E);
+    }
+    CE_InvalidateRegInfo (E);
+}
+
+
+
+static void CS_InvalidateRegInfo (CodeSeg* S, unsigned Index, unsigned Count)
+/* The Count entries starting with the one at Index were inserted or moved
+** there. Count is zero if entries before Index were deleted. Mark the
+** register info of these entries, of their neighbours and at the targets of
+** their jumps as outdated. The same is true for the cached entry indices.
+*/
+{
+    unsigned I;
+    unsigned Last = Index + Count;
+
+    if (Index < S->ValidIndices) {
+        S->ValidIndices = Index;
+    }
+
+    /* Nothing more to do if there is no register info */
+    if (!S->HaveBlocks) {
+        return;
+    }
+
+    for (I = (Index > 0)? Index - 1 : 0; I <= Last && I < CS_GetEntryCount (S); ++I) {
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        CS_MarkEntry (S, E);
+        if (I >= Index && I < Last &&
+            E->JumpTo && E->JumpTo->Owner && E->JumpTo->Owner->Block) {
+            CS_MarkEntry (S, E->JumpTo->Owner);
+        }
+    }
+}
+
+
+
+static void CS_RemoveEntry (CodeSeg* S, unsigned Index)
+/* Remove the entry at Index from the list of entries without freeing it */
+{
+    CodeEntry* E = CollAtUnchecked (&S->Entries, Index);
+    if (E->Block && E->Block->First == E) {
+        CS_KillBlock (S, E->Block);
+    }
+    CollDelete (&S->Entries, Index);
+    CS_InvalidateRegInfo (S, Index, 0);
+}
+
+
+
+static int CS_HasValidIndex (const CodeSeg* S, const CodeEntry* E)
+/* Return true if the cached index of E is valid */
+{
+    return (E->Index < S->ValidIndices &&
+            CollAtUnchecked (&S->Entries, E->Index) == E);
+}
+
+
+
+static void CS_LabelsChanged (CodeSeg* S, CodeEntry* E)
+/* Labels were added to or removed from E. Invalidate the cached label counts
+** of the following entries. If E doesn't have a valid cached index, it is
+** located behind all entries with valid indices, so there is nothing to do.
+*/
+{
+    if (CS_HasValidIndex (S, E)) {
+        S->ValidIndices = E->Index + 1;
+    }
+
+    /* Labels define the jump targets, so the register info changes */
+    CE_InvalidateRegInfo (E);
+}
+
+
+
+static void CS_UpdateIndices (CodeSeg* S, unsigned Last)
+/* Update the cached indices and label counts up to and including the entry
+** with index Last.
+*/
+{
+    while (S->ValidIndices <= Last) {
+        unsigned   I = S->ValidIndices++;
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        E->Index = I;
+        if (I == 0) {
+            E->PrevLabels = 0;
+        } else {
+            const CodeEntry* P = CollAtUnchecked (&S->Entries, I - 1);
+            E->PrevLabels = P->PrevLabels + (CE_HasLabel (P) != 0);
+        }
+    }
+}
+
+
+
 static void CS_MoveLabelsToEntry (CodeSeg* S, CodeEntry* E)
 /* Move all labels from the label pool to the given entry and remove them
 ** from the pool.
@@ -104,6 +242,11 @@ static void CS_MoveLabelsToEntry (CodeSeg* S, CodeEntry* E)
 
     /* Delete the transfered labels */
     CollDeleteAll (&S->Labels);
+
+    /* The entry may already be part of the code */
+    if (LabelCount > 0) {
+        CS_LabelsChanged (S, E);
+    }
 }
 
 
@@ -118,6 +261,7 @@ static void CS_MoveLabelsToPool (CodeSeg* S, CodeEntry* E)
         CollAppend (&S->Labels, L);
     }
     CollDeleteAll (&E->Labels);
+    CS_LabelsChanged (S, E);
 }
 
 
@@ -414,25 +558,10 @@ static CodeEntry* ParseInsn (CodeSeg* S, LineInfo* LI, const char* L)
 
     }
 
-    /* If the instruction is a branch, check for the label and generate it
-    ** if it does not exist. This may lead to unused labels (if the label
-    ** is actually an external one) which are removed by the CS_MergeLabels
-    ** function later.
-    */
+    /* If the instruction is a branch, get the label */
     Label = 0;
     if (AM == AM65_BRA) {
-
-        /* Generate the hash over the label, then search for the label */
-        unsigned Hash = HashStr (Arg) % CS_LABEL_HASH_SIZE;
-        Label = CS_FindLabel (S, Arg, Hash);
-
-        /* If we don't have the label, it's a forward ref - create it unless
-        ** it's an external function.
-        */
-        if (Label == 0 && (OPC->OPC != OP65_JMP || IsLocalLabelName (Arg)) ) {
-            /* Generate a new label */
-            Label = CS_NewCodeLabel (S, Arg, Hash);
-        }
+        Label = CS_GetJumpLabel (S, OPC->OPC, Arg);
     }
 
     /* We do now have the addressing mode in AM. Allocate a new CodeEntry
@@ -469,6 +598,14 @@ CodeSeg* NewCodeSeg (const char* SegName, SymEntry* Func)
     for (I = 0; I < sizeof(S->LabelHash) / sizeof(S->LabelHash[0]); ++I) {
         S->LabelHash[I] = 0;
     }
+    InitCollection (&S->ChangedBlocks);
+    InitCollection (&S->DeadBlocks);
+    S->BackRefBlocks = 0;
+    S->HaveBlocks = 0;
+    S->ValidIndices = 0;
+    S->LiveSeen = 0;
+    S->LiveValid = 0;
+    S->GenLabelCount = 0;
 
     /* If we have a function given, get the return type of the function.
     ** Assume ANY return type besides void will use the A and X registers.
@@ -501,6 +638,7 @@ void CS_AddEntry (CodeSeg* S, struct CodeEntry* E)
 
     /* Add the entry to the list of code entries in this segment */
     CollAppend (&S->Entries, E);
+    CS_InvalidateRegInfo (S, CollCount (&S->Entries) - 1, 1);
 }
 
 
@@ -571,6 +709,7 @@ void CS_InsertEntry (CodeSeg* S, struct CodeEntry* E, unsigned Index)
 {
     /* Insert the entry into the collection */
     CollInsert (&S->Entries, E, Index);
+    CS_InvalidateRegInfo (S, Index, 1);
 }
 
 
@@ -623,7 +762,7 @@ void CS_DelEntry (CodeSeg* S, unsigned Index)
     }
 
     /* Delete the pointer to the insn */
-    CollDelete (&S->Entries, Index);
+    CS_RemoveEntry (S, Index);
 
     /* Delete the instruction itself */
     FreeCodeEntry (E);
@@ -669,8 +808,24 @@ void CS_MoveEntries (CodeSeg* S, unsigned Start, unsigned Count, unsigned NewPos
         CS_MoveLabelsToEntry (S, CS_GetEntry (S, Start));
     }
 
-    /* Move the code block to the destination */
+    /* Move the code block to the destination. The entries are marked as
+    ** changed at the old and at the new position.
+    */
+    CS_InvalidateRegInfo (S, Start, Count);
     CollMoveMultiple (&S->Entries, Start, Count, NewPos);
+    CS_InvalidateRegInfo (S, (Start < NewPos)? NewPos - Count : NewPos, Count);
+}
+
+
+
+void CS_MoveEntry (CodeSeg* S, unsigned OldPos, unsigned NewPos)
+/* Move an entry from one position to another. OldPos is the current position
+** of the entry, NewPos is the new position of the entry.
+*/
+{
+    CS_InvalidateRegInfo (S, OldPos, 1);
+    CollMove (&S->Entries, OldPos, NewPos);
+    CS_InvalidateRegInfo (S, (OldPos < NewPos)? NewPos - 1 : NewPos, 1);
 }
 
 
@@ -730,11 +885,18 @@ int CS_GetEntries (CodeSeg* S, struct CodeEntry** List,
 
 
 unsigned CS_GetEntryIndex (CodeSeg* S, struct CodeEntry* E)
-/* Return the index of a code entry */
+/* Return the index of a code entry. The index is cached in the entry, so
+** this is usually a constant time operation.
+*/
 {
-    int Index = CollIndex (&S->Entries, E);
-    CHECK (Index >= 0);
-    return Index;
+    /* If the cached index is invalid, E is located behind all entries with
+    ** valid indices. Update the indices until we reach it.
+    */
+    while (!CS_HasValidIndex (S, E)) {
+        CHECK (S->ValidIndices < CS_GetEntryCount (S));
+        CS_UpdateIndices (S, S->ValidIndices);
+    }
+    return E->Index;
 }
 
 
@@ -745,6 +907,8 @@ int CS_RangeHasLabel (CodeSeg* S, unsigned Start, unsigned Count)
 ** possible span instead.
 */
 {
+    const CodeEntry* First;
+    const CodeEntry* Last;
     unsigned EntryCount = CS_GetEntryCount(S);
 
     /* Adjust count. We expect at least Start to be valid. */
@@ -753,18 +917,19 @@ int CS_RangeHasLabel (CodeSeg* S, unsigned Start, unsigned Count)
         Count = EntryCount - Start;
     }
 
-    /* Check each entry. Since we have validated the index above, we may
-    ** use the unchecked access function in the loop which is faster.
-    */
-    while (Count--) {
-        const CodeEntry* E = CollAtUnchecked (&S->Entries, Start++);
-        if (CE_HasLabel (E)) {
-            return 1;
-        }
+    /* Handle an empty range */
+    if (Count == 0) {
+        return 0;
     }
 
-    /* No label in the complete range */
-    return 0;
+    /* Compare the number of labeled entries before the first and the last
+    ** entry in the range. Since we have validated the index above, we may
+    ** use the unchecked access function which is faster.
+    */
+    CS_UpdateIndices (S, Start + Count - 1);
+    First = CollAtUnchecked (&S->Entries, Start);
+    Last  = CollAtUnchecked (&S->Entries, Start + Count - 1);
+    return (Last->PrevLabels != First->PrevLabels || CE_HasLabel (Last));
 }
 
 
@@ -805,6 +970,51 @@ CodeLabel* CS_AddLabel (CodeSeg* S, const char* Name)
 
 
 
+CodeLabel* CS_GetJumpLabel (CodeSeg* S, opc_t OPC, const char* Name)
+/* Return the label with the given name used as the target of the branch or
+** jump instruction OPC. If the label does not exist, it is a forward ref, so
+** it is created unless OPC is a jump to an external function. In this case,
+** NULL is returned. This may lead to unused labels (if the label is actually
+** an external one) which are removed by CS_MergeLabels later.
+*/
+{
+    /* Generate the hash over the label, then search for the label */
+    unsigned Hash = HashStr (Name) % CS_LABEL_HASH_SIZE;
+    CodeLabel* L = CS_FindLabel (S, Name, Hash);
+
+    /* If we don't have the label, create it if necessary */
+    if (L == 0 && (OPC != OP65_JMP || IsLocalLabelName (Name))) {
+        L = CS_NewCodeLabel (S, Name, Hash);
+    }
+
+    /* Return the label */
+    return L;
+}
+
+
+
+void CS_MarkIndirectLabel (CodeSeg* S, const char* Name)
+/* Mark the label with the given name as the target of an indirect jump, for
+** example from a jump table. The optimizer will neither delete nor merge such
+** a label, since its name is referenced from outside the code. If the label
+** does not exist, it is a forward ref and is created.
+*/
+{
+    /* Generate the hash over the label, then search for the label */
+    unsigned Hash = HashStr (Name) % CS_LABEL_HASH_SIZE;
+    CodeLabel* L = CS_FindLabel (S, Name, Hash);
+
+    /* If we don't have the label, create it */
+    if (L == 0) {
+        L = CS_NewCodeLabel (S, Name, Hash);
+    }
+
+    /* Mark it */
+    L->Flags |= CLF_INDIRECT;
+}
+
+
+
 CodeLabel* CS_GenLabel (CodeSeg* S, struct CodeEntry* E)
 /* If the code entry E does already have a label, return it. Otherwise
 ** create a new label, attach it to E and return it.
@@ -819,8 +1029,11 @@ CodeLabel* CS_GenLabel (CodeSeg* S, struct CodeEntry* E)
 
     } else {
 
-        /* Get a new name */
-        const char* Name = LocalLabelName (GetLocalLabel ());
+        /* Get a temporary name. The final name is assigned later by
+        ** CS_NameGenLabels.
+        */
+        char Name[32];
+        xsprintf (Name, sizeof (Name), GEN_LABEL_FORMAT, S->GenLabelCount++);
 
         /* Generate the hash over the name */
         unsigned Hash = HashStr (Name) % CS_LABEL_HASH_SIZE;
@@ -830,6 +1043,7 @@ CodeLabel* CS_GenLabel (CodeSeg* S, struct CodeEntry* E)
 
         /* Attach this label to the code entry */
         CE_AttachLabel (E, L);
+        CS_LabelsChanged (S, E);
 
     }
 
@@ -839,6 +1053,73 @@ CodeLabel* CS_GenLabel (CodeSeg* S, struct CodeEntry* E)
 
 
 
+static void CS_NameGenLabel (CodeSeg* S, CodeLabel* L, unsigned First)
+/* If L was created by CS_GenLabel, assign the final name. First is the
+** number of the first label reserved for the code segment.
+*/
+{
+    unsigned Num;
+    unsigned I;
+
+    /* Check if this is a label with a temporary name */
+    if (sscanf (L->Name, GEN_LABEL_FORMAT, &Num) != 1) {
+        return;
+    }
+
+    /* Rename the label. Since the hash changes, it must be reinserted into
+    ** the hash table.
+    */
+    CS_RemoveLabelFromHash (S, L);
+    xfree (L->Name);
+    L->Name = xstrdup (LocalLabelName (First + Num));
+    L->Hash = HashStr (L->Name) % CS_LABEL_HASH_SIZE;
+    L->Next = S->LabelHash[L->Hash];
+    S->LabelHash[L->Hash] = L;
+
+    /* Change the argument of all insns that jump here */
+    for (I = 0; I < CL_GetRefCount (L); ++I) {
+        CE_SetArg (CL_GetRef (L, I), L->Name);
+    }
+}
+
+
+
+void CS_NameGenLabels (CodeSeg* S)
+/* Labels created by CS_GenLabel have temporary names, so the optimizer may
+** run for several code segments at the same time. This function assigns the
+** final label names. To get a deterministic output, it must be called for
+** all code segments in the order in which they are output.
+*/
+{
+    unsigned First;
+    unsigned I, J;
+
+    /* If no labels were created, there's nothing to do */
+    if (S->GenLabelCount == 0) {
+        return;
+    }
+
+    /* Reserve one label number for each label ever created, so the numbers
+    ** are the same as if they had been assigned when creating the labels.
+    */
+    First = GetLocalLabels (S->GenLabelCount);
+
+    /* Rename all labels that are still in use. CS_GenLabel attaches new
+    ** labels to an entry, so there's no need to check the label pool.
+    */
+    for (I = 0; I < CS_GetEntryCount (S); ++I) {
+        CodeEntry* E = CS_GetEntry (S, I);
+        for (J = 0; J < CE_GetLabelCount (E); ++J) {
+            CS_NameGenLabel (S, CE_GetLabel (E, J), First);
+        }
+    }
+
+    /* All labels have their final names now */
+    S->GenLabelCount = 0;
+}
+
+
+
 void CS_DelLabel (CodeSeg* S, CodeLabel* L)
 /* Remove references from this label and delete it. */
 {
@@ -864,6 +1145,8 @@ void CS_DelLabel (CodeSeg* S, CodeLabel* L)
     */
     if (L->Owner) {
         CollDeleteItem (&L->Owner->Labels, L);
+        CE_InvalidateRegInfo (L->Owner);
+        CS_LabelsChanged (S, L->Owner);
     }
 
     /* All references removed, delete the label itself */
@@ -951,15 +1234,17 @@ void CS_MergeLabels (CodeSeg* S)
             /* Move all references from this label to the reference label */
             CL_MoveRefs (L, RefLab);
 
-            /* Remove the label completely. */
-            CS_DelLabel (S, L);
+            /* Remove the label completely, unless its name is used in data */
+            if (!CL_IsIndirect (L)) {
+                CS_DelLabel (S, L);
+            }
         }
 
-        /* The reference label is the only remaining label. Check if there
-        ** are any references to this label, and delete it if this is not
-        ** the case.
+        /* The reference label is the only remaining label (besides targets
+        ** of indirect jumps). Check if there are any references to this
+        ** label, and delete it if this is not the case.
         */
-        if (CollCount (&RefLab->JumpFrom) == 0) {
+        if (CollCount (&RefLab->JumpFrom) == 0 && !CL_IsIndirect (RefLab)) {
             /* Delete the label */
             CS_DelLabel (S, RefLab);
         }
@@ -991,14 +1276,24 @@ void CS_MoveLabels (CodeSeg* S, struct CodeEntry* Old, struct CodeEntry* New)
             /* Move references */
             CL_MoveRefs (OldLabel, NewLabel);
 
-            /* Delete the label */
-            CS_DelLabel (S, OldLabel);
+            /* Delete the label. Targets of indirect jumps are moved instead */
+            if (CL_IsIndirect (OldLabel)) {
+                CS_LabelsChanged (S, Old);
+                CS_LabelsChanged (S, New);
+                CE_MoveLabel (OldLabel, New);
+            } else {
+                CS_DelLabel (S, OldLabel);
+            }
 
         }
 
     } else {
 
         /* The new entry does not have a label, just move them */
+        if (OldLabelCount > 0) {
+            CS_LabelsChanged (S, Old);
+            CS_LabelsChanged (S, New);
+        }
         while (OldLabelCount--) {
 
             /* Move the label to the new entry */
@@ -1024,12 +1319,15 @@ void CS_RemoveLabelRef (CodeSeg* S, struct CodeEntry* E)
 
     /* Delete the entry from the label */
     CollDeleteItem (&L->JumpFrom, E);
+    if (L->Owner) {
+        CE_InvalidateRegInfo (L->Owner);
+    }
 
     /* The entry jumps no longer to L */
     CE_ClearJumpTo (E);
 
     /* If there are no more references, delete the label */
-    if (CollCount (&L->JumpFrom) == 0) {
+    if (CollCount (&L->JumpFrom) == 0 && !CL_IsIndirect (L)) {
         CS_DelLabel (S, L);
     }
 }
@@ -1128,7 +1426,7 @@ void CS_DelCodeRange (CodeSeg* S, unsigned First, unsigned Last)
         CHECK (!CE_HasLabel (E));
 
         /* Delete the pointer to the entry */
-        CollDelete (&S->Entries, I);
+        CS_RemoveEntry (S, I);
 
         /* Delete the entry itself */
         FreeCodeEntry (E);
@@ -1188,7 +1486,7 @@ void CS_DelCodeAfter (CodeSeg* S, unsigned Last)
         }
 
         /* Delete the pointer to the entry */
-        CollDelete (&S->Entries, C);
+        CS_RemoveEntry (S, C);
 
         /* Delete the entry itself */
         FreeCodeEntry (E);
@@ -1334,7 +1632,12 @@ void CS_OutputPrologue (const CodeSeg* S)
     if (Func) {
         /* Get the function descriptor */
         CS_PrintFunctionHeader (S);
-        WriteOutput (".segment\t\"%s\"\n\n.proc\t_%s", S->SegName, Func->Name);
+        if (FunctionSections) {
+            WriteOutput (".segment\t\"%s\", \"%s\"\n\n", S->SegName, Func->Name);
+        } else {
+            WriteOutput (".segment\t\"%s\"\n\n", S->SegName);
+        }
+        WriteOutput (".proc\t_%s", Func->Name);
         if (IsQualNear (Func->Type)) {
             WriteOutput (": near");
         } else if (IsQualFar (Func->Type)) {
@@ -1376,8 +1679,14 @@ void CS_Output (CodeSeg* S)
     /* Generate register info */
     CS_GenRegInfo (S);
 
-    /* Output the segment directive */
-    WriteOutput (".segment\t\"%s\"\n\n", S->SegName);
+    /* Output the segment directive. With --function-sections, the code of
+    ** each function goes into a sub-section named after the function.
+    */
+    if (FunctionSections && S->Func) {
+        WriteOutput (".segment\t\"%s\", \"%s\"\n\n", S->SegName, S->Func->Name);
+    } else {
+        WriteOutput (".segment\t\"%s\"\n\n", S->SegName);
+    }
 
     /* Output all entries, prepended by the line information if it has changed */
     LI = 0;
@@ -1437,251 +1746,1138 @@ void CS_Output (CodeSeg* S)
 
 
 
+static void CS_FreeDeadBlocks (CodeSeg* S)
+/* Free the blocks that are no longer in use */
+{
+    unsigned I;
+    for (I = 0; I < CollCount (&S->DeadBlocks); ++I) {
+        xfree (CollAtUnchecked (&S->DeadBlocks, I));
+    }
+    CollDeleteAll (&S->DeadBlocks);
+}
+
+
+
 void CS_FreeRegInfo (CodeSeg* S)
 /* Free register infos for all instructions */
 {
     unsigned I;
     for (I = 0; I < CS_GetEntryCount (S); ++I) {
-        CE_FreeRegInfo (CS_GetEntry(S, I));
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        CE_FreeRegInfo (E);
+
+        /* Free the blocks together with the register info */
+        if (E->Block && E->Block->First == E) {
+            CS_KillBlock (S, E->Block);
+        }
+        E->Block = 0;
     }
+    CS_FreeDeadBlocks (S);
+    CollDeleteAll (&S->ChangedBlocks);
+
+    /* Register info and liveness must be regenerated from scratch */
+    S->HaveBlocks = 0;
+    S->LiveSeen   = 0;
+    S->LiveValid  = 0;
 }
 
 
 
-void CS_GenRegInfo (CodeSeg* S)
-/* Generate register infos for all instructions */
+static const RegContents* GetJumpRegs (const CodeEntry* J, int FirstRun)
+/* Return the register contents at the target of the jump J */
 {
-    unsigned I;
-    RegContents Regs;           /* Initial register contents */
-    RegContents* CurrentRegs;   /* Current register contents */
-    int WasJump;                /* True if last insn was a jump */
-    int Done;                   /* All runs done flag */
+    return FirstRun? &J->RI->FirstOut2 : &J->RI->Out2;
+}
 
-    /* Be sure to delete all register infos */
-    CS_FreeRegInfo (S);
 
-    /* We may need two runs to get back references right */
-    do {
 
-        /* Assume we're done after this run */
-        Done = 1;
+static void MergeJumpRegs (RegContents* Regs, const RegContents* JRegs)
+/* Merge the register contents at a jump into the ones at its target */
+{
+    if (JRegs->RegA != Regs->RegA) {
+        Regs->RegA = UNKNOWN_REGVAL;
+    }
+    if (JRegs->RegX != Regs->RegX) {
+        Regs->RegX = UNKNOWN_REGVAL;
+    }
+    if (JRegs->RegY != Regs->RegY) {
+        Regs->RegY = UNKNOWN_REGVAL;
+    }
+    if (JRegs->SRegLo != Regs->SRegLo) {
+        Regs->SRegLo = UNKNOWN_REGVAL;
+    }
+    if (JRegs->SRegHi != Regs->SRegHi) {
+        Regs->SRegHi = UNKNOWN_REGVAL;
+    }
+    if (JRegs->Tmp1 != Regs->Tmp1) {
+        Regs->Tmp1 = UNKNOWN_REGVAL;
+    }
+}
+
 
-        /* On entry, the register contents are unknown */
-        RC_Invalidate (&Regs);
-        CurrentRegs = &Regs;
 
-        /* Walk over all insns and note just the changes from one insn to the
-        ** next one.
-        */
-        WasJump = 0;
-        for (I = 0; I < CS_GetEntryCount (S); ++I) {
+static int HasIndirectLabel (CodeEntry* E)
+/* Return true if one of the labels of E is the target of an indirect jump */
+{
+    unsigned I;
+    for (I = 0; I < CE_GetLabelCount (E); ++I) {
+        if (CL_IsIndirect (CE_GetLabel (E, I))) {
+            return 1;
+        }
+    }
+    return 0;
+}
 
-            CodeEntry* P;
 
-            /* Get the next instruction */
-            CodeEntry* E = CollAtUnchecked (&S->Entries, I);
 
-            /* If the instruction has a label, we need some special handling */
-            unsigned LabelCount = CE_GetLabelCount (E);
-            if (LabelCount > 0) {
+static void RefineBranchRegs (CodeEntry* E, const CodeEntry* P)
+/* If E is a branch on the zero flag, we may have more info on register
+** contents for one of both flow directions, depending on the preceeding
+** instruction P.
+*/
+{
+    bc_t BC;
 
-                /* Loop over all entry points that jump here. If these entry
-                ** points already have register info, check if all values are
-                ** known and identical. If all values are identical, and the
-                ** preceeding instruction was not an unconditional branch, check
-                ** if the register value on exit of the preceeding instruction
-                ** is also identical. If all these values are identical, the
-                ** value of a register is known, otherwise it is unknown.
-                */
-                CodeLabel* Label = CE_GetLabel (E, 0);
-                unsigned Entry;
-                if (WasJump) {
-                    /* Preceeding insn was an unconditional branch */
-                    CodeEntry* J = CL_GetRef(Label, 0);
-                    if (J->RI) {
-                        Regs = J->RI->Out2;
-                    } else {
-                        RC_Invalidate (&Regs);
-                    }
-                    Entry = 1;
+    /* Nothing to do if this is no branch on the zero flag */
+    if ((E->Info & OF_ZBRA) == 0) {
+        return;
+    }
+
+    /* Get the branch condition */
+    BC = GetBranchCond (E->OPC);
+
+    /* Check the previous instruction */
+    switch (P->OPC) {
+
+        case OP65_ADC:
+        case OP65_AND:
+        case OP65_DEA:
+        case OP65_EOR:
+        case OP65_INA:
+        case OP65_LDA:
+        case OP65_ORA:
+        case OP65_PLA:
+        case OP65_SBC:
+            /* A is zero in one execution flow direction */
+            if (BC == BC_EQ) {
+                E->RI->Out2.RegA = 0;
+            } else {
+                E->RI->Out.RegA = 0;
+            }
+            break;
+
+        case OP65_CMP:
+            /* If this is an immidiate compare, the A register has
+            ** the value of the compare later.
+            */
+            if (CE_IsConstImm (P)) {
+                if (BC == BC_EQ) {
+                    E->RI->Out2.RegA = (unsigned char)P->Num;
                 } else {
-                    Regs = *CurrentRegs;
-                    Entry = 0;
+                    E->RI->Out.RegA = (unsigned char)P->Num;
                 }
+            }
+            break;
 
-                while (Entry < CL_GetRefCount (Label)) {
-                    /* Get this entry */
-                    CodeEntry* J = CL_GetRef (Label, Entry);
-                    if (J->RI == 0) {
-                        /* No register info for this entry. This means that the
-                        ** instruction that jumps here is at higher addresses and
-                        ** the jump is a backward jump. We need a second run to
-                        ** get the register info right in this case. Until then,
-                        ** assume unknown register contents.
-                        */
-                        Done = 0;
-                        RC_Invalidate (&Regs);
-                        break;
-                    }
-                    if (J->RI->Out2.RegA != Regs.RegA) {
-                        Regs.RegA = UNKNOWN_REGVAL;
-                    }
-                    if (J->RI->Out2.RegX != Regs.RegX) {
-                        Regs.RegX = UNKNOWN_REGVAL;
-                    }
-                    if (J->RI->Out2.RegY != Regs.RegY) {
-                        Regs.RegY = UNKNOWN_REGVAL;
-                    }
-                    if (J->RI->Out2.SRegLo != Regs.SRegLo) {
-                        Regs.SRegLo = UNKNOWN_REGVAL;
-                    }
-                    if (J->RI->Out2.SRegHi != Regs.SRegHi) {
-                        Regs.SRegHi = UNKNOWN_REGVAL;
-                    }
-                    if (J->RI->Out2.Tmp1 != Regs.Tmp1) {
-                        Regs.Tmp1 = UNKNOWN_REGVAL;
-                    }
-                    ++Entry;
+        case OP65_CPX:
+            /* If this is an immidiate compare, the X register has
+            ** the value of the compare later.
+            */
+            if (CE_IsConstImm (P)) {
+                if (BC == BC_EQ) {
+                    E->RI->Out2.RegX = (unsigned char)P->Num;
+                } else {
+                    E->RI->Out.RegX = (unsigned char)P->Num;
                 }
-
-                /* Use this register info */
-                CurrentRegs = &Regs;
-
             }
+            break;
 
-            /* Generate register info for this instruction */
-            CE_GenRegInfo (E, CurrentRegs);
+        case OP65_CPY:
+            /* If this is an immidiate compare, the Y register has
+            ** the value of the compare later.
+            */
+            if (CE_IsConstImm (P)) {
+                if (BC == BC_EQ) {
+                    E->RI->Out2.RegY = (unsigned char)P->Num;
+                } else {
+                    E->RI->Out.RegY = (unsigned char)P->Num;
+                }
+            }
+            break;
 
-            /* Remember for the next insn if this insn was an uncondition branch */
-            WasJump = (E->Info & OF_UBRA) != 0;
+        case OP65_DEX:
+        case OP65_INX:
+        case OP65_LDX:
+        case OP65_PLX:
+            /* X is zero in one execution flow direction */
+            if (BC == BC_EQ) {
+                E->RI->Out2.RegX = 0;
+            } else {
+                E->RI->Out.RegX = 0;
+            }
+            break;
 
-            /* Output registers for this insn are input for the next */
-            CurrentRegs = &E->RI->Out;
+        case OP65_DEY:
+        case OP65_INY:
+        case OP65_LDY:
+        case OP65_PLY:
+            /* X is zero in one execution flow direction */
+            if (BC == BC_EQ) {
+                E->RI->Out2.RegY = 0;
+            } else {
+                E->RI->Out.RegY = 0;
+            }
+            break;
 
-            /* If this insn is a branch on zero flag, we may have more info on
-            ** register contents for one of both flow directions, but only if
-            ** we've gone through a previous instruction.
+        case OP65_TAX:
+        case OP65_TXA:
+            /* If the branch is a beq, both A and X are zero at the
+            ** branch target, otherwise they are zero at the next
+            ** insn.
             */
-            if (LabelCount == 0 && (E->Info & OF_ZBRA) != 0 && (P = CS_GetPrevEntry (S, I)) != 0) {
-
-                /* Get the branch condition */
-                bc_t BC = GetBranchCond (E->OPC);
-
-                /* Check the previous instruction */
-                switch (P->OPC) {
-
-                    case OP65_ADC:
-                    case OP65_AND:
-                    case OP65_DEA:
-                    case OP65_EOR:
-                    case OP65_INA:
-                    case OP65_LDA:
-                    case OP65_ORA:
-                    case OP65_PLA:
-                    case OP65_SBC:
-                        /* A is zero in one execution flow direction */
-                        if (BC == BC_EQ) {
-                            E->RI->Out2.RegA = 0;
-                        } else {
-                            E->RI->Out.RegA = 0;
-                        }
-                        break;
+            if (BC == BC_EQ) {
+                E->RI->Out2.RegA = E->RI->Out2.RegX = 0;
+            } else {
+                E->RI->Out.RegA = E->RI->Out.RegX = 0;
+            }
+            break;
 
-                    case OP65_CMP:
-                        /* If this is an immidiate compare, the A register has
-                        ** the value of the compare later.
-                        */
-                        if (CE_IsConstImm (P)) {
-                            if (BC == BC_EQ) {
-                                E->RI->Out2.RegA = (unsigned char)P->Num;
-                            } else {
-                                E->RI->Out.RegA = (unsigned char)P->Num;
-                            }
-                        }
-                        break;
+        case OP65_TAY:
+        case OP65_TYA:
+            /* If the branch is a beq, both A and Y are zero at the
+            ** branch target, otherwise they are zero at the next
+            ** insn.
+            */
+            if (BC == BC_EQ) {
+                E->RI->Out2.RegA = E->RI->Out2.RegY = 0;
+            } else {
+                E->RI->Out.RegA = E->RI->Out.RegY = 0;
+            }
+            break;
 
-                    case OP65_CPX:
-                        /* If this is an immidiate compare, the X register has
-                        ** the value of the compare later.
-                        */
-                        if (CE_IsConstImm (P)) {
-                            if (BC == BC_EQ) {
-                                E->RI->Out2.RegX = (unsigned char)P->Num;
-                            } else {
-                                E->RI->Out.RegX = (unsigned char)P->Num;
-                            }
-                        }
-                        break;
+        default:
+            break;
 
-                    case OP65_CPY:
-                        /* If this is an immidiate compare, the Y register has
-                        ** the value of the compare later.
-                        */
-                        if (CE_IsConstImm (P)) {
-                            if (BC == BC_EQ) {
-                                E->RI->Out2.RegY = (unsigned char)P->Num;
-                            } else {
-                                E->RI->Out.RegY = (unsigned char)P->Num;
-                            }
-                        }
-                        break;
+    }
+}
 
-                    case OP65_DEX:
-                    case OP65_INX:
-                    case OP65_LDX:
-                    case OP65_PLX:
-                        /* X is zero in one execution flow direction */
-                        if (BC == BC_EQ) {
-                            E->RI->Out2.RegX = 0;
-                        } else {
-                            E->RI->Out.RegX = 0;
-                        }
-                        break;
 
-                    case OP65_DEY:
-                    case OP65_INY:
-                    case OP65_LDY:
-                    case OP65_PLY:
-                        /* X is zero in one execution flow direction */
-                        if (BC == BC_EQ) {
-                            E->RI->Out2.RegY = 0;
-                        } else {
-                            E->RI->Out.RegY = 0;
-                        }
-                        break;
 
-                    case OP65_TAX:
-                    case OP65_TXA:
-                        /* If the branch is a beq, both A and X are zero at the
-                        ** branch target, otherwise they are zero at the next
-                        ** insn.
-                        */
-                        if (BC == BC_EQ) {
-                            E->RI->Out2.RegA = E->RI->Out2.RegX = 0;
-                        } else {
-                            E->RI->Out.RegA = E->RI->Out.RegX = 0;
-                        }
-                        break;
+static int CS_GenRegInfoRun (CodeSeg* S, int FirstRun)
+/* Do one run over all code entries and generate register info for them.
+** The function returns false if a label with references from entries
+** without register info was found, so a second run is needed to get back
+** references right.
+*/
+{
+    unsigned I;
+    RegContents Regs;           /* Initial register contents */
+    RegContents* CurrentRegs;   /* Current register contents */
+    int WasJump;                /* True if last insn was a jump */
+    int Done;                   /* All runs done flag */
 
-                    case OP65_TAY:
-                    case OP65_TYA:
-                        /* If the branch is a beq, both A and Y are zero at the
-                        ** branch target, otherwise they are zero at the next
-                        ** insn.
-                        */
-                        if (BC == BC_EQ) {
-                            E->RI->Out2.RegA = E->RI->Out2.RegY = 0;
-                        } else {
-                            E->RI->Out.RegA = E->RI->Out.RegY = 0;
-                        }
-                        break;
+    /* Assume we're done after this run */
+    Done = 1;
 
-                    default:
-                        break;
+    /* On entry, the register contents are unknown */
+    RC_Invalidate (&Regs);
+    CurrentRegs = &Regs;
+    WasJump = 0;
+
+    /* Walk over all insns and note just the changes from one insn to the
+    ** next one.
+    */
+    for (I = 0; I < CS_GetEntryCount (S); ++I) {
+
+        CodeEntry* P;
+
+        /* Get the next instruction */
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+
+        /* If the instruction has a label, we need some special handling */
+        unsigned LabelCount = CE_GetLabelCount (E);
+        if (LabelCount > 0) {
+
+            /* Loop over all entry points that jump here. If these entry
+            ** points already have register info, check if all values are
+            ** known and identical. If all values are identical, and the
+            ** preceeding instruction was not an unconditional branch, check
+            ** if the register value on exit of the preceeding instruction
+            ** is also identical. If all these values are identical, the
+            ** value of a register is known, otherwise it is unknown.
+            */
+            CodeLabel* Label = CE_GetLabel (E, 0);
+            unsigned Entry;
+            if (HasIndirectLabel (E)) {
+                /* Target of an indirect jump, entry points are unknown */
+                RC_Invalidate (&Regs);
+                Entry = CL_GetRefCount (Label);
+            } else if (WasJump) {
+                /* Preceeding insn was an unconditional branch */
+                CodeEntry* J = CL_GetRef(Label, 0);
+                if (J->RI) {
+                    Regs = *GetJumpRegs (J, FirstRun);
+                } else {
+                    RC_Invalidate (&Regs);
+                }
+                Entry = 1;
+            } else {
+                Regs = *CurrentRegs;
+                Entry = 0;
+            }
+
+            while (Entry < CL_GetRefCount (Label)) {
+                /* Get this entry */
+                CodeEntry* J = CL_GetRef (Label, Entry);
+                if (J->RI == 0) {
+                    /* No register info for this entry. This means that the
+                    ** instruction that jumps here is at higher addresses and
+                    ** the jump is a backward jump. We need a second run to
+                    ** get the register info right in this case. Until then,
+                    ** assume unknown register contents.
+                    */
+                    Done = 0;
+                    RC_Invalidate (&Regs);
+                    break;
+                }
+                MergeJumpRegs (&Regs, GetJumpRegs (J, FirstRun));
+                ++Entry;
+            }
+
+            /* Use this register info */
+            CurrentRegs = &Regs;
+
+        }
+
+        /* Generate register info for this instruction */
+        CE_GenRegInfo (E, CurrentRegs);
+
+        /* Remember for the next insn if this insn was an uncondition branch */
+        WasJump = (E->Info & OF_UBRA) != 0;
+
+        /* Output registers for this insn are input for the next */
+        CurrentRegs = FirstRun? &E->RI->FirstOut : &E->RI->Out;
+
+        /* Check for branches on the zero flag, but only if we've gone
+        ** through a previous instruction.
+        */
+        if (LabelCount == 0 && (P = CS_GetPrevEntry (S, I)) != 0) {
+            RefineBranchRegs (E, P);
+        }
+
+        /* Remember the result of the first run */
+        if (FirstRun) {
+            E->RI->FirstOut  = E->RI->Out;
+            E->RI->FirstOut2 = E->RI->Out2;
+        }
+    }
+
+    /* Return the result */
+    return Done;
+}
+
+
+
+static void CS_GenAllRegInfo (CodeSeg* S)
+/* Generate the register info for all entries from scratch */
+{
+    unsigned I;
+
+    /* Be sure to delete all register infos */
+    for (I = 0; I < CS_GetEntryCount (S); ++I) {
+        CE_FreeRegInfo (CollAtUnchecked (&S->Entries, I));
+    }
+
+    /* We may need two runs to get back references right */
+    if (!CS_GenRegInfoRun (S, 1)) {
+        CS_GenRegInfoRun (S, 0);
+    }
+}
+
+
+
+static int CS_IsBlockStart (CodeSeg* S, unsigned Index)
+/* Return true if the entry with the given index starts a block */
+{
+    return Index == 0 || CE_HasLabel (CollAtUnchecked (&S->Entries, Index));
+}
+
+
+
+static int CS_HasBackRef (CodeSeg* S, unsigned Index)
+/* Return true if the block starting at Index is the target of a jump from
+** itself or a later block that is considered by CS_GenRegInfoRun. If this
+** is true for any block, the register info needs a second run.
+*/
+{
+    unsigned   I;
+    CodeLabel* L;
+    CodeEntry* E = CollAtUnchecked (&S->Entries, Index);
+    CodeEntry* P = CS_GetPrevEntry (S, Index);
+
+    if (!CE_HasLabel (E) || HasIndirectLabel (E)) {
+        return 0;
+    }
+
+    /* Only the first label counts, and the first reference doesn't if the
+    ** preceeding insn is an unconditional branch.
+    */
+    L = CE_GetLabel (E, 0);
+    for (I = (P && (P->Info & OF_UBRA) != 0); I < CL_GetRefCount (L); ++I) {
+        if (CS_GetEntryIndex (S, CL_GetRef (L, I)) >= Index) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+static void CS_SetBackRef (CodeSeg* S, CodeBlock* B, unsigned Index)
+/* Update the back reference flag of the block B starting at Index */
+{
+    if (CS_HasBackRef (S, Index)) {
+        if ((B->Flags & CBF_BACKREF) == 0) {
+            B->Flags |= CBF_BACKREF;
+            ++S->BackRefBlocks;
+        }
+    } else if (B->Flags & CBF_BACKREF) {
+        B->Flags &= ~CBF_BACKREF;
+        --S->BackRefBlocks;
+    }
+}
+
+
+
+static void CS_BuildBlocks (CodeSeg* S)
+/* Split the code into blocks */
+{
+    unsigned   I;
+    CodeBlock* B = 0;
+
+    for (I = 0; I < CS_GetEntryCount (S); ++I) {
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        if (CS_IsBlockStart (S, I)) {
+            B = CS_NewBlock (S, E);
+            CS_SetBackRef (S, B, I);
+        } else {
+            E->Block = B;
+        }
+    }
+    S->HaveBlocks = 1;
+}
+
+
+
+static void CS_QueueBlock (CodeSeg* S, Collection* Work, CodeBlock* B, unsigned Flag)
+/* Add the block B to Work, which is a heap with the block with the lowest
+** index on top. Flag marks the blocks in Work.
+*/
+{
+    unsigned I;
+
+    /* Don't add the block twice */
+    if (B->Flags & Flag) {
+        return;
+    }
+    B->Flags |= Flag;
+    B->Index = CS_GetEntryIndex (S, B->First);
+
+    /* Move it up to its place in the heap */
+    I = CollCount (Work);
+    CollAppend (Work, B);
+    while (I > 0) {
+        CodeBlock* P = CollAtUnchecked (Work, (I - 1) / 2);
+        if (P->Index <= B->Index) {
+            break;
+        }
+        CollReplace (Work, P, I);
+        I = (I - 1) / 2;
+    }
+    CollReplace (Work, B, I);
+}
+
+
+
+static CodeBlock* PopBlock (Collection* Work, unsigned Flag)
+/* Remove the block with the lowest index from the heap Work and return it */
+{
+    unsigned   I     = 0;
+    CodeBlock* B     = CollAtUnchecked (Work, 0);
+    CodeBlock* Last  = CollPop (Work);
+    unsigned   Count = CollCount (Work);
+
+    /* Move the last block down from the top to its place in the heap */
+    if (Count > 0) {
+        while (2 * I + 1 < Count) {
+            unsigned   Child = 2 * I + 1;
+            CodeBlock* C     = CollAtUnchecked (Work, Child);
+            if (Child + 1 < Count &&
+                ((CodeBlock*) CollAtUnchecked (Work, Child + 1))->Index < C->Index) {
+                C = CollAtUnchecked (Work, ++Child);
+            }
+            if (Last->Index <= C->Index) {
+                break;
+            }
+            CollReplace (Work, C, I);
+            I = Child;
+        }
+        CollReplace (Work, Last, I);
+    }
+
+    /* Return the block */
+    B->Flags &= ~Flag;
+    return B;
+}
+
+
+
+static void CS_QueueSuccessors (CodeSeg* S, unsigned First, unsigned Last,
+                                Collection* Work, unsigned Flag,
+                                Collection* BackWork)
+/* Queue the blocks reached from the entries First to Last-1. The following
+** block and the targets of forward jumps are added to Work, the targets of
+** backward jumps are added to BackWork if it isn't NULL.
+*/
+{
+    unsigned I;
+
+    if (Last < CS_GetEntryCount (S)) {
+        CodeEntry* N = CollAtUnchecked (&S->Entries, Last);
+        CS_QueueBlock (S, Work, N->Block, Flag);
+    }
+
+    for (I = First; I < Last; ++I) {
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        CodeEntry* T;
+        if (E->JumpTo == 0 || (T = E->JumpTo->Owner) == 0 || T->Block == 0) {
+            continue;
+        }
+
+        /* The target may have got its labels after the last update */
+        if (T->Block->First != T) {
+            CS_NewBlock (S, T);
+        }
+        if (CS_GetEntryIndex (S, T) > I) {
+            CS_QueueBlock (S, Work, T->Block, Flag);
+        } else if (BackWork) {
+            CS_QueueBlock (S, BackWork, T->Block, CBF_QUEUED2);
+        }
+    }
+}
+
+
+
+static CodeBlock* CS_UpdateBlock (CodeSeg* S, CodeBlock* B, Collection* Work,
+                                  unsigned* First, unsigned* Last)
+/* Correct the boundaries of the block B after changes of the code. Since
+** B->First may be an entry inside of a block, the result may be another
+** block, which is returned together with the range of its entries. If an
+** entry behind the block got labels, a new block is created for it and
+** added to Work.
+*/
+{
+    CodeBlock* R;
+    CodeEntry* E;
+    unsigned   Count = CS_GetEntryCount (S);
+    unsigned   I     = CS_GetEntryIndex (S, B->First);
+
+    /* Search for the start of the block */
+    while (!CS_IsBlockStart (S, I)) {
+        --I;
+    }
+    *First = I;
+
+    /* Use the block of the first entry if it has a valid one */
+    E = CollAtUnchecked (&S->Entries, I);
+    if (E->Block && E->Block->First == E) {
+        R = E->Block;
+    } else {
+        R = B;
+        R->First = E;
+        E->Block = R;
+    }
+    if (R != B) {
+        CS_KillBlock (S, B);
+    }
+
+    /* All entries up to the next block start belong to the block */
+    while (++I < Count && !CS_IsBlockStart (S, I)) {
+        E = CollAtUnchecked (&S->Entries, I);
+        if (E->Block != R) {
+            if (E->Block && E->Block->First == E) {
+                CS_KillBlock (S, E->Block);
+            }
+            E->Block = R;
+        }
+    }
+    *Last = I;
+
+    /* Make sure the next block exists */
+    if (I < Count) {
+        E = CollAtUnchecked (&S->Entries, I);
+        if (E->Block == 0 || E->Block->First != E) {
+            CS_QueueBlock (S, Work, CS_NewBlock (S, E), CBF_QUEUED);
+        }
+    }
+
+    /* Return the block */
+    return R;
+}
+
+
+
+static const RegContents* CS_GetJumpRegs (CodeSeg* S, CodeEntry* J,
+                                          unsigned Index, int FirstRun)
+/* Return the register contents at the target of the jump J, which has the
+** given index, the same way CS_GenRegInfoRun sees them. The first run
+** doesn't know them for jumps from behind the target and returns NULL, the
+** second one uses the results of the first run for these jumps.
+*/
+{
+    if (CS_GetEntryIndex (S, J) < Index) {
+        return GetJumpRegs (J, FirstRun);
+    } else if (FirstRun) {
+        return 0;
+    } else {
+        return GetJumpRegs (J, 1);
+    }
+}
+
+
+
+static void CS_GetBlockRegs (CodeSeg* S, unsigned Index, int FirstRun, RegContents* Regs)
+/* Determine the register contents on entry of the block starting at Index
+** for the given run.
+*/
+{
+    const RegContents* JRegs;
+    CodeLabel*         Label;
+    unsigned           Entry;
+    CodeEntry*         E = CollAtUnchecked (&S->Entries, Index);
+    CodeEntry*         P = CS_GetPrevEntry (S, Index);
+
+    /* Start with the register contents of the preceeding entry */
+    if (P) {
+        *Regs = FirstRun? P->RI->FirstOut : P->RI->Out;
+    } else {
+        RC_Invalidate (Regs);
+    }
+
+    /* If the entry has labels, merge the registers of all jumps to it */
+    if (!CE_HasLabel (E)) {
+        return;
+    }
+    Label = CE_GetLabel (E, 0);
+    if (HasIndirectLabel (E)) {
+        RC_Invalidate (Regs);
+        return;
+    }
+    Entry = 0;
+    if (P && (P->Info & OF_UBRA) != 0) {
+        JRegs = CS_GetJumpRegs (S, CL_GetRef (Label, 0), Index, FirstRun);
+        if (JRegs) {
+            *Regs = *JRegs;
+        } else {
+            RC_Invalidate (Regs);
+        }
+        Entry = 1;
+    }
+    while (Entry < CL_GetRefCount (Label)) {
+        JRegs = CS_GetJumpRegs (S, CL_GetRef (Label, Entry), Index, FirstRun);
+        if (JRegs == 0) {
+            RC_Invalidate (Regs);
+            break;
+        }
+        MergeJumpRegs (Regs, JRegs);
+        ++Entry;
+    }
+}
+
+
+
+static int CS_GenBlockRegInfo (CodeSeg* S, unsigned First, unsigned Last,
+                               int FirstRun, int KeepOut)
+/* Generate the register info of the block with the entries First to Last-1
+** for the given run. If KeepOut is true, the first run doesn't overwrite
+** the results of the second one. Return true if the register contents at
+** the exits of the block have changed.
+*/
+{
+    unsigned     I;
+    RegContents  Regs;
+    RegContents* CurrentRegs = &Regs;
+    int          Changed = 0;
+
+    /* Get the register contents on entry */
+    CS_GetBlockRegs (S, First, FirstRun, &Regs);
+
+    for (I = First; I < Last; ++I) {
+
+        RegInfo    Old;
+        CodeEntry* E   = CollAtUnchecked (&S->Entries, I);
+        int        New = (E->RI == 0);
+        if (!New) {
+            Old = *E->RI;
+        }
+
+        /* Generate register info for this instruction */
+        CE_GenRegInfo (E, CurrentRegs);
+        if (I > First) {
+            RefineBranchRegs (E, CollAtUnchecked (&S->Entries, I - 1));
+        }
+
+        /* Remember the result of the first run */
+        if (FirstRun) {
+            E->RI->FirstOut  = E->RI->Out;
+            E->RI->FirstOut2 = E->RI->Out2;
+            if (KeepOut && !New) {
+                E->RI->In   = Old.In;
+                E->RI->Out  = Old.Out;
+                E->RI->Out2 = Old.Out2;
+            }
+            CurrentRegs = &E->RI->FirstOut;
+        } else {
+            CurrentRegs = &E->RI->Out;
+        }
+
+        /* Check the exits of the block */
+        if (!Changed && (E->JumpTo || I + 1 == Last)) {
+            if (New) {
+                Changed = 1;
+            } else if (FirstRun) {
+                Changed = !RC_Equal (&E->RI->FirstOut, &Old.FirstOut) ||
+                          !RC_Equal (&E->RI->FirstOut2, &Old.FirstOut2);
+            } else {
+                Changed = !RC_Equal (&E->RI->Out, &Old.Out) ||
+                          !RC_Equal (&E->RI->Out2, &Old.Out2);
+            }
+        }
+    }
+
+    /* Return the result */
+    return Changed;
+}
+
+
+
+static unsigned CS_GetLiveUse (const CodeSeg* S, const CodeEntry* E)
+/* Return the registers in CS_LIVE_REGS used by E, including those used by
+** the caller if E leaves the function.
+*/
+{
+    if (E->OPC == OP65_RTS ||
+        ((E->Info & OF_UBRA) != 0 && E->JumpTo == 0)) {
+        return (E->Use | S->ExitRegs) & CS_LIVE_REGS;
+    }
+    return E->Use & CS_LIVE_REGS;
+}
+
+
+
+static unsigned CS_GetLiveIn (CodeSeg* S, const CodeEntry* E, unsigned Next)
+/* Compute the registers live before E from the current liveness of the
+** entries following it. Next is the index of the entry following E.
+*/
+{
+    unsigned Out;
+
+    /* Determine the registers live after the instruction */
+    if ((E->Info & OF_RET) != 0) {
+        Out = REG_NONE;
+    } else if ((E->Info & OF_UBRA) != 0) {
+        Out = (E->JumpTo && E->JumpTo->Owner)? E->JumpTo->Owner->Live : REG_NONE;
+    } else {
+        const CodeEntry* N = CS_GetEntry (S, Next);
+        Out = N? N->Live : REG_NONE;
+        if ((E->Info & OF_CBRA) != 0) {
+            /* A jump to an external label will leave the function */
+            Out |= E->JumpTo? E->JumpTo->Owner->Live : S->ExitRegs;
+        }
+    }
+
+    /* Registers are live if they're used, or if they're live afterwards and
+    ** not changed by the instruction.
+    */
+    return CS_GetLiveUse (S, E) | (Out & ~E->Chg & CS_LIVE_REGS);
+}
+
+
+
+static void CS_CalcLiveInfo (CodeSeg* S)
+/* Compute the register liveness for all entries of the code segment. This is
+** the usual backwards data flow problem, iterated until nothing changes. The
+** result is the same as that of GetRegInfo called for a single register.
+*/
+{
+    unsigned Count = CS_GetEntryCount (S);
+    unsigned I;
+    int      Changed;
+
+    /* Start with nothing live and compute in reverse order, so most of the
+    ** information flows in one pass. Only loops need more passes.
+    */
+    for (I = 0; I < Count; ++I) {
+        CS_GetEntry (S, I)->Live = REG_NONE;
+    }
+    do {
+        Changed = 0;
+        I = Count;
+        while (I-- > 0) {
+            CodeEntry* E = CS_GetEntry (S, I);
+            unsigned Live = CS_GetLiveIn (S, E, I + 1);
+            if (Live != E->Live) {
+                E->Live = (unsigned short) Live;
+                Changed = 1;
+            }
+        }
+    } while (Changed);
+}
+
+
+
+static void CS_QueueLive (Collection* Work, CodeEntry* E)
+/* Add E to the entries in Work unless it is already there */
+{
+    if ((E->Flags & CEF_LIVEQUEUED) == 0) {
+        E->Flags |= CEF_LIVEQUEUED;
+        CollAppend (Work, E);
+    }
+}
 
+
+
+static void CS_GetLivePreds (CodeSeg* S, CodeEntry* E, Collection* Preds)
+/* Add the entries that may continue with E to Preds. These are the one
+** before E and the ones jumping to the labels of E.
+*/
+{
+    unsigned I, J;
+    unsigned Index = CS_GetEntryIndex (S, E);
+
+    if (Index > 0) {
+        CollAppend (Preds, CollAtUnchecked (&S->Entries, Index - 1));
+    }
+    for (I = 0; I < CE_GetLabelCount (E); ++I) {
+        CodeLabel* L = CE_GetLabel (E, I);
+        for (J = 0; J < CL_GetRefCount (L); ++J) {
+            CollAppend (Preds, CL_GetRef (L, J));
+        }
+    }
+}
+
+
+
+static void CS_UpdateLiveInfo (CodeSeg* S)
+/* Update the register liveness after changes to the code. The changed
+** entries are the first ones of the blocks added to the list of changed
+** blocks since the last update. Their liveness is computed again, and so is
+** the liveness of the entries before them as far as it may have depended
+** on the old one. If the liveness isn't valid, only forget about the
+** changed blocks.
+*/
+{
+    unsigned        I, J, K;
+    unsigned        Count;
+    unsigned        Reg;
+    unsigned        Regs;
+    unsigned short* Old;
+    Collection      Work  = AUTO_COLLECTION_INITIALIZER;
+    Collection      Preds = AUTO_COLLECTION_INITIALIZER;
+
+    /* Collect the changed entries. Since their labels may be new, the
+    ** entries jumping to them have changed as well.
+    */
+    for (I = S->LiveSeen; I < CollCount (&S->ChangedBlocks); ++I) {
+        CodeBlock* B = CollAtUnchecked (&S->ChangedBlocks, I);
+        B->Flags &= ~CBF_LIVECHANGED;
+        if (S->LiveValid && B->First) {
+            CodeEntry* E = B->First;
+            CS_QueueLive (&Work, E);
+            for (J = 0; J < CE_GetLabelCount (E); ++J) {
+                CodeLabel* L = CE_GetLabel (E, J);
+                for (K = 0; K < CL_GetRefCount (L); ++K) {
+                    CS_QueueLive (&Work, CL_GetRef (L, K));
                 }
             }
         }
-    } while (!Done);
+    }
+    S->LiveSeen = CollCount (&S->ChangedBlocks);
+
+    /* Done if nothing has changed */
+    Count = CollCount (&Work);
+    if (Count == 0) {
+        return;
+    }
+
+    /* Remember the old liveness of the changed entries and forget it. The
+    ** registers used by an entry are live before it in any case.
+    */
+    Old = xmalloc (Count * sizeof (Old[0]));
+    Regs = REG_NONE;
+    for (I = 0; I < Count; ++I) {
+        CodeEntry* E = CollAtUnchecked (&Work, I);
+        unsigned   Use = CS_GetLiveUse (S, E);
+        Old[I] = E->Live & ~Use;
+        Regs |= Old[I];
+        E->Live = (unsigned short) Use;
+    }
 
+    /* A register that was live before a changed entry may be live before
+    ** the entries continuing with it only because of that. Remove it there,
+    ** unless the entry uses it itself, and continue with the entries before
+    ** until it is used or wasn't live. The entries are computed again later,
+    ** so this may remove too much but not too little. Each register is
+    ** handled on its own, so Preds is a simple stack of entries.
+    */
+    for (Reg = REG_A; Reg <= Regs; Reg <<= 1) {
+        if ((Reg & Regs) == 0) {
+            continue;
+        }
+        for (I = 0; I < Count; ++I) {
+            if (Old[I] & Reg) {
+                CS_GetLivePreds (S, CollAtUnchecked (&Work, I), &Preds);
+            }
+        }
+        while (CollCount (&Preds) > 0) {
+            CodeEntry* E = CollPop (&Preds);
+            if ((E->Live & Reg) != 0 && (CS_GetLiveUse (S, E) & Reg) == 0) {
+                E->Live &= ~Reg;
+                CS_QueueLive (&Work, E);
+                CS_GetLivePreds (S, E, &Preds);
+            }
+        }
+    }
+    xfree (Old);
+
+    /* Compute the liveness of the entries again. If it changes, the entries
+    ** before have to be computed again as well. Since the liveness only
+    ** grows from here, this ends with the same result as CS_CalcLiveInfo.
+    */
+    while (CollCount (&Work) > 0) {
+        CodeEntry* E = CollPop (&Work);
+        unsigned   Live = CS_GetLiveIn (S, E, CS_GetEntryIndex (S, E) + 1);
+        E->Flags &= ~CEF_LIVEQUEUED;
+        if (Live != E->Live) {
+            E->Live = (unsigned short) Live;
+            CS_GetLivePreds (S, E, &Preds);
+            while (CollCount (&Preds) > 0) {
+                CS_QueueLive (&Work, CollPop (&Preds));
+            }
+        }
+    }
+
+    /* Cleanup */
+    DoneCollection (&Work);
+    DoneCollection (&Preds);
+}
+
+
+
+static void CS_UpdateRegInfo (CodeSeg* S)
+/* Regenerate the register info of the changed blocks and of the blocks
+** reached from them until the register contents don't change any longer.
+** Both runs of CS_GenRegInfoRun are done for each block, so the result is
+** the same as the one of CS_GenAllRegInfo.
+*/
+{
+    unsigned   I;
+    Collection Work  = AUTO_COLLECTION_INITIALIZER;
+    Collection Work2 = AUTO_COLLECTION_INITIALIZER;
+    int        NeedSecondRun = (S->BackRefBlocks > 0);
+
+    /* The list of changed blocks is also used for the liveness, so update
+    ** it before the list is cleared.
+    */
+    CS_UpdateLiveInfo (S);
+
+    /* Queue the changed blocks that are still in use */
+    for (I = 0; I < CollCount (&S->ChangedBlocks); ++I) {
+        CodeBlock* B = CollAtUnchecked (&S->ChangedBlocks, I);
+        if (B->First) {
+            CS_QueueBlock (S, &Work, B, CBF_QUEUED);
+        }
+    }
+    CollDeleteAll (&S->ChangedBlocks);
+    S->LiveSeen = 0;
+
+    /* First run. A block is only influenced by blocks with lower indices,
+    ** so each block is usually handled once. The blocks handled are queued
+    ** for the second run.
+    */
+    while (CollCount (&Work) > 0) {
+
+        unsigned   First, Last;
+        int        Changed;
+        CodeBlock* R;
+
+        CodeBlock* B = PopBlock (&Work, CBF_QUEUED);
+        if (B->First == 0) {
+            /* Block is no longer in use */
+            continue;
+        }
+
+        /* Fix the block boundaries */
+        R = CS_UpdateBlock (S, B, &Work, &First, &Last);
+        Changed = (B->Flags & CBF_CHANGED) != 0 || R != B;
+        B->Flags &= ~CBF_CHANGED;
+        CS_SetBackRef (S, R, First);
+
+        /* Regenerate the register info and queue the following blocks */
+        if (CS_GenBlockRegInfo (S, First, Last, 1, NeedSecondRun)) {
+            Changed = 1;
+        }
+        if (Changed) {
+            CS_QueueSuccessors (S, First, Last, &Work, CBF_QUEUED,
+                                NeedSecondRun? &Work2 : 0);
+        }
+        if (NeedSecondRun) {
+            CS_QueueBlock (S, &Work2, R, CBF_QUEUED2);
+        }
+    }
+
+    if ((S->BackRefBlocks > 0) != NeedSecondRun) {
+
+        /* The changes made a second run necessary or superfluous */
+        while (CollCount (&Work2) > 0) {
+            PopBlock (&Work2, CBF_QUEUED2);
+        }
+        CS_GenAllRegInfo (S);
+
+    } else {
+
+        /* Second run */
+        while (CollCount (&Work2) > 0) {
+
+            unsigned First, Last;
+
+            CodeBlock* B = PopBlock (&Work2, CBF_QUEUED2);
+            if (B->First == 0) {
+                continue;
+            }
+
+            First = CS_GetEntryIndex (S, B->First);
+            Last  = First + 1;
+            while (Last < CS_GetEntryCount (S) && !CS_IsBlockStart (S, Last)) {
+                ++Last;
+            }
+            if (CS_GenBlockRegInfo (S, First, Last, 0, 0)) {
+                CS_QueueSuccessors (S, First, Last, &Work2, CBF_QUEUED2, 0);
+            }
+        }
+    }
+
+    /* Cleanup */
+    DoneCollection (&Work);
+    DoneCollection (&Work2);
+    CS_FreeDeadBlocks (S);
+}
+
+
+
+static void CS_CheckRegInfo (CodeSeg* S)
+/* Compare the register info and the blocks of all entries against a
+** complete regeneration and bail out if there are differences.
+*/
+{
+    unsigned    I;
+    RegInfo*    Saved;
+    unsigned    BackRefs = 0;
+    CodeBlock*  B = 0;
+    unsigned    Count = CS_GetEntryCount (S);
+    const char* Name = S->Func? S->Func->Name : "<global>";
+
+    /* Check the blocks */
+    for (I = 0; I < Count; ++I) {
+        CodeEntry* E = CollAtUnchecked (&S->Entries, I);
+        if (CS_IsBlockStart (S, I)) {
+            B = E->Block;
+            if (B == 0 || B->First != E ||
+                ((B->Flags & CBF_BACKREF) != 0) != CS_HasBackRef (S, I)) {
+                Internal ("Block mismatch for entry %u in function '%s'", I, Name);
+            }
+            BackRefs += ((B->Flags & CBF_BACKREF) != 0);
+        } else if (E->Block != B) {
+            Internal ("Block mismatch for entry %u in function '%s'", I, Name);
+        }
+    }
+    if (BackRefs != S->BackRefBlocks) {
+        Internal ("Wrong back reference count in function '%s'", Name);
+    }
+
+    /* Nothing more to check if the segment is empty */
+    if (Count == 0) {
+        return;
+    }
+
+    /* Save the current register info */
+    Saved = xmalloc (Count * sizeof (RegInfo));
+    for (I = 0; I < Count; ++I) {
+        Saved[I] = *CS_GetEntry (S, I)->RI;
+    }
+
+    /* Regenerate the complete info */
+    CS_GenAllRegInfo (S);
+
+    /* Compare */
+    for (I = 0; I < Count; ++I) {
+        const RegInfo* RI = CS_GetEntry (S, I)->RI;
+        if (!RC_Equal (&RI->In, &Saved[I].In)               ||
+            !RC_Equal (&RI->Out, &Saved[I].Out)             ||
+            !RC_Equal (&RI->Out2, &Saved[I].Out2)           ||
+            !RC_Equal (&RI->FirstOut, &Saved[I].FirstOut)   ||
+            !RC_Equal (&RI->FirstOut2, &Saved[I].FirstOut2)) {
+            Internal ("Register info mismatch for entry %u in function '%s'",
+                      I, Name);
+        }
+    }
+
+    /* Cleanup */
+    xfree (Saved);
+}
+
+
+
+void CS_GenRegInfo (CodeSeg* S)
+/* Generate register infos for all instructions. If register info does
+** already exist, only the blocks that are affected by changes since the
+** last call are recomputed.
+*/
+{
+    if (!S->HaveBlocks) {
+        /* Generate everything from scratch */
+        CS_BuildBlocks (S);
+        CS_GenAllRegInfo (S);
+    } else if (CollCount (&S->ChangedBlocks) > 0) {
+        /* Update the changed blocks */
+        CS_UpdateRegInfo (S);
+    } else {
+        /* Nothing has changed */
+        return;
+    }
+
+    /* If requested, check the result against a complete run */
+    if (DebugOptRegInfo) {
+        CS_CheckRegInfo (S);
+    }
+}
+
+
+
+void CS_GenLiveInfo (CodeSeg* S)
+/* Generate the liveness of the registers in CS_LIVE_REGS for all
+** instructions. The register info must exist. If the liveness does already
+** exist, only the part of the code that is affected by changes since the
+** last call is recomputed.
+*/
+{
+    if (!S->LiveValid) {
+        /* Forget the changes and generate everything from scratch */
+        CS_UpdateLiveInfo (S);
+        CS_CalcLiveInfo (S);
+        S->LiveValid = 1;
+    } else {
+        /* Update the changed entries */
+        CS_UpdateLiveInfo (S);
+    }
 }
@@ -48,6 +48,7 @@
 /* cc65 */
 #include "codelab.h"
 #include "lineinfo.h"
+#include "opcodes.h"
 #include "symentry.h"
 
 
@@ -71,6 +72,12 @@ struct CodeEntry;
 /* Size of the label hash table */
 #define CS_LABEL_HASH_SIZE      29
 
+/* Registers whose liveness is kept in the code entries. The zero page
+** registers are live across long parts of the code, so keeping track of
+** them would cost more than following the code flow for the few queries.
+*/
+#define CS_LIVE_REGS            REG_AXY
+
 /* Code segment structure */
 typedef struct CodeSeg CodeSeg;
 struct CodeSeg {
@@ -80,6 +87,14 @@ struct CodeSeg {
     Collection      Labels;                     /* Labels for next insn */
     CodeLabel*      LabelHash[CS_LABEL_HASH_SIZE]; /* Label hash table */
     unsigned short  ExitRegs;                   /* Register use on exit */
+    Collection      ChangedBlocks;              /* Blocks with outdated reg info */
+    Collection      DeadBlocks;                 /* Blocks no longer in use */
+    unsigned        BackRefBlocks;              /* Blocks with backward jumps to them */
+    unsigned char   HaveBlocks;                 /* Reg info and blocks exist */
+    unsigned        ValidIndices;               /* Entries with valid cached index */
+    unsigned        LiveSeen;                   /* Changed blocks seen by the liveness */
+    unsigned char   LiveValid;                  /* Liveness in entries is valid */
+    unsigned        GenLabelCount;              /* Labels created by CS_GenLabel */
 
     /* Optimization settings for this segment */
     unsigned char   Optimize;                   /* On/off switch */
@@ -145,17 +160,10 @@ void CS_MoveEntries (CodeSeg* S, unsigned Start, unsigned Count, unsigned NewPos
 ** current code end)
 */
 
-#if defined(HAVE_INLINE)
-INLINE void CS_MoveEntry (CodeSeg* S, unsigned OldPos, unsigned NewPos)
+void CS_MoveEntry (CodeSeg* S, unsigned OldPos, unsigned NewPos);
 /* Move an entry from one position to another. OldPos is the current position
 ** of the entry, NewPos is the new position of the entry.
 */
-{
-    CollMove (&S->Entries, OldPos, NewPos);
-}
-#else
-#  define CS_MoveEntry(S, OldPos, NewPos)       CollMove (&(S)->Entries, OldPos, NewPos)
-#endif
 
 #if defined(HAVE_INLINE)
 INLINE struct CodeEntry* CS_GetEntry (CodeSeg* S, unsigned Index)
@@ -184,12 +192,14 @@ int CS_GetEntries (CodeSeg* S, struct CodeEntry** List,
 */
 
 unsigned CS_GetEntryIndex (CodeSeg* S, struct CodeEntry* E);
-/* Return the index of a code entry */
+/* Return the index of a code entry. The index is cached in the entry, so
+** this is usually a constant time operation.
+*/
 
 int CS_RangeHasLabel (CodeSeg* S, unsigned Start, unsigned Count);
 /* Return true if any of the code entries in the given range has a label
 ** attached. If the code segment does not span the given range, check the
-** possible span instead.
+** possible span instead. Uses the cached label counts of the entries.
 */
 
 #if defined(HAVE_INLINE)
@@ -207,11 +217,31 @@ INLINE int CS_HavePendingLabel (const CodeSeg* S)
 CodeLabel* CS_AddLabel (CodeSeg* S, const char* Name);
 /* Add a code label for the next instruction to follow */
 
+CodeLabel* CS_GetJumpLabel (CodeSeg* S, opc_t OPC, const char* Name);
+/* Return the label with the given name used as the target of the branch or
+** jump instruction OPC. If the label does not exist, it is a forward ref, so
+** it is created unless OPC is a jump to an external function. In this case,
+** NULL is returned.
+*/
+
+void CS_MarkIndirectLabel (CodeSeg* S, const char* Name);
+/* Mark the label with the given name as the target of an indirect jump, for
+** example from a jump table. The optimizer will neither delete nor merge such
+** a label. If the label does not exist, it is a forward ref and is created.
+*/
+
 CodeLabel* CS_GenLabel (CodeSeg* S, struct CodeEntry* E);
 /* If the code entry E does already have a label, return it. Otherwise
 ** create a new label, attach it to E and return it.
 */
 
+void CS_NameGenLabels (CodeSeg* S);
+/* Labels created by CS_GenLabel have temporary names, so the optimizer may
+** run for several code segments at the same time. This function assigns the
+** final label names. To get a deterministic output, it must be called for
+** all code segments in the order in which they are output.
+*/
+
 void CS_DelLabel (CodeSeg* S, CodeLabel* L);
 /* Remove references from this label and delete it. */
 
@@ -292,7 +322,17 @@ void CS_FreeRegInfo (CodeSeg* S);
 /* Free register infos for all instructions */
 
 void CS_GenRegInfo (CodeSeg* S);
-/* Generate register infos for all instructions */
+/* Generate register infos for all instructions. If register info does
+** already exist, only the part of the code that is affected by changes since
+** the last call is recomputed.
+*/
+
+void CS_GenLiveInfo (CodeSeg* S);
+/* Generate the liveness of the registers in CS_LIVE_REGS for all
+** instructions. The register info must exist. If the liveness does already
+** exist, only the part of the code that is affected by changes since the
+** last call is recomputed.
+*/
 
 
 
@@ -58,6 +58,7 @@
 #include "litpool.h"
 #include "macrotab.h"
 #include "output.h"
+#include "pch.h"
 #include "pragma.h"
 #include "preproc.h"
 #include "standard.h"
@@ -381,6 +382,9 @@ void Compile (const char* FileName)
     /* Generate the code generator preamble */
     g_preamble ();
 
+    /* Prepare precompiled headers */
+    InitPCH ();
+
     /* Open the input file */
     OpenMainFile (FileName);
 
@@ -420,6 +424,7 @@ void FinishCompile (void)
 /* Emit literals, externals, debug info, do cleanup and optimizations */
 {
     SymEntry* Entry;
+    Collection Funcs = AUTO_COLLECTION_INITIALIZER;
 
     /* Reset the BSS segment name to its default; so that the below strcmp()
     ** will work as expected, at the beginning of the list of variables
@@ -427,7 +432,7 @@ void FinishCompile (void)
     SetSegName (SEG_BSS, SEGNAME_BSS);
 
     /* Walk over all global symbols:
-    ** - for functions, do clean-up and optimizations
+    ** - for functions, do clean-up and remember the code for optimization
     ** - generate code for uninitialized global variables
     */
     for (Entry = GetGlobalSymTab ()->SymHead; Entry; Entry = Entry->NextSym) {
@@ -435,7 +440,7 @@ void FinishCompile (void)
             /* Function which is defined and referenced or extern */
             MoveLiteralPool (Entry->V.F.LitPool);
             CS_MergeLabels (Entry->V.F.Seg->Code);
-            RunOpt (Entry->V.F.Seg->Code);
+            CollAppend (&Funcs, Entry->V.F.Seg->Code);
         } else if ((Entry->Flags & (SC_STORAGE | SC_DEF | SC_STATIC)) == (SC_STORAGE | SC_STATIC)) {
             /* Assembly definition of uninitialized global variable */
 
@@ -452,6 +457,10 @@ void FinishCompile (void)
         }
     }
 
+    /* Optimize the code of all functions */
+    RunOpt (&Funcs);
+    DoneCollection (&Funcs);
+
     /* Output the literal pool */
     OutputGlobalLiteralPool ();
 
@@ -40,6 +40,7 @@
 #include "codeinfo.h"
 #include "error.h"
 #include "coptcmp.h"
+#include "coptpat.h"
 
 
 
@@ -273,6 +274,24 @@ unsigned OptBoolTrans (CodeSeg* S)
 
 
 
+static unsigned ApplyCmp1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace ldx/stx tmp1/ora tmp1 by an ora */
+{
+    CodeEntry* X;
+
+    /* Insert the ora instead */
+    X = NewCodeEntry (OP65_ORA, L[0]->AM, L[0]->Arg, 0, L[0]->LI);
+    CS_InsertEntry (S, X, I);
+
+    /* Remove all other instructions */
+    CS_DelEntries (S, I+1, 3);
+
+    /* Remember, we had changes */
+    return 1;
+}
+
+
+
 unsigned OptCmp1 (CodeSeg* S)
 /* Search for the sequence
 **
@@ -285,47 +304,24 @@ unsigned OptCmp1 (CodeSeg* S)
 **      ora     xx
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[3];
-
-        /* Get next entry */
-        L[0] = CS_GetEntry (S, I);
-
-        /* Check for the sequence */
-        if (L[0]->OPC == OP65_LDX               &&
-            !CS_RangeHasLabel (S, I+1, 2)       &&
-            CS_GetEntries (S, L+1, I+1, 2)      &&
-            L[1]->OPC == OP65_STX               &&
-            strcmp (L[1]->Arg, "tmp1") == 0     &&
-            L[2]->OPC == OP65_ORA               &&
-            strcmp (L[2]->Arg, "tmp1") == 0) {
-
-            CodeEntry* X;
-
-            /* Insert the ora instead */
-            X = NewCodeEntry (OP65_ORA, L[0]->AM, L[0]->Arg, 0, L[0]->LI);
-            CS_InsertEntry (S, X, I);
+    return CS_ApplyPatternGroup (S, PAT_CMP1);
+}
 
-            /* Remove all other instructions */
-            CS_DelEntries (S, I+1, 3);
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
+static unsigned ApplyCmp2 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace stx tmp1/ora tmp1 by an ora from the location stored before */
+{
+    CodeEntry* E = L[0];
 
-        /* Next entry */
-        ++I;
+    /* Remove the remaining instructions */
+    CS_DelEntries (S, I+1, 2);
 
-    }
+    /* Insert the ora instead */
+    CS_InsertEntry (S, NewCodeEntry (OP65_ORA, E->AM, E->Arg, 0, E->LI), I+1);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -343,44 +339,7 @@ unsigned OptCmp2 (CodeSeg* S)
 **      ora     xx
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[2];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check for the sequence */
-        if (E->OPC == OP65_STX                  &&
-            !CS_RangeHasLabel (S, I+1, 2)       &&
-            CS_GetEntries (S, L, I+1, 2)        &&
-            L[0]->OPC == OP65_STX               &&
-            strcmp (L[0]->Arg, "tmp1") == 0     &&
-            L[1]->OPC == OP65_ORA               &&
-            strcmp (L[1]->Arg, "tmp1") == 0) {
-
-            /* Remove the remaining instructions */
-            CS_DelEntries (S, I+1, 2);
-
-            /* Insert the ora instead */
-            CS_InsertEntry (S, NewCodeEntry (OP65_ORA, E->AM, E->Arg, 0, E->LI), I+1);
-
-            /* Remember, we had changes */
-            ++Changes;
-
-        }
-
-        /* Next entry */
-        ++I;
-
-    }
-
-    /* Return the number of changes made */
-    return Changes;
+    return CS_ApplyPatternGroup (S, PAT_CMP2);
 }
 
 
@@ -750,46 +709,28 @@ unsigned OptCmp6 (CodeSeg* S)
 
 
 
-unsigned OptCmp7 (CodeSeg* S)
-/* Search for a sequence ldx/txa/branch and remove the txa if A is not
-** used later.
-*/
+static unsigned ApplyCmp7 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Remove the txa if the branch uses the flags of the load and A is unused */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[2];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
+    if ((L[2]->Info & OF_FBRA) == 0 || RegAUsed (S, I+3)) {
+        return 0;
+    }
 
-        /* Check for the sequence */
-        if ((E->OPC == OP65_LDX)                        &&
-            CS_GetEntries (S, L, I+1, 2)                &&
-            L[0]->OPC == OP65_TXA                       &&
-            !CE_HasLabel (L[0])                         &&
-            (L[1]->Info & OF_FBRA) != 0                 &&
-            !CE_HasLabel (L[1])                         &&
-            !RegAUsed (S, I+3)) {
+    /* Remove the txa */
+    CS_DelEntry (S, I+1);
 
-            /* Remove the txa */
-            CS_DelEntry (S, I+1);
+    /* Remember, we had changes */
+    return 1;
+}
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
 
-        /* Next entry */
-        ++I;
-
-    }
-
-    /* Return the number of changes made */
-    return Changes;
+unsigned OptCmp7 (CodeSeg* S)
+/* Search for a sequence ldx/txa/branch and remove the txa if A is not
+** used later.
+*/
+{
+    return CS_ApplyPatternGroup (S, PAT_CMP7);
 }
 
 
@@ -919,6 +860,32 @@ NextEntry:
 
 
 
+static unsigned ApplyCmp9 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Branch on the N flag instead of the carry and remove the asl */
+{
+    if (L[1]->JumpTo == 0                       ||
+        L[1]->JumpTo->Owner != L[3]             ||
+        L[3]->AM != AM65_ACC                    ||
+        RegAUsed (S, I+4)) {
+        return 0;
+    }
+
+    /* Replace the branch condition */
+    switch (GetBranchCond (L[4]->OPC)) {
+        case BC_CC:     CE_ReplaceOPC (L[4], OP65_JPL); break;
+        case BC_CS:     CE_ReplaceOPC (L[4], OP65_JMI); break;
+        default:        Internal ("Unknown branch condition in OptCmp9");
+    }
+
+    /* Delete the asl insn */
+    CS_DelEntry (S, I+3);
+
+    /* Remember, we had changes */
+    return 1;
+}
+
+
+
 unsigned OptCmp9 (CodeSeg* S)
 /* Search for the sequence
 **
@@ -932,57 +899,41 @@ unsigned OptCmp9 (CodeSeg* S)
 ** flag instead of the carry flag and remove the asl.
 */
 {
-    unsigned Changes = 0;
-    unsigned I;
-
-    /* Walk over the entries */
-    I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[5];
-
-        /* Get next entry */
-        L[0] = CS_GetEntry (S, I);
+    return CS_ApplyPatternGroup (S, PAT_CMP9);
+}
 
-        /* Check for the sequence */
-        if (L[0]->OPC == OP65_SBC                       &&
-            CS_GetEntries (S, L+1, I+1, 4)              &&
-            (L[1]->OPC == OP65_BVC              ||
-             L[1]->OPC == OP65_BVS)                     &&
-            L[1]->JumpTo != 0                           &&
-            L[1]->JumpTo->Owner == L[3]                 &&
-            L[2]->OPC == OP65_EOR                       &&
-            CE_IsKnownImm (L[2], 0x80)                  &&
-            L[3]->OPC == OP65_ASL                       &&
-            L[3]->AM == AM65_ACC                        &&
-            (L[4]->OPC == OP65_BCC              ||
-             L[4]->OPC == OP65_BCS              ||
-             L[4]->OPC == OP65_JCC              ||
-             L[4]->OPC == OP65_JCS)                     &&
-            !CE_HasLabel (L[4])                         &&
-            !RegAUsed (S, I+4)) {
-
-            /* Replace the branch condition */
-            switch (GetBranchCond (L[4]->OPC)) {
-                case BC_CC:     CE_ReplaceOPC (L[4], OP65_JPL); break;
-                case BC_CS:     CE_ReplaceOPC (L[4], OP65_JMI); break;
-                default:        Internal ("Unknown branch condition in OptCmp9");
-            }
 
-            /* Delete the asl insn */
-            CS_DelEntry (S, I+3);
 
-            /* Next sequence is somewhat ahead (if any) */
-            I += 3;
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
 
-            /* Remember, we had changes */
-            ++Changes;
-        }
 
-        /* Next entry */
-        ++I;
-    }
 
-    /* Return the number of changes made */
-    return Changes;
-}
+const CodePattern CmpPatterns[] = {
+    {
+        PAT_CMP1,
+        "ldx; stx tmp1; ora tmp1",
+        PF_NONE,
+        ApplyCmp1
+    },
+    {
+        PAT_CMP2,
+        "stx; stx tmp1; ora tmp1",
+        PF_NONE,
+        ApplyCmp2
+    },
+    {
+        PAT_CMP7,
+        "ldx; txa; *",
+        PF_NONE,
+        ApplyCmp7
+    },
+    {
+        PAT_CMP9,
+        "sbc; @bvc|bvs; @eor #$80; @asl; bcc|bcs|jcc|jcs",
+        PF_NONE,
+        ApplyCmp9
+    },
+    { 0, 0, 0, 0 }
+};
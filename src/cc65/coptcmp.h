@@ -40,6 +40,7 @@
 
 /* cc65 */
 #include "codeseg.h"
+#include "coptpat.h"
 
 
 
@@ -168,6 +169,18 @@ unsigned OptCmp9 (CodeSeg* S);
 
 
 
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+extern const CodePattern CmpPatterns[];
+/* Patterns used by the optimizer steps above */
+
+
+
 /* End of coptcmp.h */
 
 #endif
@@ -39,6 +39,7 @@
 /* cc65 */
 #include "codeent.h"
 #include "coptind.h"
+#include "coptpat.h"
 #include "codeinfo.h"
 #include "codeopt.h"
 #include "error.h"
@@ -409,6 +410,8 @@ unsigned OptDeadCode (CodeSeg* S)
              ((N->Info & OF_UBRA) != 0          &&              /* Uncond branch */
               (LN = N->JumpTo) != 0             &&              /* Jumps to known label */
               LN->Owner == N                    &&              /* Attached to insn */
+              CE_GetLabelCount (N) == 1         &&              /* Only label */
+              !CL_IsIndirect (LN)               &&              /* Not in a table */
               CL_GetRefCount (LN) == 1))) {                     /* Only reference */
 
             /* Delete the next entry */
@@ -1060,8 +1063,8 @@ unsigned OptUnusedLoads (CodeSeg* S)
                 default:        goto NextEntry;         /* OOPS */
             }
 
-            /* Get register usage and check if the register value is used later */
-            if ((GetRegInfo (S, I+1, R) & R) == 0) {
+            /* Check if the register value is used later */
+            if (!RegUsed (S, I+1, R)) {
 
                 /* Register value is not used, remove the load */
                 CS_DelEntry (S, I);
@@ -1332,50 +1335,75 @@ unsigned OptDupLoads (CodeSeg* S)
 
 
 
-unsigned OptStoreLoad (CodeSeg* S)
-/* Remove a store followed by a load from the same location. */
+static unsigned ApplyStoreLoad (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Remove the load if it is from the same address as the store, and not
+** followed by a conditional branch.
+*/
 {
-    unsigned Changes = 0;
+    CodeEntry* E = L[0];
+    CodeEntry* N = L[1];
+
+    if (E->AM != N->AM                                  ||
+        !((E->OPC == OP65_STA && N->OPC == OP65_LDA) ||
+          (E->OPC == OP65_STX && N->OPC == OP65_LDX) ||
+          (E->OPC == OP65_STY && N->OPC == OP65_LDY))   ||
+        strcmp (E->Arg, N->Arg) != 0                    ||
+        CE_UseLoadFlags (L[2])) {
+        return 0;
+    }
 
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
+    /* Register has already the correct value, remove the load */
+    CS_DelEntry (S, I+1);
 
-        CodeEntry* N;
-        CodeEntry* X;
+    /* Remember, we had changes */
+    return 1;
+}
 
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
 
-        /* Check if it is a store instruction followed by a load from the
-        ** same address which is itself not followed by a conditional branch.
-        */
-        if ((E->Info & OF_STORE) != 0                       &&
-            (N = CS_GetNextEntry (S, I)) != 0               &&
-            !CE_HasLabel (N)                                &&
-            E->AM == N->AM                                  &&
-            ((E->OPC == OP65_STA && N->OPC == OP65_LDA) ||
-             (E->OPC == OP65_STX && N->OPC == OP65_LDX) ||
-             (E->OPC == OP65_STY && N->OPC == OP65_LDY))    &&
-            strcmp (E->Arg, N->Arg) == 0                    &&
-            (X = CS_GetNextEntry (S, I+1)) != 0             &&
-            !CE_UseLoadFlags (X)) {
-
-            /* Register has already the correct value, remove the load */
-            CS_DelEntry (S, I+1);
 
-            /* Remember, we had changes */
-            ++Changes;
+unsigned OptStoreLoad (CodeSeg* S)
+/* Remove a store followed by a load from the same location. */
+{
+    return CS_ApplyPatternGroup (S, PAT_STORELOAD);
+}
 
-        }
 
-        /* Next entry */
-        ++I;
 
+static unsigned ApplyTransfers1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Remove a transfer from one register to another and back */
+{
+    CodeEntry* E = L[0];
+    CodeEntry* N = L[1];
+
+    /* Check if it's a transfer and back */
+    if (!((E->OPC == OP65_TAX && N->OPC == OP65_TXA && !RegXUsed (S, I+2)) ||
+          (E->OPC == OP65_TAY && N->OPC == OP65_TYA && !RegYUsed (S, I+2)) ||
+          (E->OPC == OP65_TXA && N->OPC == OP65_TAX && !RegAUsed (S, I+2)) ||
+          (E->OPC == OP65_TYA && N->OPC == OP65_TAY && !RegAUsed (S, I+2)))) {
+        return 0;
     }
 
-    /* Return the number of changes made */
-    return Changes;
+    /* If the next insn is a conditional branch, check if the insn
+    ** preceeding the first xfr will set the flags right, otherwise we
+    ** may not remove the sequence.
+    */
+    if (CE_UseLoadFlags (L[2])) {
+        if (I == 0) {
+            /* No preceeding entry */
+            return 0;
+        }
+        if ((CS_GetEntry (S, I-1)->Info & OF_SETF) == 0) {
+            /* Does not set the flags */
+            return 0;
+        }
+    }
+
+    /* Remove both transfers */
+    CS_DelEntry (S, I+1);
+    CS_DelEntry (S, I);
+
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -1383,67 +1411,7 @@ unsigned OptStoreLoad (CodeSeg* S)
 unsigned OptTransfers1 (CodeSeg* S)
 /* Remove transfers from one register to another and back */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* N;
-        CodeEntry* X;
-        CodeEntry* P;
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check if we have two transfer instructions */
-        if ((E->Info & OF_XFR) != 0                 &&
-            (N = CS_GetNextEntry (S, I)) != 0       &&
-            !CE_HasLabel (N)                        &&
-            (N->Info & OF_XFR) != 0) {
-
-            /* Check if it's a transfer and back */
-            if ((E->OPC == OP65_TAX && N->OPC == OP65_TXA && !RegXUsed (S, I+2)) ||
-                (E->OPC == OP65_TAY && N->OPC == OP65_TYA && !RegYUsed (S, I+2)) ||
-                (E->OPC == OP65_TXA && N->OPC == OP65_TAX && !RegAUsed (S, I+2)) ||
-                (E->OPC == OP65_TYA && N->OPC == OP65_TAY && !RegAUsed (S, I+2))) {
-
-                /* If the next insn is a conditional branch, check if the insn
-                ** preceeding the first xfr will set the flags right, otherwise we
-                ** may not remove the sequence.
-                */
-                if ((X = CS_GetNextEntry (S, I+1)) == 0) {
-                    goto NextEntry;
-                }
-                if (CE_UseLoadFlags (X)) {
-                    if (I == 0) {
-                        /* No preceeding entry */
-                        goto NextEntry;
-                    }
-                    P = CS_GetEntry (S, I-1);
-                    if ((P->Info & OF_SETF) == 0) {
-                        /* Does not set the flags */
-                        goto NextEntry;
-                    }
-                }
-
-                /* Remove both transfers */
-                CS_DelEntry (S, I+1);
-                CS_DelEntry (S, I);
-
-                /* Remember, we had changes */
-                ++Changes;
-            }
-        }
-
-NextEntry:
-        /* Next entry */
-        ++I;
-
-    }
-
-    /* Return the number of changes made */
-    return Changes;
+    return CS_ApplyPatternGroup (S, PAT_TRANSFERS1);
 }
 
 
@@ -2298,3 +2266,27 @@ unsigned OptIndLoads2 (CodeSeg* S)
     /* Return the number of changes made */
     return Changes;
 }
+
+
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+const CodePattern IndPatterns[] = {
+    {
+        PAT_STORELOAD,
+        "sta|stx|sty; lda|ldx|ldy; @*",
+        PF_NONE,
+        ApplyStoreLoad
+    },
+    {
+        PAT_TRANSFERS1,
+        "tax|tay|txa|tya; tax|tay|txa|tya; @*",
+        PF_NONE,
+        ApplyTransfers1
+    },
+    { 0, 0, 0, 0 }
+};
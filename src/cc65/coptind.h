@@ -40,6 +40,7 @@
 
 /* cc65 */
 #include "codeseg.h"
+#include "coptpat.h"
 
 
 
@@ -173,6 +174,18 @@ unsigned OptIndLoads2 (CodeSeg* S);
 
 
 
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+extern const CodePattern IndPatterns[];
+/* Patterns used by the optimizer steps above */
+
+
+
 /* End of coptind.h */
 
 #endif
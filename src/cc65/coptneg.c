@@ -37,6 +37,7 @@
 #include "codeent.h"
 #include "codeinfo.h"
 #include "coptneg.h"
+#include "coptpat.h"
 
 
 
@@ -46,6 +47,22 @@
 
 
 
+static unsigned ApplyBNegA1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Remove the ldx if the lda does not use it */
+{
+    if ((L[1]->Use & REG_X) != 0) {
+        return 0;
+    }
+
+    /* Remove the ldx instruction */
+    CS_DelEntry (S, I);
+
+    /* Remember, we had changes */
+    return 1;
+}
+
+
+
 unsigned OptBNegA1 (CodeSeg* S)
 /* Check for
 **
@@ -56,44 +73,22 @@ unsigned OptBNegA1 (CodeSeg* S)
 ** Remove the ldx if the lda does not use it.
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[2];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check for a ldx */
-        if (E->OPC == OP65_LDX                  &&
-            E->AM == AM65_IMM                   &&
-            (E->Flags & CEF_NUMARG) != 0        &&
-            E->Num == 0                         &&
-            CS_GetEntries (S, L, I+1, 2)        &&
-            L[0]->OPC == OP65_LDA               &&
-            (L[0]->Use & REG_X) == 0            &&
-            !CE_HasLabel (L[0])                 &&
-            CE_IsCallTo (L[1], "bnega")         &&
-            !CE_HasLabel (L[1])) {
-
-            /* Remove the ldx instruction */
-            CS_DelEntry (S, I);
+    return CS_ApplyPatternGroup (S, PAT_BNEGA1);
+}
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
 
-        /* Next entry */
-        ++I;
+static unsigned ApplyBNegA2 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Invert the branch and remove the call to bnega */
+{
+    /* Invert the branch */
+    CE_ReplaceOPC (L[2], GetInverseBranch (L[2]->OPC));
 
-    }
+    /* Delete the subroutine call */
+    CS_DelEntry (S, I+1);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -108,60 +103,33 @@ unsigned OptBNegA2 (CodeSeg* S)
 ** Adjust the conditional branch and remove the call to the subroutine.
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[2];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
+    return CS_ApplyPatternGroup (S, PAT_BNEGA2);
+}
 
-        /* Check for the sequence */
-        if ((E->OPC == OP65_ADC ||
-             E->OPC == OP65_AND ||
-             E->OPC == OP65_DEA ||
-             E->OPC == OP65_EOR ||
-             E->OPC == OP65_INA ||
-             E->OPC == OP65_LDA ||
-             E->OPC == OP65_ORA ||
-             E->OPC == OP65_PLA ||
-             E->OPC == OP65_SBC ||
-             E->OPC == OP65_TXA ||
-             E->OPC == OP65_TYA)                &&
-            CS_GetEntries (S, L, I+1, 2)        &&
-            CE_IsCallTo (L[0], "bnega")         &&
-            !CE_HasLabel (L[0])                 &&
-            (L[1]->Info & OF_ZBRA) != 0         &&
-            !CE_HasLabel (L[1])) {
 
-            /* Invert the branch */
-            CE_ReplaceOPC (L[1], GetInverseBranch (L[1]->OPC));
 
-            /* Delete the subroutine call */
-            CS_DelEntry (S, I+1);
+/*****************************************************************************/
+/*                            bnegax optimizations                           */
+/*****************************************************************************/
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
 
-        /* Next entry */
-        ++I;
+static unsigned ApplyBNegAX1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to bnegax by a call to bnega if X is zero */
+{
+    CodeEntry* X;
 
+    if (L[0]->RI->In.RegX != 0) {
+        return 0;
     }
 
-    /* Return the number of changes made */
-    return Changes;
-}
+    X = NewCodeEntry (OP65_JSR, AM65_ABS, "bnega", 0, L[0]->LI);
+    CS_InsertEntry (S, X, I+1);
+    CS_DelEntry (S, I);
 
-
-
-/*****************************************************************************/
-/*                            bnegax optimizations                           */
-/*****************************************************************************/
+    /* Remember, we had changes */
+    return 1;
+}
 
 
 
@@ -171,34 +139,40 @@ unsigned OptBNegAX1 (CodeSeg* S)
 ** later if possible.
 */
 {
-    unsigned Changes = 0;
-    unsigned I;
+    return CS_ApplyPatternGroup (S, PAT_BNEGAX1);
+}
 
-    /* Walk over the entries */
-    I = 0;
-    while (I < CS_GetEntryCount (S)) {
 
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
 
-        /* Check if this is a call to bnegax, and if X is known and zero */
-        if (E->RI->In.RegX == 0 && CE_IsCallTo (E, "bnegax")) {
+static unsigned ApplyBNegAX2 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to ldaxysp and bnegax by an inline test */
+{
+    CodeEntry* X;
 
-            CodeEntry* X = NewCodeEntry (OP65_JSR, AM65_ABS, "bnega", 0, E->LI);
-            CS_InsertEntry (S, X, I+1);
-            CS_DelEntry (S, I);
+    if (!CE_IsConstImm (L[0])) {
+        return 0;
+    }
 
-            /* We had changes */
-            ++Changes;
-        }
+    /* lda (sp),y */
+    X = NewCodeEntry (OP65_LDA, AM65_ZP_INDY, "sp", 0, L[1]->LI);
+    CS_InsertEntry (S, X, I+1);
 
-        /* Next entry */
-        ++I;
+    /* dey */
+    X = NewCodeEntry (OP65_DEY, AM65_IMP, 0, 0, L[1]->LI);
+    CS_InsertEntry (S, X, I+2);
 
-    }
+    /* ora (sp),y */
+    X = NewCodeEntry (OP65_ORA, AM65_ZP_INDY, "sp", 0, L[1]->LI);
+    CS_InsertEntry (S, X, I+3);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Invert the branch */
+    CE_ReplaceOPC (L[3], GetInverseBranch (L[3]->OPC));
+
+    /* Delete the entries no longer needed. */
+    CS_DelEntries (S, I+4, 2);
+
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -220,58 +194,25 @@ unsigned OptBNegAX2 (CodeSeg* S)
 **      jeq/jne ...
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[4];
-
-        /* Get next entry */
-        L[0] = CS_GetEntry (S, I);
-
-        /* Check for the sequence */
-        if (L[0]->OPC == OP65_LDY               &&
-            CE_IsConstImm (L[0])                &&
-            !CS_RangeHasLabel (S, I+1, 3)       &&
-            CS_GetEntries (S, L+1, I+1, 3)      &&
-            CE_IsCallTo (L[1], "ldaxysp")       &&
-            CE_IsCallTo (L[2], "bnegax")        &&
-            (L[3]->Info & OF_ZBRA) != 0) {
-
-            CodeEntry* X;
-
-            /* lda (sp),y */
-            X = NewCodeEntry (OP65_LDA, AM65_ZP_INDY, "sp", 0, L[1]->LI);
-            CS_InsertEntry (S, X, I+1);
-
-            /* dey */
-            X = NewCodeEntry (OP65_DEY, AM65_IMP, 0, 0, L[1]->LI);
-            CS_InsertEntry (S, X, I+2);
-
-            /* ora (sp),y */
-            X = NewCodeEntry (OP65_ORA, AM65_ZP_INDY, "sp", 0, L[1]->LI);
-            CS_InsertEntry (S, X, I+3);
-
-            /* Invert the branch */
-            CE_ReplaceOPC (L[3], GetInverseBranch (L[3]->OPC));
+    return CS_ApplyPatternGroup (S, PAT_BNEGAX2);
+}
 
-            /* Delete the entries no longer needed. */
-            CS_DelEntries (S, I+4, 2);
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
+static unsigned ApplyBNegAX3 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the ldx by an ora and remove the call to bnegax */
+{
+    /* ldx --> ora */
+    CE_ReplaceOPC (L[1], OP65_ORA);
 
-        /* Next entry */
-        ++I;
+    /* Invert the branch */
+    CE_ReplaceOPC (L[3], GetInverseBranch (L[3]->OPC));
 
-    }
+    /* Delete the subroutine call */
+    CS_DelEntry (S, I+2);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -291,48 +232,39 @@ unsigned OptBNegAX3 (CodeSeg* S)
 **      jeq/jne ...
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[3];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check for the sequence */
-        if (E->OPC == OP65_LDA                  &&
-            CS_GetEntries (S, L, I+1, 3)        &&
-            L[0]->OPC == OP65_LDX               &&
-            !CE_HasLabel (L[0])                 &&
-            CE_IsCallTo (L[1], "bnegax")        &&
-            !CE_HasLabel (L[1])                 &&
-            (L[2]->Info & OF_ZBRA) != 0         &&
-            !CE_HasLabel (L[2])) {
-
-            /* ldx --> ora */
-            CE_ReplaceOPC (L[0], OP65_ORA);
-
-            /* Invert the branch */
-            CE_ReplaceOPC (L[2], GetInverseBranch (L[2]->OPC));
+    return CS_ApplyPatternGroup (S, PAT_BNEGAX3);
+}
 
-            /* Delete the subroutine call */
-            CS_DelEntry (S, I+2);
 
-            /* Remember, we had changes */
-            ++Changes;
 
-        }
+static unsigned ApplyBNegAX4 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to bnega or bnegax by an inline test */
+{
+    CodeEntry* X;
+
+    /* Check if we're calling bnega or bnegax */
+    if (strcmp (L[1]->Arg, "bnega") == 0) {
+        /* Test bytes */
+        X = NewCodeEntry (OP65_TAX, AM65_IMP, 0, 0, L[1]->LI);
+        CS_InsertEntry (S, X, I+2);
+    } else if (strcmp (L[1]->Arg, "bnegax") == 0) {
+        /* Test words */
+        X = NewCodeEntry (OP65_STX, AM65_ZP, "tmp1", 0, L[1]->LI);
+        CS_InsertEntry (S, X, I+2);
+        X = NewCodeEntry (OP65_ORA, AM65_ZP, "tmp1", 0, L[1]->LI);
+        CS_InsertEntry (S, X, I+3);
+    } else {
+        return 0;
+    }
 
-        /* Next entry */
-        ++I;
+    /* Delete the subroutine call */
+    CS_DelEntry (S, I+1);
 
-    }
+    /* Invert the branch */
+    CE_ReplaceOPC (L[2], GetInverseBranch (L[2]->OPC));
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -351,72 +283,45 @@ unsigned OptBNegAX4 (CodeSeg* S)
 **      jne/jeq ...
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[2];
+    return CS_ApplyPatternGroup (S, PAT_BNEGAX4);
+}
 
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
 
-        /* Check for the sequence */
-        if (E->OPC == OP65_JSR                  &&
-            CS_GetEntries (S, L, I+1, 2)        &&
-            L[0]->OPC == OP65_JSR               &&
-            strncmp (L[0]->Arg,"bnega",5) == 0  &&
-            !CE_HasLabel (L[0])                 &&
-            (L[1]->Info & OF_ZBRA) != 0         &&
-            !CE_HasLabel (L[1])) {
 
-            CodeEntry* X;
+/*****************************************************************************/
+/*                            negax optimizations                            */
+/*****************************************************************************/
 
-            /* Check if we're calling bnega or bnegax */
-            int ByteSized = (strcmp (L[0]->Arg, "bnega") == 0);
 
-            /* Insert apropriate test code */
-            if (ByteSized) {
-                /* Test bytes */
-                X = NewCodeEntry (OP65_TAX, AM65_IMP, 0, 0, L[0]->LI);
-                CS_InsertEntry (S, X, I+2);
-            } else {
-                /* Test words */
-                X = NewCodeEntry (OP65_STX, AM65_ZP, "tmp1", 0, L[0]->LI);
-                CS_InsertEntry (S, X, I+2);
-                X = NewCodeEntry (OP65_ORA, AM65_ZP, "tmp1", 0, L[0]->LI);
-                CS_InsertEntry (S, X, I+3);
-            }
 
-            /* Delete the subroutine call */
-            CS_DelEntry (S, I+1);
+static unsigned ApplyNegAX1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to negax by inline code if X isn't used later */
+{
+    CodeEntry* X;
 
-            /* Invert the branch */
-            CE_ReplaceOPC (L[1], GetInverseBranch (L[1]->OPC));
+    if (RegXUsed (S, I+1)) {
+        return 0;
+    }
 
-            /* Remember, we had changes */
-            ++Changes;
+    /* Add replacement code behind */
+    X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, L[0]->LI);
+    CS_InsertEntry (S, X, I+1);
 
-        }
+    X = NewCodeEntry (OP65_CLC, AM65_IMP, 0, 0, L[0]->LI);
+    CS_InsertEntry (S, X, I+2);
 
-        /* Next entry */
-        ++I;
+    X = NewCodeEntry (OP65_ADC, AM65_IMM, "$01", 0, L[0]->LI);
+    CS_InsertEntry (S, X, I+3);
 
-    }
+    /* Delete the call to negax */
+    CS_DelEntry (S, I);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
 
-/*****************************************************************************/
-/*                            negax optimizations                            */
-/*****************************************************************************/
-
-
-
 unsigned OptNegAX1 (CodeSeg* S)
 /* Search for a call to negax and replace it by
 **
@@ -427,48 +332,56 @@ unsigned OptNegAX1 (CodeSeg* S)
 ** if X isn't used later.
 */
 {
-    unsigned Changes = 0;
-    unsigned I;
+    return CS_ApplyPatternGroup (S, PAT_NEGAX1);
+}
+
 
-    /* Walk over the entries */
-    I = 0;
-    while (I < CS_GetEntryCount (S)) {
 
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
+static unsigned ApplyNegAX2 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to negax by inline code if X is zero */
+{
+    CodeEntry* E = L[0];
+    CodeEntry* X;
+    CodeLabel* Label;
 
-        /* Check if this is a call to negax, and if X isn't used later */
-        if (CE_IsCallTo (E, "negax") && !RegXUsed (S, I+1)) {
+    if (E->RI->In.RegX != 0) {
+        return 0;
+    }
 
-            CodeEntry* X;
+    /* Add replacement code behind */
 
-            /* Add replacement code behind */
-            X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, E->LI);
-            CS_InsertEntry (S, X, I+1);
+    /* ldx #$FF */
+    X = NewCodeEntry (OP65_LDX, AM65_IMM, "$FF", 0, E->LI);
+    CS_InsertEntry (S, X, I+1);
 
-            X = NewCodeEntry (OP65_CLC, AM65_IMP, 0, 0, E->LI);
-            CS_InsertEntry (S, X, I+2);
+    /* eor #$FF */
+    X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, E->LI);
+    CS_InsertEntry (S, X, I+2);
 
-            X = NewCodeEntry (OP65_ADC, AM65_IMM, "$01", 0, E->LI);
-            CS_InsertEntry (S, X, I+3);
+    /* clc */
+    X = NewCodeEntry (OP65_CLC, AM65_IMP, 0, 0, E->LI);
+    CS_InsertEntry (S, X, I+3);
 
-            /* Delete the call to negax */
-            CS_DelEntry (S, I);
+    /* adc #$01 */
+    X = NewCodeEntry (OP65_ADC, AM65_IMM, "$01", 0, E->LI);
+    CS_InsertEntry (S, X, I+4);
 
-            /* Skip the generated code */
-            I += 2;
+    /* Get the label attached to the insn following the call */
+    Label = CS_GenLabel (S, L[1]);
 
-            /* We had changes */
-            ++Changes;
-        }
+    /* bne L */
+    X = NewCodeEntry (OP65_BNE, AM65_BRA, Label->Name, Label, E->LI);
+    CS_InsertEntry (S, X, I+5);
 
-        /* Next entry */
-        ++I;
+    /* inx */
+    X = NewCodeEntry (OP65_INX, AM65_IMP, 0, 0, E->LI);
+    CS_InsertEntry (S, X, I+6);
 
-    }
+    /* Delete the call to negax */
+    CS_DelEntry (S, I);
 
-    /* Return the number of changes made */
-    return Changes;
+    /* Remember, we had changes */
+    return 1;
 }
 
 
@@ -487,79 +400,36 @@ unsigned OptNegAX2 (CodeSeg* S)
 ** if X is known and zero on entry.
 */
 {
-    unsigned Changes = 0;
-    unsigned I;
-
-    /* Walk over the entries */
-    I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* P;
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check if this is a call to negax, and if X is known and zero */
-        if (E->RI->In.RegX == 0                 &&
-            CE_IsCallTo (E, "negax")            &&
-            (P = CS_GetNextEntry (S, I)) != 0) {
-
-            CodeEntry* X;
-            CodeLabel* L;
-
-            /* Add replacement code behind */
-
-            /* ldx #$FF */
-            X = NewCodeEntry (OP65_LDX, AM65_IMM, "$FF", 0, E->LI);
-            CS_InsertEntry (S, X, I+1);
-
-            /* eor #$FF */
-            X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, E->LI);
-            CS_InsertEntry (S, X, I+2);
-
-            /* clc */
-            X = NewCodeEntry (OP65_CLC, AM65_IMP, 0, 0, E->LI);
-            CS_InsertEntry (S, X, I+3);
-
-            /* adc #$01 */
-            X = NewCodeEntry (OP65_ADC, AM65_IMM, "$01", 0, E->LI);
-            CS_InsertEntry (S, X, I+4);
-
-            /* Get the label attached to the insn following the call */
-            L = CS_GenLabel (S, P);
+    return CS_ApplyPatternGroup (S, PAT_NEGAX2);
+}
 
-            /* bne L */
-            X = NewCodeEntry (OP65_BNE, AM65_BRA, L->Name, L, E->LI);
-            CS_InsertEntry (S, X, I+5);
 
-            /* inx */
-            X = NewCodeEntry (OP65_INX, AM65_IMP, 0, 0, E->LI);
-            CS_InsertEntry (S, X, I+6);
 
-            /* Delete the call to negax */
-            CS_DelEntry (S, I);
+/*****************************************************************************/
+/*                           complax optimizations                           */
+/*****************************************************************************/
 
-            /* Skip the generated code */
-            I += 5;
 
-            /* We had changes */
-            ++Changes;
-        }
 
-        /* Next entry */
-        ++I;
+static unsigned ApplyComplAX1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Replace the call to complax by an eor if X isn't used later */
+{
+    CodeEntry* X;
 
+    if (RegXUsed (S, I+1)) {
+        return 0;
     }
 
-    /* Return the number of changes made */
-    return Changes;
-}
-
+    /* Add replacement code behind */
+    X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, L[0]->LI);
+    CS_InsertEntry (S, X, I+1);
 
+    /* Delete the call to complax */
+    CS_DelEntry (S, I);
 
-/*****************************************************************************/
-/*                           complax optimizations                           */
-/*****************************************************************************/
+    /* Remember, we had changes */
+    return 1;
+}
 
 
 
@@ -571,37 +441,71 @@ unsigned OptComplAX1 (CodeSeg* S)
 ** if X isn't used later.
 */
 {
-    unsigned Changes = 0;
-    unsigned I;
-
-    /* Walk over the entries */
-    I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check if this is a call to negax, and if X isn't used later */
-        if (CE_IsCallTo (E, "complax") && !RegXUsed (S, I+1)) {
-
-            CodeEntry* X;
+    return CS_ApplyPatternGroup (S, PAT_COMPLAX1);
+}
 
-            /* Add replacement code behind */
-            X = NewCodeEntry (OP65_EOR, AM65_IMM, "$FF", 0, E->LI);
-            CS_InsertEntry (S, X, I+1);
 
-            /* Delete the call to negax */
-            CS_DelEntry (S, I);
 
-            /* We had changes */
-            ++Changes;
-        }
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
 
-        /* Next entry */
-        ++I;
 
-    }
 
-    /* Return the number of changes made */
-    return Changes;
-}
+const CodePattern NegPatterns[] = {
+    {
+        PAT_BNEGA1,
+        "ldx #0; lda; jsr bnega",
+        PF_NONE,
+        ApplyBNegA1
+    },
+    {
+        PAT_BNEGA2,
+        "adc|and|dea|eor|ina|lda|ora|pla|sbc|txa|tya; jsr bnega; beq|bne|jeq|jne",
+        PF_NONE,
+        ApplyBNegA2
+    },
+    {
+        PAT_BNEGAX1,
+        "jsr bnegax",
+        PF_REGINFO,
+        ApplyBNegAX1
+    },
+    {
+        PAT_BNEGAX2,
+        "ldy; jsr ldaxysp; jsr bnegax; beq|bne|jeq|jne",
+        PF_NONE,
+        ApplyBNegAX2
+    },
+    {
+        PAT_BNEGAX3,
+        "lda; ldx; jsr bnegax; beq|bne|jeq|jne",
+        PF_NONE,
+        ApplyBNegAX3
+    },
+    {
+        PAT_BNEGAX4,
+        "jsr; jsr; beq|bne|jeq|jne",
+        PF_REGINFO,
+        ApplyBNegAX4
+    },
+    {
+        PAT_NEGAX1,
+        "jsr negax",
+        PF_NONE,
+        ApplyNegAX1
+    },
+    {
+        PAT_NEGAX2,
+        "jsr negax; @*",
+        PF_REGINFO,
+        ApplyNegAX2
+    },
+    {
+        PAT_COMPLAX1,
+        "jsr complax",
+        PF_NONE,
+        ApplyComplAX1
+    },
+    { 0, 0, 0, 0 }
+};
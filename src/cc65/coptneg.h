@@ -40,6 +40,7 @@
 
 /* cc65 */
 #include "codeseg.h"
+#include "coptpat.h"
 
 
 
@@ -180,6 +181,18 @@ unsigned OptComplAX1 (CodeSeg* S);
 
 
 
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+extern const CodePattern NegPatterns[];
+/* Patterns used by the optimizer steps above */
+
+
+
 /* End of coptneg.h */
 
 #endif
@@ -0,0 +1,465 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 coptpat.c                                 */
+/*                                                                           */
+/*                      Pattern based peephole optimizer                     */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+/* common */
+#include "chartype.h"
+#include "check.h"
+#include "coll.h"
+#include "xmalloc.h"
+
+/* cc65 */
+#include "codeent.h"
+#include "coptcmp.h"
+#include "coptind.h"
+#include "coptneg.h"
+#include "coptpat.h"
+#include "coptsub.h"
+#include "error.h"
+#include "opcodes.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* All pattern tables. Each table is terminated by an entry with Insns == 0 */
+static const CodePattern* const PatternTables[] = {
+    CmpPatterns,
+    IndPatterns,
+    NegPatterns,
+    SubPatterns,
+};
+
+/* Flags for a pattern instruction */
+#define PIF_LABEL       0x01U           /* Insn may have a label */
+#define PIF_NUM         0x02U           /* Insn has immediate numeric operand */
+
+/* One instruction of a compiled pattern */
+typedef struct PatInsn PatInsn;
+struct PatInsn {
+    unsigned char       Opcs[OP65_COUNT];       /* Opcodes that match */
+    unsigned char       Flags;                  /* See above */
+    unsigned long       Num;                    /* Numeric operand */
+    char*               Arg;                    /* Argument, NULL if any */
+};
+
+/* A compiled pattern */
+typedef struct Pattern Pattern;
+struct Pattern {
+    const CodePattern*  Def;                    /* Pattern definition */
+    unsigned            Count;                  /* Number of instructions */
+    PatInsn             Insns[PAT_MAX_INSNS];   /* Instructions */
+};
+
+/* The patterns are compiled into a deterministic automaton over the opcodes.
+** Each state stands for the set of patterns whose first Depth instructions
+** match the opcodes seen so far. State zero is the dead state, state one is
+** the start state.
+*/
+typedef struct PatState PatState;
+struct PatState {
+    Collection          Items;                  /* Patterns still matching */
+    Collection          Accept;                 /* Patterns complete here */
+    unsigned long       Groups;                 /* Groups still possible */
+    unsigned            Depth;                  /* Opcodes consumed */
+    unsigned            Next[OP65_COUNT];       /* Transitions */
+};
+
+/* All patterns and all states of the automaton */
+static Collection Patterns = STATIC_COLLECTION_INITIALIZER;
+static Collection States   = STATIC_COLLECTION_INITIALIZER;
+
+
+
+/*****************************************************************************/
+/*                              Pattern compiler                             */
+/*****************************************************************************/
+
+
+
+static void PatError (const Pattern* P)
+/* Print an error about an invalid pattern */
+{
+    Internal ("Invalid optimizer pattern: `%s'", P->Def->Insns);
+}
+
+
+
+static const char* SkipSpace (const char* S)
+/* Skip white space in a pattern */
+{
+    while (IsSpace (*S)) {
+        ++S;
+    }
+    return S;
+}
+
+
+
+static const char* ParseInsn (Pattern* P, PatInsn* I, const char* S)
+/* Parse one instruction of a pattern and return a pointer behind it */
+{
+    char Buf[64];
+    unsigned Len;
+
+    /* Skip leading white space and check for the label flag */
+    S = SkipSpace (S);
+    if (*S == '@') {
+        I->Flags |= PIF_LABEL;
+        S = SkipSpace (S + 1);
+    }
+
+    /* Read the list of mnemonics */
+    if (*S == '*') {
+        memset (I->Opcs, 1, sizeof (I->Opcs));
+        ++S;
+    } else {
+        while (1) {
+            const OPCDesc* D;
+            Len = 0;
+            while (IsAlpha (*S) || IsDigit (*S)) {
+                if (Len >= sizeof (Buf) - 1) {
+                    PatError (P);
+                }
+                Buf[Len++] = *S++;
+            }
+            Buf[Len] = '\0';
+            if ((D = FindOP65 (Buf)) == 0) {
+                PatError (P);
+            }
+            I->Opcs[D->OPC] = 1;
+            if (*S != '|') {
+                break;
+            }
+            ++S;
+        }
+    }
+
+    /* Read the optional operand */
+    S = SkipSpace (S);
+    if (*S == '#') {
+        char* End;
+        ++S;
+        if (*S == '$') {
+            ++S;
+            I->Num = strtoul (S, &End, 16);
+        } else {
+            I->Num = strtoul (S, &End, 10);
+        }
+        if (End == S) {
+            PatError (P);
+        }
+        I->Flags |= PIF_NUM;
+        S = End;
+    } else if (*S != '\0' && *S != ';') {
+        Len = 0;
+        while (*S != '\0' && *S != ';' && !IsSpace (*S)) {
+            if (Len >= sizeof (Buf) - 1) {
+                PatError (P);
+            }
+            Buf[Len++] = *S++;
+        }
+        Buf[Len] = '\0';
+        I->Arg = xstrdup (Buf);
+    }
+
+    /* Check for the end of the instruction */
+    S = SkipSpace (S);
+    if (*S != '\0' && *S != ';') {
+        PatError (P);
+    }
+    return S;
+}
+
+
+
+static void CompilePattern (const CodePattern* Def)
+/* Parse a pattern definition and add it to the list of patterns */
+{
+    const char* S = Def->Insns;
+
+    /* Create a new pattern */
+    Pattern* P = xmalloc (sizeof (Pattern));
+    memset (P, 0, sizeof (Pattern));
+    P->Def = Def;
+    CHECK (Def->Group < sizeof (unsigned long) * 8);
+
+    /* Parse the instructions */
+    while (1) {
+        if (P->Count >= PAT_MAX_INSNS) {
+            PatError (P);
+        }
+        S = ParseInsn (P, P->Insns + P->Count++, S);
+        if (*S == '\0') {
+            break;
+        }
+        ++S;
+    }
+
+    /* Remember the pattern */
+    CollAppend (&Patterns, P);
+}
+
+
+
+static unsigned GetState (Collection* Items, unsigned Depth)
+/* Return the state for the given list of patterns. The list is consumed. */
+{
+    unsigned  I;
+    PatState* S;
+
+    /* An empty list is the dead state */
+    if (CollCount (Items) == 0) {
+        DoneCollection (Items);
+        return 0;
+    }
+
+    /* Search for an existing state with this list of patterns. All patterns
+    ** are added in ascending order, so the lists can be compared directly.
+    */
+    for (I = 1; I < CollCount (&States); ++I) {
+        S = CollAtUnchecked (&States, I);
+        if (S->Depth == Depth                           &&
+            CollCount (&S->Items) == CollCount (Items)  &&
+            memcmp (S->Items.Items, Items->Items,
+                    CollCount (Items) * sizeof (void*)) == 0) {
+            DoneCollection (Items);
+            return I;
+        }
+    }
+
+    /* Create a new state */
+    S = xmalloc (sizeof (PatState));
+    memset (S, 0, sizeof (PatState));
+    S->Items  = *Items;
+    InitCollection (&S->Accept);
+    S->Depth  = Depth;
+    for (I = 0; I < CollCount (Items); ++I) {
+        Pattern* P = CollAtUnchecked (Items, I);
+        if (P->Count == Depth) {
+            CollAppend (&S->Accept, P);
+        }
+        S->Groups |= PAT_GROUP (P->Def->Group);
+    }
+    CollAppend (&States, S);
+    return CollCount (&States) - 1;
+}
+
+
+
+void InitPatterns (void)
+/* Compile all patterns into one matcher. Must be called before the first use
+** of CS_ApplyPatterns and before any optimizer threads are started.
+*/
+{
+    unsigned   I;
+    unsigned   J;
+    Collection Items;
+
+    /* Nothing to do if we did that already */
+    if (CollCount (&States) > 0) {
+        return;
+    }
+
+    /* Parse all pattern definitions */
+    for (I = 0; I < sizeof (PatternTables) / sizeof (PatternTables[0]); ++I) {
+        const CodePattern* Def = PatternTables[I];
+        while (Def->Insns) {
+            CompilePattern (Def++);
+        }
+    }
+
+    /* Add the dead state and the start state, which contains all patterns */
+    CollAppend (&States, 0);
+    InitCollection (&Items);
+    for (I = 0; I < CollCount (&Patterns); ++I) {
+        CollAppend (&Items, CollAtUnchecked (&Patterns, I));
+    }
+    GetState (&Items, 0);
+
+    /* Compute the transitions of all states. Since new states are appended,
+    ** this will also handle the states created here.
+    */
+    for (I = 1; I < CollCount (&States); ++I) {
+        opc_t OPC;
+        for (OPC = 0; OPC < OP65_COUNT; ++OPC) {
+            PatState* S = CollAtUnchecked (&States, I);
+            InitCollection (&Items);
+            for (J = 0; J < CollCount (&S->Items); ++J) {
+                Pattern* P = CollAtUnchecked (&S->Items, J);
+                if (S->Depth < P->Count && P->Insns[S->Depth].Opcs[OPC]) {
+                    CollAppend (&Items, P);
+                }
+            }
+            J = GetState (&Items, S->Depth + 1);
+            /* GetState may have reallocated the state list */
+            S = CollAtUnchecked (&States, I);
+            S->Next[OPC] = J;
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/*                                  Matcher                                  */
+/*****************************************************************************/
+
+
+
+static int MatchInsns (const Pattern* P, CodeEntry** L)
+/* Check the operands and labels of the entries against the pattern */
+{
+    unsigned I;
+    for (I = 0; I < P->Count; ++I) {
+        const PatInsn* PI = P->Insns + I;
+        const CodeEntry* E = L[I];
+        if (I > 0 && (PI->Flags & PIF_LABEL) == 0 && CE_HasLabel (E)) {
+            return 0;
+        }
+        if ((PI->Flags & PIF_NUM) != 0          &&
+            (E->AM != AM65_IMM || !CE_HasNumArg (E) || E->Num != PI->Num)) {
+            return 0;
+        }
+        if (PI->Arg && strcmp (E->Arg, PI->Arg) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+static unsigned MatchAt (CodeSeg* S, unsigned Index, unsigned long Groups,
+                         unsigned* Changes, int* Stale)
+/* Try all patterns at the given position. Add the changes to the counter of
+** the group that made them and return their number. *Stale is set if the
+** code was changed since the register info was generated.
+*/
+{
+    CodeEntry* L[PAT_MAX_INSNS];
+    unsigned   Count = CS_GetEntryCount (S);
+    unsigned   State = 1;
+    unsigned   N = 0;
+
+    while (Index + N < Count) {
+
+        unsigned        I;
+        const PatState* PS;
+
+        /* Follow the transition for the next opcode */
+        L[N] = CS_GetEntry (S, Index + N);
+        State = ((const PatState*) CollAtUnchecked (&States, State))->Next[L[N]->OPC];
+        if (State == 0) {
+            break;
+        }
+        PS = CollAtUnchecked (&States, State);
+        if ((PS->Groups & Groups) == 0) {
+            break;
+        }
+        ++N;
+
+        /* Try the patterns that are complete now */
+        for (I = 0; I < CollCount (&PS->Accept); ++I) {
+            const Pattern* P = CollAtUnchecked (&PS->Accept, I);
+            if ((PAT_GROUP (P->Def->Group) & Groups) != 0 && MatchInsns (P, L)) {
+                unsigned C;
+                if ((P->Def->Flags & PF_REGINFO) != 0 && *Stale) {
+                    CS_GenRegInfo (S);
+                    *Stale = 0;
+                }
+                C = P->Def->Apply (S, Index, L);
+                if (C) {
+                    Changes[P->Def->Group] += C;
+                    *Stale = 1;
+                    return C;
+                }
+            }
+        }
+    }
+
+    /* No match */
+    return 0;
+}
+
+
+
+unsigned CS_ApplyPatterns (CodeSeg* S, unsigned long Groups, unsigned* Changes)
+/* Walk once over the code segment and apply the patterns of all groups in
+** the Groups mask. At each position, shorter patterns are tried before
+** longer ones, and patterns of the same length in the order of their
+** definition. The number of changes for each group is stored in Changes,
+** which must have PAT_GROUP_COUNT entries. Return the total number of
+** changes.
+*/
+{
+    unsigned I;
+    unsigned Total = 0;
+    int      Stale = 0;
+
+    /* No changes so far */
+    memset (Changes, 0, PAT_GROUP_COUNT * sizeof (Changes[0]));
+
+    /* Walk over the entries */
+    I = 0;
+    while (I < CS_GetEntryCount (S)) {
+
+        /* Try the patterns at this position */
+        Total += MatchAt (S, I, Groups, Changes, &Stale);
+
+        /* Next entry */
+        ++I;
+
+    }
+
+    /* Return the number of changes made */
+    return Total;
+}
+
+
+
+unsigned CS_ApplyPatternGroup (CodeSeg* S, unsigned Group)
+/* Walk once over the code segment and apply the patterns of one group.
+** Return the number of changes.
+*/
+{
+    unsigned Changes[PAT_GROUP_COUNT];
+    return CS_ApplyPatterns (S, PAT_GROUP (Group), Changes);
+}
@@ -0,0 +1,139 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 coptpat.h                                 */
+/*                                                                           */
+/*                      Pattern based peephole optimizer                     */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef COPTPAT_H
+#define COPTPAT_H
+
+
+
+/* cc65 */
+#include "codeent.h"
+#include "codeseg.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Pattern groups. Each group contains the patterns of one optimizer step. */
+enum {
+    PAT_BNEGA1,
+    PAT_BNEGA2,
+    PAT_BNEGAX1,
+    PAT_BNEGAX2,
+    PAT_BNEGAX3,
+    PAT_BNEGAX4,
+    PAT_CMP1,
+    PAT_CMP2,
+    PAT_CMP7,
+    PAT_CMP9,
+    PAT_COMPLAX1,
+    PAT_NEGAX1,
+    PAT_NEGAX2,
+    PAT_STORELOAD,
+    PAT_SUB1,
+    PAT_TRANSFERS1,
+    PAT_GROUP_COUNT
+};
+
+/* Pattern flags */
+#define PF_NONE         0x00U
+#define PF_REGINFO      0x01U           /* Apply uses the register info */
+
+/* Maximum number of instructions in a pattern */
+#define PAT_MAX_INSNS   8
+
+/* A pattern describes a sequence of instructions. Insns is a list of
+** instructions separated by semicolons. Each instruction is written as
+**
+**      [@]mnemonic[|mnemonic...] [operand]
+**
+** A "*" in place of the mnemonics matches any opcode. The operand is either
+** missing (any operand), "#n" (an immediate numeric operand with the value
+** n, decimal or hex with a leading "$") or a symbol name that must match the
+** argument of the instruction. All instructions except the first must not
+** have a label, unless they're preceeded by an "@".
+**
+** If the sequence matches, Apply is called with the index of the first
+** instruction and the matched entries. It checks any remaining conditions,
+** replaces the code and returns the number of changes, or zero if it didn't
+** change anything. If the pattern has the PF_REGINFO flag, the register info
+** is brought up to date before Apply is called.
+*/
+typedef struct CodePattern CodePattern;
+struct CodePattern {
+    unsigned    Group;                  /* Pattern group */
+    const char* Insns;                  /* Instruction sequence */
+    unsigned    Flags;                  /* Pattern flags */
+    unsigned    (*Apply) (CodeSeg* S, unsigned I, CodeEntry** L);
+};
+
+/* Macro to create a group mask */
+#define PAT_GROUP(G)    (1UL << (G))
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void InitPatterns (void);
+/* Compile all patterns into one matcher. Must be called before the first use
+** of CS_ApplyPatterns and before any optimizer threads are started.
+*/
+
+unsigned CS_ApplyPatterns (CodeSeg* S, unsigned long Groups, unsigned* Changes);
+/* Walk once over the code segment and apply the patterns of all groups in
+** the Groups mask. At each position, shorter patterns are tried before
+** longer ones, and patterns of the same length in the order of their
+** definition. The number of changes for each group is stored in Changes,
+** which must have PAT_GROUP_COUNT entries. Return the total number of
+** changes.
+*/
+
+unsigned CS_ApplyPatternGroup (CodeSeg* S, unsigned Group);
+/* Walk once over the code segment and apply the patterns of one group.
+** Return the number of changes.
+*/
+
+
+
+/* End of coptpat.h */
+
+#endif
@@ -38,6 +38,7 @@
 /* common */
 #include "chartype.h"
 #include "strbuf.h"
+#include "thread.h"
 #include "xmalloc.h"
 #include "xsprintf.h"
 
@@ -137,7 +138,7 @@ static const char* LoadAXImm (CodeSeg* S, unsigned I)
 ** storage which is overwritten with each call.
 */
 {
-    static StrBuf Buf = STATIC_STRBUF_INITIALIZER;
+    static THREAD_LOCAL StrBuf Buf = STATIC_STRBUF_INITIALIZER;
     CodeEntry* L[2];
     CodeEntry* ALoad;
     CodeEntry* XLoad;
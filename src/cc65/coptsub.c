@@ -39,6 +39,7 @@
 /* cc65 */
 #include "codeent.h"
 #include "codeinfo.h"
+#include "coptpat.h"
 #include "coptsub.h"
 
 
@@ -49,6 +50,22 @@
 
 
 
+static unsigned ApplySub1 (CodeSeg* S, unsigned I, CodeEntry** L)
+/* Remove the bcs/dex if X is not used later */
+{
+    if (L[1]->JumpTo == 0 || L[1]->JumpTo->Owner != L[3] || RegXUsed (S, I+3)) {
+        return 0;
+    }
+
+    /* Remove the bcs/dex */
+    CS_DelEntries (S, I+1, 2);
+
+    /* Remember, we had changes */
+    return 1;
+}
+
+
+
 unsigned OptSub1 (CodeSeg* S)
 /* Search for the sequence
 **
@@ -60,43 +77,7 @@ unsigned OptSub1 (CodeSeg* S)
 ** and remove the handling of the high byte if X is not used later.
 */
 {
-    unsigned Changes = 0;
-
-    /* Walk over the entries */
-    unsigned I = 0;
-    while (I < CS_GetEntryCount (S)) {
-
-        CodeEntry* L[3];
-
-        /* Get next entry */
-        CodeEntry* E = CS_GetEntry (S, I);
-
-        /* Check for the sequence */
-        if (E->OPC == OP65_SBC                               &&
-            CS_GetEntries (S, L, I+1, 3)                     &&
-            (L[0]->OPC == OP65_BCS || L[0]->OPC == OP65_JCS) &&
-            L[0]->JumpTo != 0                                &&
-            !CE_HasLabel (L[0])                              &&
-            L[1]->OPC == OP65_DEX                            &&
-            !CE_HasLabel (L[1])                              &&
-            L[0]->JumpTo->Owner == L[2]                      &&
-            !RegXUsed (S, I+3)) {
-
-            /* Remove the bcs/dex */
-            CS_DelEntries (S, I+1, 2);
-
-            /* Remember, we had changes */
-            ++Changes;
-
-        }
-
-        /* Next entry */
-        ++I;
-
-    }
-
-    /* Return the number of changes made */
-    return Changes;
+    return CS_ApplyPatternGroup (S, PAT_SUB1);
 }
 
 
@@ -228,3 +209,21 @@ unsigned OptSub3 (CodeSeg* S)
     /* Return the number of changes made */
     return Changes;
 }
+
+
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+const CodePattern SubPatterns[] = {
+    {
+        PAT_SUB1,
+        "sbc; bcs|jcs; dex; @*",
+        PF_NONE,
+        ApplySub1
+    },
+    { 0, 0, 0, 0 }
+};
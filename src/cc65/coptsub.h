@@ -40,6 +40,7 @@
 
 /* cc65 */
 #include "codeseg.h"
+#include "coptpat.h"
 
 
 
@@ -85,6 +86,18 @@ unsigned OptSub3 (CodeSeg* S);
 
 
 
+
+/*****************************************************************************/
+/*                                 Patterns                                  */
+/*****************************************************************************/
+
+
+
+extern const CodePattern SubPatterns[];
+/* Patterns used by the optimizer steps above */
+
+
+
 /* End of coptsub.h */
 
 #endif
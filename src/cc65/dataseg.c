@@ -41,6 +41,7 @@
 /* cc65 */
 #include "dataseg.h"
 #include "error.h"
+#include "global.h"
 #include "output.h"
 
 
@@ -119,8 +120,14 @@ void DS_Output (const DataSeg* S)
         return;
     }
 
-    /* Output the segment directive */
-    WriteOutput (".segment\t\"%s\"\n\n", S->SegName);
+    /* Output the segment directive. Data owned by a function goes into the
+    ** sub-section of that function if --function-sections is active.
+    */
+    if (FunctionSections && S->Func) {
+        WriteOutput (".segment\t\"%s\", \"%s\"\n\n", S->SegName, S->Func->Name);
+    } else {
+        WriteOutput (".segment\t\"%s\"\n\n", S->SegName);
+    }
 
     /* Output all entries */
     for (I = 0; I < Count; ++I) {
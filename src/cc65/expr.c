@@ -1612,7 +1612,7 @@ static void PostInc (ExprDesc* Expr)
     if ((Flags & CF_CHAR) == CF_CHAR && ED_IsLocConst(Expr)) {
 
         LoadExpr (CF_NONE, Expr);
-        AddCodeLine ("inc %s", ED_GetLabelName(Expr, 0));
+        AddCodeArg (OP65_INC, AM65_ABS, "%s", ED_GetLabelName(Expr, 0));
 
     } else {
 
@@ -1668,7 +1668,7 @@ static void PostDec (ExprDesc* Expr)
     if ((Flags & CF_CHAR) == CF_CHAR && ED_IsLocConst(Expr)) {
 
         LoadExpr (CF_NONE, Expr);
-        AddCodeLine ("dec %s", ED_GetLabelName(Expr, 0));
+        AddCodeArg (OP65_DEC, AM65_ABS, "%s", ED_GetLabelName(Expr, 0));
 
     } else {
 
@@ -48,6 +48,9 @@ unsigned char AutoCDecl         = 0;    /* Make functions default to __cdecl__ *
 unsigned char DebugInfo         = 0;    /* Add debug info to the obj */
 unsigned char PreprocessOnly    = 0;    /* Just preprocess the input */
 unsigned char DebugOptOutput    = 0;    /* Output debug stuff */
+unsigned char DebugOptRegInfo   = 0;    /* Verify incremental reg info */
+unsigned char FunctionSections  = 0;    /* Emit functions in sub-sections */
+unsigned      OptimizerJobs     = 1;    /* Number of optimizer threads */
 unsigned      RegisterSpace     = 6;    /* Space available for register vars */
 
 /* Stackable options */
@@ -66,6 +69,8 @@ IntStack CodeSizeFactor     = INTSTACK(100);/* Size factor for generated code */
 IntStack DataAlignment      = INTSTACK(1);  /* Alignment for data */
 
 /* File names */
-StrBuf DepName     = STATIC_STRBUF_INITIALIZER; /* Name of dependencies file */
-StrBuf FullDepName = STATIC_STRBUF_INITIALIZER; /* Name of full dependencies file */
-StrBuf DepTarget   = STATIC_STRBUF_INITIALIZER; /* Name of dependency target */
+StrBuf DepName       = STATIC_STRBUF_INITIALIZER; /* Name of dependencies file */
+StrBuf FullDepName   = STATIC_STRBUF_INITIALIZER; /* Name of full dependencies file */
+StrBuf DepTarget     = STATIC_STRBUF_INITIALIZER; /* Name of dependency target */
+StrBuf CreatePCHName = STATIC_STRBUF_INITIALIZER; /* Name of precompiled header to create */
+StrBuf UsePCHName    = STATIC_STRBUF_INITIALIZER; /* Name of precompiled header to use */
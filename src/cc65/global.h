@@ -56,6 +56,9 @@ extern unsigned char    AutoCDecl;              /* Make functions default to __c
 extern unsigned char    DebugInfo;              /* Add debug info to the obj */
 extern unsigned char    PreprocessOnly;         /* Just preprocess the input */
 extern unsigned char    DebugOptOutput;         /* Output debug stuff */
+extern unsigned char    DebugOptRegInfo;        /* Verify incremental reg info */
+extern unsigned char    FunctionSections;       /* Emit functions in sub-sections */
+extern unsigned         OptimizerJobs;          /* Number of optimizer threads */
 extern unsigned         RegisterSpace;          /* Space available for register vars */
 
 /* Stackable options */
@@ -77,6 +80,8 @@ extern IntStack         DataAlignment;          /* Alignment for data */
 extern StrBuf           DepName;                /* Name of dependencies file */
 extern StrBuf           FullDepName;            /* Name of full dependencies file */
 extern StrBuf           DepTarget;              /* Name of dependency target */
+extern StrBuf           CreatePCHName;          /* Name of precompiled header to create */
+extern StrBuf           UsePCHName;             /* Name of precompiled header to use */
 
 
 
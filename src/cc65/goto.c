@@ -104,28 +104,28 @@ void GotoStatement (void)
                 NextToken ();
 
                 if (CPUIsets[CPU] & CPU_ISET_65SC02) {
-                    AddCodeLine ("ldx #$%02X", val * 2);
-                    AddCodeLine ("jmp (.loword(%s),x)", arr->AsmName);
+                    AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", val * 2);
+                    AddCodeArg (OP65_JMP, AM65_ZPX_IND, ".loword(%s)", arr->AsmName);
                 } else {
-                    AddCodeLine ("ldy #$%02X", val * 2);
-                    AddCodeLine ("lda %s,y", arr->AsmName);
-                    AddCodeLine ("ldx %s+1,y", arr->AsmName);
-                    AddCodeLine ("jmp callax");
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", val * 2);
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", arr->AsmName);
+                    AddCodeArg (OP65_LDX, AM65_ABSY, "%s+1", arr->AsmName);
+                    AddCodeArg (OP65_JMP, AM65_BRA, "callax");
                 }
             } else if (CurTok.Tok == TOK_IDENT &&
                        (idx = FindSym (CurTok.Ident))) {
                 hie10 (&desc);
                 LoadExpr (CF_NONE, &desc);
-                AddCodeLine ("asl a");
+                AddCodeImp (OP65_ASL);
 
                 if (CPUIsets[CPU] & CPU_ISET_65SC02) {
-                    AddCodeLine ("tax");
-                    AddCodeLine ("jmp (.loword(%s),x)", arr->AsmName);
+                    AddCodeImp (OP65_TAX);
+                    AddCodeArg (OP65_JMP, AM65_ZPX_IND, ".loword(%s)", arr->AsmName);
                 } else {
-                    AddCodeLine ("tay");
-                    AddCodeLine ("lda %s,y", arr->AsmName);
-                    AddCodeLine ("ldx %s+1,y", arr->AsmName);
-                    AddCodeLine ("jmp callax");
+                    AddCodeImp (OP65_TAY);
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", arr->AsmName);
+                    AddCodeArg (OP65_LDX, AM65_ABSY, "%s+1", arr->AsmName);
+                    AddCodeArg (OP65_JMP, AM65_BRA, "callax");
                 }
             } else {
                 Error ("Only simple expressions are supported for computed goto");
@@ -44,6 +44,7 @@
 #include "fname.h"
 #include "print.h"
 #include "strbuf.h"
+#include "textfile.h"
 #include "xmalloc.h"
 
 /* cc65 */
@@ -54,6 +55,7 @@
 #include "input.h"
 #include "lineinfo.h"
 #include "output.h"
+#include "pch.h"
 
 
 
@@ -88,7 +90,7 @@ struct IFile {
 typedef struct AFile AFile;
 struct AFile {
     unsigned    Line;           /* Line number for this file */
-    FILE*       F;              /* Input file stream */
+    TextFile*   F;              /* Input file */
     IFile*      Input;          /* Points to corresponding IFile */
     int         SearchPath;     /* True if we've added a path for this file */
 };
@@ -142,7 +144,7 @@ static IFile* NewIFile (const char* Name, InputType Type)
 
 
 
-static AFile* NewAFile (IFile* IF, FILE* F)
+static AFile* NewAFile (IFile* IF, TextFile* F)
 /* Create a new AFile, push it onto the stack, add the path of the file to
 ** the path search list, and finally return a pointer to the new AFile struct.
 */
@@ -248,7 +250,7 @@ void OpenMainFile (const char* Name)
     IFile* IF = NewIFile (Name, IT_MAIN);
 
     /* Open the file for reading */
-    FILE* F = fopen (Name, "r");
+    TextFile* F = OpenTextFile (Name);
     if (F == 0) {
         /* Cannot open */
         Fatal ("Cannot open input file '%s': %s", Name, strerror (errno));
@@ -271,9 +273,9 @@ void OpenMainFile (const char* Name)
 void OpenIncludeFile (const char* Name, InputType IT)
 /* Open an include file and insert it into the tables. */
 {
-    char*  N;
-    FILE*  F;
-    IFile* IF;
+    char*     N;
+    TextFile* F;
+    IFile*    IF;
 
     /* Check for the maximum include nesting */
     if (CollCount (&AFiles) > MAX_INC_NESTING) {
@@ -288,6 +290,12 @@ void OpenIncludeFile (const char* Name, InputType IT)
         return;
     }
 
+    /* The first #include may be replaced by a precompiled header */
+    if (UsePCH (N, IT)) {
+        xfree (N);
+        return;
+    }
+
     /* Search the list of all input files for this file. If we don't find
     ** it, create a new IFile object.
     */
@@ -300,7 +308,7 @@ void OpenIncludeFile (const char* Name, InputType IT)
     xfree (N);
 
     /* Open the file */
-    F = fopen (IF->Name, "r");
+    F = OpenTextFile (IF->Name);
     if (F == 0) {
         /* Error opening the file */
         PPError ("Cannot open include file '%s': %s", IF->Name, strerror (errno));
@@ -332,8 +340,8 @@ static void CloseIncludeFile (void)
     /* Get the current active input file */
     Input = (AFile*) CollLast (&AFiles);
 
-    /* Close the current input file (we're just reading so no error check) */
-    fclose (Input->F);
+    /* Close the current input file */
+    CloseTextFile (Input->F);
 
     /* Delete the last active file from the active file collection */
     CollDelete (&AFiles, AFileCount-1);
@@ -435,6 +443,20 @@ StrBuf* InitLine (StrBuf* Buf)
 
 
 
+static void AppendText (StrBuf* B, const char* Data, unsigned Len)
+/* Append text read from a file to B, ignoring embedded NULs */
+{
+    const char* NUL;
+    while ((NUL = memchr (Data, '\0', Len)) != 0) {
+        SB_AppendBuf (B, Data, NUL - Data);
+        Len -= NUL - Data + 1;
+        Data = NUL + 1;
+    }
+    SB_AppendBuf (B, Data, Len);
+}
+
+
+
 int NextLine (void)
 /* Get a line from the current input. Returns 0 on end of file. */
 {
@@ -449,14 +471,15 @@ int NextLine (void)
     }
     Input = CollLast (&AFiles);
 
-    /* Read characters until we have one complete line */
+    /* Read lines until we have one complete line */
     while (1) {
 
-        /* Read the next character */
-        int C = fgetc (Input->F);
+        /* Get the next line from the file */
+        unsigned Len;
+        const char* Data = TF_NextLine (Input->F, &Len);
 
         /* Check for EOF */
-        if (C == EOF) {
+        if (Data == 0) {
 
             /* Accept files without a newline at the end */
             if (SB_NotEmpty (Line)) {
@@ -477,34 +500,35 @@ int NextLine (void)
             continue;
         }
 
-        /* Check for end of line */
-        if (C == '\n') {
-
-            /* We got a new line */
-            ++Input->Line;
-
-            /* If the \n is preceeded by a \r, remove the \r, so we can read
-            ** DOS/Windows files under *nix.
-            */
-            if (SB_LookAtLast (Line) == '\r') {
-                SB_Drop (Line, 1);
-            }
-
-            /* If we don't have a line continuation character at the end,
-            ** we're done with this line. Otherwise replace the character
-            ** by a newline and continue reading.
+        /* Add the line to the buffer, ignoring embedded NULs */
+        if (Len > 0 && Data[Len-1] == '\n') {
+            AppendText (Line, Data, Len - 1);
+        } else {
+            /* Last line of the file without a newline. Go on, so we will
+            ** hit the end of the file above.
             */
-            if (SB_LookAtLast (Line) == '\\') {
-                Line->Buf[Line->Len-1] = '\n';
-            } else {
-                break;
-            }
+            AppendText (Line, Data, Len);
+            continue;
+        }
 
-        } else if (C != '\0') {         /* Ignore embedded NULs */
+        /* We got a new line */
+        ++Input->Line;
 
-            /* Just some character, add it to the line */
-            SB_AppendChar (Line, C);
+        /* If the \n is preceeded by a \r, remove the \r, so we can read
+        ** DOS/Windows files under *nix.
+        */
+        if (SB_LookAtLast (Line) == '\r') {
+            SB_Drop (Line, 1);
+        }
 
+        /* If we don't have a line continuation character at the end,
+        ** we're done with this line. Otherwise replace the character
+        ** by a newline and continue reading.
+        */
+        if (SB_LookAtLast (Line) == '\\') {
+            Line->Buf[Line->Len-1] = '\n';
+        } else {
+            break;
         }
     }
 
@@ -567,6 +591,82 @@ unsigned GetCurrentLine (void)
 
 
 
+void WriteInputFiles (void)
+/* Write the list of input files to a precompiled header */
+{
+    unsigned I;
+    PCHWriteVar (CollCount (&IFiles));
+    for (I = 0; I < CollCount (&IFiles); ++I) {
+        const IFile* IF = (const IFile*) CollAt (&IFiles, I);
+        PCHWriteStr (IF->Name);
+        PCHWriteVar (IF->Type);
+        PCHWriteVar (IF->Usage);
+        PCHWriteVar (IF->Size);
+        PCHWriteVar (IF->MTime);
+    }
+}
+
+
+
+const char* CheckInputFiles (void)
+/* Read the list of input files from a precompiled header, and check if they
+** have changed. Return the name of the first file that has changed, or NULL
+** if all files are unchanged.
+*/
+{
+    unsigned I;
+    unsigned Count = PCHReadVar ();
+    for (I = 0; I < Count; ++I) {
+        struct stat Buf;
+        const char*   Name = PCHReadStr ();
+        unsigned long Usage, Size, MTime;
+        (void) PCHReadVar ();
+        Usage = PCHReadVar ();
+        Size  = PCHReadVar ();
+        MTime = PCHReadVar ();
+        if (Usage > 0 && (FileStat (Name, &Buf) != 0                  ||
+                          (unsigned long) Buf.st_size  != Size        ||
+                          (unsigned long) Buf.st_mtime != MTime)) {
+            return Name;
+        }
+    }
+    return 0;
+}
+
+
+
+void ReadInputFiles (const char* Name, InputType Type)
+/* Read the list of input files from a precompiled header and add them to the
+** list of files used in this compilation. The main file of the header is
+** replaced by Name, which was included with the given type.
+*/
+{
+    unsigned I;
+    unsigned Count = PCHReadVar ();
+    for (I = 0; I < Count; ++I) {
+
+        /* Create the file entry */
+        IFile* IF;
+        const char* FileName = PCHReadStr ();
+        InputType FileType = (InputType) PCHReadVar ();
+        if (I == 0) {
+            IF = NewIFile (Name, Type);
+        } else {
+            IF = NewIFile (FileName, FileType);
+        }
+        IF->Usage = PCHReadVar ();
+        IF->Size  = PCHReadVar ();
+        IF->MTime = PCHReadVar ();
+
+        /* Output debug info for files that were read */
+        if (IF->Usage > 0) {
+            g_fileinfo (IF->Name, IF->Size, IF->MTime);
+        }
+    }
+}
+
+
+
 static void WriteEscaped (FILE* F, const char* Name)
 /* Write a file name to a dependency file escaping spaces */
 {
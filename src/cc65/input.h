@@ -110,6 +110,21 @@ const char* GetCurrentFile (void);
 unsigned GetCurrentLine (void);
 /* Return the line number in the current input file */
 
+void WriteInputFiles (void);
+/* Write the list of input files to a precompiled header */
+
+const char* CheckInputFiles (void);
+/* Read the list of input files from a precompiled header, and check if they
+** have changed. Return the name of the first file that has changed, or NULL
+** if all files are unchanged.
+*/
+
+void ReadInputFiles (const char* Name, InputType Type);
+/* Read the list of input files from a precompiled header and add them to the
+** list of files used in this compilation. The main file of the header is
+** replaced by Name, which was included with the given type.
+*/
+
 void CreateDependencies (void);
 /* Create dependency files requested by the user */
 
@@ -38,6 +38,7 @@
 /* common */
 #include "chartype.h"
 #include "check.h"
+#include "thread.h"
 #include "xmalloc.h"
 
 /* cc65 */
@@ -126,7 +127,7 @@ LineInfo* UseLineInfo (LineInfo* LI)
 /* Increase the reference count of the given line info and return it. */
 {
     CHECK (LI != 0);
-    ++LI->RefCount;
+    AtomicInc (&LI->RefCount);
     return LI;
 }
 
@@ -137,8 +138,15 @@ void ReleaseLineInfo (LineInfo* LI)
 ** reference count drops to zero.
 */
 {
-    CHECK (LI && LI->RefCount > 0);
-    if (--LI->RefCount == 0) {
+    unsigned RefCount;
+
+    /* Check the count after decrementing it, since other threads may use
+    ** the same line info.
+    */
+    CHECK (LI != 0);
+    RefCount = AtomicDec (&LI->RefCount);
+    CHECK (RefCount != (unsigned) -1);
+    if (RefCount == 0) {
         /* No more references, free it */
         FreeLineInfo (LI);
     }
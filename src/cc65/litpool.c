@@ -49,6 +49,7 @@
 #include "error.h"
 #include "global.h"
 #include "litpool.h"
+#include "pch.h"
 
 
 
@@ -460,6 +461,65 @@ void OutputGlobalLiteralPool (void)
 
 
 
+static void WriteLiterals (const Collection* Literals)
+/* Write a collection of literals to a precompiled header */
+{
+    unsigned I;
+
+    PCHWriteVar (CollCount (Literals));
+    for (I = 0; I < CollCount (Literals); ++I) {
+        const Literal* L = CollConstAt (Literals, I);
+        PCHWriteVar (L->Label);
+        PCHWriteVar (L->RefCount);
+        PCHWriteVar (L->Output);
+        PCHWriteBuf (&L->Data);
+    }
+}
+
+
+
+static void ReadLiterals (Collection* Literals)
+/* Read a collection of literals from a precompiled header */
+{
+    unsigned Count = PCHReadVar ();
+    while (Count--) {
+        /* Don't use NewLiteral, since the label is already allocated */
+        Literal* L = xmalloc (sizeof (*L));
+        L->Label    = PCHReadVar ();
+        L->RefCount = PCHReadVar ();
+        L->Output   = PCHReadVar ();
+        SB_Init (&L->Data);
+        PCHReadBuf (&L->Data);
+        CollAppend (Literals, L);
+    }
+}
+
+
+
+void WriteLiteralPool (void)
+/* Write the global literal pool to a precompiled header. Unreferenced
+** literals are written too, since they affect the order of the output.
+*/
+{
+    PRECONDITION (LP == GlobalPool);
+    WriteLiterals (&GlobalPool->WritableLiterals);
+    WriteLiterals (&GlobalPool->ReadOnlyLiterals);
+}
+
+
+
+void ReadLiteralPool (void)
+/* Read the global literal pool from a precompiled header */
+{
+    PRECONDITION (LP == GlobalPool &&
+                  CollCount (&GlobalPool->WritableLiterals) == 0 &&
+                  CollCount (&GlobalPool->ReadOnlyLiterals) == 0);
+    ReadLiterals (&GlobalPool->WritableLiterals);
+    ReadLiterals (&GlobalPool->ReadOnlyLiterals);
+}
+
+
+
 Literal* AddLiteral (const char* S)
 /* Add a literal string to the literal pool. Return the literal. */
 {
@@ -119,6 +119,14 @@ void OutputLocalLiteralPool (LiteralPool* Pool);
 void OutputGlobalLiteralPool (void);
 /* Output the global literal pool */
 
+void WriteLiteralPool (void);
+/* Write the global literal pool to a precompiled header. Unreferenced
+** literals are written too, since they affect the order of the output.
+*/
+
+void ReadLiteralPool (void);
+/* Read the global literal pool from a precompiled header */
+
 Literal* AddLiteral (const char* S);
 /* Add a literal string to the literal pool. Return the literal. */
 
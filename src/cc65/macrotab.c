@@ -43,6 +43,7 @@
 /* cc65 */
 #include "error.h"
 #include "macrotab.h"
+#include "pch.h"
 
 
 
@@ -58,6 +59,50 @@ static Macro* MacroTab[MACRO_TAB_SIZE];
 
 
 
+/*****************************************************************************/
+/*                                  helpers                                  */
+/*****************************************************************************/
+
+
+
+static int IsTimeMacro (const Macro* M)
+/* Return true if this is one of the macros that are defined anew by each
+** compilation, and are therefore not part of a precompiled header.
+*/
+{
+    return (strcmp (M->Name, "__DATE__") == 0 || strcmp (M->Name, "__TIME__") == 0);
+}
+
+
+
+static void WriteMacroChain (const Macro* M)
+/* Write a hash chain to a precompiled header. The chain is written in
+** reverse order, so inserting the macros when reading restores the order.
+*/
+{
+    unsigned I;
+
+    if (M == 0) {
+        return;
+    }
+    WriteMacroChain (M->Next);
+    if (IsTimeMacro (M)) {
+        return;
+    }
+
+    PCHWriteStr (M->Name);
+    PCHWriteVar (M->ArgCount + 1);
+    PCHWriteVar (M->MaxArgs);
+    PCHWriteVar (CollCount (&M->FormalArgs));
+    for (I = 0; I < CollCount (&M->FormalArgs); ++I) {
+        PCHWriteStr (CollConstAt (&M->FormalArgs, I));
+    }
+    PCHWriteBuf (&M->Replacement);
+    PCHWriteVar (M->Variadic);
+}
+
+
+
 /*****************************************************************************/
 /*                                   code                                    */
 /*****************************************************************************/
@@ -281,6 +326,67 @@ int MacroCmp (const Macro* M1, const Macro* M2)
 
 
 
+void WriteMacroTab (void)
+/* Write all macros to a precompiled header */
+{
+    unsigned I;
+    unsigned Count = 0;
+    const Macro* M;
+
+    for (I = 0; I < MACRO_TAB_SIZE; ++I) {
+        for (M = MacroTab[I]; M; M = M->Next) {
+            if (!IsTimeMacro (M)) {
+                ++Count;
+            }
+        }
+    }
+    PCHWriteVar (Count);
+    for (I = 0; I < MACRO_TAB_SIZE; ++I) {
+        WriteMacroChain (MacroTab[I]);
+    }
+}
+
+
+
+void ReadMacroTab (void)
+/* Replace all macros by the ones from a precompiled header */
+{
+    unsigned I, J;
+    unsigned Count;
+
+    /* Delete the existing macros */
+    for (I = 0; I < MACRO_TAB_SIZE; ++I) {
+        Macro** L = &MacroTab[I];
+        while (*L) {
+            Macro* M = *L;
+            if (IsTimeMacro (M)) {
+                L = &M->Next;
+            } else {
+                *L = M->Next;
+                FreeMacro (M);
+            }
+        }
+    }
+
+    /* Read the macros from the file */
+    Count = PCHReadVar ();
+    for (I = 0; I < Count; ++I) {
+        unsigned ArgCount;
+        Macro* M = NewMacro (PCHReadStr ());
+        M->ArgCount = (int) PCHReadVar () - 1;
+        M->MaxArgs  = PCHReadVar ();
+        ArgCount    = PCHReadVar ();
+        for (J = 0; J < ArgCount; ++J) {
+            CollAppend (&M->FormalArgs, xstrdup (PCHReadStr ()));
+        }
+        PCHReadBuf (&M->Replacement);
+        M->Variadic = (unsigned char) PCHReadVar ();
+        InsertMacro (M);
+    }
+}
+
+
+
 void PrintMacroStats (FILE* F)
 /* Print macro statistics to the given text file. */
 {
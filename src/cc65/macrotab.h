@@ -121,6 +121,12 @@ void AddMacroArg (Macro* M, const char* Arg);
 int MacroCmp (const Macro* M1, const Macro* M2);
 /* Compare two macros and return zero if both are identical. */
 
+void WriteMacroTab (void);
+/* Write all macros to a precompiled header */
+
+void ReadMacroTab (void);
+/* Replace all macros by the ones from a precompiled header */
+
 void PrintMacroStats (FILE* F);
 /* Print macro statistics to the given text file. */
 
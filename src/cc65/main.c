@@ -64,6 +64,7 @@
 #include "input.h"
 #include "macrotab.h"
 #include "output.h"
+#include "pch.h"
 #include "scanner.h"
 #include "segments.h"
 #include "standard.h"
@@ -112,21 +113,26 @@ static void Usage (void)
             "  --cpu type\t\t\tSet cpu type (6502, 65c02)\n"
             "  --create-dep name\t\tCreate a make dependency file\n"
             "  --create-full-dep name\tCreate a full make dependency file\n"
+            "  --create-pch name\t\tCreate a precompiled header\n"
             "  --data-name seg\t\tSet the name of the DATA segment\n"
             "  --debug\t\t\tDebug mode\n"
             "  --debug-info\t\t\tAdd debug info to object file\n"
             "  --debug-opt name\t\tDebug optimization steps\n"
             "  --debug-opt-output\t\tDebug output of each optimization step\n"
+            "  --debug-opt-reginfo\t\tVerify register info of each optimization step\n"
             "  --dep-target target\t\tUse this dependency target\n"
             "  --disable-opt name\t\tDisable an optimization step\n"
             "  --eagerly-inline-funcs\tEagerly inline some known functions\n"
             "  --enable-opt name\t\tEnable an optimization step\n"
+            "  --function-sections\t\tPlace each function in its own section\n"
             "  --help\t\t\tHelp (this text)\n"
             "  --include-dir dir\t\tSet an include directory search path\n"
             "  --inline-stdfuncs\t\tInline some standard functions\n"
+            "  --jobs n\t\t\tRun the optimizer in n threads\n"
             "  --list-opt-steps\t\tList all optimizer steps and exit\n"
             "  --list-warnings\t\tList available warning types for -W\n"
             "  --local-strings\t\tEmit string literals immediately\n"
+            "  --mem-stats\t\t\tPrint memory statistics\n"
             "  --memory-model model\t\tSet the memory model\n"
             "  --register-space b\t\tSet space available for register variables\n"
             "  --register-vars\t\tEnable register variables\n"
@@ -135,6 +141,7 @@ static void Usage (void)
             "  --standard std\t\tLanguage standard (c89, c99, cc65)\n"
             "  --static-locals\t\tMake local variables static\n"
             "  --target sys\t\t\tSet the target system\n"
+            "  --use-pch name\t\tUse a precompiled header\n"
             "  --verbose\t\t\tIncrease verbosity\n"
             "  --version\t\t\tPrint the compiler version number\n"
             "  --writable-strings\t\tMake string literals writable\n",
@@ -457,6 +464,14 @@ static void OptCreateFullDep (const char* Opt attribute ((unused)),
 
 
 
+static void OptCreatePCH (const char* Opt, const char* Arg)
+/* Handle the --create-pch option */
+{
+    FileNameOption (Opt, Arg, &CreatePCHName);
+}
+
+
+
 static void OptCPU (const char* Opt, const char* Arg)
 /* Handle the --cpu option */
 {
@@ -576,6 +591,15 @@ static void OptDebugOptOutput (const char* Opt attribute ((unused)),
 
 
 
+static void OptDebugOptRegInfo (const char* Opt attribute ((unused)),
+                                const char* Arg attribute ((unused)))
+/* Verify the register info after each optimization step */
+{
+    DebugOptRegInfo = 1;
+}
+
+
+
 static void OptDepTarget (const char* Opt attribute ((unused)), const char* Arg)
 /* Handle the --dep-target option */
 {
@@ -629,6 +653,15 @@ static void OptIncludeDir (const char* Opt attribute ((unused)), const char* Arg
 
 
 
+static void OptFunctionSections (const char* Opt attribute ((unused)),
+                                 const char* Arg attribute ((unused)))
+/* Place each function in its own section */
+{
+    FunctionSections = 1;
+}
+
+
+
 static void OptInlineStdFuncs (const char* Opt attribute((unused)),
                                const char* Arg attribute((unused)))
 /* Inline some standard functions */
@@ -638,6 +671,22 @@ static void OptInlineStdFuncs (const char* Opt attribute((unused)),
 
 
 
+static void OptJobs (const char* Opt, const char* Arg)
+/* Handle the --jobs option */
+{
+    unsigned Jobs;
+    char     BoundsCheck;
+
+    /* Numeric argument expected */
+    if (sscanf (Arg, "%u%c", &Jobs, &BoundsCheck) != 1 ||
+        Jobs < 1 || Jobs > 256) {
+        AbEnd ("Argument for %s is invalid", Opt);
+    }
+    OptimizerJobs = Jobs;
+}
+
+
+
 static void OptListOptSteps (const char* Opt attribute ((unused)),
                              const char* Arg attribute ((unused)))
 /* List all optimizer steps */
@@ -673,6 +722,15 @@ static void OptLocalStrings (const char* Opt attribute ((unused)),
 
 
 
+static void OptMemStats (const char* Opt attribute ((unused)),
+                        const char* Arg attribute ((unused)))
+/* Print memory statistics when done */
+{
+    MemStats = 1;
+}
+
+
+
 static void OptMemoryModel (const char* Opt, const char* Arg)
 /* Set the memory model */
 {
@@ -771,6 +829,14 @@ static void OptTarget (const char* Opt attribute ((unused)), const char* Arg)
 
 
 
+static void OptUsePCH (const char* Opt, const char* Arg)
+/* Handle the --use-pch option */
+{
+    FileNameOption (Opt, Arg, &UsePCHName);
+}
+
+
+
 static void OptVerbose (const char* Opt attribute ((unused)),
                         const char* Arg attribute ((unused)))
 /* Increase verbosity */
@@ -858,21 +924,26 @@ int main (int argc, char* argv[])
         { "--cpu",                  1,      OptCPU                  },
         { "--create-dep",           1,      OptCreateDep            },
         { "--create-full-dep",      1,      OptCreateFullDep        },
+        { "--create-pch",           1,      OptCreatePCH            },
         { "--data-name",            1,      OptDataName             },
         { "--debug",                0,      OptDebug                },
         { "--debug-info",           0,      OptDebugInfo            },
         { "--debug-opt",            1,      OptDebugOpt             },
         { "--debug-opt-output",     0,      OptDebugOptOutput       },
+        { "--debug-opt-reginfo",    0,      OptDebugOptRegInfo      },
         { "--dep-target",           1,      OptDepTarget            },
         { "--disable-opt",          1,      OptDisableOpt           },
         { "--eagerly-inline-funcs", 0,      OptEagerlyInlineFuncs   },
         { "--enable-opt",           1,      OptEnableOpt            },
+        { "--function-sections",    0,      OptFunctionSections     },
         { "--help",                 0,      OptHelp                 },
         { "--include-dir",          1,      OptIncludeDir           },
         { "--inline-stdfuncs",      0,      OptInlineStdFuncs       },
+        { "--jobs",                 1,      OptJobs                 },
         { "--list-opt-steps",       0,      OptListOptSteps         },
         { "--list-warnings",        0,      OptListWarnings         },
         { "--local-strings",        0,      OptLocalStrings         },
+        { "--mem-stats",            0,      OptMemStats             },
         { "--memory-model",         1,      OptMemoryModel          },
         { "--register-space",       1,      OptRegisterSpace        },
         { "--register-vars",        0,      OptRegisterVars         },
@@ -881,6 +952,7 @@ int main (int argc, char* argv[])
         { "--standard",             1,      OptStandard             },
         { "--static-locals",        0,      OptStaticLocals         },
         { "--target",               1,      OptTarget               },
+        { "--use-pch",              1,      OptUsePCH               },
         { "--verbose",              0,      OptVerbose              },
         { "--version",              0,      OptVersion              },
         { "--writable-strings",     0,      OptWritableStrings      },
@@ -1064,7 +1136,15 @@ int main (int argc, char* argv[])
     Compile (InputFile);
 
     /* Create the output file if we didn't had any errors */
-    if (PreprocessOnly == 0 && (ErrorCount == 0 || Debug)) {
+    if (PreprocessOnly == 0 && SB_NotEmpty (&CreatePCHName)) {
+
+        /* Write the precompiled header instead of assembler output */
+        if (ErrorCount == 0) {
+            WritePCH (InputFile);
+            CreateDependencies ();
+        }
+
+    } else if (PreprocessOnly == 0 && (ErrorCount == 0 || Debug)) {
 
         /* Emit literals, externals, do cleanup and optimizations */
         FinishCompile ();
@@ -1083,6 +1163,11 @@ int main (int argc, char* argv[])
         CreateDependencies ();
     }
 
+    /* Print memory statistics if requested */
+    if (MemStats) {
+        PrintMemStats (stdout);
+    }
+
     /* Return an apropriate exit code */
     return (ErrorCount > 0)? EXIT_FAILURE : EXIT_SUCCESS;
 }
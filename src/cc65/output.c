@@ -61,7 +61,7 @@
 const char* OutputFilename = 0;
 
 /* Output file handle */
-FILE* OutputFile = 0;
+THREAD_LOCAL FILE* OutputFile = 0;
 
 
 
@@ -99,10 +99,14 @@ void OpenOutputFile ()
     /* Output file must not be open and we must have a name*/
     PRECONDITION (OutputFile == 0 && OutputFilename != 0);
 
-    /* Open the file */
-    OutputFile = fopen (OutputFilename, "w");
-    if (OutputFile == 0) {
-        Fatal ("Cannot open output file '%s': %s", OutputFilename, strerror (errno));
+    /* Open the file. A name of "-" means stdout. */
+    if (strcmp (OutputFilename, "-") == 0) {
+        OutputFile = stdout;
+    } else {
+        OutputFile = fopen (OutputFilename, "w");
+        if (OutputFile == 0) {
+            Fatal ("Cannot open output file '%s': %s", OutputFilename, strerror (errno));
+        }
     }
     Print (stdout, 1, "Opened output file '%s'\n", OutputFilename);
 }
@@ -133,8 +137,12 @@ void CloseOutputFile ()
     /* Output file must be open */
     PRECONDITION (OutputFile != 0);
 
-    /* Close the file, check for errors */
-    if (fclose (OutputFile) != 0) {
+    /* Close the file, check for errors. stdout is flushed but not closed. */
+    if (OutputFile == stdout) {
+        if (fflush (OutputFile) != 0 || ferror (OutputFile)) {
+            Fatal ("Cannot write to output file: %s", strerror (errno));
+        }
+    } else if (fclose (OutputFile) != 0) {
         remove (OutputFilename);
         Fatal ("Cannot write to output file (disk full?)");
     }
@@ -42,6 +42,7 @@
 
 /* common */
 #include "attrib.h"
+#include "thread.h"
 
 
 
@@ -54,8 +55,10 @@
 /* Name of the output file. Dynamically allocated and read only. */
 extern const char* OutputFilename;
 
-/* Output file handle. Use WriteOutput if possible. Read only. */
-extern FILE* OutputFile;
+/* Output file handle. Use WriteOutput if possible. Read only. Each thread has
+** its own, so optimizer threads may write separate debug output files.
+*/
+extern THREAD_LOCAL FILE* OutputFile;
 
 
 
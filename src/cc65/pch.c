@@ -0,0 +1,567 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                   pch.c                                   */
+/*                                                                           */
+/*                         Precompiled header support                        */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+/* common */
+#include "cpu.h"
+#include "filemap.h"
+#include "filestat.h"
+#include "fname.h"
+#include "intstack.h"
+#include "mmodel.h"
+#include "print.h"
+#include "target.h"
+#include "tgttrans.h"
+#include "version.h"
+#include "xmalloc.h"
+
+/* cc65 */
+#include "anonname.h"
+#include "asmlabel.h"
+#include "error.h"
+#include "global.h"
+#include "incpath.h"
+#include "litpool.h"
+#include "macrotab.h"
+#include "pch.h"
+#include "segments.h"
+#include "standard.h"
+#include "symtab.h"
+#include "wrappedcall.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* File format identification */
+static const char PCHMagic[] = "cc65 pch\n";
+#define PCH_VERSION     1U
+
+/* Option stacks that may be changed by #pragma */
+static IntStack* const PragmaStacks[] = {
+    &WritableStrings,
+    &LocalStrings,
+    &InlineStdFuncs,
+    &EagerlyInlineFuncs,
+    &EnableRegVars,
+    &AllowRegVarAddr,
+    &RegVarsToCallStack,
+    &StaticLocals,
+    &SignedChars,
+    &CheckStack,
+    &Optimize,
+    &CodeSizeFactor,
+    &DataAlignment,
+    &WarnEnable,
+    &WarningsAreErrors,
+    &WarnConstComparison,
+    &WarnNoEffect,
+    &WarnRemapZero,
+    &WarnStructParam,
+    &WarnUnknownPragma,
+    &WarnUnusedLabel,
+    &WarnUnusedParam,
+    &WarnUnusedVar,
+};
+#define PRAGMA_STACK_COUNT  (sizeof (PragmaStacks) / sizeof (PragmaStacks[0]))
+
+/* Output buffer while writing */
+static StrBuf* Out = 0;
+
+/* The precompiled header in use, and the current read position */
+static MappedFile*          PCH     = 0;
+static const unsigned char* ReadPos = 0;
+static const unsigned char* ReadEnd = 0;
+
+/* Scratch buffer for PCHReadStr */
+static StrBuf ReadStrBuf = STATIC_STRBUF_INITIALIZER;
+
+/* The translation environment at the start of the compilation. A precompiled
+** header can only be used if it was created in the same environment.
+*/
+static StrBuf Config = STATIC_STRBUF_INITIALIZER;
+
+/* Data for the precompiled header to use */
+static int                  Pending     = 0;    /* Waiting for the first #include */
+static StrBuf               Reason      = STATIC_STRBUF_INITIALIZER;
+static char*                HeaderName  = 0;    /* Base name of the header */
+static unsigned long        HeaderSize  = 0;
+static unsigned long        HeaderMTime = 0;
+static const unsigned char* StatePos    = 0;    /* Start of the saved state */
+
+
+
+/*****************************************************************************/
+/*                             Reading and writing                           */
+/*****************************************************************************/
+
+
+
+void PCHWriteVar (unsigned long V)
+/* Write a variable sized value to the precompiled header */
+{
+    /* Write 7 bits at a time, the high bit flags that more bytes follow */
+    do {
+        unsigned char C = (V & 0x7F);
+        V >>= 7;
+        if (V) {
+            C |= 0x80;
+        }
+        SB_AppendChar (Out, C);
+    } while (V);
+}
+
+
+
+void PCHWriteStr (const char* S)
+/* Write a string to the precompiled header */
+{
+    unsigned Len = strlen (S);
+    PCHWriteVar (Len);
+    SB_AppendBuf (Out, S, Len);
+}
+
+
+
+void PCHWriteBuf (const StrBuf* B)
+/* Write the contents of a string buffer to the precompiled header */
+{
+    PCHWriteVar (SB_GetLen (B));
+    SB_Append (Out, B);
+}
+
+
+
+static void Corrupt (void)
+/* Bail out because the precompiled header has an invalid format */
+{
+    Fatal ("Precompiled header '%s' is corrupt", SB_GetConstBuf (&UsePCHName));
+}
+
+
+
+unsigned long PCHReadVar (void)
+/* Read a variable sized value from the precompiled header */
+{
+    unsigned long V = 0;
+    unsigned Shift = 0;
+    unsigned char C;
+    do {
+        if (ReadPos >= ReadEnd || Shift >= sizeof (V) * 8) {
+            Corrupt ();
+        }
+        C = *ReadPos++;
+        V |= ((unsigned long) (C & 0x7F)) << Shift;
+        Shift += 7;
+    } while (C & 0x80);
+    return V;
+}
+
+
+
+static const unsigned char* ReadData (unsigned long* Len)
+/* Read the length of a data block, skip the data and return a pointer to it */
+{
+    const unsigned char* Data;
+
+    *Len = PCHReadVar ();
+    if ((unsigned long) (ReadEnd - ReadPos) < *Len) {
+        Corrupt ();
+    }
+    Data = ReadPos;
+    ReadPos += *Len;
+    return Data;
+}
+
+
+
+const char* PCHReadStr (void)
+/* Read a string from the precompiled header. The string is placed in static
+** storage and overwritten by the next call.
+*/
+{
+    unsigned long Len;
+    const unsigned char* Data = ReadData (&Len);
+    SB_CopyBuf (&ReadStrBuf, (const char*) Data, Len);
+    SB_Terminate (&ReadStrBuf);
+    return SB_GetConstBuf (&ReadStrBuf);
+}
+
+
+
+void PCHReadBuf (StrBuf* B)
+/* Read the contents of a string buffer from the precompiled header */
+{
+    unsigned long Len;
+    const unsigned char* Data = ReadData (&Len);
+    SB_CopyBuf (B, (const char*) Data, Len);
+    SB_Terminate (B);
+}
+
+
+
+/*****************************************************************************/
+/*                               Compiler state                              */
+/*****************************************************************************/
+
+
+
+static void WriteSearchPath (SearchPaths* P)
+/* Write a search path list */
+{
+    unsigned I;
+    PCHWriteVar (CollCount (P));
+    for (I = 0; I < CollCount (P); ++I) {
+        PCHWriteStr (GetSearchPath (P, I));
+    }
+}
+
+
+
+static void WritePragmaStacks (void)
+/* Write the option stacks that may be changed by #pragma */
+{
+    unsigned I, J;
+    for (I = 0; I < PRAGMA_STACK_COUNT; ++I) {
+        const IntStack* S = PragmaStacks[I];
+        PCHWriteVar (S->Count);
+        for (J = 0; J < S->Count; ++J) {
+            PCHWriteVar ((unsigned long) S->Stack[J]);
+        }
+    }
+}
+
+
+
+static void ReadPragmaStacks (void)
+/* Read the option stacks that may be changed by #pragma */
+{
+    unsigned I, J;
+    for (I = 0; I < PRAGMA_STACK_COUNT; ++I) {
+        IntStack* S = PragmaStacks[I];
+        unsigned Count = PCHReadVar ();
+        if (Count > sizeof (S->Stack) / sizeof (S->Stack[0])) {
+            Corrupt ();
+        }
+        S->Count = Count;
+        for (J = 0; J < Count; ++J) {
+            S->Stack[J] = (long) PCHReadVar ();
+        }
+    }
+}
+
+
+
+static void WriteCharMap (void)
+/* Write the target character translation table */
+{
+    unsigned I;
+    for (I = 0; I < 256; ++I) {
+        PCHWriteVar ((unsigned char) TgtTranslateChar (I));
+    }
+}
+
+
+
+static void ReadCharMap (void)
+/* Read the target character translation table */
+{
+    unsigned I;
+    for (I = 0; I < 256; ++I) {
+        TgtTranslateSet (I, (unsigned char) PCHReadVar ());
+    }
+}
+
+
+
+static void WriteConfig (void)
+/* Write everything that affects the translation of a header but cannot be
+** changed by the header itself.
+*/
+{
+    PCHWriteVar (Target);
+    PCHWriteVar (CPU);
+    PCHWriteVar (MemoryModel);
+    PCHWriteVar (AutoCDecl);
+    PCHWriteVar (IS_Get (&Standard));
+    WriteSearchPath (SysIncSearchPath);
+    WriteSearchPath (UsrIncSearchPath);
+    WritePragmaStacks ();
+    WriteMacroTab ();
+}
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static void ClosePCH (void)
+/* Release the precompiled header in use */
+{
+    if (PCH) {
+        UnmapFile (PCH);
+        PCH = 0;
+        ReadPos = ReadEnd = 0;
+    }
+}
+
+
+
+static void NotUsed (void)
+/* Tell the user why the precompiled header cannot be used and forget it */
+{
+    PPWarning ("Precompiled header '%s' not used: %s",
+               SB_GetConstBuf (&UsePCHName), SB_GetConstBuf (&Reason));
+    ClosePCH ();
+}
+
+
+
+void InitPCH (void)
+/* Initialize precompiled header support. Must be called after all predefined
+** macros are in place, and before the main file is opened. If a precompiled
+** header should be used, it is loaded and checked here.
+*/
+{
+    const char* Name;
+    const char* Changed;
+    unsigned long Len;
+    const unsigned char* Data;
+
+    /* Nothing to do if no precompiled headers are involved */
+    if (SB_IsEmpty (&CreatePCHName) && SB_IsEmpty (&UsePCHName)) {
+        return;
+    }
+
+    /* Remember the environment */
+    Out = &Config;
+    WriteConfig ();
+    Out = 0;
+
+    /* Done if we don't use a precompiled header. The output of the
+    ** preprocessor must contain the text of the header, so it is ignored
+    ** in this case, too.
+    */
+    if (SB_IsEmpty (&UsePCHName) || PreprocessOnly) {
+        return;
+    }
+
+    /* Load the file */
+    Name = SB_GetConstBuf (&UsePCHName);
+    PCH = MapFile (Name);
+    if (PCH == 0) {
+        Fatal ("Cannot open precompiled header '%s': %s", Name, strerror (errno));
+    }
+    ReadPos = PCH->Data;
+    ReadEnd = PCH->Data + PCH->Size;
+
+    /* Check the header */
+    if (PCH->Size < sizeof (PCHMagic) - 1 ||
+        memcmp (ReadPos, PCHMagic, sizeof (PCHMagic) - 1) != 0) {
+        Fatal ("'%s' is not a precompiled header", Name);
+    }
+    ReadPos += sizeof (PCHMagic) - 1;
+
+    /* From now on, we're waiting for the first #include. If the file turns
+    ** out to be unusable, remember why, and tell the user when the
+    ** #include is seen.
+    */
+    Pending = 1;
+    if (PCHReadVar () != PCH_VERSION || PCHReadVar () != GetVersionAsNumber ()) {
+        SB_Printf (&Reason, "created by a different version of the compiler");
+        ClosePCH ();
+        return;
+    }
+    Data = ReadData (&Len);
+    if (Len != SB_GetLen (&Config) ||
+        memcmp (Data, SB_GetConstBuf (&Config), Len) != 0) {
+        SB_Printf (&Reason, "created with different options or macros");
+        ClosePCH ();
+        return;
+    }
+    HeaderName  = xstrdup (PCHReadStr ());
+    HeaderSize  = PCHReadVar ();
+    HeaderMTime = PCHReadVar ();
+
+    /* Check if one of the files used to create the header has changed */
+    StatePos = ReadPos;
+    Changed = CheckInputFiles ();
+    if (Changed) {
+        SB_Printf (&Reason, "'%s' has changed", Changed);
+        ClosePCH ();
+    }
+}
+
+
+
+int UsePCH (const char* Name, InputType IT)
+/* Called for the first #include of the main file. If a valid precompiled
+** header exists for the file with the given name, restore the compiler state
+** from it and return true. Otherwise return false, and the file is included
+** as usual.
+*/
+{
+    struct stat Buf;
+
+    /* Only the first #include may be replaced */
+    if (!Pending) {
+        return 0;
+    }
+    Pending = 0;
+
+    /* Check if the header is the one the precompiled header was made from */
+    if (SB_IsEmpty (&Reason)) {
+        if (strcmp (FindName (Name), HeaderName) != 0) {
+            SB_Printf (&Reason, "first #include is not '%s'", HeaderName);
+        } else if (FileStat (Name, &Buf) != 0                     ||
+                   (unsigned long) Buf.st_size  != HeaderSize     ||
+                   (unsigned long) Buf.st_mtime != HeaderMTime) {
+            SB_Printf (&Reason, "'%s' has changed", Name);
+        }
+    }
+    if (SB_NotEmpty (&Reason)) {
+        NotUsed ();
+        return 0;
+    }
+
+    /* Restore the state of the compiler after translating the header */
+    ReadPos = StatePos;
+    ReadInputFiles (Name, IT);
+    ReadMacroTab ();
+    ReadAnonNames ();
+    ReadLocalLabels ();
+    ReadLiteralPool ();
+    ReadSymTab ();
+    ReadSegNames ();
+    ReadWrappedCalls ();
+    ReadPragmaStacks ();
+    ReadCharMap ();
+    if (ReadPos != ReadEnd) {
+        Corrupt ();
+    }
+
+    Print (stdout, 1, "Using precompiled header '%s'\n", SB_GetConstBuf (&UsePCHName));
+
+    /* The file isn't needed any longer */
+    ClosePCH ();
+    return 1;
+}
+
+
+
+void SkipPCH (void)
+/* Called when the preprocessor sees something other than an #include. Since
+** a precompiled header replaces the first #include only, it cannot be used
+** from now on.
+*/
+{
+    if (Pending) {
+        Pending = 0;
+        if (SB_IsEmpty (&Reason)) {
+            SB_Printf (&Reason, "source doesn't start with an #include");
+        }
+        NotUsed ();
+    }
+}
+
+
+
+void WritePCH (const char* InputFile)
+/* Write the state of the compiler after translating InputFile to the
+** precompiled header file.
+*/
+{
+    StrBuf      Data = AUTO_STRBUF_INITIALIZER;
+    const char* Name = SB_GetConstBuf (&CreatePCHName);
+    struct stat Buf;
+    FILE*       F;
+    size_t      Written;
+
+    /* A precompiled header may declare things, but not generate code */
+    if (HaveGlobalCode ()) {
+        Error ("Precompiled header must not contain code");
+    }
+
+    /* Get the file data of the header */
+    if (FileStat (InputFile, &Buf) != 0) {
+        Fatal ("Cannot stat '%s': %s", InputFile, strerror (errno));
+    }
+
+    /* Write everything into a memory buffer */
+    Out = &Data;
+    SB_AppendBuf (Out, PCHMagic, sizeof (PCHMagic) - 1);
+    PCHWriteVar (PCH_VERSION);
+    PCHWriteVar (GetVersionAsNumber ());
+    PCHWriteBuf (&Config);
+    PCHWriteStr (FindName (InputFile));
+    PCHWriteVar ((unsigned long) Buf.st_size);
+    PCHWriteVar ((unsigned long) Buf.st_mtime);
+    WriteInputFiles ();
+    WriteMacroTab ();
+    WriteAnonNames ();
+    WriteLocalLabels ();
+    WriteLiteralPool ();
+    WriteSymTab ();
+    WriteSegNames ();
+    WriteWrappedCalls ();
+    WritePragmaStacks ();
+    WriteCharMap ();
+    Out = 0;
+
+    /* Write the file if the header was accepted */
+    if (ErrorCount == 0) {
+        F = fopen (Name, "wb");
+        if (F == 0) {
+            Fatal ("Cannot open precompiled header '%s': %s", Name, strerror (errno));
+        }
+        Written = fwrite (SB_GetConstBuf (&Data), 1, SB_GetLen (&Data), F);
+        if (fclose (F) != 0 || Written != SB_GetLen (&Data)) {
+            remove (Name);
+            Fatal ("Cannot write to precompiled header '%s'", Name);
+        }
+        Print (stdout, 1, "Wrote precompiled header to '%s'\n", Name);
+    }
+
+    SB_Done (&Data);
+}
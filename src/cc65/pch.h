@@ -0,0 +1,102 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                   pch.h                                   */
+/*                                                                           */
+/*                         Precompiled header support                        */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef PCH_H
+#define PCH_H
+
+
+
+/* common */
+#include "strbuf.h"
+
+/* cc65 */
+#include "input.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void PCHWriteVar (unsigned long V);
+/* Write a variable sized value to the precompiled header */
+
+void PCHWriteStr (const char* S);
+/* Write a string to the precompiled header */
+
+void PCHWriteBuf (const StrBuf* B);
+/* Write the contents of a string buffer to the precompiled header */
+
+unsigned long PCHReadVar (void);
+/* Read a variable sized value from the precompiled header */
+
+const char* PCHReadStr (void);
+/* Read a string from the precompiled header. The string is placed in static
+** storage and overwritten by the next call.
+*/
+
+void PCHReadBuf (StrBuf* B);
+/* Read the contents of a string buffer from the precompiled header */
+
+void InitPCH (void);
+/* Initialize precompiled header support. Must be called after all predefined
+** macros are in place, and before the main file is opened. If a precompiled
+** header should be used, it is loaded and checked here.
+*/
+
+int UsePCH (const char* Name, InputType IT);
+/* Called for the first #include of the main file. If a valid precompiled
+** header exists for the file with the given name, restore the compiler state
+** from it and return true. Otherwise return false, and the file is included
+** as usual.
+*/
+
+void SkipPCH (void);
+/* Called when the preprocessor sees something other than an #include. Since
+** a precompiled header replaces the first #include only, it cannot be used
+** from now on.
+*/
+
+void WritePCH (const char* InputFile);
+/* Write the state of the compiler after translating InputFile to the
+** precompiled header file.
+*/
+
+
+
+/* End of pch.h */
+
+#endif
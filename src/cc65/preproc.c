@@ -55,6 +55,7 @@
 #include "input.h"
 #include "lineinfo.h"
 #include "macrotab.h"
+#include "pch.h"
 #include "preproc.h"
 #include "scanner.h"
 #include "standard.h"
@@ -1230,6 +1231,7 @@ void Preprocess (void)
 {
     int         Skip;
     ident       Directive;
+    pptoken_t   Tok;
 
     /* Create the output buffer if we don't already have one */
     if (MLine == 0) {
@@ -1255,7 +1257,12 @@ void Preprocess (void)
                 PPError ("Preprocessor directive expected");
                 ClearLine ();
             } else {
-                switch (FindPPToken (Directive)) {
+                /* A precompiled header can replace the first #include only */
+                Tok = FindPPToken (Directive);
+                if (Tok != PP_INCLUDE) {
+                    SkipPCH ();
+                }
+                switch (Tok) {
 
                     case PP_DEFINE:
                         if (!Skip) {
@@ -1396,6 +1403,12 @@ void Preprocess (void)
 
     PreprocessLine ();
 
+    /* Source text prevents the use of a precompiled header, comments don't */
+    SkipWhitespace (0);
+    if (CurC != '\0') {
+        SkipPCH ();
+    }
+
 Done:
     if (Verbosity > 1 && SB_NotEmpty (Line)) {
         printf ("%s(%u): %.*s\n", GetCurrentFile (), GetCurrentLine (),
@@ -74,6 +74,21 @@ void RC_InvalidateZP (RegContents* C)
 
 
 
+int RC_Equal (const RegContents* C1, const RegContents* C2)
+/* Return true if both register contents are identical */
+{
+    return C1->RegA   == C2->RegA   &&
+           C1->RegX   == C2->RegX   &&
+           C1->RegY   == C2->RegY   &&
+           C1->SRegLo == C2->SRegLo &&
+           C1->SRegHi == C2->SRegHi &&
+           C1->Ptr1Lo == C2->Ptr1Lo &&
+           C1->Ptr1Hi == C2->Ptr1Hi &&
+           C1->Tmp1   == C2->Tmp1;
+}
+
+
+
 static void RC_Dump1 (FILE* F, const char* Desc, short Val)
 /* Dump one register value */
 {
@@ -121,6 +136,8 @@ RegInfo* NewRegInfo (const RegContents* RC)
         RC_Invalidate (&RI->Out);
         RC_Invalidate (&RI->Out2);
     }
+    RI->FirstOut  = RI->Out;
+    RI->FirstOut2 = RI->Out2;
 
     /* Return the new struct */
     return RI;
@@ -73,6 +73,8 @@ struct RegInfo {
     RegContents In;             /* Incoming register values */
     RegContents Out;            /* Outgoing register values */
     RegContents Out2;           /* Alternative outgoing reg values for branches */
+    RegContents FirstOut;       /* Out after the first run of CS_GenRegInfo */
+    RegContents FirstOut2;      /* Out2 after the first run of CS_GenRegInfo */
 };
 
 
@@ -89,6 +91,9 @@ void RC_Invalidate (RegContents* C);
 void RC_InvalidateZP (RegContents* C);
 /* Invalidate all ZP registers */
 
+int RC_Equal (const RegContents* C1, const RegContents* C2);
+/* Return true if both register contents are identical */
+
 void RC_Dump (FILE* F, const RegContents* RC);
 /* Dump the contents of the given RegContents struct */
 
@@ -42,14 +42,19 @@
 #include "coll.h"
 #include "scanner.h"
 #include "segnames.h"
+#include "strbuf.h"
 #include "strstack.h"
 #include "xmalloc.h"
 
 /* cc65 */
+#include "asmlabel.h"
 #include "codeent.h"
+#include "codegen.h"
+#include "codeinfo.h"
 #include "codeseg.h"
 #include "dataseg.h"
 #include "error.h"
+#include "pch.h"
 #include "textseg.h"
 #include "segments.h"
 
@@ -136,6 +141,59 @@ const char* GetSegName (segment_t Seg)
 
 
 
+void WriteSegNames (void)
+/* Write the segment name stacks to a precompiled header */
+{
+    unsigned Seg, I;
+    for (Seg = 0; Seg < SEG_COUNT; ++Seg) {
+        const StrStack* S = &SegmentNames[Seg];
+        PCHWriteVar (S->Count);
+        for (I = 0; I < S->Count; ++I) {
+            PCHWriteStr (S->Stack[I]);
+        }
+    }
+}
+
+
+
+void ReadSegNames (void)
+/* Read the segment name stacks from a precompiled header */
+{
+    unsigned Seg, I;
+    for (Seg = 0; Seg < SEG_COUNT; ++Seg) {
+
+        StrStack* S = &SegmentNames[Seg];
+        unsigned Count;
+        int Changed;
+
+        /* Remember the current name, then replace the stack */
+        char* Old = xstrdup (SS_Get (S));
+        while (SS_GetCount (S) > 1) {
+            SS_Drop (S);
+        }
+        Count = PCHReadVar ();
+        for (I = 0; I < Count; ++I) {
+            if (I == 0) {
+                SS_Set (S, PCHReadStr ());
+            } else {
+                PushSegName ((segment_t) Seg, PCHReadStr ());
+            }
+        }
+        Changed = (strcmp (Old, SS_Get (S)) != 0);
+        xfree (Old);
+
+        /* Data segment names are output when they're changed by #pragma,
+        ** so do the same here. BSS variables are output at the end of the
+        ** compilation.
+        */
+        if (Changed && Seg != SEG_BSS) {
+            g_segname ((segment_t) Seg);
+        }
+    }
+}
+
+
+
 static Segments* NewSegments (SymEntry* Func)
 /* Initialize a Segments structure (set all fields to NULL) */
 {
@@ -252,6 +310,78 @@ void AddCode (opc_t OPC, am_t AM, const char* Arg, struct CodeLabel* JumpTo)
 
 
 
+void AddCodeImp (opc_t OPC)
+/* Add an instruction without an argument to the current code segment. For
+** instructions that cannot be implicit, accumulator addressing is used.
+*/
+{
+    if (GetOPCDesc (OPC)->Info & OF_NOIMP) {
+        AddCode (OPC, AM65_ACC, 0, 0);
+    } else {
+        AddCode (OPC, AM65_IMP, 0, 0);
+    }
+}
+
+
+
+void AddCodeArg (opc_t OPC, am_t AM, const char* Format, ...)
+/* Add an instruction to the current code segment. The argument is created
+** from Format and the following parameters. AM65_ABS and AM65_ABSX are
+** changed to zero page addressing if the argument is a known zero page
+** location. For AM65_BRA, the argument is the name of the target label.
+*/
+{
+    static StrBuf Arg = STATIC_STRBUF_INITIALIZER;
+    CodeLabel*    JumpTo = 0;
+
+    /* Create the argument */
+    va_list ap;
+    va_start (ap, Format);
+    SB_VPrintf (&Arg, Format, ap);
+    va_end (ap);
+
+    /* Check the addressing mode */
+    switch (AM) {
+
+        case AM65_ABS:
+            if (GetZPInfo (SB_GetConstBuf (&Arg)) != 0) {
+                AM = AM65_ZP;
+            }
+            break;
+
+        case AM65_ABSX:
+            if (GetZPInfo (SB_GetConstBuf (&Arg)) != 0) {
+                AM = AM65_ZPX;
+            }
+            break;
+
+        case AM65_BRA:
+            CHECK (CS != 0);
+            JumpTo = CS_GetJumpLabel (CS->Code, OPC, SB_GetConstBuf (&Arg));
+            break;
+
+        default:
+            break;
+    }
+
+    /* Add the code entry */
+    AddCode (OPC, AM, SB_GetConstBuf (&Arg), JumpTo);
+}
+
+
+
+void AddCodeBranch (opc_t OPC, unsigned Label)
+/* Add a branch or jump to the local label with the given number to the
+** current code segment.
+*/
+{
+    const char* Name = LocalLabelName (Label);
+    CHECK (CS != 0);
+    AddCode (OPC, AM65_BRA, Name, CS_GetJumpLabel (CS->Code, OPC, Name));
+}
+
+
+
 void AddDataLine (const char* Format, ...)
 /* Add a line of data to the current data segment */
 {
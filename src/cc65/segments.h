@@ -117,6 +117,12 @@ void PopSegName (segment_t Seg);
 const char* GetSegName (segment_t Seg);
 /* Get the name of the given segment */
 
+void WriteSegNames (void);
+/* Write the segment name stacks to a precompiled header */
+
+void ReadSegNames (void);
+/* Read the segment name stacks from a precompiled header */
+
 Segments* PushSegments (struct SymEntry* Func);
 /* Make the new segment list current but remember the old one */
 
@@ -136,11 +142,31 @@ void AddTextLine (const char* Format, ...) attribute ((format (printf, 1, 2)));
 /* Add a line to the current text segment */
 
 void AddCodeLine (const char* Format, ...) attribute ((format (printf, 1, 2)));
-/* Add a line of code to the current code segment */
+/* Add a line of code to the current code segment. The line is parsed, so
+** this is meant for assembler code supplied by the user. The code generator
+** uses the AddCode... functions instead.
+*/
 
 void AddCode (opc_t OPC, am_t AM, const char* Arg, struct CodeLabel* JumpTo);
 /* Add a code entry to the current code segment */
 
+void AddCodeImp (opc_t OPC);
+/* Add an instruction without an argument to the current code segment. For
+** instructions that cannot be implicit, accumulator addressing is used.
+*/
+
+void AddCodeArg (opc_t OPC, am_t AM, const char* Format, ...) attribute ((format (printf, 3, 4)));
+/* Add an instruction to the current code segment. The argument is created
+** from Format and the following parameters. AM65_ABS and AM65_ABSX are
+** changed to zero page addressing if the argument is a known zero page
+** location. For AM65_BRA, the argument is the name of the target label.
+*/
+
+void AddCodeBranch (opc_t OPC, unsigned Label);
+/* Add a branch or jump to the local label with the given number to the
+** current code segment.
+*/
+
 void AddDataLine (const char* Format, ...) attribute ((format (printf, 1, 2)));
 /* Add a line of data to the current data segment */
 
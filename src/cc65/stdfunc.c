@@ -185,14 +185,14 @@ static void ParseArg (ArgDesc* Arg, Type* Type)
 
 
 
-void AddCmpCodeIfSizeNot256 (const char* Code, long Size)
-/* Add a line of Assembly code that compares an index register
-** only if it isn't comparing to #<256.  (If the next line
-** is "bne", then this will avoid a redundant line.)
+void AddCmpCodeIfSizeNot256 (opc_t OPC, long Size)
+/* Add a compare instruction OPC for an index register only if it isn't
+** comparing to #<256.  (If the next line is "bne", then this will avoid a
+** redundant line.)
 */
 {
     if (Size != 256) {
-        AddCodeLine (Code, (unsigned int)Size);
+        AddCodeArg (OPC, AM65_IMM, "$%02X", (unsigned int)Size);
     }
 }
 
@@ -286,38 +286,38 @@ static void StdFunc_memcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             /* Generate memcpy code */
             if (Arg3.Expr.IVal <= 129) {
 
-                AddCodeLine ("ldy #$%02X", (unsigned char) (Arg3.Expr.IVal-1));
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal-1));
                 g_defcodelabel (Label);
                 if (Reg2) {
-                    AddCodeLine ("lda (%s),y", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCodeArg (OP65_LDA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg2.Expr, 0));
                 } else {
-                    AddCodeLine ("lda %s,y", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", ED_GetLabelName (&Arg2.Expr, 0));
                 }
                 if (Reg1) {
-                    AddCodeLine ("sta (%s),y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 } else {
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 }
-                AddCodeLine ("dey");
-                AddCodeLine ("bpl %s", LocalLabelName (Label));
+                AddCodeImp (OP65_DEY);
+                AddCodeBranch (OP65_BPL, Label);
 
             } else {
 
-                AddCodeLine ("ldy #$00");
+                AddCode (OP65_LDY, AM65_IMM, "$00", 0);
                 g_defcodelabel (Label);
                 if (Reg2) {
-                    AddCodeLine ("lda (%s),y", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCodeArg (OP65_LDA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg2.Expr, 0));
                 } else {
-                    AddCodeLine ("lda %s,y", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", ED_GetLabelName (&Arg2.Expr, 0));
                 }
                 if (Reg1) {
-                    AddCodeLine ("sta (%s),y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 } else {
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 }
-                AddCodeLine ("iny");
-                AddCmpCodeIfSizeNot256 ("cpy #$%02X", Arg3.Expr.IVal);
-                AddCodeLine ("bne %s", LocalLabelName (Label));
+                AddCodeImp (OP65_INY);
+                AddCmpCodeIfSizeNot256 (OP65_CPY, Arg3.Expr.IVal);
+                AddCodeBranch (OP65_BNE, Label);
 
             }
 
@@ -358,43 +358,45 @@ static void StdFunc_memcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             if (Arg3.Expr.IVal <= 129 && !AllowOneIndex) {
 
                 if (Offs == 0) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) (Offs + Arg3.Expr.IVal - 1));
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X",
+                                (unsigned char) (Offs + Arg3.Expr.IVal - 1));
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda %s,y", ED_GetLabelName (&Arg2.Expr, -Offs));
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("dey");
-                    AddCodeLine ("bpl %s", LocalLabelName (Label));
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", ED_GetLabelName (&Arg2.Expr, -Offs));
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_DEY);
+                    AddCodeBranch (OP65_BPL, Label);
                 } else {
-                    AddCodeLine ("ldx #$%02X", (unsigned char) (Arg3.Expr.IVal-1));
-                    AddCodeLine ("ldy #$%02X", (unsigned char) (Offs + Arg3.Expr.IVal - 1));
+                    AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal-1));
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X",
+                                (unsigned char) (Offs + Arg3.Expr.IVal - 1));
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda %s,x", ED_GetLabelName (&Arg2.Expr, 0));
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("dey");
-                    AddCodeLine ("dex");
-                    AddCodeLine ("bpl %s", LocalLabelName (Label));
+                    AddCodeArg (OP65_LDA, AM65_ABSX, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_DEY);
+                    AddCodeImp (OP65_DEX);
+                    AddCodeBranch (OP65_BPL, Label);
                 }
 
             } else {
 
                 if (Offs == 0 || AllowOneIndex) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) Offs);
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) Offs);
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda %s,y", ED_GetLabelName (&Arg2.Expr, -Offs));
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("iny");
-                    AddCmpCodeIfSizeNot256 ("cpy #$%02X", Offs + Arg3.Expr.IVal);
-                    AddCodeLine ("bne %s", LocalLabelName (Label));
+                    AddCodeArg (OP65_LDA, AM65_ABSY, "%s", ED_GetLabelName (&Arg2.Expr, -Offs));
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_INY);
+                    AddCmpCodeIfSizeNot256 (OP65_CPY, Offs + Arg3.Expr.IVal);
+                    AddCodeBranch (OP65_BNE, Label);
                 } else {
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("ldy #$%02X", (unsigned char) Offs);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) Offs);
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda %s,x", ED_GetLabelName (&Arg2.Expr, 0));
-                    AddCodeLine ("sta (sp),y");
-                    AddCodeLine ("iny");
-                    AddCodeLine ("inx");
-                    AddCmpCodeIfSizeNot256 ("cpx #$%02X", Arg3.Expr.IVal);
-                    AddCodeLine ("bne %s", LocalLabelName (Label));
+                    AddCodeArg (OP65_LDA, AM65_ABSX, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+                    AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeImp (OP65_INY);
+                    AddCodeImp (OP65_INX);
+                    AddCmpCodeIfSizeNot256 (OP65_CPX, Arg3.Expr.IVal);
+                    AddCodeBranch (OP65_BNE, Label);
                 }
 
             }
@@ -436,43 +438,44 @@ static void StdFunc_memcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             if (Arg3.Expr.IVal <= 129 && !AllowOneIndex) {
 
                 if (Offs == 0) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) (Arg3.Expr.IVal - 1));
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal - 1));
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda (sp),y");
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, 0));
-                    AddCodeLine ("dey");
-                    AddCodeLine ("bpl %s", LocalLabelName (Label));
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeImp (OP65_DEY);
+                    AddCodeBranch (OP65_BPL, Label);
                 } else {
-                    AddCodeLine ("ldx #$%02X", (unsigned char) (Arg3.Expr.IVal-1));
-                    AddCodeLine ("ldy #$%02X", (unsigned char) (Offs + Arg3.Expr.IVal - 1));
+                    AddCodeArg (OP65_LDX, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal-1));
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X",
+                                (unsigned char) (Offs + Arg3.Expr.IVal - 1));
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda (sp),y");
-                    AddCodeLine ("sta %s,x", ED_GetLabelName (&Arg1.Expr, 0));
-                    AddCodeLine ("dey");
-                    AddCodeLine ("dex");
-                    AddCodeLine ("bpl %s", LocalLabelName (Label));
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeArg (OP65_STA, AM65_ABSX, "%s", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeImp (OP65_DEY);
+                    AddCodeImp (OP65_DEX);
+                    AddCodeBranch (OP65_BPL, Label);
                 }
 
             } else {
 
                 if (Offs == 0 || AllowOneIndex) {
-                    AddCodeLine ("ldy #$%02X", (unsigned char) Offs);
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) Offs);
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda (sp),y");
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, -Offs));
-                    AddCodeLine ("iny");
-                    AddCmpCodeIfSizeNot256 ("cpy #$%02X", Offs + Arg3.Expr.IVal);
-                    AddCodeLine ("bne %s", LocalLabelName (Label));
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, -Offs));
+                    AddCodeImp (OP65_INY);
+                    AddCmpCodeIfSizeNot256 (OP65_CPY, Offs + Arg3.Expr.IVal);
+                    AddCodeBranch (OP65_BNE, Label);
                 } else {
-                    AddCodeLine ("ldx #$00");
-                    AddCodeLine ("ldy #$%02X", (unsigned char) Offs);
+                    AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                    AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) Offs);
                     g_defcodelabel (Label);
-                    AddCodeLine ("lda (sp),y");
-                    AddCodeLine ("sta %s,x", ED_GetLabelName (&Arg1.Expr, 0));
-                    AddCodeLine ("iny");
-                    AddCodeLine ("inx");
-                    AddCmpCodeIfSizeNot256 ("cpx #$%02X", Arg3.Expr.IVal);
-                    AddCodeLine ("bne %s", LocalLabelName (Label));
+                    AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                    AddCodeArg (OP65_STA, AM65_ABSX, "%s", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeImp (OP65_INY);
+                    AddCodeImp (OP65_INX);
+                    AddCmpCodeIfSizeNot256 (OP65_CPX, Arg3.Expr.IVal);
+                    AddCodeBranch (OP65_BNE, Label);
                 }
 
             }
@@ -497,27 +500,27 @@ static void StdFunc_memcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             Label = GetLocalLabel ();
 
             /* Generate memcpy code */
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
             if (Arg3.Expr.IVal <= 129) {
-                AddCodeLine ("ldy #$%02X", (unsigned char) (Arg3.Expr.IVal - 1));
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal - 1));
                 g_defcodelabel (Label);
-                AddCodeLine ("lda (sp),y");
-                AddCodeLine ("sta (ptr1),y");
-                AddCodeLine ("dey");
-                AddCodeLine ("bpl %s", LocalLabelName (Label));
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
+                AddCodeImp (OP65_DEY);
+                AddCodeBranch (OP65_BPL, Label);
             } else {
-                AddCodeLine ("ldy #$00");
+                AddCode (OP65_LDY, AM65_IMM, "$00", 0);
                 g_defcodelabel (Label);
-                AddCodeLine ("lda (sp),y");
-                AddCodeLine ("sta (ptr1),y");
-                AddCodeLine ("iny");
-                AddCmpCodeIfSizeNot256 ("cpy #$%02X", Arg3.Expr.IVal);
-                AddCodeLine ("bne %s", LocalLabelName (Label));
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
+                AddCodeImp (OP65_INY);
+                AddCmpCodeIfSizeNot256 (OP65_CPY, Arg3.Expr.IVal);
+                AddCodeBranch (OP65_BNE, Label);
             }
 
             /* Reload result - X hasn't changed by the code above */
-            AddCodeLine ("lda ptr1");
+            AddCode (OP65_LDA, AM65_ZP, "ptr1", 0);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -637,30 +640,30 @@ static void StdFunc_memset (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             /* Generate memset code */
             if (Arg3.Expr.IVal <= 129) {
 
-                AddCodeLine ("ldy #$%02X", (unsigned char) (Arg3.Expr.IVal-1));
-                AddCodeLine ("lda #$%02X", (unsigned char) Arg2.Expr.IVal);
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal-1));
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Arg2.Expr.IVal);
                 g_defcodelabel (Label);
                 if (Reg) {
-                    AddCodeLine ("sta (%s),y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 } else {
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 }
-                AddCodeLine ("dey");
-                AddCodeLine ("bpl %s", LocalLabelName (Label));
+                AddCodeImp (OP65_DEY);
+                AddCodeBranch (OP65_BPL, Label);
 
             } else {
 
-                AddCodeLine ("ldy #$00");
-                AddCodeLine ("lda #$%02X", (unsigned char) Arg2.Expr.IVal);
+                AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Arg2.Expr.IVal);
                 g_defcodelabel (Label);
                 if (Reg) {
-                    AddCodeLine ("sta (%s),y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 } else {
-                    AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, 0));
+                    AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, 0));
                 }
-                AddCodeLine ("iny");
-                AddCmpCodeIfSizeNot256 ("cpy #$%02X", Arg3.Expr.IVal);
-                AddCodeLine ("bne %s", LocalLabelName (Label));
+                AddCodeImp (OP65_INY);
+                AddCmpCodeIfSizeNot256 (OP65_CPY, Arg3.Expr.IVal);
+                AddCodeBranch (OP65_BNE, Label);
 
             }
 
@@ -688,13 +691,13 @@ static void StdFunc_memset (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             Label = GetLocalLabel ();
 
             /* Generate memset code */
-            AddCodeLine ("ldy #$%02X", (unsigned char) Offs);
-            AddCodeLine ("lda #$%02X", (unsigned char) Arg2.Expr.IVal);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) Offs);
+            AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Arg2.Expr.IVal);
             g_defcodelabel (Label);
-            AddCodeLine ("sta (sp),y");
-            AddCodeLine ("iny");
-            AddCmpCodeIfSizeNot256 ("cpy #$%02X", Offs + Arg3.Expr.IVal);
-            AddCodeLine ("bne %s", LocalLabelName (Label));
+            AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
+            AddCodeImp (OP65_INY);
+            AddCmpCodeIfSizeNot256 (OP65_CPY, Offs + Arg3.Expr.IVal);
+            AddCodeBranch (OP65_BNE, Label);
 
             /* memset returns the address, so the result is actually identical
             ** to the first argument.
@@ -718,29 +721,29 @@ static void StdFunc_memset (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             Label = GetLocalLabel ();
 
             /* Generate code */
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
             if (Arg3.Expr.IVal <= 129) {
-                AddCodeLine ("ldy #$%02X", (unsigned char) (Arg3.Expr.IVal-1));
-                AddCodeLine ("lda #$%02X", (unsigned char) Arg2.Expr.IVal);
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Arg3.Expr.IVal-1));
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Arg2.Expr.IVal);
                 g_defcodelabel (Label);
-                AddCodeLine ("sta (ptr1),y");
-                AddCodeLine ("dey");
-                AddCodeLine ("bpl %s", LocalLabelName (Label));
+                AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
+                AddCodeImp (OP65_DEY);
+                AddCodeBranch (OP65_BPL, Label);
             } else {
-                AddCodeLine ("ldy #$00");
-                AddCodeLine ("lda #$%02X", (unsigned char) Arg2.Expr.IVal);
+                AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+                AddCodeArg (OP65_LDA, AM65_IMM, "$%02X", (unsigned char) Arg2.Expr.IVal);
                 g_defcodelabel (Label);
-                AddCodeLine ("sta (ptr1),y");
-                AddCodeLine ("iny");
-                AddCmpCodeIfSizeNot256 ("cpy #$%02X", Arg3.Expr.IVal);
-                AddCodeLine ("bne %s", LocalLabelName (Label));
+                AddCode (OP65_STA, AM65_ZP_INDY, "ptr1", 0);
+                AddCodeImp (OP65_INY);
+                AddCmpCodeIfSizeNot256 (OP65_CPY, Arg3.Expr.IVal);
+                AddCodeBranch (OP65_BNE, Label);
             }
 
             /* Load the function result pointer into a/x (x is still valid). This
             ** code will get removed by the optimizer if it is not used later.
             */
-            AddCodeLine ("lda ptr1");
+            AddCode (OP65_LDA, AM65_ZP, "ptr1", 0);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -844,16 +847,16 @@ static void StdFunc_strcmp (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
                 RemoveCode (&Arg1.Load);
 
                 /* Generate code */
-                AddCodeLine ("ldy #$%02X", Offs);
-                AddCodeLine ("ldx #$00");
-                AddCodeLine ("lda (sp),y");
+                AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", Offs);
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
             } else if (IsArray && ED_IsLocConst (&Arg1.Expr)) {
                 /* Drop the generated code */
                 RemoveCode (&Arg1.Load);
 
                 /* Generate code */
-                AddCodeLine ("ldx #$00");
-                AddCodeLine ("lda %s", ED_GetLabelName (&Arg1.Expr, 0));
+                AddCode (OP65_LDX, AM65_IMM, "$00", 0);
+                AddCodeArg (OP65_LDA, AM65_ABS, "%s", ED_GetLabelName (&Arg1.Expr, 0));
             } else {
                 /* Drop part of the generated code so we have the first argument
                 ** in the primary
@@ -872,18 +875,18 @@ static void StdFunc_strcmp (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
                    (IS_Get (&EagerlyInlineFuncs) || (ECount1 > 0 && ECount1 < 256))) {
 
             unsigned    Entry, Loop, Fin;   /* Labels */
-            const char* Load;
-            const char* Compare;
+            am_t        LoadAM;
+            am_t        CompareAM;
 
             if (ED_IsLVal (&Arg1.Expr) && ED_IsLocRegister (&Arg1.Expr)) {
-                Load = "lda (%s),y";
+                LoadAM = AM65_ZP_INDY;
             } else {
-                Load = "lda %s,y";
+                LoadAM = AM65_ABSY;
             }
             if (ED_IsLVal (&Arg2.Expr) && ED_IsLocRegister (&Arg2.Expr)) {
-                Compare = "cmp (%s),y";
+                CompareAM = AM65_ZP_INDY;
             } else {
-                Compare = "cmp %s,y";
+                CompareAM = AM65_ABSY;
             }
 
             /* Drop the generated code */
@@ -895,19 +898,19 @@ static void StdFunc_strcmp (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             Fin   = GetLocalLabel ();
 
             /* Generate strcmp code */
-            AddCodeLine ("ldy #$00");
-            AddCodeLine ("beq %s", LocalLabelName (Entry));
+            AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+            AddCodeBranch (OP65_BEQ, Entry);
             g_defcodelabel (Loop);
-            AddCodeLine ("tax");
-            AddCodeLine ("beq %s", LocalLabelName (Fin));
-            AddCodeLine ("iny");
+            AddCodeImp (OP65_TAX);
+            AddCodeBranch (OP65_BEQ, Fin);
+            AddCodeImp (OP65_INY);
             g_defcodelabel (Entry);
-            AddCodeLine (Load, ED_GetLabelName (&Arg1.Expr, 0));
-            AddCodeLine (Compare, ED_GetLabelName (&Arg2.Expr, 0));
-            AddCodeLine ("beq %s", LocalLabelName (Loop));
-            AddCodeLine ("ldx #$01");
-            AddCodeLine ("bcs %s", LocalLabelName (Fin));
-            AddCodeLine ("ldx #$FF");
+            AddCodeArg (OP65_LDA, LoadAM, "%s", ED_GetLabelName (&Arg1.Expr, 0));
+            AddCodeArg (OP65_CMP, CompareAM, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+            AddCodeBranch (OP65_BEQ, Loop);
+            AddCode (OP65_LDX, AM65_IMM, "$01", 0);
+            AddCodeBranch (OP65_BCS, Fin);
+            AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
             g_defcodelabel (Fin);
 
         } else if ((IS_Get (&CodeSizeFactor) > 190) &&
@@ -916,12 +919,12 @@ static void StdFunc_strcmp (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
                    (IS_Get (&EagerlyInlineFuncs) || (ECount1 > 0 && ECount1 < 256))) {
 
             unsigned    Entry, Loop, Fin;   /* Labels */
-            const char* Compare;
+            am_t        CompareAM;
 
             if (ED_IsLVal (&Arg2.Expr) && ED_IsLocRegister (&Arg2.Expr)) {
-                Compare = "cmp (%s),y";
+                CompareAM = AM65_ZP_INDY;
             } else {
-                Compare = "cmp %s,y";
+                CompareAM = AM65_ABSY;
             }
 
             /* Drop the generated code */
@@ -933,23 +936,23 @@ static void StdFunc_strcmp (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             Fin   = GetLocalLabel ();
 
             /* Store Arg1 into ptr1 */
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
 
             /* Generate strcmp code */
-            AddCodeLine ("ldy #$00");
-            AddCodeLine ("beq %s", LocalLabelName (Entry));
+            AddCode (OP65_LDY, AM65_IMM, "$00", 0);
+            AddCodeBranch (OP65_BEQ, Entry);
             g_defcodelabel (Loop);
-            AddCodeLine ("tax");
-            AddCodeLine ("beq %s", LocalLabelName (Fin));
-            AddCodeLine ("iny");
+            AddCodeImp (OP65_TAX);
+            AddCodeBranch (OP65_BEQ, Fin);
+            AddCodeImp (OP65_INY);
             g_defcodelabel (Entry);
-            AddCodeLine ("lda (ptr1),y");
-            AddCodeLine (Compare, ED_GetLabelName (&Arg2.Expr, 0));
-            AddCodeLine ("beq %s", LocalLabelName (Loop));
-            AddCodeLine ("ldx #$01");
-            AddCodeLine ("bcs %s", LocalLabelName (Fin));
-            AddCodeLine ("ldx #$FF");
+            AddCode (OP65_LDA, AM65_ZP_INDY, "ptr1", 0);
+            AddCodeArg (OP65_CMP, CompareAM, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+            AddCodeBranch (OP65_BEQ, Loop);
+            AddCode (OP65_LDX, AM65_IMM, "$01", 0);
+            AddCodeBranch (OP65_BCS, Fin);
+            AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
             g_defcodelabel (Fin);
         }
     }
@@ -1023,17 +1026,17 @@ static void StdFunc_strcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             (IS_Get (&EagerlyInlineFuncs) ||
             (ECount != UNSPECIFIED && ECount < 256))) {
 
-            const char* Load;
-            const char* Store;
+            am_t        LoadAM;
+            am_t        StoreAM;
             if (ED_IsLVal (&Arg2.Expr) && ED_IsLocRegister (&Arg2.Expr)) {
-                Load = "lda (%s),y";
+                LoadAM = AM65_ZP_INDY;
             } else {
-                Load = "lda %s,y";
+                LoadAM = AM65_ABSY;
             }
             if (ED_IsLVal (&Arg1.Expr) && ED_IsLocRegister (&Arg1.Expr)) {
-                Store = "sta (%s),y";
+                StoreAM = AM65_ZP_INDY;
             } else {
-                Store = "sta %s,y";
+                StoreAM = AM65_ABSY;
             }
 
             /* Drop the generated code */
@@ -1043,12 +1046,12 @@ static void StdFunc_strcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             L1 = GetLocalLabel ();
 
             /* Generate strcpy code */
-            AddCodeLine ("ldy #$FF");
+            AddCode (OP65_LDY, AM65_IMM, "$FF", 0);
             g_defcodelabel (L1);
-            AddCodeLine ("iny");
-            AddCodeLine (Load, ED_GetLabelName (&Arg2.Expr, 0));
-            AddCodeLine (Store, ED_GetLabelName (&Arg1.Expr, 0));
-            AddCodeLine ("bne %s", LocalLabelName (L1));
+            AddCodeImp (OP65_INY);
+            AddCodeArg (OP65_LDA, LoadAM, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+            AddCodeArg (OP65_STA, StoreAM, "%s", ED_GetLabelName (&Arg1.Expr, 0));
+            AddCodeBranch (OP65_BNE, L1);
 
             /* strcpy returns argument #1 */
             *Expr = Arg1.Expr;
@@ -1081,21 +1084,21 @@ static void StdFunc_strcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             L1 = GetLocalLabel ();
 
             /* Generate strcpy code */
-            AddCodeLine ("ldy #$%02X", (unsigned char) (Offs - 1));
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Offs - 1));
             if (Offs == 0 || AllowOneIndex) {
                 g_defcodelabel (L1);
-                AddCodeLine ("iny");
-                AddCodeLine ("lda (sp),y");
-                AddCodeLine ("sta %s,y", ED_GetLabelName (&Arg1.Expr, -Offs));
+                AddCodeImp (OP65_INY);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                AddCodeArg (OP65_STA, AM65_ABSY, "%s", ED_GetLabelName (&Arg1.Expr, -Offs));
             } else {
-                AddCodeLine ("ldx #$FF");
+                AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
                 g_defcodelabel (L1);
-                AddCodeLine ("iny");
-                AddCodeLine ("inx");
-                AddCodeLine ("lda (sp),y");
-                AddCodeLine ("sta %s,x", ED_GetLabelName (&Arg1.Expr, 0));
+                AddCodeImp (OP65_INY);
+                AddCodeImp (OP65_INX);
+                AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+                AddCodeArg (OP65_STA, AM65_ABSX, "%s", ED_GetLabelName (&Arg1.Expr, 0));
             }
-            AddCodeLine ("bne %s", LocalLabelName (L1));
+            AddCodeBranch (OP65_BNE, L1);
 
             /* strcpy returns argument #1 */
             *Expr = Arg1.Expr;
@@ -1128,21 +1131,21 @@ static void StdFunc_strcpy (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
             L1 = GetLocalLabel ();
 
             /* Generate strcpy code */
-            AddCodeLine ("ldy #$%02X", (unsigned char) (Offs - 1));
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Offs - 1));
             if (Offs == 0 || AllowOneIndex) {
                 g_defcodelabel (L1);
-                AddCodeLine ("iny");
-                AddCodeLine ("lda %s,y", ED_GetLabelName (&Arg2.Expr, -Offs));
-                AddCodeLine ("sta (sp),y");
+                AddCodeImp (OP65_INY);
+                AddCodeArg (OP65_LDA, AM65_ABSY, "%s", ED_GetLabelName (&Arg2.Expr, -Offs));
+                AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
             } else {
-                AddCodeLine ("ldx #$FF");
+                AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
                 g_defcodelabel (L1);
-                AddCodeLine ("iny");
-                AddCodeLine ("inx");
-                AddCodeLine ("lda %s,x", ED_GetLabelName (&Arg2.Expr, 0));
-                AddCodeLine ("sta (sp),y");
+                AddCodeImp (OP65_INY);
+                AddCodeImp (OP65_INX);
+                AddCodeArg (OP65_LDA, AM65_ABSX, "%s", ED_GetLabelName (&Arg2.Expr, 0));
+                AddCode (OP65_STA, AM65_ZP_INDY, "sp", 0);
             }
-            AddCodeLine ("bne %s", LocalLabelName (L1));
+            AddCodeBranch (OP65_BNE, L1);
 
             /* strcpy returns argument #1 */
             *Expr = Arg1.Expr;
@@ -1242,12 +1245,12 @@ static void StdFunc_strlen (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
 
             /* Generate the strlen code */
             L = GetLocalLabel ();
-            AddCodeLine ("ldy #$FF");
+            AddCode (OP65_LDY, AM65_IMM, "$FF", 0);
             g_defcodelabel (L);
-            AddCodeLine ("iny");
-            AddCodeLine ("ldx %s,y", ED_GetLabelName (&Arg, 0));
-            AddCodeLine ("bne %s", LocalLabelName (L));
-            AddCodeLine ("tya");
+            AddCodeImp (OP65_INY);
+            AddCodeArg (OP65_LDX, AM65_ABSY, "%s", ED_GetLabelName (&Arg, 0));
+            AddCodeBranch (OP65_BNE, L);
+            AddCodeImp (OP65_TYA);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -1268,15 +1271,15 @@ static void StdFunc_strlen (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
 
             /* Generate the strlen code */
             L = GetLocalLabel ();
-            AddCodeLine ("ldx #$FF");
-            AddCodeLine ("ldy #$%02X", (unsigned char) (Offs-1));
+            AddCode (OP65_LDX, AM65_IMM, "$FF", 0);
+            AddCodeArg (OP65_LDY, AM65_IMM, "$%02X", (unsigned char) (Offs-1));
             g_defcodelabel (L);
-            AddCodeLine ("inx");
-            AddCodeLine ("iny");
-            AddCodeLine ("lda (sp),y");
-            AddCodeLine ("bne %s", LocalLabelName (L));
-            AddCodeLine ("txa");
-            AddCodeLine ("ldx #$00");
+            AddCodeImp (OP65_INX);
+            AddCodeImp (OP65_INY);
+            AddCode (OP65_LDA, AM65_ZP_INDY, "sp", 0);
+            AddCodeBranch (OP65_BNE, L);
+            AddCodeImp (OP65_TXA);
+            AddCode (OP65_LDX, AM65_IMM, "$00", 0);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -1295,13 +1298,13 @@ static void StdFunc_strlen (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
 
             /* Generate the strlen code */
             L = GetLocalLabel ();
-            AddCodeLine ("ldy #$FF");
+            AddCode (OP65_LDY, AM65_IMM, "$FF", 0);
             g_defcodelabel (L);
-            AddCodeLine ("iny");
-            AddCodeLine ("lda (%s),y", ED_GetLabelName (&Arg, 0));
-            AddCodeLine ("bne %s", LocalLabelName (L));
-            AddCodeLine ("tax");
-            AddCodeLine ("tya");
+            AddCodeImp (OP65_INY);
+            AddCodeArg (OP65_LDA, AM65_ZP_INDY, "%s", ED_GetLabelName (&Arg, 0));
+            AddCodeBranch (OP65_BNE, L);
+            AddCodeImp (OP65_TAX);
+            AddCodeImp (OP65_TYA);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -1322,15 +1325,15 @@ static void StdFunc_strlen (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
 
             /* Inline the function */
             L = GetLocalLabel ();
-            AddCodeLine ("sta ptr1");
-            AddCodeLine ("stx ptr1+1");
-            AddCodeLine ("ldy #$FF");
+            AddCode (OP65_STA, AM65_ZP, "ptr1", 0);
+            AddCode (OP65_STX, AM65_ZP, "ptr1+1", 0);
+            AddCode (OP65_LDY, AM65_IMM, "$FF", 0);
             g_defcodelabel (L);
-            AddCodeLine ("iny");
-            AddCodeLine ("lda (ptr1),y");
-            AddCodeLine ("bne %s", LocalLabelName (L));
-            AddCodeLine ("tax");
-            AddCodeLine ("tya");
+            AddCodeImp (OP65_INY);
+            AddCode (OP65_LDA, AM65_ZP_INDY, "ptr1", 0);
+            AddCodeBranch (OP65_BNE, L);
+            AddCodeImp (OP65_TAX);
+            AddCodeImp (OP65_TYA);
 
             /* The function result is an rvalue in the primary register */
             ED_MakeRValExpr (Expr);
@@ -1345,7 +1348,7 @@ static void StdFunc_strlen (FuncDesc* F attribute ((unused)), ExprDesc* Expr)
     LoadExpr (CF_NONE, &Arg);
 
     /* Call the strlen function */
-    AddCodeLine ("jsr _%s", Func_strlen);
+    AddCodeArg (OP65_JSR, AM65_ABS, "_%s", Func_strlen);
 
     /* The function result is an rvalue in the primary register */
     ED_MakeRValExpr (Expr);
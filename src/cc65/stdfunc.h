@@ -40,6 +40,7 @@
 
 /* cc65 */
 #include "expr.h"
+#include "opcodes.h"
 #include "symtab.h"
 
 
@@ -50,10 +51,10 @@
 
 
 
-void AddCmpCodeIfSizeNot256 (const char* Code, long Size);
-/* Add a line of Assembly code that compares an index register
-** only if it isn't comparing to #<256.  (If the next line
-** is "bne", then this will avoid a redundant line.)
+void AddCmpCodeIfSizeNot256 (opc_t OPC, long Size);
+/* Add a compare instruction OPC for an index register only if it isn't
+** comparing to #<256.  (If the next line is "bne", then this will avoid a
+** redundant line.)
 */
 
 int FindStdFunc (const char* Name);
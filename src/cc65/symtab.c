@@ -53,6 +53,7 @@
 #include "error.h"
 #include "funcdesc.h"
 #include "global.h"
+#include "pch.h"
 #include "stackptr.h"
 #include "symentry.h"
 #include "typecmp.h"
@@ -980,6 +981,489 @@ SymEntry* AddGlobalSym (const char* Name, const Type* T, unsigned Flags)
 
 
 
+/*****************************************************************************/
+/*                            Precompiled headers                            */
+/*****************************************************************************/
+
+
+
+/* Symbol tables, function descriptors and symbols while reading or writing
+** a precompiled header. Tables are referenced by their index plus two, where
+** zero is NULL and one is EmptySymTab. Symbols are referenced by the table
+** they're in, and their position in the table.
+*/
+static Collection       PCHTables = STATIC_COLLECTION_INITIALIZER;
+static Collection       PCHFuncs  = STATIC_COLLECTION_INITIALIZER;
+static Collection       PCHSyms   = STATIC_COLLECTION_INITIALIZER;
+static unsigned*        PCHFirst  = 0;  /* Index of first symbol of each table */
+
+
+
+static void CollectSymTable (SymTable* Tab);
+/* Remember a symbol table and everything referenced by its symbols */
+
+
+
+static void CollectFunc (FuncDesc* F)
+/* Remember a function descriptor and its symbol tables */
+{
+    if (F != 0 && CollIndex (&PCHFuncs, F) < 0) {
+        CollAppend (&PCHFuncs, F);
+        CollectSymTable (F->SymTab);
+        CollectSymTable (F->TagTab);
+    }
+}
+
+
+
+static void CollectType (const Type* T)
+/* Remember the function descriptors and struct tags referenced by a type */
+{
+    if (T == 0) {
+        return;
+    }
+    while (T->C != T_END) {
+        if (IsTypeFunc (T)) {
+            CollectFunc (T->A.P);
+        } else if (IsClassStruct (T) && T->A.P != 0) {
+            CollectSymTable (((SymEntry*) T->A.P)->Owner);
+        }
+        ++T;
+    }
+}
+
+
+
+static void CollectSymTable (SymTable* Tab)
+/* Remember a symbol table and everything referenced by its symbols */
+{
+    SymEntry* E;
+
+    if (Tab == 0 || Tab == &EmptySymTab || CollIndex (&PCHTables, Tab) >= 0) {
+        return;
+    }
+    CollAppend (&PCHTables, Tab);
+    CollectSymTable (Tab->PrevTab);
+
+    for (E = Tab->SymHead; E; E = E->NextSym) {
+        CollectType (E->Type);
+        if (E->Flags & SC_TYPE) {
+            unsigned Type = E->Flags & SC_TYPEMASK;
+            if (Type == SC_STRUCT || Type == SC_UNION) {
+                CollectSymTable (E->V.S.SymTab);
+            }
+        } else if ((E->Flags & SC_CONST) != SC_CONST &&
+                   E->Type != 0 && IsTypeFunc (E->Type)) {
+            CollectFunc (E->V.F.Func);
+        }
+    }
+}
+
+
+
+static void WriteTabRef (const SymTable* Tab)
+/* Write a reference to a symbol table */
+{
+    if (Tab == 0) {
+        PCHWriteVar (0);
+    } else if (Tab == &EmptySymTab) {
+        PCHWriteVar (1);
+    } else {
+        int Index = CollIndex (&PCHTables, Tab);
+        CHECK (Index >= 0);
+        PCHWriteVar (Index + 2);
+    }
+}
+
+
+
+static SymTable* ReadTabRef (void)
+/* Read a reference to a symbol table */
+{
+    unsigned long Ref = PCHReadVar ();
+    if (Ref == 0) {
+        return 0;
+    } else if (Ref == 1) {
+        return &EmptySymTab;
+    } else {
+        return CollAt (&PCHTables, Ref - 2);
+    }
+}
+
+
+
+static void WriteSymRef (const SymEntry* Sym)
+/* Write a reference to a symbol */
+{
+    if (Sym == 0) {
+        WriteTabRef (0);
+    } else {
+        unsigned Index = 0;
+        const SymEntry* E = Sym->Owner->SymHead;
+        while (E != Sym) {
+            CHECK (E != 0);
+            ++Index;
+            E = E->NextSym;
+        }
+        WriteTabRef (Sym->Owner);
+        PCHWriteVar (Index);
+    }
+}
+
+
+
+static SymEntry* ReadSymRef (void)
+/* Read a reference to a symbol */
+{
+    unsigned long Ref = PCHReadVar ();
+    if (Ref < 2) {
+        return 0;
+    } else {
+        unsigned long Index = PCHReadVar ();
+        CHECK (Ref - 2 < CollCount (&PCHTables));
+        CHECK (Index < ((SymTable*) CollAt (&PCHTables, Ref - 2))->SymCount);
+        return CollAt (&PCHSyms, PCHFirst[Ref - 2] + Index);
+    }
+}
+
+
+
+static void WriteFuncRef (FuncDesc* F)
+/* Write a reference to a function descriptor */
+{
+    PCHWriteVar (F? CollIndex (&PCHFuncs, F) + 1 : 0);
+}
+
+
+
+static FuncDesc* ReadFuncRef (void)
+/* Read a reference to a function descriptor */
+{
+    unsigned long Ref = PCHReadVar ();
+    return Ref? CollAt (&PCHFuncs, Ref - 1) : 0;
+}
+
+
+
+static void WriteOptStr (const char* S)
+/* Write a string that may be NULL */
+{
+    PCHWriteVar (S != 0);
+    if (S) {
+        PCHWriteStr (S);
+    }
+}
+
+
+
+static char* ReadOptStr (void)
+/* Read a string that may be NULL and return a copy allocated on the heap */
+{
+    return PCHReadVar ()? xstrdup (PCHReadStr ()) : 0;
+}
+
+
+
+static void WriteType (const Type* T)
+/* Write a type string */
+{
+    if (T == 0) {
+        PCHWriteVar (0);
+        return;
+    }
+    PCHWriteVar (TypeLen (T) + 1);
+    while (T->C != T_END) {
+        PCHWriteVar (T->C);
+        if (IsTypeFunc (T)) {
+            WriteFuncRef (T->A.P);
+        } else if (IsClassStruct (T)) {
+            WriteSymRef (T->A.P);
+        } else {
+            PCHWriteVar ((unsigned long) T->A.L);
+        }
+        ++T;
+    }
+}
+
+
+
+static Type* ReadType (void)
+/* Read a type string */
+{
+    unsigned I;
+    Type* T;
+
+    unsigned Len = PCHReadVar ();
+    if (Len == 0) {
+        return 0;
+    }
+    T = TypeAlloc (Len);
+    for (I = 0; I < Len - 1; ++I) {
+        T[I].C = PCHReadVar ();
+        if (IsTypeFunc (T + I)) {
+            T[I].A.P = ReadFuncRef ();
+        } else if (IsClassStruct (T + I)) {
+            T[I].A.P = ReadSymRef ();
+        } else {
+            T[I].A.L = (long) PCHReadVar ();
+        }
+    }
+    T[I].C = T_END;
+    return T;
+}
+
+
+
+static void WriteSymData (const SymEntry* E)
+/* Write the data of a symbol */
+{
+    unsigned I;
+    unsigned Flags = E->Flags;
+
+    /* Type, attributes and assembler name */
+    WriteType (E->Type);
+    if (E->Attr) {
+        PCHWriteVar (CollCount (E->Attr));
+        for (I = 0; I < CollCount (E->Attr); ++I) {
+            const DeclAttr* A = CollConstAt (E->Attr, I);
+            PCHWriteVar (A->AttrType);
+        }
+    } else {
+        PCHWriteVar (0);
+    }
+    WriteOptStr (E->AsmName);
+
+    /* Data depending on the kind of symbol */
+    if (Flags & SC_TYPE) {
+        switch (Flags & SC_TYPEMASK) {
+            case SC_STRUCT:
+            case SC_UNION:
+                WriteTabRef (E->V.S.SymTab);
+                PCHWriteVar (E->V.S.Size);
+                break;
+            case SC_STRUCTFIELD:
+                PCHWriteVar ((unsigned long) E->V.Offs);
+                break;
+            case SC_BITFIELD:
+                PCHWriteVar (E->V.B.Offs);
+                PCHWriteVar (E->V.B.BitOffs);
+                PCHWriteVar (E->V.B.BitWidth);
+                break;
+            default:
+                break;
+        }
+    } else if ((Flags & SC_CONST) == SC_CONST) {
+        PCHWriteVar ((unsigned long) E->V.ConstVal);
+    } else if (E->Type != 0 && IsTypeFunc (E->Type)) {
+        WriteFuncRef (E->V.F.Func);
+    } else if (SymIsRegVar (E)) {
+        PCHWriteVar ((unsigned long) E->V.R.RegOffs);
+        PCHWriteVar ((unsigned long) E->V.R.SaveOffs);
+    } else if (Flags & SC_AUTO) {
+        PCHWriteVar ((unsigned long) E->V.Offs);
+    } else {
+        WriteOptStr (E->V.BssName);
+    }
+}
+
+
+
+static void ReadSymData (SymEntry* E)
+/* Read the data of a symbol */
+{
+    unsigned I;
+    unsigned Count;
+    unsigned Flags = E->Flags;
+
+    /* Type, attributes and assembler name */
+    E->Type = ReadType ();
+    Count = PCHReadVar ();
+    if (Count > 0) {
+        E->Attr = NewCollection ();
+        for (I = 0; I < Count; ++I) {
+            DeclAttr* A = xmalloc (sizeof (DeclAttr));
+            A->AttrType = (DeclAttrType) PCHReadVar ();
+            CollAppend (E->Attr, A);
+        }
+    }
+    E->AsmName = ReadOptStr ();
+
+    /* Data depending on the kind of symbol */
+    if (Flags & SC_TYPE) {
+        switch (Flags & SC_TYPEMASK) {
+            case SC_STRUCT:
+            case SC_UNION:
+                E->V.S.SymTab = ReadTabRef ();
+                E->V.S.Size   = PCHReadVar ();
+                break;
+            case SC_STRUCTFIELD:
+                E->V.Offs = (int) PCHReadVar ();
+                break;
+            case SC_BITFIELD:
+                E->V.B.Offs     = PCHReadVar ();
+                E->V.B.BitOffs  = PCHReadVar ();
+                E->V.B.BitWidth = PCHReadVar ();
+                break;
+            default:
+                break;
+        }
+    } else if ((Flags & SC_CONST) == SC_CONST) {
+        E->V.ConstVal = (long) PCHReadVar ();
+    } else if (E->Type != 0 && IsTypeFunc (E->Type)) {
+        E->V.F.Func    = ReadFuncRef ();
+        E->V.F.Seg     = 0;
+        E->V.F.LitPool = 0;
+    } else if (SymIsRegVar (E)) {
+        E->V.R.RegOffs  = (int) PCHReadVar ();
+        E->V.R.SaveOffs = (int) PCHReadVar ();
+    } else if (Flags & SC_AUTO) {
+        E->V.Offs = (int) PCHReadVar ();
+    } else {
+        E->V.BssName = ReadOptStr ();
+    }
+}
+
+
+
+void WriteSymTab (void)
+/* Write the global symbol tables to a precompiled header. Symbols that need
+** code or data cannot be written, this is flagged as an error.
+*/
+{
+    unsigned I;
+    const SymEntry* E;
+
+    /* A precompiled header may declare things, but not define them */
+    for (E = SymTab0->SymHead; E; E = E->NextSym) {
+        if ((E->Flags & (SC_TYPE | SC_CONST)) == 0 && SymIsDef (E)) {
+            Error ("Precompiled header must not define '%s'", E->Name);
+        }
+    }
+
+    /* Collect all symbol tables and function descriptors */
+    CollectSymTable (SymTab0);
+    CollectSymTable (TagTab0);
+
+    /* Write the tables with the names and flags of their symbols */
+    PCHWriteVar (CollCount (&PCHTables));
+    for (I = 0; I < CollCount (&PCHTables); ++I) {
+        const SymTable* T = CollConstAt (&PCHTables, I);
+        PCHWriteVar (T->Size);
+        PCHWriteVar (T->SymCount);
+        for (E = T->SymHead; E; E = E->NextSym) {
+            PCHWriteStr (E->Name);
+            PCHWriteVar (E->Flags);
+        }
+    }
+    for (I = 0; I < CollCount (&PCHTables); ++I) {
+        const SymTable* T = CollConstAt (&PCHTables, I);
+        WriteTabRef (T->PrevTab);
+    }
+    WriteTabRef (SymTab0);
+    WriteTabRef (TagTab0);
+
+    /* Write the function descriptors */
+    PCHWriteVar (CollCount (&PCHFuncs));
+    for (I = 0; I < CollCount (&PCHFuncs); ++I) {
+        const FuncDesc* F = CollConstAt (&PCHFuncs, I);
+        PCHWriteVar (F->Flags);
+        WriteTabRef (F->SymTab);
+        WriteTabRef (F->TagTab);
+        PCHWriteVar (F->ParamCount);
+        PCHWriteVar (F->ParamSize);
+        WriteSymRef (F->LastParam);
+        WriteSymRef (F->WrappedCall);
+        PCHWriteVar (F->WrappedCallData);
+    }
+
+    /* Write the data of all symbols */
+    for (I = 0; I < CollCount (&PCHTables); ++I) {
+        const SymTable* T = CollConstAt (&PCHTables, I);
+        for (E = T->SymHead; E; E = E->NextSym) {
+            WriteSymData (E);
+        }
+    }
+
+    CollDeleteAll (&PCHTables);
+    CollDeleteAll (&PCHFuncs);
+}
+
+
+
+void ReadSymTab (void)
+/* Replace the global symbol tables by the ones from a precompiled header */
+{
+    unsigned I, J;
+    unsigned Count;
+    SymTable* NewSymTab0;
+    SymTable* NewTagTab0;
+
+    /* We must be on global level, and nothing may have been declared */
+    PRECONDITION (LexicalLevel == LEX_LEVEL_GLOBAL &&
+                  SymTab == SymTab0 && SymTab0->SymCount == 0 &&
+                  TagTab == TagTab0 && TagTab0->SymCount == 0);
+
+    /* Read the tables and create their symbols */
+    Count = PCHReadVar ();
+    PCHFirst = xmalloc (Count * sizeof (PCHFirst[0]));
+    for (I = 0; I < Count; ++I) {
+        SymTable* T = NewSymTable (PCHReadVar ());
+        unsigned SymCount = PCHReadVar ();
+        PCHFirst[I] = CollCount (&PCHSyms);
+        for (J = 0; J < SymCount; ++J) {
+            SymEntry* E = NewSymEntry (PCHReadStr (), 0);
+            E->Flags = PCHReadVar ();
+            AddSymEntry (T, E);
+            CollAppend (&PCHSyms, E);
+        }
+        CollAppend (&PCHTables, T);
+    }
+    for (I = 0; I < Count; ++I) {
+        SymTable* T = CollAt (&PCHTables, I);
+        T->PrevTab = ReadTabRef ();
+    }
+    NewSymTab0 = ReadTabRef ();
+    NewTagTab0 = ReadTabRef ();
+
+    /* Read the function descriptors */
+    Count = PCHReadVar ();
+    for (I = 0; I < Count; ++I) {
+        FuncDesc* F = NewFuncDesc ();
+        CollAppend (&PCHFuncs, F);
+    }
+    for (I = 0; I < Count; ++I) {
+        FuncDesc* F = CollAt (&PCHFuncs, I);
+        F->Flags           = PCHReadVar ();
+        F->SymTab          = ReadTabRef ();
+        F->TagTab          = ReadTabRef ();
+        F->ParamCount      = PCHReadVar ();
+        F->ParamSize       = PCHReadVar ();
+        F->LastParam       = ReadSymRef ();
+        F->WrappedCall     = ReadSymRef ();
+        F->WrappedCallData = (unsigned char) PCHReadVar ();
+    }
+
+    /* Read the data of all symbols */
+    for (I = 0; I < CollCount (&PCHSyms); ++I) {
+        ReadSymData (CollAt (&PCHSyms, I));
+    }
+
+    /* Replace the empty global tables */
+    CHECK (NewSymTab0 != 0 && NewTagTab0 != 0);
+    FreeSymTable (SymTab0);
+    FreeSymTable (TagTab0);
+    SymTab0 = SymTab = NewSymTab0;
+    TagTab0 = TagTab = NewTagTab0;
+
+    xfree (PCHFirst);
+    PCHFirst = 0;
+    CollDeleteAll (&PCHTables);
+    CollDeleteAll (&PCHFuncs);
+    CollDeleteAll (&PCHSyms);
+}
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
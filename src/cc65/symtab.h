@@ -196,6 +196,14 @@ void EmitExternals (void);
 void EmitDebugInfo (void);
 /* Emit debug infos for the locals of the current scope */
 
+void WriteSymTab (void);
+/* Write the global symbol tables to a precompiled header. Symbols that need
+** code or data cannot be written, this is flagged as an error.
+*/
+
+void ReadSymTab (void);
+/* Replace the global symbol tables by the ones from a precompiled header */
+
 
 
 /* End of symtab.h */
@@ -44,6 +44,8 @@
 /* cc65 */
 #include "codeent.h"
 #include "error.h"
+#include "pch.h"
+#include "symtab.h"
 #include "wrappedcall.h"
 
 
@@ -100,3 +102,41 @@ void GetWrappedCall (void **Ptr, unsigned char *Val)
         *Val = (unsigned char) Temp;
     }
 }
+
+
+
+void WriteWrappedCalls (void)
+/* Write the WrappedCall stack to a precompiled header */
+{
+    unsigned I;
+    PCHWriteVar (WrappedCalls.Count);
+    for (I = 0; I < WrappedCalls.Count; ++I) {
+        const SymEntry* Sym = WrappedCalls.Stack[I].ptr;
+        PCHWriteVar ((unsigned long) WrappedCalls.Stack[I].val);
+        PCHWriteStr (Sym->Name);
+    }
+}
+
+
+
+void ReadWrappedCalls (void)
+/* Read the WrappedCall stack from a precompiled header. Must be called after
+** the symbol table has been read.
+*/
+{
+    unsigned I;
+    unsigned Count;
+
+    while (!IPS_IsEmpty (&WrappedCalls)) {
+        IPS_Drop (&WrappedCalls);
+    }
+    Count = PCHReadVar ();
+    for (I = 0; I < Count; ++I) {
+        long Val = (long) PCHReadVar ();
+        SymEntry* Sym = FindGlobalSym (PCHReadStr ());
+        if (Sym == 0) {
+            Internal ("Wrapped call target not found");
+        }
+        PushWrappedCall (Sym, (unsigned char) Val);
+    }
+}
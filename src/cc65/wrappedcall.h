@@ -59,6 +59,14 @@ void PopWrappedCall (void);
 void GetWrappedCall (void **Ptr, unsigned char *Val);
 /* Get the current WrappedCall, if any */
 
+void WriteWrappedCalls (void);
+/* Write the WrappedCall stack to a precompiled header */
+
+void ReadWrappedCalls (void);
+/* Read the WrappedCall stack from a precompiled header. Must be called after
+** the symbol table has been read.
+*/
+
 
 /* End of wrappedcall.h */
 
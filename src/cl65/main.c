@@ -42,6 +42,12 @@
 #  define NEED_SPAWN 1
 #endif
 
+/* Pipes between the tools and the compile server need Unix */
+#if defined(NEED_SPAWN) && !defined(_AMIGA)
+#  define HAVE_PIPE     1
+#  define HAVE_SERVER   1
+#endif
+
 /* GCC strictly follows http://c-faq.com/ansi/constmismatch.html and issues an
 ** 'incompatible pointer type' warning - that can't be suppressed via #pragma.
 ** The spawnvp() prototype of MinGW (http://www.mingw.org/) differs from the
@@ -103,22 +109,30 @@ struct CmdDesc {
     unsigned    FileCount;      /* Count of files to translate */
     unsigned    FileMax;        /* Maximum count of files */
     char**      Files;          /* The files */
+
+    int         Resident;       /* Control socket of a resident process or -1 */
 };
 
 /* Command descriptors for the different programs */
-static CmdDesc CC65 = { 0, 0, 0, 0, 0, 0, 0 };
-static CmdDesc CA65 = { 0, 0, 0, 0, 0, 0, 0 };
-static CmdDesc CO65 = { 0, 0, 0, 0, 0, 0, 0 };
-static CmdDesc LD65 = { 0, 0, 0, 0, 0, 0, 0 };
-static CmdDesc GRC  = { 0, 0, 0, 0, 0, 0, 0 };
+static CmdDesc CC65 = { 0, 0, 0, 0, 0, 0, 0, -1 };
+static CmdDesc CA65 = { 0, 0, 0, 0, 0, 0, 0, -1 };
+static CmdDesc CO65 = { 0, 0, 0, 0, 0, 0, 0, -1 };
+static CmdDesc LD65 = { 0, 0, 0, 0, 0, 0, 0, -1 };
+static CmdDesc GRC  = { 0, 0, 0, 0, 0, 0, 0, -1 };
 
 /* Pseudo-command to track files we want to delete */
-static CmdDesc RM   = { 0, 0, 0, 0, 0, 0, 0 };
+static CmdDesc RM   = { 0, 0, 0, 0, 0, 0, 0, -1 };
 
 /* Variables controlling the steps we're doing */
 static int DoLink       = 1;
 static int DoAssemble   = 1;
 
+/* Feed the compiler output into the assembler through a pipe */
+static int Pipe         = 0;
+
+/* Verbose mode */
+static int Verbose      = 0;
+
 /* The name of the output file, NULL if none given */
 static const char* OutputName = 0;
 
@@ -144,6 +158,9 @@ static int Module = 0;
 static char* TargetLib   = 0;
 static int   NoTargetLib = 0;
 
+/* Server mode: The directory of the socket */
+static const char* ServerDir = 0;
+
 
 
 /*****************************************************************************/
@@ -157,6 +174,7 @@ static int   NoTargetLib = 0;
 #    include "spawn-amiga.inc"
 #  else
 #    include "spawn-unix.inc"
+#    include "server-unix.inc"
 #  endif
 #endif
 
@@ -437,7 +455,15 @@ static void ExecProgram (CmdDesc* Cmd)
     }
 
     /* Call the program */
+#if defined(HAVE_SERVER)
+    if (Cmd->Resident >= 0) {
+        Status = spawnresident (Cmd->Resident, Cmd->Name, Cmd->Args);
+    } else {
+        Status = spawnvp (P_WAIT, Cmd->Name, SPAWN_ARGV_CONST_CAST Cmd->Args);
+    }
+#else
     Status = spawnvp (P_WAIT, Cmd->Name, SPAWN_ARGV_CONST_CAST Cmd->Args);
+#endif
 
     /* Check the result code */
     if (Status < 0) {
@@ -451,6 +477,42 @@ static void ExecProgram (CmdDesc* Cmd)
 
 
 
+#if defined(HAVE_PIPE)
+
+static void ExecPipe (CmdDesc* From, CmdDesc* To, const char* Output)
+/* Execute two subprocesses, with the output of the first one fed into the
+** second one. Exit on errors. If the first one fails, the output file of the
+** second one is removed, since it was created from incomplete input.
+*/
+{
+    int Status1, Status2;
+
+    /* Call the programs */
+#if defined(HAVE_SERVER)
+    if (From->Resident >= 0 && To->Resident >= 0) {
+        spawnpiperesident (From->Resident, From->Name, From->Args,
+                           To->Resident, To->Name, To->Args,
+                           &Status1, &Status2);
+    } else {
+        spawnpipevp (From->Name, From->Args, To->Name, To->Args, &Status1, &Status2);
+    }
+#else
+    spawnpipevp (From->Name, From->Args, To->Name, To->Args, &Status1, &Status2);
+#endif
+
+    /* Check the result codes */
+    if (Status1 != 0) {
+        remove (Output);
+        exit (Status1);
+    } else if (Status2 != 0) {
+        exit (Status2);
+    }
+}
+
+#endif
+
+
+
 static void RemoveTempFiles (void)
 {
     unsigned I;
@@ -617,6 +679,55 @@ static void Assemble (const char* File)
 
 
 
+#if defined(HAVE_PIPE)
+
+static void CompileAndAssemble (const char* File)
+/* Compile the given file and feed the compiler output directly into the
+** assembler. The compiler command must be complete except for the output and
+** input file.
+*/
+{
+    /* Remember the current assembler argument count */
+    unsigned ArgCount = CA65.ArgCount;
+
+    /* The assembler reads from stdin, so it cannot derive the name of the
+    ** object file from its input file. Determine the name here.
+    */
+    char* ObjName;
+    if (DoLink || OutputName == 0) {
+        ObjName = MakeFilename (File, ".o");
+    } else {
+        ObjName = xstrdup (OutputName);
+    }
+    if (DoLink) {
+        /* We're linking later, and the object file is a temporary file */
+        CmdAddFile (&LD65, ObjName);
+        CmdAddFile (&RM, ObjName);
+    }
+
+    /* The compiler writes to stdout */
+    CmdSetOutput (&CC65, "-");
+    CmdAddArg (&CC65, File);
+    CmdAddArg (&CC65, 0);
+
+    /* The assembler reads from stdin */
+    CmdSetTarget (&CA65, Target);
+    CmdSetOutput (&CA65, ObjName);
+    CmdAddArg (&CA65, "-");
+    CmdAddArg (&CA65, 0);
+
+    /* Run both */
+    ExecPipe (&CC65, &CA65, ObjName);
+
+    /* Remove the excess arguments */
+    CmdDelArgs (&CA65, ArgCount);
+    xfree (ObjName);
+}
+
+#endif
+
+
+
 static void Compile (const char* File)
 /* Compile the given file */
 {
@@ -654,6 +765,18 @@ static void Compile (const char* File)
         }
     }
 
+#if defined(HAVE_PIPE)
+    /* Use a pipe instead of an intermediate file if requested. Verbose and
+    ** debug output of the compiler would end up in the pipe, so don't use it
+    ** in these cases.
+    */
+    if (DoAssemble && Pipe && !Verbose && !Debug) {
+        CompileAndAssemble (File);
+        CmdDelArgs (&CC65, ArgCount);
+        return;
+    }
+#endif
+
     /* Add the file as argument for the compiler */
     CmdAddArg (&CC65, File);
 
@@ -806,6 +929,7 @@ static void Usage (void)
             "  --code-name seg\t\tSet the name of the CODE segment\n"
             "  --codesize x\t\t\tAccept larger code by factor x\n"
             "  --config name\t\t\tUse linker config file\n"
+            "  --connect dir\t\t\tUse the tools of a compile server\n"
             "  --cpu type\t\t\tSet CPU type\n"
             "  --create-dep name\t\tCreate a make dependency file\n"
             "  --create-full-dep name\tCreate a full make dependency file\n"
@@ -815,6 +939,8 @@ static void Usage (void)
             "  --debug-info\t\t\tAdd debug info\n"
             "  --feature name\t\tSet an emulation feature\n"
             "  --force-import sym\t\tForce an import of symbol 'sym'\n"
+            "  --function-sections\t\tPlace each function in its own section\n"
+            "  --gc-sections\t\t\tRemove unused sections when linking\n"
             "  --help\t\t\tHelp (this text)\n"
             "  --include-dir dir\t\tSet a compiler include directory path\n"
             "  --ld-args options\t\tPass options to the linker\n"
@@ -830,10 +956,12 @@ static void Usage (void)
             "  --o65-model model\t\tOverride the o65 model\n"
             "  --obj file\t\t\tLink this object file\n"
             "  --obj-path path\t\tSpecify an object file search path\n"
+            "  --pipe\t\t\tPipe the compiler output into the assembler\n"
             "  --print-target-path\t\tPrint the target file path\n"
             "  --register-space b\t\tSet space available for register variables\n"
             "  --register-vars\t\tEnable register variables\n"
             "  --rodata-name seg\t\tSet the name of the RODATA segment\n"
+            "  --server dir\t\t\tRun as a compile server\n"
             "  --signed-chars\t\tDefault characters are signed\n"
             "  --standard std\t\tLanguage standard (c89, c99, cc65)\n"
             "  --start-addr addr\t\tSet the default start address\n"
@@ -975,6 +1103,19 @@ static void OptConfig (const char* Opt attribute ((unused)), const char* Arg)
 
 
 
+static void OptConnect (const char* Opt attribute ((unused)), const char* Arg)
+/* Use the tools of a compile server */
+{
+#if defined(HAVE_SERVER)
+    Connect (Arg);
+#else
+    (void) Arg;
+    Error ("Compile servers are not supported on this platform");
+#endif
+}
+
+
+
 static void OptCPU (const char* Opt attribute ((unused)), const char* Arg)
 /* Handle the --cpu option */
 {
@@ -1064,6 +1205,24 @@ static void OptForceImport (const char* Opt attribute ((unused)), const char* Ar
 
 
 
+static void OptFunctionSections (const char* Opt attribute ((unused)),
+                                 const char* Arg attribute ((unused)))
+/* Handle the --function-sections option */
+{
+    CmdAddArg (&CC65, "--function-sections");
+}
+
+
+
+static void OptGCSections (const char* Opt attribute ((unused)),
+                           const char* Arg attribute ((unused)))
+/* Handle the --gc-sections option */
+{
+    CmdAddArg (&LD65, "--gc-sections");
+}
+
+
+
 static void OptHelp (const char* Opt attribute ((unused)),
                      const char* Arg attribute ((unused)))
 /* Print help - cl65 */
@@ -1207,6 +1366,15 @@ static void OptObjPath (const char* Opt attribute ((unused)), const char* Arg)
 
 
 
+static void OptPipe (const char* Opt attribute ((unused)),
+                     const char* Arg attribute ((unused)))
+/* Pipe the compiler output into the assembler */
+{
+    Pipe = 1;
+}
+
+
+
 static void OptPrintTargetPath (const char* Opt attribute ((unused)),
                                 const char* Arg attribute ((unused)))
 /* Print the target file path */
@@ -1259,6 +1427,19 @@ static void OptRodataName (const char* Opt attribute ((unused)), const char* Arg
 
 
 
+static void OptServer (const char* Opt attribute ((unused)), const char* Arg)
+/* Run as a compile server */
+{
+#if defined(HAVE_SERVER)
+    ServerDir = Arg;
+#else
+    (void) Arg;
+    Error ("Compile servers are not supported on this platform");
+#endif
+}
+
+
+
 static void OptSignedChars (const char* Opt attribute ((unused)),
                             const char* Arg attribute ((unused)))
 /* Make default characters signed */
@@ -1314,6 +1495,7 @@ static void OptVerbose (const char* Opt attribute ((unused)),
     CmdAddArg (&CA65, "-v");
     CmdAddArg (&CO65, "-v");
     CmdAddArg (&LD65, "-v");
+    Verbose = 1;
 }
 
 
@@ -1364,6 +1546,7 @@ int main (int argc, char* argv [])
         { "--code-name",         1, OptCodeName       },
         { "--codesize",          1, OptCodeSize       },
         { "--config",            1, OptConfig         },
+        { "--connect",           1, OptConnect        },
         { "--cpu",               1, OptCPU            },
         { "--create-dep",        1, OptCreateDep      },
         { "--create-full-dep",   1, OptCreateFullDep  },
@@ -1373,6 +1556,8 @@ int main (int argc, char* argv [])
         { "--debug-info",        0, OptDebugInfo      },
         { "--feature",           1, OptFeature        },
         { "--force-import",      1, OptForceImport    },
+        { "--function-sections", 0, OptFunctionSections },
+        { "--gc-sections",       0, OptGCSections     },
         { "--help",              0, OptHelp           },
         { "--include-dir",       1, OptIncludeDir     },
         { "--ld-args",           1, OptLdArgs         },
@@ -1388,10 +1573,12 @@ int main (int argc, char* argv [])
         { "--o65-model",         1, OptO65Model       },
         { "--obj",               1, OptObj            },
         { "--obj-path",          1, OptObjPath        },
+        { "--pipe",              0, OptPipe           },
         { "--print-target-path", 0, OptPrintTargetPath},
         { "--register-space",    1, OptRegisterSpace  },
         { "--register-vars",     0, OptRegisterVars   },
         { "--rodata-name",       1, OptRodataName     },
+        { "--server",            1, OptServer         },
         { "--signed-chars",      0, OptSignedChars    },
         { "--standard",          1, OptStandard       },
         { "--start-addr",        1, OptStartAddr      },
@@ -1642,6 +1829,16 @@ int main (int argc, char* argv [])
         ++I;
     }
 
+#if defined(HAVE_SERVER)
+    /* In server mode, we don't return from here */
+    if (ServerDir) {
+        if (FirstInput) {
+            Error ("Cannot translate files in server mode");
+        }
+        RunServer (ServerDir);
+    }
+#endif
+
     /* Check if we had any input files */
     if (FirstInput == 0) {
         Warning ("No input files");
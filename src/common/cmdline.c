@@ -41,6 +41,7 @@
 #include "abend.h"
 #include "chartype.h"
 #include "fname.h"
+#include "resident.h"
 #include "xmalloc.h"
 #include "cmdline.h"
 
@@ -183,6 +184,13 @@ void InitCmdLine (int* aArgCount, char*** aArgVec, const char* aProgName)
         }
     }
 
+#if defined(HAVE_RESIDENT)
+    /* If we were started as a resident process, this returns with the command
+    ** line of a job.
+    */
+    ResidentMain (aArgCount, aArgVec);
+#endif
+
     /* Make a CmdLine struct */
     NewCmdLine (&L);
 
@@ -0,0 +1,198 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 filemap.c                                 */
+/*                                                                           */
+/*                 Read only access to the contents of a file                */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+#include <errno.h>
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+/* common */
+#include "filemap.h"
+#include "xmalloc.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static int ReadStreamContents (MappedFile* M, FILE* F)
+/* Read the remaining contents of a stream into a memory buffer. Return true
+** on success.
+*/
+{
+    unsigned char* Buf = 0;
+    unsigned long  Size = 0;
+    unsigned long  Max = 0;
+    size_t         Count;
+
+    /* Read the file in chunks, growing the buffer as needed. This works
+    ** for files of unknown size (pipes, devices) as well.
+    */
+    do {
+        if (Size == Max) {
+            Max = (Max == 0)? 0x10000 : Max * 2;
+            Buf = xrealloc (Buf, Max);
+        }
+        Count = fread (Buf + Size, 1, Max - Size, F);
+        Size += Count;
+    } while (Count > 0);
+
+    if (ferror (F)) {
+        xfree (Buf);
+        errno = EIO;
+        return 0;
+    }
+
+    M->Data   = Buf;
+    M->Size   = Size;
+    M->Mapped = 0;
+    return 1;
+}
+
+
+
+static int ReadFileContents (MappedFile* M, const char* Name)
+/* Read the file into a memory buffer. Return true on success. */
+{
+    int Success;
+
+    FILE* F = fopen (Name, "rb");
+    if (F == 0) {
+        return 0;
+    }
+    Success = ReadStreamContents (M, F);
+    (void) fclose (F);
+    return Success;
+}
+
+
+
+#if !defined(_WIN32)
+
+static int MapFileContents (MappedFile* M, const char* Name)
+/* Map the file into memory. Return true on success. */
+{
+    struct stat S;
+    void* Data;
+
+    int FD = open (Name, O_RDONLY);
+    if (FD < 0) {
+        return 0;
+    }
+    if (fstat (FD, &S) != 0 || !S_ISREG (S.st_mode) || S.st_size == 0) {
+        /* Not something we can map, leave it to the caller to read it */
+        close (FD);
+        return 0;
+    }
+
+    /* The mapping stays valid after closing the file */
+    Data = mmap (0, S.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+    close (FD);
+    if (Data == MAP_FAILED) {
+        return 0;
+    }
+
+    M->Data   = Data;
+    M->Size   = S.st_size;
+    M->Mapped = 1;
+    return 1;
+}
+
+#endif
+
+
+
+MappedFile* MapFile (const char* Name)
+/* Make the contents of the given file available in memory. Returns NULL if
+** the file cannot be opened or read, in which case errno describes the
+** problem.
+*/
+{
+    MappedFile* M = xmalloc (sizeof (MappedFile));
+
+#if !defined(_WIN32)
+    if (MapFileContents (M, Name)) {
+        return M;
+    }
+#endif
+
+    /* Mapping isn't possible, read the file instead */
+    if (ReadFileContents (M, Name)) {
+        return M;
+    }
+
+    xfree (M);
+    return 0;
+}
+
+
+
+MappedFile* MapStream (FILE* F)
+/* Read the remaining contents of an open stream, for example stdin, into
+** memory. The stream isn't closed. Returns NULL if the stream cannot be read,
+** in which case errno describes the problem.
+*/
+{
+    MappedFile* M = xmalloc (sizeof (MappedFile));
+    if (ReadStreamContents (M, F)) {
+        return M;
+    }
+    xfree (M);
+    return 0;
+}
+
+
+
+void UnmapFile (MappedFile* M)
+/* Release the file contents and the MappedFile structure */
+{
+#if !defined(_WIN32)
+    if (M->Mapped) {
+        munmap ((void*) M->Data, M->Size);
+    } else
+#endif
+    {
+        xfree ((void*) M->Data);
+    }
+    xfree (M);
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 filemap.h                                 */
+/*                                                                           */
+/*                 Read only access to the contents of a file                */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef FILEMAP_H
+#define FILEMAP_H
+
+
+
+#include <stdio.h>
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* The contents of a file, mapped into memory if the system supports it,
+** otherwise read into a memory buffer.
+*/
+typedef struct MappedFile MappedFile;
+struct MappedFile {
+    const unsigned char*    Data;       /* File contents */
+    unsigned long           Size;       /* Size of the file */
+    int                     Mapped;     /* True if the data is mapped */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+MappedFile* MapFile (const char* Name);
+/* Make the contents of the given file available in memory. Returns NULL if
+** the file cannot be opened or read, in which case errno describes the
+** problem.
+*/
+
+MappedFile* MapStream (FILE* F);
+/* Read the remaining contents of an open stream, for example stdin, into
+** memory. The stream isn't closed. Returns NULL if the stream cannot be read,
+** in which case errno describes the problem.
+*/
+
+void UnmapFile (MappedFile* M);
+/* Release the file contents and the MappedFile structure */
+
+
+
+/* End of filemap.h */
+
+#endif
@@ -40,17 +40,108 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Minimum number of slots in a table */
+#define HT_MIN_SLOTS    8U
+
+/* The table is enlarged if it is more than 3/4 full */
+#define HT_FULL(Count, Slots)   ((Count) * 4U > (Slots) * 3U)
+
+
+
+/*****************************************************************************/
+/*                              Helper functions                             */
+/*****************************************************************************/
+
+
+
+static unsigned HT_Home (const HashTable* T, unsigned Hash)
+/* Return the home slot for the given hash. Many hash functions in use don't
+** distribute well in the low bits (think of string pool ids), so the hash is
+** mixed before reducing it to the table size.
+*/
+{
+    Hash &= 0xFFFFFFFFU;
+    Hash ^= Hash >> 16;
+    Hash  = (Hash * 0x85EBCA6BU) & 0xFFFFFFFFU;
+    Hash ^= Hash >> 13;
+    Hash  = (Hash * 0xC2B2AE35U) & 0xFFFFFFFFU;
+    Hash ^= Hash >> 16;
+    return Hash & (T->Slots - 1);
+}
+
+
+
+static unsigned HT_SlotsFor (unsigned Count)
+/* Return the number of slots needed to hold Count entries */
+{
+    unsigned Slots = HT_MIN_SLOTS;
+    while (HT_FULL (Count, Slots)) {
+        Slots <<= 1;
+    }
+    return Slots;
+}
+
+
+
+static void HT_Place (HashTable* T, unsigned Hash, HashNode* N)
+/* Place a node into the first free slot of its probe sequence */
+{
+    unsigned Mask = T->Slots - 1;
+    unsigned I = HT_Home (T, Hash);
+    while (T->Table[I].Node) {
+        I = (I + 1) & Mask;
+    }
+    T->Table[I].Hash = Hash;
+    T->Table[I].Node = N;
+}
+
+
+
+static void HT_Resize (HashTable* T, unsigned Slots)
+/* Reallocate the table with the given number of slots and rehash all entries */
+{
+    unsigned  I;
+    HashSlot* Old      = T->Table;
+    unsigned  OldSlots = T->Slots;
+
+    /* Allocate and clear the new table */
+    T->Slots = Slots;
+    T->Table = xmalloc (Slots * sizeof (T->Table[0]));
+    for (I = 0; I < Slots; ++I) {
+        T->Table[I].Node = 0;
+    }
+
+    /* Move the entries over */
+    for (I = 0; I < OldSlots; ++I) {
+        if (Old[I].Node) {
+            HT_Place (T, Old[I].Hash, Old[I].Node);
+        }
+    }
+    xfree (Old);
+}
+
+
+
 /*****************************************************************************/
 /*                             struct HashTable                              */
 /*****************************************************************************/
 
 
 
-HashTable* InitHashTable (HashTable* T, unsigned Slots, const HashFunctions* Func)
-/* Initialize a hash table and return it */
+HashTable* InitHashTable (HashTable* T, unsigned Size, const HashFunctions* Func)
+/* Initialize a hash table and return it. Size is the number of entries
+** expected, the table will grow if more are added.
+*/
 {
     /* Initialize the fields */
-    T->Slots    = Slots;
+    T->Size     = Size;
+    T->Slots    = 0;
     T->Count    = 0;
     T->Table    = 0;
     T->Func     = Func;
@@ -66,7 +157,7 @@ void DoneHashTable (HashTable* T)
 ** in the table!
 */
 {
-    /* Just free the array with the table pointers */
+    /* Just free the array with the slots */
     xfree (T->Table);
 }
 
@@ -85,53 +176,39 @@ void FreeHashTable (HashTable* T)
 
 
 
-static void HT_Alloc (HashTable* T)
-/* Allocate table memory */
-{
-    unsigned I;
-
-    /* Allocate memory */
-    T->Table = xmalloc (T->Slots * sizeof (T->Table[0]));
-
-    /* Initialize the table */
-    for (I = 0; I < T->Slots; ++I) {
-        T->Table[I] = 0;
-    }
-}
-
-
-
 HashNode* HT_FindHash (const HashTable* T, const void* Key, unsigned Hash)
 /* Find the node with the given key. Differs from HT_Find in that the hash
 ** for the key is precalculated and passed to the function.
 */
 {
-    HashNode* N;
+    unsigned Mask;
+    unsigned I;
 
     /* If we don't have a table, there's nothing to find */
     if (T->Table == 0) {
         return 0;
     }
 
-    /* Search for the entry in the given chain */
-    N = T->Table[Hash % T->Slots];
-    while (N) {
+    /* Follow the probe sequence until we hit a free slot */
+    Mask = T->Slots - 1;
+    I    = HT_Home (T, Hash);
+    while (T->Table[I].Node) {
 
         /* First compare the full hash, to avoid calling the compare function
         ** if it is not really necessary.
         */
-        if (N->Hash == Hash &&
-            T->Func->Compare (Key, T->Func->GetKey (N)) == 0) {
+        if (T->Table[I].Hash == Hash &&
+            T->Func->Compare (Key, T->Func->GetKey (T->Table[I].Node)) == 0) {
             /* Found */
-            break;
+            return T->Table[I].Node;
         }
 
-        /* Not found, next entry */
-        N = N->Next;
+        /* Not found, next slot */
+        I = (I + 1) & Mask;
     }
 
-    /* Return what we found */
-    return N;
+    /* Not found */
+    return 0;
 }
 
 
@@ -146,28 +223,23 @@ void* HT_Find (const HashTable* T, const void* Key)
 
 
 void HT_Insert (HashTable* T, void* Entry)
-/* Insert an entry into the given hash table */
+/* Insert an entry into the given hash table. The table is enlarged if the
+** load factor gets too high.
+*/
 {
-    HashNode* N;
-    unsigned RHash;
+    /* The first member of Entry is also the hash node */
+    HashNode* N = Entry;
 
-    /* If we don't have a table, we need to allocate it now */
+    /* Allocate the table on first use, or grow it if it gets too full */
     if (T->Table == 0) {
-        HT_Alloc (T);
+        HT_Resize (T, HT_SlotsFor (T->Size > T->Count + 1? T->Size : T->Count + 1));
+    } else if (HT_FULL (T->Count + 1, T->Slots)) {
+        HT_Resize (T, T->Slots * 2);
     }
 
-    /* The first member of Entry is also the hash node */
-    N = Entry;
-
-    /* Generate the hash over the node key. */
+    /* Generate the hash over the node key and place the node */
     N->Hash = T->Func->GenHash (T->Func->GetKey (N));
-
-    /* Calculate the reduced hash */
-    RHash = N->Hash % T->Slots;
-
-    /* Insert the entry into the correct chain */
-    N->Next = T->Table[RHash];
-    T->Table[RHash] = N;
+    HT_Place (T, N->Hash, N);
 
     /* One more entry */
     ++T->Count;
@@ -180,26 +252,44 @@ void HT_Remove (HashTable* T, void* Entry)
 {
     /* The first member of Entry is also the hash node */
     HashNode* N = Entry;
+    unsigned  Mask;
+    unsigned  I, J;
+
+    /* Search for the slot holding the node. If we hit a free slot, the node
+    ** is not in the table which we will consider a serious error.
+    */
+    CHECK (T->Table != 0);
+    Mask = T->Slots - 1;
+    I    = HT_Home (T, N->Hash);
+    while (T->Table[I].Node != N) {
+        CHECK (T->Table[I].Node != 0);
+        I = (I + 1) & Mask;
+    }
 
-    /* Calculate the reduced hash, which is also the slot number */
-    unsigned Slot = N->Hash % T->Slots;
-
-    /* Remove the entry from the single linked list */
-    HashNode** Q = &T->Table[Slot];
+    /* Close the gap by moving back following entries of the same cluster
+    ** that would otherwise become unreachable. This avoids tombstones, so
+    ** lookups never slow down because of deleted entries.
+    */
+    J = I;
     while (1) {
-        /* If the pointer is NULL, the node is not in the table which we will
-        ** consider a serious error.
-        */
-        CHECK (*Q != 0);
-        if (*Q == N) {
-            /* Found - remove it */
-            *Q = N->Next;
-            --T->Count;
+        unsigned Home;
+        J = (J + 1) & Mask;
+        if (T->Table[J].Node == 0) {
             break;
         }
-        /* Next node */
-        Q = &(*Q)->Next;
+        /* The entry in J may be moved to I if its home slot isn't in the
+        ** cyclic range (I, J].
+        */
+        Home = HT_Home (T, T->Table[J].Hash);
+        if (I <= J? (Home <= I || Home > J) : (Home <= I && Home > J)) {
+            T->Table[I] = T->Table[J];
+            I = J;
+        }
     }
+    T->Table[I].Node = 0;
+
+    /* One entry less */
+    --T->Count;
 }
 
 
@@ -210,37 +300,38 @@ void HT_Walk (HashTable* T, int (*F) (void* Entry, void* Data), void* Data)
 ** pointer to the entry, and the data pointer passed to HT_Walk by the caller.
 ** If F returns true, the node is deleted from the hash table otherwise it's
 ** left in place. While deleting the node, the node is not accessed, so it is
-** safe for F to free the memory associcated with the entry.
+** safe for F to free the memory associcated with the entry. F must not add
+** entries to or remove entries from the table itself.
 */
 {
     unsigned I;
+    unsigned Deleted = 0;
 
     /* If we don't have a table there are no entries to walk over */
     if (T->Table == 0) {
         return;
     }
 
-    /* Walk over all chains */
+    /* Walk over all slots. Deleted entries just leave an empty slot behind,
+    ** because moving entries around would make us visit some of them twice.
+    */
     for (I = 0; I < T->Slots; ++I) {
-
-        /* Get the pointer to the first entry of the hash chain */
-        HashNode** Cur = &T->Table[I];
-
-        /* Walk over all entries in this chain */
-        while (*Cur) {
-            /* Fetch the next node in chain now, because F() may delete it */
-            HashNode* Next = (*Cur)->Next;
-            /* Call the user function. N is also the pointer to the entry. If
-            ** the function returns true, the entry is to be deleted.
-            */
-            if (F (*Cur, Data)) {
-                /* Delete the node from the chain */
-                *Cur = Next;
-                --T->Count;
-            } else {
-                /* Next node in chain */
-                Cur = &(*Cur)->Next;
-            }
+        /* Call the user function. Node is also the pointer to the entry. If
+        ** the function returns true, the entry is to be deleted.
+        */
+        if (T->Table[I].Node && F (T->Table[I].Node, Data)) {
+            T->Table[I].Node = 0;
+            ++Deleted;
         }
     }
+
+    /* The empty slots may have broken probe sequences, so rehash the table
+    ** if something was deleted. Shrink it at the same time if possible.
+    */
+    if (Deleted) {
+        unsigned Slots;
+        T->Count -= Deleted;
+        Slots = HT_SlotsFor (T->Count);
+        HT_Resize (T, Slots < T->Slots? Slots : T->Slots);
+    }
 }
@@ -57,11 +57,10 @@
 */
 typedef struct HashNode HashNode;
 struct HashNode {
-    HashNode*           Next;           /* Next entry in hash list */
     unsigned            Hash;           /* The full hash value */
 };
 
-#define STATIC_HASHNODE_INITIALIZER     { 0, 0, 0 }
+#define STATIC_HASHNODE_INITIALIZER     { 0 }
 
 /* Hash table functions */
 typedef struct HashFunctions HashFunctions;
@@ -80,16 +79,28 @@ struct HashFunctions {
     */
 };
 
-/* Hash table */
+/* Hash table slot. The full hash is kept in the slot, so probing the table
+** doesn't have to touch the entries themselves.
+*/
+typedef struct HashSlot HashSlot;
+struct HashSlot {
+    unsigned            Hash;           /* Full hash value of the entry */
+    HashNode*           Node;           /* Entry, NULL if the slot is free */
+};
+
+/* Hash table. The table uses open addressing with linear probing and grows
+** automatically, so Size is just a hint for the number of entries expected.
+*/
 typedef struct HashTable HashTable;
 struct HashTable {
-    unsigned                    Slots;  /* Number of table slots */
+    unsigned                    Size;   /* Expected number of entries */
+    unsigned                    Slots;  /* Number of slots, a power of two */
     unsigned                    Count;  /* Number of table entries */
-    HashNode**                  Table;  /* Table, dynamically allocated */
+    HashSlot*                   Table;  /* Table, dynamically allocated */
     const HashFunctions*        Func;   /* Table functions */
 };
 
-#define STATIC_HASHTABLE_INITIALIZER(Slots, Func)   { Slots, 0, 0, Func }
+#define STATIC_HASHTABLE_INITIALIZER(Size, Func)    { Size, 0, 0, 0, Func }
 
 
 
@@ -103,10 +114,10 @@ struct HashTable {
 INLINE void InitHashNode (HashNode* N)
 /* Initialize a hash node. */
 {
-    N->Next     = 0;
+    N->Hash     = 0;
 }
 #else
-#define InitHashNode(N)         do { (N)->Next   = 0; } while (0)
+#define InitHashNode(N)         do { (N)->Hash   = 0; } while (0)
 #endif
 
 
@@ -117,8 +128,10 @@ INLINE void InitHashNode (HashNode* N)
 
 
 
-HashTable* InitHashTable (HashTable* T, unsigned Slots, const HashFunctions* Func);
-/* Initialize a hash table and return it */
+HashTable* InitHashTable (HashTable* T, unsigned Size, const HashFunctions* Func);
+/* Initialize a hash table and return it. Size is the number of entries
+** expected, the table will grow if more are added.
+*/
 
 void DoneHashTable (HashTable* T);
 /* Destroy the contents of a hash table. Note: This will not free the entries
@@ -126,14 +139,14 @@ void DoneHashTable (HashTable* T);
 */
 
 #if defined(HAVE_INLINE)
-INLINE HashTable* NewHashTable (unsigned Slots, const HashFunctions* Func)
+INLINE HashTable* NewHashTable (unsigned Size, const HashFunctions* Func)
 /* Create a new hash table and return it. */
 {
     /* Allocate memory, initialize and return it */
-    return InitHashTable (xmalloc (sizeof (HashTable)), Slots, Func);
+    return InitHashTable (xmalloc (sizeof (HashTable)), Size, Func);
 }
 #else
-#define NewHashTable(Slots, Func) InitHashTable(xmalloc (sizeof (HashTable)), Slots, Func)
+#define NewHashTable(Size, Func) InitHashTable(xmalloc (sizeof (HashTable)), Size, Func)
 #endif
 
 void FreeHashTable (HashTable* T);
@@ -158,7 +171,9 @@ void* HT_Find (const HashTable* T, const void* Key);
 /* Find the entry with the given key and return it */
 
 void HT_Insert (HashTable* T, void* Entry);
-/* Insert an entry into the given hash table */
+/* Insert an entry into the given hash table. The table is enlarged if the
+** load factor gets too high.
+*/
 
 void HT_Remove (HashTable* T, void* Entry);
 /* Remove an entry from the given hash table */
@@ -169,7 +184,8 @@ void HT_Walk (HashTable* T, int (*F) (void* Entry, void* Data), void* Data);
 ** pointer to the entry, and the data pointer passed to HT_Walk by the caller.
 ** If F returns true, the node is deleted from the hash table otherwise it's
 ** left in place. While deleting the node, the node is not accessed, so it is
-** safe for F to free the memory associcated with the entry.
+** safe for F to free the memory associcated with the entry. F must not add
+** entries to or remove entries from the table itself.
 */
 
 
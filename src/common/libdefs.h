@@ -44,9 +44,14 @@
 
 
 
-/* Defines for magic and version */
+/* Defines for magic and version. Starting with version 0x000E, the index
+** is followed by the number of bytes in the file that are no longer used,
+** because libraries are updated in place by appending to them.
+*/
 #define LIB_MAGIC       0x7A55616E
-#define LIB_VERSION     0x000D
+#define LIB_VERSION     0x000E
+#define LIB_VERSION_MIN 0x000D          /* Oldest version still supported */
+#define LIB_VERSION_FREEBYTES 0x000E    /* First version with unused bytes */
 
 /* Size of an library file header */
 #define LIB_HDR_SIZE    12
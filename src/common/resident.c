@@ -0,0 +1,879 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 resident.c                                */
+/*                                                                           */
+/*                          Resident tool processes                          */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#if defined(__linux__)
+/* Needed for struct ucred */
+#  define _GNU_SOURCE
+#endif
+
+#include "resident.h"
+
+#if defined(HAVE_RESIDENT)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+/* common */
+#include "abend.h"
+#include "attrib.h"
+#include "strbuf.h"
+#include "xmalloc.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* The environment of the process */
+extern char** environ;
+
+/* A job for a resident process: A command line together with the working
+** directory, environment, file creation mask, stdin, stdout and stderr it
+** runs with.
+*/
+typedef struct Job Job;
+struct Job {
+    char*       Data;           /* Buffer holding the strings */
+    const char* Dir;            /* Working directory */
+    unsigned    Mask;           /* File creation mask */
+    unsigned    ArgCount;       /* Count of arguments */
+    char**      Args;           /* The arguments, terminated by NULL */
+    char**      Env;            /* The environment, terminated by NULL */
+    int         FD[3];          /* stdin, stdout and stderr */
+};
+
+/* A job that is running in a child process */
+typedef struct RunningJob RunningJob;
+struct RunningJob {
+    int         pid;            /* The process that runs the job */
+    int         S;              /* Socket that receives the wait status */
+};
+
+/* Write end of the pipe that wakes up ServeJobs when a child terminates */
+static int ChildPipe = -1;
+
+/* Not all systems can suppress SIGPIPE for a single send. Some can do it for
+** the socket instead, see NoSigPipe.
+*/
+#if !defined(MSG_NOSIGNAL)
+#  define MSG_NOSIGNAL  0
+#endif
+
+
+
+/*****************************************************************************/
+/*                             Helper functions                              */
+/*****************************************************************************/
+
+
+
+static void NoSigPipe (int S)
+/* Don't raise SIGPIPE when sending to S after the other end is closed */
+{
+#if defined(SO_NOSIGPIPE)
+    int On = 1;
+    setsockopt (S, SOL_SOCKET, SO_NOSIGPIPE, &On, sizeof (On));
+#else
+    (void) S;
+#endif
+}
+
+
+
+static int SendAll (int S, const void* Buf, size_t Size)
+/* Send Size bytes from Buf. Return true on success. */
+{
+    const char* P = Buf;
+    while (Size > 0) {
+        ssize_t N = send (S, P, Size, MSG_NOSIGNAL);
+        if (N < 0 && errno == EINTR) {
+            continue;
+        }
+        if (N <= 0) {
+            return 0;
+        }
+        P    += N;
+        Size -= N;
+    }
+    return 1;
+}
+
+
+
+static int RecvAll (int S, void* Buf, size_t Size)
+/* Receive exactly Size bytes into Buf. Return true on success. */
+{
+    char* P = Buf;
+    while (Size > 0) {
+        ssize_t N = recv (S, P, Size, 0);
+        if (N < 0 && errno == EINTR) {
+            continue;
+        }
+        if (N <= 0) {
+            return 0;
+        }
+        P    += N;
+        Size -= N;
+    }
+    return 1;
+}
+
+
+
+static void PutSize (unsigned char* Buf, unsigned long Size)
+/* Store a 32 bit value in big endian format */
+{
+    Buf[0] = (unsigned char) (Size >> 24);
+    Buf[1] = (unsigned char) (Size >> 16);
+    Buf[2] = (unsigned char) (Size >> 8);
+    Buf[3] = (unsigned char) Size;
+}
+
+
+
+static unsigned long GetSize (const unsigned char* Buf)
+/* Read a 32 bit value in big endian format */
+{
+    return ((unsigned long) Buf[0] << 24) | ((unsigned long) Buf[1] << 16) |
+           ((unsigned long) Buf[2] << 8)  | (unsigned long) Buf[3];
+}
+
+
+
+static int SendFDs (int S, const void* Buf, size_t Size,
+                    const int* FD, unsigned Count)
+/* Send Size bytes from Buf together with Count file descriptors in one
+** message. Return true on success.
+*/
+{
+    union {
+        struct cmsghdr  Hdr;
+        char            Data[CMSG_SPACE (3 * sizeof (int))];
+    } Control;
+    struct msghdr   Msg;
+    struct iovec    IO;
+    struct cmsghdr* C;
+
+    IO.iov_base = (void*) Buf;
+    IO.iov_len  = Size;
+
+    memset (&Control, 0, sizeof (Control));
+    memset (&Msg, 0, sizeof (Msg));
+    Msg.msg_iov        = &IO;
+    Msg.msg_iovlen     = 1;
+    Msg.msg_control    = Control.Data;
+    Msg.msg_controllen = CMSG_SPACE (Count * sizeof (int));
+
+    C = CMSG_FIRSTHDR (&Msg);
+    C->cmsg_level = SOL_SOCKET;
+    C->cmsg_type  = SCM_RIGHTS;
+    C->cmsg_len   = CMSG_LEN (Count * sizeof (int));
+    memcpy (CMSG_DATA (C), FD, Count * sizeof (int));
+
+    while (sendmsg (S, &Msg, MSG_NOSIGNAL) < 0) {
+        if (errno != EINTR) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
+static ssize_t RecvFDs (int S, void* Buf, size_t Size, int* FD, unsigned Count)
+/* Receive a message with up to Size bytes into Buf, together with exactly
+** Count file descriptors. Return the number of bytes received, zero at the
+** end of the data, or -1 on errors. If the descriptors are missing, errno is
+** set to EBADMSG.
+*/
+{
+    union {
+        struct cmsghdr  Hdr;
+        char            Data[CMSG_SPACE (3 * sizeof (int))];
+    } Control;
+    struct msghdr   Msg;
+    struct iovec    IO;
+    struct cmsghdr* C;
+    ssize_t         N;
+
+    IO.iov_base = Buf;
+    IO.iov_len  = Size;
+
+    memset (&Msg, 0, sizeof (Msg));
+    Msg.msg_iov        = &IO;
+    Msg.msg_iovlen     = 1;
+    Msg.msg_control    = Control.Data;
+    Msg.msg_controllen = sizeof (Control.Data);
+
+    do {
+        N = recvmsg (S, &Msg, 0);
+    } while (N < 0 && errno == EINTR);
+    if (N <= 0) {
+        return N;
+    }
+
+    C = CMSG_FIRSTHDR (&Msg);
+    if (C == 0                                  ||
+        C->cmsg_level != SOL_SOCKET             ||
+        C->cmsg_type != SCM_RIGHTS              ||
+        C->cmsg_len != CMSG_LEN (Count * sizeof (int))) {
+        /* Don't leak descriptors that came in unexpected numbers */
+        if (C && C->cmsg_level == SOL_SOCKET && C->cmsg_type == SCM_RIGHTS) {
+            const int* P   = (const int*) CMSG_DATA (C);
+            const int* End = (const int*) ((const char*) C + C->cmsg_len);
+            while (P < End) {
+                close (*P++);
+            }
+        }
+        errno = EBADMSG;
+        return -1;
+    }
+    memcpy (FD, CMSG_DATA (C), Count * sizeof (int));
+    return N;
+}
+
+
+
+static void AppendString (StrBuf* B, const char* S)
+/* Append a string including the terminator to a job */
+{
+    SB_AppendBuf (B, S, strlen (S) + 1);
+}
+
+
+
+static void AppendCount (StrBuf* B, unsigned long Count)
+/* Append a number to a job */
+{
+    char Buf[32];
+    sprintf (Buf, "%lu", Count);
+    AppendString (B, Buf);
+}
+
+
+
+static const char* NextString (const char** Pos, const char* End)
+/* Return the next string of a job, or NULL if the job is truncated */
+{
+    const char* S = *Pos;
+    const char* Term = memchr (S, '\0', End - S);
+    if (Term == 0) {
+        return 0;
+    }
+    *Pos = Term + 1;
+    return S;
+}
+
+
+
+static int NextCount (const char** Pos, const char* End, unsigned* Count)
+/* Read a number from a job. Return true on success. */
+{
+    const char* S = NextString (Pos, End);
+    char        Check;
+
+    return S != 0 && sscanf (S, "%u%c", Count, &Check) == 1;
+}
+
+
+
+static char** NextStrings (const char** Pos, const char* End, unsigned* Count)
+/* Read a count followed by that many strings from a job, and return them in
+** a vector terminated by a NULL pointer. Returns NULL if the job is
+** malformed.
+*/
+{
+    char**      Vec;
+    unsigned    I;
+
+    if (!NextCount (Pos, End, Count) || *Count > (unsigned) (End - *Pos)) {
+        return 0;
+    }
+    Vec = xmalloc ((*Count + 1) * sizeof (char*));
+    for (I = 0; I < *Count; ++I) {
+        const char* S = NextString (Pos, End);
+        if (S == 0) {
+            xfree (Vec);
+            return 0;
+        }
+        Vec[I] = (char*) S;
+    }
+    Vec[I] = 0;
+    return Vec;
+}
+
+
+
+static char* GetWorkDir (void)
+/* Return the current working directory in an allocated buffer, or NULL if
+** it cannot be determined.
+*/
+{
+    size_t Size = 256;
+    char*  Buf  = xmalloc (Size);
+    while (getcwd (Buf, Size) == 0) {
+        if (errno != ERANGE) {
+            xfree (Buf);
+            return 0;
+        }
+        Size *= 2;
+        Buf = xrealloc (Buf, Size);
+    }
+    return Buf;
+}
+
+
+
+static void ChildHandler (int Sig attribute ((unused)))
+/* SIGCHLD handler for ServeJobs */
+{
+    int E = errno;
+    if (write (ChildPipe, "", 1) < 0) {
+        /* The pipe is full, so ServeJobs will wake up anyway */
+    }
+    errno = E;
+}
+
+
+
+static int WaitForJob (int C[2], int Control, const int Wake[2],
+                       const RunningJob* Jobs, unsigned Count)
+/* Wait in a child forked in advance by ServeJobs until it is given a job, and
+** return the socket of the job. Descriptors that belong to ServeJobs are
+** closed, and the child terminates if ServeJobs does.
+*/
+{
+    char     Buf;
+    int      S;
+    unsigned I;
+
+    signal (SIGCHLD, SIG_DFL);
+    close (C[0]);
+    close (Control);
+    close (Wake[0]);
+    close (Wake[1]);
+    for (I = 0; I < Count; ++I) {
+        close (Jobs[I].S);
+    }
+    if (RecvFDs (C[1], &Buf, sizeof (Buf), &S, 1) <= 0) {
+        exit (EXIT_SUCCESS);
+    }
+    close (C[1]);
+    return S;
+}
+
+
+
+static int SendJob (int S, char* const Args[], const int FD[3])
+/* Send a job with the given arguments over the socket S. It runs with the
+** working directory, environment and file creation mask of the caller, and
+** uses FD as stdin, stdout and stderr. Returns true on success.
+*/
+{
+    StrBuf          B = AUTO_STRBUF_INITIALIZER;
+    unsigned char   Size[4];
+    mode_t          Mask;
+    char*           Dir;
+    unsigned        I;
+    int             Ok;
+
+    /* The job contains the working directory, the file creation mask, the
+    ** arguments and the environment.
+    */
+    Dir = GetWorkDir ();
+    if (Dir == 0) {
+        return 0;
+    }
+    AppendString (&B, Dir);
+    xfree (Dir);
+    Mask = umask (0);
+    umask (Mask);
+    AppendCount (&B, (unsigned long) Mask);
+    for (I = 0; Args[I] != 0; ++I) {
+        /* Count the arguments */
+    }
+    AppendCount (&B, I);
+    for (I = 0; Args[I] != 0; ++I) {
+        AppendString (&B, Args[I]);
+    }
+    for (I = 0; environ[I] != 0; ++I) {
+        /* Count the entries */
+    }
+    AppendCount (&B, I);
+    for (I = 0; environ[I] != 0; ++I) {
+        AppendString (&B, environ[I]);
+    }
+
+    /* Send the size together with the descriptors, then the data */
+    PutSize (Size, SB_GetLen (&B));
+    Ok = SendFDs (S, Size, sizeof (Size), FD, 3) &&
+         SendAll (S, SB_GetConstBuf (&B), SB_GetLen (&B));
+    SB_Done (&B);
+    return Ok;
+}
+
+
+
+static void FreeJob (Job* J)
+/* Close the file descriptors of a job and free it */
+{
+    unsigned I;
+
+    for (I = 0; I < 3; ++I) {
+        if (J->FD[I] >= 0) {
+            close (J->FD[I]);
+        }
+    }
+    xfree (J->Env);
+    xfree (J->Args);
+    xfree (J->Data);
+    xfree (J);
+}
+
+
+
+static Job* RecvJob (int S)
+/* Receive a job sent by SendJob. Returns NULL if the job cannot be received
+** or is malformed.
+*/
+{
+    unsigned char   Size[4];
+    unsigned long   Len;
+    const char*     Pos;
+    const char*     End;
+    unsigned        EnvCount;
+    ssize_t         N;
+    Job*            J = xmalloc (sizeof (Job));
+
+    J->Data = 0;
+    J->Args = 0;
+    J->Env  = 0;
+    J->FD[0] = J->FD[1] = J->FD[2] = -1;
+
+    /* The descriptors come with the first bytes of the size */
+    N = RecvFDs (S, Size, sizeof (Size), J->FD, 3);
+    if (N <= 0 || !RecvAll (S, Size + N, sizeof (Size) - N)) {
+        FreeJob (J);
+        return 0;
+    }
+    Len = GetSize (Size);
+    J->Data = xmalloc (Len + 1);
+    if (!RecvAll (S, J->Data, Len)) {
+        FreeJob (J);
+        return 0;
+    }
+
+    Pos = J->Data;
+    End = J->Data + Len;
+    if ((J->Dir  = NextString (&Pos, End)) == 0                 ||
+        !NextCount (&Pos, End, &J->Mask)                        ||
+        (J->Args = NextStrings (&Pos, End, &J->ArgCount)) == 0  ||
+        J->ArgCount == 0                                        ||
+        (J->Env  = NextStrings (&Pos, End, &EnvCount)) == 0) {
+        FreeJob (J);
+        return 0;
+    }
+    return J;
+}
+
+
+
+static void EnterJob (Job* J)
+/* Set up the working directory, environment, file creation mask, stdin,
+** stdout and stderr of the job in the calling process. Terminates the
+** program if the working directory cannot be entered.
+*/
+{
+    unsigned I;
+
+    for (I = 0; I < 3; ++I) {
+        dup2 (J->FD[I], (int) I);
+    }
+    for (I = 0; I < 3; ++I) {
+        if (J->FD[I] > 2) {
+            close (J->FD[I]);
+        }
+        J->FD[I] = (int) I;
+    }
+    umask ((mode_t) J->Mask);
+    environ = J->Env;
+    if (chdir (J->Dir) < 0) {
+        AbEnd ("Cannot change to directory '%s': %s", J->Dir, strerror (errno));
+    }
+}
+
+
+
+static int SendStatus (int S, int Status)
+/* Send the wait status of a job, as returned by waitpid(). Returns true on
+** success.
+*/
+{
+    unsigned char Buf[4];
+
+    PutSize (Buf, (unsigned long) Status);
+    return SendAll (S, Buf, sizeof (Buf));
+}
+
+
+
+static int ServeJobs (int Control)
+/* Run the jobs that arrive on the control socket in child processes. Jobs
+** arrive as single bytes that come with the socket of the job, see StartJob.
+** The function returns only in the child processes, with the socket the job
+** can be received from. When a child terminates, its wait status is sent
+** over this socket. The children are forked in advance, so a job doesn't
+** have to wait for fork(). The program terminates when the control socket
+** is closed.
+*/
+{
+    RunningJob*     Jobs  = 0;
+    unsigned        Count = 0;
+    unsigned        Size  = 0;
+    int             Spare = -1;         /* Child waiting for a job or -1 */
+    int             Chan  = -1;         /* Channel to the spare child */
+    int             Wake[2];
+    struct pollfd   P[2];
+    ssize_t         N;
+    char            Buf;
+    int             Status;
+    int             pid;
+    int             S;
+
+    /* Terminated children wake us up through a pipe */
+    if (pipe (Wake) < 0) {
+        AbEnd ("Cannot create pipe: %s", strerror (errno));
+    }
+    fcntl (Wake[0], F_SETFL, O_NONBLOCK);
+    fcntl (Wake[1], F_SETFL, O_NONBLOCK);
+    ChildPipe = Wake[1];
+    signal (SIGCHLD, ChildHandler);
+
+    while (1) {
+
+        /* Report the status of finished jobs */
+        while ((pid = waitpid (-1, &Status, WNOHANG)) > 0) {
+            unsigned I;
+            if (pid == Spare) {
+                close (Chan);
+                Spare = -1;
+            }
+            for (I = 0; I < Count; ++I) {
+                if (Jobs[I].pid == pid) {
+                    SendStatus (Jobs[I].S, Status);
+                    close (Jobs[I].S);
+                    Jobs[I] = Jobs[--Count];
+                    break;
+                }
+            }
+        }
+
+        /* Keep a child ready for the next job. If we cannot fork now, try
+        ** again later.
+        */
+        if (Spare < 0) {
+            int C[2];
+            if (socketpair (AF_UNIX, SOCK_STREAM, 0, C) == 0) {
+                Spare = fork ();
+                if (Spare == 0) {
+                    return WaitForJob (C, Control, Wake, Jobs, Count);
+                }
+                close (C[1]);
+                if (Spare > 0) {
+                    Chan = C[0];
+                    NoSigPipe (Chan);
+                } else {
+                    close (C[0]);
+                }
+            }
+        }
+
+        /* Wait for a job or a terminated child */
+        P[0].fd      = (Spare < 0)? -1 : Control;
+        P[0].events  = POLLIN;
+        P[0].revents = 0;
+        P[1].fd      = Wake[0];
+        P[1].events  = POLLIN;
+        P[1].revents = 0;
+        if (poll (P, 2, (Spare < 0)? 1000 : -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            AbEnd ("Cannot wait for jobs: %s", strerror (errno));
+        }
+        if (P[1].revents) {
+            char Drain[64];
+            while (read (Wake[0], Drain, sizeof (Drain)) > 0) {
+                /* Just empty the pipe */
+            }
+        }
+        if (P[0].revents == 0) {
+            continue;
+        }
+
+        /* Get the job */
+        N = RecvFDs (Control, &Buf, sizeof (Buf), &S, 1);
+        if (N == 0) {
+            exit (EXIT_SUCCESS);
+        } else if (N < 0) {
+            if (errno == EBADMSG) {
+                continue;
+            }
+            AbEnd ("Cannot receive a job: %s", strerror (errno));
+        }
+        NoSigPipe (S);
+
+        /* Pass it to the spare child. If that doesn't work, the child has
+        ** died, and the job fails.
+        */
+        if (SendFDs (Chan, "", 1, &S, 1)) {
+            if (Count >= Size) {
+                Size = (Size == 0)? 8 : Size * 2;
+                Jobs = xrealloc (Jobs, Size * sizeof (Jobs[0]));
+            }
+            Jobs[Count].pid = Spare;
+            Jobs[Count].S   = S;
+            ++Count;
+        } else {
+            close (S);
+        }
+        close (Chan);
+        Spare = -1;
+    }
+}
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void ResidentMain (int* aArgCount, char*** aArgVec)
+/* If the command line is "prog --resident fd", the program becomes a resident
+** process that waits for jobs on the control socket fd, see StartJob, and
+** runs each of them in a new child process. The function returns only in
+** these children, with the arguments of the job in *aArgCount and *aArgVec
+** and the rest of the job set up. Since the children are forked from a
+** process that hasn't done anything yet, they start just like the program
+** does when it's executed. For any other command line, the function returns
+** at once.
+*/
+{
+    unsigned Control;
+    char     Check;
+    Job*     J;
+    int      S;
+
+    if (*aArgCount != 3                                     ||
+        strcmp ((*aArgVec)[1], "--resident") != 0          ||
+        sscanf ((*aArgVec)[2], "%u%c", &Control, &Check) != 1) {
+        return;
+    }
+
+    /* Tell StartResident that we're ready */
+    if (!SendAll ((int) Control, "", 1)) {
+        exit (EXIT_FAILURE);
+    }
+
+    /* This returns in the child processes that run the jobs */
+    S = ServeJobs ((int) Control);
+    J = RecvJob (S);
+    if (J == 0) {
+        exit (EXIT_FAILURE);
+    }
+    close (S);
+    EnterJob (J);
+    *aArgCount = (int) J->ArgCount;
+    *aArgVec   = J->Args;
+}
+
+
+
+int StartResident (const char* Name)
+/* Execute the given program as a resident process. Returns the control socket
+** for StartJob, or -1 if the process cannot be started.
+*/
+{
+    char    Arg[32];
+    char*   Args[4];
+    char    Ready;
+    int     S[2];
+    int     pid;
+
+    /* Each job is sent as a single byte, so jobs sent by several processes
+    ** at the same time don't mix, even on a stream socket.
+    */
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, S) < 0) {
+        return -1;
+    }
+
+    /* Keep our end out of other programs we execute */
+    fcntl (S[0], F_SETFD, FD_CLOEXEC);
+    NoSigPipe (S[0]);
+
+    pid = fork ();
+    if (pid == 0) {
+        close (S[0]);
+        sprintf (Arg, "%d", S[1]);
+        Args[0] = (char*) Name;
+        Args[1] = "--resident";
+        Args[2] = Arg;
+        Args[3] = 0;
+        execvp (Name, Args);
+        _exit (EXIT_FAILURE);
+    }
+    close (S[1]);
+
+    /* Wait until the process is ready. If the program cannot be executed, we
+    ** see the end of the data instead.
+    */
+    if (pid < 0 || !RecvAll (S[0], &Ready, 1)) {
+        close (S[0]);
+        return -1;
+    }
+    return S[0];
+}
+
+
+
+int StartJob (int Control, char* const Args[], const int FD[3])
+/* Pass a job with the given arguments to the resident process with the given
+** control socket. It runs with the working directory, environment and file
+** creation mask of the caller, and uses FD as stdin, stdout and stderr.
+** Returns a socket for WaitJob, or -1 on errors.
+*/
+{
+    int S[2];
+
+    if (socketpair (AF_UNIX, SOCK_STREAM, 0, S) < 0) {
+        return -1;
+    }
+    NoSigPipe (S[0]);
+    if (!SendFDs (Control, "", 1, &S[1], 1)) {
+        close (S[0]);
+        close (S[1]);
+        return -1;
+    }
+    close (S[1]);
+    if (!SendJob (S[0], Args, FD)) {
+        close (S[0]);
+        return -1;
+    }
+    return S[0];
+}
+
+
+
+int WaitJob (int S)
+/* Wait until the job started on socket S has terminated, close S and return
+** the wait status of the job as returned by waitpid(). Returns -1 if the job
+** failed to report one.
+*/
+{
+    unsigned char   Buf[4];
+    int             Status = -1;
+
+    if (RecvAll (S, Buf, sizeof (Buf))) {
+        Status = (int) GetSize (Buf);
+    }
+    close (S);
+    return Status;
+}
+
+
+
+int SendSockets (int S, const int* FD, unsigned Count)
+/* Send Count descriptors, at most three, over the local socket S. Returns
+** true on success.
+*/
+{
+    return SendFDs (S, "", 1, FD, Count);
+}
+
+
+
+int RecvSockets (int S, int* FD, unsigned Count)
+/* Receive exactly Count descriptors, at most three, sent by SendSockets over
+** the local socket S. Returns true on success.
+*/
+{
+    char Buf;
+    return RecvFDs (S, &Buf, sizeof (Buf), FD, Count) == 1;
+}
+
+
+
+int PeerIsUser (int S)
+/* Return true if the process on the other end of the local socket S runs as
+** the same user as the calling process.
+*/
+{
+#if defined(SO_PEERCRED)
+    struct ucred    Cred;
+    socklen_t       Len = sizeof (Cred);
+
+    return getsockopt (S, SOL_SOCKET, SO_PEERCRED, &Cred, &Len) == 0 &&
+           Len == sizeof (Cred)                                        &&
+           Cred.uid == geteuid ();
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || \
+      defined(__OpenBSD__) || defined(__DragonFly__)
+    uid_t   UID;
+    gid_t   GID;
+
+    return getpeereid (S, &UID, &GID) == 0 && UID == geteuid ();
+#else
+    /* No way to tell, so don't trust the peer */
+    (void) S;
+    return 0;
+#endif
+}
+
+
+
+#endif
@@ -0,0 +1,105 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 resident.h                                */
+/*                                                                           */
+/*                          Resident tool processes                          */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef RESIDENT_H
+#define RESIDENT_H
+
+
+
+/* Resident processes need fork() and local sockets */
+#if !defined(_WIN32) && !defined(_AMIGA)
+#  define HAVE_RESIDENT 1
+#endif
+
+
+
+#if defined(HAVE_RESIDENT)
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void ResidentMain (int* aArgCount, char*** aArgVec);
+/* If the command line is "prog --resident fd", the program becomes a resident
+** process that waits for jobs on the control socket fd, see StartJob, and
+** runs each of them in a new child process. The function returns only in
+** these children, with the arguments of the job in *aArgCount and *aArgVec
+** and the rest of the job set up. Since the children are forked from a
+** process that hasn't done anything yet, they start just like the program
+** does when it's executed. For any other command line, the function returns
+** at once.
+*/
+
+int StartResident (const char* Name);
+/* Execute the given program as a resident process. Returns the control socket
+** for StartJob, or -1 if the process cannot be started.
+*/
+
+int StartJob (int Control, char* const Args[], const int FD[3]);
+/* Pass a job with the given arguments to the resident process with the given
+** control socket. It runs with the working directory, environment and file
+** creation mask of the caller, and uses FD as stdin, stdout and stderr.
+** Returns a socket for WaitJob, or -1 on errors.
+*/
+
+int WaitJob (int S);
+/* Wait until the job started on socket S has terminated, close S and return
+** the wait status of the job as returned by waitpid(). Returns -1 if the job
+** failed to report one.
+*/
+
+int SendSockets (int S, const int* FD, unsigned Count);
+/* Send Count descriptors, at most three, over the local socket S. Returns
+** true on success.
+*/
+
+int RecvSockets (int S, int* FD, unsigned Count);
+/* Receive exactly Count descriptors, at most three, sent by SendSockets over
+** the local socket S. Returns true on success.
+*/
+
+int PeerIsUser (int S);
+/* Return true if the process on the other end of the local socket S runs as
+** the same user as the calling process.
+*/
+
+#endif
+
+
+
+/* End of resident.h */
+
+#endif
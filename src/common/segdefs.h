@@ -46,6 +46,7 @@
 
 /* Segment flags */
 #define SEG_FLAG_NONE           0x00
+#define SEG_FLAG_SUBSEC         0x01    /* Sub-section, may be removed if unused */
 
 
 
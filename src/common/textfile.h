@@ -0,0 +1,96 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 textfile.h                                */
+/*                                                                           */
+/*             Line oriented access to text files held in memory             */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef TEXTFILE_H
+#define TEXTFILE_H
+
+
+
+/* common */
+#include "filemap.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* A text file. The complete file is mapped or read into memory when it is
+** opened, and lines are returned as pointers into the file contents, so no
+** per character I/O is needed.
+*/
+typedef struct TextFile TextFile;
+struct TextFile {
+    MappedFile*         M;              /* File contents */
+    const char*         Pos;            /* Current read position */
+    const char*         End;            /* End of the file contents */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+TextFile* OpenTextFile (const char* Name);
+/* Open a text file for reading. Returns NULL if the file cannot be opened or
+** read, in which case errno describes the problem.
+*/
+
+TextFile* OpenTextStream (FILE* F);
+/* Read the remaining contents of an open stream, for example stdin, as a
+** text file. The stream isn't closed. Returns NULL if the stream cannot be
+** read, in which case errno describes the problem.
+*/
+
+void CloseTextFile (TextFile* T);
+/* Close a text file and release all memory */
+
+const char* TF_NextLine (TextFile* T, unsigned* Len);
+/* Return a pointer to the next line of the file and its length in Len. The
+** line includes the terminating newline if there is one (the last line of a
+** file may not have one). Line terminators other than '\n' are not handled
+** specially. The returned data is not NUL terminated and stays valid until
+** the file is closed. At the end of the file, NULL is returned.
+*/
+
+
+
+/* End of textfile.h */
+
+#endif
@@ -0,0 +1,209 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  thread.c                                 */
+/*                                                                           */
+/*                               Thread support                              */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+/* common */
+#include "abend.h"
+#include "thread.h"
+#include "xmalloc.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+struct Thread {
+#if defined(_WIN32)
+    HANDLE              Handle;         /* Thread handle */
+#else
+    pthread_t           Handle;         /* Thread handle */
+#endif
+    void                (*Func) (void*);/* Thread function */
+    void*               Data;           /* Argument for Func */
+};
+
+struct Mutex {
+#if defined(_WIN32)
+    CRITICAL_SECTION    Lock;
+#else
+    pthread_mutex_t     Lock;
+#endif
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+#if defined(_WIN32)
+static DWORD WINAPI ThreadStart (LPVOID Arg)
+#else
+static void* ThreadStart (void* Arg)
+#endif
+/* Start routine for all threads */
+{
+    Thread* T = Arg;
+    T->Func (T->Data);
+    return 0;
+}
+
+
+
+Thread* NewThread (void (*Func) (void*), void* Data)
+/* Create a new thread that executes Func (Data). Will call AbEnd if the
+** thread cannot be created.
+*/
+{
+    /* Allocate memory */
+    Thread* T = xmalloc (sizeof (Thread));
+
+    /* Initialize the fields */
+    T->Func = Func;
+    T->Data = Data;
+
+    /* Start the thread */
+#if defined(_WIN32)
+    T->Handle = CreateThread (0, 0, ThreadStart, T, 0, 0);
+    if (T->Handle == 0) {
+        AbEnd ("Cannot create thread");
+    }
+#else
+    if (pthread_create (&T->Handle, 0, ThreadStart, T) != 0) {
+        AbEnd ("Cannot create thread");
+    }
+#endif
+
+    /* Return the new thread */
+    return T;
+}
+
+
+
+void JoinThread (Thread* T)
+/* Wait until the given thread terminates, then free the thread object */
+{
+#if defined(_WIN32)
+    WaitForSingleObject (T->Handle, INFINITE);
+    CloseHandle (T->Handle);
+#else
+    pthread_join (T->Handle, 0);
+#endif
+    xfree (T);
+}
+
+
+
+Mutex* NewMutex (void)
+/* Create and return a new mutex */
+{
+    Mutex* M = xmalloc (sizeof (Mutex));
+#if defined(_WIN32)
+    InitializeCriticalSection (&M->Lock);
+#else
+    pthread_mutex_init (&M->Lock, 0);
+#endif
+    return M;
+}
+
+
+
+void FreeMutex (Mutex* M)
+/* Free a mutex */
+{
+#if defined(_WIN32)
+    DeleteCriticalSection (&M->Lock);
+#else
+    pthread_mutex_destroy (&M->Lock);
+#endif
+    xfree (M);
+}
+
+
+
+void LockMutex (Mutex* M)
+/* Lock the given mutex. Blocks until the mutex is available. */
+{
+#if defined(_WIN32)
+    EnterCriticalSection (&M->Lock);
+#else
+    pthread_mutex_lock (&M->Lock);
+#endif
+}
+
+
+
+void UnlockMutex (Mutex* M)
+/* Unlock the given mutex */
+{
+#if defined(_WIN32)
+    LeaveCriticalSection (&M->Lock);
+#else
+    pthread_mutex_unlock (&M->Lock);
+#endif
+}
+
+
+
+unsigned AtomicInc (volatile unsigned* Val)
+/* Atomically increment Val and return the new value */
+{
+#if defined(_WIN32)
+    return (unsigned) InterlockedIncrement ((volatile LONG*) Val);
+#else
+    return __sync_add_and_fetch (Val, 1);
+#endif
+}
+
+
+
+unsigned AtomicDec (volatile unsigned* Val)
+/* Atomically decrement Val and return the new value */
+{
+#if defined(_WIN32)
+    return (unsigned) InterlockedDecrement ((volatile LONG*) Val);
+#else
+    return __sync_sub_and_fetch (Val, 1);
+#endif
+}
@@ -0,0 +1,95 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  thread.h                                 */
+/*                                                                           */
+/*                               Thread support                              */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef THREAD_H
+#define THREAD_H
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Storage class for variables that have a separate instance per thread */
+#if defined(_MSC_VER)
+#  define THREAD_LOCAL  __declspec(thread)
+#else
+#  define THREAD_LOCAL  __thread
+#endif
+
+/* Opaque thread and mutex types */
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+Thread* NewThread (void (*Func) (void*), void* Data);
+/* Create a new thread that executes Func (Data). Will call AbEnd if the
+** thread cannot be created.
+*/
+
+void JoinThread (Thread* T);
+/* Wait until the given thread terminates, then free the thread object */
+
+Mutex* NewMutex (void);
+/* Create and return a new mutex */
+
+void FreeMutex (Mutex* M);
+/* Free a mutex */
+
+void LockMutex (Mutex* M);
+/* Lock the given mutex. Blocks until the mutex is available. */
+
+void UnlockMutex (Mutex* M);
+/* Unlock the given mutex */
+
+unsigned AtomicInc (volatile unsigned* Val);
+/* Atomically increment Val and return the new value */
+
+unsigned AtomicDec (volatile unsigned* Val);
+/* Atomically decrement Val and return the new value */
+
+
+
+/* End of thread.h */
+
+#endif
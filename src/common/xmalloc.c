@@ -35,14 +35,50 @@
 
 #include <stdlib.h>
 #include <string.h>
+#if !defined(_WIN32)
+#  include <sys/resource.h>
+#endif
 
 /* common */
 #include "abend.h"
+#include "check.h"
 #include "debugflag.h"
+#include "thread.h"
 #include "xmalloc.h"
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Set to true to count calls to xmalloc */
+unsigned char MemStats = 0;
+
+/* Number of calls to xmalloc while MemStats is set */
+static volatile unsigned MallocCount = 0;
+
+/* Size of the blocks allocated by a pool */
+#define POOL_BLOCK_SIZE 16384
+
+/* Header of a pool block. The members besides Next make sure that the
+** objects following the header are properly aligned. Object sizes are
+** rounded up to a multiple of the header size for the same reason.
+*/
+typedef union PoolBlock PoolBlock;
+union PoolBlock {
+    PoolBlock*  Next;
+    long        L;
+    double      D;
+};
+
+/* List of all pools with a name */
+static MemPool* NamedPools = 0;
+
+
+
 /*****************************************************************************/
 /*                                   code                                    */
 /*****************************************************************************/
@@ -59,6 +95,9 @@ void* xmalloc (size_t Size)
 
         /* Allocate memory */
         P = malloc (Size);
+        if (MemStats) {
+            AtomicInc (&MallocCount);
+        }
 
         /* Check for errors */
         if (P == 0) {
@@ -125,3 +164,207 @@ void* xdup (const void* Buf, size_t Size)
 {
     return memcpy (xmalloc (Size), Buf, Size);
 }
+
+
+
+static size_t PoolObjSize (size_t Size)
+/* Return the size of an object in a pool, rounded up for alignment */
+{
+    if (Size == 0) {
+        Size = 1;
+    }
+    return (Size + sizeof (PoolBlock) - 1) / sizeof (PoolBlock) * sizeof (PoolBlock);
+}
+
+
+
+static void StartPool (MemPool* P)
+/* Prepare a pool for its first block */
+{
+    P->Size = PoolObjSize (P->Size);
+
+    /* Add the pool to the list for the statistics if it has a name */
+    if (P->Name) {
+        const MemPool* Q = NamedPools;
+        while (Q && Q != P) {
+            Q = Q->Next;
+        }
+        if (Q == 0) {
+            P->Next = NamedPools;
+            NamedPools = P;
+        }
+    }
+}
+
+
+
+static void NewPoolBlock (MemPool* P)
+/* Allocate a new block for the pool and make it the current one */
+{
+    PoolBlock* B;
+    size_t     Count;
+
+    if (P->BlockCount == 0) {
+        StartPool (P);
+    }
+
+    /* Determine the number of objects in the block */
+    Count = (POOL_BLOCK_SIZE - sizeof (PoolBlock)) / P->Size;
+    if (Count == 0) {
+        Count = 1;
+    }
+
+    /* Allocate the block and add it to the list */
+    B = xmalloc (sizeof (PoolBlock) + Count * P->Size);
+    B->Next = P->Blocks;
+    P->Blocks = B;
+    ++P->BlockCount;
+
+    /* Objects are allocated from the space behind the header */
+    P->Pos = (char*) (B + 1);
+    P->End = P->Pos + Count * P->Size;
+}
+
+
+
+void InitMemPool (MemPool* P, const char* Name, size_t Size)
+/* Initialize a pool for objects with the given size */
+{
+    P->Next       = 0;
+    P->Name       = Name;
+    P->Size       = Size;
+    P->FreeList   = 0;
+    P->Pos        = 0;
+    P->End        = 0;
+    P->Blocks     = 0;
+    P->BlockCount = 0;
+    P->Allocs     = 0;
+    P->Frees      = 0;
+}
+
+
+
+void* PoolAlloc (MemPool* P)
+/* Allocate an object from the pool. The memory is not initialized. */
+{
+    void* Obj;
+
+    if (P->FreeList) {
+        /* Reuse a freed object */
+        Obj = P->FreeList;
+        P->FreeList = *(void**) Obj;
+    } else {
+        /* Take the object from the current block */
+        if (P->Pos == P->End) {
+            NewPoolBlock (P);
+        }
+        Obj = P->Pos;
+        P->Pos += P->Size;
+    }
+    ++P->Allocs;
+
+    return Obj;
+}
+
+
+
+void PoolFree (MemPool* P, void* Obj)
+/* Return an object to the pool. Obj may come from another pool with the same
+** object size, if that pool is merged into P later or not used any longer.
+*/
+{
+    *(void**) Obj = P->FreeList;
+    P->FreeList = Obj;
+    ++P->Frees;
+}
+
+
+
+void PoolMerge (MemPool* Dest, MemPool* Src)
+/* Move all memory from Src into Dest, which must have the same object size.
+** Src is empty afterwards and may be used again.
+*/
+{
+    PRECONDITION (PoolObjSize (Dest->Size) == PoolObjSize (Src->Size));
+
+    if (Dest->BlockCount == 0) {
+        StartPool (Dest);
+    }
+
+    /* The unused rest of the current block of Src goes into the free list */
+    while (Src->Pos != Src->End) {
+        void* Obj = Src->Pos;
+        Src->Pos += Src->Size;
+        *(void**) Obj = Src->FreeList;
+        Src->FreeList = Obj;
+    }
+
+    /* Prepend the free list of Src to the one of Dest */
+    if (Src->FreeList) {
+        void** Last = Src->FreeList;
+        while (*Last) {
+            Last = *Last;
+        }
+        *Last = Dest->FreeList;
+        Dest->FreeList = Src->FreeList;
+    }
+
+    /* Dest owns the blocks of Src from now on */
+    if (Src->Blocks) {
+        PoolBlock* Last = Src->Blocks;
+        while (Last->Next) {
+            Last = Last->Next;
+        }
+        Last->Next = Dest->Blocks;
+        Dest->Blocks = Src->Blocks;
+    }
+
+    /* Add up the statistics */
+    Dest->BlockCount += Src->BlockCount;
+    Dest->Allocs     += Src->Allocs;
+    Dest->Frees      += Src->Frees;
+
+    /* Src is empty now */
+    Src->FreeList   = 0;
+    Src->Pos        = 0;
+    Src->End        = 0;
+    Src->Blocks     = 0;
+    Src->BlockCount = 0;
+    Src->Allocs     = 0;
+    Src->Frees      = 0;
+}
+
+
+
+void PrintMemStats (FILE* F)
+/* Print the number of xmalloc calls, statistics for all pools with a name,
+** and the peak memory usage of the process if it is available.
+*/
+{
+    const MemPool* P;
+
+    fprintf (F, "xmalloc calls:      %10u\n", MallocCount);
+    for (P = NamedPools; P; P = P->Next) {
+        fprintf (F,
+                 "%-18s  %10lu allocs, %10lu frees, %6u blocks, %10lu bytes\n",
+                 P->Name,
+                 P->Allocs,
+                 P->Frees,
+                 P->BlockCount,
+                 (unsigned long) P->BlockCount * POOL_BLOCK_SIZE);
+    }
+
+#if !defined(_WIN32)
+    {
+        struct rusage Usage;
+        if (getrusage (RUSAGE_SELF, &Usage) == 0) {
+            long MaxRSS = Usage.ru_maxrss;
+#if defined(__APPLE__)
+            /* macOS reports bytes instead of kilobytes */
+            MaxRSS /= 1024;
+#endif
+            fprintf (F, "Peak memory usage:  %10ld KB\n", MaxRSS);
+        }
+    }
+#endif
+}
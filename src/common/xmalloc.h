@@ -39,6 +39,43 @@
 
 
 #include <stddef.h>
+#include <stdio.h>
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Set to true to count calls to xmalloc for PrintMemStats */
+extern unsigned char MemStats;
+
+/* A pool of objects with the same size. Objects are carved from large blocks
+** and freed objects are kept in a free list, so allocating and freeing them
+** is a lot cheaper than malloc/free. The memory of a pool is never returned
+** to the system. A pool must not be used by more than one thread at a time.
+*/
+typedef struct MemPool MemPool;
+struct MemPool {
+    MemPool*            Next;           /* Next pool with a name */
+    const char*         Name;           /* Name for the statistics or NULL */
+    size_t              Size;           /* Size of one object */
+    void*               FreeList;       /* Objects freed */
+    char*               Pos;            /* Free space in the current block */
+    char*               End;            /* End of the current block */
+    void*               Blocks;         /* List of blocks */
+    unsigned            BlockCount;     /* Number of blocks */
+    unsigned long       Allocs;         /* Number of allocations */
+    unsigned long       Frees;          /* Number of objects freed */
+};
+
+/* Initializer for a pool of objects with the given size. Pools with a name
+** are listed by PrintMemStats.
+*/
+#define STATIC_MEMPOOL_INITIALIZER(Name, Size)  \
+    { 0, Name, Size, 0, 0, 0, 0, 0, 0, 0 }
 
 
 
@@ -63,6 +100,27 @@ char* xstrdup (const char* S);
 void* xdup (const void* Buf, size_t Size);
 /* Create a copy of Buf on the heap and return a pointer to it. */
 
+void InitMemPool (MemPool* P, const char* Name, size_t Size);
+/* Initialize a pool for objects with the given size */
+
+void* PoolAlloc (MemPool* P);
+/* Allocate an object from the pool. The memory is not initialized. */
+
+void PoolFree (MemPool* P, void* Obj);
+/* Return an object to the pool. Obj may come from another pool with the same
+** object size, if that pool is merged into P later or not used any longer.
+*/
+
+void PoolMerge (MemPool* Dest, MemPool* Src);
+/* Move all memory from Src into Dest, which must have the same object size.
+** Src is empty afterwards and may be used again.
+*/
+
+void PrintMemStats (FILE* F);
+/* Print the number of xmalloc calls, statistics for all pools with a name,
+** and the peak memory usage of the process if it is available.
+*/
+
 
 
 /* End of xmalloc.h */
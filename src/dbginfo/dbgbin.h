@@ -0,0 +1,215 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  dbgbin.h                                 */
+/*                                                                           */
+/*                       Binary debug info file format                       */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef DBGBIN_H
+#define DBGBIN_H
+
+
+
+/* Binary debug info files contain the same information as the text files
+** written by the linker, but in a form that can be used without parsing.
+** All numbers are 32 bit little endian words. The file starts with a header:
+**
+**      magic           DBGBIN_MAGIC
+**      version         (DBGBIN_VER_MAJOR << 16) | DBGBIN_VER_MINOR
+**      sections        DBGBIN_SECTION_COUNT pairs of offset and count
+**
+** Offsets are file offsets in bytes. The count is the size in bytes for the
+** string pool, the size in words for the id list pool, the number of records
+** for the item sections, and the number of ids for the index sections.
+**
+** Items are stored as arrays of fixed size records, the id of an item is the
+** index of its record. The index sections contain item ids in the sort order
+** used by the debug info library, so it doesn't have to sort them on load.
+**
+** Strings are stored as offsets into the string pool, which contains zero
+** terminated strings and starts with an empty string. Lists of ids are stored
+** as word offsets into the id list pool, where a count is followed by that
+** many ids. The pool starts with an empty list.
+**
+** Storage classes, scope and symbol types use the values of the enums from
+** dbginfo.h. Missing ids are CC65_INV_ID.
+*/
+
+
+
+#include "dbginfo.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Magic and version */
+#define DBGBIN_MAGIC            0x62643536UL    /* "65db" */
+#define DBGBIN_VER_MAJOR        1U
+#define DBGBIN_VER_MINOR        0U
+
+/* Sections */
+enum {
+    DBGBIN_STRINGS,                     /* String pool */
+    DBGBIN_IDLISTS,                     /* Id list pool */
+
+    /* Items */
+    DBGBIN_CSYM,                        /* C symbols */
+    DBGBIN_FILE,                        /* Source files */
+    DBGBIN_LIB,                         /* Libraries */
+    DBGBIN_LINE,                        /* Line infos */
+    DBGBIN_MOD,                         /* Modules */
+    DBGBIN_SCOPE,                       /* Scopes */
+    DBGBIN_SEG,                         /* Segments */
+    DBGBIN_SPAN,                        /* Spans */
+    DBGBIN_SYM,                         /* Symbols */
+    DBGBIN_TYPE,                        /* Types */
+
+    /* Indices */
+    DBGBIN_FILE_BYNAME,                 /* Files by name, mtime and size */
+    DBGBIN_LINE_BYLINE,                 /* Line infos by file and line */
+    DBGBIN_MOD_BYNAME,                  /* Modules by name */
+    DBGBIN_SCOPE_BYNAME,                /* Scopes by name and id */
+    DBGBIN_SEG_BYNAME,                  /* Segments by name */
+    DBGBIN_SPAN_BYADDR,                 /* Spans by start and end address */
+    DBGBIN_SYM_BYNAME,                  /* Symbols by name */
+    DBGBIN_SYM_BYVAL,                   /* Symbols by value and name */
+
+    DBGBIN_SECTION_COUNT
+};
+
+/* Size of the header in bytes */
+#define DBGBIN_HEADER_SIZE      ((2 + 2 * DBGBIN_SECTION_COUNT) * 4)
+
+/* C symbol records */
+enum {
+    DBGBIN_CSYM_NAME,                   /* Name */
+    DBGBIN_CSYM_SC,                     /* Storage class */
+    DBGBIN_CSYM_OFFS,                   /* Offset, signed */
+    DBGBIN_CSYM_SYM,                    /* Id of asm symbol */
+    DBGBIN_CSYM_TYPE,                   /* Id of type */
+    DBGBIN_CSYM_SCOPE,                  /* Id of scope */
+    DBGBIN_CSYM_WORDS
+};
+
+/* File records */
+enum {
+    DBGBIN_FILE_NAME,                   /* Name */
+    DBGBIN_FILE_SIZE,                   /* Size of file */
+    DBGBIN_FILE_MTIME,                  /* Modification time */
+    DBGBIN_FILE_MODS,                   /* List of module ids */
+    DBGBIN_FILE_WORDS
+};
+
+/* Library records */
+enum {
+    DBGBIN_LIB_NAME,                    /* Name */
+    DBGBIN_LIB_WORDS
+};
+
+/* Line info records */
+enum {
+    DBGBIN_LINE_FILE,                   /* Id of file */
+    DBGBIN_LINE_LINE,                   /* Line number */
+    DBGBIN_LINE_TYPE,                   /* Type of line */
+    DBGBIN_LINE_COUNT,                  /* Nesting counter for macros */
+    DBGBIN_LINE_SPANS,                  /* List of span ids */
+    DBGBIN_LINE_WORDS
+};
+
+/* Module records */
+enum {
+    DBGBIN_MOD_NAME,                    /* Name */
+    DBGBIN_MOD_FILE,                    /* Id of main file */
+    DBGBIN_MOD_LIB,                     /* Id of library */
+    DBGBIN_MOD_WORDS
+};
+
+/* Scope records */
+enum {
+    DBGBIN_SCOPE_NAME,                  /* Name */
+    DBGBIN_SCOPE_TYPE,                  /* Type of scope */
+    DBGBIN_SCOPE_SIZE,                  /* Size of scope */
+    DBGBIN_SCOPE_MOD,                   /* Id of module */
+    DBGBIN_SCOPE_PARENT,                /* Id of parent scope */
+    DBGBIN_SCOPE_SYM,                   /* Id of label symbol */
+    DBGBIN_SCOPE_SPANS,                 /* List of span ids */
+    DBGBIN_SCOPE_WORDS
+};
+
+/* Segment records */
+enum {
+    DBGBIN_SEG_NAME,                    /* Name */
+    DBGBIN_SEG_START,                   /* Start address */
+    DBGBIN_SEG_SIZE,                    /* Size of segment */
+    DBGBIN_SEG_ONAME,                   /* Output file name, empty if none */
+    DBGBIN_SEG_OOFFS,                   /* Offset in output file */
+    DBGBIN_SEG_WORDS
+};
+
+/* Span records */
+enum {
+    DBGBIN_SPAN_SEG,                    /* Id of segment */
+    DBGBIN_SPAN_START,                  /* Start, relative to segment */
+    DBGBIN_SPAN_SIZE,                   /* Size of span */
+    DBGBIN_SPAN_TYPE,                   /* Id of type */
+    DBGBIN_SPAN_WORDS
+};
+
+/* Symbol records */
+enum {
+    DBGBIN_SYM_NAME,                    /* Name */
+    DBGBIN_SYM_TYPE,                    /* Type of symbol */
+    DBGBIN_SYM_VAL,                     /* Value, signed */
+    DBGBIN_SYM_SIZE,                    /* Size of symbol */
+    DBGBIN_SYM_EXP,                     /* Id of export for imports */
+    DBGBIN_SYM_SEG,                     /* Id of segment */
+    DBGBIN_SYM_SCOPE,                   /* Id of scope */
+    DBGBIN_SYM_PARENT,                  /* Id of parent for cheap locals */
+    DBGBIN_SYM_DEF,                     /* List of definition line ids */
+    DBGBIN_SYM_REF,                     /* List of reference line ids */
+    DBGBIN_SYM_WORDS
+};
+
+/* Type records */
+enum {
+    DBGBIN_TYPE_VAL,                    /* Type string as in text files */
+    DBGBIN_TYPE_WORDS
+};
+
+
+
+/* End of dbgbin.h */
+
+#endif
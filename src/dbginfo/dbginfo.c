@@ -41,8 +41,14 @@
 #include <limits.h>
 #include <assert.h>
 #include <errno.h>
+#if !defined(_WIN32)
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
 
 #include "dbginfo.h"
+#include "dbgbin.h"
 
 
 
@@ -92,20 +98,25 @@ struct Collection {
 /* Initializer for static collections */
 #define COLLECTION_INITIALIZER  { 0, 0, 0 }
 
-/* Span info management. The following table has as many entries as there
-** are addresses active in spans. Each entry lists the spans for this address.
+/* Span info management. The address space covered by spans is split into
+** disjoint ranges, so that all addresses within one range are covered by the
+** same set of spans. The ranges are sorted by address, so the spans for an
+** address are found by a binary search even if spans overlap, and a sorted
+** list of addresses can be resolved in one merge pass.
 */
 typedef struct SpanInfoListEntry SpanInfoListEntry;
 struct SpanInfoListEntry {
-    cc65_addr           Addr;           /* Unique address */
-    unsigned            Count;          /* Number of SpanInfos for this address */
-    void*               Data;           /* Either SpanInfo* or SpanInfo** */
+    cc65_addr           Start;          /* First address of the range */
+    cc65_addr           End;            /* Last address of the range */
+    unsigned            Count;          /* Number of SpanInfos for this range */
+    unsigned            Index;          /* Index of the first one in Spans */
 };
 
 typedef struct SpanInfoList SpanInfoList;
 struct SpanInfoList {
     unsigned            Count;          /* Number of entries */
     SpanInfoListEntry*  List;           /* Dynamic array with entries */
+    struct SpanInfo**   Spans;          /* Spans for all entries */
 };
 
 /* Input tokens */
@@ -233,6 +244,18 @@ struct InputData {
     StrBuf              SVal;           /* String constant */
     cc65_errorfunc      Error;          /* Function called in case of errors */
     DbgInfo*            Info;           /* Pointer to debug info */
+    Collection          LineInfoByLine; /* Line infos, sorted by file and line later */
+    Collection          SpanInfoByAddr; /* Span infos, sorted by address later */
+};
+
+/* Data used when reading a binary debug info file */
+typedef struct BinInput BinInput;
+struct BinInput {
+    const unsigned char*    Data;       /* Contents of the file */
+    unsigned long           Size;       /* Size of the file */
+    int                     Mapped;     /* True if the file is memory mapped */
+    unsigned long           Offs[DBGBIN_SECTION_COUNT];     /* Section offsets */
+    unsigned long           Count[DBGBIN_SECTION_COUNT];    /* Section sizes */
 };
 
 /* Typedefs for the item structures. Do also serve as forwards */
@@ -923,8 +946,19 @@ static void CollQuickSort (Collection* C, int Lo, int Hi,
     while (Hi > Lo) {
         int I = Lo + 1;
         int J = Hi;
+
+        /* Use the middle element as pivot. The input is often almost sorted,
+        ** which is the worst case when using the first one.
+        */
+        CollEntry Pivot = Items[(Lo + Hi) / 2];
+        Items[(Lo + Hi) / 2] = Items[Lo];
+        Items[Lo] = Pivot;
+
+        /* Both scans stop at items equal to the pivot, so many equal keys
+        ** are split evenly instead of degrading to quadratic run time.
+        */
         while (I <= J) {
-            while (I <= J && Compare (Items[Lo].Ptr, Items[I].Ptr) >= 0) {
+            while (I <= J && Compare (Items[Lo].Ptr, Items[I].Ptr) > 0) {
                 ++I;
             }
             while (I <= J && Compare (Items[Lo].Ptr, Items[J].Ptr) < 0) {
@@ -957,10 +991,28 @@ static void CollQuickSort (Collection* C, int Lo, int Hi,
 
 
 
+static int CollIsSorted (const Collection* C,
+                         int (*Compare) (const void*, const void*))
+/* Return true if the collection is sorted according to the compare function */
+{
+    unsigned I;
+    for (I = 1; I < C->Count; ++I) {
+        if (Compare (C->Items[I-1].Ptr, C->Items[I].Ptr) > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+
 static void CollSort (Collection* C, int (*Compare) (const void*, const void*))
 /* Sort the collection using the given compare function. */
 {
-    if (C->Count > 1) {
+    /* Collections from binary files are usually sorted already. Checking
+    ** this first is cheap and avoids the worst case of the quicksort.
+    */
+    if (C->Count > 1 && !CollIsSorted (C, Compare)) {
         CollQuickSort (C, 0, C->Count-1, Compare);
     }
 }
@@ -1029,13 +1081,11 @@ static void DumpSpanInfo (SpanInfoList* L)
     /* Line info */
     for (I = 0; I < L->Count; ++I) {
         const SpanInfoListEntry* E = &L->List[I];
-        printf ("Addr:   %lu\n", (unsigned long) E->Addr);
-        if (E->Count == 1) {
-            DumpOneLineInfo (0, E->Data);
-        } else {
-            for (J = 0; J < E->Count; ++J) {
-                DumpOneLineInfo (J, ((LineInfo**) E->Data)[J]);
-            }
+        printf ("Range:  0x%06lX-0x%06lX\n",
+                (unsigned long) E->Start,
+                (unsigned long) E->End);
+        for (J = 0; J < E->Count; ++J) {
+            printf ("  Span: %u\n", L->Spans[E->Index + J]->Id);
         }
     }
 }
@@ -2187,6 +2237,7 @@ static void InitSpanInfoList (SpanInfoList* L)
 {
     L->Count = 0;
     L->List  = 0;
+    L->Spans = 0;
 }
 
 
@@ -2196,149 +2247,111 @@ static void CreateSpanInfoList (SpanInfoList* L, Collection* SpanInfos)
 ** must be sorted by ascending start addresses.
 */
 {
-    unsigned I, J;
-    SpanInfo* S;
-    SpanInfoListEntry* List;
-    unsigned StartIndex;
-    cc65_addr Start;
-    cc65_addr Addr;
-    cc65_addr End;
+    unsigned    I;
+    unsigned    J;
+    unsigned    K;
+    unsigned    ListSize;
+    unsigned    SpanCount;
+    unsigned    SpanSize;
+    cc65_addr   Addr;
+    cc65_addr   End;
+    Collection  Active = COLLECTION_INITIALIZER;
 
     /* Initialize and check if there's something to do */
-    L->Count = 0;
-    L->List  = 0;
+    InitSpanInfoList (L);
     if (CollCount (SpanInfos) == 0) {
         /* No entries */
         return;
     }
 
-    /* Step 1: Determine the number of unique address entries needed */
-    S = CollAt (SpanInfos, 0);
-    L->Count += (S->End - S->Start) + 1;
-    End = S->End;
-    for (I = 1; I < CollCount (SpanInfos); ++I) {
-
-        /* Get next entry */
-        S = CollAt (SpanInfos, I);
-
-        /* Check for additional unique addresses in this span info */
-        if (S->Start > End) {
-            L->Count += (S->End - S->Start) + 1;
-            End = S->End;
-        } else if (S->End > End) {
-            L->Count += (S->End - End);
-            End = S->End;
+    /* Sweep over the address space. Active contains the spans covering the
+    ** current address in the order of the sorted input, which means that
+    ** spans starting at the same address have the smaller ones first. Each
+    ** time a span starts or ends, a new range begins.
+    */
+    ListSize  = 0;
+    SpanCount = 0;
+    SpanSize  = 0;
+    Addr      = 0;
+    I         = 0;
+    while (I < CollCount (SpanInfos) || CollCount (&Active) > 0) {
+
+        SpanInfoListEntry* E;
+
+        /* If nothing is active, skip the gap to the next span */
+        if (CollCount (&Active) == 0) {
+            Addr = ((const SpanInfo*) CollAt (SpanInfos, I))->Start;
         }
 
-    }
-
-    /* Step 2: Allocate memory and initialize it */
-    L->List = List = xmalloc (L->Count * sizeof (*List));
-    for (I = 0; I < L->Count; ++I) {
-        List[I].Count = 0;
-        List[I].Data  = 0;
-    }
-
-    /* Step 3: Determine the number of entries per unique address */
-    List = L->List;
-    S = CollAt (SpanInfos, 0);
-    StartIndex = 0;
-    Start = S->Start;
-    End = S->End;
-    for (J = StartIndex, Addr = S->Start; Addr <= S->End; ++J, ++Addr) {
-        List[J].Addr = Addr;
-        ++List[J].Count;
-    }
-    for (I = 1; I < CollCount (SpanInfos); ++I) {
-
-        /* Get next entry */
-        S = CollAt (SpanInfos, I);
+        /* Add all spans starting at the current address. Empty spans don't
+        ** cover any address and are ignored.
+        */
+        while (I < CollCount (SpanInfos)) {
+            SpanInfo* S = CollAt (SpanInfos, I);
+            if (S->Start > Addr) {
+                break;
+            }
+            if (S->End >= S->Start) {
+                CollAppend (&Active, S);
+            }
+            ++I;
+        }
+        if (CollCount (&Active) == 0) {
+            continue;
+        }
 
-        /* Determine the start index of the next range. Line infos are sorted
-        ** by ascending start address, so the start address of the next entry
-        ** is always larger than the previous one - we don't need to check
-        ** that.
+        /* The range ends before the next span starts or with the first of
+        ** the active spans that ends.
         */
-        if (S->Start <= End) {
-            /* Range starts within out already known linear range */
-            StartIndex += (unsigned) (S->Start - Start);
-            Start = S->Start;
-            if (S->End > End) {
+        End = ((const SpanInfo*) CollAt (&Active, 0))->End;
+        for (J = 1; J < CollCount (&Active); ++J) {
+            const SpanInfo* S = CollAt (&Active, J);
+            if (S->End < End) {
                 End = S->End;
             }
-        } else {
-            /* Range starts after the already known */
-            StartIndex += (unsigned) (End - Start) + 1;
-            Start = S->Start;
-            End = S->End;
         }
-        for (J = StartIndex, Addr = S->Start; Addr <= S->End; ++J, ++Addr) {
-            List[J].Addr = Addr;
-            ++List[J].Count;
+        if (I < CollCount (SpanInfos)) {
+            const SpanInfo* S = CollAt (SpanInfos, I);
+            if (S->Start <= End) {
+                End = S->Start - 1;
+            }
         }
-    }
-
-    /* Step 4: Allocate memory for the indirect tables */
-    for (I = 0, List = L->List; I < L->Count; ++I, ++List) {
 
-        /* For a count of 1, we store the pointer to the lineinfo for this
-        ** address in the Data pointer directly. For counts > 1, we allocate
-        ** an array of pointers and reset the counter, so we can use it as
-        ** an index later. This is dangerous programming since it disables
-        ** all possible checks!
-        */
-        if (List->Count > 1) {
-            List->Data = xmalloc (List->Count * sizeof (SpanInfo*));
-            List->Count = 0;
-        }
-    }
-
-    /* Step 5: Enter the data into the table */
-    List = L->List;
-    S = CollAt (SpanInfos, 0);
-    StartIndex = 0;
-    Start = S->Start;
-    End = S->End;
-    for (J = StartIndex, Addr = S->Start; Addr <= S->End; ++J, ++Addr) {
-        assert (List[J].Addr == Addr);
-        if (List[J].Count == 1 && List[J].Data == 0) {
-            List[J].Data = S;
-        } else {
-            ((SpanInfo**) List[J].Data)[List[J].Count++] = S;
+        /* Make room for the new entry and its spans */
+        if (L->Count == ListSize) {
+            ListSize = (ListSize == 0)? 64 : ListSize * 2;
+            L->List = xrealloc (L->List, ListSize * sizeof (L->List[0]));
+        }
+        while (SpanCount + CollCount (&Active) > SpanSize) {
+            SpanSize = (SpanSize == 0)? 256 : SpanSize * 2;
+            L->Spans = xrealloc (L->Spans, SpanSize * sizeof (L->Spans[0]));
         }
-    }
-    for (I = 1; I < CollCount (SpanInfos); ++I) {
 
-        /* Get next entry */
-        S = CollAt (SpanInfos, I);
+        /* Enter the range */
+        E = &L->List[L->Count++];
+        E->Start = Addr;
+        E->End   = End;
+        E->Count = CollCount (&Active);
+        E->Index = SpanCount;
+        for (J = 0; J < CollCount (&Active); ++J) {
+            L->Spans[SpanCount++] = CollAt (&Active, J);
+        }
 
-        /* Determine the start index of the next range. Line infos are sorted
-        ** by ascending start address, so the start address of the next entry
-        ** is always larger than the previous one - we don't need to check
-        ** that.
-        */
-        if (S->Start <= End) {
-            /* Range starts within out already known linear range */
-            StartIndex += (unsigned) (S->Start - Start);
-            Start = S->Start;
-            if (S->End > End) {
-                End = S->End;
-            }
-        } else {
-            /* Range starts after the already known */
-            StartIndex += (unsigned) (End - Start) + 1;
-            Start = S->Start;
-            End = S->End;
-        }
-        for (J = StartIndex, Addr = S->Start; Addr <= S->End; ++J, ++Addr) {
-            assert (List[J].Addr == Addr);
-            if (List[J].Count == 1 && List[J].Data == 0) {
-                List[J].Data = S;
-            } else {
-                ((SpanInfo**) List[J].Data)[List[J].Count++] = S;
+        /* Remove the spans that end here, keeping the order of the others */
+        for (J = 0, K = 0; J < CollCount (&Active); ++J) {
+            SpanInfo* S = CollAt (&Active, J);
+            if (S->End != End) {
+                CollReplace (&Active, S, K++);
             }
         }
+        Active.Count = K;
+
+        /* Continue after the range */
+        Addr = End + 1;
     }
+
+    /* Free the work collection */
+    CollDone (&Active);
 }
 
 
@@ -2346,23 +2359,8 @@ static void CreateSpanInfoList (SpanInfoList* L, Collection* SpanInfos)
 static void DoneSpanInfoList (SpanInfoList* L)
 /* Delete the contents of a span info list */
 {
-    unsigned I;
-
-    /* Delete the span info and the indirect data */
-    for (I = 0; I < L->Count; ++I) {
-
-        /* Get a pointer to the entry */
-        SpanInfoListEntry* E = &L->List[I];
-
-        /* Check for indirect memory */
-        if (E->Count > 1) {
-            /* SpanInfo addressed indirectly */
-            xfree (E->Data);
-        }
-    }
-
-    /* Delete the list */
     xfree (L->List);
+    xfree (L->Spans);
 }
 
 
@@ -3166,6 +3164,7 @@ static void ParseInfo (InputData* D)
 
             case TOK_LINE:
                 CollGrow (&D->Info->LineInfoById, D->IVal);
+                CollGrow (&D->LineInfoByLine, D->IVal);
                 break;
 
             case TOK_MODULE:
@@ -3185,6 +3184,7 @@ static void ParseInfo (InputData* D)
 
             case TOK_SPAN:
                 CollGrow (&D->Info->SpanInfoById,  D->IVal);
+                CollGrow (&D->SpanInfoByAddr, D->IVal);
                 break;
 
             case TOK_SYM:
@@ -3483,6 +3483,7 @@ static void ParseLine (InputData* D)
     L->Count    = Count;
     CollMove (&SpanIds, &L->SpanInfoList);
     CollReplaceExpand (&D->Info->LineInfoById, L, Id);
+    CollAppend (&D->LineInfoByLine, L);
 
 ErrorExit:
     /* Entry point in case of errors */
@@ -4138,6 +4139,7 @@ static void ParseSpan (InputData* D)
     S->Seg.Id   = SegId;
     S->Type.Id  = TypeId;
     CollReplaceExpand (&D->Info->SpanInfoById, S, Id);
+    CollAppend (&D->SpanInfoByAddr, S);
 
 ErrorExit:
     /* Entry point in case of errors */
@@ -4154,7 +4156,6 @@ static void ParseSym (InputData* D)
     */
     Collection          DefLineIds = COLLECTION_INITIALIZER;
     unsigned            ExportId = CC65_INV_ID;
-    unsigned            FileId = CC65_INV_ID;
     unsigned            Id = CC65_INV_ID;
     StrBuf              Name = STRBUF_INITIALIZER;
     unsigned            ParentId = CC65_INV_ID;
@@ -4256,7 +4257,7 @@ static void ParseSym (InputData* D)
                 if (!IntConstFollows (D)) {
                     goto ErrorExit;
                 }
-                FileId = D->IVal;
+                /* The file isn't used */
                 InfoBits |= ibFileId;
                 NextToken (D);
                 break;
@@ -4659,53 +4660,9 @@ static int FindCSymInfoByName (const Collection* CSymInfos, const char* Name,
 
 
 
-static int FindFileInfoByName (const Collection* FileInfos, const char* Name,
-                               unsigned* Index)
-/* Find the FileInfo for a given file name. The function returns true if the
-** name was found. In this case, Index contains the index of the first item
-** that matches. If the item wasn't found, the function returns false and
-** Index contains the insert position for Name.
-*/
-{
-    /* Do a binary search */
-    int Lo = 0;
-    int Hi = (int) CollCount (FileInfos) - 1;
-    int Found = 0;
-    while (Lo <= Hi) {
-
-        /* Mid of range */
-        int Cur = (Lo + Hi) / 2;
-
-        /* Get item */
-        const FileInfo* CurItem = CollAt (FileInfos, Cur);
-
-        /* Compare */
-        int Res = strcmp (CurItem->Name, Name);
-
-        /* Found? */
-        if (Res < 0) {
-            Lo = Cur + 1;
-        } else {
-            Hi = Cur - 1;
-            /* Since we may have duplicates, repeat the search until we've
-            ** the first item that has a match.
-            */
-            if (Res == 0) {
-                Found = 1;
-            }
-        }
-    }
-
-    /* Pass back the index. This is also the insert position */
-    *Index = Lo;
-    return Found;
-}
-
-
-
 static SpanInfoListEntry* FindSpanInfoByAddr (const SpanInfoList* L, cc65_addr Addr)
-/* Find the index of a SpanInfo for a given address. Returns 0 if no such
-** SpanInfo was found.
+/* Find the range that contains the given address. Returns 0 if the address
+** isn't covered by any span.
 */
 {
     /* Do a binary search */
@@ -4720,9 +4677,9 @@ static SpanInfoListEntry* FindSpanInfoByAddr (const SpanInfoList* L, cc65_addr A
         SpanInfoListEntry* CurItem = &L->List[Cur];
 
         /* Found? */
-        if (CurItem->Addr > Addr) {
+        if (CurItem->Start > Addr) {
             Hi = Cur - 1;
-        } else if (CurItem->Addr < Addr) {
+        } else if (CurItem->End < Addr) {
             Lo = Cur + 1;
         } else {
             /* Found */
@@ -5041,12 +4998,18 @@ static void ProcessCSymInfo (InputData* D)
 static void ProcessFileInfo (InputData* D)
 /* Postprocess file infos */
 {
-    /* Walk over all file infos and resolve the module ids */
     unsigned I;
-    for (I = 0; I < CollCount (&D->Info->FileInfoById); ++I) {
+
+    /* Sort the file infos by name, so we can do a binary search */
+    CollSort (&D->Info->FileInfoByName, CompareFileInfoByName);
+
+    /* Walk over all file infos and resolve the module ids. Walking in the
+    ** order of names means that the files added to the modules are sorted.
+    */
+    for (I = 0; I < CollCount (&D->Info->FileInfoByName); ++I) {
 
         /* Get this file info */
-        FileInfo* F = CollAt (&D->Info->FileInfoById, I);
+        FileInfo* F = CollAt (&D->Info->FileInfoByName, I);
 
         /* Resolve the module ids */
         unsigned J;
@@ -5088,9 +5051,6 @@ static void ProcessFileInfo (InputData* D)
         /* Sort the files by name */
         CollSort (&M->FileInfoByName, CompareFileInfoByName);
     }
-
-    /* Sort the file infos by name, so we can do a binary search */
-    CollSort (&D->Info->FileInfoByName, CompareFileInfoByName);
 }
 
 
@@ -5105,9 +5065,8 @@ static void ProcessLineInfo (InputData* D)
     Collection* FileInfos = &D->Info->FileInfoById;
 
     /* Walk over the line infos and replace the id numbers of file and segment
-    ** with pointers to the actual structs. Add the line info to each file
-    ** where it is defined. Resolve the spans and add backpointers to the
-    ** spans.
+    ** with pointers to the actual structs. Resolve the spans and add
+    ** backpointers to the spans.
     */
     for (I = 0; I < CollCount (LineInfos); ++I) {
 
@@ -5125,7 +5084,6 @@ static void ProcessLineInfo (InputData* D)
             L->File.Info = 0;
         } else {
             L->File.Info = CollAt (FileInfos, L->File.Id);
-            CollAppend (&L->File.Info->LineInfoByLine, L);
         }
 
         /* Resolve the spans ids */
@@ -5156,6 +5114,17 @@ static void ProcessLineInfo (InputData* D)
         }
     }
 
+    /* Add the line infos to the files where they are defined. Binary files
+    ** have them in the order of files and lines, so the lists for the files
+    ** don't need sorting.
+    */
+    for (I = 0; I < CollCount (&D->LineInfoByLine); ++I) {
+        LineInfo* L = CollAt (&D->LineInfoByLine, I);
+        if (L->File.Info) {
+            CollAppend (&L->File.Info->LineInfoByLine, L);
+        }
+    }
+
     /* Walk over all files and sort the line infos for each file so we can
     ** do a binary search later.
     */
@@ -5236,9 +5205,6 @@ static void ProcessScopeInfo (InputData* D)
         } else {
             S->Mod.Info = CollAt (&D->Info->ModInfoById, S->Mod.Id);
 
-            /* Add the scope to the list of scopes for this module */
-            CollAppend (&S->Mod.Info->ScopeInfoByName, S);
-
             /* If this is a main scope, add a pointer to the corresponding
             ** module.
             */
@@ -5315,6 +5281,17 @@ static void ProcessScopeInfo (InputData* D)
         }
     }
 
+    /* Sort the scope infos, then add them to the lists of scopes for their
+    ** modules in this order, so these lists are sorted, too.
+    */
+    CollSort (&D->Info->ScopeInfoByName, CompareScopeInfoByName);
+    for (I = 0; I < CollCount (&D->Info->ScopeInfoByName); ++I) {
+        ScopeInfo* S = CollAt (&D->Info->ScopeInfoByName, I);
+        if (S->Mod.Info) {
+            CollAppend (&S->Mod.Info->ScopeInfoByName, S);
+        }
+    }
+
     /* Walk over all modules. If a module doesn't have scopes, it wasn't
     ** compiled with debug info which is ok. If it has debug info, it must
     ** also have a main scope. If there are scopes, sort them by name. Do
@@ -5344,9 +5321,6 @@ static void ProcessScopeInfo (InputData* D)
         /* Sort the C functions in this module by name */
         CollSort (&M->CSymFuncByName, CompareCSymInfoByName);
     }
-
-    /* Sort the scope infos */
-    CollSort (&D->Info->ScopeInfoByName, CompareScopeInfoByName);
 }
 
 
@@ -5365,12 +5339,6 @@ static void ProcessSpanInfo (InputData* D)
 {
     unsigned I;
 
-    /* Temporary collection with span infos sorted by address */
-    Collection SpanInfoByAddr = COLLECTION_INITIALIZER;
-
-    /* Resize the temporary collection */
-    CollGrow (&SpanInfoByAddr, CollCount (&D->Info->SpanInfoById));
-
     /* Walk over all spans and resolve the ids */
     for (I = 0; I < CollCount (&D->Info->SpanInfoById); ++I) {
 
@@ -5402,21 +5370,13 @@ static void ProcessSpanInfo (InputData* D)
         } else {
             S->Type.Info = CollAt (&D->Info->TypeInfoById, S->Type.Id);
         }
-
-        /* Append this span info to the temporary collection that is later
-        ** sorted by address.
-        */
-        CollAppend (&SpanInfoByAddr, S);
     }
 
     /* Sort the collection with all span infos by address */
-    CollSort (&SpanInfoByAddr, CompareSpanInfoByAddr);
+    CollSort (&D->SpanInfoByAddr, CompareSpanInfoByAddr);
 
     /* Create the span info list from the span info collection */
-    CreateSpanInfoList (&D->Info->SpanInfoByAddr, &SpanInfoByAddr);
-
-    /* Remove the temporary collection */
-    CollDone (&SpanInfoByAddr);
+    CreateSpanInfoList (&D->Info->SpanInfoByAddr, &D->SpanInfoByAddr);
 }
 
 
@@ -5475,9 +5435,6 @@ static void ProcessSymInfo (InputData* D)
             S->Scope.Info = 0;
         } else {
             S->Scope.Info = CollAt (&D->Info->ScopeInfoById, S->Scope.Id);
-
-            /* Place a backpointer to the symbol in the scope */
-            CollAppend (&S->Scope.Info->SymInfoByName, S);
         }
 
         /* Resolve the parent for cheap locals */
@@ -5541,6 +5498,19 @@ static void ProcessSymInfo (InputData* D)
 
     }
 
+    /* Sort the symbol infos. Then place backpointers to the symbols in their
+    ** scopes in the order of names, so the lists for the scopes are sorted.
+    ** Cheap locals don't have a scope yet, so they're not added.
+    */
+    CollSort (&D->Info->SymInfoByName, CompareSymInfoByName);
+    CollSort (&D->Info->SymInfoByVal,  CompareSymInfoByVal);
+    for (I = 0; I < CollCount (&D->Info->SymInfoByName); ++I) {
+        SymInfo* S = CollAt (&D->Info->SymInfoByName, I);
+        if (S->Scope.Info) {
+            CollAppend (&S->Scope.Info->SymInfoByName, S);
+        }
+    }
+
     /* Second run. Resolve scopes for cheap locals */
     for (I = 0; I < CollCount (&D->Info->SymInfoById); ++I) {
 
@@ -5575,10 +5545,479 @@ static void ProcessSymInfo (InputData* D)
         /* Sort the symbols in this scope by name */
         CollSort (&S->SymInfoByName, CompareSymInfoByName);
     }
+}
 
-    /* Sort the symbol infos */
-    CollSort (&D->Info->SymInfoByName, CompareSymInfoByName);
-    CollSort (&D->Info->SymInfoByVal,  CompareSymInfoByVal);
+
+
+/*****************************************************************************/
+/*                          Binary debug info files                          */
+/*****************************************************************************/
+
+
+
+static unsigned long BinWord (const unsigned char* P)
+/* Read a little endian 32 bit word */
+{
+    return (unsigned long) P[0]         |
+           ((unsigned long) P[1] << 8)  |
+           ((unsigned long) P[2] << 16) |
+           ((unsigned long) P[3] << 24);
+}
+
+
+
+static unsigned BinRecordWords (unsigned Section)
+/* Return the size of the elements of a section in words */
+{
+    switch (Section) {
+        case DBGBIN_CSYM:       return DBGBIN_CSYM_WORDS;
+        case DBGBIN_FILE:       return DBGBIN_FILE_WORDS;
+        case DBGBIN_LIB:        return DBGBIN_LIB_WORDS;
+        case DBGBIN_LINE:       return DBGBIN_LINE_WORDS;
+        case DBGBIN_MOD:        return DBGBIN_MOD_WORDS;
+        case DBGBIN_SCOPE:      return DBGBIN_SCOPE_WORDS;
+        case DBGBIN_SEG:        return DBGBIN_SEG_WORDS;
+        case DBGBIN_SPAN:       return DBGBIN_SPAN_WORDS;
+        case DBGBIN_SYM:        return DBGBIN_SYM_WORDS;
+        case DBGBIN_TYPE:       return DBGBIN_TYPE_WORDS;
+        default:                return 1;
+    }
+}
+
+
+
+static int IsBinaryFile (InputData* D)
+/* Check if the input file is a binary debug info file. If not, rewind it
+** so it can be read as a text file.
+*/
+{
+    unsigned char Magic[4];
+    if (fread (Magic, 1, sizeof (Magic), D->F) == sizeof (Magic) &&
+        BinWord (Magic) == DBGBIN_MAGIC) {
+        return 1;
+    }
+    rewind (D->F);
+    return 0;
+}
+
+
+
+static int MapBinaryFile (InputData* D, BinInput* B)
+/* Map the binary input file into memory. If this isn't possible, read it.
+** Return true on success.
+*/
+{
+    FILE*           F;
+    long            Size;
+    unsigned char*  Buf;
+
+#if !defined(_WIN32)
+    struct stat S;
+    if (fstat (fileno (D->F), &S) == 0 && S.st_size > 0) {
+        void* Data = mmap (0, S.st_size, PROT_READ, MAP_PRIVATE, fileno (D->F), 0);
+        if (Data != MAP_FAILED) {
+            B->Data   = Data;
+            B->Size   = S.st_size;
+            B->Mapped = 1;
+            return 1;
+        }
+    }
+#endif
+
+    /* Read the file. Open it again in binary mode for systems where this
+    ** makes a difference.
+    */
+    F = fopen (D->FileName, "rb");
+    if (F == 0                              ||
+        fseek (F, 0, SEEK_END) != 0         ||
+        (Size = ftell (F)) < 0              ||
+        fseek (F, 0, SEEK_SET) != 0) {
+        ParseError (D, CC65_ERROR, "Cannot read input file \"%s\": %s",
+                    D->FileName, strerror (errno));
+        if (F) {
+            fclose (F);
+        }
+        return 0;
+    }
+    Buf = xmalloc (Size);
+    if (fread (Buf, 1, Size, F) != (size_t) Size) {
+        ParseError (D, CC65_ERROR, "Cannot read input file \"%s\"",
+                    D->FileName);
+        fclose (F);
+        xfree (Buf);
+        return 0;
+    }
+    fclose (F);
+
+    B->Data   = Buf;
+    B->Size   = Size;
+    B->Mapped = 0;
+    return 1;
+}
+
+
+
+static void UnmapBinaryFile (BinInput* B)
+/* Release the memory used for the contents of a binary input file */
+{
+#if !defined(_WIN32)
+    if (B->Mapped) {
+        munmap ((void*) B->Data, B->Size);
+        return;
+    }
+#endif
+    xfree ((void*) B->Data);
+}
+
+
+
+static int ReadBinHeader (InputData* D, BinInput* B)
+/* Read and check the header of a binary debug info file. Return true if it's
+** ok.
+*/
+{
+    unsigned I;
+    unsigned long Version;
+
+    /* Check the size and version */
+    if (B->Size < DBGBIN_HEADER_SIZE) {
+        ParseError (D, CC65_ERROR, "Binary debug info file is truncated");
+        return 0;
+    }
+    Version = BinWord (B->Data + 4);
+    if ((Version >> 16) != DBGBIN_VER_MAJOR) {
+        ParseError (D, CC65_ERROR,
+                    "Unsupported version of the binary debug info format. "
+                    "Version found = %lu.%lu, version supported = %u.%u",
+                    Version >> 16, Version & 0xFFFF,
+                    DBGBIN_VER_MAJOR, DBGBIN_VER_MINOR);
+        return 0;
+    }
+
+    /* Read the section table and check that the sections are inside the
+    ** file.
+    */
+    for (I = 0; I < DBGBIN_SECTION_COUNT; ++I) {
+        unsigned long Bytes;
+        B->Offs[I]  = BinWord (B->Data + 8 + I * 8);
+        B->Count[I] = BinWord (B->Data + 12 + I * 8);
+        if (I == DBGBIN_STRINGS) {
+            Bytes = B->Count[I];
+        } else {
+            Bytes = B->Count[I] * BinRecordWords (I) * 4;
+            if (Bytes / (BinRecordWords (I) * 4) != B->Count[I]) {
+                Bytes = ULONG_MAX;
+            }
+        }
+        if (B->Offs[I] > B->Size || Bytes > B->Size - B->Offs[I]) {
+            ParseError (D, CC65_ERROR,
+                        "Section %u of binary debug info file is invalid", I);
+            return 0;
+        }
+    }
+
+    /* The pools must contain at least the empty items, and the string pool
+    ** must be terminated.
+    */
+    if (B->Count[DBGBIN_STRINGS] == 0                                   ||
+        B->Data[B->Offs[DBGBIN_STRINGS] + B->Count[DBGBIN_STRINGS] - 1] ||
+        B->Count[DBGBIN_IDLISTS] == 0) {
+        ParseError (D, CC65_ERROR, "Binary debug info file has invalid pools");
+        return 0;
+    }
+
+    /* Ok */
+    return 1;
+}
+
+
+
+static const unsigned char* BinRecord (const BinInput* B, unsigned Section,
+                                       unsigned long Index)
+/* Return a pointer to a record or index entry in a section */
+{
+    return B->Data + B->Offs[Section] + Index * BinRecordWords (Section) * 4;
+}
+
+
+
+static unsigned long BinField (const unsigned char* R, unsigned Field)
+/* Return a field from a record */
+{
+    return BinWord (R + Field * 4);
+}
+
+
+
+static long BinSigned (const unsigned char* R, unsigned Field)
+/* Return a signed field from a record */
+{
+    unsigned long W = BinField (R, Field);
+    if (W & 0x80000000UL) {
+        return -(long) (0xFFFFFFFFUL - W) - 1;
+    } else {
+        return (long) W;
+    }
+}
+
+
+
+static const StrBuf* BinString (InputData* D, const BinInput* B,
+                                const unsigned char* R, unsigned Field,
+                                StrBuf* S)
+/* Make S point to a string from the string pool without copying it. The
+** string buffer must not be freed.
+*/
+{
+    unsigned long Offs = BinField (R, Field);
+    if (Offs >= B->Count[DBGBIN_STRINGS]) {
+        ParseError (D, CC65_ERROR, "Invalid string offset %lu", Offs);
+        Offs = 0;
+    }
+    S->Buf       = (char*) B->Data + B->Offs[DBGBIN_STRINGS] + Offs;
+    S->Len       = strlen (S->Buf);
+    S->Allocated = 0;
+    return S;
+}
+
+
+
+static void BinIdList (InputData* D, const BinInput* B,
+                       const unsigned char* R, unsigned Field, Collection* C)
+/* Append the ids from a list in the id list pool to a collection */
+{
+    unsigned long Offs = BinField (R, Field);
+    unsigned long Count;
+    unsigned long I;
+
+    if (Offs >= B->Count[DBGBIN_IDLISTS]) {
+        ParseError (D, CC65_ERROR, "Invalid id list offset %lu", Offs);
+        return;
+    }
+    Count = BinField (BinRecord (B, DBGBIN_IDLISTS, Offs), 0);
+    if (Count >= B->Count[DBGBIN_IDLISTS] - Offs) {
+        ParseError (D, CC65_ERROR, "Invalid id list at offset %lu", Offs);
+        return;
+    }
+    CollGrow (C, Count);
+    for (I = 1; I <= Count; ++I) {
+        CollAppendId (C, BinField (BinRecord (B, DBGBIN_IDLISTS, Offs + I), 0));
+    }
+}
+
+
+
+static void BinIndex (InputData* D, const BinInput* B, unsigned Index,
+                      const Collection* Items, Collection* C)
+/* Fill a collection with items in the order given by an index section */
+{
+    unsigned long I;
+
+    if (B->Count[Index] != CollCount (Items)) {
+        ParseError (D, CC65_ERROR, "Index %u has an invalid size", Index);
+        return;
+    }
+    CollGrow (C, B->Count[Index]);
+    for (I = 0; I < B->Count[Index]; ++I) {
+        unsigned long Id = BinField (BinRecord (B, Index, I), 0);
+        if (Id >= CollCount (Items)) {
+            ParseError (D, CC65_ERROR, "Invalid id %lu in index %u", Id, Index);
+            return;
+        }
+        CollAppend (C, CollAt (Items, Id));
+    }
+}
+
+
+
+static void ReadBinItems (InputData* D, const BinInput* B)
+/* Create the items from the records of a binary debug info file */
+{
+    unsigned long I;
+    DbgInfo* Info = D->Info;
+    StrBuf Name;
+
+    /* C symbols */
+    CollGrow (&Info->CSymInfoById, B->Count[DBGBIN_CSYM]);
+    for (I = 0; I < B->Count[DBGBIN_CSYM]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_CSYM, I);
+        CSymInfo* S = NewCSymInfo (BinString (D, B, R, DBGBIN_CSYM_NAME, &Name));
+        S->Id       = I;
+        S->Kind     = CC65_CSYM_VAR;
+        S->SC       = BinField (R, DBGBIN_CSYM_SC);
+        S->Offs     = BinSigned (R, DBGBIN_CSYM_OFFS);
+        S->Sym.Id   = BinField (R, DBGBIN_CSYM_SYM);
+        S->Type.Id  = BinField (R, DBGBIN_CSYM_TYPE);
+        S->Scope.Id = BinField (R, DBGBIN_CSYM_SCOPE);
+        CollAppend (&Info->CSymInfoById, S);
+    }
+
+    /* Files */
+    CollGrow (&Info->FileInfoById, B->Count[DBGBIN_FILE]);
+    for (I = 0; I < B->Count[DBGBIN_FILE]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_FILE, I);
+        FileInfo* F = NewFileInfo (BinString (D, B, R, DBGBIN_FILE_NAME, &Name));
+        F->Id       = I;
+        F->Size     = BinField (R, DBGBIN_FILE_SIZE);
+        F->MTime    = BinField (R, DBGBIN_FILE_MTIME);
+        BinIdList (D, B, R, DBGBIN_FILE_MODS, &F->ModInfoByName);
+        CollAppend (&Info->FileInfoById, F);
+    }
+
+    /* Libraries */
+    CollGrow (&Info->LibInfoById, B->Count[DBGBIN_LIB]);
+    for (I = 0; I < B->Count[DBGBIN_LIB]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_LIB, I);
+        LibInfo* L = NewLibInfo (BinString (D, B, R, DBGBIN_LIB_NAME, &Name));
+        L->Id       = I;
+        CollAppend (&Info->LibInfoById, L);
+    }
+
+    /* Line infos */
+    CollGrow (&Info->LineInfoById, B->Count[DBGBIN_LINE]);
+    for (I = 0; I < B->Count[DBGBIN_LINE]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_LINE, I);
+        LineInfo* L = NewLineInfo ();
+        L->Id       = I;
+        L->Line     = BinField (R, DBGBIN_LINE_LINE);
+        L->File.Id  = BinField (R, DBGBIN_LINE_FILE);
+        L->Type     = (cc65_line_type) BinField (R, DBGBIN_LINE_TYPE);
+        L->Count    = BinField (R, DBGBIN_LINE_COUNT);
+        BinIdList (D, B, R, DBGBIN_LINE_SPANS, &L->SpanInfoList);
+        CollAppend (&Info->LineInfoById, L);
+    }
+
+    /* Modules */
+    CollGrow (&Info->ModInfoById, B->Count[DBGBIN_MOD]);
+    for (I = 0; I < B->Count[DBGBIN_MOD]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_MOD, I);
+        ModInfo* M = NewModInfo (BinString (D, B, R, DBGBIN_MOD_NAME, &Name));
+        M->Id       = I;
+        M->File.Id  = BinField (R, DBGBIN_MOD_FILE);
+        M->Lib.Id   = BinField (R, DBGBIN_MOD_LIB);
+        CollAppend (&Info->ModInfoById, M);
+    }
+
+    /* Scopes */
+    CollGrow (&Info->ScopeInfoById, B->Count[DBGBIN_SCOPE]);
+    for (I = 0; I < B->Count[DBGBIN_SCOPE]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_SCOPE, I);
+        ScopeInfo* S = NewScopeInfo (BinString (D, B, R, DBGBIN_SCOPE_NAME, &Name));
+        S->Id        = I;
+        S->Type      = (cc65_scope_type) BinField (R, DBGBIN_SCOPE_TYPE);
+        S->Size      = BinField (R, DBGBIN_SCOPE_SIZE);
+        S->Mod.Id    = BinField (R, DBGBIN_SCOPE_MOD);
+        S->Parent.Id = BinField (R, DBGBIN_SCOPE_PARENT);
+        S->Label.Id  = BinField (R, DBGBIN_SCOPE_SYM);
+        BinIdList (D, B, R, DBGBIN_SCOPE_SPANS, &S->SpanInfoList);
+        CollAppend (&Info->ScopeInfoById, S);
+    }
+
+    /* Segments */
+    CollGrow (&Info->SegInfoById, B->Count[DBGBIN_SEG]);
+    for (I = 0; I < B->Count[DBGBIN_SEG]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_SEG, I);
+        StrBuf OutputName;
+        SegInfo* S = NewSegInfo (BinString (D, B, R, DBGBIN_SEG_NAME, &Name),
+                                 I,
+                                 BinField (R, DBGBIN_SEG_START),
+                                 BinField (R, DBGBIN_SEG_SIZE),
+                                 BinString (D, B, R, DBGBIN_SEG_ONAME, &OutputName),
+                                 BinField (R, DBGBIN_SEG_OOFFS));
+        CollAppend (&Info->SegInfoById, S);
+    }
+
+    /* Spans */
+    CollGrow (&Info->SpanInfoById, B->Count[DBGBIN_SPAN]);
+    for (I = 0; I < B->Count[DBGBIN_SPAN]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_SPAN, I);
+        SpanInfo* S = NewSpanInfo ();
+        S->Id       = I;
+        S->Start    = BinField (R, DBGBIN_SPAN_START);
+        S->End      = S->Start + BinField (R, DBGBIN_SPAN_SIZE) - 1;
+        S->Seg.Id   = BinField (R, DBGBIN_SPAN_SEG);
+        S->Type.Id  = BinField (R, DBGBIN_SPAN_TYPE);
+        CollAppend (&Info->SpanInfoById, S);
+    }
+
+    /* Symbols */
+    CollGrow (&Info->SymInfoById, B->Count[DBGBIN_SYM]);
+    for (I = 0; I < B->Count[DBGBIN_SYM]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_SYM, I);
+        SymInfo* S = NewSymInfo (BinString (D, B, R, DBGBIN_SYM_NAME, &Name));
+        S->Id        = I;
+        S->Type      = (cc65_symbol_type) BinField (R, DBGBIN_SYM_TYPE);
+        S->Value     = BinSigned (R, DBGBIN_SYM_VAL);
+        S->Size      = BinField (R, DBGBIN_SYM_SIZE);
+        S->Exp.Id    = BinField (R, DBGBIN_SYM_EXP);
+        S->Seg.Id    = BinField (R, DBGBIN_SYM_SEG);
+        S->Scope.Id  = BinField (R, DBGBIN_SYM_SCOPE);
+        S->Parent.Id = BinField (R, DBGBIN_SYM_PARENT);
+        BinIdList (D, B, R, DBGBIN_SYM_DEF, &S->DefLineInfoList);
+        BinIdList (D, B, R, DBGBIN_SYM_REF, &S->RefLineInfoList);
+        CollAppend (&Info->SymInfoById, S);
+    }
+
+    /* Types. The type strings are converted in place, so copy them */
+    CollGrow (&Info->TypeInfoById, B->Count[DBGBIN_TYPE]);
+    for (I = 0; I < B->Count[DBGBIN_TYPE]; ++I) {
+        const unsigned char* R = BinRecord (B, DBGBIN_TYPE, I);
+        StrBuf Value = STRBUF_INITIALIZER;
+        TypeInfo* T;
+        SB_Copy (&Value, BinString (D, B, R, DBGBIN_TYPE_VAL, &Name));
+        T = ParseTypeString (D, &Value);
+        SB_Done (&Value);
+        if (T == 0) {
+            return;
+        }
+        T->Id = I;
+        CollAppend (&Info->TypeInfoById, T);
+    }
+}
+
+
+
+static void ReadBinary (InputData* D)
+/* Read a binary debug info file. The file contains the items with ids and
+** the sort orders needed, so no parsing or sorting is necessary. The data
+** is then handed to the same postprocessing as the text format.
+*/
+{
+    BinInput B;
+
+    /* There's no line information for errors */
+    D->SLine = 0;
+    D->SCol  = 0;
+
+    /* Map the file into memory and check the header */
+    if (!MapBinaryFile (D, &B)) {
+        return;
+    }
+    if (ReadBinHeader (D, &B)) {
+
+        /* The data is equivalent to the current text format */
+        D->Info->MajorVersion = VER_MAJOR;
+        D->Info->MinorVersion = VER_MINOR;
+
+        /* Create the items */
+        ReadBinItems (D, &B);
+
+        /* Fill the sorted collections from the indices */
+        if (D->Errors == 0) {
+            DbgInfo* Info = D->Info;
+            BinIndex (D, &B, DBGBIN_FILE_BYNAME,  &Info->FileInfoById,  &Info->FileInfoByName);
+            BinIndex (D, &B, DBGBIN_LINE_BYLINE,  &Info->LineInfoById,  &D->LineInfoByLine);
+            BinIndex (D, &B, DBGBIN_MOD_BYNAME,   &Info->ModInfoById,   &Info->ModInfoByName);
+            BinIndex (D, &B, DBGBIN_SCOPE_BYNAME, &Info->ScopeInfoById, &Info->ScopeInfoByName);
+            BinIndex (D, &B, DBGBIN_SEG_BYNAME,   &Info->SegInfoById,   &Info->SegInfoByName);
+            BinIndex (D, &B, DBGBIN_SPAN_BYADDR,  &Info->SpanInfoById,  &D->SpanInfoByAddr);
+            BinIndex (D, &B, DBGBIN_SYM_BYNAME,   &Info->SymInfoById,   &Info->SymInfoByName);
+            BinIndex (D, &B, DBGBIN_SYM_BYVAL,    &Info->SymInfoById,   &Info->SymInfoByVal);
+        }
+    }
+
+    /* Release the file contents. All strings have been copied. */
+    UnmapBinaryFile (&B);
 }
 
 
@@ -5612,6 +6051,8 @@ cc65_dbginfo cc65_read_dbginfo (const char* FileName, cc65_errorfunc ErrFunc)
         STRBUF_INITIALIZER,     /* String constant */
         0,                      /* Function called in case of errors */
         0,                      /* Pointer to debug info */
+        COLLECTION_INITIALIZER, /* Line infos */
+        COLLECTION_INITIALIZER, /* Span infos */
     };
     D.FileName = FileName;
     D.Error    = ErrFunc;
@@ -5629,6 +6070,12 @@ cc65_dbginfo cc65_read_dbginfo (const char* FileName, cc65_errorfunc ErrFunc)
     /* Create a new debug info struct */
     D.Info = NewDbgInfo (FileName);
 
+    /* Binary files don't need the tokenizer */
+    if (IsBinaryFile (&D)) {
+        ReadBinary (&D);
+        goto CloseAndExit;
+    }
+
     /* Prime the pump */
     NextToken (&D);
 
@@ -5758,6 +6205,8 @@ CloseAndExit:
     if (D.Errors > 0) {
         /* Free allocated stuff */
         FreeDbgInfo (D.Info);
+        CollDone (&D.LineInfoByLine);
+        CollDone (&D.SpanInfoByAddr);
         return 0;
     }
 
@@ -5774,6 +6223,10 @@ CloseAndExit:
     ProcessSpanInfo (&D);
     ProcessSymInfo (&D);
 
+    /* Free the temporary collections */
+    CollDone (&D.LineInfoByLine);
+    CollDone (&D.SpanInfoByAddr);
+
 #if DEBUG
     /* Debug output */
     DumpData (&D);
@@ -6510,13 +6963,9 @@ const cc65_spaninfo* cc65_span_byaddr (cc65_dbginfo Handle, unsigned long Addr)
 
         /* Prepare the struct we will return to the caller */
         D = new_cc65_spaninfo (E->Count);
-        if (E->Count == 1) {
-            CopySpanInfo (D->data, E->Data);
-        } else {
-            for (I = 0; I < D->count; ++I) {
-                /* Copy data */
-                CopySpanInfo (D->data + I, ((SpanInfo**) E->Data)[I]);
-            }
+        for (I = 0; I < D->count; ++I) {
+            /* Copy data */
+            CopySpanInfo (D->data + I, Info->SpanInfoByAddr.Spans[E->Index + I]);
         }
     }
 
@@ -7312,6 +7761,190 @@ void cc65_free_symbolinfo (cc65_dbginfo Handle, const cc65_symbolinfo* Info)
 
 
 
+/*****************************************************************************/
+/*                              Address lookup                               */
+/*****************************************************************************/
+
+
+
+static void LookupRange (const SpanInfoList* L, const SpanInfoListEntry* E,
+                         cc65_addrdata* D)
+/* Determine the span, line and scope ids for all addresses in the range E.
+** The smallest span wins, since it is the innermost one. For lines, C source
+** is preferred over assembler source, which is preferred over macros.
+*/
+{
+    unsigned I, J;
+    const SpanInfo* Span      = 0;
+    const SpanInfo* LineSpan  = 0;
+    const SpanInfo* ScopeSpan = 0;
+    const LineInfo* Line      = 0;
+    int             LineRank  = -1;
+
+    for (I = 0; I < E->Count; ++I) {
+
+        /* Get the next span for this range */
+        const SpanInfo* S = L->Spans[E->Index + I];
+        cc65_addr Size = S->End - S->Start;
+
+        /* Remember the smallest ones */
+        if (Span == 0 || Size < Span->End - Span->Start) {
+            Span = S;
+        }
+        if (S->ScopeInfoList && CollCount (S->ScopeInfoList) > 0 &&
+            (ScopeSpan == 0 || Size < ScopeSpan->End - ScopeSpan->Start)) {
+            ScopeSpan = S;
+        }
+
+        /* Check the lines of this span */
+        if (S->LineInfoList == 0) {
+            continue;
+        }
+        for (J = 0; J < CollCount (S->LineInfoList); ++J) {
+            const LineInfo* LI = CollAt (S->LineInfoList, J);
+            int Rank = (LI->Type == CC65_LINE_EXT)? 2 :
+                       (LI->Type == CC65_LINE_ASM)? 1 : 0;
+            if (Rank > LineRank ||
+                (Rank == LineRank && Size < LineSpan->End - LineSpan->Start)) {
+                Line     = LI;
+                LineRank = Rank;
+                LineSpan = S;
+            }
+        }
+    }
+
+    /* Fill in the data */
+    D->span_id  = Span->Id;
+    D->scope_id = ScopeSpan?
+        ((const ScopeInfo*) CollAt (ScopeSpan->ScopeInfoList, 0))->Id : CC65_INV_ID;
+    if (Line) {
+        D->line_id     = Line->Id;
+        D->source_id   = Line->File.Info->Id;
+        D->source_line = Line->Line;
+    } else {
+        D->line_id     = CC65_INV_ID;
+        D->source_id   = CC65_INV_ID;
+        D->source_line = 0;
+    }
+}
+
+
+
+unsigned cc65_lookup_addresses (cc65_dbginfo Handle, const cc65_addr* Addrs,
+                                unsigned Count, cc65_addrdata* Data)
+/* Look up span, line, scope, source and symbol ids for Count addresses and store
+** them in Data, which must have room for Count entries. The addresses
+** should be sorted ascending, so the lookup is done in one merge pass over
+** the internal tables. Unsorted addresses work, but each step backwards
+** costs a binary search. The function returns the number of addresses that
+** are covered by at least one span. No memory is allocated, so there is
+** nothing to free.
+*/
+{
+    const DbgInfo*              Info;
+    const SpanInfoList*         L;
+    const Collection*           Syms;
+    const SpanInfoListEntry*    Last = 0;
+    const SymInfo*              Label = 0;
+    unsigned                    R = 0;
+    unsigned                    S = 0;
+    unsigned                    Found = 0;
+    cc65_addrdata               Cur;
+    unsigned                    I;
+
+    /* Check the parameter */
+    assert (Handle != 0);
+
+    /* The handle is actually a pointer to a debug info struct */
+    Info = Handle;
+    L    = &Info->SpanInfoByAddr;
+    Syms = &Info->SymInfoByVal;
+
+    /* Ids for the range in Last */
+    Cur.span_id     = CC65_INV_ID;
+    Cur.line_id     = CC65_INV_ID;
+    Cur.scope_id    = CC65_INV_ID;
+    Cur.source_id   = CC65_INV_ID;
+    Cur.source_line = 0;
+    Cur.symbol_id   = CC65_INV_ID;
+
+    for (I = 0; I < Count; ++I) {
+
+        cc65_addr Addr = Addrs[I];
+
+        /* If the address is smaller than the last one, we cannot continue
+        ** from where we are, so search the new start positions.
+        */
+        if (I > 0 && Addr < Addrs[I-1]) {
+
+            /* First range that doesn't end before the address */
+            int Lo = 0;
+            int Hi = (int) L->Count - 1;
+            while (Lo <= Hi) {
+                int Mid = (Lo + Hi) / 2;
+                if (L->List[Mid].End < Addr) {
+                    Lo = Mid + 1;
+                } else {
+                    Hi = Mid - 1;
+                }
+            }
+            R = Lo;
+
+            /* First symbol with the value, and the last label before it */
+            FindSymInfoByValue (Syms, Addr, &S);
+            Label = 0;
+            for (Lo = (int) S - 1; Lo >= 0; --Lo) {
+                const SymInfo* Sym = CollAt (Syms, Lo);
+                if (Sym->Type == CC65_SYM_LABEL) {
+                    Label = Sym;
+                    break;
+                }
+            }
+        }
+
+        /* Skip the ranges that end before the address */
+        while (R < L->Count && L->List[R].End < Addr) {
+            ++R;
+        }
+
+        /* Use the range if it covers the address. The ids are the same for
+        ** all addresses of a range, so compute them only once.
+        */
+        if (R < L->Count && L->List[R].Start <= Addr) {
+            if (&L->List[R] != Last) {
+                Last = &L->List[R];
+                LookupRange (L, Last, &Cur);
+            }
+            Data[I] = Cur;
+            ++Found;
+        } else {
+            Data[I].span_id     = CC65_INV_ID;
+            Data[I].line_id     = CC65_INV_ID;
+            Data[I].scope_id    = CC65_INV_ID;
+            Data[I].source_id   = CC65_INV_ID;
+            Data[I].source_line = 0;
+        }
+
+        /* Advance to the last label at or below the address */
+        while (S < CollCount (Syms)) {
+            const SymInfo* Sym = CollAt (Syms, S);
+            if (Sym->Value > (long) Addr) {
+                break;
+            }
+            if (Sym->Type == CC65_SYM_LABEL) {
+                Label = Sym;
+            }
+            ++S;
+        }
+        Data[I].symbol_id = Label? Label->Id : CC65_INV_ID;
+    }
+
+    /* Return the number of addresses with spans */
+    return Found;
+}
+
+
+
 /*****************************************************************************/
 /*                                   Types                                   */
 /*****************************************************************************/
@@ -629,6 +629,46 @@ void cc65_free_symbolinfo (cc65_dbginfo handle, const cc65_symbolinfo* info);
 
 
 
+/*****************************************************************************/
+/*                              Address lookup                               */
+/*****************************************************************************/
+
+
+
+/* Result of an address lookup. An id is CC65_INV_ID if there is no matching
+** item for the address.
+**  - span_id is the smallest span that covers the address.
+**  - line_id is a line of the covering spans. C source lines are preferred
+**    over assembler source lines, which are preferred over macro lines.
+**    Between lines of the same kind, the one from the smaller span wins.
+**    source_id and source_line are taken from this line.
+**  - scope_id is the first scope of the smallest covering span with scopes,
+**    which is the innermost scope.
+**  - symbol_id is the label with the largest value at or below the address.
+*/
+typedef struct cc65_addrdata cc65_addrdata;
+struct cc65_addrdata {
+    unsigned            span_id;        /* Innermost span */
+    unsigned            line_id;        /* Line for the address */
+    unsigned            source_id;      /* Source file of the line */
+    cc65_line           source_line;    /* Line number in the source file */
+    unsigned            scope_id;       /* Innermost scope */
+    unsigned            symbol_id;      /* Nearest label */
+};
+
+
+
+unsigned cc65_lookup_addresses (cc65_dbginfo handle, const cc65_addr* addrs,
+                                unsigned count, cc65_addrdata* data);
+/* Look up span, line, scope, source and symbol ids for count addresses and store
+** them in data, which must have room for count entries. The addresses
+** should be sorted ascending, so the lookup is done in one merge pass. The
+** function returns the number of addresses that are covered by at least one
+** span. No memory is allocated, so there is nothing to free.
+*/
+
+
+
 /*****************************************************************************/
 /*                                   Types                                   */
 /*****************************************************************************/
@@ -75,7 +75,7 @@ static Collection Assertions = STATIC_COLLECTION_INITIALIZER;
 
 
 
-Assertion* ReadAssertion (FILE* F, struct ObjData* O)
+Assertion* ReadAssertion (InFile* F, struct ObjData* O)
 /* Read an assertion from the given file */
 {
     /* Allocate memory */
@@ -100,6 +100,14 @@ Assertion* ReadAssertion (FILE* F, struct ObjData* O)
 
 
 
+ExprNode* GetAssertionExpr (const Assertion* A)
+/* Return the expression of an assertion */
+{
+    return A->Expr;
+}
+
+
+
 void CheckAssertions (void)
 /* Check all assertions */
 {
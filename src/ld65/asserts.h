@@ -54,9 +54,15 @@
 /* Assertion object forward decl */
 typedef struct Assertion Assertion;
 
+/* ExprNode forward decl */
+struct ExprNode;
+
 /* ObjData forward decl */
 struct ObjData;
 
+/* InFile forward decl */
+struct InFile;
+
 
 
 /*****************************************************************************/
@@ -65,9 +71,12 @@ struct ObjData;
 
 
 
-Assertion* ReadAssertion (FILE* F, struct ObjData* O);
+Assertion* ReadAssertion (struct InFile* F, struct ObjData* O);
 /* Read an assertion from the given file */
 
+struct ExprNode* GetAssertionExpr (const Assertion* A);
+/* Return the expression of an assertion */
+
 void CheckAssertions (void);
 /* Check all assertions */
 
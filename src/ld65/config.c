@@ -121,6 +121,7 @@ static Collection       SegDescList = STATIC_COLLECTION_INITIALIZER;
 #define SA_START        0x0080
 #define SA_OPTIONAL     0x0100
 #define SA_FILLVAL      0x0200
+#define SA_KEEP         0x0400
 
 /* Symbol types used in the CfgSymbol structure */
 typedef enum {
@@ -648,6 +649,7 @@ static void ParseSegments (void)
         {   "ALIGN_LOAD",       CFGTOK_ALIGN_LOAD       },
         {   "DEFINE",           CFGTOK_DEFINE           },
         {   "FILLVAL",          CFGTOK_FILLVAL          },
+        {   "KEEP",             CFGTOK_KEEP             },
         {   "LOAD",             CFGTOK_LOAD             },
         {   "OFFSET",           CFGTOK_OFFSET           },
         {   "OPTIONAL",         CFGTOK_OPTIONAL         },
@@ -724,6 +726,15 @@ static void ParseSegments (void)
                     S->Flags |= SF_FILLVAL;
                     break;
 
+                case CFGTOK_KEEP:
+                    FlagAttr (&S->Attr, SA_KEEP, "KEEP");
+                    CfgBoolToken ();
+                    if (CfgTok == CFGTOK_TRUE) {
+                        S->Flags |= SF_KEEP;
+                    }
+                    CfgNextTok ();
+                    break;
+
                 case CFGTOK_LOAD:
                     FlagAttr (&S->Attr, SA_LOAD, "LOAD");
                     S->Load = CfgGetMemory (GetStrBufId (&CfgSVal));
@@ -2232,3 +2243,31 @@ void CfgWriteTarget (void)
         }
     }
 }
+
+
+
+int CfgKeepSegment (unsigned Name)
+/* Return true if the config file requests that no sections of the segment
+** with the given name are removed as unused.
+*/
+{
+    const SegDesc* S = CfgFindSegDesc (Name);
+    return (S != 0 && (S->Flags & SF_KEEP) != 0);
+}
+
+
+
+int CfgKeepSymbol (unsigned Name)
+/* Return true if the symbol with the given name is referenced by the config
+** file in a way that isn't visible as an import (o65 exports).
+*/
+{
+    unsigned I;
+    for (I = 0; I < CollCount (&CfgSymbols); ++I) {
+        const CfgSymbol* Sym = CollConstAt (&CfgSymbols, I);
+        if (Sym->Type == CfgSymO65Export && Sym->Name == Name) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -97,6 +97,7 @@ struct SegDesc {
 #define SF_LOAD_DEF     0x0400          /* LOAD symbols already defined */
 #define SF_FILLVAL      0x0800          /* Segment has separate fill value */
 #define SF_OVERWRITE    0x1000          /* Segment can overwrite (part of) another one */
+#define SF_KEEP         0x2000          /* Never remove sections of this segment */
 
 
 
@@ -121,6 +122,16 @@ unsigned CfgProcess (void);
 void CfgWriteTarget (void);
 /* Write the target file(s) */
 
+int CfgKeepSegment (unsigned Name);
+/* Return true if the config file requests that no sections of the segment
+** with the given name are removed as unused.
+*/
+
+int CfgKeepSymbol (unsigned Name);
+/* Return true if the symbol with the given name is referenced by the config
+** file in a way that isn't visible as an import (o65 exports).
+*/
+
 
 
 /* End of config.h */
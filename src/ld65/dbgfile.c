@@ -34,14 +34,23 @@
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 
+/* common */
+#include "strbuf.h"
+#include "xmalloc.h"
+
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
 #include "dbgfile.h"
 #include "dbgsyms.h"
 #include "error.h"
 #include "fileinfo.h"
+#include "fileio.h"
 #include "global.h"
 #include "library.h"
 #include "lineinfo.h"
@@ -52,12 +61,264 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* A growable array of words used for the sections of binary debug files */
+typedef struct WordBuf WordBuf;
+struct WordBuf {
+    unsigned long*      Words;          /* Words in the buffer */
+    unsigned            Count;          /* Number of words used */
+    unsigned            Size;           /* Number of words allocated */
+};
+
+/* Contents of a binary debug info file. The string pool is kept separately,
+** the other sections are arrays of words.
+*/
+static StrBuf  BinStrings = STATIC_STRBUF_INITIALIZER;
+static WordBuf BinSections[DBGBIN_SECTION_COUNT];
+
+/* Number of words in the item records */
+static const unsigned char RecordWords[DBGBIN_SECTION_COUNT] = {
+    1,                          /* DBGBIN_STRINGS */
+    1,                          /* DBGBIN_IDLISTS */
+    DBGBIN_CSYM_WORDS,          /* DBGBIN_CSYM */
+    DBGBIN_FILE_WORDS,          /* DBGBIN_FILE */
+    DBGBIN_LIB_WORDS,           /* DBGBIN_LIB */
+    DBGBIN_LINE_WORDS,          /* DBGBIN_LINE */
+    DBGBIN_MOD_WORDS,           /* DBGBIN_MOD */
+    DBGBIN_SCOPE_WORDS,         /* DBGBIN_SCOPE */
+    DBGBIN_SEG_WORDS,           /* DBGBIN_SEG */
+    DBGBIN_SPAN_WORDS,          /* DBGBIN_SPAN */
+    DBGBIN_SYM_WORDS,           /* DBGBIN_SYM */
+    DBGBIN_TYPE_WORDS,          /* DBGBIN_TYPE */
+    1, 1, 1, 1, 1, 1, 1, 1,     /* Indices */
+};
+
+/* Section sorted by the compare functions used with qsort */
+static const WordBuf* SortSection;
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
 
 
 
+static void AppendWord (WordBuf* B, unsigned long W)
+/* Append a word to a word buffer */
+{
+    if (B->Count == B->Size) {
+        B->Size  = (B->Size == 0)? 256 : B->Size * 2;
+        B->Words = xrealloc (B->Words, B->Size * sizeof (B->Words[0]));
+    }
+    B->Words[B->Count++] = W & 0xFFFFFFFFUL;
+}
+
+
+
+static const unsigned long* GetRecord (const WordBuf* B, unsigned long Id)
+/* Return the record with the given id from an item section */
+{
+    return B->Words + Id * RecordWords[B - BinSections];
+}
+
+
+
+static const char* GetBinString (unsigned long Offs)
+/* Return a string from the string pool */
+{
+    return SB_GetConstBuf (&BinStrings) + Offs;
+}
+
+
+
+static long GetSigned (unsigned long W)
+/* Return a signed value from a record word */
+{
+    if (W & 0x80000000UL) {
+        return -(long) (0xFFFFFFFFUL - W) - 1;
+    } else {
+        return (long) W;
+    }
+}
+
+
+
+static int CompareFileByName (const void* L, const void* R)
+/* Compare files by name, modification time and size */
+{
+    const unsigned long* Left  = GetRecord (SortSection, *(const unsigned long*) L);
+    const unsigned long* Right = GetRecord (SortSection, *(const unsigned long*) R);
+    int Res = strcmp (GetBinString (Left[DBGBIN_FILE_NAME]),
+                      GetBinString (Right[DBGBIN_FILE_NAME]));
+    if (Res == 0) {
+        if (Left[DBGBIN_FILE_MTIME] != Right[DBGBIN_FILE_MTIME]) {
+            Res = (Left[DBGBIN_FILE_MTIME] < Right[DBGBIN_FILE_MTIME])? -1 : 1;
+        } else if (Left[DBGBIN_FILE_SIZE] != Right[DBGBIN_FILE_SIZE]) {
+            Res = (Left[DBGBIN_FILE_SIZE] < Right[DBGBIN_FILE_SIZE])? -1 : 1;
+        }
+    }
+    return Res;
+}
+
+
+
+static int CompareLineByLine (const void* L, const void* R)
+/* Compare line infos by file and line number */
+{
+    const unsigned long* Left  = GetRecord (SortSection, *(const unsigned long*) L);
+    const unsigned long* Right = GetRecord (SortSection, *(const unsigned long*) R);
+    if (Left[DBGBIN_LINE_FILE] != Right[DBGBIN_LINE_FILE]) {
+        return (Left[DBGBIN_LINE_FILE] < Right[DBGBIN_LINE_FILE])? -1 : 1;
+    } else if (Left[DBGBIN_LINE_LINE] != Right[DBGBIN_LINE_LINE]) {
+        return (Left[DBGBIN_LINE_LINE] < Right[DBGBIN_LINE_LINE])? -1 : 1;
+    } else {
+        return (Left < Right)? -1 : (Left > Right);
+    }
+}
+
+
+
+static int CompareByName (const void* L, const void* R)
+/* Compare items by name, then by id. The name must be the first field */
+{
+    const unsigned long* Left  = GetRecord (SortSection, *(const unsigned long*) L);
+    const unsigned long* Right = GetRecord (SortSection, *(const unsigned long*) R);
+    int Res = strcmp (GetBinString (Left[0]), GetBinString (Right[0]));
+    if (Res == 0) {
+        /* Records are in id order, so this compares the ids */
+        Res = (Left < Right)? -1 : (Left > Right);
+    }
+    return Res;
+}
+
+
+
+static int CompareSpanByAddr (const void* L, const void* R)
+/* Compare spans by start and end address */
+{
+    const unsigned long* Left  = GetRecord (SortSection, *(const unsigned long*) L);
+    const unsigned long* Right = GetRecord (SortSection, *(const unsigned long*) R);
+    const unsigned long* LSeg  = GetRecord (&BinSections[DBGBIN_SEG], Left[DBGBIN_SPAN_SEG]);
+    const unsigned long* RSeg  = GetRecord (&BinSections[DBGBIN_SEG], Right[DBGBIN_SPAN_SEG]);
+
+    /* Calculate the absolute addresses the same way as the debug info
+    ** library does.
+    */
+    unsigned long LStart = (LSeg[DBGBIN_SEG_START] + Left[DBGBIN_SPAN_START]) & 0xFFFFFFFFUL;
+    unsigned long RStart = (RSeg[DBGBIN_SEG_START] + Right[DBGBIN_SPAN_START]) & 0xFFFFFFFFUL;
+    unsigned long LEnd   = (LStart + Left[DBGBIN_SPAN_SIZE] - 1) & 0xFFFFFFFFUL;
+    unsigned long REnd   = (RStart + Right[DBGBIN_SPAN_SIZE] - 1) & 0xFFFFFFFFUL;
+
+    if (LStart != RStart) {
+        return (LStart < RStart)? -1 : 1;
+    } else if (LEnd != REnd) {
+        return (LEnd < REnd)? -1 : 1;
+    } else {
+        return 0;
+    }
+}
+
+
+
+static int CompareSymByVal (const void* L, const void* R)
+/* Compare symbols by value, then by name */
+{
+    const unsigned long* Left  = GetRecord (SortSection, *(const unsigned long*) L);
+    const unsigned long* Right = GetRecord (SortSection, *(const unsigned long*) R);
+    long LVal = GetSigned (Left[DBGBIN_SYM_VAL]);
+    long RVal = GetSigned (Right[DBGBIN_SYM_VAL]);
+    if (LVal != RVal) {
+        return (LVal < RVal)? -1 : 1;
+    }
+    return CompareByName (L, R);
+}
+
+
+
+static void CreateIndex (unsigned Index, unsigned Section,
+                         int (*Compare) (const void*, const void*))
+/* Create an index section containing the ids of the items in another
+** section, sorted by the given compare function.
+*/
+{
+    WordBuf* B = &BinSections[Index];
+    unsigned Count = BinSections[Section].Count / RecordWords[Section];
+    unsigned I;
+
+    for (I = 0; I < Count; ++I) {
+        AppendWord (B, I);
+    }
+
+    SortSection = &BinSections[Section];
+    if (Count > 1) {
+        qsort (B->Words, Count, sizeof (B->Words[0]), Compare);
+    }
+}
+
+
+
+void AddBinDbgRecord (unsigned Section, const unsigned long* Fields)
+/* Add a record to one of the item sections of a binary debug file. The
+** number of fields is determined by the section.
+*/
+{
+    unsigned I;
+    for (I = 0; I < RecordWords[Section]; ++I) {
+        AppendWord (&BinSections[Section], Fields[I]);
+    }
+}
+
+
+
+unsigned long AddBinDbgString (const char* S)
+/* Add a string to the string pool of a binary debug file and return its
+** offset.
+*/
+{
+    unsigned long Offs;
+
+    /* The empty string is always at offset zero */
+    if (*S == '\0') {
+        return 0;
+    }
+    Offs = SB_GetLen (&BinStrings);
+    SB_AppendStr (&BinStrings, S);
+    SB_AppendChar (&BinStrings, '\0');
+    return Offs;
+}
+
+
+
+unsigned long StartBinDbgList (unsigned Count)
+/* Start a list of ids with the given count in the id list pool of a binary
+** debug file. Count calls to AddBinDbgListId must follow. Return the offset
+** of the list, which is zero for an empty list.
+*/
+{
+    WordBuf* B = &BinSections[DBGBIN_IDLISTS];
+    if (Count == 0) {
+        return 0;
+    }
+    AppendWord (B, Count);
+    return B->Count - 1;
+}
+
+
+
+void AddBinDbgListId (unsigned long Id)
+/* Add an id to the list started with StartBinDbgList */
+{
+    AppendWord (&BinSections[DBGBIN_IDLISTS], Id);
+}
+
+
+
 static void AssignIds (void)
 /* Assign the base ids for debug info output. Within each module, many of the
 ** items are addressed by ids which are actually the indices of the items in
@@ -101,9 +362,97 @@ static void AssignIds (void)
 
 
 
+static void CreateBinDbgFile (void)
+/* Create a binary debug info file */
+{
+    unsigned long Offs;
+    unsigned I, J;
+    FILE* F;
+
+    /* Both pools start with an empty item */
+    SB_AppendChar (&BinStrings, '\0');
+    AppendWord (&BinSections[DBGBIN_IDLISTS], 0);
+
+    /* Assign the ids to the items */
+    AssignIds ();
+
+    /* Collect the items */
+    WriteBinHLLDbgSyms ();
+    WriteBinDbgFileInfo ();
+    WriteBinDbgLibraries ();
+    WriteBinDbgLineInfo ();
+    WriteBinDbgModules ();
+    WriteBinDbgSegments ();
+    WriteBinDbgSpans ();
+    WriteBinDbgScopes ();
+    WriteBinDbgSyms ();
+    WriteBinDbgTypes ();
+
+    /* Create the indices */
+    CreateIndex (DBGBIN_FILE_BYNAME,  DBGBIN_FILE,  CompareFileByName);
+    CreateIndex (DBGBIN_LINE_BYLINE,  DBGBIN_LINE,  CompareLineByLine);
+    CreateIndex (DBGBIN_MOD_BYNAME,   DBGBIN_MOD,   CompareByName);
+    CreateIndex (DBGBIN_SCOPE_BYNAME, DBGBIN_SCOPE, CompareByName);
+    CreateIndex (DBGBIN_SEG_BYNAME,   DBGBIN_SEG,   CompareByName);
+    CreateIndex (DBGBIN_SPAN_BYADDR,  DBGBIN_SPAN,  CompareSpanByAddr);
+    CreateIndex (DBGBIN_SYM_BYNAME,   DBGBIN_SYM,   CompareByName);
+    CreateIndex (DBGBIN_SYM_BYVAL,    DBGBIN_SYM,   CompareSymByVal);
+
+    /* Open the debug info file */
+    F = fopen (DbgFileName, "wb");
+    if (F == 0) {
+        Error ("Cannot create debug file '%s': %s", DbgFileName, strerror (errno));
+    }
+
+    /* Write the header. The string pool follows immediately, the other
+    ** sections follow the string pool in the order of their numbers.
+    */
+    Write32 (F, DBGBIN_MAGIC);
+    Write32 (F, (DBGBIN_VER_MAJOR << 16) | DBGBIN_VER_MINOR);
+    Offs = DBGBIN_HEADER_SIZE;
+    for (I = 0; I < DBGBIN_SECTION_COUNT; ++I) {
+        Write32 (F, Offs);
+        if (I == DBGBIN_STRINGS) {
+            Write32 (F, SB_GetLen (&BinStrings));
+            Offs += (SB_GetLen (&BinStrings) + 3) & ~3UL;
+        } else {
+            Write32 (F, BinSections[I].Count / RecordWords[I]);
+            Offs += BinSections[I].Count * 4;
+        }
+    }
+
+    /* Write the string pool, padded to a word boundary */
+    WriteData (F, SB_GetConstBuf (&BinStrings), SB_GetLen (&BinStrings));
+    WriteMult (F, 0, (4 - (SB_GetLen (&BinStrings) & 3)) & 3);
+
+    /* Write the other sections */
+    for (I = DBGBIN_IDLISTS; I < DBGBIN_SECTION_COUNT; ++I) {
+        for (J = 0; J < BinSections[I].Count; ++J) {
+            Write32 (F, BinSections[I].Words[J]);
+        }
+        xfree (BinSections[I].Words);
+        BinSections[I].Words = 0;
+        BinSections[I].Count = BinSections[I].Size = 0;
+    }
+    SB_Done (&BinStrings);
+
+    /* Close the file */
+    if (fclose (F) != 0) {
+        Error ("Error closing debug file '%s': %s", DbgFileName, strerror (errno));
+    }
+}
+
+
+
 void CreateDbgFile (void)
 /* Create a debug info file */
 {
+    /* Handle binary debug info files separately */
+    if (BinDbgFile) {
+        CreateBinDbgFile ();
+        return;
+    }
+
     /* Open the debug info file */
     FILE* F = fopen (DbgFileName, "w");
     if (F == 0) {
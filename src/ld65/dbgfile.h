@@ -44,6 +44,25 @@
 
 
 
+void AddBinDbgRecord (unsigned Section, const unsigned long* Fields);
+/* Add a record to one of the item sections of a binary debug file. The
+** number of fields is determined by the section.
+*/
+
+unsigned long AddBinDbgString (const char* S);
+/* Add a string to the string pool of a binary debug file and return its
+** offset.
+*/
+
+unsigned long StartBinDbgList (unsigned Count);
+/* Start a list of ids with the given count in the id list pool of a binary
+** debug file. Count calls to AddBinDbgListId must follow. Return the offset
+** of the list, which is zero for an empty list.
+*/
+
+void AddBinDbgListId (unsigned long Id);
+/* Add an id to the list started with StartBinDbgList */
+
 void CreateDbgFile (void);
 /* Create a debug info file */
 
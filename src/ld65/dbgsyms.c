@@ -43,12 +43,17 @@
 #include "symdefs.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "dbgsyms.h"
 #include "error.h"
 #include "exports.h"
 #include "expr.h"
 #include "fileio.h"
+#include "gcsect.h"
 #include "global.h"
 #include "lineinfo.h"
 #include "objdata.h"
@@ -185,7 +190,7 @@ static void InsertDbgSym (DbgSym* D, long Val)
 
 
 
-DbgSym* ReadDbgSym (FILE* F, ObjData* O, unsigned Id)
+DbgSym* ReadDbgSym (InFile* F, ObjData* O, unsigned Id)
 /* Read a debug symbol from a file, insert and return it */
 {
     /* Read the type and address size */
@@ -236,7 +241,7 @@ DbgSym* ReadDbgSym (FILE* F, ObjData* O, unsigned Id)
 
 
 
-HLLDbgSym* ReadHLLDbgSym (FILE* F, ObjData* O, unsigned Id attribute ((unused)))
+HLLDbgSym* ReadHLLDbgSym (InFile* F, ObjData* O, unsigned Id attribute ((unused)))
 /* Read a hll debug symbol from a file, insert and return it */
 {
     unsigned SC;
@@ -310,6 +315,20 @@ static void PrintLineInfo (FILE* F, const Collection* LineInfos, const char* For
 
 
 
+static unsigned long WriteBinLineInfo (const Collection* LineInfos)
+/* Add a list of line infos to a binary debug file and return its offset */
+{
+    unsigned I;
+    unsigned long Offs = StartBinDbgList (CollCount (LineInfos));
+    for (I = 0; I < CollCount (LineInfos); ++I) {
+        const LineInfo* LI = CollConstAt (LineInfos, I);
+        AddBinDbgListId (LI->Id);
+    }
+    return Offs;
+}
+
+
+
 unsigned DbgSymCount (void)
 /* Return the total number of debug symbols */
 {
@@ -442,6 +461,77 @@ void PrintDbgSyms (FILE* F)
 
 
 
+void WriteBinDbgSyms (void)
+/* Add the debug symbols to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        /* Get the object file */
+        ObjData* O = CollAtUnchecked (&ObjDataList, I);
+
+        /* Walk through all debug symbols in this module */
+        for (J = 0; J < CollCount (&O->DbgSyms); ++J) {
+
+            unsigned long R[DBGBIN_SYM_WORDS];
+
+            /* Get the next debug symbol */
+            const DbgSym* S = CollConstAt (&O->DbgSyms, J);
+
+            /* Base data */
+            R[DBGBIN_SYM_NAME]   = AddBinDbgString (GetString (S->Name));
+            R[DBGBIN_SYM_SIZE]   = S->Size;
+            R[DBGBIN_SYM_VAL]    = 0;
+            R[DBGBIN_SYM_EXP]    = CC65_INV_ID;
+            R[DBGBIN_SYM_SEG]    = CC65_INV_ID;
+            R[DBGBIN_SYM_SCOPE]  = CC65_INV_ID;
+            R[DBGBIN_SYM_PARENT] = CC65_INV_ID;
+
+            /* Owner scope or owner symbol for cheap locals */
+            if (SYM_IS_STD (S->Type)) {
+                R[DBGBIN_SYM_SCOPE]  = O->ScopeBaseId + S->OwnerId;
+            } else {
+                R[DBGBIN_SYM_PARENT] = O->SymBaseId + S->OwnerId;
+            }
+
+            /* Line infos */
+            R[DBGBIN_SYM_DEF] = WriteBinLineInfo (&S->DefLines);
+            R[DBGBIN_SYM_REF] = WriteBinLineInfo (&S->RefLines);
+
+            /* Imports have the id of the matching export, other symbols
+            ** have a value and maybe a segment.
+            */
+            if (SYM_IS_IMPORT (S->Type)) {
+
+                /* Get the export from the import */
+                const Export* Exp = GetObjImport (O, S->ImportId)->Exp;
+
+                R[DBGBIN_SYM_TYPE] = CC65_SYM_IMPORT;
+                if (Exp->Obj && OBJ_HAS_DBGINFO (Exp->Obj->Header.Flags)) {
+                    R[DBGBIN_SYM_EXP] = Exp->Obj->SymBaseId + Exp->DbgSymId;
+                }
+
+            } else {
+
+                SegExprDesc D;
+
+                R[DBGBIN_SYM_TYPE] = SYM_IS_LABEL (S->Type)? CC65_SYM_LABEL : CC65_SYM_EQUATE;
+                R[DBGBIN_SYM_VAL]  = (unsigned long) GetDbgSymVal (S);
+
+                GetSegExprVal (S->Expr, &D);
+                if (!D.TooComplex && D.Seg != 0) {
+                    R[DBGBIN_SYM_SEG] = D.Seg->Id;
+                }
+            }
+
+            AddBinDbgRecord (DBGBIN_SYM, R);
+        }
+    }
+}
+
+
+
 void PrintHLLDbgSyms (FILE* F)
 /* Print the high level language debug symbols in a debug file */
 {
@@ -495,6 +585,53 @@ void PrintHLLDbgSyms (FILE* F)
 
 
 
+void WriteBinHLLDbgSyms (void)
+/* Add the high level language debug symbols to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        /* Get the object file */
+        ObjData* O = CollAtUnchecked (&ObjDataList, I);
+
+        /* Walk through all hll debug symbols in this module */
+        for (J = 0; J < CollCount (&O->HLLDbgSyms); ++J) {
+
+            unsigned long R[DBGBIN_CSYM_WORDS];
+
+            /* Get the next debug symbol */
+            const HLLDbgSym* S = CollConstAt (&O->HLLDbgSyms, J);
+
+            /* Get the storage class */
+            unsigned SC = HLL_GET_SC (S->Flags);
+
+            R[DBGBIN_CSYM_NAME]  = AddBinDbgString (GetString (S->Name));
+            R[DBGBIN_CSYM_OFFS]  = (unsigned long) (long) S->Offs;
+            R[DBGBIN_CSYM_TYPE]  = S->Type;
+            R[DBGBIN_CSYM_SCOPE] = O->ScopeBaseId + S->ScopeId;
+            switch (SC) {
+                case HLL_SC_AUTO:   R[DBGBIN_CSYM_SC] = CC65_CSYM_AUTO;     break;
+                case HLL_SC_REG:    R[DBGBIN_CSYM_SC] = CC65_CSYM_REG;      break;
+                case HLL_SC_STATIC: R[DBGBIN_CSYM_SC] = CC65_CSYM_STATIC;   break;
+                case HLL_SC_EXTERN: R[DBGBIN_CSYM_SC] = CC65_CSYM_EXTERN;   break;
+                default:
+                    Error ("Invalid storage class %u for hll symbol", SC);
+                    break;
+            }
+            if (HLL_HAS_SYM (S->Flags)) {
+                R[DBGBIN_CSYM_SYM] = O->SymBaseId + S->Sym->Id;
+            } else {
+                R[DBGBIN_CSYM_SYM] = CC65_INV_ID;
+            }
+
+            AddBinDbgRecord (DBGBIN_CSYM, R);
+        }
+    }
+}
+
+
+
 void PrintDbgSymLabels (FILE* F)
 /* Print the debug symbols in a VICE label file */
 {
@@ -522,6 +659,11 @@ void PrintDbgSymLabels (FILE* F)
                 continue;
             }
 
+            /* Skip labels in sections removed by --gc-sections */
+            if (GCSections && IsRemovedExpr (D->Expr)) {
+                continue;
+            }
+
             /* Get the symbol value */
             Val = GetDbgSymVal (D);
 
@@ -45,6 +45,7 @@
 #include "exprdefs.h"
 
 /* ld65 */
+#include "fileio.h"
 #include "objdata.h"
 
 
@@ -70,15 +71,18 @@ typedef struct DbgSym DbgSym;
 
 
 
-DbgSym* ReadDbgSym (FILE* F, ObjData* Obj, unsigned Id);
+DbgSym* ReadDbgSym (InFile* F, ObjData* Obj, unsigned Id);
 /* Read a debug symbol from a file, insert and return it */
 
-struct HLLDbgSym* ReadHLLDbgSym (FILE* F, ObjData* Obj, unsigned Id);
+struct HLLDbgSym* ReadHLLDbgSym (InFile* F, ObjData* Obj, unsigned Id);
 /* Read a hll debug symbol from a file, insert and return it */
 
 void PrintDbgSyms (FILE* F);
 /* Print the debug symbols in a debug file */
 
+void WriteBinDbgSyms (void);
+/* Add the debug symbols to a binary debug file */
+
 unsigned DbgSymCount (void);
 /* Return the total number of debug symbols */
 
@@ -88,6 +92,9 @@ unsigned HLLDbgSymCount (void);
 void PrintHLLDbgSyms (FILE* F);
 /* Print the high level language debug symbols in a debug file */
 
+void WriteBinHLLDbgSyms (void);
+/* Add the high level language debug symbols to a binary debug file */
+
 void PrintDbgSymLabels (FILE* F);
 /* Print the debug symbols in a VICE label file */
 
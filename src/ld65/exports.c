@@ -41,6 +41,7 @@
 #include "addrsize.h"
 #include "check.h"
 #include "hashfunc.h"
+#include "hashtab.h"
 #include "lidefs.h"
 #include "symdefs.h"
 #include "xmalloc.h"
@@ -51,6 +52,7 @@
 #include "exports.h"
 #include "expr.h"
 #include "fileio.h"
+#include "gcsect.h"
 #include "global.h"
 #include "lineinfo.h"
 #include "memarea.h"
@@ -59,16 +61,38 @@
 
 
 
+/*****************************************************************************/
+/*                                 Forwards                                  */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key);
+/* Generate the hash over a key. */
+
+static const void* HT_GetKey (const void* Entry);
+/* Given a pointer to the user entry data, return a pointer to the key */
+
+static int HT_Compare (const void* Key1, const void* Key2);
+/* Compare two keys. */
+
+
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
 
 
 
-/* Hash table */
-#define HASHTAB_MASK    0x0FFFU
-#define HASHTAB_SIZE    (HASHTAB_MASK + 1)
-static Export*          HashTab[HASHTAB_SIZE];
+/* Hash table functions */
+static const HashFunctions HashFunc = {
+    HT_GenHash,
+    HT_GetKey,
+    HT_Compare
+};
+
+/* Hash table with all exports, keyed by name */
+static HashTable        ExpTab = STATIC_HASHTABLE_INITIALIZER (4096, &HashFunc);
 
 /* Import management variables */
 static unsigned         ImpCount = 0;           /* Import count */
@@ -85,6 +109,49 @@ static Export**         ExpPool  = 0;           /* Exports array */
 #define EXP_INLIST      0x0001U                 /* Export is in exports list */
 #define EXP_USERMARK    0x0002U                 /* User setable flag */
 
+/* Data passed through HT_Walk by WalkExports */
+typedef struct WalkData WalkData;
+struct WalkData {
+    void        (*Func) (Export* E, void* Data);
+    void*       Data;
+};
+
+
+
+/*****************************************************************************/
+/*                           Hash table functions                            */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key)
+/* Generate the hash over a key. */
+{
+    /* The key is a string id, which is as good as a hash */
+    return *(const unsigned*) Key;
+}
+
+
+
+static const void* HT_GetKey (const void* Entry)
+/* Given a pointer to the user entry data, return a pointer to the key */
+{
+    return &((const Export*) Entry)->Name;
+}
+
+
+
+static int HT_Compare (const void* Key1, const void* Key2)
+/* Compare two keys. The function must return a value less than zero if
+** Key1 is smaller than Key2, zero if both are equal, and a value greater
+** than zero if Key1 is greater then Key2.
+*/
+{
+    unsigned K1 = *(const unsigned*) Key1;
+    unsigned K2 = *(const unsigned*) Key2;
+    return (K1 < K2)? -1 : (K1 > K2);
+}
+
 
 
 /*****************************************************************************/
@@ -140,7 +207,7 @@ void FreeImport (Import* I)
 
 
 
-Import* ReadImport (FILE* F, ObjData* Obj)
+Import* ReadImport (InFile* F, ObjData* Obj)
 /* Read an import from a file and return it */
 {
     Import* I;
@@ -213,36 +280,16 @@ Import* GenImport (unsigned Name, unsigned char AddrSize)
 Import* InsertImport (Import* I)
 /* Insert an import into the table, return I */
 {
-    Export* E;
-
     /* As long as the import is not inserted, V.Name is valid */
     unsigned Name = I->Name;
 
-    /* Create a hash value for the given name */
-    unsigned Hash = (Name & HASHTAB_MASK);
-
-    /* Search through the list in that slot for a symbol with that name */
-    if (HashTab[Hash] == 0) {
-        /* The slot is empty, we need to insert a dummy export */
-        E = HashTab[Hash] = NewExport (0, ADDR_SIZE_DEFAULT, Name, 0);
+    /* Search for a symbol with that name */
+    Export* E = HT_Find (&ExpTab, &Name);
+    if (E == 0) {
+        /* Not found, we need to insert a dummy export */
+        E = NewExport (0, ADDR_SIZE_DEFAULT, Name, 0);
+        HT_Insert (&ExpTab, E);
         ++ExpCount;
-    } else {
-        E = HashTab [Hash];
-        while (1) {
-            if (E->Name == Name) {
-                /* We have an entry, L points to it */
-                break;
-            }
-            if (E->Next == 0) {
-                /* End of list an entry not found, insert a dummy */
-                E->Next = NewExport (0, ADDR_SIZE_DEFAULT, Name, 0);
-                E = E->Next;            /* Point to dummy */
-                ++ExpCount;             /* One export more */
-                break;
-            } else {
-                E = E->Next;
-            }
-        }
     }
 
     /* Ok, E now points to a valid exports entry for the given import. Insert
@@ -296,8 +343,8 @@ static Export* NewExport (unsigned Type, unsigned char AddrSize,
     Export* E = xmalloc (sizeof (Export));
 
     /* Initialize the fields */
+    InitHashNode (&E->Node);
     E->Name      = Name;
-    E->Next      = 0;
     E->Flags     = 0;
     E->Obj       = Obj;
     E->ImpCount  = 0;
@@ -341,7 +388,7 @@ void FreeExport (Export* E)
 
 
 
-Export* ReadExport (FILE* F, ObjData* O)
+Export* ReadExport (InFile* F, ObjData* O)
 /* Read an export from a file */
 {
     unsigned    ConDesCount;
@@ -431,9 +478,7 @@ void InsertExport (Export* E)
 /* Insert an exported identifier and check if it's already in the list */
 {
     Export* L;
-    Export* Last;
     Import* Imp;
-    unsigned Hash;
 
     /* Mark the export as inserted */
     E->Flags |= EXP_INLIST;
@@ -443,59 +488,35 @@ void InsertExport (Export* E)
         ConDesAddExport (E);
     }
 
-    /* Create a hash value for the given name */
-    Hash = (E->Name & HASHTAB_MASK);
-
-    /* Search through the list in that slot */
-    if (HashTab[Hash] == 0) {
-        /* The slot is empty */
-        HashTab[Hash] = E;
+    /* Search for an export with the same name */
+    L = HT_Find (&ExpTab, &E->Name);
+    if (L == 0) {
+        /* Not there */
+        HT_Insert (&ExpTab, E);
         ++ExpCount;
-    } else {
+    } else if (L->Expr == 0) {
 
-        Last = 0;
-        L = HashTab[Hash];
-        do {
-            if (L->Name == E->Name) {
-                /* This may be an unresolved external */
-                if (L->Expr == 0) {
-
-                    /* This *is* an unresolved external. Use the actual export
-                    ** in E instead of the dummy one in L.
-                    */
-                    E->Next     = L->Next;
-                    E->ImpCount = L->ImpCount;
-                    E->ImpList  = L->ImpList;
-                    if (Last) {
-                        Last->Next = E;
-                    } else {
-                        HashTab[Hash] = E;
-                    }
-                    ImpOpen -= E->ImpCount;     /* Decrease open imports now */
-                    xfree (L);
-                    /* We must run through the import list and change the
-                    ** export pointer now.
-                    */
-                    Imp = E->ImpList;
-                    while (Imp) {
-                        Imp->Exp = E;
-                        Imp = Imp->Next;
-                    }
-                } else if (AllowMultDef == 0) {
-                    /* Duplicate entry, this is fatal unless allowed by the user */
-                    Error ("Duplicate external identifier: '%s'",
-                           GetString (L->Name));
-                }
-                return;
-            }
-            Last = L;
-            L = L->Next;
-
-        } while (L);
-
-        /* Insert export at end of queue */
-        Last->Next = E;
-        ++ExpCount;
+        /* This is an unresolved external. Use the actual export in E instead
+        ** of the dummy one in L.
+        */
+        E->ImpCount = L->ImpCount;
+        E->ImpList  = L->ImpList;
+        HT_Remove (&ExpTab, L);
+        HT_Insert (&ExpTab, E);
+        ImpOpen -= E->ImpCount;         /* Decrease open imports now */
+        xfree (L);
+        /* We must run through the import list and change the
+        ** export pointer now.
+        */
+        Imp = E->ImpList;
+        while (Imp) {
+            Imp->Exp = E;
+            Imp = Imp->Next;
+        }
+    } else if (AllowMultDef == 0) {
+        /* Duplicate entry, this is fatal unless allowed by the user */
+        Error ("Duplicate external identifier: '%s'",
+               GetString (L->Name));
     }
 }
 
@@ -609,19 +630,7 @@ Export* FindExport (unsigned Name)
 ** return a pointer to the export.
 */
 {
-    /* Get a pointer to the list with the symbols hash value */
-    Export* L = HashTab[Name & HASHTAB_MASK];
-    while (L) {
-        /* Search through the list in that slot */
-        if (L->Name == Name) {
-            /* Entry found */
-            return L;
-        }
-        L = L->Next;
-    }
-
-    /* Not found */
-    return 0;
+    return HT_Find (&ExpTab, &Name);
 }
 
 
@@ -803,10 +812,21 @@ static int CmpExpName (const void* K1, const void* K2)
 
 
 
+static int CollectExport (void* Entry, void* Data)
+/* Called from HT_Walk. Adds the export to the pool. */
+{
+    unsigned* J = Data;
+    CHECK (*J < ExpCount);
+    ExpPool[(*J)++] = Entry;
+    return 0;
+}
+
+
+
 static void CreateExportPool (void)
 /* Create an array with pointer to all exports */
 {
-    unsigned I, J;
+    unsigned J = 0;
 
     /* Allocate memory */
     if (ExpPool) {
@@ -814,15 +834,8 @@ static void CreateExportPool (void)
     }
     ExpPool = xmalloc (ExpCount * sizeof (Export*));
 
-    /* Walk through the list and insert the exports */
-    for (I = 0, J = 0; I < sizeof (HashTab) / sizeof (HashTab [0]); ++I) {
-        Export* E = HashTab[I];
-        while (E) {
-            CHECK (J < ExpCount);
-            ExpPool[J++] = E;
-            E = E->Next;
-        }
-    }
+    /* Walk through the table and insert the exports */
+    HT_Walk (&ExpTab, CollectExport, &J);
 
     /* Sort them by name */
     qsort (ExpPool, ExpCount, sizeof (Export*), CmpExpName);
@@ -875,6 +888,14 @@ static char GetAddrSizeCode (unsigned char AddrSize)
 
 
 
+static int IsRemovedExport (const Export* E)
+/* Return true if the export is a label in a section removed by --gc-sections */
+{
+    return GCSections && IsRemovedExpr (E->Expr);
+}
+
+
+
 void PrintExportMapByName (FILE* F)
 /* Print an export map, sorted by symbol name, to the given file */
 {
@@ -886,6 +907,11 @@ void PrintExportMapByName (FILE* F)
     for (I = 0; I < ExpCount; ++I) {
         const Export* E = ExpPool [I];
 
+        /* Skip symbols that are no longer part of the output */
+        if (IsRemovedExport (E)) {
+            continue;
+        }
+
         /* Print unreferenced symbols only if explictly requested */
         if (VerboseMap || E->ImpCount > 0 || SYM_IS_CONDES (E->Type)) {
             fprintf (F,
@@ -940,6 +966,11 @@ void PrintExportMapByValue (FILE* F)
     for (I = 0; I < ExpCount; ++I) {
         const Export* E = ExpPool [ExpValXlat [I]];
 
+        /* Skip symbols that are no longer part of the output */
+        if (IsRemovedExport (E)) {
+            continue;
+        }
+
         /* Print unreferenced symbols only if explictly requested */
         if (VerboseMap || E->ImpCount > 0 || SYM_IS_CONDES (E->Type)) {
             fprintf (F,
@@ -1024,12 +1055,36 @@ void PrintExportLabels (FILE* F)
     /* Print all exports */
     for (I = 0; I < ExpCount; ++I) {
         const Export* E = ExpPool [I];
+        if (IsRemovedExport (E)) {
+            continue;
+        }
         fprintf (F, "al %06lX .%s\n", GetExportVal (E), GetString (E->Name));
     }
 }
 
 
 
+static int WalkExport (void* Entry, void* Data)
+/* Called from HT_Walk. Passes the export to the function in WalkData. */
+{
+    WalkData* W = Data;
+    W->Func (Entry, W->Data);
+    return 0;
+}
+
+
+
+void WalkExports (void (*Func) (Export* E, void* Data), void* Data)
+/* Call Func for all exports in the table */
+{
+    WalkData W;
+    W.Func = Func;
+    W.Data = Data;
+    HT_Walk (&ExpTab, WalkExport, &W);
+}
+
+
+
 void MarkExport (Export* E)
 /* Mark the export */
 {
@@ -44,9 +44,11 @@
 #include "cddefs.h"
 #include "coll.h"
 #include "exprdefs.h"
+#include "hashtab.h"
 
 /* ld65 */
 #include "config.h"
+#include "fileio.h"
 #include "lineinfo.h"
 #include "memarea.h"
 #include "objdata.h"
@@ -77,8 +79,8 @@ struct Import {
 /* Export symbol structure */
 typedef struct Export Export;
 struct Export {
+    HashNode            Node;           /* Node in the hash table */
     unsigned            Name;           /* Name */
-    Export*             Next;           /* Hash table link */
     unsigned            Flags;          /* Generic flags */
     ObjData*            Obj;            /* Object file that exports the name */
     unsigned            ImpCount;       /* How many imports for this symbol? */
@@ -117,7 +119,7 @@ void FreeImport (Import* I);
 ** aren't referenced).
 */
 
-Import* ReadImport (FILE* F, ObjData* Obj);
+Import* ReadImport (InFile* F, ObjData* Obj);
 /* Read an import from a file and insert it into the table */
 
 Import* GenImport (unsigned Name, unsigned char AddrSize);
@@ -135,7 +137,7 @@ void FreeExport (Export* E);
 ** aren't referenced).
 */
 
-Export* ReadExport (FILE* F, ObjData* Obj);
+Export* ReadExport (InFile* F, ObjData* Obj);
 /* Read an export from a file */
 
 void InsertExport (Export* E);
@@ -198,6 +200,9 @@ void PrintImportMap (FILE* F);
 void PrintExportLabels (FILE* F);
 /* Print the exports in a VICE label file */
 
+void WalkExports (void (*Func) (Export* E, void* Data), void* Data);
+/* Call Func for all exports in the table */
+
 void MarkExport (Export* E);
 /* Mark the export */
 
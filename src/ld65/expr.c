@@ -48,6 +48,17 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Pool for expression nodes */
+static MemPool ExprNodePool = STATIC_MEMPOOL_INITIALIZER ("ExprNode", sizeof (ExprNode));
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
@@ -57,8 +68,8 @@
 ExprNode* NewExprNode (ObjData* O, unsigned char Op)
 /* Create a new expression node */
 {
-    /* Allocate fresh memory */
-    ExprNode* N = xmalloc (sizeof (ExprNode));
+    /* Allocate memory */
+    ExprNode* N = PoolAlloc (&ExprNodePool);
     N->Op       = Op;
     N->Left     = 0;
     N->Right    = 0;
@@ -73,8 +84,8 @@ ExprNode* NewExprNode (ObjData* O, unsigned char Op)
 static void FreeExprNode (ExprNode* E)
 /* Free a node */
 {
-    /* Free the memory */
-    xfree (E);
+    /* Return the node to the pool */
+    PoolFree (&ExprNodePool, E);
 }
 
 
@@ -622,7 +633,7 @@ ExprNode* SectionExpr (Section* Sec, long Offs, ObjData* O)
 
 
 
-ExprNode* ReadExpr (FILE* F, ObjData* O)
+ExprNode* ReadExpr (InFile* F, ObjData* O)
 /* Read an expression from the given file */
 {
     ExprNode* Expr;
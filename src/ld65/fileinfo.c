@@ -37,7 +37,11 @@
 #include "coll.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "fileio.h"
 #include "fileinfo.h"
 #include "objdata.h"
@@ -133,7 +137,7 @@ static void FreeFileInfo (FileInfo* FI)
 
 
 
-FileInfo* ReadFileInfo (FILE* F, ObjData* O)
+FileInfo* ReadFileInfo (InFile* F, ObjData* O)
 /* Read a file info from a file and return it */
 {
     FileInfo* FI;
@@ -261,3 +265,32 @@ void PrintDbgFileInfo (FILE* F)
         fputc ('\n', F);
     }
 }
+
+
+
+void WriteBinDbgFileInfo (void)
+/* Add the file info to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&FileInfos); ++I) {
+
+        unsigned long R[DBGBIN_FILE_WORDS];
+
+        /* Get the file info */
+        const FileInfo* FI = CollAtUnchecked (&FileInfos, I);
+
+        R[DBGBIN_FILE_NAME]  = AddBinDbgString (GetString (FI->Name));
+        R[DBGBIN_FILE_SIZE]  = FI->Size;
+        R[DBGBIN_FILE_MTIME] = FI->MTime;
+
+        /* Modules that use the file */
+        R[DBGBIN_FILE_MODS]  = StartBinDbgList (CollCount (&FI->Modules));
+        for (J = 0; J < CollCount (&FI->Modules); ++J) {
+            const ObjData* O = CollConstAt (&FI->Modules, J);
+            AddBinDbgListId (O->Id);
+        }
+
+        AddBinDbgRecord (DBGBIN_FILE, R);
+    }
+}
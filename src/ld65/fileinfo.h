@@ -45,6 +45,7 @@
 #include "filepos.h"
 
 /* ld65 */
+#include "fileio.h"
 #include "objdata.h"
 
 
@@ -72,7 +73,7 @@ struct FileInfo {
 
 
 
-FileInfo* ReadFileInfo (FILE* F, ObjData* O);
+FileInfo* ReadFileInfo (InFile* F, ObjData* O);
 /* Read a file info from a file and return it */
 
 unsigned FileInfoCount (void);
@@ -84,6 +85,9 @@ void AssignFileInfoIds (void);
 void PrintDbgFileInfo (FILE* F);
 /* Output the file info to a debug info file */
 
+void WriteBinDbgFileInfo (void);
+/* Add the file info to a binary debug file */
+
 
 
 /* End of fileinfo.h */
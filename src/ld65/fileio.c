@@ -34,9 +34,9 @@
 
 
 #include <string.h>
-#include <errno.h>
 
 /* common */
+#include "filemap.h"
 #include "xmalloc.h"
 
 /* ld65 */
@@ -52,24 +52,80 @@
 
 
 
-void FileSetPos (FILE* F, unsigned long Pos)
+InFile* OpenInFile (const char* Name)
+/* Open an input file. Return NULL on errors, errno is set in this case. */
+{
+    InFile* F;
+
+    /* Make the file contents available */
+    MappedFile* Map = MapFile (Name);
+    if (Map == 0) {
+        return 0;
+    }
+
+    /* Create the file structure */
+    F = xmalloc (sizeof (InFile));
+    F->Map  = Map;
+    F->Pos  = 0;
+    F->Name = xstrdup (Name);
+    return F;
+}
+
+
+
+void CloseInFile (InFile* F)
+/* Close an input file. The caller must make sure that no data is referenced
+** in place.
+*/
+{
+    UnmapFile (F->Map);
+    xfree (F->Name);
+    xfree (F);
+}
+
+
+
+void FileSetPos (InFile* F, unsigned long Pos)
 /* Seek to the given absolute position, fail on errors */
 {
-    if (fseek (F, Pos, SEEK_SET) != 0) {
-        Error ("Cannot seek: %s", strerror (errno));
+    if (Pos > F->Map->Size) {
+        Error ("Cannot seek to position %lu in '%s' (file corrupt?)",
+               Pos, F->Name);
     }
+    F->Pos = Pos;
+}
+
+
+
+unsigned long FileGetPos (InFile* F)
+/* Return the current file position */
+{
+    return F->Pos;
 }
 
 
 
-unsigned long FileGetPos (FILE* F)
-/* Return the current file position, fail on errors */
+static void ReadError (const InFile* F)
+/* Bail out because of a read beyond the end of the file */
 {
-    long Pos = ftell (F);
-    if (Pos < 0) {
-        Error ("Error in ftell: %s", strerror (errno));
+    Error ("Read error in '%s' at position %lu (file corrupt?)",
+           F->Name, F->Pos);
+}
+
+
+
+static const unsigned char* CheckRead (InFile* F, unsigned long Size)
+/* Check that Size bytes can be read, advance the position and return a
+** pointer to the data.
+*/
+{
+    const unsigned char* Data;
+    if (Size > F->Map->Size - F->Pos) {
+        ReadError (F);
     }
-    return Pos;
+    Data = F->Map->Data + F->Pos;
+    F->Pos += Size;
+    return Data;
 }
 
 
@@ -193,50 +249,46 @@ void WriteMult (FILE* F, unsigned char Val, unsigned long Count)
 
 
 
-unsigned Read8 (FILE* F)
+unsigned Read8 (InFile* F)
 /* Read an 8 bit value from the file */
 {
-    int C = getc (F);
-    if (C == EOF) {
-        long Pos = ftell (F);
-        Error ("Read error at position %ld (file corrupt?)", Pos);
+    if (F->Pos >= F->Map->Size) {
+        ReadError (F);
     }
-    return C;
+    return F->Map->Data[F->Pos++];
 }
 
 
 
-unsigned Read16 (FILE* F)
+unsigned Read16 (InFile* F)
 /* Read a 16 bit value from the file */
 {
-    unsigned Lo = Read8 (F);
-    unsigned Hi = Read8 (F);
-    return (Hi << 8) | Lo;
+    const unsigned char* D = CheckRead (F, 2);
+    return D[0] | (D[1] << 8);
 }
 
 
 
-unsigned long Read24 (FILE* F)
+unsigned long Read24 (InFile* F)
 /* Read a 24 bit value from the file */
 {
-    unsigned long Lo = Read16 (F);
-    unsigned long Hi = Read8 (F);
-    return (Hi << 16) | Lo;
+    const unsigned char* D = CheckRead (F, 3);
+    return D[0] | (D[1] << 8) | ((unsigned long) D[2] << 16);
 }
 
 
 
-unsigned long Read32 (FILE* F)
+unsigned long Read32 (InFile* F)
 /* Read a 32 bit value from the file */
 {
-    unsigned long Lo = Read16 (F);
-    unsigned long Hi = Read16 (F);
-    return (Hi << 16) | Lo;
+    const unsigned char* D = CheckRead (F, 4);
+    return D[0] | (D[1] << 8) | ((unsigned long) D[2] << 16) |
+           ((unsigned long) D[3] << 24);
 }
 
 
 
-long Read32Signed (FILE* F)
+long Read32Signed (InFile* F)
 /* Read a 32 bit value from the file. Sign extend the value. */
 {
     /* Read a 32 bit value */
@@ -254,18 +306,24 @@ long Read32Signed (FILE* F)
 
 
 
-unsigned long ReadVar (FILE* F)
+unsigned long ReadVar (InFile* F)
 /* Read a variable size value from the file */
 {
     /* The value was written to the file in 7 bit chunks LSB first. If there
     ** are more bytes, bit 8 is set, otherwise it is clear.
     */
+    const unsigned char* Data = F->Map->Data;
+    unsigned long Pos = F->Pos;
     unsigned char C;
     unsigned long V = 0;
     unsigned Shift = 0;
     do {
         /* Read one byte */
-        C = Read8 (F);
+        if (Pos >= F->Map->Size) {
+            F->Pos = Pos;
+            ReadError (F);
+        }
+        C = Data[Pos++];
         /* Encode it into the target value */
         V |= ((unsigned long)(C & 0x7F)) << Shift;
         /* Next value */
@@ -273,42 +331,35 @@ unsigned long ReadVar (FILE* F)
     } while (C & 0x80);
 
     /* Return the value read */
+    F->Pos = Pos;
     return V;
 }
 
 
 
-unsigned ReadStr (FILE* F)
+unsigned ReadStr (InFile* F)
 /* Read a string from the file, place it into the global string pool, and
 ** return its string id.
 */
 {
-    unsigned    Id;
     StrBuf      Buf = STATIC_STRBUF_INITIALIZER;
 
     /* Read the length */
     unsigned Len = ReadVar (F);
 
-    /* Expand the string buffer memory */
-    SB_Realloc (&Buf, Len);
-
-    /* Read the string */
-    ReadData (F, SB_GetBuf (&Buf), Len);
+    /* Let the buffer point to the string in the file. Adding it to the pool
+    ** will copy it.
+    */
+    Buf.Buf = (char*) CheckRead (F, Len);
     Buf.Len = Len;
 
-    /* Insert it into the string pool and remember the id */
-    Id = GetStrBufId (&Buf);
-
-    /* Free the memory buffer */
-    SB_Done (&Buf);
-
-    /* Return the string id */
-    return Id;
+    /* Insert it into the string pool and return the id */
+    return GetStrBufId (&Buf);
 }
 
 
 
-FilePos* ReadFilePos (FILE* F, FilePos* Pos)
+FilePos* ReadFilePos (InFile* F, FilePos* Pos)
 /* Read a file position from the file */
 {
     /* Read the data fields */
@@ -320,15 +371,22 @@ FilePos* ReadFilePos (FILE* F, FilePos* Pos)
 
 
 
-void* ReadData (FILE* F, void* Data, unsigned Size)
+void* ReadData (InFile* F, void* Data, unsigned Size)
 /* Read data from the file */
 {
     /* Explicitly allow reading zero bytes */
     if (Size > 0) {
-        if (fread (Data, 1, Size, F) != Size) {
-            long Pos = ftell (F);
-            Error ("Read error at position %ld (file corrupt?)", Pos);
-        }
+        memcpy (Data, CheckRead (F, Size), Size);
     }
     return Data;
 }
+
+
+
+const unsigned char* ReadInPlace (InFile* F, unsigned Size)
+/* Skip Size bytes of the file and return a pointer to them. The data stays
+** valid until the file is closed.
+*/
+{
+    return CheckRead (F, Size);
+}
@@ -41,21 +41,48 @@
 #include <stdio.h>
 
 /* common */
+#include "filemap.h"
 #include "filepos.h"
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* An input file. The complete file is held in memory, and data read from it
+** may be referenced in place as long as the file isn't closed.
+*/
+typedef struct InFile InFile;
+struct InFile {
+    MappedFile*     Map;        /* File contents */
+    unsigned long   Pos;        /* Current read position */
+    char*           Name;       /* Name of the file for error messages */
+};
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
 
 
 
-void FileSetPos (FILE* F, unsigned long Pos);
+InFile* OpenInFile (const char* Name);
+/* Open an input file. Return NULL on errors, errno is set in this case. */
+
+void CloseInFile (InFile* F);
+/* Close an input file. The caller must make sure that no data is referenced
+** in place.
+*/
+
+void FileSetPos (InFile* F, unsigned long Pos);
 /* Seek to the given absolute position, fail on errors */
 
-unsigned long FileGetPos (FILE* F);
-/* Return the current file position, fail on errors */
+unsigned long FileGetPos (InFile* F);
+/* Return the current file position */
 
 void Write8 (FILE* F, unsigned Val);
 /* Write an 8 bit value to the file */
@@ -84,35 +111,40 @@ void WriteData (FILE* F, const void* Data, unsigned Size);
 void WriteMult (FILE* F, unsigned char Val, unsigned long Count);
 /* Write one byte several times to the file */
 
-unsigned Read8 (FILE* F);
+unsigned Read8 (InFile* F);
 /* Read an 8 bit value from the file */
 
-unsigned Read16 (FILE* F);
+unsigned Read16 (InFile* F);
 /* Read a 16 bit value from the file */
 
-unsigned long Read24 (FILE* F);
+unsigned long Read24 (InFile* F);
 /* Read a 24 bit value from the file */
 
-unsigned long Read32 (FILE* F);
+unsigned long Read32 (InFile* F);
 /* Read a 32 bit value from the file */
 
-long Read32Signed (FILE* F);
+long Read32Signed (InFile* F);
 /* Read a 32 bit value from the file. Sign extend the value. */
 
-unsigned long ReadVar (FILE* F);
+unsigned long ReadVar (InFile* F);
 /* Read a variable size value from the file */
 
-unsigned ReadStr (FILE* F);
+unsigned ReadStr (InFile* F);
 /* Read a string from the file, place it into the global string pool, and
 ** return its string id.
 */
 
-FilePos* ReadFilePos (FILE* F, FilePos* Pos);
+FilePos* ReadFilePos (InFile* F, FilePos* Pos);
 /* Read a file position from the file */
 
-void* ReadData (FILE* F, void* Data, unsigned Size);
+void* ReadData (InFile* F, void* Data, unsigned Size);
 /* Read data from the file */
 
+const unsigned char* ReadInPlace (InFile* F, unsigned Size);
+/* Skip Size bytes of the file and return a pointer to them. The data stays
+** valid until the file is closed.
+*/
+
 
 
 /* End of fileio.h */
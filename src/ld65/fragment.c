@@ -45,6 +45,17 @@
 
 
 
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Fragments are never freed, so a pool is cheaper than xmalloc */
+static MemPool FragmentPool = STATIC_MEMPOOL_INITIALIZER ("Fragment", sizeof (Fragment));
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
@@ -54,18 +65,8 @@
 Fragment* NewFragment (unsigned char Type, unsigned Size, Section* S)
 /* Create a new fragment and insert it into the section S */
 {
-    Fragment* F;
-
-    /* Calculate the size of the memory block. LitBuf is only needed if the
-    ** fragment contains literal data.
-    */
-    unsigned FragSize = sizeof (Fragment) - 1;
-    if (Type == FRAG_LITERAL) {
-        FragSize += Size;
-    }
-
     /* Allocate memory */
-    F = xmalloc (FragSize);
+    Fragment* F = PoolAlloc (&FragmentPool);
 
     /* Initialize the data */
     F->Next      = 0;
@@ -74,6 +75,7 @@ Fragment* NewFragment (unsigned char Type, unsigned Size, Section* S)
     F->Size      = Size;
     F->Expr      = 0;
     F->LineInfos = EmptyCollection;
+    F->LitBuf    = 0;
     F->Type      = Type;
 
     /* Insert the code fragment into the section */
@@ -0,0 +1,265 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  gcsect.c                                 */
+/*                                                                           */
+/*                         Removal of unused sections                        */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+
+/* common */
+#include "attrib.h"
+#include "coll.h"
+#include "exprdefs.h"
+#include "fragdefs.h"
+#include "segdefs.h"
+
+/* ld65 */
+#include "asserts.h"
+#include "config.h"
+#include "exports.h"
+#include "fragment.h"
+#include "gcsect.h"
+#include "library.h"
+#include "objdata.h"
+#include "segments.h"
+#include "spool.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Sections that are reachable but haven't been scanned so far */
+static Collection WorkList = STATIC_COLLECTION_INITIALIZER;
+
+/* Exports marked while following references */
+static Collection Marked = STATIC_COLLECTION_INITIALIZER;
+
+/* Sections removed, for the map file */
+static Collection Removed = STATIC_COLLECTION_INITIALIZER;
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static void KeepSection (Section* S)
+/* Keep a candidate section that is referenced and schedule it for scanning */
+{
+    if (S->Removed) {
+        S->Removed = 0;
+        CollAppend (&WorkList, S);
+    }
+}
+
+
+
+static void MarkExpr (ExprNode* Expr)
+/* Keep all sections referenced by the given expression, either directly or
+** through the expressions of the exports used.
+*/
+{
+    while (Expr) {
+        switch (Expr->Op) {
+
+            case EXPR_SYMBOL:
+                {
+                    Export* E = GetExprExport (Expr);
+                    if (E && !ExportHasMark (E)) {
+                        MarkExport (E);
+                        CollAppend (&Marked, E);
+                        MarkExpr (E->Expr);
+                    }
+                }
+                return;
+
+            case EXPR_SECTION:
+                KeepSection (GetExprSection (Expr));
+                return;
+
+            default:
+                /* Leaf nodes have no children, so this ends the loop */
+                MarkExpr (Expr->Left);
+                Expr = Expr->Right;
+                break;
+        }
+    }
+}
+
+
+
+static void MarkExportRoot (Export* E, void* Data attribute ((unused)))
+/* Keep everything referenced by exports that are used outside of the object
+** files: Exports generated by the linker or defined in the config, exports
+** imported by the config or the command line, and o65 exports.
+*/
+{
+    int IsRoot = (E->Obj == 0 || CfgKeepSymbol (E->Name));
+    const Import* Imp = E->ImpList;
+    while (!IsRoot && Imp) {
+        IsRoot = (Imp->Obj == 0);
+        Imp = Imp->Next;
+    }
+    if (IsRoot && !ExportHasMark (E)) {
+        MarkExport (E);
+        CollAppend (&Marked, E);
+        MarkExpr (E->Expr);
+    }
+}
+
+
+
+static void ScheduleRoot (Section* S, void* Data attribute ((unused)))
+/* Schedule all sections that are not candidates for removal for scanning */
+{
+    if (!S->Removed) {
+        CollAppend (&WorkList, S);
+    }
+}
+
+
+
+void RemoveUnusedSections (void)
+/* Remove all sub-sections that cannot be reached from the sections that must
+** be kept. Must be called after the condes tables are created and before
+** the segments are placed.
+*/
+{
+    unsigned I, J;
+
+    /* Sub-sections are candidates for removal unless the config file says
+    ** otherwise. Everything else is kept.
+    */
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+        const ObjData* O = CollConstAt (&ObjDataList, I);
+        for (J = 0; J < CollCount (&O->Sections); ++J) {
+            Section* S = CollAtUnchecked (&O->Sections, J);
+            S->Removed = (S->Flags & SEG_FLAG_SUBSEC) != 0 &&
+                         !CfgKeepSegment (S->Seg->Name);
+        }
+    }
+
+    /* Collect the roots */
+    WalkSections (ScheduleRoot, 0);
+    WalkExports (MarkExportRoot, 0);
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+        const ObjData* O = CollConstAt (&ObjDataList, I);
+        for (J = 0; J < CollCount (&O->Assertions); ++J) {
+            MarkExpr (GetAssertionExpr (CollConstAt (&O->Assertions, J)));
+        }
+    }
+
+    /* Follow the references in the fragments of all reachable sections */
+    while (CollCount (&WorkList) > 0) {
+        const Section* S = CollPop (&WorkList);
+        const Fragment* F = S->FragRoot;
+        while (F) {
+            if (F->Type == FRAG_EXPR || F->Type == FRAG_SEXPR) {
+                MarkExpr (F->Expr);
+            }
+            F = F->Next;
+        }
+    }
+
+    /* Remove the marks from the exports */
+    for (I = 0; I < CollCount (&Marked); ++I) {
+        UnmarkExport (CollAtUnchecked (&Marked, I));
+    }
+    DoneCollection (&Marked);
+
+    /* Remember the sections that weren't reached */
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+        const ObjData* O = CollConstAt (&ObjDataList, I);
+        for (J = 0; J < CollCount (&O->Sections); ++J) {
+            Section* S = CollAtUnchecked (&O->Sections, J);
+            if (S->Removed) {
+                CollAppend (&Removed, S);
+            }
+        }
+    }
+
+    /* Take them out of the segments */
+    SegRemoveSections ();
+}
+
+
+
+int IsRemovedExpr (ExprNode* Expr)
+/* Return true if the given expression refers to a removed section */
+{
+    while (Expr) {
+        if (Expr->Op == EXPR_SECTION) {
+            return GetExprSection (Expr)->Removed;
+        } else if (Expr->Op == EXPR_SYMBOL) {
+            return 0;
+        } else if (IsRemovedExpr (Expr->Left)) {
+            return 1;
+        }
+        Expr = Expr->Right;
+    }
+    return 0;
+}
+
+
+
+void PrintRemovedSections (FILE* F)
+/* Print the list of removed sections to the map file */
+{
+    unsigned I;
+    unsigned long Total = 0;
+    const ObjData* Last = 0;
+
+    for (I = 0; I < CollCount (&Removed); ++I) {
+
+        const Section* S = CollConstAt (&Removed, I);
+
+        /* Output the module name if it changed */
+        if (S->Obj != Last) {
+            Last = S->Obj;
+            if (Last->Lib) {
+                fprintf (F, "%s(%s):\n",
+                         GetLibFileName (Last->Lib), GetObjFileName (Last));
+            } else {
+                fprintf (F, "%s:\n", GetObjFileName (Last));
+            }
+        }
+        fprintf (F, "    %-17s Size=%06lX  %s\n", GetString (S->Seg->Name),
+                 S->Size, GetString (S->SubName));
+        Total += S->Size;
+    }
+    fprintf (F, "Total: %u section(s), %lu bytes\n", CollCount (&Removed), Total);
+}
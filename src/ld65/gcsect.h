@@ -0,0 +1,69 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  gcsect.h                                 */
+/*                                                                           */
+/*                         Removal of unused sections                        */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef GCSECT_H
+#define GCSECT_H
+
+
+
+#include <stdio.h>
+
+/* ld65 */
+#include "expr.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void RemoveUnusedSections (void);
+/* Remove all sub-sections that cannot be reached from the sections that must
+** be kept. Must be called after the condes tables are created and before
+** the segments are placed.
+*/
+
+int IsRemovedExpr (ExprNode* Expr);
+/* Return true if the given expression refers to a removed section */
+
+void PrintRemovedSections (FILE* F);
+/* Print the list of removed sections to the map file */
+
+
+
+/* End of gcsect.h */
+
+#endif
@@ -55,10 +55,12 @@ extern unsigned long    StartAddr;      /* Start address */
 extern unsigned char    VerboseMap;     /* Verbose map file */
 extern unsigned char    AllowMultDef;   /* Allow multiple definitions */
 extern unsigned char    LargeAlignment; /* Don't warn about large alignments */
+extern unsigned char    GCSections;     /* Remove unused sections */
 
 extern const char*      MapFileName;    /* Name of the map file */
 extern const char*      LabelFileName;  /* Name of the label file */
 extern const char*      DbgFileName;    /* Name of the debug file */
+extern unsigned char    BinDbgFile;     /* Write a binary debug file */
 
 
 
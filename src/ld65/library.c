@@ -34,18 +34,21 @@
 
 
 #include <stdio.h>
-#include <string.h>
-#include <errno.h>
 
 /* common */
 #include "coll.h"
 #include "exprdefs.h"
+#include "hashtab.h"
 #include "libdefs.h"
 #include "objdefs.h"
 #include "symdefs.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "error.h"
 #include "exports.h"
 #include "fileio.h"
@@ -62,14 +65,33 @@
 
 
 
+/* An entry in the export index of a library */
+typedef struct LibExport LibExport;
+struct LibExport {
+    HashNode    Node;           /* Node in the hash table */
+    unsigned    Name;           /* Name of the export */
+    unsigned    Pos;            /* Position of the module in the sweep */
+    ObjData*    Obj;            /* Module that exports the name */
+    LibExport*  Next;           /* Next module in the library with this export */
+};
+
 /* Library data structure */
 typedef struct Library Library;
 struct Library {
     unsigned    Id;             /* Id of library */
     unsigned    Name;           /* String id of the name */
-    FILE*       F;              /* Open file stream */
+    InFile*     F;              /* Library file */
     LibHeader   Header;         /* Library header */
     Collection  Modules;        /* Modules */
+    HashTable   ExportIndex;    /* Modules by exported name */
+    LibExport*  IndexEntries;   /* Memory for the index entries */
+};
+
+/* A pending visit of a module while resolving */
+typedef struct Visit Visit;
+struct Visit {
+    unsigned long   Time;       /* Step of the sweep that visits the module */
+    ObjData*        Obj;        /* Module to visit */
 };
 
 /* List of open libraries */
@@ -81,6 +103,57 @@ static Collection LibraryList = STATIC_COLLECTION_INITIALIZER;
 /* Flag for library grouping */
 static int Grouping = 0;
 
+/* Hash table functions for the export index */
+static unsigned HT_GenHash (const void* Key);
+static const void* HT_GetKey (const void* Entry);
+static int HT_Compare (const void* Key1, const void* Key2);
+static const HashFunctions IndexFunctions = {
+    HT_GenHash,
+    HT_GetKey,
+    HT_Compare
+};
+
+/* Pending visits while resolving, a heap ordered by time */
+static Visit*   Visits;
+static unsigned VisitCount;
+static unsigned VisitMax;
+
+
+
+/*****************************************************************************/
+/*                              Hash table functions                         */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key)
+/* Generate the hash over a key. */
+{
+    /* The key is a string id, which is as good as a hash */
+    return *(const unsigned*) Key;
+}
+
+
+
+static const void* HT_GetKey (const void* Entry)
+/* Given a pointer to the user entry data, return a pointer to the key */
+{
+    return &((const LibExport*) Entry)->Name;
+}
+
+
+
+static int HT_Compare (const void* Key1, const void* Key2)
+/* Compare two keys. The function must return a value less than zero if
+** Key1 is smaller than Key2, zero if both are equal, and a value greater
+** than zero if Key1 is greater then Key2.
+*/
+{
+    unsigned K1 = *(const unsigned*) Key1;
+    unsigned K2 = *(const unsigned*) Key2;
+    return (K1 < K2)? -1 : (K1 > K2);
+}
+
 
 
 /*****************************************************************************/
@@ -89,7 +162,7 @@ static int Grouping = 0;
 
 
 
-static Library* NewLibrary (FILE* F, const char* Name)
+static Library* NewLibrary (InFile* F, const char* Name)
 /* Create a new Library structure and return it */
 {
     /* Allocate memory */
@@ -100,6 +173,8 @@ static Library* NewLibrary (FILE* F, const char* Name)
     L->Name     = GetStringId (Name);
     L->F        = F;
     L->Modules  = EmptyCollection;
+    InitHashTable (&L->ExportIndex, 1, &IndexFunctions);
+    L->IndexEntries = 0;
 
     /* Return the new struct */
     return L;
@@ -108,23 +183,34 @@ static Library* NewLibrary (FILE* F, const char* Name)
 
 
 static void CloseLibrary (Library* L)
-/* Close a library file and remove the list of modules */
+/* Close a library file. No data from the file may be referenced. */
 {
-    /* Close the library file */
-    if (fclose (L->F) != 0) {
-        Error ("Error closing '%s': %s", GetString (L->Name), strerror (errno));
-    }
+    CloseInFile (L->F);
     L->F = 0;
 }
 
 
 
+static void FreeExportIndex (Library* L)
+/* Free the export index of a library */
+{
+    DoneHashTable (&L->ExportIndex);
+    InitHashTable (&L->ExportIndex, 1, &IndexFunctions);
+    xfree (L->IndexEntries);
+    L->IndexEntries = 0;
+}
+
+
+
 static void FreeLibrary (Library* L)
 /* Free a library structure */
 {
     /* Close the library */
     CloseLibrary (L);
 
+    /* Free the export index */
+    FreeExportIndex (L);
+
     /* Free the module index */
     DoneCollection (&L->Modules);
 
@@ -143,10 +229,7 @@ static void FreeLibrary (Library* L)
 static void LibSeek (Library* L, unsigned long Offs)
 /* Do a seek in the library checking for errors */
 {
-    if (fseek (L->F, Offs, SEEK_SET) != 0) {
-        Error ("Seek error in '%s' (%lu): %s",
-               GetString (L->Name), Offs, strerror (errno));
-    }
+    FileSetPos (L->F, Offs);
 }
 
 
@@ -157,7 +240,7 @@ static void LibReadHeader (Library* L)
     /* Read the remaining header fields (magic is already read) */
     L->Header.Magic   = LIB_MAGIC;
     L->Header.Version = Read16 (L->F);
-    if (L->Header.Version != LIB_VERSION) {
+    if (L->Header.Version < LIB_VERSION_MIN || L->Header.Version > LIB_VERSION) {
         Error ("Wrong data version in '%s'", GetString (L->Name));
     }
     L->Header.Flags   = Read16 (L->F);
@@ -257,6 +340,53 @@ static void ReadBasicData (Library* L, ObjData* O)
 
 
 
+static void BuildExportIndex (Library* L)
+/* Build the index that maps exported names to the modules of the library */
+{
+    unsigned Count, I, J;
+    LibExport* E;
+
+    /* Count the exports */
+    Count = 0;
+    for (I = 0; I < CollCount (&L->Modules); ++I) {
+        const ObjData* O = CollConstAt (&L->Modules, I);
+        Count += CollCount (&O->Exports);
+    }
+    if (Count == 0) {
+        return;
+    }
+
+    /* Allocate memory for all entries and size the table accordingly */
+    E = L->IndexEntries = xmalloc (Count * sizeof (LibExport));
+    InitHashTable (&L->ExportIndex, Count, &IndexFunctions);
+
+    /* Add the exports. If more than one module exports a name, the modules
+    ** are chained in the order they appear in the library.
+    */
+    for (I = 0; I < CollCount (&L->Modules); ++I) {
+        ObjData* O = CollAtUnchecked (&L->Modules, I);
+        for (J = 0; J < CollCount (&O->Exports); ++J, ++E) {
+            LibExport* Prev;
+            E->Name = ((const Export*) CollConstAt (&O->Exports, J))->Name;
+            E->Pos  = I;
+            E->Obj  = O;
+            E->Next = 0;
+            InitHashNode (&E->Node);
+            Prev = HT_Find (&L->ExportIndex, &E->Name);
+            if (Prev == 0) {
+                HT_Insert (&L->ExportIndex, E);
+            } else {
+                while (Prev->Next) {
+                    Prev = Prev->Next;
+                }
+                Prev->Next = E;
+            }
+        }
+    }
+}
+
+
+
 static void LibReadIndex (Library* L)
 /* Read the index of a library file */
 {
@@ -280,6 +410,9 @@ static void LibReadIndex (Library* L)
     for (I = 0; I < CollCount (&L->Modules); ++I) {
         ReadBasicData (L, CollAtUnchecked (&L->Modules, I));
     }
+
+    /* Build the export index */
+    BuildExportIndex (L);
 }
 
 
@@ -311,7 +444,7 @@ static void LibCheckExports (ObjData* O)
 
 
 
-static void LibOpen (FILE* F, const char* Name)
+static void LibOpen (InFile* F, const char* Name)
 /* Open the library for use */
 {
     /* Create a new library structure */
@@ -329,46 +462,146 @@ static void LibOpen (FILE* F, const char* Name)
 
 
 
-static void LibResolve (void)
-/* Resolve all externals from the list of all currently open libraries */
+static void PushVisit (unsigned long Time, ObjData* O)
+/* Add a pending visit of a module */
 {
-    unsigned I, J;
-    unsigned Additions;
+    unsigned I;
 
-    /* Walk repeatedly over all open libraries until there's nothing more
-    ** to add.
-    */
-    do {
+    /* Grow the heap if needed */
+    if (VisitCount == VisitMax) {
+        VisitMax = (VisitMax == 0)? 64 : VisitMax * 2;
+        Visits = xrealloc (Visits, VisitMax * sizeof (Visit));
+    }
+
+    /* Sift up */
+    I = VisitCount++;
+    while (I > 0) {
+        unsigned Parent = (I - 1) / 2;
+        if (Visits[Parent].Time <= Time) {
+            break;
+        }
+        Visits[I] = Visits[Parent];
+        I = Parent;
+    }
+    Visits[I].Time = Time;
+    Visits[I].Obj  = O;
+}
+
+
+
+static Visit PopVisit (void)
+/* Remove the earliest pending visit from the heap and return it */
+{
+    Visit First = Visits[0];
+    Visit Last  = Visits[--VisitCount];
+    unsigned I  = 0;
+
+    /* Sift down */
+    while (1) {
+        unsigned Child = I * 2 + 1;
+        if (Child >= VisitCount) {
+            break;
+        }
+        if (Child + 1 < VisitCount && Visits[Child+1].Time < Visits[Child].Time) {
+            ++Child;
+        }
+        if (Last.Time <= Visits[Child].Time) {
+            break;
+        }
+        Visits[I] = Visits[Child];
+        I = Child;
+    }
+    Visits[I] = Last;
+
+    return First;
+}
+
+
+
+static void ScheduleExporters (unsigned Name, unsigned long Cursor, unsigned Total)
+/* Schedule a visit for all modules not yet added that export Name. Modules
+** are numbered in the order of the open libraries. Each module is visited
+** at the first step >= Cursor of a sweep over all Total modules.
+*/
+{
+    unsigned I;
+    unsigned Base = 0;
+
+    for (I = 0; I < CollCount (&OpenLibs); ++I) {
+        const Library* L = CollConstAt (&OpenLibs, I);
+        const LibExport* E = HT_Find (&L->ExportIndex, &Name);
+        while (E) {
+            if ((E->Obj->Flags & OBJ_REF) == 0) {
+                unsigned long Time = Cursor - Cursor % Total + Base + E->Pos;
+                if (Time < Cursor) {
+                    Time += Total;
+                }
+                PushVisit (Time, E->Obj);
+            }
+            E = E->Next;
+        }
+        Base += CollCount (&L->Modules);
+    }
+}
 
-        Additions = 0;
 
-        /* Walk over all libraries */
-        for (I = 0; I < CollCount (&OpenLibs); ++I) {
 
-            /* Get the next library */
-            Library* L = CollAt (&OpenLibs, I);
+static void LibResolve (void)
+/* Resolve all externals from the list of all currently open libraries */
+{
+    unsigned I, J;
+    unsigned Total;
+
+    /* Adding a module may create new unresolved externals, which may in turn
+    ** be resolved by modules that were checked before. The linker did always
+    ** walk over all modules of all open libraries until nothing more was
+    ** added, and the module order in the output depends on this. Instead of
+    ** sweeping, we use the export index to find the modules that may resolve
+    ** a symbol and visit them in exactly the order a sweep would, so the
+    ** result is the same.
+    **
+    ** Since a module is needed only if it resolves an open import, the first
+    ** sweep must visit all modules that have exports.
+    */
+    Total = 0;
+    for (I = 0; I < CollCount (&OpenLibs); ++I) {
+        const Library* L = CollConstAt (&OpenLibs, I);
+        for (J = 0; J < CollCount (&L->Modules); ++J) {
+            ObjData* O = CollAtUnchecked (&L->Modules, J);
+            if (CollCount (&O->Exports) > 0) {
+                PushVisit (Total + J, O);
+            }
+        }
+        Total += CollCount (&L->Modules);
+    }
 
-            /* Walk through all modules in this library and check for each
-            ** module if there are unresolved externals in existing modules
-            ** that may be resolved by adding the module.
-            */
-            for (J = 0; J < CollCount (&L->Modules); ++J) {
+    /* Visit modules until no more are pending */
+    while (VisitCount > 0) {
 
-                /* Get the next module */
-                ObjData* O = CollAtUnchecked (&L->Modules, J);
+        Visit V = PopVisit ();
+        ObjData* O = V.Obj;
 
-                /* We only need to check this module if it wasn't added before */
-                if ((O->Flags & OBJ_REF) == 0) {
-                    LibCheckExports (O);
-                    if (O->Flags & OBJ_REF) {
-                        /* The routine added the file */
-                        ++Additions;
+        /* We only need to check this module if it wasn't added before */
+        if ((O->Flags & OBJ_REF) == 0) {
+            LibCheckExports (O);
+            if (O->Flags & OBJ_REF) {
+                /* The module was added. Its imports may need modules from
+                ** the libraries.
+                */
+                for (I = 0; I < CollCount (&O->Imports); ++I) {
+                    const Import* Imp = CollConstAt (&O->Imports, I);
+                    if (IsUnresolvedExport (Imp->Exp)) {
+                        ScheduleExporters (Imp->Exp->Name, V.Time + 1, Total);
                     }
                 }
             }
         }
+    }
 
-    } while (Additions > 0);
+    /* The export index isn't needed any longer */
+    for (I = 0; I < CollCount (&OpenLibs); ++I) {
+        FreeExportIndex (CollAt (&OpenLibs, I));
+    }
 
     /* We do know now which modules must be added, so we can load the data
     ** for these modues into memory. Since we're walking over all modules
@@ -432,10 +665,11 @@ static void LibResolve (void)
         }
 
         /* If we have referenced modules in this library, assign it an id
-        ** (which is the index in the library collection) and keep it.
+        ** (which is the index in the library collection) and keep it. The
+        ** library file is kept open, since the fragments of the modules
+        ** reference its data.
         */
         if (CollCount (&L->Modules) > 0) {
-            CloseLibrary (L);
             L->Id = CollCount (&LibraryList);
             CollAppend (&LibraryList, L);
         } else {
@@ -451,7 +685,7 @@ static void LibResolve (void)
 
 
 
-void LibAdd (FILE* F, const char* Name)
+void LibAdd (InFile* F, const char* Name)
 /* Add files from the library to the list if there are references that could
 ** be satisfied.
 */
@@ -553,3 +787,17 @@ void PrintDbgLibraries (FILE* F)
         fprintf (F, "lib\tid=%u,name=\"%s\"\n", L->Id, GetString (L->Name));
     }
 }
+
+
+
+void WriteBinDbgLibraries (void)
+/* Add the libraries to a binary debug file */
+{
+    unsigned I;
+    for (I = 0; I < CollCount (&LibraryList); ++I) {
+        const Library* L = CollAtUnchecked (&LibraryList, I);
+        unsigned long R[DBGBIN_LIB_WORDS];
+        R[DBGBIN_LIB_NAME] = AddBinDbgString (GetString (L->Name));
+        AddBinDbgRecord (DBGBIN_LIB, R);
+    }
+}
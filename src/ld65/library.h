@@ -47,6 +47,9 @@
 /* Opaque structure */
 struct Library;
 
+/* Forwards */
+struct InFile;
+
 
 
 /*****************************************************************************/
@@ -55,7 +58,7 @@ struct Library;
 
 
 
-void LibAdd (FILE* F, const char* Name);
+void LibAdd (struct InFile* F, const char* Name);
 /* Add files from the library to the list if there are references that could
 ** be satisfied.
 */
@@ -87,6 +90,9 @@ unsigned LibraryCount (void);
 void PrintDbgLibraries (FILE* F);
 /* Output the libraries to a debug info file */
 
+void WriteBinDbgLibraries (void);
+/* Add the libraries to a binary debug file */
+
 
 
 /* End of library.h */
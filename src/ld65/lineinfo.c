@@ -38,13 +38,18 @@
 #include "lidefs.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "error.h"
 #include "fileinfo.h"
 #include "fileio.h"
 #include "lineinfo.h"
 #include "objdata.h"
 #include "segments.h"
+#include "span.h"
 
 
 
@@ -121,7 +126,7 @@ LineInfo* GenLineInfo (const FilePos* Pos)
 
 
 
-LineInfo* ReadLineInfo (FILE* F, ObjData* O)
+LineInfo* ReadLineInfo (InFile* F, ObjData* O)
 /* Read a line info from a file and return it */
 {
     /* Create a new LineInfo struct */
@@ -141,7 +146,7 @@ LineInfo* ReadLineInfo (FILE* F, ObjData* O)
 
 
 
-void ReadLineInfoList (FILE* F, ObjData* O, Collection* LineInfos)
+void ReadLineInfoList (InFile* F, ObjData* O, Collection* LineInfos)
 /* Read a list of line infos stored as a list of indices in the object file,
 ** make real line infos from them and place them into the passed collection.
 */
@@ -284,3 +289,33 @@ void PrintDbgLineInfo (FILE* F)
         }
     }
 }
+
+
+
+void WriteBinDbgLineInfo (void)
+/* Add the line infos to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        /* Get the object file */
+        const ObjData* O = CollAtUnchecked (&ObjDataList, I);
+
+        for (J = 0; J < CollCount (&O->LineInfos); ++J) {
+
+            unsigned long R[DBGBIN_LINE_WORDS];
+
+            /* Get this line info */
+            const LineInfo* LI = CollConstAt (&O->LineInfos, J);
+
+            R[DBGBIN_LINE_FILE]  = LI->File->Id;
+            R[DBGBIN_LINE_LINE]  = GetSourceLine (LI);
+            R[DBGBIN_LINE_TYPE]  = LI_GET_TYPE (LI->Type);
+            R[DBGBIN_LINE_COUNT] = LI_GET_COUNT (LI->Type);
+            R[DBGBIN_LINE_SPANS] = WriteBinDbgSpanList (O, LI->Spans);
+
+            AddBinDbgRecord (DBGBIN_LINE, R);
+        }
+    }
+}
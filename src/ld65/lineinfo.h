@@ -56,6 +56,7 @@
 
 
 
+struct InFile;
 struct ObjData;
 struct Segment;
 
@@ -91,7 +92,7 @@ struct LineInfo {
 LineInfo* GenLineInfo (const FilePos* Pos);
 /* Generate a new (internally used) line info with the given information */
 
-LineInfo* ReadLineInfo (FILE* F, struct ObjData* O);
+LineInfo* ReadLineInfo (struct InFile* F, struct ObjData* O);
 /* Read a line info from a file and return it */
 
 void FreeLineInfo (LineInfo* LI);
@@ -100,7 +101,7 @@ void FreeLineInfo (LineInfo* LI);
 LineInfo* DupLineInfo (const LineInfo* LI);
 /* Creates a duplicate of a line info structure */
 
-void ReadLineInfoList (FILE* F, struct ObjData* O, Collection* LineInfos);
+void ReadLineInfoList (struct InFile* F, struct ObjData* O, Collection* LineInfos);
 /* Read a list of line infos stored as a list of indices in the object file,
 ** make real line infos from them and place them into the passed collection.
 */
@@ -183,6 +184,9 @@ void AssignLineInfoIds (void);
 void PrintDbgLineInfo (FILE* F);
 /* Output the line infos to a debug info file */
 
+void WriteBinDbgLineInfo (void);
+/* Add the line infos to a binary debug file */
+
 
 
 /* End of lineinfo.h */
@@ -60,6 +60,7 @@
 #include "exports.h"
 #include "fileio.h"
 #include "filepath.h"
+#include "gcsect.h"
 #include "global.h"
 #include "library.h"
 #include "mapfile.h"
@@ -132,14 +133,17 @@ static void Usage (void)
             "  --cfg-path path\t\tSpecify a config file search path\n"
             "  --config name\t\t\tUse linker config file\n"
             "  --dbgfile name\t\tGenerate debug information\n"
+            "  --dbgfile-format fmt\t\tDebug file format (text or binary)\n"
             "  --define sym=val\t\tDefine a symbol\n"
             "  --end-group\t\t\tEnd a library group\n"
             "  --force-import sym\t\tForce an import of symbol 'sym'\n"
+            "  --gc-sections\t\t\tRemove unused sub-sections\n"
             "  --help\t\t\tHelp (this text)\n"
             "  --large-alignment\t\tDon't warn about large alignments\n"
             "  --lib file\t\t\tLink this library\n"
             "  --lib-path path\t\tSpecify a library search path\n"
             "  --mapfile name\t\tCreate a map file\n"
+            "  --mem-stats\t\t\tPrint memory statistics\n"
             "  --module-id id\t\tSpecify a module id\n"
             "  --obj file\t\t\tLink this object file\n"
             "  --obj-path path\t\tSpecify an object file search path\n"
@@ -183,7 +187,7 @@ static void LinkFile (const char* Name, FILETYPE Type)
 /* Handle one file */
 {
     char*         PathName;
-    FILE*         F;
+    InFile*       F;
     unsigned long Magic;
 
 
@@ -220,7 +224,7 @@ static void LinkFile (const char* Name, FILETYPE Type)
     }
 
     /* Try to open the file */
-    F = fopen (PathName, "rb");
+    F = OpenInFile (PathName);
     if (F == 0) {
         Error ("Cannot open '%s': %s", PathName, strerror (errno));
     }
@@ -247,7 +251,7 @@ static void LinkFile (const char* Name, FILETYPE Type)
             break;
 
         default:
-            fclose (F);
+            CloseInFile (F);
             Error ("File '%s' has unknown type", PathName);
 
     }
@@ -342,6 +346,20 @@ static void OptDbgFile (const char* Opt attribute ((unused)), const char* Arg)
 
 
 
+static void OptDbgFileFormat (const char* Opt attribute ((unused)), const char* Arg)
+/* Set the format of the debug file */
+{
+    if (strcmp (Arg, "text") == 0) {
+        BinDbgFile = 0;
+    } else if (strcmp (Arg, "binary") == 0) {
+        BinDbgFile = 1;
+    } else {
+        Error ("Invalid debug file format: '%s'", Arg);
+    }
+}
+
+
+
 static void OptDefine (const char* Opt attribute ((unused)), const char* Arg)
 /* Define a symbol on the command line */
 {
@@ -397,6 +415,15 @@ static void OptForceImport (const char* Opt attribute ((unused)), const char* Ar
 
 
 
+static void OptGCSections (const char* Opt attribute ((unused)),
+                           const char* Arg attribute ((unused)))
+/* Remove unused sections */
+{
+    GCSections = 1;
+}
+
+
+
 static void OptHelp (const char* Opt attribute ((unused)),
                      const char* Arg attribute ((unused)))
 /* Print usage information and exit */
@@ -445,6 +472,15 @@ static void OptMapFile (const char* Opt attribute ((unused)), const char* Arg)
 
 
 
+static void OptMemStats (const char* Opt attribute ((unused)),
+                        const char* Arg attribute ((unused)))
+/* Print memory statistics when done */
+{
+    MemStats = 1;
+}
+
+
+
 static void OptModuleId (const char* Opt, const char* Arg)
 /* Specify a module id */
 {
@@ -622,14 +658,17 @@ static void ParseCommandLine(void)
         { "--cfg-path",                  1,      OptCfgPath              },
         { "--config",                    1,      CmdlOptConfig           },
         { "--dbgfile",                   1,      OptDbgFile              },
+        { "--dbgfile-format",            1,      OptDbgFileFormat        },
         { "--define",                    1,      OptDefine               },
         { "--end-group",                 0,      CmdlOptEndGroup         },
         { "--force-import",              1,      OptForceImport          },
+        { "--gc-sections",               0,      OptGCSections           },
         { "--help",                      0,      OptHelp                 },
         { "--large-alignment",           0,      OptLargeAlignment       },
         { "--lib",                       1,      OptLib                  },
         { "--lib-path",                  1,      OptLibPath              },
         { "--mapfile",                   1,      OptMapFile              },
+        { "--mem-stats",                 0,      OptMemStats             },
         { "--module-id",                 1,      OptModuleId             },
         { "--obj",                       1,      OptObj                  },
         { "--obj-path",                  1,      OptObjPath              },
@@ -821,6 +860,11 @@ int main (int argc, char* argv [])
     /* Create the condes tables if requested */
     ConDesCreate ();
 
+    /* Remove sections not referenced from anywhere if requested */
+    if (GCSections) {
+        RemoveUnusedSections ();
+    }
+
     /* Process data from the config file. Assign start addresses for the
     ** segments, define linker symbols. The function will return the number
     ** of memory area overflows (zero on success).
@@ -868,6 +912,11 @@ int main (int argc, char* argv [])
         ConDesDump ();
     }
 
+    /* Print memory statistics if requested */
+    if (MemStats) {
+        PrintMemStats (stdout);
+    }
+
     /* Return an apropriate exit code */
     return EXIT_SUCCESS;
 }
@@ -41,6 +41,7 @@
 #include "config.h"
 #include "dbgsyms.h"
 #include "exports.h"
+#include "gcsect.h"
 #include "global.h"
 #include "error.h"
 #include "library.h"
@@ -89,6 +90,10 @@ void CreateMapFile (int ShortMap)
         }
         for (J = 0; J < CollCount (&O->Sections); ++J) {
             const Section* S = CollConstAt (&O->Sections, J);
+            /* Removed sections are listed separately below */
+            if (S->Removed) {
+                continue;
+            }
             /* Don't include zero sized sections if not explicitly
             ** requested
             */
@@ -102,6 +107,14 @@ void CreateMapFile (int ShortMap)
         }
     }
 
+    /* Write the list of sections removed by --gc-sections */
+    if (GCSections) {
+        fprintf (F, "\n\n"
+                    "Removed sections:\n"
+                    "-----------------\n");
+        PrintRemovedSections (F);
+    }
+
     /* Write the segment list */
     fprintf (F, "\n\n"
                 "Segment list:\n"
@@ -39,7 +39,11 @@
 #include "check.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "error.h"
 #include "exports.h"
 #include "fileinfo.h"
@@ -309,3 +313,28 @@ void PrintDbgModules (FILE* F)
     }
 
 }
+
+
+
+void WriteBinDbgModules (void)
+/* Add the modules to a binary debug file */
+{
+    unsigned I;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        unsigned long R[DBGBIN_MOD_WORDS];
+
+        /* Get this object file */
+        const ObjData* O = CollConstAt (&ObjDataList, I);
+
+        /* The main source file is the one at index zero */
+        const FileInfo* Source = CollConstAt (&O->Files, 0);
+
+        R[DBGBIN_MOD_NAME] = AddBinDbgString (GetObjFileName (O));
+        R[DBGBIN_MOD_FILE] = Source->Id;
+        R[DBGBIN_MOD_LIB]  = O->Lib? GetLibId (O->Lib) : CC65_INV_ID;
+
+        AddBinDbgRecord (DBGBIN_MOD, R);
+    }
+}
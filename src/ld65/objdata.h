@@ -170,6 +170,9 @@ unsigned ObjDataCount (void);
 void PrintDbgModules (FILE* F);
 /* Output the modules to a debug info file */
 
+void WriteBinDbgModules (void);
+/* Add the modules to a binary debug file */
+
 
 
 /* End of objdata.h */
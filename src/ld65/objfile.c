@@ -74,7 +74,7 @@ static unsigned GetModule (const char* Name)
 
 
 
-static void ObjReadHeader (FILE* Obj, ObjHeader* H, const char* Name)
+static void ObjReadHeader (InFile* Obj, ObjHeader* H, const char* Name)
 /* Read the header of the object file checking the signature */
 {
     H->Version    = Read16 (Obj);
@@ -109,7 +109,7 @@ static void ObjReadHeader (FILE* Obj, ObjHeader* H, const char* Name)
 
 
 
-void ObjReadFiles (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadFiles (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the files list from a file at the given position */
 {
     unsigned I;
@@ -128,7 +128,7 @@ void ObjReadFiles (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadSections (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadSections (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the section data from a file at the given position */
 {
     unsigned I;
@@ -147,7 +147,7 @@ void ObjReadSections (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadImports (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadImports (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the imports from a file at the given position */
 {
     unsigned I;
@@ -166,7 +166,7 @@ void ObjReadImports (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadExports (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadExports (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the exports from a file at the given position */
 {
     unsigned I;
@@ -185,7 +185,7 @@ void ObjReadExports (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadDbgSyms (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadDbgSyms (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the debug symbols from a file at the given position */
 {
     unsigned I;
@@ -211,7 +211,7 @@ void ObjReadDbgSyms (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadLineInfos (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadLineInfos (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the line infos from a file at the given position */
 {
     unsigned I;
@@ -230,7 +230,7 @@ void ObjReadLineInfos (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadStrPool (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadStrPool (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the string pool from a file at the given position */
 {
     unsigned I;
@@ -248,7 +248,7 @@ void ObjReadStrPool (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadAssertions (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadAssertions (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the assertions from a file at the given offset */
 {
     unsigned I;
@@ -267,7 +267,7 @@ void ObjReadAssertions (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadScopes (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadScopes (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the scope table from a file at the given offset */
 {
     unsigned I;
@@ -286,7 +286,7 @@ void ObjReadScopes (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjReadSpans (FILE* F, unsigned long Pos, ObjData* O)
+void ObjReadSpans (InFile* F, unsigned long Pos, ObjData* O)
 /* Read the span table from a file at the given offset */
 {
     unsigned I;
@@ -305,7 +305,7 @@ void ObjReadSpans (FILE* F, unsigned long Pos, ObjData* O)
 
 
 
-void ObjAdd (FILE* Obj, const char* Name)
+void ObjAdd (InFile* Obj, const char* Name)
 /* Add an object file to the module list */
 {
     /* Create a new structure for the object file data */
@@ -358,8 +358,7 @@ void ObjAdd (FILE* Obj, const char* Name)
     /* Mark this object file as needed */
     O->Flags |= OBJ_REF;
 
-    /* Done, close the file (we read it only, so no error check) */
-    fclose (Obj);
+    /* The file isn't closed, since the fragments reference its data */
 
     /* Insert the imports and exports to the global lists */
     InsertObjGlobals (O);
@@ -44,6 +44,7 @@
 #include "objdefs.h"
 
 /* ld65 */
+#include "fileio.h"
 #include "objdata.h"
 
 
@@ -54,37 +55,37 @@
 
 
 
-void ObjReadFiles (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadFiles (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the files list from a file at the given position */
 
-void ObjReadSections (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadSections (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the section data from a file at the given position */
 
-void ObjReadImports (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadImports (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the imports from a file at the given position */
 
-void ObjReadExports (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadExports (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the exports from a file at the given position */
 
-void ObjReadDbgSyms (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadDbgSyms (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the debug symbols from a file at the given position */
 
-void ObjReadLineInfos (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadLineInfos (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the line infos from a file at the given position */
 
-void ObjReadStrPool (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadStrPool (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the string pool from a file at the given position */
 
-void ObjReadAssertions (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadAssertions (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the assertions from a file at the given offset */
 
-void ObjReadScopes (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadScopes (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the scope table from a file at the given offset */
 
-void ObjReadSpans (FILE* F, unsigned long Pos, ObjData* O);
+void ObjReadSpans (InFile* F, unsigned long Pos, ObjData* O);
 /* Read the span table from a file at the given offset */
 
-void ObjAdd (FILE* F, const char* Name);
+void ObjAdd (InFile* F, const char* Name);
 /* Add an object file to the module list */
 
 
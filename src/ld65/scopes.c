@@ -36,7 +36,11 @@
 /* common */
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "error.h"
 #include "fileio.h"
 #include "scopes.h"
@@ -70,7 +74,7 @@ static Scope* NewScope (ObjData* Obj, unsigned Id)
 
 
 
-Scope* ReadScope (FILE* F, ObjData* Obj, unsigned Id)
+Scope* ReadScope (InFile* F, ObjData* Obj, unsigned Id)
 /* Read a scope from a file and return it */
 {
     /* Create a new scope */
@@ -171,3 +175,50 @@ void PrintDbgScopes (FILE* F)
         }
     }
 }
+
+
+
+void WriteBinDbgScopes (void)
+/* Add the scopes to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        /* Get the object file */
+        ObjData* O = CollAtUnchecked (&ObjDataList, I);
+
+        for (J = 0; J < CollCount (&O->Scopes); ++J) {
+
+            unsigned long R[DBGBIN_SCOPE_WORDS];
+            const Scope* S = CollConstAt (&O->Scopes, J);
+
+            R[DBGBIN_SCOPE_NAME] = AddBinDbgString (GetString (S->Name));
+            R[DBGBIN_SCOPE_SIZE] = S->Size;
+            R[DBGBIN_SCOPE_MOD]  = I;
+            switch (S->Type) {
+                case SCOPE_GLOBAL:  R[DBGBIN_SCOPE_TYPE] = CC65_SCOPE_GLOBAL;   break;
+                case SCOPE_FILE:    R[DBGBIN_SCOPE_TYPE] = CC65_SCOPE_MODULE;   break;
+                case SCOPE_SCOPE:   R[DBGBIN_SCOPE_TYPE] = CC65_SCOPE_SCOPE;    break;
+                case SCOPE_STRUCT:  R[DBGBIN_SCOPE_TYPE] = CC65_SCOPE_STRUCT;   break;
+                case SCOPE_ENUM:    R[DBGBIN_SCOPE_TYPE] = CC65_SCOPE_ENUM;     break;
+                default:
+                    Error ("Module '%s': Unknown scope type %u",
+                           GetObjFileName (O), S->Type);
+            }
+            if (S->Id != S->ParentId) {
+                R[DBGBIN_SCOPE_PARENT] = O->ScopeBaseId + S->ParentId;
+            } else {
+                R[DBGBIN_SCOPE_PARENT] = CC65_INV_ID;
+            }
+            if (SCOPE_HAS_LABEL (S->Flags)) {
+                R[DBGBIN_SCOPE_SYM] = O->SymBaseId + S->LabelId;
+            } else {
+                R[DBGBIN_SCOPE_SYM] = CC65_INV_ID;
+            }
+            R[DBGBIN_SCOPE_SPANS] = WriteBinDbgSpanList (O, S->Spans);
+
+            AddBinDbgRecord (DBGBIN_SCOPE, R);
+        }
+    }
+}
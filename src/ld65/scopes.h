@@ -45,6 +45,7 @@
 #include "scopedefs.h"
 
 /* ld65 */
+#include "fileio.h"
 #include "objdata.h"
 
 
@@ -78,7 +79,7 @@ struct Scope {
 
 
 
-Scope* ReadScope (FILE* F, ObjData* Obj, unsigned Id);
+Scope* ReadScope (InFile* F, ObjData* Obj, unsigned Id);
 /* Read a scope from a file, insert and return it */
 
 unsigned ScopeCount (void);
@@ -87,6 +88,9 @@ unsigned ScopeCount (void);
 void PrintDbgScopes (FILE* F);
 /* Output the scopes to a debug info file */
 
+void WriteBinDbgScopes (void);
+/* Add the scopes to a binary debug file */
+
 
 
 /* End of scopes.h */
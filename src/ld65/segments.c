@@ -49,7 +49,11 @@
 #include "symdefs.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "error.h"
 #include "expr.h"
 #include "fileio.h"
@@ -169,7 +173,10 @@ Section* NewSection (Segment* Seg, unsigned long Alignment, unsigned char AddrSi
     S->FragLast = 0;
     S->Size     = 0;
     S->Alignment= Alignment;
+    S->Flags    = 0;
+    S->SubName  = INVALID_STRING_ID;
     S->AddrSize = AddrSize;
+    S->Removed  = 0;
 
     /* Calculate the alignment bytes needed for the section */
     S->Fill = AlignCount (Seg->Size, S->Alignment);
@@ -187,10 +194,12 @@ Section* NewSection (Segment* Seg, unsigned long Alignment, unsigned char AddrSi
 
 
 
-Section* ReadSection (FILE* F, ObjData* O)
+Section* ReadSection (InFile* F, ObjData* O)
 /* Read a section from a file */
 {
     unsigned      Name;
+    unsigned      Flags;
+    unsigned      SubName;
     unsigned      Size;
     unsigned long Alignment;
     unsigned char Type;
@@ -201,7 +210,11 @@ Section* ReadSection (FILE* F, ObjData* O)
     /* Read the segment data */
     (void) Read32 (F);          /* File size of data */
     Name      = MakeGlobalStringId (O, ReadVar (F));    /* Segment name */
-                ReadVar (F);    /* Segment flags (currently unused) */
+    Flags     = ReadVar (F);    /* Segment flags */
+    SubName   = INVALID_STRING_ID;
+    if (Flags & SEG_FLAG_SUBSEC) {
+        SubName = MakeGlobalStringId (O, ReadVar (F));  /* Sub-section name */
+    }
     Size      = ReadVar (F);    /* Size of data */
     Alignment = ReadVar (F);    /* Alignment */
     Type      = Read8 (F);      /* Segment type */
@@ -220,7 +233,9 @@ Section* ReadSection (FILE* F, ObjData* O)
     Sec = NewSection (S, Alignment, Type);
 
     /* Remember the object file this section was from */
-    Sec->Obj = O;
+    Sec->Obj     = O;
+    Sec->Flags   = Flags;
+    Sec->SubName = SubName;
 
     /* Set up the combined segment alignment */
     if (Sec->Alignment > 1) {
@@ -254,8 +269,9 @@ Section* ReadSection (FILE* F, ObjData* O)
         switch (Type) {
 
             case FRAG_LITERAL:
+                /* The data is not copied but referenced in the file */
                 Frag = NewFragment (Type, ReadVar (F), Sec);
-                ReadData (F, Frag->LitBuf, Frag->Size);
+                Frag->LitBuf = ReadInPlace (F, Frag->Size);
                 break;
 
             case FRAG_EXPR:
@@ -322,7 +338,7 @@ int IsBSSType (Segment* S)
         Fragment* F = Sec->FragRoot;
         while (F) {
             if (F->Type == FRAG_LITERAL) {
-                unsigned char* Data = F->LitBuf;
+                const unsigned char* Data = F->LitBuf;
                 unsigned long Count = F->Size;
                 while (Count--) {
                     if (*Data++ != 0) {
@@ -347,7 +363,7 @@ void SegDump (void)
 {
     unsigned I, J;
     unsigned long Count;
-    unsigned char* Data;
+    const unsigned char* Data;
 
     for (I = 0; I < CollCount (&SegmentList); ++I) {
         Segment* Seg = CollAtUnchecked (&SegmentList, I);
@@ -545,6 +561,60 @@ void SegWrite (const char* TgtName, FILE* Tgt, Segment* S, SegWriteFunc F, void*
 
 
 
+void WalkSections (void (*Func) (Section* S, void* Data), void* Data)
+/* Call Func for all sections in all segments */
+{
+    unsigned I, J;
+    for (I = 0; I < CollCount (&SegmentList); ++I) {
+        Segment* Seg = CollAtUnchecked (&SegmentList, I);
+        for (J = 0; J < CollCount (&Seg->Sections); ++J) {
+            Func (CollAtUnchecked (&Seg->Sections, J), Data);
+        }
+    }
+}
+
+
+
+void SegRemoveSections (void)
+/* Remove all sections flagged as removed from their segments and recalculate
+** the section offsets and segment sizes.
+*/
+{
+    unsigned I, J, K;
+
+    for (I = 0; I < CollCount (&SegmentList); ++I) {
+
+        Segment* Seg = CollAtUnchecked (&SegmentList, I);
+
+        /* Lay out the remaining sections again, starting from scratch */
+        Seg->Size = 0;
+        for (J = 0, K = 0; J < CollCount (&Seg->Sections); ++J) {
+            Section* Sec = CollAtUnchecked (&Seg->Sections, J);
+            if (Sec->Removed) {
+                /* Removed sections are placed at the segment start, so
+                ** anything still referring to them (debug info) stays
+                ** within the segment.
+                */
+                Sec->Offs = 0;
+                Sec->Fill = 0;
+                continue;
+            }
+            Sec->Fill  = AlignCount (Seg->Size, Sec->Alignment);
+            Seg->Size += Sec->Fill;
+            Sec->Offs  = Seg->Size;
+            Seg->Size += Sec->Size;
+            CollReplace (&Seg->Sections, Sec, K++);
+        }
+
+        /* Drop the entries no longer used */
+        while (CollCount (&Seg->Sections) > K) {
+            CollPop (&Seg->Sections);
+        }
+    }
+}
+
+
+
 unsigned SegmentCount (void)
 /* Return the total number of segments */
 {
@@ -644,6 +714,34 @@ void PrintDbgSegments (FILE* F)
 
 
 
+void WriteBinDbgSegments (void)
+/* Add the segments to a binary debug file */
+{
+    unsigned I;
+    for (I = 0; I < CollCount (&SegmentList); ++I) {
+
+        unsigned long R[DBGBIN_SEG_WORDS];
+
+        /* Get the next segment */
+        const Segment* S = CollAtUnchecked (&SegmentList, I);
+
+        R[DBGBIN_SEG_NAME]  = AddBinDbgString (GetString (S->Name));
+        R[DBGBIN_SEG_START] = S->PC;
+        R[DBGBIN_SEG_SIZE]  = S->Size;
+        if (S->OutputName) {
+            R[DBGBIN_SEG_ONAME] = AddBinDbgString (S->OutputName);
+            R[DBGBIN_SEG_OOFFS] = S->OutputOffs;
+        } else {
+            R[DBGBIN_SEG_ONAME] = 0;
+            R[DBGBIN_SEG_OOFFS] = 0;
+        }
+
+        AddBinDbgRecord (DBGBIN_SEG, R);
+    }
+}
+
+
+
 void CheckSegments (void)
 /* Walk through the segment list and check if there are segments that were
 ** not written to the output file. Output an error if this is the case.
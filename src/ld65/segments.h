@@ -53,6 +53,7 @@
 
 
 /* Forwards */
+struct InFile;
 struct MemoryArea;
 
 /* Segment structure */
@@ -89,7 +90,10 @@ struct Section {
     unsigned long       Size;           /* Size of the section */
     unsigned long       Fill;           /* Fill bytes for alignment */
     unsigned long       Alignment;      /* Alignment */
+    unsigned            Flags;          /* Section flags from the object file */
+    unsigned            SubName;        /* Name of sub-section or invalid */
     unsigned char       AddrSize;       /* Address size of segment */
+    unsigned char       Removed;        /* Removed as unused (--gc-sections) */
 };
 
 
@@ -125,7 +129,7 @@ Segment* GetSegment (unsigned Name, unsigned char AddrSize, const char* ObjName)
 Section* NewSection (Segment* Seg, unsigned long Alignment, unsigned char AddrSize);
 /* Create a new section for the given segment */
 
-Section* ReadSection (FILE* F, struct ObjData* O);
+Section* ReadSection (struct InFile* F, struct ObjData* O);
 /* Read a section from a file */
 
 Segment* SegFind (unsigned Name);
@@ -149,6 +153,14 @@ void SegWrite (const char* TgtName, FILE* Tgt, Segment* S, SegWriteFunc F, void*
 ** called (see description of SegWriteFunc above).
 */
 
+void WalkSections (void (*Func) (Section* S, void* Data), void* Data);
+/* Call Func for all sections in all segments */
+
+void SegRemoveSections (void);
+/* Remove all sections flagged as removed from their segments and recalculate
+** the section offsets and segment sizes.
+*/
+
 unsigned SegmentCount (void);
 /* Return the total number of segments */
 
@@ -158,6 +170,9 @@ void PrintSegmentMap (FILE* F);
 void PrintDbgSegments (FILE* F);
 /* Output the segments to the debug file */
 
+void WriteBinDbgSegments (void);
+/* Add the segments to a binary debug file */
+
 void CheckSegments (void);
 /* Walk through the segment list and check if there are segments that were
 ** not written to the output file. Output an error if this is the case.
@@ -37,7 +37,11 @@
 #include "gentype.h"
 #include "xmalloc.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "fileio.h"
 #include "objdata.h"
 #include "segments.h"
@@ -84,7 +88,7 @@ static Span* NewSpan (unsigned Id)
 
 
 
-Span* ReadSpan (FILE* F, ObjData* O, unsigned Id)
+Span* ReadSpan (InFile* F, ObjData* O, unsigned Id)
 /* Read a Span from a file and return it */
 {
     unsigned Type;
@@ -109,7 +113,7 @@ Span* ReadSpan (FILE* F, ObjData* O, unsigned Id)
 
 
 
-unsigned* ReadSpanList (FILE* F)
+unsigned* ReadSpanList (InFile* F)
 /* Read a list of span ids from a file. The list is returned as an array of
 ** unsigneds, the first being the number of spans (never zero) followed by
 ** the span ids. If the number of spans is zero, NULL is returned.
@@ -203,6 +207,24 @@ void PrintDbgSpanList (FILE* F, const ObjData* O, const unsigned* List)
 
 
 
+unsigned long WriteBinDbgSpanList (const ObjData* O, const unsigned* List)
+/* Add a list of spans read by ReadSpanList to a binary debug file and return
+** its offset. A NULL list is handled like an empty one.
+*/
+{
+    unsigned long Offs = 0;
+    if (List) {
+        unsigned I;
+        Offs = StartBinDbgList (*List);
+        for (I = 0; I < *List; ++I) {
+            AddBinDbgListId (O->SpanBaseId + List[I+1]);
+        }
+    }
+    return Offs;
+}
+
+
+
 void PrintDbgSpans (FILE* F)
 /* Output the spans to a debug info file */
 {
@@ -245,3 +267,37 @@ void PrintDbgSpans (FILE* F)
     /* Free the string buffer */
     SB_Done (&SpanType);
 }
+
+
+
+void WriteBinDbgSpans (void)
+/* Add the spans to a binary debug file */
+{
+    unsigned I, J;
+
+    for (I = 0; I < CollCount (&ObjDataList); ++I) {
+
+        /* Get this object file */
+        ObjData* O = CollAtUnchecked (&ObjDataList, I);
+
+        for (J = 0; J < CollCount (&O->Spans); ++J) {
+
+            unsigned long R[DBGBIN_SPAN_WORDS];
+
+            /* Get this span and the section for it */
+            const Span* S = CollAtUnchecked (&O->Spans, J);
+            const Section* Sec = GetObjSection (O, S->Sec);
+
+            R[DBGBIN_SPAN_SEG]   = Sec->Seg->Id;
+            R[DBGBIN_SPAN_START] = Sec->Offs + S->Offs;
+            R[DBGBIN_SPAN_SIZE]  = S->Size;
+            if (S->Type != INVALID_TYPE_ID) {
+                R[DBGBIN_SPAN_TYPE] = S->Type;
+            } else {
+                R[DBGBIN_SPAN_TYPE] = CC65_INV_ID;
+            }
+
+            AddBinDbgRecord (DBGBIN_SPAN, R);
+        }
+    }
+}
@@ -51,6 +51,7 @@
 
 
 
+struct InFile;
 struct ObjData;
 struct Segment;
 
@@ -73,10 +74,10 @@ typedef struct Span Span;
 
 
 
-Span* ReadSpan (FILE* F, struct ObjData* O, unsigned Id);
+Span* ReadSpan (struct InFile* F, struct ObjData* O, unsigned Id);
 /* Read a Span from a file and return it */
 
-unsigned* ReadSpanList (FILE* F);
+unsigned* ReadSpanList (struct InFile* F);
 /* Read a list of span ids from a file. The list is returned as an array of
 ** unsigneds, the first being the number of spans (never zero) followed by
 ** the span ids. If the number of spans is zero, NULL is returned.
@@ -97,9 +98,17 @@ void PrintDbgSpanList (FILE* F, const struct ObjData* O, const unsigned* List);
 ** print a list of spans read by ReadSpanList to the debug info file.
 */
 
+unsigned long WriteBinDbgSpanList (const struct ObjData* O, const unsigned* List);
+/* Add a list of spans read by ReadSpanList to a binary debug file and return
+** its offset. A NULL list is handled like an empty one.
+*/
+
 void PrintDbgSpans (FILE* F);
 /* Output the spans to a debug info file */
 
+void WriteBinDbgSpans (void);
+/* Add the spans to a binary debug file */
+
 
 
 /* End of span.h */
@@ -36,7 +36,11 @@
 /* common */
 #include "gentype.h"
 
+/* dbginfo */
+#include "dbgbin.h"
+
 /* ld65 */
+#include "dbgfile.h"
 #include "tpool.h"
 
 
@@ -82,6 +86,24 @@ void PrintDbgTypes (FILE* F)
 
 
 
+void WriteBinDbgTypes (void)
+/* Add the types to a binary debug file */
+{
+    StrBuf Type = STATIC_STRBUF_INITIALIZER;
+    unsigned Count = SP_GetCount (TypePool);
+    unsigned Id;
+
+    for (Id = 0; Id < Count; ++Id) {
+        unsigned long R[DBGBIN_TYPE_WORDS];
+        R[DBGBIN_TYPE_VAL] = AddBinDbgString (GT_AsString (SP_Get (TypePool, Id), &Type));
+        AddBinDbgRecord (DBGBIN_TYPE, R);
+    }
+
+    SB_Done (&Type);
+}
+
+
+
 void InitTypePool (void)
 /* Initialize the type pool */
 {
@@ -98,6 +98,9 @@ INLINE unsigned TypeCount (void)
 void PrintDbgTypes (FILE* F);
 /* Output the types to a debug info file */
 
+void WriteBinDbgTypes (void);
+/* Add the types to a binary debug file */
+
 void InitTypePool (void);
 /* Initialize the type pool */
 
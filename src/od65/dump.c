@@ -46,6 +46,7 @@
 #include "objdefs.h"
 #include "optdefs.h"
 #include "scopedefs.h"
+#include "segdefs.h"
 #include "symdefs.h"
 #include "xmalloc.h"
 
@@ -499,6 +500,8 @@ void DumpObjSegments (FILE* F, unsigned long Offset)
         const char*   Name      = GetString (&StrPool, ReadVar (F));
         unsigned      Len       = strlen (Name);
         unsigned      Flags     = ReadVar (F);
+        const char*   SubName   = (Flags & SEG_FLAG_SUBSEC)?
+                                  GetString (&StrPool, ReadVar (F)) : 0;
         unsigned long Size      = ReadVar (F);
         unsigned long Align     = ReadVar (F);
         unsigned char AddrSize  = Read8 (F);
@@ -510,6 +513,10 @@ void DumpObjSegments (FILE* F, unsigned long Offset)
         /* Print the data */
         printf ("      Name:%*s\"%s\"\n", (int)(24-Len), "", Name);
         printf ("      Flags:%25u\n", Flags);
+        if (SubName) {
+            printf ("      Sub-section:%*s\"%s\"\n",
+                    (int)(17-strlen (SubName)), "", SubName);
+        }
         printf ("      Size:%26lu\n", Size);
         printf ("      Alignment:%21lu\n", Align);
         printf ("      Address size:%14s0x%02X  (%s)\n", "", AddrSize,
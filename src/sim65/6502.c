@@ -39,10 +39,15 @@
    6502)
 */
 
+#include <limits.h>
+
 #include "memory.h"
 #include "error.h"
 #include "6502.h"
+#include "fastcore.h"
+#include "machine.h"
 #include "paravirt.h"
+#include "profile.h"
 
 
 
@@ -52,29 +57,9 @@
 
 
 
-/* Current CPU */
-CPUType CPU;
-
 /* Type of an opcode handler function */
-typedef void (*OPFunc) (void);
-
-/* The CPU registers */
-static CPURegs Regs;
-
-/* Cycles for the current insn */
-static unsigned Cycles;
-
-/* Total number of CPU cycles exec'd */
-static unsigned long TotalCycles;
+typedef void (*OPFunc) (Machine* M);
 
-/* NMI request active */
-static unsigned HaveNMIRequest;
-
-/* IRQ request active */
-static unsigned HaveIRQRequest;
-
-/* flag to print cycles at program termination */
-int PrintCycles;
 
 
 /*****************************************************************************/
@@ -84,22 +69,22 @@ int PrintCycles;
 
 
 /* Return the flags as boolean values (0/1) */
-#define GET_CF()        ((Regs.SR & CF) != 0)
-#define GET_ZF()        ((Regs.SR & ZF) != 0)
-#define GET_IF()        ((Regs.SR & IF) != 0)
-#define GET_DF()        ((Regs.SR & DF) != 0)
-#define GET_OF()        ((Regs.SR & OF) != 0)
-#define GET_SF()        ((Regs.SR & SF) != 0)
+#define GET_CF()        ((M->Regs.SR & CF) != 0)
+#define GET_ZF()        ((M->Regs.SR & ZF) != 0)
+#define GET_IF()        ((M->Regs.SR & IF) != 0)
+#define GET_DF()        ((M->Regs.SR & DF) != 0)
+#define GET_OF()        ((M->Regs.SR & OF) != 0)
+#define GET_SF()        ((M->Regs.SR & SF) != 0)
 
 /* Set the flags. The parameter is a boolean flag that says if the flag should be
 ** set or reset.
 */
-#define SET_CF(f)       do { if (f) { Regs.SR |= CF; } else { Regs.SR &= ~CF; } } while (0)
-#define SET_ZF(f)       do { if (f) { Regs.SR |= ZF; } else { Regs.SR &= ~ZF; } } while (0)
-#define SET_IF(f)       do { if (f) { Regs.SR |= IF; } else { Regs.SR &= ~IF; } } while (0)
-#define SET_DF(f)       do { if (f) { Regs.SR |= DF; } else { Regs.SR &= ~DF; } } while (0)
-#define SET_OF(f)       do { if (f) { Regs.SR |= OF; } else { Regs.SR &= ~OF; } } while (0)
-#define SET_SF(f)       do { if (f) { Regs.SR |= SF; } else { Regs.SR &= ~SF; } } while (0)
+#define SET_CF(f)       do { if (f) { M->Regs.SR |= CF; } else { M->Regs.SR &= ~CF; } } while (0)
+#define SET_ZF(f)       do { if (f) { M->Regs.SR |= ZF; } else { M->Regs.SR &= ~ZF; } } while (0)
+#define SET_IF(f)       do { if (f) { M->Regs.SR |= IF; } else { M->Regs.SR &= ~IF; } } while (0)
+#define SET_DF(f)       do { if (f) { M->Regs.SR |= DF; } else { M->Regs.SR &= ~DF; } } while (0)
+#define SET_OF(f)       do { if (f) { M->Regs.SR |= OF; } else { M->Regs.SR &= ~OF; } } while (0)
+#define SET_SF(f)       do { if (f) { M->Regs.SR |= SF; } else { M->Regs.SR &= ~SF; } } while (0)
 
 /* Special test and set macros. The meaning of the parameter depends on the
 ** actual flag that should be set or reset.
@@ -109,132 +94,132 @@ int PrintCycles;
 #define TEST_CF(v)      SET_CF (((v) & 0xFF00) != 0)
 
 /* Program counter halves */
-#define PCL             (Regs.PC & 0xFF)
-#define PCH             ((Regs.PC >> 8) & 0xFF)
+#define PCL             (M->Regs.PC & 0xFF)
+#define PCH             ((M->Regs.PC >> 8) & 0xFF)
 
 /* Stack operations */
-#define PUSH(Val)       MemWriteByte (0x0100 | (Regs.SP-- & 0xFF), Val)
-#define POP()           MemReadByte (0x0100 | (++Regs.SP & 0xFF))
+#define PUSH(Val)       MemWriteByte (M, 0x0100 | (M->Regs.SP-- & 0xFF), Val)
+#define POP()           MemReadByte (M, 0x0100 | (++M->Regs.SP & 0xFF))
 
 /* Test for page cross */
 #define PAGE_CROSS(addr,offs)   ((((addr) & 0xFF) + offs) >= 0x100)
 
 /* #imm */
 #define AC_OP_IMM(op)                                           \
-    Cycles = 2;                                                 \
-    Regs.AC = Regs.AC op MemReadByte (Regs.PC+1);               \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 2;                                              \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, M->Regs.PC+1);   \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* zp */
 #define AC_OP_ZP(op)                                            \
-    Cycles = 3;                                                 \
-    Regs.AC = Regs.AC op MemReadByte (MemReadByte (Regs.PC+1)); \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 3;                                              \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, MemReadByte (M, M->Regs.PC+1)); \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* zp,x */
 #define AC_OP_ZPX(op)                                           \
     unsigned char ZPAddr;                                       \
-    Cycles = 4;                                                 \
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;                 \
-    Regs.AC = Regs.AC op MemReadByte (ZPAddr);                  \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 4;                                              \
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;        \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, ZPAddr);         \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* zp,y */
 #define AC_OP_ZPY(op)                                           \
     unsigned char ZPAddr;                                       \
-    Cycles = 4;                                                 \
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.YR;                 \
-    Regs.AC = Regs.AC op MemReadByte (ZPAddr);                  \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 4;                                              \
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.YR;        \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, ZPAddr);         \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* abs */
 #define AC_OP_ABS(op)                                           \
     unsigned Addr;                                              \
-    Cycles = 4;                                                 \
-    Addr = MemReadWord (Regs.PC+1);                             \
-    Regs.AC = Regs.AC op MemReadByte (Addr);                    \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 3
+    M->Cycles = 4;                                              \
+    Addr = MemReadWord (M, M->Regs.PC+1);                       \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr);           \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 3
 
 /* abs,x */
 #define AC_OP_ABSX(op)                                          \
     unsigned Addr;                                              \
-    Cycles = 4;                                                 \
-    Addr = MemReadWord (Regs.PC+1);                             \
-    if (PAGE_CROSS (Addr, Regs.XR)) {                           \
-        ++Cycles;                                               \
+    M->Cycles = 4;                                              \
+    Addr = MemReadWord (M, M->Regs.PC+1);                       \
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {                        \
+        ++M->Cycles;                                            \
     }                                                           \
-    Regs.AC = Regs.AC op MemReadByte (Addr + Regs.XR);          \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 3
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr + M->Regs.XR); \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 3
 
 /* abs,y */
 #define AC_OP_ABSY(op)                                          \
     unsigned Addr;                                              \
-    Cycles = 4;                                                 \
-    Addr = MemReadWord (Regs.PC+1);                             \
-    if (PAGE_CROSS (Addr, Regs.YR)) {                           \
-        ++Cycles;                                               \
+    M->Cycles = 4;                                              \
+    Addr = MemReadWord (M, M->Regs.PC+1);                       \
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {                        \
+        ++M->Cycles;                                            \
     }                                                           \
-    Regs.AC = Regs.AC op MemReadByte (Addr + Regs.YR);          \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 3
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr + M->Regs.YR); \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 3
 
 /* (zp,x) */
 #define AC_OP_ZPXIND(op)                                        \
     unsigned char ZPAddr;                                       \
     unsigned Addr;                                              \
-    Cycles = 6;                                                 \
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;                 \
-    Addr = MemReadZPWord (ZPAddr);                              \
-    Regs.AC = Regs.AC op MemReadByte (Addr);                    \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 6;                                              \
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;        \
+    Addr = MemReadZPWord (M, ZPAddr);                           \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr);           \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* (zp),y */
 #define AC_OP_ZPINDY(op)                                        \
     unsigned char ZPAddr;                                       \
     unsigned Addr;                                              \
-    Cycles = 5;                                                 \
-    ZPAddr = MemReadByte (Regs.PC+1);                           \
-    Addr = MemReadZPWord (ZPAddr);                              \
-    if (PAGE_CROSS (Addr, Regs.YR)) {                           \
-        ++Cycles;                                               \
+    M->Cycles = 5;                                              \
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);                     \
+    Addr = MemReadZPWord (M, ZPAddr);                           \
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {                        \
+        ++M->Cycles;                                            \
     }                                                           \
-    Addr += Regs.YR;                                            \
-    Regs.AC = Regs.AC op MemReadByte (Addr);                    \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    Addr += M->Regs.YR;                                         \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr);           \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* (zp) */
 #define AC_OP_ZPIND(op)                                         \
     unsigned char ZPAddr;                                       \
     unsigned Addr;                                              \
-    Cycles = 5;                                                 \
-    ZPAddr = MemReadByte (Regs.PC+1);                           \
-    Addr = MemReadZPWord (ZPAddr);                              \
-    Regs.AC = Regs.AC op MemReadByte (Addr);                    \
-    TEST_ZF (Regs.AC);                                          \
-    TEST_SF (Regs.AC);                                          \
-    Regs.PC += 2
+    M->Cycles = 5;                                              \
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);                     \
+    Addr = MemReadZPWord (M, ZPAddr);                           \
+    M->Regs.AC = M->Regs.AC op MemReadByte (M, Addr);           \
+    TEST_ZF (M->Regs.AC);                                       \
+    TEST_SF (M->Regs.AC);                                       \
+    M->Regs.PC += 2
 
 /* ADC */
 #define ADC(v)                                                  \
     do {                                                        \
-        unsigned old = Regs.AC;                                 \
+        unsigned old = M->Regs.AC;                              \
         unsigned rhs = (v & 0xFF);                              \
         if (GET_DF ()) {                                        \
             unsigned lo;                                        \
@@ -243,46 +228,47 @@ int PrintCycles;
             if (lo >= 0x0A) {                                   \
                 lo = ((lo + 0x06) & 0x0F) + 0x10;               \
             }                                                   \
-            Regs.AC = (old & 0xF0) + (rhs & 0xF0) + lo;         \
+            M->Regs.AC = (old & 0xF0) + (rhs & 0xF0) + lo;      \
             res = (signed char)(old & 0xF0) +                   \
                   (signed char)(rhs & 0xF0) +                   \
                   (signed char)lo;                              \
             TEST_ZF (old + rhs + GET_CF ());                    \
-            TEST_SF (Regs.AC);                                  \
-            if (Regs.AC >= 0xA0) {                              \
-                Regs.AC += 0x60;                                \
+            TEST_SF (M->Regs.AC);                               \
+            if (M->Regs.AC >= 0xA0) {                           \
+                M->Regs.AC += 0x60;                             \
             }                                                   \
-            TEST_CF (Regs.AC);                                  \
+            TEST_CF (M->Regs.AC);                               \
             SET_OF ((res < -128) || (res > 127));               \
-            if (CPU != CPU_6502) {                              \
-                ++Cycles;                                       \
+            M->Regs.AC &= 0xFF;                                 \
+            if (M->CPU != CPU_6502) {                           \
+                ++M->Cycles;                                    \
             }                                                   \
         } else {                                                \
-            Regs.AC += rhs + GET_CF ();                         \
-            TEST_ZF (Regs.AC);                                  \
-            TEST_SF (Regs.AC);                                  \
-            TEST_CF (Regs.AC);                                  \
+            M->Regs.AC += rhs + GET_CF ();                      \
+            TEST_ZF (M->Regs.AC);                               \
+            TEST_SF (M->Regs.AC);                               \
+            TEST_CF (M->Regs.AC);                               \
             SET_OF (!((old ^ rhs) & 0x80) &&                    \
-                    ((old ^ Regs.AC) & 0x80));                  \
-            Regs.AC &= 0xFF;                                    \
+                    ((old ^ M->Regs.AC) & 0x80));               \
+            M->Regs.AC &= 0xFF;                                 \
         }                                                       \
     } while (0)
 
 /* branches */
 #define BRANCH(cond)                                            \
-    Cycles = 2;                                                 \
+    M->Cycles = 2;                                              \
     if (cond) {                                                 \
         signed char Offs;                                       \
         unsigned char OldPCH;                                   \
-        ++Cycles;                                               \
-        Offs = (signed char) MemReadByte (Regs.PC+1);           \
+        ++M->Cycles;                                            \
+        Offs = (signed char) MemReadByte (M, M->Regs.PC+1);     \
         OldPCH = PCH;                                           \
-        Regs.PC += 2 + (int) Offs;                              \
+        M->Regs.PC += 2 + (int) Offs;                           \
         if (PCH != OldPCH) {                                    \
-            ++Cycles;                                           \
+            ++M->Cycles;                                        \
         }                                                       \
     } else {                                                    \
-        Regs.PC += 2;                                           \
+        M->Regs.PC += 2;                                        \
     }
 
 /* compares */
@@ -318,7 +304,7 @@ int PrintCycles;
 /* SBC */
 #define SBC(v)                                                  \
     do {                                                        \
-        unsigned old = Regs.AC;                                 \
+        unsigned old = M->Regs.AC;                              \
         unsigned rhs = (v & 0xFF);                              \
         if (GET_DF ()) {                                        \
             unsigned lo;                                        \
@@ -327,25 +313,26 @@ int PrintCycles;
             if (lo & 0x80) {                                    \
                 lo = ((lo - 0x06) & 0x0F) - 0x10;               \
             }                                                   \
-            Regs.AC = (old & 0xF0) - (rhs & 0xF0) + lo;         \
-            if (Regs.AC & 0x80) {                               \
-                Regs.AC -= 0x60;                                \
+            M->Regs.AC = (old & 0xF0) - (rhs & 0xF0) + lo;      \
+            if (M->Regs.AC & 0x80) {                            \
+                M->Regs.AC -= 0x60;                             \
             }                                                   \
-            res = Regs.AC - rhs + (!GET_CF ());                 \
+            res = M->Regs.AC - rhs + (!GET_CF ());              \
             TEST_ZF (res);                                      \
             TEST_SF (res);                                      \
             SET_CF (res <= 0xFF);                               \
             SET_OF (((old^rhs) & (old^res) & 0x80));            \
-            if (CPU != CPU_6502) {                              \
-                ++Cycles;                                       \
+            M->Regs.AC &= 0xFF;                                 \
+            if (M->CPU != CPU_6502) {                           \
+                ++M->Cycles;                                    \
             }                                                   \
         } else {                                                \
-            Regs.AC -= rhs + (!GET_CF ());                      \
-            TEST_ZF (Regs.AC);                                  \
-            TEST_SF (Regs.AC);                                  \
-            SET_CF (Regs.AC <= 0xFF);                           \
-            SET_OF (((old^rhs) & (old^Regs.AC) & 0x80));        \
-            Regs.AC &= 0xFF;                                    \
+            M->Regs.AC -= rhs + (!GET_CF ());                   \
+            TEST_ZF (M->Regs.AC);                               \
+            TEST_SF (M->Regs.AC);                               \
+            SET_CF (M->Regs.AC <= 0xFF);                        \
+            SET_OF (((old^rhs) & (old^M->Regs.AC) & 0x80));     \
+            M->Regs.AC &= 0xFF;                                 \
         }                                                       \
     } while (0)
 
@@ -357,33 +344,33 @@ int PrintCycles;
 
 
 
-static void OPC_Illegal (void)
+static void OPC_Illegal (Machine* M)
 {
-    Error ("Illegal opcode $%02X at address $%04X",
-           MemReadByte (Regs.PC), Regs.PC);
+    MachineError (M, SIM65_ERROR, "Illegal opcode $%02X at address $%04X",
+                  MemReadByte (M, M->Regs.PC), M->Regs.PC);
 }
 
 
 
-static void OPC_6502_00 (void)
+static void OPC_6502_00 (Machine* M)
 /* Opcode $00: BRK */
 {
-    Cycles = 7;
-    Regs.PC += 2;
+    M->Cycles = 7;
+    M->Regs.PC += 2;
     PUSH (PCH);
     PUSH (PCL);
-    PUSH (Regs.SR);
+    PUSH (M->Regs.SR);
     SET_IF (1);
-    if (CPU != CPU_6502)
+    if (M->CPU != CPU_6502)
     {
         SET_DF (0);
     }
-    Regs.PC = MemReadWord (0xFFFE);
+    M->Regs.PC = MemReadWord (M, 0xFFFE);
 }
 
 
 
-static void OPC_6502_01 (void)
+static void OPC_6502_01 (Machine* M)
 /* Opcode $01: ORA (ind,x) */
 {
     AC_OP_ZPXIND (|);
@@ -391,22 +378,22 @@ static void OPC_6502_01 (void)
 
 
 
-static void OPC_65SC02_04 (void)
+static void OPC_65SC02_04 (Machine* M)
 /* Opcode $04: TSB zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
-    SET_ZF ((Val & Regs.AC) == 0);
-    MemWriteByte (ZPAddr, (unsigned char)(Val | Regs.AC));
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    MemWriteByte (M, ZPAddr, (unsigned char)(Val | M->Regs.AC));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_05 (void)
+static void OPC_6502_05 (Machine* M)
 /* Opcode $05: ORA zp */
 {
     AC_OP_ZP (|);
@@ -414,34 +401,34 @@ static void OPC_6502_05 (void)
 
 
 
-static void OPC_6502_06 (void)
+static void OPC_6502_06 (Machine* M)
 /* Opcode $06: ASL zp */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr) << 1;
-    MemWriteByte (ZPAddr, (unsigned char) Val);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr) << 1;
+    MemWriteByte (M, ZPAddr, (unsigned char) Val);
     TEST_ZF (Val & 0xFF);
     TEST_SF (Val);
     SET_CF (Val & 0x100);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_08 (void)
+static void OPC_6502_08 (Machine* M)
 /* Opcode $08: PHP */
 {
-    Cycles = 3;
-    PUSH (Regs.SR);
-    Regs.PC += 1;
+    M->Cycles = 3;
+    PUSH (M->Regs.SR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_09 (void)
+static void OPC_6502_09 (Machine* M)
 /* Opcode $09: ORA #imm */
 {
     AC_OP_IMM (|);
@@ -449,36 +436,36 @@ static void OPC_6502_09 (void)
 
 
 
-static void OPC_6502_0A (void)
+static void OPC_6502_0A (Machine* M)
 /* Opcode $0A: ASL a */
 {
-    Cycles = 2;
-    Regs.AC <<= 1;
-    TEST_ZF (Regs.AC & 0xFF);
-    TEST_SF (Regs.AC);
-    SET_CF (Regs.AC & 0x100);
-    Regs.AC &= 0xFF;
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.AC <<= 1;
+    TEST_ZF (M->Regs.AC & 0xFF);
+    TEST_SF (M->Regs.AC);
+    SET_CF (M->Regs.AC & 0x100);
+    M->Regs.AC &= 0xFF;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_0C (void)
+static void OPC_65SC02_0C (Machine* M)
 /* Opcode $0C: TSB abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr);
-    SET_ZF ((Val & Regs.AC) == 0);
-    MemWriteByte (Addr, (unsigned char) (Val | Regs.AC));
-    Regs.PC += 3;
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr);
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    MemWriteByte (M, Addr, (unsigned char) (Val | M->Regs.AC));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_0D (void)
+static void OPC_6502_0D (Machine* M)
 /* Opcode $0D: ORA abs */
 {
     AC_OP_ABS (|);
@@ -486,24 +473,24 @@ static void OPC_6502_0D (void)
 
 
 
-static void OPC_6502_0E (void)
+static void OPC_6502_0E (Machine* M)
 /* Opcode $0E: ALS abs */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr) << 1;
-    MemWriteByte (Addr, (unsigned char) Val);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr) << 1;
+    MemWriteByte (M, Addr, (unsigned char) Val);
     TEST_ZF (Val & 0xFF);
     TEST_SF (Val);
     SET_CF (Val & 0x100);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_10 (void)
+static void OPC_6502_10 (Machine* M)
 /* Opcode $10: BPL */
 {
     BRANCH (!GET_SF ());
@@ -511,7 +498,7 @@ static void OPC_6502_10 (void)
 
 
 
-static void OPC_6502_11 (void)
+static void OPC_6502_11 (Machine* M)
 /* Opcode $11: ORA (zp),y */
 {
     AC_OP_ZPINDY (|);
@@ -519,7 +506,7 @@ static void OPC_6502_11 (void)
 
 
 
-static void OPC_65SC02_12 (void)
+static void OPC_65SC02_12 (Machine* M)
 /* Opcode $12: ORA (zp) */
 {
     AC_OP_ZPIND (|);
@@ -527,22 +514,22 @@ static void OPC_65SC02_12 (void)
 
 
 
-static void OPC_65SC02_14 (void)
+static void OPC_65SC02_14 (Machine* M)
 /* Opcode $14: TRB zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
-    SET_ZF ((Val & Regs.AC) == 0);
-    MemWriteByte (ZPAddr, (unsigned char)(Val & ~Regs.AC));
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    MemWriteByte (M, ZPAddr, (unsigned char)(Val & ~M->Regs.AC));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_15 (void)
+static void OPC_6502_15 (Machine* M)
 /* Opcode $15: ORA zp,x */
 {
    AC_OP_ZPX (|);
@@ -550,34 +537,34 @@ static void OPC_6502_15 (void)
 
 
 
-static void OPC_6502_16 (void)
+static void OPC_6502_16 (Machine* M)
 /* Opcode $16: ASL zp,x */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr) << 1;
-    MemWriteByte (ZPAddr, (unsigned char) Val);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr) << 1;
+    MemWriteByte (M, ZPAddr, (unsigned char) Val);
     TEST_ZF (Val & 0xFF);
     TEST_SF (Val);
     SET_CF (Val & 0x100);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_18 (void)
+static void OPC_6502_18 (Machine* M)
 /* Opcode $18: CLC */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_CF (0);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_19 (void)
+static void OPC_6502_19 (Machine* M)
 /* Opcode $19: ORA abs,y */
 {
     AC_OP_ABSY (|);
@@ -585,34 +572,34 @@ static void OPC_6502_19 (void)
 
 
 
-static void OPC_65SC02_1A (void)
+static void OPC_65SC02_1A (Machine* M)
 /* Opcode $1A: INC a */
 {
-    Cycles = 2;
-    Regs.AC = (Regs.AC + 1) & 0xFF;
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.AC = (M->Regs.AC + 1) & 0xFF;
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_1C (void)
+static void OPC_65SC02_1C (Machine* M)
 /* Opcode $1C: TRB abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr);
-    SET_ZF ((Val & Regs.AC) == 0);
-    MemWriteByte (Addr, (unsigned char) (Val & ~Regs.AC));
-    Regs.PC += 3;
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr);
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    MemWriteByte (M, Addr, (unsigned char) (Val & ~M->Regs.AC));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_1D (void)
+static void OPC_6502_1D (Machine* M)
 /* Opcode $1D: ORA abs,x */
 {
     AC_OP_ABSX (|);
@@ -620,42 +607,42 @@ static void OPC_6502_1D (void)
 
 
 
-static void OPC_6502_1E (void)
+static void OPC_6502_1E (Machine* M)
 /* Opcode $1E: ASL abs,x */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    if (CPU != CPU_6502 && !PAGE_CROSS (Addr, Regs.XR))
-        --Cycles;
-    Val = MemReadByte (Addr) << 1;
-    MemWriteByte (Addr, (unsigned char) Val);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    if (M->CPU != CPU_6502 && !PAGE_CROSS (Addr, M->Regs.XR))
+        --M->Cycles;
+    Val = MemReadByte (M, Addr) << 1;
+    MemWriteByte (M, Addr, (unsigned char) Val);
     TEST_ZF (Val & 0xFF);
     TEST_SF (Val);
     SET_CF (Val & 0x100);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_20 (void)
+static void OPC_6502_20 (Machine* M)
 /* Opcode $20: JSR */
 {
     unsigned Addr;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Regs.PC += 2;
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    M->Regs.PC += 2;
     PUSH (PCH);
     PUSH (PCL);
-    Regs.PC = Addr;
+    M->Regs.PC = Addr;
 
-    ParaVirtHooks (&Regs);
+    ParaVirtHooks (M);
 }
 
 
 
-static void OPC_6502_21 (void)
+static void OPC_6502_21 (Machine* M)
 /* Opcode $21: AND (zp,x) */
 {
     AC_OP_ZPXIND (&);
@@ -663,23 +650,23 @@ static void OPC_6502_21 (void)
 
 
 
-static void OPC_6502_24 (void)
+static void OPC_6502_24 (Machine* M)
 /* Opcode $24: BIT zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
     SET_SF (Val & 0x80);
     SET_OF (Val & 0x40);
-    SET_ZF ((Val & Regs.AC) == 0);
-    Regs.PC += 2;
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_25 (void)
+static void OPC_6502_25 (Machine* M)
 /* Opcode $25: AND zp */
 {
     AC_OP_ZP (&);
@@ -687,34 +674,34 @@ static void OPC_6502_25 (void)
 
 
 
-static void OPC_6502_26 (void)
+static void OPC_6502_26 (Machine* M)
 /* Opcode $26: ROL zp */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
     ROL (Val);
-    MemWriteByte (ZPAddr, Val);
-    Regs.PC += 2;
+    MemWriteByte (M, ZPAddr, Val);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_28 (void)
+static void OPC_6502_28 (Machine* M)
 /* Opcode $28: PLP */
 {
-    Cycles = 4;
+    M->Cycles = 4;
 
     /* Bits 5 and 4 aren't used, and always are 1! */
-    Regs.SR = (POP () | 0x30);
-    Regs.PC += 1;
+    M->Regs.SR = (POP () | 0x30);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_29 (void)
+static void OPC_6502_29 (Machine* M)
 /* Opcode $29: AND #imm */
 {
     AC_OP_IMM (&);
@@ -722,34 +709,34 @@ static void OPC_6502_29 (void)
 
 
 
-static void OPC_6502_2A (void)
+static void OPC_6502_2A (Machine* M)
 /* Opcode $2A: ROL a */
 {
-    Cycles = 2;
-    ROL (Regs.AC);
-    Regs.AC &= 0xFF;
-    Regs.PC += 1;
+    M->Cycles = 2;
+    ROL (M->Regs.AC);
+    M->Regs.AC &= 0xFF;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_2C (void)
+static void OPC_6502_2C (Machine* M)
 /* Opcode $2C: BIT abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr);
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr);
     SET_SF (Val & 0x80);
     SET_OF (Val & 0x40);
-    SET_ZF ((Val & Regs.AC) == 0);
-    Regs.PC += 3;
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_2D (void)
+static void OPC_6502_2D (Machine* M)
 /* Opcode $2D: AND abs */
 {
     AC_OP_ABS (&);
@@ -757,22 +744,22 @@ static void OPC_6502_2D (void)
 
 
 
-static void OPC_6502_2E (void)
+static void OPC_6502_2E (Machine* M)
 /* Opcode $2E: ROL abs */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr);
     ROL (Val);
-    MemWriteByte (Addr, Val);
-    Regs.PC += 3;
+    MemWriteByte (M, Addr, Val);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_30 (void)
+static void OPC_6502_30 (Machine* M)
 /* Opcode $30: BMI */
 {
     BRANCH (GET_SF ());
@@ -780,7 +767,7 @@ static void OPC_6502_30 (void)
 
 
 
-static void OPC_6502_31 (void)
+static void OPC_6502_31 (Machine* M)
 /* Opcode $31: AND (zp),y */
 {
     AC_OP_ZPINDY (&);
@@ -788,7 +775,7 @@ static void OPC_6502_31 (void)
 
 
 
-static void OPC_65SC02_32 (void)
+static void OPC_65SC02_32 (Machine* M)
 /* Opcode $32: AND (zp) */
 {
     AC_OP_ZPIND (&);
@@ -796,23 +783,23 @@ static void OPC_65SC02_32 (void)
 
 
 
-static void OPC_65SC02_34 (void)
+static void OPC_65SC02_34 (Machine* M)
 /* Opcode $34: BIT zp,x */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr);
     SET_SF (Val & 0x80);
     SET_OF (Val & 0x40);
-    SET_ZF ((Val & Regs.AC) == 0);
-    Regs.PC += 2;
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_35 (void)
+static void OPC_6502_35 (Machine* M)
 /* Opcode $35: AND zp,x */
 {
     AC_OP_ZPX (&);
@@ -820,32 +807,32 @@ static void OPC_6502_35 (void)
 
 
 
-static void OPC_6502_36 (void)
+static void OPC_6502_36 (Machine* M)
 /* Opcode $36: ROL zp,x */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr);
     ROL (Val);
-    MemWriteByte (ZPAddr, Val);
-    Regs.PC += 2;
+    MemWriteByte (M, ZPAddr, Val);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_38 (void)
+static void OPC_6502_38 (Machine* M)
 /* Opcode $38: SEC */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_CF (1);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_39 (void)
+static void OPC_6502_39 (Machine* M)
 /* Opcode $39: AND abs,y */
 {
     AC_OP_ABSY (&);
@@ -853,37 +840,37 @@ static void OPC_6502_39 (void)
 
 
 
-static void OPC_65SC02_3A (void)
+static void OPC_65SC02_3A (Machine* M)
 /* Opcode $3A: DEC a */
 {
-    Cycles = 2;
-    Regs.AC = (Regs.AC - 1) & 0xFF;
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.AC = (M->Regs.AC - 1) & 0xFF;
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_3C (void)
+static void OPC_65SC02_3C (Machine* M)
 /* Opcode $3C: BIT abs,x */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR))
-        ++Cycles;
-    Val  = MemReadByte (Addr + Regs.XR);
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR))
+        ++M->Cycles;
+    Val  = MemReadByte (M, Addr + M->Regs.XR);
     SET_SF (Val & 0x80);
     SET_OF (Val & 0x40);
-    SET_ZF ((Val & Regs.AC) == 0);
-    Regs.PC += 3;
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_3D (void)
+static void OPC_6502_3D (Machine* M)
 /* Opcode $3D: AND abs,x */
 {
     AC_OP_ABSX (&);
@@ -891,37 +878,37 @@ static void OPC_6502_3D (void)
 
 
 
-static void OPC_6502_3E (void)
+static void OPC_6502_3E (Machine* M)
 /* Opcode $3E: ROL abs,x */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    if (CPU != CPU_6502 && !PAGE_CROSS (Addr, Regs.XR))
-        --Cycles;
-    Val = MemReadByte (Addr);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    if (M->CPU != CPU_6502 && !PAGE_CROSS (Addr, M->Regs.XR))
+        --M->Cycles;
+    Val = MemReadByte (M, Addr);
     ROL (Val);
-    MemWriteByte (Addr, Val);
-    Regs.PC += 2;
+    MemWriteByte (M, Addr, Val);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_40 (void)
+static void OPC_6502_40 (Machine* M)
 /* Opcode $40: RTI */
 {
-    Cycles = 6;
+    M->Cycles = 6;
 
     /* Bits 5 and 4 aren't used, and always are 1! */
-    Regs.SR = POP () | 0x30;
-    Regs.PC = POP ();                /* PCL */
-    Regs.PC |= (POP () << 8);        /* PCH */
+    M->Regs.SR = POP () | 0x30;
+    M->Regs.PC = POP ();                /* PCL */
+    M->Regs.PC |= (POP () << 8);        /* PCH */
 }
 
 
 
-static void OPC_6502_41 (void)
+static void OPC_6502_41 (Machine* M)
 /* Opcode $41: EOR (zp,x) */
 {
     AC_OP_ZPXIND (^);
@@ -929,16 +916,16 @@ static void OPC_6502_41 (void)
 
 
 
-static void OPC_65C02_44 (void)
+static void OPC_65C02_44 (Machine* M)
 /* Opcode $44: 'zp' 3 cycle NOP */
 {
-    Cycles = 3;
-    Regs.PC += 2;
+    M->Cycles = 3;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_45 (void)
+static void OPC_6502_45 (Machine* M)
 /* Opcode $45: EOR zp */
 {
     AC_OP_ZP (^);
@@ -946,35 +933,35 @@ static void OPC_6502_45 (void)
 
 
 
-static void OPC_6502_46 (void)
+static void OPC_6502_46 (Machine* M)
 /* Opcode $46: LSR zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
     SET_CF (Val & 0x01);
     Val >>= 1;
-    MemWriteByte (ZPAddr, Val);
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_48 (void)
+static void OPC_6502_48 (Machine* M)
 /* Opcode $48: PHA */
 {
-    Cycles = 3;
-    PUSH (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 3;
+    PUSH (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_49 (void)
+static void OPC_6502_49 (Machine* M)
 /* Opcode $49: EOR #imm */
 {
     AC_OP_IMM (^);
@@ -982,31 +969,31 @@ static void OPC_6502_49 (void)
 
 
 
-static void OPC_6502_4A (void)
+static void OPC_6502_4A (Machine* M)
 /* Opcode $4A: LSR a */
 {
-    Cycles = 2;
-    SET_CF (Regs.AC & 0x01);
-    Regs.AC >>= 1;
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    SET_CF (M->Regs.AC & 0x01);
+    M->Regs.AC >>= 1;
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_4C (void)
+static void OPC_6502_4C (Machine* M)
 /* Opcode $4C: JMP abs */
 {
-    Cycles = 3;
-    Regs.PC = MemReadWord (Regs.PC+1);
+    M->Cycles = 3;
+    M->Regs.PC = MemReadWord (M, M->Regs.PC+1);
 
-    ParaVirtHooks (&Regs);
+    ParaVirtHooks (M);
 }
 
 
 
-static void OPC_6502_4D (void)
+static void OPC_6502_4D (Machine* M)
 /* Opcode $4D: EOR abs */
 {
     AC_OP_ABS (^);
@@ -1014,25 +1001,25 @@ static void OPC_6502_4D (void)
 
 
 
-static void OPC_6502_4E (void)
+static void OPC_6502_4E (Machine* M)
 /* Opcode $4E: LSR abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr);
     SET_CF (Val & 0x01);
     Val >>= 1;
-    MemWriteByte (Addr, Val);
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_50 (void)
+static void OPC_6502_50 (Machine* M)
 /* Opcode $50: BVC */
 {
     BRANCH (!GET_OF ());
@@ -1040,7 +1027,7 @@ static void OPC_6502_50 (void)
 
 
 
-static void OPC_6502_51 (void)
+static void OPC_6502_51 (Machine* M)
 /* Opcode $51: EOR (zp),y */
 {
     AC_OP_ZPINDY (^);
@@ -1048,7 +1035,7 @@ static void OPC_6502_51 (void)
 
 
 
-static void OPC_65SC02_52 (void)
+static void OPC_65SC02_52 (Machine* M)
 /* Opcode $52: EOR (zp) */
 {
     AC_OP_ZPIND (^);
@@ -1056,7 +1043,7 @@ static void OPC_65SC02_52 (void)
 
 
 
-static void OPC_6502_55 (void)
+static void OPC_6502_55 (Machine* M)
 /* Opcode $55: EOR zp,x */
 {
     AC_OP_ZPX (^);
@@ -1064,35 +1051,35 @@ static void OPC_6502_55 (void)
 
 
 
-static void OPC_6502_56 (void)
+static void OPC_6502_56 (Machine* M)
 /* Opcode $56: LSR zp,x */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr);
     SET_CF (Val & 0x01);
     Val >>= 1;
-    MemWriteByte (ZPAddr, Val);
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_58 (void)
+static void OPC_6502_58 (Machine* M)
 /* Opcode $58: CLI */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_IF (0);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_59 (void)
+static void OPC_6502_59 (Machine* M)
 /* Opcode $59: EOR abs,y */
 {
     AC_OP_ABSY (^);
@@ -1100,26 +1087,26 @@ static void OPC_6502_59 (void)
 
 
 
-static void OPC_65SC02_5A (void)
+static void OPC_65SC02_5A (Machine* M)
 /* Opcode $5A: PHY */
 {
-    Cycles = 3;
-    PUSH (Regs.YR);
-    Regs.PC += 1;
+    M->Cycles = 3;
+    PUSH (M->Regs.YR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65C02_5C (void)
+static void OPC_65C02_5C (Machine* M)
 /* Opcode $5C: 'Absolute' 8 cycle NOP */
 {
-    Cycles = 8;
-    Regs.PC += 3;
+    M->Cycles = 8;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_5D (void)
+static void OPC_6502_5D (Machine* M)
 /* Opcode $5D: EOR abs,x */
 {
     AC_OP_ABSX (^);
@@ -1127,136 +1114,136 @@ static void OPC_6502_5D (void)
 
 
 
-static void OPC_6502_5E (void)
+static void OPC_6502_5E (Machine* M)
 /* Opcode $5E: LSR abs,x */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    if (CPU != CPU_6502 && !PAGE_CROSS (Addr, Regs.XR))
-        --Cycles;
-    Val = MemReadByte (Addr);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    if (M->CPU != CPU_6502 && !PAGE_CROSS (Addr, M->Regs.XR))
+        --M->Cycles;
+    Val = MemReadByte (M, Addr);
     SET_CF (Val & 0x01);
     Val >>= 1;
-    MemWriteByte (Addr, Val);
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_60 (void)
+static void OPC_6502_60 (Machine* M)
 /* Opcode $60: RTS */
 {
-    Cycles = 6;
-    Regs.PC = POP ();                /* PCL */
-    Regs.PC |= (POP () << 8);        /* PCH */
-    Regs.PC += 1;
+    M->Cycles = 6;
+    M->Regs.PC = POP ();                /* PCL */
+    M->Regs.PC |= (POP () << 8);        /* PCH */
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_61 (void)
+static void OPC_6502_61 (Machine* M)
 /* Opcode $61: ADC (zp,x) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Addr = MemReadZPWord (ZPAddr);
-    ADC (MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Addr = MemReadZPWord (M, ZPAddr);
+    ADC (MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_64 (void)
+static void OPC_65SC02_64 (Machine* M)
 /* Opcode $64: STZ zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    MemWriteByte (ZPAddr, 0);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    MemWriteByte (M, ZPAddr, 0);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_65 (void)
+static void OPC_6502_65 (Machine* M)
 /* Opcode $65: ADC zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    ADC (MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    ADC (MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_66 (void)
+static void OPC_6502_66 (Machine* M)
 /* Opcode $66: ROR zp */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr);
     ROR (Val);
-    MemWriteByte (ZPAddr, Val);
-    Regs.PC += 2;
+    MemWriteByte (M, ZPAddr, Val);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_68 (void)
+static void OPC_6502_68 (Machine* M)
 /* Opcode $68: PLA */
 {
-    Cycles = 4;
-    Regs.AC = POP ();
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 4;
+    M->Regs.AC = POP ();
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_69 (void)
+static void OPC_6502_69 (Machine* M)
 /* Opcode $69: ADC #imm */
 {
-    Cycles = 2;
-    ADC (MemReadByte (Regs.PC+1));
-    Regs.PC += 2;
+    M->Cycles = 2;
+    ADC (MemReadByte (M, M->Regs.PC+1));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_6A (void)
+static void OPC_6502_6A (Machine* M)
 /* Opcode $6A: ROR a */
 {
-    Cycles = 2;
-    ROR (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    ROR (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_6C (void)
+static void OPC_6502_6C (Machine* M)
 /* Opcode $6C: JMP (ind) */
 {
     unsigned PC, Lo, Hi;
-    PC = Regs.PC;
-    Lo = MemReadWord (PC+1);
+    PC = M->Regs.PC;
+    Lo = MemReadWord (M, PC+1);
 
-    if (CPU == CPU_6502)
+    if (M->CPU == CPU_6502)
     {
          /* Emulate the 6502 bug */
-        Cycles = 5;
-        Regs.PC = MemReadByte (Lo);
+        M->Cycles = 5;
+        M->Regs.PC = MemReadByte (M, Lo);
         Hi = (Lo & 0xFF00) | ((Lo + 1) & 0xFF);
-        Regs.PC |= (MemReadByte (Hi) << 8);
+        M->Regs.PC |= (MemReadByte (M, Hi) << 8);
 
         /* Output a warning if the bug is triggered */
         if (Hi != Lo + 1)
@@ -1267,55 +1254,55 @@ static void OPC_6502_6C (void)
     }
     else
     {
-        Cycles = 6;
-        Regs.PC = MemReadWord(Lo);
+        M->Cycles = 6;
+        M->Regs.PC = MemReadWord(M, Lo);
     }
     
-    ParaVirtHooks (&Regs);    
+    ParaVirtHooks (M);    
 }
 
 
 
-static void OPC_65C02_6C (void)
+static void OPC_65C02_6C (Machine* M)
 /* Opcode $6C: JMP (ind) */
 {
     /* 6502 bug fixed here */
-    Cycles = 5;
-    Regs.PC = MemReadWord (MemReadWord (Regs.PC+1));
+    M->Cycles = 5;
+    M->Regs.PC = MemReadWord (M, MemReadWord (M, M->Regs.PC+1));
 
-    ParaVirtHooks (&Regs);    
+    ParaVirtHooks (M);    
 }
 
 
 
-static void OPC_6502_6D (void)
+static void OPC_6502_6D (Machine* M)
 /* Opcode $6D: ADC abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr   = MemReadWord (Regs.PC+1);
-    ADC (MemReadByte (Addr));
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr   = MemReadWord (M, M->Regs.PC+1);
+    ADC (MemReadByte (M, Addr));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_6E (void)
+static void OPC_6502_6E (Machine* M)
 /* Opcode $6E: ROR abs */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val  = MemReadByte (Addr);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val  = MemReadByte (M, Addr);
     ROR (Val);
-    MemWriteByte (Addr, Val);
-    Regs.PC += 3;
+    MemWriteByte (M, Addr, Val);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_70 (void)
+static void OPC_6502_70 (Machine* M)
 /* Opcode $70: BVS */
 {
     BRANCH (GET_OF ());
@@ -1323,160 +1310,160 @@ static void OPC_6502_70 (void)
 
 
 
-static void OPC_6502_71 (void)
+static void OPC_6502_71 (Machine* M)
 /* Opcode $71: ADC (zp),y */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr   = MemReadZPWord (ZPAddr);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr   = MemReadZPWord (M, ZPAddr);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    ADC (MemReadByte (Addr + Regs.YR));
-    Regs.PC += 2;
+    ADC (MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_72 (void)
+static void OPC_65SC02_72 (Machine* M)
 /* Opcode $72: ADC (zp) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr   = MemReadZPWord (ZPAddr);
-    ADC (MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr   = MemReadZPWord (M, ZPAddr);
+    ADC (MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_74 (void)
+static void OPC_65SC02_74 (Machine* M)
 /* Opcode $74: STZ zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    MemWriteByte (ZPAddr, 0);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    MemWriteByte (M, ZPAddr, 0);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_75 (void)
+static void OPC_6502_75 (Machine* M)
 /* Opcode $75: ADC zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    ADC (MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    ADC (MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_76 (void)
+static void OPC_6502_76 (Machine* M)
 /* Opcode $76: ROR zp,x */
 {
     unsigned char ZPAddr;
     unsigned Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr);
     ROR (Val);
-    MemWriteByte (ZPAddr, Val);
-    Regs.PC += 2;
+    MemWriteByte (M, ZPAddr, Val);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_78 (void)
+static void OPC_6502_78 (Machine* M)
 /* Opcode $78: SEI */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_IF (1);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_79 (void)
+static void OPC_6502_79 (Machine* M)
 /* Opcode $79: ADC abs,y */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    ADC (MemReadByte (Addr + Regs.YR));
-    Regs.PC += 3;
+    ADC (MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_65SC02_7A (void)
+static void OPC_65SC02_7A (Machine* M)
 /* Opcode $7A: PLY */
 {
-    Cycles = 4;
-    Regs.YR = POP ();
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 1;
+    M->Cycles = 4;
+    M->Regs.YR = POP ();
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_7C (void)
+static void OPC_65SC02_7C (Machine* M)
 /* Opcode $7C: JMP (ind,X) */
 {
     unsigned PC, Adr;
-    Cycles = 6;
-    PC = Regs.PC;
-    Adr = MemReadWord (PC+1);
-    Regs.PC = MemReadWord(Adr+Regs.XR);
+    M->Cycles = 6;
+    PC = M->Regs.PC;
+    Adr = MemReadWord (M, PC+1);
+    M->Regs.PC = MemReadWord(M, Adr+M->Regs.XR);
 
-    ParaVirtHooks (&Regs);    
+    ParaVirtHooks (M);    
 }
 
 
 
-static void OPC_6502_7D (void)
+static void OPC_6502_7D (Machine* M)
 /* Opcode $7D: ADC abs,x */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {
+        ++M->Cycles;
     }
-    ADC (MemReadByte (Addr + Regs.XR));
-    Regs.PC += 3;
+    ADC (MemReadByte (M, Addr + M->Regs.XR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_7E (void)
+static void OPC_6502_7E (Machine* M)
 /* Opcode $7E: ROR abs,x */
 {
     unsigned Addr;
     unsigned Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    if (CPU != CPU_6502 && !PAGE_CROSS (Addr, Regs.XR))
-        --Cycles;
-    Val = MemReadByte (Addr);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    if (M->CPU != CPU_6502 && !PAGE_CROSS (Addr, M->Regs.XR))
+        --M->Cycles;
+    Val = MemReadByte (M, Addr);
     ROR (Val);
-    MemWriteByte (Addr, Val);
-    Regs.PC += 3;
+    MemWriteByte (M, Addr, Val);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_65SC02_80 (void)
+static void OPC_65SC02_80 (Machine* M)
 /* Opcode $80: BRA */
 {
     BRANCH (1);
@@ -1484,131 +1471,131 @@ static void OPC_65SC02_80 (void)
 
 
 
-static void OPC_6502_81 (void)
+static void OPC_6502_81 (Machine* M)
 /* Opcode $81: STA (zp,x) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Addr = MemReadZPWord (ZPAddr);
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Addr = MemReadZPWord (M, ZPAddr);
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_84 (void)
+static void OPC_6502_84 (Machine* M)
 /* Opcode $84: STY zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    MemWriteByte (ZPAddr, Regs.YR);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    MemWriteByte (M, ZPAddr, M->Regs.YR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_85 (void)
+static void OPC_6502_85 (Machine* M)
 /* Opcode $85: STA zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    MemWriteByte (ZPAddr, Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    MemWriteByte (M, ZPAddr, M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_86 (void)
+static void OPC_6502_86 (Machine* M)
 /* Opcode $86: STX zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    MemWriteByte (ZPAddr, Regs.XR);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    MemWriteByte (M, ZPAddr, M->Regs.XR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_88 (void)
+static void OPC_6502_88 (Machine* M)
 /* Opcode $88: DEY */
 {
-    Cycles = 2;
-    Regs.YR = (Regs.YR - 1) & 0xFF;
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.YR = (M->Regs.YR - 1) & 0xFF;
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_89 (void)
+static void OPC_65SC02_89 (Machine* M)
 /* Opcode $89: BIT #imm */
 {
     unsigned char Val;
-    Cycles = 2;
-    Val = MemReadByte (Regs.PC+1);
+    M->Cycles = 2;
+    Val = MemReadByte (M, M->Regs.PC+1);
     SET_SF (Val & 0x80);
     SET_OF (Val & 0x40);
-    SET_ZF ((Val & Regs.AC) == 0);
-    Regs.PC += 2;
+    SET_ZF ((Val & M->Regs.AC) == 0);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_8A (void)
+static void OPC_6502_8A (Machine* M)
 /* Opcode $8A: TXA */
 {
-    Cycles = 2;
-    Regs.AC = Regs.XR;
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.AC = M->Regs.XR;
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_8C (void)
+static void OPC_6502_8C (Machine* M)
 /* Opcode $8C: STY abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    MemWriteByte (Addr, Regs.YR);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    MemWriteByte (M, Addr, M->Regs.YR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_8D (void)
+static void OPC_6502_8D (Machine* M)
 /* Opcode $8D: STA abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_8E (void)
+static void OPC_6502_8E (Machine* M)
 /* Opcode $8E: STX abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    MemWriteByte (Addr, Regs.XR);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    MemWriteByte (M, Addr, M->Regs.XR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_90 (void)
+static void OPC_6502_90 (Machine* M)
 /* Opcode $90: BCC */
 {
     BRANCH (!GET_CF ());
@@ -1616,301 +1603,301 @@ static void OPC_6502_90 (void)
 
 
 
-static void OPC_6502_91 (void)
+static void OPC_6502_91 (Machine* M)
 /* Opcode $91: sta (zp),y */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr) + Regs.YR;
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr) + M->Regs.YR;
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_92 (void)
+static void OPC_65SC02_92 (Machine* M)
 /* Opcode $92: sta (zp) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr);
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr);
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_94 (void)
+static void OPC_6502_94 (Machine* M)
 /* Opcode $94: STY zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    MemWriteByte (ZPAddr, Regs.YR);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    MemWriteByte (M, ZPAddr, M->Regs.YR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_95 (void)
+static void OPC_6502_95 (Machine* M)
 /* Opcode $95: STA zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    MemWriteByte (ZPAddr, Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    MemWriteByte (M, ZPAddr, M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_96 (void)
+static void OPC_6502_96 (Machine* M)
 /* Opcode $96: stx zp,y */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.YR;
-    MemWriteByte (ZPAddr, Regs.XR);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.YR;
+    MemWriteByte (M, ZPAddr, M->Regs.XR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_98 (void)
+static void OPC_6502_98 (Machine* M)
 /* Opcode $98: TYA */
 {
-    Cycles = 2;
-    Regs.AC = Regs.YR;
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.AC = M->Regs.YR;
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_99 (void)
+static void OPC_6502_99 (Machine* M)
 /* Opcode $99: STA abs,y */
 {
     unsigned Addr;
-    Cycles = 5;
-    Addr = MemReadWord (Regs.PC+1) + Regs.YR;
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 3;
+    M->Cycles = 5;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.YR;
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_9A (void)
+static void OPC_6502_9A (Machine* M)
 /* Opcode $9A: TXS */
 {
-    Cycles = 2;
-    Regs.SP = Regs.XR;
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.SP = M->Regs.XR;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65SC02_9C (void)
+static void OPC_65SC02_9C (Machine* M)
 /* Opcode $9C: STZ abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    MemWriteByte (Addr, 0);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    MemWriteByte (M, Addr, 0);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_9D (void)
+static void OPC_6502_9D (Machine* M)
 /* Opcode $9D: STA abs,x */
 {
     unsigned Addr;
-    Cycles = 5;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    MemWriteByte (Addr, Regs.AC);
-    Regs.PC += 3;
+    M->Cycles = 5;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    MemWriteByte (M, Addr, M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_65SC02_9E (void)
+static void OPC_65SC02_9E (Machine* M)
 /* Opcode $9E: STZ abs,x */
 {
     unsigned Addr;
-    Cycles = 5;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    MemWriteByte (Addr, 0);
-    Regs.PC += 3;
+    M->Cycles = 5;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    MemWriteByte (M, Addr, 0);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_A0 (void)
+static void OPC_6502_A0 (Machine* M)
 /* Opcode $A0: LDY #imm */
 {
-    Cycles = 2;
-    Regs.YR = MemReadByte (Regs.PC+1);
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 2;
+    M->Cycles = 2;
+    M->Regs.YR = MemReadByte (M, M->Regs.PC+1);
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A1 (void)
+static void OPC_6502_A1 (Machine* M)
 /* Opcode $A1: LDA (zp,x) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Addr = MemReadZPWord (ZPAddr);
-    Regs.AC = MemReadByte (Addr);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Addr = MemReadZPWord (M, ZPAddr);
+    M->Regs.AC = MemReadByte (M, Addr);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A2 (void)
+static void OPC_6502_A2 (Machine* M)
 /* Opcode $A2: LDX #imm */
 {
-    Cycles = 2;
-    Regs.XR = MemReadByte (Regs.PC+1);
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 2;
+    M->Cycles = 2;
+    M->Regs.XR = MemReadByte (M, M->Regs.PC+1);
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A4 (void)
+static void OPC_6502_A4 (Machine* M)
 /* Opcode $A4: LDY zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Regs.YR = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    M->Regs.YR = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A5 (void)
+static void OPC_6502_A5 (Machine* M)
 /* Opcode $A5: LDA zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Regs.AC = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    M->Regs.AC = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A6 (void)
+static void OPC_6502_A6 (Machine* M)
 /* Opcode $A6: LDX zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Regs.XR = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    M->Regs.XR = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_A8 (void)
+static void OPC_6502_A8 (Machine* M)
 /* Opcode $A8: TAY */
 {
-    Cycles = 2;
-    Regs.YR = Regs.AC;
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.YR = M->Regs.AC;
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_A9 (void)
+static void OPC_6502_A9 (Machine* M)
 /* Opcode $A9: LDA #imm */
 {
-    Cycles = 2;
-    Regs.AC = MemReadByte (Regs.PC+1);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 2;
+    M->Regs.AC = MemReadByte (M, M->Regs.PC+1);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_AA (void)
+static void OPC_6502_AA (Machine* M)
 /* Opcode $AA: TAX */
 {
-    Cycles = 2;
-    Regs.XR = Regs.AC;
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.XR = M->Regs.AC;
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_AC (void)
+static void OPC_6502_AC (Machine* M)
 /* Opcode $Regs.AC: LDY abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    Regs.YR = MemReadByte (Addr);
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    M->Regs.YR = MemReadByte (M, Addr);
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_AD (void)
+static void OPC_6502_AD (Machine* M)
 /* Opcode $AD: LDA abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    Regs.AC = MemReadByte (Addr);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    M->Regs.AC = MemReadByte (M, Addr);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_AE (void)
+static void OPC_6502_AE (Machine* M)
 /* Opcode $AE: LDX abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    Regs.XR = MemReadByte (Addr);
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    M->Regs.XR = MemReadByte (M, Addr);
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_B0 (void)
+static void OPC_6502_B0 (Machine* M)
 /* Opcode $B0: BCS */
 {
     BRANCH (GET_CF ());
@@ -1918,312 +1905,312 @@ static void OPC_6502_B0 (void)
 
 
 
-static void OPC_6502_B1 (void)
+static void OPC_6502_B1 (Machine* M)
 /* Opcode $B1: LDA (zp),y */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    Regs.AC = MemReadByte (Addr + Regs.YR);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Regs.AC = MemReadByte (M, Addr + M->Regs.YR);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_B2 (void)
+static void OPC_65SC02_B2 (Machine* M)
 /* Opcode $B2: LDA (zp) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr);
-    Regs.AC = MemReadByte (Addr);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr);
+    M->Regs.AC = MemReadByte (M, Addr);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_B4 (void)
+static void OPC_6502_B4 (Machine* M)
 /* Opcode $B4: LDY zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Regs.YR = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    M->Regs.YR = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_B5 (void)
+static void OPC_6502_B5 (Machine* M)
 /* Opcode $B5: LDA zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Regs.AC = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    M->Regs.AC = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_B6 (void)
+static void OPC_6502_B6 (Machine* M)
 /* Opcode $B6: LDX zp,y */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.YR;
-    Regs.XR = MemReadByte (ZPAddr);
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.YR;
+    M->Regs.XR = MemReadByte (M, ZPAddr);
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_B8 (void)
+static void OPC_6502_B8 (Machine* M)
 /* Opcode $B8: CLV */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_OF (0);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_B9 (void)
+static void OPC_6502_B9 (Machine* M)
 /* Opcode $B9: LDA abs,y */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    Regs.AC = MemReadByte (Addr + Regs.YR);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 3;
+    M->Regs.AC = MemReadByte (M, Addr + M->Regs.YR);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_BA (void)
+static void OPC_6502_BA (Machine* M)
 /* Opcode $BA: TSX */
 {
-    Cycles = 2;
-    Regs.XR = Regs.SP & 0xFF;
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.XR = M->Regs.SP & 0xFF;
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_BC (void)
+static void OPC_6502_BC (Machine* M)
 /* Opcode $BC: LDY abs,x */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {
+        ++M->Cycles;
     }
-    Regs.YR = MemReadByte (Addr + Regs.XR);
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 3;
+    M->Regs.YR = MemReadByte (M, Addr + M->Regs.XR);
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_BD (void)
+static void OPC_6502_BD (Machine* M)
 /* Opcode $BD: LDA abs,x */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {
+        ++M->Cycles;
     }
-    Regs.AC = MemReadByte (Addr + Regs.XR);
-    TEST_ZF (Regs.AC);
-    TEST_SF (Regs.AC);
-    Regs.PC += 3;
+    M->Regs.AC = MemReadByte (M, Addr + M->Regs.XR);
+    TEST_ZF (M->Regs.AC);
+    TEST_SF (M->Regs.AC);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_BE (void)
+static void OPC_6502_BE (Machine* M)
 /* Opcode $BE: LDX abs,y */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    Regs.XR = MemReadByte (Addr + Regs.YR);
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 3;
+    M->Regs.XR = MemReadByte (M, Addr + M->Regs.YR);
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_C0 (void)
+static void OPC_6502_C0 (Machine* M)
 /* Opcode $C0: CPY #imm */
 {
-    Cycles = 2;
-    CMP (Regs.YR, MemReadByte (Regs.PC+1));
-    Regs.PC += 2;
+    M->Cycles = 2;
+    CMP (M->Regs.YR, MemReadByte (M, M->Regs.PC+1));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_C1 (void)
+static void OPC_6502_C1 (Machine* M)
 /* Opcode $C1: CMP (zp,x) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Addr = MemReadZPWord (ZPAddr);
-    CMP (Regs.AC, MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Addr = MemReadZPWord (M, ZPAddr);
+    CMP (M->Regs.AC, MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_C4 (void)
+static void OPC_6502_C4 (Machine* M)
 /* Opcode $C4: CPY zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    CMP (Regs.YR, MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    CMP (M->Regs.YR, MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_C5 (void)
+static void OPC_6502_C5 (Machine* M)
 /* Opcode $C5: CMP zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    CMP (Regs.AC, MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    CMP (M->Regs.AC, MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_C6 (void)
+static void OPC_6502_C6 (Machine* M)
 /* Opcode $C6: DEC zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr) - 1;
-    MemWriteByte (ZPAddr, Val);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr) - 1;
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_C8 (void)
+static void OPC_6502_C8 (Machine* M)
 /* Opcode $C8: INY */
 {
-    Cycles = 2;
-    Regs.YR = (Regs.YR + 1) & 0xFF;
-    TEST_ZF (Regs.YR);
-    TEST_SF (Regs.YR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.YR = (M->Regs.YR + 1) & 0xFF;
+    TEST_ZF (M->Regs.YR);
+    TEST_SF (M->Regs.YR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_C9 (void)
+static void OPC_6502_C9 (Machine* M)
 /* Opcode $C9: CMP #imm */
 {
-    Cycles = 2;
-    CMP (Regs.AC, MemReadByte (Regs.PC+1));
-    Regs.PC += 2;
+    M->Cycles = 2;
+    CMP (M->Regs.AC, MemReadByte (M, M->Regs.PC+1));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_CA (void)
+static void OPC_6502_CA (Machine* M)
 /* Opcode $CA: DEX */
 {
-    Cycles = 2;
-    Regs.XR = (Regs.XR - 1) & 0xFF;
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.XR = (M->Regs.XR - 1) & 0xFF;
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_CC (void)
+static void OPC_6502_CC (Machine* M)
 /* Opcode $CC: CPY abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    CMP (Regs.YR, MemReadByte (Addr));
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    CMP (M->Regs.YR, MemReadByte (M, Addr));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_CD (void)
+static void OPC_6502_CD (Machine* M)
 /* Opcode $CD: CMP abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    CMP (Regs.AC, MemReadByte (Addr));
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    CMP (M->Regs.AC, MemReadByte (M, Addr));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_CE (void)
+static void OPC_6502_CE (Machine* M)
 /* Opcode $CE: DEC abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val  = MemReadByte (Addr) - 1;
-    MemWriteByte (Addr, Val);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val  = MemReadByte (M, Addr) - 1;
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_D0 (void)
+static void OPC_6502_D0 (Machine* M)
 /* Opcode $D0: BNE */
 {
     BRANCH (!GET_ZF ());
@@ -2231,304 +2218,304 @@ static void OPC_6502_D0 (void)
 
 
 
-static void OPC_6502_D1 (void)
+static void OPC_6502_D1 (Machine* M)
 /* Opcode $D1: CMP (zp),y */
 {
     unsigned ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadWord (ZPAddr);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadWord (M, ZPAddr);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    CMP (Regs.AC, MemReadByte (Addr + Regs.YR));
-    Regs.PC += 2;
+    CMP (M->Regs.AC, MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_D2 (void)
+static void OPC_65SC02_D2 (Machine* M)
 /* Opcode $D2: CMP (zp) */
 {
     unsigned ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadWord (ZPAddr);
-    CMP (Regs.AC, MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadWord (M, ZPAddr);
+    CMP (M->Regs.AC, MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_D5 (void)
+static void OPC_6502_D5 (Machine* M)
 /* Opcode $D5: CMP zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    CMP (Regs.AC, MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    CMP (M->Regs.AC, MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_D6 (void)
+static void OPC_6502_D6 (Machine* M)
 /* Opcode $D6: DEC zp,x */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr) - 1;
-    MemWriteByte (ZPAddr, Val);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr) - 1;
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_D8 (void)
+static void OPC_6502_D8 (Machine* M)
 /* Opcode $D8: CLD */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_DF (0);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_D9 (void)
+static void OPC_6502_D9 (Machine* M)
 /* Opcode $D9: CMP abs,y */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    CMP (Regs.AC, MemReadByte (Addr + Regs.YR));
-    Regs.PC += 3;
+    CMP (M->Regs.AC, MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_65SC02_DA (void)
+static void OPC_65SC02_DA (Machine* M)
 /* Opcode $DA: PHX */
 {
-    Cycles = 3;
-    PUSH (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 3;
+    PUSH (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_DD (void)
+static void OPC_6502_DD (Machine* M)
 /* Opcode $DD: CMP abs,x */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {
+        ++M->Cycles;
     }
-    CMP (Regs.AC, MemReadByte (Addr + Regs.XR));
-    Regs.PC += 3;
+    CMP (M->Regs.AC, MemReadByte (M, Addr + M->Regs.XR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_DE (void)
+static void OPC_6502_DE (Machine* M)
 /* Opcode $DE: DEC abs,x */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (Addr) - 1;
-    MemWriteByte (Addr, Val);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, Addr) - 1;
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_E0 (void)
+static void OPC_6502_E0 (Machine* M)
 /* Opcode $E0: CPX #imm */
 {
-    Cycles = 2;
-    CMP (Regs.XR, MemReadByte (Regs.PC+1));
-    Regs.PC += 2;
+    M->Cycles = 2;
+    CMP (M->Regs.XR, MemReadByte (M, M->Regs.PC+1));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_E1 (void)
+static void OPC_6502_E1 (Machine* M)
 /* Opcode $E1: SBC (zp,x) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Addr = MemReadZPWord (ZPAddr);
-    SBC (MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Addr = MemReadZPWord (M, ZPAddr);
+    SBC (MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_E4 (void)
+static void OPC_6502_E4 (Machine* M)
 /* Opcode $E4: CPX zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    CMP (Regs.XR, MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    CMP (M->Regs.XR, MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_E5 (void)
+static void OPC_6502_E5 (Machine* M)
 /* Opcode $E5: SBC zp */
 {
     unsigned char ZPAddr;
-    Cycles = 3;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    SBC (MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 3;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    SBC (MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_E6 (void)
+static void OPC_6502_E6 (Machine* M)
 /* Opcode $E6: INC zp */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Val = MemReadByte (ZPAddr) + 1;
-    MemWriteByte (ZPAddr, Val);
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Val = MemReadByte (M, ZPAddr) + 1;
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_E8 (void)
+static void OPC_6502_E8 (Machine* M)
 /* Opcode $E8: INX */
 {
-    Cycles = 2;
-    Regs.XR = (Regs.XR + 1) & 0xFF;
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.XR = (M->Regs.XR + 1) & 0xFF;
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_E9 (void)
+static void OPC_6502_E9 (Machine* M)
 /* Opcode $E9: SBC #imm */
 {
-    Cycles = 2;
-    SBC (MemReadByte (Regs.PC+1));
-    Regs.PC += 2;
+    M->Cycles = 2;
+    SBC (MemReadByte (M, M->Regs.PC+1));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_EA (void)
+static void OPC_6502_EA (Machine* M)
 /* Opcode $EA: NOP */
 {
     /* This one is easy... */
-    Cycles = 2;
-    Regs.PC += 1;
+    M->Cycles = 2;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65C02_NOP11(void)
+static void OPC_65C02_NOP11(Machine* M)
 /* Opcode 'Illegal' 1 cycle NOP */
 {
-    Cycles = 1;
-    Regs.PC += 1;
+    M->Cycles = 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_65C02_NOP22 (void)
+static void OPC_65C02_NOP22 (Machine* M)
 /* Opcode 'Illegal' 2 byte 2 cycle NOP */
 {
-    Cycles = 2;
-    Regs.PC += 2;
+    M->Cycles = 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65C02_NOP24 (void)
+static void OPC_65C02_NOP24 (Machine* M)
 /* Opcode 'Illegal' 2 byte 4 cycle NOP */
 {
-    Cycles = 4;
-    Regs.PC += 2;
+    M->Cycles = 4;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65C02_NOP34 (void)
+static void OPC_65C02_NOP34 (Machine* M)
 /* Opcode 'Illegal' 3 byte 4 cycle NOP */
 {
-    Cycles = 4;
-    Regs.PC += 3;
+    M->Cycles = 4;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_EC (void)
+static void OPC_6502_EC (Machine* M)
 /* Opcode $EC: CPX abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr   = MemReadWord (Regs.PC+1);
-    CMP (Regs.XR, MemReadByte (Addr));
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr   = MemReadWord (M, M->Regs.PC+1);
+    CMP (M->Regs.XR, MemReadByte (M, Addr));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_ED (void)
+static void OPC_6502_ED (Machine* M)
 /* Opcode $ED: SBC abs */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    SBC (MemReadByte (Addr));
-    Regs.PC += 3;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    SBC (MemReadByte (M, Addr));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_EE (void)
+static void OPC_6502_EE (Machine* M)
 /* Opcode $EE: INC abs */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 6;
-    Addr = MemReadWord (Regs.PC+1);
-    Val = MemReadByte (Addr) + 1;
-    MemWriteByte (Addr, Val);
+    M->Cycles = 6;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    Val = MemReadByte (M, Addr) + 1;
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_F0 (void)
+static void OPC_6502_F0 (Machine* M)
 /* Opcode $F0: BEQ */
 {
     BRANCH (GET_ZF ());
@@ -2536,129 +2523,129 @@ static void OPC_6502_F0 (void)
 
 
 
-static void OPC_6502_F1 (void)
+static void OPC_6502_F1 (Machine* M)
 /* Opcode $F1: SBC (zp),y */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    SBC (MemReadByte (Addr + Regs.YR));
-    Regs.PC += 2;
+    SBC (MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_65SC02_F2 (void)
+static void OPC_65SC02_F2 (Machine* M)
 /* Opcode $F2: SBC (zp) */
 {
     unsigned char ZPAddr;
     unsigned Addr;
-    Cycles = 5;
-    ZPAddr = MemReadByte (Regs.PC+1);
-    Addr = MemReadZPWord (ZPAddr);
-    SBC (MemReadByte (Addr));
-    Regs.PC += 2;
+    M->Cycles = 5;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1);
+    Addr = MemReadZPWord (M, ZPAddr);
+    SBC (MemReadByte (M, Addr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_F5 (void)
+static void OPC_6502_F5 (Machine* M)
 /* Opcode $F5: SBC zp,x */
 {
     unsigned char ZPAddr;
-    Cycles = 4;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    SBC (MemReadByte (ZPAddr));
-    Regs.PC += 2;
+    M->Cycles = 4;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    SBC (MemReadByte (M, ZPAddr));
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_F6 (void)
+static void OPC_6502_F6 (Machine* M)
 /* Opcode $F6: INC zp,x */
 {
     unsigned char ZPAddr;
     unsigned char Val;
-    Cycles = 6;
-    ZPAddr = MemReadByte (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (ZPAddr) + 1;
-    MemWriteByte (ZPAddr, Val);
+    M->Cycles = 6;
+    ZPAddr = MemReadByte (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, ZPAddr) + 1;
+    MemWriteByte (M, ZPAddr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 2;
+    M->Regs.PC += 2;
 }
 
 
 
-static void OPC_6502_F8 (void)
+static void OPC_6502_F8 (Machine* M)
 /* Opcode $F8: SED */
 {
-    Cycles = 2;
+    M->Cycles = 2;
     SET_DF (1);
-    Regs.PC += 1;
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_F9 (void)
+static void OPC_6502_F9 (Machine* M)
 /* Opcode $F9: SBC abs,y */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.YR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.YR)) {
+        ++M->Cycles;
     }
-    SBC (MemReadByte (Addr + Regs.YR));
-    Regs.PC += 3;
+    SBC (MemReadByte (M, Addr + M->Regs.YR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_65SC02_FA (void)
+static void OPC_65SC02_FA (Machine* M)
 /* Opcode $7A: PLX */
 {
-    Cycles = 4;
-    Regs.XR = POP ();
-    TEST_ZF (Regs.XR);
-    TEST_SF (Regs.XR);
-    Regs.PC += 1;
+    M->Cycles = 4;
+    M->Regs.XR = POP ();
+    TEST_ZF (M->Regs.XR);
+    TEST_SF (M->Regs.XR);
+    M->Regs.PC += 1;
 }
 
 
 
-static void OPC_6502_FD (void)
+static void OPC_6502_FD (Machine* M)
 /* Opcode $FD: SBC abs,x */
 {
     unsigned Addr;
-    Cycles = 4;
-    Addr = MemReadWord (Regs.PC+1);
-    if (PAGE_CROSS (Addr, Regs.XR)) {
-        ++Cycles;
+    M->Cycles = 4;
+    Addr = MemReadWord (M, M->Regs.PC+1);
+    if (PAGE_CROSS (Addr, M->Regs.XR)) {
+        ++M->Cycles;
     }
-    SBC (MemReadByte (Addr + Regs.XR));
-    Regs.PC += 3;
+    SBC (MemReadByte (M, Addr + M->Regs.XR));
+    M->Regs.PC += 3;
 }
 
 
 
-static void OPC_6502_FE (void)
+static void OPC_6502_FE (Machine* M)
 /* Opcode $FE: INC abs,x */
 {
     unsigned Addr;
     unsigned char Val;
-    Cycles = 7;
-    Addr = MemReadWord (Regs.PC+1) + Regs.XR;
-    Val = MemReadByte (Addr) + 1;
-    MemWriteByte (Addr, Val);
+    M->Cycles = 7;
+    Addr = MemReadWord (M, M->Regs.PC+1) + M->Regs.XR;
+    Val = MemReadByte (M, Addr) + 1;
+    MemWriteByte (M, Addr, Val);
     TEST_ZF (Val);
     TEST_SF (Val);
-    Regs.PC += 3;
+    M->Regs.PC += 3;
 }
 
 
@@ -3204,91 +3191,225 @@ static const OPFunc* Handlers[2] = {OP6502Table, OP65C02Table};
 
 
 
-void IRQRequest (void)
+void IRQRequest (Machine* M)
 /* Generate an IRQ */
 {
     /* Remember the request */
-    HaveIRQRequest = 1;
+    M->HaveIRQRequest = 1;
 }
 
 
 
-void NMIRequest (void)
+void NMIRequest (Machine* M)
 /* Generate an NMI */
 {
     /* Remember the request */
-    HaveNMIRequest = 1;
+    M->HaveNMIRequest = 1;
 }
 
 
 
-void Reset (void)
+void Reset (Machine* M)
 /* Generate a CPU RESET */
 {
     /* Reset the CPU */
-    HaveIRQRequest = 0;
-    HaveNMIRequest = 0;
+    M->HaveIRQRequest = 0;
+    M->HaveNMIRequest = 0;
 
     /* Bits 5 and 4 aren't used, and always are 1! */
-    Regs.SR = 0x30;
-    Regs.PC = MemReadWord (0xFFFC);
+    M->Regs.SR = 0x30;
+    M->Regs.PC = MemReadWord (M, 0xFFFC);
 }
 
 
 
-unsigned ExecuteInsn (void)
+unsigned ExecuteInsn (Machine* M)
 /* Execute one CPU instruction */
 {
     /* If we have an NMI request, handle it */
-    if (HaveNMIRequest) {
+    if (M->HaveNMIRequest) {
 
-        HaveNMIRequest = 0;
+        M->HaveNMIRequest = 0;
         PUSH (PCH);
         PUSH (PCL);
-        PUSH (Regs.SR & ~BF);
+        PUSH (M->Regs.SR & ~BF);
         SET_IF (1);
-        if (CPU != CPU_6502)
+        if (M->CPU != CPU_6502)
         {
             SET_DF (0);
         }
-        Regs.PC = MemReadWord (0xFFFA);
-        Cycles = 7;
+        M->Regs.PC = MemReadWord (M, 0xFFFA);
+        M->Cycles = 7;
 
-    } else if (HaveIRQRequest && GET_IF () == 0) {
+    } else if (M->HaveIRQRequest && GET_IF () == 0) {
 
-        HaveIRQRequest = 0;
+        M->HaveIRQRequest = 0;
         PUSH (PCH);
         PUSH (PCL);
-        PUSH (Regs.SR & ~BF);
+        PUSH (M->Regs.SR & ~BF);
         SET_IF (1);
-        if (CPU != CPU_6502)
+        if (M->CPU != CPU_6502)
         {
             SET_DF (0);
         }
-        Regs.PC = MemReadWord (0xFFFE);
-        Cycles = 7;
+        M->Regs.PC = MemReadWord (M, 0xFFFE);
+        M->Cycles = 7;
 
     } else {
 
         /* Normal instruction - read the next opcode */
-        unsigned char OPC = MemReadByte (Regs.PC);
+        unsigned PC = M->Regs.PC;
+        unsigned char OPC;
+        M->InsnPC = PC;
+        OPC = MemFetchOpcode (M, PC);
 
         /* Execute it */
-        Handlers[CPU][OPC] ();
+        Handlers[M->CPU][OPC] (M);
+
+        /* Tell the profiler about it */
+        if (M->Profiler) {
+            ProfileInsn (M, PC, OPC, M->Cycles, &M->Regs);
+        }
     }
 
     /* Count cycles */
-    TotalCycles += Cycles;
+    M->TotalCycles += M->Cycles;
 
     /* Return the number of clock cycles needed by this insn */
-    return Cycles;
+    return M->Cycles;
+}
+
+
+
+static void LockstepInsn (Machine* M)
+/* Execute one instruction with both CPU cores and make sure they agree */
+{
+    CPURegs     Fast = M->Regs;
+    unsigned    FastCycles;
+    MemWrite    FastWrites[8];
+    unsigned    FastCount;
+    MemWrite    TableWrites[8];
+    unsigned    TableCount;
+    unsigned    PC = M->Regs.PC;
+    unsigned    I;
+
+    /* Let the table core handle interrupts */
+    if (M->HaveNMIRequest || (M->HaveIRQRequest && GET_IF () == 0)) {
+        ExecuteInsn (M);
+        return;
+    }
+
+    /* Run the fast core first, then undo its writes to memory */
+    MemLogStart (M);
+    FastCycles = FastStep (M, &Fast);
+    FastCount  = MemLogStop (M, FastWrites,
+                             sizeof (FastWrites) / sizeof (FastWrites[0]));
+    I = FastCount;
+    while (I > 0) {
+        --I;
+        MemWriteByte (M, FastWrites[I].Addr, FastWrites[I].Old);
+    }
+
+    /* Now run the table core on the same state */
+    MemLogStart (M);
+    ExecuteInsn (M);
+    TableCount = MemLogStop (M, TableWrites,
+                             sizeof (TableWrites) / sizeof (TableWrites[0]));
+
+    /* The fast core doesn't call the paravirtualization hooks in single step
+    ** mode, so we cannot compare the results of a call.
+    */
+    if (Fast.PC >= PARAVIRT_BASE) {
+        return;
+    }
+
+    /* Compare the results */
+    if (Fast.AC != (M->Regs.AC & 0xFF)      ||
+        Fast.XR != (M->Regs.XR & 0xFF)      ||
+        Fast.YR != (M->Regs.YR & 0xFF)      ||
+        Fast.SP != (M->Regs.SP & 0xFF)      ||
+        Fast.SR != M->Regs.SR               ||
+        Fast.PC != (M->Regs.PC & 0xFFFF)    ||
+        FastCycles != M->Cycles) {
+        MachineError (M, SIM65_ERROR,
+                      "CPU cores disagree after opcode $%02X at $%04X:\n"
+                      "  table: AC=$%02X XR=$%02X YR=$%02X SP=$%02X SR=$%02X PC=$%04X, %u cycles\n"
+                      "  fast:  AC=$%02X XR=$%02X YR=$%02X SP=$%02X SR=$%02X PC=$%04X, %u cycles",
+                      MemReadByte (M, PC), PC,
+                      M->Regs.AC, M->Regs.XR, M->Regs.YR, M->Regs.SP & 0xFF,
+                      M->Regs.SR, M->Regs.PC, M->Cycles,
+                      Fast.AC, Fast.XR, Fast.YR, Fast.SP, Fast.SR, Fast.PC,
+                      FastCycles);
+    }
+    if (FastCount != TableCount) {
+        MachineError (M, SIM65_ERROR,
+                      "CPU cores disagree after opcode $%02X at $%04X: "
+                      "%u writes to memory instead of %u",
+                      MemReadByte (M, PC), PC, FastCount, TableCount);
+    }
+    for (I = 0; I < FastCount; ++I) {
+        if (FastWrites[I].Addr != TableWrites[I].Addr ||
+            FastWrites[I].New  != TableWrites[I].New) {
+            MachineError (M, SIM65_ERROR,
+                          "CPU cores disagree after opcode $%02X at $%04X: "
+                          "Wrote $%02X to $%04X instead of $%02X to $%04X",
+                          MemReadByte (M, PC), PC,
+                          FastWrites[I].New, FastWrites[I].Addr,
+                          TableWrites[I].New, TableWrites[I].Addr);
+        }
+    }
+}
+
+
+
+void ExecuteInsns (Machine* M, unsigned long MaxCycles)
+/* Execute instructions with the CPU core selected for the machine until the
+** total number of clock cycles reaches MaxCycles. If MaxCycles is zero, run
+** forever.
+*/
+{
+    unsigned long Limit = MaxCycles? MaxCycles : ULONG_MAX;
+
+    while (M->TotalCycles < Limit) {
+
+        /* Only the table core calls the memory hooks */
+        if (M->HookCount) {
+            ExecuteInsn (M);
+            continue;
+        }
+
+        switch (M->Core) {
+
+            case CORE_FAST:
+            case CORE_TRACE:
+                /* The fast core knows nothing about interrupts. Since
+                ** requests can only come from the paravirtualization hooks,
+                ** and the fast core returns after calling one, checking
+                ** here is enough.
+                */
+                if (M->HaveNMIRequest || (M->HaveIRQRequest && GET_IF () == 0)) {
+                    ExecuteInsn (M);
+                } else {
+                    FastRun (M, Limit);
+                }
+                break;
+
+            case CORE_LOCKSTEP:
+                LockstepInsn (M);
+                break;
+
+            default:
+                ExecuteInsn (M);
+                break;
+        }
+    }
 }
 
 
 
-unsigned long GetCycles (void)
+unsigned long GetCycles (const Machine* M)
 /* Return the total number of cycles executed */
 {
     /* Return the total number of cycles */
-    return TotalCycles;
+    return M->TotalCycles;
 }
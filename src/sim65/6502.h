@@ -50,8 +50,16 @@ typedef enum CPUType {
     CPU_65C02
 } CPUType;
 
-/* Current CPU */
-extern CPUType CPU;
+/* CPU cores */
+typedef enum CPUCore {
+    CORE_TABLE,                 /* Opcode handler tables */
+    CORE_FAST,                  /* Predecoding core, see fastcore.c */
+    CORE_TRACE,                 /* Predecoding core with superinstructions */
+    CORE_LOCKSTEP               /* Both of the above, compared */
+} CPUCore;
+
+/* A simulated machine, see machine.h */
+typedef struct Machine Machine;
 
 /* 6502 CPU registers */
 typedef struct CPURegs CPURegs;
@@ -82,25 +90,29 @@ struct CPURegs {
 
 
 
-void Reset (void);
+void Reset (Machine* M);
 /* Generate a CPU RESET */
 
-void IRQRequest (void);
+void IRQRequest (Machine* M);
 /* Generate an IRQ */
 
-void NMIRequest (void);
+void NMIRequest (Machine* M);
 /* Generate an NMI */
 
-unsigned ExecuteInsn (void);
+unsigned ExecuteInsn (Machine* M);
 /* Execute one CPU instruction. Return the number of clock cycles for the
 ** executed instruction.
 */
 
-unsigned long GetCycles (void);
+void ExecuteInsns (Machine* M, unsigned long MaxCycles);
+/* Execute instructions with the CPU core selected for the machine until the
+** total number of clock cycles reaches MaxCycles. If MaxCycles is zero, run
+** forever.
+*/
+
+unsigned long GetCycles (const Machine* M);
 /* Return the total number of clock cycles executed */
 
-extern int PrintCycles;
-/* flag to print cycles at program termination */
 
 
 /* End of 6502.h */
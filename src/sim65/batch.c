@@ -0,0 +1,436 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  batch.c                                  */
+/*                                                                           */
+/*                       Run many programs in parallel                       */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* common */
+#include "coll.h"
+#include "strbuf.h"
+#include "thread.h"
+#include "xmalloc.h"
+
+/* sim65 */
+#include "batch.h"
+#include "error.h"
+#include "machine.h"
+#include "paravirt.h"
+#include "profile.h"
+#include "snapshot.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Result of running one program */
+typedef struct BatchResult BatchResult;
+struct BatchResult {
+    char*               Name;           /* Name of the program file */
+    unsigned            ArgCount;       /* Number of arguments, name first */
+    char**              ArgVec;         /* Program arguments */
+    unsigned            Number;         /* Number used for the profile name */
+    int                 ExitCode;       /* Exit code of the program */
+    unsigned long       Cycles;         /* Cycles executed */
+    char*               Msg;            /* Error message or NULL */
+};
+
+/* Data shared by all threads */
+typedef struct Batch Batch;
+struct Batch {
+    BatchResult*        Results;        /* One entry per program */
+    unsigned            Count;          /* Number of programs */
+    volatile unsigned   Next;           /* Number of programs started */
+    CPUCore             Core;           /* CPU core to use */
+    unsigned long       MaxCycles;      /* Cycle limit for each program */
+    Snapshot*           Snap;           /* Start state for forks or NULL */
+    const char*         ProfileFile;    /* Base name for profiles or NULL */
+    const char*         DbgInfoFile;    /* Debug info for profiles or NULL */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static void RunWithOutput (const Batch* B, BatchResult* R, Machine* M)
+/* Run or resume the program on machine M. The program gets no input, and its
+** output goes to a file.
+*/
+{
+    StrBuf OutName = STATIC_STRBUF_INITIALIZER;
+    FILE*  Out;
+
+    SB_CopyStr (&OutName, R->Name);
+    SB_AppendStr (&OutName, ".out");
+    SB_Terminate (&OutName);
+    Out = fopen (SB_GetConstBuf (&OutName), "wb");
+    if (Out == 0) {
+        SB_Printf (&M->Msg, "Cannot create '%s': %s",
+                   SB_GetConstBuf (&OutName), strerror (errno));
+        R->ExitCode = SIM65_ERROR;
+    } else {
+        ParaVirtSetFile (M, 0, -1);
+        ParaVirtSetFile (M, 1, fileno (Out));
+        ParaVirtSetFile (M, 2, fileno (Out));
+
+        /* Run it */
+        if (B->ProfileFile) {
+            ProfileStart (M);
+        }
+        if (M->Paused) {
+            R->ExitCode = ResumeMachine (M, B->MaxCycles);
+        } else {
+            R->ExitCode = RunMachine (M, B->MaxCycles);
+        }
+        fclose (Out);
+
+        /* Write the profile. If this fails, the run fails. */
+        if (B->ProfileFile) {
+            StrBuf Msg = STATIC_STRBUF_INITIALIZER;
+            SB_Printf (&OutName, "%s.%u", B->ProfileFile, R->Number);
+            if (!ProfileWrite (M, SB_GetConstBuf (&OutName), B->DbgInfoFile, &Msg)) {
+                if (SB_IsEmpty (&M->Msg)) {
+                    SB_Copy (&M->Msg, &Msg);
+                    SB_Terminate (&M->Msg);
+                }
+                R->ExitCode = SIM65_ERROR;
+            }
+            SB_Done (&Msg);
+        }
+    }
+
+    /* Remember the results */
+    R->Cycles = GetCycles (M);
+    R->Msg    = SB_IsEmpty (&M->Msg)? 0 : xstrdup (SB_GetConstBuf (&M->Msg));
+
+    SB_Done (&OutName);
+}
+
+
+
+static void RunOne (const Batch* B, BatchResult* R)
+/* Run one program of the batch */
+{
+    /* Create a new machine and load the program */
+    Machine* M = NewMachine (B->Core);
+    if (!LoadProgram (M, R->Name, R->ArgCount, R->ArgVec)) {
+        R->ExitCode = SIM65_ERROR;
+        R->Msg      = xstrdup (SB_GetConstBuf (&M->Msg));
+    } else {
+        RunWithOutput (B, R, M);
+    }
+
+    /* Cleanup */
+    FreeMachine (M);
+}
+
+
+
+static void BatchThread (void* Data)
+/* Thread function: Run programs until none is left */
+{
+    Batch* B = Data;
+    unsigned I;
+
+    while ((I = AtomicInc (&B->Next) - 1) < B->Count) {
+        RunOne (B, B->Results + I);
+    }
+}
+
+
+
+static void ForkThread (void* Data)
+/* Thread function: Run forks of the snapshot until none is left. Each thread
+** uses one machine, and restores the snapshot into it for each run, so the
+** predecoded instructions of the fast core are kept.
+*/
+{
+    Batch* B = Data;
+    Machine* M = 0;
+    unsigned I;
+
+    while ((I = AtomicInc (&B->Next) - 1) < B->Count) {
+        BatchResult* R = B->Results + I;
+        if (M == 0) {
+            M = ForkMachine (B->Snap, B->Core);
+        } else {
+            RestoreSnapshot (M, B->Snap);
+        }
+        M->ArgCount = R->ArgCount;
+        M->ArgVec   = R->ArgVec;
+        RunWithOutput (B, R, M);
+    }
+
+    if (M) {
+        FreeMachine (M);
+    }
+}
+
+
+
+static unsigned RunThreads (Batch* B, void (*Func) (void*), unsigned Jobs)
+/* Run the programs of the batch with up to Jobs threads executing Func. Print
+** the results and return the number of programs that failed.
+*/
+{
+    Thread**    Threads;
+    unsigned    Failed;
+    unsigned    I;
+
+    /* Don't start more threads than there are programs */
+    if (Jobs > B->Count) {
+        Jobs = B->Count;
+    }
+
+    /* Start the threads and wait until they're done */
+    Threads = xmalloc (Jobs * sizeof (Thread*));
+    for (I = 0; I < Jobs; ++I) {
+        Threads[I] = NewThread (Func, B);
+    }
+    for (I = 0; I < Jobs; ++I) {
+        JoinThread (Threads[I]);
+    }
+    xfree (Threads);
+
+    /* Print the results in the order of the command line */
+    Failed = 0;
+    for (I = 0; I < B->Count; ++I) {
+        const BatchResult* R = B->Results + I;
+        printf ("%s: exit code %d, %lu cycles\n", R->Name, R->ExitCode, R->Cycles);
+        if (R->Msg) {
+            printf ("%s: %s\n", R->Name, R->Msg);
+            xfree (R->Msg);
+        }
+        if (R->ExitCode != 0) {
+            ++Failed;
+        }
+    }
+    printf ("%u of %u programs failed\n", Failed, B->Count);
+
+    return Failed;
+}
+
+
+
+int RunBatch (unsigned Count, char** Files, CPUCore Core,
+              unsigned long MaxCycles, unsigned Jobs, const char* ProfileFile)
+/* Run Count program files, each one on its own machine, using up to Jobs
+** threads. The output of a program is written to a file with ".out" appended
+** to the program name. If ProfileFile is not NULL, the profile of the Nth
+** program is written to a file with ".N" appended to ProfileFile. When all
+** programs have terminated, print their exit codes and cycle counts. Return
+** EXIT_SUCCESS if all programs returned zero, EXIT_FAILURE otherwise.
+*/
+{
+    Batch       B;
+    unsigned    Failed;
+    unsigned    I;
+
+    /* Setup the shared data */
+    B.Results   = xmalloc (Count * sizeof (BatchResult));
+    B.Count     = Count;
+    B.Next      = 0;
+    B.Core      = Core;
+    B.MaxCycles = MaxCycles;
+    B.Snap      = 0;
+    B.ProfileFile = ProfileFile;
+    B.DbgInfoFile = 0;
+    for (I = 0; I < Count; ++I) {
+        B.Results[I].Name     = Files[I];
+        B.Results[I].ArgCount = 1;
+        B.Results[I].ArgVec   = &B.Results[I].Name;
+        B.Results[I].Number   = I + 1;
+        B.Results[I].ExitCode = 0;
+        B.Results[I].Cycles   = 0;
+        B.Results[I].Msg      = 0;
+    }
+
+    /* Run the programs */
+    Failed = RunThreads (&B, BatchThread, Jobs);
+
+    /* Cleanup */
+    xfree (B.Results);
+
+    return Failed? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+
+static int ReadCase (FILE* F, Collection* Args)
+/* Read one line of the case file and add its words to Args. Return false at
+** the end of the file.
+*/
+{
+    StrBuf   Word  = STATIC_STRBUF_INITIALIZER;
+    unsigned Count = CollCount (Args);
+    int C;
+
+    while ((C = getc (F)) != EOF && C != '\n') {
+        if (C == ' ' || C == '\t' || C == '\r') {
+            if (SB_NotEmpty (&Word)) {
+                SB_Terminate (&Word);
+                CollAppend (Args, xstrdup (SB_GetConstBuf (&Word)));
+                SB_Clear (&Word);
+            }
+        } else {
+            SB_AppendChar (&Word, C);
+        }
+    }
+    if (SB_NotEmpty (&Word)) {
+        SB_Terminate (&Word);
+        CollAppend (Args, xstrdup (SB_GetConstBuf (&Word)));
+    }
+    SB_Done (&Word);
+
+    return C != EOF || CollCount (Args) > Count;
+}
+
+
+
+int RunForks (const char* Program, const char* CaseFile, CPUCore Core,
+              unsigned long MaxCycles, unsigned Jobs, const char* ProfileFile,
+              const char* DbgInfoFile)
+/* Load the program and run it until it asks for its arguments. Take a
+** snapshot of the machine at this point, and then run the program from the
+** snapshot once for each line of CaseFile, using the words on the line as
+** arguments. Up to Jobs threads are used. The output of the run for line N
+** goes to a file with ".N.out" appended to the program name. If ProfileFile
+** is not NULL, the profile of the run goes to a file with ".N" appended to
+** ProfileFile, using the debug info from DbgInfoFile if that is not NULL.
+** Results are printed as with RunBatch, and so is the return value.
+*/
+{
+    Batch       B;
+    Collection  Cases = STATIC_COLLECTION_INITIALIZER;
+    Collection  Args  = STATIC_COLLECTION_INITIALIZER;
+    StrBuf      Name  = STATIC_STRBUF_INITIALIZER;
+    Machine*    M;
+    FILE*       F;
+    unsigned    Line;
+    unsigned    Failed;
+    unsigned    I, J;
+
+    /* Run the program up to the point where it reads its arguments */
+    M = NewMachine (Core);
+    M->PauseAtArgs = 1;
+    if (LoadProgram (M, Program, 0, 0)) {
+        RunMachine (M, MaxCycles);
+    }
+    if (!M->Paused) {
+        if (SB_IsEmpty (&M->Msg)) {
+            SB_CopyStr (&M->Msg, "Program exited before reading its arguments");
+            SB_Terminate (&M->Msg);
+        }
+        printf ("%s: %s\n", Program, SB_GetConstBuf (&M->Msg));
+        FreeMachine (M);
+        return EXIT_FAILURE;
+    }
+    B.Snap = TakeSnapshot (M);
+    FreeMachine (M);
+
+    /* Read the cases, one per line. Empty lines are skipped. */
+    F = fopen (CaseFile, "r");
+    if (F == 0) {
+        printf ("Cannot open '%s': %s\n", CaseFile, strerror (errno));
+        FreeSnapshot (B.Snap);
+        return EXIT_FAILURE;
+    }
+    Line = 0;
+    CollAppend (&Args, xstrdup (Program));
+    while (ReadCase (F, &Args)) {
+        ++Line;
+        if (CollCount (&Args) > 1) {
+            BatchResult* R = xmalloc (sizeof (BatchResult));
+            SB_Printf (&Name, "%s.%u", Program, Line);
+            R->Name     = xstrdup (SB_GetConstBuf (&Name));
+            R->ArgCount = CollCount (&Args);
+            R->ArgVec   = xmalloc (R->ArgCount * sizeof (char*));
+            R->Number   = Line;
+            for (J = 0; J < R->ArgCount; ++J) {
+                R->ArgVec[J] = CollAt (&Args, J);
+            }
+            R->ExitCode = 0;
+            R->Cycles   = 0;
+            R->Msg      = 0;
+            CollAppend (&Cases, R);
+            CollDeleteAll (&Args);
+            CollAppend (&Args, xstrdup (Program));
+        }
+    }
+    fclose (F);
+    xfree (CollAt (&Args, 0));
+    DoneCollection (&Args);
+    SB_Done (&Name);
+
+    /* Setup the shared data */
+    B.Count     = CollCount (&Cases);
+    B.Results   = xmalloc (B.Count * sizeof (BatchResult));
+    B.Next      = 0;
+    B.Core      = Core;
+    B.MaxCycles = MaxCycles;
+    B.ProfileFile = ProfileFile;
+    B.DbgInfoFile = DbgInfoFile;
+    for (I = 0; I < B.Count; ++I) {
+        BatchResult* R = CollAt (&Cases, I);
+        B.Results[I] = *R;
+        xfree (R);
+    }
+    DoneCollection (&Cases);
+
+    /* Run the cases */
+    Failed = RunThreads (&B, ForkThread, Jobs);
+
+    /* Cleanup */
+    for (I = 0; I < B.Count; ++I) {
+        BatchResult* R = B.Results + I;
+        for (J = 0; J < R->ArgCount; ++J) {
+            xfree (R->ArgVec[J]);
+        }
+        xfree (R->ArgVec);
+        xfree (R->Name);
+    }
+    xfree (B.Results);
+    FreeSnapshot (B.Snap);
+
+    return Failed? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  batch.h                                  */
+/*                                                                           */
+/*                       Run many programs in parallel                       */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef BATCH_H
+#define BATCH_H
+
+
+
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+int RunBatch (unsigned Count, char** Files, CPUCore Core,
+              unsigned long MaxCycles, unsigned Jobs, const char* ProfileFile);
+/* Run Count program files, each one on its own machine, using up to Jobs
+** threads. The output of a program is written to a file with ".out" appended
+** to the program name. If ProfileFile is not NULL, the profile of the Nth
+** program is written to a file with ".N" appended to ProfileFile. When all
+** programs have terminated, print their exit codes and cycle counts. Return
+** EXIT_SUCCESS if all programs returned zero, EXIT_FAILURE otherwise.
+*/
+
+int RunForks (const char* Program, const char* CaseFile, CPUCore Core,
+              unsigned long MaxCycles, unsigned Jobs, const char* ProfileFile,
+              const char* DbgInfoFile);
+/* Load the program and run it until it asks for its arguments. Take a
+** snapshot of the machine at this point, and then run the program from the
+** snapshot once for each line of CaseFile, using the words on the line as
+** arguments. Up to Jobs threads are used. The output of the run for line N
+** goes to a file with ".N.out" appended to the program name. If ProfileFile
+** is not NULL, the profile of the run goes to a file with ".N" appended to
+** ProfileFile, using the debug info from DbgInfoFile if that is not NULL.
+** Results are printed as with RunBatch, and so is the return value.
+*/
+
+
+
+/* End of batch.h */
+
+#endif
@@ -0,0 +1,2801 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 fastcore.c                                */
+/*                                                                           */
+/*                     Predecoding CPU core for the 6502                     */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+/* The fast core executes the same instruction set as the opcode handlers in
+** 6502.c, with the same cycle counts, but is organized for speed:
+**
+**   - Instructions are decoded once and kept in a cache that is indexed by
+**     address. Writes to memory pages that contain decoded instructions go
+**     through MemWatchedWrite, which invalidates the affected entries.
+**   - Dispatch is done by jumping directly from one handler to the next
+**     using computed gotos if the compiler supports them, and a switch
+**     statement otherwise.
+**   - The registers live in local variables while executing. The N and Z
+**     flags aren't computed when an instruction changes them. Instead, the
+**     values they depend on are remembered, and the status register is
+**     assembled only when it is actually needed.
+**   - The trace core ("sim65 --core trace") additionally counts the calls of
+**     each subroutine. When one of the hot helpers of the cc65 runtime library
+**     is called often, it is replaced by a superinstruction that does the
+**     work of the complete routine, including the RTS, in C. The cycles are
+**     counted exactly like for the single instructions, including taken
+**     branches and page crossings.
+**
+** Any change to the opcode handlers in 6502.c must be mirrored here. Use
+** "sim65 --core lockstep" to check that both cores behave identically.
+*/
+
+
+
+#include <string.h>
+
+/* common */
+#include "attrib.h"
+#include "xmalloc.h"
+
+/* sim65 */
+#include "6502.h"
+#include "error.h"
+#include "fastcore.h"
+#include "machine.h"
+#include "memory.h"
+#include "paravirt.h"
+#include "profile.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Use computed gotos for dispatching if we can */
+#if defined(__GNUC__)
+#  define FAST_THREADED 1
+#else
+#  define FAST_THREADED 1
+#endif
+
+/* Operations. These correspond to the opcode handlers in 6502.c */
+enum {
+    OP_DECODE,
+    OP_ILLEGAL,
+    OP_6502_00,
+    OP_6502_01,
+    OP_6502_05,
+    OP_6502_06,
+    OP_6502_08,
+    OP_6502_09,
+    OP_6502_0A,
+    OP_6502_0D,
+    OP_6502_0E,
+    OP_6502_10,
+    OP_6502_11,
+    OP_6502_15,
+    OP_6502_16,
+    OP_6502_18,
+    OP_6502_19,
+    OP_6502_1D,
+    OP_6502_1E,
+    OP_6502_20,
+    OP_6502_21,
+    OP_6502_24,
+    OP_6502_25,
+    OP_6502_26,
+    OP_6502_28,
+    OP_6502_29,
+    OP_6502_2A,
+    OP_6502_2C,
+    OP_6502_2D,
+    OP_6502_2E,
+    OP_6502_30,
+    OP_6502_31,
+    OP_6502_35,
+    OP_6502_36,
+    OP_6502_38,
+    OP_6502_39,
+    OP_6502_3D,
+    OP_6502_3E,
+    OP_6502_40,
+    OP_6502_41,
+    OP_6502_45,
+    OP_6502_46,
+    OP_6502_48,
+    OP_6502_49,
+    OP_6502_4A,
+    OP_6502_4C,
+    OP_6502_4D,
+    OP_6502_4E,
+    OP_6502_50,
+    OP_6502_51,
+    OP_6502_55,
+    OP_6502_56,
+    OP_6502_58,
+    OP_6502_59,
+    OP_6502_5D,
+    OP_6502_5E,
+    OP_6502_60,
+    OP_6502_61,
+    OP_6502_65,
+    OP_6502_66,
+    OP_6502_68,
+    OP_6502_69,
+    OP_6502_6A,
+    OP_6502_6C,
+    OP_6502_6D,
+    OP_6502_6E,
+    OP_6502_70,
+    OP_6502_71,
+    OP_6502_75,
+    OP_6502_76,
+    OP_6502_78,
+    OP_6502_79,
+    OP_6502_7D,
+    OP_6502_7E,
+    OP_6502_81,
+    OP_6502_84,
+    OP_6502_85,
+    OP_6502_86,
+    OP_6502_88,
+    OP_6502_8A,
+    OP_6502_8C,
+    OP_6502_8D,
+    OP_6502_8E,
+    OP_6502_90,
+    OP_6502_91,
+    OP_6502_94,
+    OP_6502_95,
+    OP_6502_96,
+    OP_6502_98,
+    OP_6502_99,
+    OP_6502_9A,
+    OP_6502_9D,
+    OP_6502_A0,
+    OP_6502_A1,
+    OP_6502_A2,
+    OP_6502_A4,
+    OP_6502_A5,
+    OP_6502_A6,
+    OP_6502_A8,
+    OP_6502_A9,
+    OP_6502_AA,
+    OP_6502_AC,
+    OP_6502_AD,
+    OP_6502_AE,
+    OP_6502_B0,
+    OP_6502_B1,
+    OP_6502_B4,
+    OP_6502_B5,
+    OP_6502_B6,
+    OP_6502_B8,
+    OP_6502_B9,
+    OP_6502_BA,
+    OP_6502_BC,
+    OP_6502_BD,
+    OP_6502_BE,
+    OP_6502_C0,
+    OP_6502_C1,
+    OP_6502_C4,
+    OP_6502_C5,
+    OP_6502_C6,
+    OP_6502_C8,
+    OP_6502_C9,
+    OP_6502_CA,
+    OP_6502_CC,
+    OP_6502_CD,
+    OP_6502_CE,
+    OP_6502_D0,
+    OP_6502_D1,
+    OP_6502_D5,
+    OP_6502_D6,
+    OP_6502_D8,
+    OP_6502_D9,
+    OP_6502_DD,
+    OP_6502_DE,
+    OP_6502_E0,
+    OP_6502_E1,
+    OP_6502_E4,
+    OP_6502_E5,
+    OP_6502_E6,
+    OP_6502_E8,
+    OP_6502_E9,
+    OP_6502_EA,
+    OP_6502_EC,
+    OP_6502_ED,
+    OP_6502_EE,
+    OP_6502_F0,
+    OP_6502_F1,
+    OP_6502_F5,
+    OP_6502_F6,
+    OP_6502_F8,
+    OP_6502_F9,
+    OP_6502_FD,
+    OP_6502_FE,
+    OP_65C02_NOP22,
+    OP_65C02_NOP11,
+    OP_65SC02_04,
+    OP_65SC02_0C,
+    OP_65SC02_12,
+    OP_65SC02_14,
+    OP_65SC02_1A,
+    OP_65SC02_1C,
+    OP_65SC02_32,
+    OP_65SC02_34,
+    OP_65SC02_3A,
+    OP_65SC02_3C,
+    OP_65C02_44,
+    OP_65SC02_52,
+    OP_65C02_NOP24,
+    OP_65SC02_5A,
+    OP_65C02_5C,
+    OP_65SC02_64,
+    OP_65C02_6C,
+    OP_65SC02_72,
+    OP_65SC02_74,
+    OP_65SC02_7A,
+    OP_65SC02_7C,
+    OP_65SC02_80,
+    OP_65SC02_89,
+    OP_65SC02_92,
+    OP_65SC02_9C,
+    OP_65SC02_9E,
+    OP_65SC02_B2,
+    OP_65SC02_D2,
+    OP_65SC02_DA,
+    OP_65C02_NOP34,
+    OP_65SC02_F2,
+    OP_65SC02_FA,
+
+    /* Superinstructions for runtime helpers, in the order of Helpers */
+    OP_FUSED_PUSHA,
+    OP_FUSED_PUSHAX,
+    OP_FUSED_PUSHWYSP,
+    OP_FUSED_LDAXYSP,
+    OP_FUSED_POPAX,
+    OP_FUSED_POPAX_C02,
+    OP_FUSED_INCSP1,
+    OP_FUSED_INCSP2,
+    OP_FUSED_INCAX1,
+    OP_FUSED_INCAX1_C02,
+    OP_FUSED_TOSADDAX,
+    OP_FUSED_TOSADDAX_C02,
+    OP_FUSED_TOSICMP,
+    OP_COUNT
+};
+
+/* The first superinstruction */
+#define OP_FUSED_FIRST  OP_FUSED_PUSHA
+
+/* A predecoded instruction */
+typedef struct FastInsn FastInsn;
+struct FastInsn {
+    unsigned char       Op;             /* Operation, OP_DECODE if invalid */
+    unsigned char       Opc;            /* The opcode byte */
+    unsigned short      Operand;        /* The two bytes following the opcode */
+};
+
+/* Number of entries in the instruction cache of a machine. It is indexed by
+** address, and all entries start out with OP_DECODE, so pages that never
+** contain code are never touched.
+*/
+#define CACHE_SIZE      0x10000
+
+/* Operations for the 6502 opcodes */
+static const unsigned char Ops6502[256] = {
+    OP_6502_00, OP_6502_01, OP_ILLEGAL, OP_ILLEGAL,                     /* $00 */
+    OP_ILLEGAL, OP_6502_05, OP_6502_06, OP_ILLEGAL,                     /* $04 */
+    OP_6502_08, OP_6502_09, OP_6502_0A, OP_ILLEGAL,                     /* $08 */
+    OP_ILLEGAL, OP_6502_0D, OP_6502_0E, OP_ILLEGAL,                     /* $0C */
+    OP_6502_10, OP_6502_11, OP_ILLEGAL, OP_ILLEGAL,                     /* $10 */
+    OP_ILLEGAL, OP_6502_15, OP_6502_16, OP_ILLEGAL,                     /* $14 */
+    OP_6502_18, OP_6502_19, OP_ILLEGAL, OP_ILLEGAL,                     /* $18 */
+    OP_ILLEGAL, OP_6502_1D, OP_6502_1E, OP_ILLEGAL,                     /* $1C */
+    OP_6502_20, OP_6502_21, OP_ILLEGAL, OP_ILLEGAL,                     /* $20 */
+    OP_6502_24, OP_6502_25, OP_6502_26, OP_ILLEGAL,                     /* $24 */
+    OP_6502_28, OP_6502_29, OP_6502_2A, OP_ILLEGAL,                     /* $28 */
+    OP_6502_2C, OP_6502_2D, OP_6502_2E, OP_ILLEGAL,                     /* $2C */
+    OP_6502_30, OP_6502_31, OP_ILLEGAL, OP_ILLEGAL,                     /* $30 */
+    OP_ILLEGAL, OP_6502_35, OP_6502_36, OP_ILLEGAL,                     /* $34 */
+    OP_6502_38, OP_6502_39, OP_ILLEGAL, OP_ILLEGAL,                     /* $38 */
+    OP_ILLEGAL, OP_6502_3D, OP_6502_3E, OP_ILLEGAL,                     /* $3C */
+    OP_6502_40, OP_6502_41, OP_ILLEGAL, OP_ILLEGAL,                     /* $40 */
+    OP_ILLEGAL, OP_6502_45, OP_6502_46, OP_ILLEGAL,                     /* $44 */
+    OP_6502_48, OP_6502_49, OP_6502_4A, OP_ILLEGAL,                     /* $48 */
+    OP_6502_4C, OP_6502_4D, OP_6502_4E, OP_ILLEGAL,                     /* $4C */
+    OP_6502_50, OP_6502_51, OP_ILLEGAL, OP_ILLEGAL,                     /* $50 */
+    OP_ILLEGAL, OP_6502_55, OP_6502_56, OP_ILLEGAL,                     /* $54 */
+    OP_6502_58, OP_6502_59, OP_ILLEGAL, OP_ILLEGAL,                     /* $58 */
+    OP_ILLEGAL, OP_6502_5D, OP_6502_5E, OP_ILLEGAL,                     /* $5C */
+    OP_6502_60, OP_6502_61, OP_ILLEGAL, OP_ILLEGAL,                     /* $60 */
+    OP_ILLEGAL, OP_6502_65, OP_6502_66, OP_ILLEGAL,                     /* $64 */
+    OP_6502_68, OP_6502_69, OP_6502_6A, OP_ILLEGAL,                     /* $68 */
+    OP_6502_6C, OP_6502_6D, OP_6502_6E, OP_ILLEGAL,                     /* $6C */
+    OP_6502_70, OP_6502_71, OP_ILLEGAL, OP_ILLEGAL,                     /* $70 */
+    OP_ILLEGAL, OP_6502_75, OP_6502_76, OP_ILLEGAL,                     /* $74 */
+    OP_6502_78, OP_6502_79, OP_ILLEGAL, OP_ILLEGAL,                     /* $78 */
+    OP_ILLEGAL, OP_6502_7D, OP_6502_7E, OP_ILLEGAL,                     /* $7C */
+    OP_ILLEGAL, OP_6502_81, OP_ILLEGAL, OP_ILLEGAL,                     /* $80 */
+    OP_6502_84, OP_6502_85, OP_6502_86, OP_ILLEGAL,                     /* $84 */
+    OP_6502_88, OP_ILLEGAL, OP_6502_8A, OP_ILLEGAL,                     /* $88 */
+    OP_6502_8C, OP_6502_8D, OP_6502_8E, OP_ILLEGAL,                     /* $8C */
+    OP_6502_90, OP_6502_91, OP_ILLEGAL, OP_ILLEGAL,                     /* $90 */
+    OP_6502_94, OP_6502_95, OP_6502_96, OP_ILLEGAL,                     /* $94 */
+    OP_6502_98, OP_6502_99, OP_6502_9A, OP_ILLEGAL,                     /* $98 */
+    OP_ILLEGAL, OP_6502_9D, OP_ILLEGAL, OP_ILLEGAL,                     /* $9C */
+    OP_6502_A0, OP_6502_A1, OP_6502_A2, OP_ILLEGAL,                     /* $A0 */
+    OP_6502_A4, OP_6502_A5, OP_6502_A6, OP_ILLEGAL,                     /* $A4 */
+    OP_6502_A8, OP_6502_A9, OP_6502_AA, OP_ILLEGAL,                     /* $A8 */
+    OP_6502_AC, OP_6502_AD, OP_6502_AE, OP_ILLEGAL,                     /* $AC */
+    OP_6502_B0, OP_6502_B1, OP_ILLEGAL, OP_ILLEGAL,                     /* $B0 */
+    OP_6502_B4, OP_6502_B5, OP_6502_B6, OP_ILLEGAL,                     /* $B4 */
+    OP_6502_B8, OP_6502_B9, OP_6502_BA, OP_ILLEGAL,                     /* $B8 */
+    OP_6502_BC, OP_6502_BD, OP_6502_BE, OP_ILLEGAL,                     /* $BC */
+    OP_6502_C0, OP_6502_C1, OP_ILLEGAL, OP_ILLEGAL,                     /* $C0 */
+    OP_6502_C4, OP_6502_C5, OP_6502_C6, OP_ILLEGAL,                     /* $C4 */
+    OP_6502_C8, OP_6502_C9, OP_6502_CA, OP_ILLEGAL,                     /* $C8 */
+    OP_6502_CC, OP_6502_CD, OP_6502_CE, OP_ILLEGAL,                     /* $CC */
+    OP_6502_D0, OP_6502_D1, OP_ILLEGAL, OP_ILLEGAL,                     /* $D0 */
+    OP_ILLEGAL, OP_6502_D5, OP_6502_D6, OP_ILLEGAL,                     /* $D4 */
+    OP_6502_D8, OP_6502_D9, OP_ILLEGAL, OP_ILLEGAL,                     /* $D8 */
+    OP_ILLEGAL, OP_6502_DD, OP_6502_DE, OP_ILLEGAL,                     /* $DC */
+    OP_6502_E0, OP_6502_E1, OP_ILLEGAL, OP_ILLEGAL,                     /* $E0 */
+    OP_6502_E4, OP_6502_E5, OP_6502_E6, OP_ILLEGAL,                     /* $E4 */
+    OP_6502_E8, OP_6502_E9, OP_6502_EA, OP_ILLEGAL,                     /* $E8 */
+    OP_6502_EC, OP_6502_ED, OP_6502_EE, OP_ILLEGAL,                     /* $EC */
+    OP_6502_F0, OP_6502_F1, OP_ILLEGAL, OP_ILLEGAL,                     /* $F0 */
+    OP_ILLEGAL, OP_6502_F5, OP_6502_F6, OP_ILLEGAL,                     /* $F4 */
+    OP_6502_F8, OP_6502_F9, OP_ILLEGAL, OP_ILLEGAL,                     /* $F8 */
+    OP_ILLEGAL, OP_6502_FD, OP_6502_FE, OP_ILLEGAL,                     /* $FC */
+};
+
+/* Operations for the 65C02 opcodes */
+static const unsigned char Ops65C02[256] = {
+    OP_6502_00, OP_6502_01, OP_65C02_NOP22, OP_65C02_NOP11,             /* $00 */
+    OP_65SC02_04, OP_6502_05, OP_6502_06, OP_ILLEGAL,                   /* $04 */
+    OP_6502_08, OP_6502_09, OP_6502_0A, OP_65C02_NOP11,                 /* $08 */
+    OP_65SC02_0C, OP_6502_0D, OP_6502_0E, OP_ILLEGAL,                   /* $0C */
+    OP_6502_10, OP_6502_11, OP_65SC02_12, OP_65C02_NOP11,               /* $10 */
+    OP_65SC02_14, OP_6502_15, OP_6502_16, OP_ILLEGAL,                   /* $14 */
+    OP_6502_18, OP_6502_19, OP_65SC02_1A, OP_65C02_NOP11,               /* $18 */
+    OP_65SC02_1C, OP_6502_1D, OP_6502_1E, OP_ILLEGAL,                   /* $1C */
+    OP_6502_20, OP_6502_21, OP_65C02_NOP22, OP_65C02_NOP11,             /* $20 */
+    OP_6502_24, OP_6502_25, OP_6502_26, OP_ILLEGAL,                     /* $24 */
+    OP_6502_28, OP_6502_29, OP_6502_2A, OP_65C02_NOP11,                 /* $28 */
+    OP_6502_2C, OP_6502_2D, OP_6502_2E, OP_ILLEGAL,                     /* $2C */
+    OP_6502_30, OP_6502_31, OP_65SC02_32, OP_65C02_NOP11,               /* $30 */
+    OP_65SC02_34, OP_6502_35, OP_6502_36, OP_ILLEGAL,                   /* $34 */
+    OP_6502_38, OP_6502_39, OP_65SC02_3A, OP_65C02_NOP11,               /* $38 */
+    OP_65SC02_3C, OP_6502_3D, OP_6502_3E, OP_ILLEGAL,                   /* $3C */
+    OP_6502_40, OP_6502_41, OP_65C02_NOP22, OP_65C02_NOP11,             /* $40 */
+    OP_65C02_44, OP_6502_45, OP_6502_46, OP_ILLEGAL,                    /* $44 */
+    OP_6502_48, OP_6502_49, OP_6502_4A, OP_65C02_NOP11,                 /* $48 */
+    OP_6502_4C, OP_6502_4D, OP_6502_4E, OP_ILLEGAL,                     /* $4C */
+    OP_6502_50, OP_6502_51, OP_65SC02_52, OP_65C02_NOP11,               /* $50 */
+    OP_65C02_NOP24, OP_6502_55, OP_6502_56, OP_ILLEGAL,                 /* $54 */
+    OP_6502_58, OP_6502_59, OP_65SC02_5A, OP_65C02_NOP11,               /* $58 */
+    OP_65C02_5C, OP_6502_5D, OP_6502_5E, OP_ILLEGAL,                    /* $5C */
+    OP_6502_60, OP_6502_61, OP_65C02_NOP22, OP_65C02_NOP11,             /* $60 */
+    OP_65SC02_64, OP_6502_65, OP_6502_66, OP_ILLEGAL,                   /* $64 */
+    OP_6502_68, OP_6502_69, OP_6502_6A, OP_65C02_NOP11,                 /* $68 */
+    OP_65C02_6C, OP_6502_6D, OP_6502_6E, OP_ILLEGAL,                    /* $6C */
+    OP_6502_70, OP_6502_71, OP_65SC02_72, OP_65C02_NOP11,               /* $70 */
+    OP_65SC02_74, OP_6502_75, OP_6502_76, OP_ILLEGAL,                   /* $74 */
+    OP_6502_78, OP_6502_79, OP_65SC02_7A, OP_65C02_NOP11,               /* $78 */
+    OP_65SC02_7C, OP_6502_7D, OP_6502_7E, OP_ILLEGAL,                   /* $7C */
+    OP_65SC02_80, OP_6502_81, OP_65C02_NOP22, OP_65C02_NOP11,           /* $80 */
+    OP_6502_84, OP_6502_85, OP_6502_86, OP_ILLEGAL,                     /* $84 */
+    OP_6502_88, OP_65SC02_89, OP_6502_8A, OP_65C02_NOP11,               /* $88 */
+    OP_6502_8C, OP_6502_8D, OP_6502_8E, OP_ILLEGAL,                     /* $8C */
+    OP_6502_90, OP_6502_91, OP_65SC02_92, OP_65C02_NOP11,               /* $90 */
+    OP_6502_94, OP_6502_95, OP_6502_96, OP_ILLEGAL,                     /* $94 */
+    OP_6502_98, OP_6502_99, OP_6502_9A, OP_65C02_NOP11,                 /* $98 */
+    OP_65SC02_9C, OP_6502_9D, OP_65SC02_9E, OP_ILLEGAL,                 /* $9C */
+    OP_6502_A0, OP_6502_A1, OP_6502_A2, OP_65C02_NOP11,                 /* $A0 */
+    OP_6502_A4, OP_6502_A5, OP_6502_A6, OP_ILLEGAL,                     /* $A4 */
+    OP_6502_A8, OP_6502_A9, OP_6502_AA, OP_65C02_NOP11,                 /* $A8 */
+    OP_6502_AC, OP_6502_AD, OP_6502_AE, OP_ILLEGAL,                     /* $AC */
+    OP_6502_B0, OP_6502_B1, OP_65SC02_B2, OP_65C02_NOP11,               /* $B0 */
+    OP_6502_B4, OP_6502_B5, OP_6502_B6, OP_ILLEGAL,                     /* $B4 */
+    OP_6502_B8, OP_6502_B9, OP_6502_BA, OP_65C02_NOP11,                 /* $B8 */
+    OP_6502_BC, OP_6502_BD, OP_6502_BE, OP_ILLEGAL,                     /* $BC */
+    OP_6502_C0, OP_6502_C1, OP_65C02_NOP22, OP_65C02_NOP11,             /* $C0 */
+    OP_6502_C4, OP_6502_C5, OP_6502_C6, OP_ILLEGAL,                     /* $C4 */
+    OP_6502_C8, OP_6502_C9, OP_6502_CA, OP_ILLEGAL,                     /* $C8 */
+    OP_6502_CC, OP_6502_CD, OP_6502_CE, OP_ILLEGAL,                     /* $CC */
+    OP_6502_D0, OP_6502_D1, OP_65SC02_D2, OP_65C02_NOP11,               /* $D0 */
+    OP_65C02_NOP24, OP_6502_D5, OP_6502_D6, OP_ILLEGAL,                 /* $D4 */
+    OP_6502_D8, OP_6502_D9, OP_65SC02_DA, OP_ILLEGAL,                   /* $D8 */
+    OP_65C02_NOP34, OP_6502_DD, OP_6502_DE, OP_ILLEGAL,                 /* $DC */
+    OP_6502_E0, OP_6502_E1, OP_65C02_NOP22, OP_65C02_NOP11,             /* $E0 */
+    OP_6502_E4, OP_6502_E5, OP_6502_E6, OP_ILLEGAL,                     /* $E4 */
+    OP_6502_E8, OP_6502_E9, OP_6502_EA, OP_65C02_NOP11,                 /* $E8 */
+    OP_6502_EC, OP_6502_ED, OP_6502_EE, OP_ILLEGAL,                     /* $EC */
+    OP_6502_F0, OP_6502_F1, OP_65SC02_F2, OP_65C02_NOP11,               /* $F0 */
+    OP_65C02_NOP24, OP_6502_F5, OP_6502_F6, OP_ILLEGAL,                 /* $F4 */
+    OP_6502_F8, OP_6502_F9, OP_65SC02_FA, OP_65C02_NOP11,               /* $F8 */
+    OP_65C02_NOP34, OP_6502_FD, OP_6502_FE, OP_ILLEGAL,                 /* $FC */
+};
+
+/* Markers in the code of the runtime helpers below */
+#define T_SP            0x100           /* Zero page location of the C sp */
+#define T_SP1           0x101           /* The location following it */
+#define T_ZP            0x102           /* Any zero page location */
+
+/* The code of the runtime helpers in libsrc/runtime that are replaced by
+** superinstructions. The zero page locations are matched against the C sp
+** given in the program header, except for temporaries like tmp1, which are
+** read from the code when the superinstruction runs.
+*/
+static const unsigned short PushaCode[] = {
+    0xA4, T_SP,                         /* ldy sp */
+    0xF0, 0x07,                         /* beq @L1 */
+    0xC6, T_SP,                         /* dec sp */
+    0xA0, 0x00,                         /* ldy #0 */
+    0x91, T_SP,                         /* sta (sp),y */
+    0x60,                               /* rts */
+    0xC6, T_SP1,                        /* @L1: dec sp+1 */
+    0xC6, T_SP,                         /* dec sp */
+    0x91, T_SP,                         /* sta (sp),y */
+    0x60,                               /* rts */
+};
+static const unsigned short PushaxCode[] = {
+    0x48,                               /* pha */
+    0xA5, T_SP,                         /* lda sp */
+    0x38,                               /* sec */
+    0xE9, 0x02,                         /* sbc #2 */
+    0x85, T_SP,                         /* sta sp */
+    0xB0, 0x02,                         /* bcs @L1 */
+    0xC6, T_SP1,                        /* dec sp+1 */
+    0xA0, 0x01,                         /* @L1: ldy #1 */
+    0x8A,                               /* txa */
+    0x91, T_SP,                         /* sta (sp),y */
+    0x68,                               /* pla */
+    0x88,                               /* dey */
+    0x91, T_SP,                         /* sta (sp),y */
+    0x60,                               /* rts */
+};
+static const unsigned short PushwyspCode[] = {
+    0xA5, T_SP,                         /* lda sp */
+    0x38,                               /* sec */
+    0xE9, 0x02,                         /* sbc #2 */
+    0x85, T_SP,                         /* sta sp */
+    0xB0, 0x02,                         /* bcs @L1 */
+    0xC6, T_SP1,                        /* dec sp+1 */
+    0xB1, T_SP,                         /* @L1: lda (sp),y */
+    0xAA,                               /* tax */
+    0x88,                               /* dey */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xA0, 0x00,                         /* ldy #0 */
+    0x91, T_SP,                         /* sta (sp),y */
+    0xC8,                               /* iny */
+    0x8A,                               /* txa */
+    0x91, T_SP,                         /* sta (sp),y */
+    0x60,                               /* rts */
+};
+static const unsigned short LdaxyspCode[] = {
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xAA,                               /* tax */
+    0x88,                               /* dey */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0x60,                               /* rts */
+};
+static const unsigned short PopaxCode[] = {
+    0xA0, 0x01,                         /* ldy #1 */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xAA,                               /* tax */
+    0x88,                               /* dey */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xE6, T_SP,                         /* incsp2: inc sp */
+    0xF0, 0x05,                         /* beq @L1 */
+    0xE6, T_SP,                         /* inc sp */
+    0xF0, 0x03,                         /* beq @L2 */
+    0x60,                               /* rts */
+    0xE6, T_SP,                         /* @L1: inc sp */
+    0xE6, T_SP1,                        /* @L2: inc sp+1 */
+    0x60,                               /* rts */
+};
+static const unsigned short PopaxC02Code[] = {
+    0xA0, 0x01,                         /* ldy #1 */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xAA,                               /* tax */
+    0xB2, T_SP,                         /* lda (sp) */
+    0xE6, T_SP,                         /* incsp2: inc sp */
+    0xF0, 0x05,                         /* beq @L1 */
+    0xE6, T_SP,                         /* inc sp */
+    0xF0, 0x03,                         /* beq @L2 */
+    0x60,                               /* rts */
+    0xE6, T_SP,                         /* @L1: inc sp */
+    0xE6, T_SP1,                        /* @L2: inc sp+1 */
+    0x60,                               /* rts */
+};
+static const unsigned short Incsp1Code[] = {
+    0xE6, T_SP,                         /* inc sp */
+    0xD0, 0x02,                         /* bne @L1 */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0x60,                               /* @L1: rts */
+};
+static const unsigned short Incsp2Code[] = {
+    0xE6, T_SP,                         /* inc sp */
+    0xF0, 0x05,                         /* beq @L1 */
+    0xE6, T_SP,                         /* inc sp */
+    0xF0, 0x03,                         /* beq @L2 */
+    0x60,                               /* rts */
+    0xE6, T_SP,                         /* @L1: inc sp */
+    0xE6, T_SP1,                        /* @L2: inc sp+1 */
+    0x60,                               /* rts */
+};
+static const unsigned short Incax1Code[] = {
+    0x18,                               /* clc */
+    0x69, 0x01,                         /* adc #1 */
+    0x90, 0x01,                         /* bcc @L9 */
+    0xE8,                               /* inx */
+    0x60,                               /* @L9: rts */
+};
+static const unsigned short Incax1C02Code[] = {
+    0x1A,                               /* ina */
+    0xD0, 0x01,                         /* bne @L9 */
+    0xE8,                               /* inx */
+    0x60,                               /* @L9: rts */
+};
+static const unsigned short TosaddaxCode[] = {
+    0x18,                               /* clc */
+    0xA0, 0x00,                         /* ldy #0 */
+    0x71, T_SP,                         /* adc (sp),y */
+    0xC8,                               /* iny */
+    0x85, T_ZP,                         /* sta tmp1 */
+    0x8A,                               /* txa */
+    0x71, T_SP,                         /* adc (sp),y */
+    0xAA,                               /* tax */
+    0x18,                               /* clc */
+    0xA5, T_SP,                         /* lda sp */
+    0x69, 0x02,                         /* adc #2 */
+    0x85, T_SP,                         /* sta sp */
+    0x90, 0x02,                         /* bcc L1 */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0xA5, T_ZP,                         /* L1: lda tmp1 */
+    0x60,                               /* rts */
+};
+static const unsigned short TosaddaxC02Code[] = {
+    0x18,                               /* clc */
+    0x72, T_SP,                         /* adc (sp) */
+    0xA8,                               /* tay */
+    0xE6, T_SP,                         /* inc sp */
+    0xD0, 0x02,                         /* bne hiadd */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0x8A,                               /* hiadd: txa */
+    0x72, T_SP,                         /* adc (sp) */
+    0xAA,                               /* tax */
+    0xE6, T_SP,                         /* inc sp */
+    0xD0, 0x02,                         /* bne done */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0x98,                               /* done: tya */
+    0x60,                               /* rts */
+};
+static const unsigned short TosicmpCode[] = {
+    0x85, T_ZP,                         /* sta sreg */
+    0x86, T_ZP,                         /* stx sreg+1 */
+    0xA0, 0x00,                         /* ldy #0 */
+    0xB1, T_SP,                         /* lda (sp),y */
+    0xAA,                               /* tax */
+    0xE6, T_SP,                         /* inc sp */
+    0xD0, 0x02,                         /* bne @L1 */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0xB1, T_SP,                         /* @L1: lda (sp),y */
+    0xE6, T_SP,                         /* inc sp */
+    0xD0, 0x02,                         /* bne @L2 */
+    0xE6, T_SP1,                        /* inc sp+1 */
+    0x38,                               /* @L2: sec */
+    0xE5, T_ZP,                         /* sbc sreg+1 */
+    0xD0, 0x09,                         /* bne @L4 */
+    0xE4, T_ZP,                         /* cpx sreg */
+    0xF0, 0x04,                         /* beq @L3 */
+    0x69, 0xFF,                         /* adc #$FF */
+    0x09, 0x01,                         /* ora #$01 */
+    0x60,                               /* @L3: rts */
+    0x50, 0xFD,                         /* @L4: bvc @L3 */
+    0x49, 0xFF,                         /* eor #$FF */
+    0x09, 0x01,                         /* ora #$01 */
+    0x60,                               /* rts */
+};
+
+/* A runtime helper that is replaced by a superinstruction */
+typedef struct FastHelper FastHelper;
+struct FastHelper {
+    const unsigned short*       Code;   /* The code, see above */
+    unsigned                    Size;   /* Size of the code in bytes */
+    int                         C02;    /* True if the code is for the 65C02 */
+};
+#define HELPER(Code, C02)       { Code, sizeof (Code) / sizeof (Code[0]), C02 }
+
+/* The runtime helpers, indexed by superinstruction */
+static const FastHelper Helpers[OP_COUNT - OP_FUSED_FIRST] = {
+    HELPER (PushaCode,          0),
+    HELPER (PushaxCode,         0),
+    HELPER (PushwyspCode,       0),
+    HELPER (LdaxyspCode,        0),
+    HELPER (PopaxCode,          0),
+    HELPER (PopaxC02Code,       1),
+    HELPER (Incsp1Code,         0),
+    HELPER (Incsp2Code,         0),
+    HELPER (Incax1Code,         0),
+    HELPER (Incax1C02Code,      1),
+    HELPER (TosaddaxCode,       0),
+    HELPER (TosaddaxC02Code,    1),
+    HELPER (TosicmpCode,        0),
+};
+
+/* Size of the largest helper */
+#define HELPER_MAX_SIZE 44
+
+/* A subroutine is checked for a runtime helper each time its call count wraps
+** around to this value, so helpers are found again after being modified.
+*/
+#define TRACE_HOT       16
+
+/* State of the trace core */
+typedef struct FastTrace FastTrace;
+struct FastTrace {
+    unsigned char       Heat[0x10000];  /* Call counts, indexed by address */
+    unsigned char       Pages[0x100];   /* Pages with superinstructions */
+};
+
+/* Flags for Run */
+#define RUN_PROFILE     0x01U           /* Call the profiler */
+#define RUN_STEP        0x02U           /* Single step without hooks */
+#define RUN_TRACE       0x04U           /* Use superinstructions */
+
+
+
+/*****************************************************************************/
+/*                        Helper functions and macros                        */
+/*****************************************************************************/
+
+
+
+/* Dispatching */
+#if FAST_THREADED
+#  define OP(Name)      L_##Name
+#  define DISPATCH()    goto *Labels[E->Op]
+#  define DISPATCH_PLAIN() goto *Labels[Plain[E->Opc]]
+#else
+#  define OP(Name)      case OP_##Name
+#  define DISPATCH()    goto Dispatch
+#  define DISPATCH_PLAIN()                                      \
+    do {                                                        \
+        Op = Plain[E->Opc];                                     \
+        goto Switch;                                            \
+    } while (0)
+#endif
+
+/* Finish an instruction and continue with the next one */
+#define NEXT()                                                  \
+    Total += Cycles;                                            \
+    if (Total >= Stop) {                                        \
+        goto Check;                                             \
+    }                                                           \
+    PC &= 0xFFFF;                                               \
+    E = Cache + PC;                                             \
+    DISPATCH ()
+
+/* Finish a jump, calling the paravirtualization hooks if needed */
+#define JUMP()                                                  \
+    if (PC >= PARAVIRT_BASE) {                                  \
+        goto Hook;                                              \
+    }                                                           \
+    NEXT ()
+
+/* Copy the registers to and from Regs */
+#define SYNC()                                                  \
+    do {                                                        \
+        Regs->AC = AC;                                          \
+        Regs->XR = XR;                                          \
+        Regs->YR = YR;                                          \
+        Regs->SP = SP;                                          \
+        Regs->PC = PC & 0xFFFF;                                 \
+        Regs->SR = GET_SR ();                                   \
+    } while (0)
+#define LOAD()                                                  \
+    do {                                                        \
+        AC = Regs->AC & 0xFF;                                   \
+        XR = Regs->XR & 0xFF;                                   \
+        YR = Regs->YR & 0xFF;                                   \
+        SP = Regs->SP & 0xFF;                                   \
+        PC = Regs->PC & 0xFFFF;                                 \
+        PUT_SR (Regs->SR);                                      \
+    } while (0)
+
+/* The status register. ZVal is zero if the Z flag is set, and bit 7 of NVal
+** is the N flag.
+*/
+#define SET_NZ(v)       (ZVal = NVal = (unsigned char) (v))
+#define GET_SR()        (Other | CFlag | (ZVal? 0 : ZF) | (NVal & SF) | \
+                         (OFlag? OF : 0))
+#define PUT_SR(v)                                               \
+    do {                                                        \
+        unsigned SR_ = (v);                                     \
+        Other = SR_ & ~(CF | ZF | OF | SF);                     \
+        CFlag = SR_ & CF;                                       \
+        ZVal  = (SR_ & ZF) == 0;                                \
+        NVal  = SR_ & SF;                                       \
+        OFlag = (SR_ & OF) != 0;                                \
+    } while (0)
+
+/* Operands of the current instruction */
+#define OPB             ((unsigned char) E->Operand)
+#define OPW             E->Operand
+
+/* Memory access */
+#define READ_W(Addr)    (Mem[Addr] | (Mem[((Addr) + 1) & 0xFFFF] << 8))
+#define READ_ZPW(Addr)  (Mem[Addr] | (Mem[((Addr) + 1) & 0xFF] << 8))
+#define WRITE(Addr, Val)                                        \
+    do {                                                        \
+        unsigned A_ = (Addr);                                   \
+        if (MemWatch[A_ >> 8]) {                                \
+            MemWatchedWrite (M, A_, (unsigned char) (Val));     \
+        } else {                                                \
+            Mem[A_] = (unsigned char) (Val);                    \
+        }                                                       \
+    } while (0)
+
+/* Stack operations */
+#define PUSH(Val)       do { WRITE (0x0100 | SP, Val); SP = (SP - 1) & 0xFF; } while (0)
+#define POP()           Mem[0x0100 | (SP = (SP + 1) & 0xFF)]
+
+/* Test for page cross */
+#define PAGE_CROSS(addr,offs)   ((((addr) & 0xFF) + offs) >= 0x100)
+
+/* Effective addresses */
+#define EA_ZP()         Addr = OPB
+#define EA_ZPX()        Addr = (unsigned char) (OPB + XR)
+#define EA_ZPY()        Addr = (unsigned char) (OPB + YR)
+#define EA_ABS()        Addr = OPW
+#define EA_ABSX()                                               \
+    do {                                                        \
+        Addr = OPW;                                             \
+        if (PAGE_CROSS (Addr, XR)) {                            \
+            ++Cycles;                                           \
+        }                                                       \
+        Addr = (Addr + XR) & 0xFFFF;                            \
+    } while (0)
+#define EA_ABSY()                                               \
+    do {                                                        \
+        Addr = OPW;                                             \
+        if (PAGE_CROSS (Addr, YR)) {                            \
+            ++Cycles;                                           \
+        }                                                       \
+        Addr = (Addr + YR) & 0xFFFF;                            \
+    } while (0)
+#define EA_ZPXIND()     Addr = READ_ZPW ((unsigned char) (OPB + XR))
+#define EA_ZPINDY()     EA_INDY (OPB)
+#define EA_INDY(Zp)                                             \
+    do {                                                        \
+        Addr = READ_ZPW (Zp);                                   \
+        if (PAGE_CROSS (Addr, YR)) {                            \
+            ++Cycles;                                           \
+        }                                                       \
+        Addr = (Addr + YR) & 0xFFFF;                            \
+    } while (0)
+#define EA_ZPIND()      Addr = READ_ZPW (OPB)
+
+/* abs,x for read-modify-write instructions. The page cross test is done on
+** the final address, exactly as in 6502.c.
+*/
+#define EA_ABSX_RMW()                                           \
+    do {                                                        \
+        Addr = OPW + XR;                                        \
+        if (C02 && !PAGE_CROSS (Addr, XR)) {                    \
+            --Cycles;                                           \
+        }                                                       \
+        Addr &= 0xFFFF;                                         \
+    } while (0)
+
+/* Accumulator operations */
+#define AC_OP_IMM(op)                                           \
+    Cycles = 2;                                                 \
+    AC = AC op OPB;                                             \
+    SET_NZ (AC);                                                \
+    PC += 2
+#define AC_OP(n, Mode, op, Len)                                 \
+    Cycles = n;                                                 \
+    EA_##Mode ();                                               \
+    AC = AC op Mem[Addr];                                       \
+    SET_NZ (AC);                                                \
+    PC += Len
+
+/* Loads and compares */
+#define LD_OP(Reg, n, Mode, Len)                                \
+    Cycles = n;                                                 \
+    EA_##Mode ();                                               \
+    Reg = Mem[Addr];                                            \
+    SET_NZ (Reg);                                               \
+    PC += Len
+#define CMP(v1, v2)                                             \
+    do {                                                        \
+        unsigned Result = (v1) - (v2);                          \
+        SET_NZ (Result);                                        \
+        CFlag = (Result <= 0xFF);                               \
+    } while (0)
+#define CMP_OP(Reg, n, Mode, Len)                               \
+    Cycles = n;                                                 \
+    EA_##Mode ();                                               \
+    CMP (Reg, Mem[Addr]);                                       \
+    PC += Len
+
+/* BIT */
+#define BIT(v)                                                  \
+    do {                                                        \
+        Val   = (v);                                            \
+        NVal  = (unsigned char) Val;                            \
+        OFlag = (Val & 0x40) != 0;                              \
+        ZVal  = (unsigned char) (Val & AC);                     \
+    } while (0)
+
+/* Shifts and rotates */
+#define ROL(v)                                                  \
+    do {                                                        \
+        v = (v << 1) | CFlag;                                   \
+        SET_NZ (v);                                             \
+        CFlag = v >> 8;                                         \
+    } while (0)
+#define ROR(v)                                                  \
+    do {                                                        \
+        v |= CFlag << 8;                                        \
+        CFlag = v & 0x01;                                       \
+        v >>= 1;                                                \
+        SET_NZ (v);                                             \
+    } while (0)
+
+/* Read-modify-write operations on Mem[Addr] */
+#define ASL_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr] << 1;                                   \
+        WRITE (Addr, Val);                                      \
+        SET_NZ (Val);                                           \
+        CFlag = Val >> 8;                                       \
+    } while (0)
+#define LSR_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr];                                        \
+        CFlag = Val & 0x01;                                     \
+        Val >>= 1;                                              \
+        WRITE (Addr, Val);                                      \
+        SET_NZ (Val);                                           \
+    } while (0)
+#define ROL_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr];                                        \
+        ROL (Val);                                              \
+        WRITE (Addr, Val);                                      \
+    } while (0)
+#define ROR_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr];                                        \
+        ROR (Val);                                              \
+        WRITE (Addr, Val);                                      \
+    } while (0)
+#define INC_MEM()                                               \
+    do {                                                        \
+        Val = (unsigned char) (Mem[Addr] + 1);                  \
+        WRITE (Addr, Val);                                      \
+        SET_NZ (Val);                                           \
+    } while (0)
+#define DEC_MEM()                                               \
+    do {                                                        \
+        Val = (unsigned char) (Mem[Addr] - 1);                  \
+        WRITE (Addr, Val);                                      \
+        SET_NZ (Val);                                           \
+    } while (0)
+#define TSB_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr];                                        \
+        ZVal = (unsigned char) (Val & AC);                      \
+        WRITE (Addr, Val | AC);                                 \
+    } while (0)
+#define TRB_MEM()                                               \
+    do {                                                        \
+        Val = Mem[Addr];                                        \
+        ZVal = (unsigned char) (Val & AC);                      \
+        WRITE (Addr, Val & ~AC);                                \
+    } while (0)
+
+/* ADC and SBC. The decimal mode flags are computed exactly as in 6502.c. */
+#define ADC(v)                                                  \
+    do {                                                        \
+        unsigned Old = AC;                                      \
+        unsigned Rhs = (v) & 0xFF;                              \
+        if (Other & DF) {                                       \
+            unsigned Lo;                                        \
+            int Res;                                            \
+            Lo = (Old & 0x0F) + (Rhs & 0x0F) + CFlag;           \
+            if (Lo >= 0x0A) {                                   \
+                Lo = ((Lo + 0x06) & 0x0F) + 0x10;               \
+            }                                                   \
+            AC = (Old & 0xF0) + (Rhs & 0xF0) + Lo;              \
+            Res = (signed char) (Old & 0xF0) +                  \
+                  (signed char) (Rhs & 0xF0) +                  \
+                  (signed char) Lo;                             \
+            ZVal = (unsigned char) (Old + Rhs + CFlag);         \
+            NVal = (unsigned char) AC;                          \
+            if (AC >= 0xA0) {                                   \
+                AC += 0x60;                                     \
+            }                                                   \
+            CFlag = (AC & 0xFF00) != 0;                         \
+            OFlag = (Res < -128) || (Res > 127);                \
+            AC &= 0xFF;                                         \
+            if (C02) {                                          \
+                ++Cycles;                                       \
+            }                                                   \
+        } else {                                                \
+            AC += Rhs + CFlag;                                  \
+            SET_NZ (AC);                                        \
+            CFlag = (AC & 0xFF00) != 0;                         \
+            OFlag = !((Old ^ Rhs) & 0x80) &&                    \
+                    ((Old ^ AC) & 0x80);                        \
+            AC &= 0xFF;                                         \
+        }                                                       \
+    } while (0)
+#define SBC(v)                                                  \
+    do {                                                        \
+        unsigned Old = AC;                                      \
+        unsigned Rhs = (v) & 0xFF;                              \
+        if (Other & DF) {                                       \
+            unsigned Lo;                                        \
+            int Res;                                            \
+            Lo = (Old & 0x0F) - (Rhs & 0x0F) + CFlag - 1;       \
+            if (Lo & 0x80) {                                    \
+                Lo = ((Lo - 0x06) & 0x0F) - 0x10;               \
+            }                                                   \
+            AC = (Old & 0xF0) - (Rhs & 0xF0) + Lo;              \
+            if (AC & 0x80) {                                    \
+                AC -= 0x60;                                     \
+            }                                                   \
+            Res = AC - Rhs + (!CFlag);                          \
+            SET_NZ (Res);                                       \
+            CFlag = (Res <= 0xFF);                              \
+            OFlag = ((Old ^ Rhs) & (Old ^ Res) & 0x80) != 0;    \
+            AC &= 0xFF;                                         \
+            if (C02) {                                          \
+                ++Cycles;                                       \
+            }                                                   \
+        } else {                                                \
+            AC -= Rhs + (!CFlag);                               \
+            SET_NZ (AC);                                        \
+            CFlag = (AC <= 0xFF);                               \
+            OFlag = ((Old ^ Rhs) & (Old ^ AC) & 0x80) != 0;     \
+            AC &= 0xFF;                                         \
+        }                                                       \
+    } while (0)
+
+/* Branches */
+#define BRANCH(cond)                                            \
+    Cycles = 2;                                                 \
+    if (cond) {                                                 \
+        unsigned OldPC = PC;                                    \
+        ++Cycles;                                               \
+        PC = (PC + 2 + (signed char) OPB) & 0xFFFF;             \
+        if ((PC ^ OldPC) & 0xFF00) {                            \
+            ++Cycles;                                           \
+        }                                                       \
+    } else {                                                    \
+        PC += 2;                                                \
+    }
+
+/* Superinstructions. While one runs, PC stays at the start of the helper, and
+** Cycles sums up the cycles of the instructions done so far. If the cycle
+** limit is near, the first instruction is run on its own instead, so the
+** limit is checked after the same instruction as without superinstructions.
+*/
+#define FUSED_BEGIN(MaxCycles)                                  \
+    if (Total + (MaxCycles) >= Stop) {                          \
+        DISPATCH_PLAIN ();                                      \
+    }                                                           \
+    Cycles = 0
+
+/* Write to memory. If the write changed the code of the helper, the entry was
+** invalidated, and execution continues with the instruction at offset Next.
+*/
+#define FUSED_WRITE(Addr, Val, Next)                            \
+    do {                                                        \
+        WRITE (Addr, Val);                                      \
+        if (E->Op == OP_DECODE) {                               \
+            PC += (Next);                                       \
+            NEXT ();                                            \
+        }                                                       \
+    } while (0)
+#define FUSED_PUSH(Val, Next)                                   \
+    do {                                                        \
+        unsigned S_ = 0x0100 | SP;                              \
+        SP = (SP - 1) & 0xFF;                                   \
+        FUSED_WRITE (S_, Val, Next);                            \
+    } while (0)
+
+/* INC and DEC for zero page locations */
+#define FUSED_INC(Zp, Next)                                     \
+    do {                                                        \
+        Cycles += 5;                                            \
+        Val = (unsigned char) (Mem[Zp] + 1);                    \
+        SET_NZ (Val);                                           \
+        FUSED_WRITE (Zp, Val, Next);                            \
+    } while (0)
+#define FUSED_DEC(Zp, Next)                                     \
+    do {                                                        \
+        Cycles += 5;                                            \
+        Val = (unsigned char) (Mem[Zp] - 1);                    \
+        SET_NZ (Val);                                           \
+        FUSED_WRITE (Zp, Val, Next);                            \
+    } while (0)
+
+/* A taken branch from offset From to offset To. Timing is as in BRANCH. */
+#define FUSED_TAKEN(From, To)                                   \
+    Cycles += 3 + ((((PC + (From)) ^ (PC + (To))) & 0xFF00) != 0)
+
+/* The RTS at the end of a helper */
+#define FUSED_RTS()                                             \
+    Cycles += 6;                                                \
+    PC = POP ();                                                \
+    PC |= (POP () << 8);                                        \
+    PC += 1;                                                    \
+    NEXT ()
+
+
+
+static void Decode (Machine* M, unsigned PC)
+/* Predecode the instruction at PC */
+{
+    FastInsn* E = M->Cache + PC;
+    unsigned Last = (PC + 2) & 0xFFFF;
+
+    E->Opc     = M->Mem[PC];
+    E->Op      = (M->CPU == CPU_6502)? Ops6502[E->Opc] : Ops65C02[E->Opc];
+    E->Operand = M->Mem[(PC + 1) & 0xFFFF] | (M->Mem[Last] << 8);
+
+    /* Writes to any of the instruction bytes must invalidate the entry */
+    M->MemWatch[PC >> 8]   |= MEM_WATCH_CODE;
+    M->MemWatch[Last >> 8] |= MEM_WATCH_CODE;
+}
+
+
+
+static int MatchHelper (const Machine* M, const FastHelper* H, unsigned Addr)
+/* Return true if the code at Addr is the given runtime helper */
+{
+    unsigned I;
+
+    if (H->C02 && M->CPU == CPU_6502) {
+        return 0;
+    }
+    if (Addr + H->Size > PARAVIRT_BASE) {
+        return 0;
+    }
+    for (I = 0; I < H->Size; ++I) {
+        unsigned B = M->Mem[Addr + I];
+        switch (H->Code[I]) {
+            case T_SP:
+                if (B != M->SPAddr) {
+                    return 0;
+                }
+                break;
+            case T_SP1:
+                if (B != ((M->SPAddr + 1) & 0xFF)) {
+                    return 0;
+                }
+                break;
+            case T_ZP:
+                break;
+            default:
+                if (B != H->Code[I]) {
+                    return 0;
+                }
+                break;
+        }
+    }
+    return 1;
+}
+
+
+
+static int Fuse (Machine* M, unsigned Addr)
+/* If the code at Addr is one of the runtime helpers, replace it by a
+** superinstruction. Return true if there is one now.
+*/
+{
+    unsigned I;
+
+    if (M->Cache[Addr].Op >= OP_FUSED_FIRST) {
+        return 1;
+    }
+    for (I = 0; I < sizeof (Helpers) / sizeof (Helpers[0]); ++I) {
+        const FastHelper* H = Helpers + I;
+        if (MatchHelper (M, H, Addr)) {
+            unsigned Last = Addr + H->Size - 1;
+
+            /* The entry keeps the decoded first instruction, so it can run
+            ** on its own if needed. Writes to any byte of the helper must
+            ** find the entry, see FastInvalidate.
+            */
+            Decode (M, Addr);
+            M->Cache[Addr].Op = OP_FUSED_FIRST + I;
+            M->MemWatch[Last >> 8] |= MEM_WATCH_CODE;
+            M->Trace->Pages[Addr >> 8] = 1;
+            M->Trace->Pages[Last >> 8] = 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+
+static void Translate (Machine* M, unsigned Addr)
+/* Called for hot subroutines. Many runtime helpers have a second entry that
+** loads a register first, like pusha0 and ldax0sp, so the instruction after
+** an immediate load is checked, too.
+*/
+{
+    if (!Fuse (M, Addr)) {
+        switch (M->Mem[Addr]) {
+            case 0xA0:                          /* LDY #imm */
+            case 0xA2:                          /* LDX #imm */
+            case 0xA9:                          /* LDA #imm */
+                Fuse (M, (Addr + 2) & 0xFFFF);
+                break;
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void FastInvalidate (Machine* M, unsigned Addr)
+/* Invalidate all predecoded instructions that contain the byte at Addr */
+{
+    FastInsn* Cache = M->Cache;
+    Cache[Addr & 0xFFFF].Op       = OP_DECODE;
+    Cache[(Addr - 1) & 0xFFFF].Op = OP_DECODE;
+    Cache[(Addr - 2) & 0xFFFF].Op = OP_DECODE;
+
+    /* Superinstructions cover more bytes */
+    if (M->Trace && M->Trace->Pages[(Addr >> 8) & 0xFF]) {
+        unsigned I;
+        for (I = 3; I < HELPER_MAX_SIZE; ++I) {
+            FastInsn* E = Cache + ((Addr - I) & 0xFFFF);
+            if (E->Op >= OP_FUSED_FIRST &&
+                Helpers[E->Op - OP_FUSED_FIRST].Size > I) {
+                E->Op = OP_DECODE;
+            }
+        }
+    }
+}
+
+
+
+static void Run (Machine* M, CPURegs* Regs, unsigned long* TotalCycles,
+                 unsigned long Limit, unsigned Flags)
+/* Execute instructions until *TotalCycles reaches Limit or a hook was called */
+{
+#if FAST_THREADED
+    /* Handler addresses, indexed by operation */
+    static const void* const Labels[OP_COUNT] = {
+        &&L_DECODE, &&L_ILLEGAL, &&L_6502_00, &&L_6502_01, &&L_6502_05,
+        &&L_6502_06, &&L_6502_08, &&L_6502_09, &&L_6502_0A, &&L_6502_0D,
+        &&L_6502_0E, &&L_6502_10, &&L_6502_11, &&L_6502_15, &&L_6502_16,
+        &&L_6502_18, &&L_6502_19, &&L_6502_1D, &&L_6502_1E, &&L_6502_20,
+        &&L_6502_21, &&L_6502_24, &&L_6502_25, &&L_6502_26, &&L_6502_28,
+        &&L_6502_29, &&L_6502_2A, &&L_6502_2C, &&L_6502_2D, &&L_6502_2E,
+        &&L_6502_30, &&L_6502_31, &&L_6502_35, &&L_6502_36, &&L_6502_38,
+        &&L_6502_39, &&L_6502_3D, &&L_6502_3E, &&L_6502_40, &&L_6502_41,
+        &&L_6502_45, &&L_6502_46, &&L_6502_48, &&L_6502_49, &&L_6502_4A,
+        &&L_6502_4C, &&L_6502_4D, &&L_6502_4E, &&L_6502_50, &&L_6502_51,
+        &&L_6502_55, &&L_6502_56, &&L_6502_58, &&L_6502_59, &&L_6502_5D,
+        &&L_6502_5E, &&L_6502_60, &&L_6502_61, &&L_6502_65, &&L_6502_66,
+        &&L_6502_68, &&L_6502_69, &&L_6502_6A, &&L_6502_6C, &&L_6502_6D,
+        &&L_6502_6E, &&L_6502_70, &&L_6502_71, &&L_6502_75, &&L_6502_76,
+        &&L_6502_78, &&L_6502_79, &&L_6502_7D, &&L_6502_7E, &&L_6502_81,
+        &&L_6502_84, &&L_6502_85, &&L_6502_86, &&L_6502_88, &&L_6502_8A,
+        &&L_6502_8C, &&L_6502_8D, &&L_6502_8E, &&L_6502_90, &&L_6502_91,
+        &&L_6502_94, &&L_6502_95, &&L_6502_96, &&L_6502_98, &&L_6502_99,
+        &&L_6502_9A, &&L_6502_9D, &&L_6502_A0, &&L_6502_A1, &&L_6502_A2,
+        &&L_6502_A4, &&L_6502_A5, &&L_6502_A6, &&L_6502_A8, &&L_6502_A9,
+        &&L_6502_AA, &&L_6502_AC, &&L_6502_AD, &&L_6502_AE, &&L_6502_B0,
+        &&L_6502_B1, &&L_6502_B4, &&L_6502_B5, &&L_6502_B6, &&L_6502_B8,
+        &&L_6502_B9, &&L_6502_BA, &&L_6502_BC, &&L_6502_BD, &&L_6502_BE,
+        &&L_6502_C0, &&L_6502_C1, &&L_6502_C4, &&L_6502_C5, &&L_6502_C6,
+        &&L_6502_C8, &&L_6502_C9, &&L_6502_CA, &&L_6502_CC, &&L_6502_CD,
+        &&L_6502_CE, &&L_6502_D0, &&L_6502_D1, &&L_6502_D5, &&L_6502_D6,
+        &&L_6502_D8, &&L_6502_D9, &&L_6502_DD, &&L_6502_DE, &&L_6502_E0,
+        &&L_6502_E1, &&L_6502_E4, &&L_6502_E5, &&L_6502_E6, &&L_6502_E8,
+        &&L_6502_E9, &&L_6502_EA, &&L_6502_EC, &&L_6502_ED, &&L_6502_EE,
+        &&L_6502_F0, &&L_6502_F1, &&L_6502_F5, &&L_6502_F6, &&L_6502_F8,
+        &&L_6502_F9, &&L_6502_FD, &&L_6502_FE, &&L_65C02_NOP22,
+        &&L_65C02_NOP11, &&L_65SC02_04, &&L_65SC02_0C, &&L_65SC02_12,
+        &&L_65SC02_14, &&L_65SC02_1A, &&L_65SC02_1C, &&L_65SC02_32,
+        &&L_65SC02_34, &&L_65SC02_3A, &&L_65SC02_3C, &&L_65C02_44,
+        &&L_65SC02_52, &&L_65C02_NOP24, &&L_65SC02_5A, &&L_65C02_5C,
+        &&L_65SC02_64, &&L_65C02_6C, &&L_65SC02_72, &&L_65SC02_74,
+        &&L_65SC02_7A, &&L_65SC02_7C, &&L_65SC02_80, &&L_65SC02_89,
+        &&L_65SC02_92, &&L_65SC02_9C, &&L_65SC02_9E, &&L_65SC02_B2,
+        &&L_65SC02_D2, &&L_65SC02_DA, &&L_65C02_NOP34, &&L_65SC02_F2,
+        &&L_65SC02_FA, &&L_FUSED_PUSHA, &&L_FUSED_PUSHAX,
+        &&L_FUSED_PUSHWYSP, &&L_FUSED_LDAXYSP, &&L_FUSED_POPAX,
+        &&L_FUSED_POPAX_C02, &&L_FUSED_INCSP1, &&L_FUSED_INCSP2,
+        &&L_FUSED_INCAX1, &&L_FUSED_INCAX1_C02, &&L_FUSED_TOSADDAX,
+        &&L_FUSED_TOSADDAX_C02, &&L_FUSED_TOSICMP,
+    };
+#else
+    unsigned            Op;             /* Operation to run */
+#endif
+
+    unsigned            AC, XR, YR, SP, PC;
+    unsigned            CFlag, OFlag;   /* Carry and overflow flag, 0 or 1 */
+    unsigned char       ZVal, NVal;     /* Values for the Z and N flags */
+    unsigned            Other;          /* Remaining status register bits */
+    unsigned            Cycles = 0;     /* Cycles of the current instruction */
+    unsigned            Addr;
+    unsigned            Val;
+    const FastInsn*     E;
+
+    /* The memory of the machine and the instruction cache */
+    unsigned char*      Mem      = M->Mem;
+    unsigned char*      MemWatch = M->MemWatch;
+    FastInsn*           Cache    = M->Cache;
+
+    /* The total cycle count and the count at which we have to leave the fast
+    ** path. When profiling, we leave it after each instruction.
+    */
+    unsigned long       Total = *TotalCycles;
+    unsigned long       Stop  = (Flags & RUN_PROFILE)? 0 : Limit;
+
+    /* Cycle counts differ slightly for the 65C02 */
+    int                 C02 = (M->CPU != CPU_6502);
+
+    /* The operations of the single instructions, used by superinstructions
+    ** that have to run their first instruction on its own.
+    */
+    const unsigned char* Plain = C02? Ops65C02 : Ops6502;
+
+    /* State of the trace core, NULL if superinstructions aren't created */
+    FastTrace*          Trace = 0;
+
+    /* The C stack pointer used by the runtime helpers */
+    unsigned            SpZP  = M->SPAddr;
+    unsigned            SpZP1 = (SpZP + 1) & 0xFF;
+
+    /* Allocate the instruction cache when running the machine for the first
+    ** time.
+    */
+    if (Cache == 0) {
+        Cache = M->Cache = xmalloc (CACHE_SIZE * sizeof (FastInsn));
+        memset (Cache, OP_DECODE, CACHE_SIZE * sizeof (FastInsn));
+    }
+    if (Flags & RUN_TRACE) {
+        if (M->Trace == 0) {
+            M->Trace = xmalloc (sizeof (FastTrace));
+            memset (M->Trace, 0, sizeof (FastTrace));
+        }
+        Trace = M->Trace;
+    }
+
+    /* Load the registers */
+    LOAD ();
+
+    /* Start with the current instruction */
+    if (Total >= Limit) {
+        return;
+    }
+    E = Cache + PC;
+#if FAST_THREADED
+    DISPATCH ();
+#else
+Dispatch:
+    Op = E->Op;
+Switch:
+    switch (Op) {
+#endif
+
+    OP (DECODE):
+        Decode (M, PC);
+        DISPATCH ();
+
+    OP (ILLEGAL):
+        SYNC ();
+        *TotalCycles = Total;
+        MachineError (M, SIM65_ERROR, "Illegal opcode $%02X at address $%04X",
+                      E->Opc, PC);
+
+    OP (6502_00):                                       /* BRK */
+        Cycles = 7;
+        PC += 2;
+        PUSH (PC >> 8);
+        PUSH (PC);
+        PUSH (GET_SR ());
+        Other |= IF;
+        if (C02) {
+            Other &= ~DF;
+        }
+        PC = READ_W (0xFFFE);
+        NEXT ();
+
+    OP (6502_01):                                       /* ORA (zp,x) */
+        AC_OP (6, ZPXIND, |, 2);
+        NEXT ();
+
+    OP (6502_05):                                       /* ORA zp */
+        AC_OP (3, ZP, |, 2);
+        NEXT ();
+
+    OP (6502_06):                                       /* ASL zp */
+        Cycles = 5;
+        EA_ZP ();
+        ASL_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_08):                                       /* PHP */
+        Cycles = 3;
+        PUSH (GET_SR ());
+        PC += 1;
+        NEXT ();
+
+    OP (6502_09):                                       /* ORA #imm */
+        AC_OP_IMM (|);
+        NEXT ();
+
+    OP (6502_0A):                                       /* ASL a */
+        Cycles = 2;
+        AC <<= 1;
+        SET_NZ (AC);
+        CFlag = AC >> 8;
+        AC &= 0xFF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_0D):                                       /* ORA abs */
+        AC_OP (4, ABS, |, 3);
+        NEXT ();
+
+    OP (6502_0E):                                       /* ASL abs */
+        Cycles = 6;
+        EA_ABS ();
+        ASL_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_10):                                       /* BPL */
+        BRANCH ((NVal & SF) == 0);
+        NEXT ();
+
+    OP (6502_11):                                       /* ORA (zp),y */
+        AC_OP (5, ZPINDY, |, 2);
+        NEXT ();
+
+    OP (6502_15):                                       /* ORA zp,x */
+        AC_OP (4, ZPX, |, 2);
+        NEXT ();
+
+    OP (6502_16):                                       /* ASL zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        ASL_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_18):                                       /* CLC */
+        Cycles = 2;
+        CFlag = 0;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_19):                                       /* ORA abs,y */
+        AC_OP (4, ABSY, |, 3);
+        NEXT ();
+
+    OP (6502_1D):                                       /* ORA abs,x */
+        AC_OP (4, ABSX, |, 3);
+        NEXT ();
+
+    OP (6502_1E):                                       /* ASL abs,x */
+        Cycles = 7;
+        EA_ABSX_RMW ();
+        ASL_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_20):                                       /* JSR */
+        Cycles = 6;
+        PC += 2;
+        PUSH (PC >> 8);
+        PUSH (PC);
+        PC = OPW;
+        if (Trace && ++Trace->Heat[PC] == TRACE_HOT) {
+            Translate (M, PC);
+        }
+        JUMP ();
+
+    OP (6502_21):                                       /* AND (zp,x) */
+        AC_OP (6, ZPXIND, &, 2);
+        NEXT ();
+
+    OP (6502_24):                                       /* BIT zp */
+        Cycles = 3;
+        EA_ZP ();
+        BIT (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_25):                                       /* AND zp */
+        AC_OP (3, ZP, &, 2);
+        NEXT ();
+
+    OP (6502_26):                                       /* ROL zp */
+        Cycles = 5;
+        EA_ZP ();
+        ROL_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_28):                                       /* PLP */
+        Cycles = 4;
+        PUT_SR (POP () | 0x30);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_29):                                       /* AND #imm */
+        AC_OP_IMM (&);
+        NEXT ();
+
+    OP (6502_2A):                                       /* ROL a */
+        Cycles = 2;
+        ROL (AC);
+        AC &= 0xFF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_2C):                                       /* BIT abs */
+        Cycles = 4;
+        EA_ABS ();
+        BIT (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_2D):                                       /* AND abs */
+        AC_OP (4, ABS, &, 3);
+        NEXT ();
+
+    OP (6502_2E):                                       /* ROL abs */
+        Cycles = 6;
+        EA_ABS ();
+        ROL_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_30):                                       /* BMI */
+        BRANCH ((NVal & SF) != 0);
+        NEXT ();
+
+    OP (6502_31):                                       /* AND (zp),y */
+        AC_OP (5, ZPINDY, &, 2);
+        NEXT ();
+
+    OP (6502_35):                                       /* AND zp,x */
+        AC_OP (4, ZPX, &, 2);
+        NEXT ();
+
+    OP (6502_36):                                       /* ROL zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        ROL_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_38):                                       /* SEC */
+        Cycles = 2;
+        CFlag = 1;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_39):                                       /* AND abs,y */
+        AC_OP (4, ABSY, &, 3);
+        NEXT ();
+
+    OP (6502_3D):                                       /* AND abs,x */
+        AC_OP (4, ABSX, &, 3);
+        NEXT ();
+
+    OP (6502_3E):                                       /* ROL abs,x */
+        Cycles = 7;
+        EA_ABSX_RMW ();
+        ROL_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_40):                                       /* RTI */
+        Cycles = 6;
+        PUT_SR (POP () | 0x30);
+        PC = POP ();
+        PC |= (POP () << 8);
+        NEXT ();
+
+    OP (6502_41):                                       /* EOR (zp,x) */
+        AC_OP (6, ZPXIND, ^, 2);
+        NEXT ();
+
+    OP (6502_45):                                       /* EOR zp */
+        AC_OP (3, ZP, ^, 2);
+        NEXT ();
+
+    OP (6502_46):                                       /* LSR zp */
+        Cycles = 5;
+        EA_ZP ();
+        LSR_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_48):                                       /* PHA */
+        Cycles = 3;
+        PUSH (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_49):                                       /* EOR #imm */
+        AC_OP_IMM (^);
+        NEXT ();
+
+    OP (6502_4A):                                       /* LSR a */
+        Cycles = 2;
+        CFlag = AC & 0x01;
+        AC >>= 1;
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_4C):                                       /* JMP abs */
+        Cycles = 3;
+        PC = OPW;
+        if (Trace && ++Trace->Heat[PC] == TRACE_HOT) {
+            Translate (M, PC);
+        }
+        JUMP ();
+
+    OP (6502_4D):                                       /* EOR abs */
+        AC_OP (4, ABS, ^, 3);
+        NEXT ();
+
+    OP (6502_4E):                                       /* LSR abs */
+        Cycles = 6;
+        EA_ABS ();
+        LSR_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_50):                                       /* BVC */
+        BRANCH (OFlag == 0);
+        NEXT ();
+
+    OP (6502_51):                                       /* EOR (zp),y */
+        AC_OP (5, ZPINDY, ^, 2);
+        NEXT ();
+
+    OP (6502_55):                                       /* EOR zp,x */
+        AC_OP (4, ZPX, ^, 2);
+        NEXT ();
+
+    OP (6502_56):                                       /* LSR zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        LSR_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_58):                                       /* CLI */
+        Cycles = 2;
+        Other &= ~IF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_59):                                       /* EOR abs,y */
+        AC_OP (4, ABSY, ^, 3);
+        NEXT ();
+
+    OP (6502_5D):                                       /* EOR abs,x */
+        AC_OP (4, ABSX, ^, 3);
+        NEXT ();
+
+    OP (6502_5E):                                       /* LSR abs,x */
+        Cycles = 7;
+        EA_ABSX_RMW ();
+        LSR_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_60):                                       /* RTS */
+        Cycles = 6;
+        PC = POP ();
+        PC |= (POP () << 8);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_61):                                       /* ADC (zp,x) */
+        Cycles = 6;
+        EA_ZPXIND ();
+        ADC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_65):                                       /* ADC zp */
+        Cycles = 3;
+        EA_ZP ();
+        ADC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_66):                                       /* ROR zp */
+        Cycles = 5;
+        EA_ZP ();
+        ROR_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_68):                                       /* PLA */
+        Cycles = 4;
+        AC = POP ();
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_69):                                       /* ADC #imm */
+        Cycles = 2;
+        ADC (OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_6A):                                       /* ROR a */
+        Cycles = 2;
+        ROR (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_6C):                                       /* JMP (ind) */
+        /* Emulate the 6502 bug */
+        Cycles = 5;
+        Addr = OPW;
+        Val = (Addr & 0xFF00) | ((Addr + 1) & 0xFF);
+        if (Val != Addr + 1) {
+            Warning ("6502 indirect jump bug triggered at $%04X, "
+                     "ind addr = $%04X", PC, Addr);
+        }
+        PC = Mem[Addr] | (Mem[Val] << 8);
+        JUMP ();
+
+    OP (6502_6D):                                       /* ADC abs */
+        Cycles = 4;
+        EA_ABS ();
+        ADC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_6E):                                       /* ROR abs */
+        Cycles = 6;
+        EA_ABS ();
+        ROR_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_70):                                       /* BVS */
+        BRANCH (OFlag != 0);
+        NEXT ();
+
+    OP (6502_71):                                       /* ADC (zp),y */
+        Cycles = 5;
+        EA_ZPINDY ();
+        ADC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_75):                                       /* ADC zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        ADC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_76):                                       /* ROR zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        ROR_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_78):                                       /* SEI */
+        Cycles = 2;
+        Other |= IF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_79):                                       /* ADC abs,y */
+        Cycles = 4;
+        EA_ABSY ();
+        ADC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_7D):                                       /* ADC abs,x */
+        Cycles = 4;
+        EA_ABSX ();
+        ADC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_7E):                                       /* ROR abs,x */
+        Cycles = 7;
+        EA_ABSX_RMW ();
+        ROR_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_81):                                       /* STA (zp,x) */
+        Cycles = 6;
+        EA_ZPXIND ();
+        WRITE (Addr, AC);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_84):                                       /* STY zp */
+        Cycles = 3;
+        EA_ZP ();
+        WRITE (Addr, YR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_85):                                       /* STA zp */
+        Cycles = 3;
+        EA_ZP ();
+        WRITE (Addr, AC);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_86):                                       /* STX zp */
+        Cycles = 3;
+        EA_ZP ();
+        WRITE (Addr, XR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_88):                                       /* DEY */
+        Cycles = 2;
+        YR = (YR - 1) & 0xFF;
+        SET_NZ (YR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_8A):                                       /* TXA */
+        Cycles = 2;
+        AC = XR;
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_8C):                                       /* STY abs */
+        Cycles = 4;
+        EA_ABS ();
+        WRITE (Addr, YR);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_8D):                                       /* STA abs */
+        Cycles = 4;
+        EA_ABS ();
+        WRITE (Addr, AC);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_8E):                                       /* STX abs */
+        Cycles = 4;
+        EA_ABS ();
+        WRITE (Addr, XR);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_90):                                       /* BCC */
+        BRANCH (CFlag == 0);
+        NEXT ();
+
+    OP (6502_91):                                       /* STA (zp),y */
+        Cycles = 6;
+        Addr = (READ_ZPW (OPB) + YR) & 0xFFFF;
+        WRITE (Addr, AC);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_94):                                       /* STY zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        WRITE (Addr, YR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_95):                                       /* STA zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        WRITE (Addr, AC);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_96):                                       /* STX zp,y */
+        Cycles = 4;
+        EA_ZPY ();
+        WRITE (Addr, XR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_98):                                       /* TYA */
+        Cycles = 2;
+        AC = YR;
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_99):                                       /* STA abs,y */
+        Cycles = 5;
+        Addr = (OPW + YR) & 0xFFFF;
+        WRITE (Addr, AC);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_9A):                                       /* TXS */
+        Cycles = 2;
+        SP = XR;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_9D):                                       /* STA abs,x */
+        Cycles = 5;
+        Addr = (OPW + XR) & 0xFFFF;
+        WRITE (Addr, AC);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_A0):                                       /* LDY #imm */
+        Cycles = 2;
+        YR = OPB;
+        SET_NZ (YR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_A1):                                       /* LDA (zp,x) */
+        LD_OP (AC, 6, ZPXIND, 2);
+        NEXT ();
+
+    OP (6502_A2):                                       /* LDX #imm */
+        Cycles = 2;
+        XR = OPB;
+        SET_NZ (XR);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_A4):                                       /* LDY zp */
+        LD_OP (YR, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_A5):                                       /* LDA zp */
+        LD_OP (AC, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_A6):                                       /* LDX zp */
+        LD_OP (XR, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_A8):                                       /* TAY */
+        Cycles = 2;
+        YR = AC;
+        SET_NZ (YR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_A9):                                       /* LDA #imm */
+        Cycles = 2;
+        AC = OPB;
+        SET_NZ (AC);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_AA):                                       /* TAX */
+        Cycles = 2;
+        XR = AC;
+        SET_NZ (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_AC):                                       /* LDY abs */
+        LD_OP (YR, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_AD):                                       /* LDA abs */
+        LD_OP (AC, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_AE):                                       /* LDX abs */
+        LD_OP (XR, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_B0):                                       /* BCS */
+        BRANCH (CFlag != 0);
+        NEXT ();
+
+    OP (6502_B1):                                       /* LDA (zp),y */
+        LD_OP (AC, 5, ZPINDY, 2);
+        NEXT ();
+
+    OP (6502_B4):                                       /* LDY zp,x */
+        LD_OP (YR, 4, ZPX, 2);
+        NEXT ();
+
+    OP (6502_B5):                                       /* LDA zp,x */
+        LD_OP (AC, 4, ZPX, 2);
+        NEXT ();
+
+    OP (6502_B6):                                       /* LDX zp,y */
+        LD_OP (XR, 4, ZPY, 2);
+        NEXT ();
+
+    OP (6502_B8):                                       /* CLV */
+        Cycles = 2;
+        OFlag = 0;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_B9):                                       /* LDA abs,y */
+        LD_OP (AC, 4, ABSY, 3);
+        NEXT ();
+
+    OP (6502_BA):                                       /* TSX */
+        Cycles = 2;
+        XR = SP;
+        SET_NZ (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_BC):                                       /* LDY abs,x */
+        LD_OP (YR, 4, ABSX, 3);
+        NEXT ();
+
+    OP (6502_BD):                                       /* LDA abs,x */
+        LD_OP (AC, 4, ABSX, 3);
+        NEXT ();
+
+    OP (6502_BE):                                       /* LDX abs,y */
+        LD_OP (XR, 4, ABSY, 3);
+        NEXT ();
+
+    OP (6502_C0):                                       /* CPY #imm */
+        Cycles = 2;
+        CMP (YR, OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_C1):                                       /* CMP (zp,x) */
+        CMP_OP (AC, 6, ZPXIND, 2);
+        NEXT ();
+
+    OP (6502_C4):                                       /* CPY zp */
+        CMP_OP (YR, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_C5):                                       /* CMP zp */
+        CMP_OP (AC, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_C6):                                       /* DEC zp */
+        Cycles = 5;
+        EA_ZP ();
+        DEC_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_C8):                                       /* INY */
+        Cycles = 2;
+        YR = (YR + 1) & 0xFF;
+        SET_NZ (YR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_C9):                                       /* CMP #imm */
+        Cycles = 2;
+        CMP (AC, OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_CA):                                       /* DEX */
+        Cycles = 2;
+        XR = (XR - 1) & 0xFF;
+        SET_NZ (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_CC):                                       /* CPY abs */
+        CMP_OP (YR, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_CD):                                       /* CMP abs */
+        CMP_OP (AC, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_CE):                                       /* DEC abs */
+        Cycles = 6;
+        EA_ABS ();
+        DEC_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_D0):                                       /* BNE */
+        BRANCH (ZVal != 0);
+        NEXT ();
+
+    OP (6502_D1):                                       /* CMP (zp),y */
+        /* Like in 6502.c, the pointer is not wrapped around in the zp */
+        Cycles = 5;
+        Addr = READ_W (OPB);
+        if (PAGE_CROSS (Addr, YR)) {
+            ++Cycles;
+        }
+        CMP (AC, Mem[(Addr + YR) & 0xFFFF]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_D5):                                       /* CMP zp,x */
+        CMP_OP (AC, 4, ZPX, 2);
+        NEXT ();
+
+    OP (6502_D6):                                       /* DEC zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        DEC_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_D8):                                       /* CLD */
+        Cycles = 2;
+        Other &= ~DF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_D9):                                       /* CMP abs,y */
+        CMP_OP (AC, 4, ABSY, 3);
+        NEXT ();
+
+    OP (6502_DD):                                       /* CMP abs,x */
+        CMP_OP (AC, 4, ABSX, 3);
+        NEXT ();
+
+    OP (6502_DE):                                       /* DEC abs,x */
+        Cycles = 7;
+        Addr = (OPW + XR) & 0xFFFF;
+        DEC_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_E0):                                       /* CPX #imm */
+        Cycles = 2;
+        CMP (XR, OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_E1):                                       /* SBC (zp,x) */
+        Cycles = 6;
+        EA_ZPXIND ();
+        SBC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_E4):                                       /* CPX zp */
+        CMP_OP (XR, 3, ZP, 2);
+        NEXT ();
+
+    OP (6502_E5):                                       /* SBC zp */
+        Cycles = 3;
+        EA_ZP ();
+        SBC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_E6):                                       /* INC zp */
+        Cycles = 5;
+        EA_ZP ();
+        INC_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_E8):                                       /* INX */
+        Cycles = 2;
+        XR = (XR + 1) & 0xFF;
+        SET_NZ (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (6502_E9):                                       /* SBC #imm */
+        Cycles = 2;
+        SBC (OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_EA):                                       /* NOP */
+        Cycles = 2;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_EC):                                       /* CPX abs */
+        CMP_OP (XR, 4, ABS, 3);
+        NEXT ();
+
+    OP (6502_ED):                                       /* SBC abs */
+        Cycles = 4;
+        EA_ABS ();
+        SBC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_EE):                                       /* INC abs */
+        Cycles = 6;
+        EA_ABS ();
+        INC_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (6502_F0):                                       /* BEQ */
+        BRANCH (ZVal == 0);
+        NEXT ();
+
+    OP (6502_F1):                                       /* SBC (zp),y */
+        Cycles = 5;
+        EA_ZPINDY ();
+        SBC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_F5):                                       /* SBC zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        SBC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (6502_F6):                                       /* INC zp,x */
+        Cycles = 6;
+        EA_ZPX ();
+        INC_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (6502_F8):                                       /* SED */
+        Cycles = 2;
+        Other |= DF;
+        PC += 1;
+        NEXT ();
+
+    OP (6502_F9):                                       /* SBC abs,y */
+        Cycles = 4;
+        EA_ABSY ();
+        SBC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_FD):                                       /* SBC abs,x */
+        Cycles = 4;
+        EA_ABSX ();
+        SBC (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (6502_FE):                                       /* INC abs,x */
+        Cycles = 7;
+        Addr = (OPW + XR) & 0xFFFF;
+        INC_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (65C02_NOP22):                                   /* 2 byte, 2 cycle NOP */
+        Cycles = 2;
+        PC += 2;
+        NEXT ();
+
+    OP (65C02_NOP11):                                   /* 1 byte, 1 cycle NOP */
+        Cycles = 1;
+        PC += 1;
+        NEXT ();
+
+    OP (65SC02_04):                                     /* TSB zp */
+        Cycles = 5;
+        EA_ZP ();
+        TSB_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_0C):                                     /* TSB abs */
+        Cycles = 6;
+        EA_ABS ();
+        TSB_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_12):                                     /* ORA (zp) */
+        AC_OP (5, ZPIND, |, 2);
+        NEXT ();
+
+    OP (65SC02_14):                                     /* TRB zp */
+        Cycles = 5;
+        EA_ZP ();
+        TRB_MEM ();
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_1A):                                     /* INC a */
+        Cycles = 2;
+        AC = (AC + 1) & 0xFF;
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (65SC02_1C):                                     /* TRB abs */
+        Cycles = 6;
+        EA_ABS ();
+        TRB_MEM ();
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_32):                                     /* AND (zp) */
+        AC_OP (5, ZPIND, &, 2);
+        NEXT ();
+
+    OP (65SC02_34):                                     /* BIT zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        BIT (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_3A):                                     /* DEC a */
+        Cycles = 2;
+        AC = (AC - 1) & 0xFF;
+        SET_NZ (AC);
+        PC += 1;
+        NEXT ();
+
+    OP (65SC02_3C):                                     /* BIT abs,x */
+        Cycles = 4;
+        EA_ABSX ();
+        BIT (Mem[Addr]);
+        PC += 3;
+        NEXT ();
+
+    OP (65C02_44):                                      /* 'zp' 3 cycle NOP */
+        Cycles = 3;
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_52):                                     /* EOR (zp) */
+        AC_OP (5, ZPIND, ^, 2);
+        NEXT ();
+
+    OP (65C02_NOP24):                                   /* 2 byte, 4 cycle NOP */
+        Cycles = 4;
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_5A):                                     /* PHY */
+        Cycles = 3;
+        PUSH (YR);
+        PC += 1;
+        NEXT ();
+
+    OP (65C02_5C):                                      /* 'abs' 8 cycle NOP */
+        Cycles = 8;
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_64):                                     /* STZ zp */
+        Cycles = 3;
+        EA_ZP ();
+        WRITE (Addr, 0);
+        PC += 2;
+        NEXT ();
+
+    OP (65C02_6C):                                      /* JMP (ind) */
+        Cycles = 5;
+        PC = READ_W (OPW);
+        JUMP ();
+
+    OP (65SC02_72):                                     /* ADC (zp) */
+        Cycles = 5;
+        EA_ZPIND ();
+        ADC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_74):                                     /* STZ zp,x */
+        Cycles = 4;
+        EA_ZPX ();
+        WRITE (Addr, 0);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_7A):                                     /* PLY */
+        Cycles = 4;
+        YR = POP ();
+        SET_NZ (YR);
+        PC += 1;
+        NEXT ();
+
+    OP (65SC02_7C):                                     /* JMP (ind,x) */
+        Cycles = 6;
+        Addr = (OPW + XR) & 0xFFFF;
+        PC = READ_W (Addr);
+        JUMP ();
+
+    OP (65SC02_80):                                     /* BRA */
+        BRANCH (1);
+        NEXT ();
+
+    OP (65SC02_89):                                     /* BIT #imm */
+        Cycles = 2;
+        BIT (OPB);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_92):                                     /* STA (zp) */
+        Cycles = 5;
+        EA_ZPIND ();
+        WRITE (Addr, AC);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_9C):                                     /* STZ abs */
+        Cycles = 4;
+        EA_ABS ();
+        WRITE (Addr, 0);
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_9E):                                     /* STZ abs,x */
+        Cycles = 5;
+        Addr = (OPW + XR) & 0xFFFF;
+        WRITE (Addr, 0);
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_B2):                                     /* LDA (zp) */
+        LD_OP (AC, 5, ZPIND, 2);
+        NEXT ();
+
+    OP (65SC02_D2):                                     /* CMP (zp) */
+        /* Like in 6502.c, the pointer is not wrapped around in the zp */
+        Cycles = 5;
+        Addr = READ_W (OPB);
+        CMP (AC, Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_DA):                                     /* PHX */
+        Cycles = 3;
+        PUSH (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (65C02_NOP34):                                   /* 3 byte, 4 cycle NOP */
+        Cycles = 4;
+        PC += 3;
+        NEXT ();
+
+    OP (65SC02_F2):                                     /* SBC (zp) */
+        Cycles = 5;
+        EA_ZPIND ();
+        SBC (Mem[Addr]);
+        PC += 2;
+        NEXT ();
+
+    OP (65SC02_FA):                                     /* PLX */
+        Cycles = 4;
+        XR = POP ();
+        SET_NZ (XR);
+        PC += 1;
+        NEXT ();
+
+    OP (FUSED_PUSHA):                                   /* pusha */
+        FUSED_BEGIN (29);
+        YR = Mem[SpZP];
+        Cycles += 3;
+        if (YR != 0) {
+            Cycles += 2;
+            FUSED_DEC (SpZP, 6);
+            YR = 0;
+            SET_NZ (YR);
+            Cycles += 2 + 6;
+            FUSED_WRITE (READ_ZPW (SpZP), AC, 10);
+        } else {
+            FUSED_TAKEN (2, 11);
+            FUSED_DEC (SpZP1, 13);
+            FUSED_DEC (SpZP, 15);
+            Cycles += 6;
+            FUSED_WRITE (READ_ZPW (SpZP), AC, 17);
+        }
+        FUSED_RTS ();
+
+    OP (FUSED_PUSHAX):                                  /* pushax */
+        FUSED_BEGIN (49);
+        Cycles += 3;
+        FUSED_PUSH (AC, 1);
+        AC = Mem[SpZP];
+        CFlag = 1;
+        Cycles += 3 + 2 + 2;
+        SBC (2);
+        Cycles += 3;
+        FUSED_WRITE (SpZP, AC, 8);
+        if (CFlag) {
+            FUSED_TAKEN (8, 12);
+        } else {
+            Cycles += 2;
+            FUSED_DEC (SpZP1, 12);
+        }
+        YR = 1;
+        AC = XR;
+        SET_NZ (AC);
+        Cycles += 2 + 2 + 6;
+        FUSED_WRITE ((READ_ZPW (SpZP) + 1) & 0xFFFF, AC, 17);
+        AC = POP ();
+        YR = 0;
+        SET_NZ (YR);
+        Cycles += 4 + 2 + 6;
+        FUSED_WRITE (READ_ZPW (SpZP), AC, 21);
+        FUSED_RTS ();
+
+    OP (FUSED_PUSHWYSP):                                /* pushwysp */
+        FUSED_BEGIN (58);
+        AC = Mem[SpZP];
+        CFlag = 1;
+        Cycles += 3 + 2 + 2;
+        SBC (2);
+        Cycles += 3;
+        FUSED_WRITE (SpZP, AC, 7);
+        if (CFlag) {
+            FUSED_TAKEN (7, 11);
+        } else {
+            Cycles += 2;
+            FUSED_DEC (SpZP1, 11);
+        }
+        Cycles += 5;
+        EA_INDY (SpZP);
+        XR = Mem[Addr];
+        YR = (YR - 1) & 0xFF;
+        Cycles += 2 + 2 + 5;
+        EA_INDY (SpZP);
+        AC = Mem[Addr];
+        YR = 0;
+        SET_NZ (YR);
+        Cycles += 2 + 6;
+        FUSED_WRITE (READ_ZPW (SpZP), AC, 21);
+        YR = 1;
+        AC = XR;
+        SET_NZ (AC);
+        Cycles += 2 + 2 + 6;
+        FUSED_WRITE ((READ_ZPW (SpZP) + 1) & 0xFFFF, AC, 25);
+        FUSED_RTS ();
+
+    OP (FUSED_LDAXYSP):                                 /* ldaxysp */
+        FUSED_BEGIN (22);
+        Cycles += 5 + 2 + 2 + 5;
+        EA_INDY (SpZP);
+        XR = Mem[Addr];
+        YR = (YR - 1) & 0xFF;
+        EA_INDY (SpZP);
+        AC = Mem[Addr];
+        SET_NZ (AC);
+        FUSED_RTS ();
+
+    OP (FUSED_POPAX):                                   /* popax */
+        FUSED_BEGIN (45);
+        YR = 1;
+        Cycles += 2 + 5 + 2 + 2 + 5;
+        EA_INDY (SpZP);
+        XR = Mem[Addr];
+        YR = 0;
+        EA_INDY (SpZP);
+        AC = Mem[Addr];
+        SET_NZ (AC);
+        PC += 8;
+        goto Incsp2;
+
+    OP (FUSED_POPAX_C02):                               /* popax */
+        FUSED_BEGIN (42);
+        YR = 1;
+        Cycles += 2 + 5 + 2 + 5;
+        EA_INDY (SpZP);
+        XR = Mem[Addr];
+        AC = Mem[READ_ZPW (SpZP)];
+        SET_NZ (AC);
+        PC += 7;
+        goto Incsp2;
+
+    OP (FUSED_INCSP1):                                  /* incsp1 */
+        FUSED_BEGIN (18);
+        FUSED_INC (SpZP, 2);
+        if (ZVal != 0) {
+            FUSED_TAKEN (2, 6);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 6);
+        }
+        FUSED_RTS ();
+
+    OP (FUSED_INCSP2):                                  /* incsp2 */
+        FUSED_BEGIN (27);
+Incsp2:
+        FUSED_INC (SpZP, 2);
+        if (ZVal == 0) {
+            FUSED_TAKEN (2, 9);
+            FUSED_INC (SpZP, 11);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP, 6);
+            if (ZVal != 0) {
+                Cycles += 2;
+                FUSED_RTS ();
+            }
+            FUSED_TAKEN (6, 11);
+        }
+        FUSED_INC (SpZP1, 13);
+        FUSED_RTS ();
+
+    OP (FUSED_INCAX1):                                  /* incax1 */
+        FUSED_BEGIN (15);
+        CFlag = 0;
+        Cycles += 2 + 2;
+        ADC (1);
+        if (CFlag == 0) {
+            FUSED_TAKEN (3, 6);
+        } else {
+            XR = (XR + 1) & 0xFF;
+            SET_NZ (XR);
+            Cycles += 2 + 2;
+        }
+        FUSED_RTS ();
+
+    OP (FUSED_INCAX1_C02):                              /* incax1 */
+        FUSED_BEGIN (12);
+        AC = (AC + 1) & 0xFF;
+        SET_NZ (AC);
+        Cycles += 2;
+        if (ZVal != 0) {
+            FUSED_TAKEN (1, 4);
+        } else {
+            XR = (XR + 1) & 0xFF;
+            SET_NZ (XR);
+            Cycles += 2 + 2;
+        }
+        FUSED_RTS ();
+
+    OP (FUSED_TOSADDAX):                                /* tosaddax */
+        FUSED_BEGIN (54);
+        CFlag = 0;
+        YR = 0;
+        Cycles += 2 + 2 + 5;
+        EA_INDY (SpZP);
+        ADC (Mem[Addr]);
+        YR = 1;
+        SET_NZ (YR);
+        Cycles += 2 + 3;
+        FUSED_WRITE (Mem[PC + 7], AC, 8);
+        AC = XR;
+        Cycles += 2 + 5;
+        EA_INDY (SpZP);
+        ADC (Mem[Addr]);
+        XR = AC;
+        CFlag = 0;
+        AC = Mem[SpZP];
+        Cycles += 2 + 2 + 3 + 2;
+        ADC (2);
+        Cycles += 3;
+        FUSED_WRITE (SpZP, AC, 19);
+        if (CFlag == 0) {
+            FUSED_TAKEN (19, 23);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 23);
+        }
+        AC = Mem[Mem[PC + 24]];
+        SET_NZ (AC);
+        Cycles += 3;
+        FUSED_RTS ();
+
+    OP (FUSED_TOSADDAX_C02):                            /* tosaddax */
+        FUSED_BEGIN (52);
+        CFlag = 0;
+        Cycles += 2 + 5;
+        ADC (Mem[READ_ZPW (SpZP)]);
+        YR = AC;
+        Cycles += 2;
+        FUSED_INC (SpZP, 6);
+        if (ZVal != 0) {
+            FUSED_TAKEN (6, 10);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 10);
+        }
+        AC = XR;
+        Cycles += 2 + 5;
+        ADC (Mem[READ_ZPW (SpZP)]);
+        XR = AC;
+        Cycles += 2;
+        FUSED_INC (SpZP, 16);
+        if (ZVal != 0) {
+            FUSED_TAKEN (16, 20);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 20);
+        }
+        AC = YR;
+        SET_NZ (AC);
+        Cycles += 2;
+        FUSED_RTS ();
+
+    OP (FUSED_TOSICMP):                                 /* tosicmp */
+        FUSED_BEGIN (70);
+        Cycles += 3;
+        FUSED_WRITE (Mem[PC + 1], AC, 2);
+        Cycles += 3;
+        FUSED_WRITE (Mem[PC + 3], XR, 4);
+        YR = 0;
+        Cycles += 2 + 5;
+        EA_INDY (SpZP);
+        AC = XR = Mem[Addr];
+        Cycles += 2;
+        FUSED_INC (SpZP, 11);
+        if (ZVal != 0) {
+            FUSED_TAKEN (11, 15);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 15);
+        }
+        Cycles += 5;
+        EA_INDY (SpZP);
+        AC = Mem[Addr];
+        FUSED_INC (SpZP, 19);
+        if (ZVal != 0) {
+            FUSED_TAKEN (19, 23);
+        } else {
+            Cycles += 2;
+            FUSED_INC (SpZP1, 23);
+        }
+        CFlag = 1;
+        Cycles += 2 + 3;
+        SBC (Mem[Mem[PC + 25]]);
+        if (ZVal != 0) {
+            FUSED_TAKEN (26, 37);
+            if (OFlag == 0) {
+                FUSED_TAKEN (37, 36);
+            } else {
+                AC ^= 0xFF;
+                AC |= 0x01;
+                SET_NZ (AC);
+                Cycles += 2 + 2 + 2;
+            }
+        } else {
+            Cycles += 2 + 3;
+            CMP (XR, Mem[Mem[PC + 29]]);
+            if (ZVal == 0) {
+                FUSED_TAKEN (30, 36);
+            } else {
+                Cycles += 2 + 2;
+                ADC (0xFF);
+                AC |= 0x01;
+                SET_NZ (AC);
+                Cycles += 2;
+            }
+        }
+        FUSED_RTS ();
+
+#if !FAST_THREADED
+        default:
+            Internal ("Invalid operation %u", Op);
+    }
+#endif
+
+Check:
+    /* Slow path after an instruction: Call the profiler and check the limit */
+    PC &= 0xFFFF;
+    if (Flags & RUN_PROFILE) {
+        SYNC ();
+        ProfileInsn (M, (unsigned) (E - Cache), E->Opc, Cycles, Regs);
+    }
+    if (Total >= Limit) {
+        goto Leave;
+    }
+    E = Cache + PC;
+    DISPATCH ();
+
+Hook:
+    /* A jump into the paravirtualization area. The cycles of the jump are
+    ** counted after the hook has run, as in 6502.c.
+    */
+    if ((Flags & RUN_STEP) == 0) {
+        SYNC ();
+        *TotalCycles = Total;
+        M->Cycles = Cycles;             /* Needed by ResumeMachine */
+        ParaVirtHooks (M);
+        LOAD ();
+        if (Flags & RUN_PROFILE) {
+            ProfileInsn (M, (unsigned) (E - Cache), E->Opc, Cycles, Regs);
+        }
+    }
+    Total += Cycles;
+
+Leave:
+    SYNC ();
+    *TotalCycles = Total;
+}
+
+
+
+void FastRun (Machine* M, unsigned long Limit)
+/* Execute instructions until the total number of cycles of the machine reaches
+** Limit, or until a paravirtualization hook has been called.
+*/
+{
+    unsigned Flags = 0;
+
+    if (M->Profiler) {
+        Flags |= RUN_PROFILE;
+    }
+    if (M->Core == CORE_TRACE) {
+        Flags |= RUN_TRACE;
+    }
+    Run (M, &M->Regs, &M->TotalCycles, Limit, Flags);
+}
+
+
+
+unsigned FastStep (Machine* M, CPURegs* Regs)
+/* Execute exactly one instruction and return the number of cycles used. The
+** profiler is not called. If the instruction jumps into the
+** paravirtualization area, the hook isn't called, and Regs->PC is left
+** pointing to it.
+*/
+{
+    unsigned long Cycles = 0;
+    Run (M, Regs, &Cycles, 1, RUN_STEP);
+    return (unsigned) Cycles;
+}
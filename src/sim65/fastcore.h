@@ -0,0 +1,70 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 fastcore.h                                */
+/*                                                                           */
+/*                     Predecoding CPU core for the 6502                     */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef FASTCORE_H
+#define FASTCORE_H
+
+
+
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void FastInvalidate (Machine* M, unsigned Addr);
+/* Invalidate all predecoded instructions that contain the byte at Addr */
+
+void FastRun (Machine* M, unsigned long Limit);
+/* Execute instructions until the total number of cycles of the machine reaches
+** Limit, or until a paravirtualization hook has been called.
+*/
+
+unsigned FastStep (Machine* M, CPURegs* Regs);
+/* Execute exactly one instruction and return the number of cycles used. The
+** profiler is not called. If the instruction jumps into the
+** paravirtualization area, the hook isn't called, and Regs->PC is left
+** pointing to it.
+*/
+
+
+
+/* End of fastcore.h */
+
+#endif
@@ -0,0 +1,315 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 machine.c                                 */
+/*                                                                           */
+/*                            A simulated machine                            */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+
+/* common */
+#include "check.h"
+#include "print.h"
+#include "xmalloc.h"
+
+/* sim65 */
+#include "error.h"
+#include "machine.h"
+#include "paravirt.h"
+#include "profile.h"
+#include "trace.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Header signature 'sim65' */
+static const unsigned char HeaderSignature[] = {
+    0x73, 0x69, 0x6D, 0x36, 0x35
+};
+#define HEADER_SIGNATURE_LENGTH (sizeof(HeaderSignature)/sizeof(HeaderSignature[0]))
+
+static const unsigned char HeaderVersion = 2;
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+Machine* NewMachine (CPUCore Core)
+/* Create a new machine that uses the given CPU core. The standard files of
+** programs run on the machine are the ones of the simulator.
+*/
+{
+    /* Allocate memory */
+    Machine* M = xmalloc (sizeof (Machine));
+
+    /* Initialize the fields */
+    M->CPU            = CPU_6502;
+    M->Core           = Core;
+    memset (&M->Regs, 0, sizeof (M->Regs));
+    M->InsnPC         = 0;
+    M->Cycles         = 0;
+    M->TotalCycles    = 0;
+    M->HaveNMIRequest = 0;
+    M->HaveIRQRequest = 0;
+    M->Cache          = 0;
+    M->Trace          = 0;
+    M->Tracer         = 0;
+    M->Profiler       = 0;
+    M->ArgCount       = 0;
+    M->ArgVec         = 0;
+    M->SPAddr         = 0;
+    M->PauseAtArgs    = 0;
+    M->Paused         = 0;
+    M->ExitCode       = 0;
+    SB_Init (&M->Msg);
+
+    /* Initialize the subsystems */
+    MemInit (M);
+    ParaVirtInit (M);
+
+    /* Return the new machine */
+    return M;
+}
+
+
+
+void FreeMachine (Machine* M)
+/* Free a machine. Files left open by the simulated program are closed. */
+{
+    ParaVirtDone (M);
+    TraceDone (M);
+    ProfileDone (M);
+    SB_Done (&M->Msg);
+    xfree (M->Cache);
+    xfree (M->Trace);
+    xfree (M);
+}
+
+
+
+int LoadProgram (Machine* M, const char* Name, unsigned ArgCount, char** ArgVec)
+/* Load the program file with the given name into the memory of the machine.
+** ArgVec contains the arguments passed to the program, the first one should
+** be the program name. Return true if the program was loaded. Otherwise M->Msg
+** contains an error message.
+*/
+{
+    unsigned I;
+    int Val, Val2;
+    int Version;
+    unsigned Addr;
+    unsigned Load, Reset;
+    FILE* F;
+
+    /* Errors end up here */
+    if (setjmp (M->Stop) != 0) {
+        return 0;
+    }
+
+    /* Open the file */
+    F = fopen (Name, "rb");
+    if (F == 0) {
+        MachineError (M, SIM65_ERROR, "Cannot open '%s': %s", Name, strerror (errno));
+    }
+
+    /* Verify the header signature */
+    for (I = 0; I < HEADER_SIGNATURE_LENGTH; ++I) {
+        if ((Val = fgetc(F)) != HeaderSignature[I]) {
+            fclose (F);
+            MachineError (M, SIM65_ERROR, "'%s': Invalid header signature.", Name);
+        }
+    }
+
+    /* Get header version */
+    if ((Version = fgetc(F)) != HeaderVersion) {
+        fclose (F);
+        MachineError (M, SIM65_ERROR, "'%s': Invalid header version.", Name);
+    }
+
+    /* Get the CPU type from the file header */
+    if ((Val = fgetc(F)) != EOF) {
+        if (Val != CPU_6502 && Val != CPU_65C02) {
+            fclose (F);
+            MachineError (M, SIM65_ERROR, "'%s': Invalid CPU type", Name);
+        }
+        M->CPU = Val;
+    }
+
+    /* Get the address of sp from the file header */
+    if ((Val = fgetc(F)) != EOF) {
+        M->SPAddr = Val;
+    }
+
+    /* Get load address */
+    if (((Val = fgetc(F)) == EOF) ||
+        ((Val2 = fgetc(F)) == EOF)) {
+        fclose (F);
+        MachineError (M, SIM65_ERROR, "'%s': Header missing load address", Name);
+    }
+    Load = Val | (Val2 << 8);
+
+    /* Get reset address */
+    if (((Val = fgetc(F)) == EOF) ||
+        ((Val2 = fgetc(F)) == EOF)) {
+        fclose (F);
+        MachineError (M, SIM65_ERROR, "'%s': Header missing reset address", Name);
+    }
+    Reset = Val | (Val2 << 8);
+
+    /* Read the file body into memory */
+    Addr = Load;
+    while ((Val = fgetc(F)) != EOF) {
+        if (Addr >= PARAVIRT_BASE) {
+            fclose (F);
+            MachineError (M, SIM65_ERROR, "'%s': To large to fit into $%04X-$%04X",
+                          Name, Addr, PARAVIRT_BASE);
+        }
+        MemWriteByte (M, Addr++, (unsigned char) Val);
+    }
+
+    /* Check for errors */
+    if (ferror (F)) {
+        fclose (F);
+        MachineError (M, SIM65_ERROR, "Error reading from '%s': %s",
+                      Name, strerror (errno));
+    }
+
+    /* Close the file */
+    fclose (F);
+
+    Print (stderr, 1, "Loaded '%s' at $%04X-$%04X\n", Name, Load, Addr - 1);
+    Print (stderr, 1, "File version: %d\n", Version);
+    Print (stderr, 1, "Reset: $%04X\n", Reset);
+
+    MemWriteWord (M, 0xFFFC, Reset);
+
+    /* Remember the program arguments */
+    M->ArgCount = ArgCount;
+    M->ArgVec   = ArgVec;
+
+    /* Success */
+    return 1;
+}
+
+
+
+int RunMachine (Machine* M, unsigned long MaxCycles)
+/* Reset the CPU and run the loaded program until it exits, or until the total
+** number of clock cycles reaches MaxCycles. If MaxCycles is zero, there is no
+** limit. Return the exit code. If the program didn't exit normally, M->Msg
+** contains an error message. If the machine was paused, M->Paused is true,
+** and the return value is zero.
+*/
+{
+    /* StopMachine, PauseMachine and MachineError end up here */
+    M->Paused = 0;
+    if (setjmp (M->Stop) == 0) {
+        Reset (M);
+
+        /* This returns only if the cycle limit was reached */
+        ExecuteInsns (M, MaxCycles);
+        MachineError (M, SIM65_ERROR_TIMEOUT, "Maximum number of cycles reached.");
+    }
+
+    return M->ExitCode;
+}
+
+
+
+int ResumeMachine (Machine* M, unsigned long MaxCycles)
+/* Continue running a paused machine. Apart from not resetting the CPU, this
+** works like RunMachine.
+*/
+{
+    PRECONDITION (M->Paused);
+
+    M->Paused = 0;
+    if (setjmp (M->Stop) == 0) {
+
+        /* The machine was paused in a hook, so the instruction that jumped
+        ** there isn't complete. Call the hook again and count the cycles of
+        ** the jump, as ExecuteInsn would have done.
+        */
+        ParaVirtHooks (M);
+        M->TotalCycles += M->Cycles;
+
+        ExecuteInsns (M, MaxCycles);
+        MachineError (M, SIM65_ERROR_TIMEOUT, "Maximum number of cycles reached.");
+    }
+
+    return M->ExitCode;
+}
+
+
+
+void PauseMachine (Machine* M)
+/* Pause the machine. Must be called from a paravirtualization hook before it
+** changes anything, so the hook is called again when the machine is resumed.
+*/
+{
+    M->Paused   = 1;
+    M->ExitCode = 0;
+    longjmp (M->Stop, 1);
+}
+
+
+
+void StopMachine (Machine* M, int ExitCode)
+/* Stop running the machine with the given exit code */
+{
+    M->ExitCode = ExitCode;
+    longjmp (M->Stop, 1);
+}
+
+
+
+void MachineError (Machine* M, int ExitCode, const char* Format, ...)
+/* Stop running the machine because of an error. The message is stored in
+** M->Msg.
+*/
+{
+    va_list ap;
+    va_start (ap, Format);
+    SB_VPrintf (&M->Msg, Format, ap);
+    va_end (ap);
+    StopMachine (M, ExitCode);
+}
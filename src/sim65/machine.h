@@ -0,0 +1,167 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 machine.h                                 */
+/*                                                                           */
+/*                            A simulated machine                            */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef MACHINE_H
+#define MACHINE_H
+
+
+
+#include <setjmp.h>
+
+/* common */
+#include "attrib.h"
+#include "strbuf.h"
+
+/* sim65 */
+#include "6502.h"
+#include "memory.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Number of file descriptors available to a simulated program */
+#define MAX_FILES       32
+
+/* The complete state of a simulated machine. There is no global state, so any
+** number of machines may exist at the same time, and each one can be run in
+** its own thread.
+*/
+struct Machine {
+
+    /* CPU */
+    CPUType             CPU;            /* Simulated CPU */
+    CPUCore             Core;           /* CPU core used by ExecuteInsns */
+    CPURegs             Regs;           /* The CPU registers */
+    unsigned            InsnPC;         /* Address of the current insn */
+    unsigned            Cycles;         /* Cycles for the current insn */
+    unsigned long       TotalCycles;    /* Total number of CPU cycles exec'd */
+    unsigned            HaveNMIRequest; /* NMI request active */
+    unsigned            HaveIRQRequest; /* IRQ request active */
+
+    /* Memory, see memory.c */
+    unsigned char       Mem[0x10000];   /* THE memory */
+    unsigned char       MemWatch[0x100];/* Write watch flags for each page */
+    int                 Logging;        /* True if writes are logged */
+    unsigned            LogCount;       /* Number of writes since MemLogStart */
+    MemWrite            Log[16];        /* The first of these writes */
+    MemHook             Hooks[0x100];   /* Hooks for each page */
+    unsigned            HookCount;      /* Number of pages with hooks */
+
+    /* Memory tracing and watchpoints, see trace.c */
+    struct Tracer*      Tracer;
+
+    /* Execution profile, see profile.c. NULL if not profiling. */
+    struct Profiler*    Profiler;
+
+    /* Predecoded instructions, allocated by the fast core when needed */
+    struct FastInsn*    Cache;
+
+    /* Call counts and superinstructions, allocated by the trace core */
+    struct FastTrace*   Trace;
+
+    /* Paravirtualization, see paravirt.c */
+    unsigned            ArgCount;       /* Number of program arguments */
+    char**              ArgVec;         /* Program arguments, name first */
+    unsigned char       SPAddr;         /* Zero page location of the C sp */
+    int                 Files[MAX_FILES];/* Host files for the program's fds */
+    unsigned long       OwnedFiles;     /* Files opened by the program */
+    int                 PauseAtArgs;    /* Pause before passing the arguments */
+
+    /* Termination */
+    int                 Paused;         /* True if paused, see ResumeMachine */
+    jmp_buf             Stop;           /* Used to leave RunMachine */
+    int                 ExitCode;       /* Exit code of the program */
+    StrBuf              Msg;            /* Error message, empty on normal exit */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+Machine* NewMachine (CPUCore Core);
+/* Create a new machine that uses the given CPU core. The standard files of
+** programs run on the machine are the ones of the simulator.
+*/
+
+void FreeMachine (Machine* M);
+/* Free a machine. Files left open by the simulated program are closed. */
+
+int LoadProgram (Machine* M, const char* Name, unsigned ArgCount, char** ArgVec);
+/* Load the program file with the given name into the memory of the machine.
+** ArgVec contains the arguments passed to the program, the first one should
+** be the program name. Return true if the program was loaded. Otherwise M->Msg
+** contains an error message.
+*/
+
+int RunMachine (Machine* M, unsigned long MaxCycles);
+/* Reset the CPU and run the loaded program until it exits, or until the total
+** number of clock cycles reaches MaxCycles. If MaxCycles is zero, there is no
+** limit. Return the exit code. If the program didn't exit normally, M->Msg
+** contains an error message. If the machine was paused, M->Paused is true,
+** and the return value is zero.
+*/
+
+int ResumeMachine (Machine* M, unsigned long MaxCycles);
+/* Continue running a paused machine. Apart from not resetting the CPU, this
+** works like RunMachine.
+*/
+
+void PauseMachine (Machine* M) attribute ((noreturn));
+/* Pause the machine. Must be called from a paravirtualization hook before it
+** changes anything, so the hook is called again when the machine is resumed.
+*/
+
+void StopMachine (Machine* M, int ExitCode) attribute ((noreturn));
+/* Stop running the machine with the given exit code */
+
+void MachineError (Machine* M, int ExitCode, const char* Format, ...)
+    attribute ((noreturn, format (printf, 3, 4)));
+/* Stop running the machine because of an error. The message is stored in
+** M->Msg.
+*/
+
+
+
+/* End of machine.h */
+
+#endif
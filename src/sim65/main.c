@@ -33,21 +33,24 @@
 
 
 
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <errno.h>
 
 /* common */
 #include "abend.h"
 #include "cmdline.h"
+#include "coll.h"
 #include "print.h"
 #include "version.h"
 
 /* sim65 */
 #include "6502.h"
+#include "batch.h"
 #include "error.h"
-#include "memory.h"
-#include "paravirt.h"
+#include "machine.h"
+#include "profile.h"
+#include "trace.h"
 
 
 
@@ -63,13 +66,26 @@ const char* ProgramFile;
 /* exit simulator after MaxCycles Cycles */
 unsigned long MaxCycles;
 
-/* Header signature 'sim65' */
-static const unsigned char HeaderSignature[] = {
-    0x73, 0x69, 0x6D, 0x36, 0x35
-};
-#define HEADER_SIGNATURE_LENGTH (sizeof(HeaderSignature)/sizeof(HeaderSignature[0]))
+/* CPU core to use */
+static CPUCore Core = CORE_FAST;
 
-static const unsigned char HeaderVersion = 2;
+/* flag to print cycles at program termination */
+static int PrintCycles;
+
+/* Profile output and debug info file */
+static const char* ProfileFile;
+static const char* DbgInfoFile;
+
+/* Run all files on the command line, and the number of threads to use */
+static int Batch;
+static unsigned Jobs = 4;
+
+/* Run the program once for each line of this file, see RunForks */
+static const char* CaseFile;
+
+/* Memory trace file and watchpoint specs */
+static const char* TraceFile;
+static Collection Watchpoints = STATIC_COLLECTION_INITIALIZER;
 
 
 
@@ -91,9 +107,17 @@ static void Usage (void)
             "\n"
             "Long options:\n"
             "  --help\t\tHelp (this text)\n"
+            "  --batch\t\tRun all files given and report the results\n"
+            "  --core name\t\tUse the given CPU core (fast, trace, table, lockstep)\n"
             "  --cycles\t\tPrint amount of executed CPU cycles\n"
+            "  --dbgfile name\t\tRead debug info for the profile from file\n"
+            "  --fork file\t\tRun the program once for each line of file\n"
+            "  --jobs n\t\tRun up to n programs at the same time in batch mode\n"
+            "  --profile name\t\tWrite an execution profile to file\n"
+            "  --trace name\t\tWrite all memory accesses to file\n"
             "  --verbose\t\tIncrease verbosity\n"
-            "  --version\t\tPrint the simulator version number\n",
+            "  --version\t\tPrint the simulator version number\n"
+            "  --watch range\t\tStop when memory in range is accessed\n",
             ProgName);
 }
 
@@ -118,6 +142,33 @@ static void OptVerbose (const char* Opt attribute ((unused)),
 
 
 
+static void OptBatch (const char* Opt attribute ((unused)),
+                      const char* Arg attribute ((unused)))
+/* Run all program files on the command line */
+{
+    Batch = 1;
+}
+
+
+
+static void OptCore (const char* Opt attribute ((unused)), const char* Arg)
+/* Select the CPU core */
+{
+    if (strcmp (Arg, "fast") == 0) {
+        Core = CORE_FAST;
+    } else if (strcmp (Arg, "trace") == 0) {
+        Core = CORE_TRACE;
+    } else if (strcmp (Arg, "table") == 0) {
+        Core = CORE_TABLE;
+    } else if (strcmp (Arg, "lockstep") == 0) {
+        Core = CORE_LOCKSTEP;
+    } else {
+        AbEnd ("Invalid argument for --core: '%s'", Arg);
+    }
+}
+
+
+
 static void OptCycles (const char* Opt attribute ((unused)),
                        const char* Arg attribute ((unused)))
 /* Set flag to print amount of cycles at the end */
@@ -127,99 +178,96 @@ static void OptCycles (const char* Opt attribute ((unused)),
 
 
 
-static void OptVersion (const char* Opt attribute ((unused)),
-                        const char* Arg attribute ((unused)))
-/* Print the simulator version */
+static void OptDbgFile (const char* Opt attribute ((unused)), const char* Arg)
+/* Set the debug info file used for the profile */
 {
-    fprintf (stderr, "%s V%s\n", ProgName, GetVersionAsString ());
-    exit(EXIT_SUCCESS);
+    DbgInfoFile = Arg;
 }
 
-static void OptQuitXIns (const char* Opt attribute ((unused)),
-                        const char* Arg attribute ((unused)))
-/* quit after MaxCycles cycles */
+
+
+static void OptFork (const char* Opt attribute ((unused)), const char* Arg)
+/* Run the program from a snapshot once for each line of a file */
 {
-    MaxCycles = strtoul(Arg, NULL, 0);
+    CaseFile = Arg;
 }
 
-static unsigned char ReadProgramFile (void)
-/* Load program into memory */
+
+
+static void OptJobs (const char* Opt, const char* Arg)
+/* Set the number of threads used in batch mode */
 {
-    unsigned I;
-    int Val, Val2;
-    int Version;
-    unsigned Addr;
-    unsigned Load, Reset;
-    unsigned char SPAddr = 0x00;
-
-    /* Open the file */
-    FILE* F = fopen (ProgramFile, "rb");
-    if (F == 0) {
-        Error ("Cannot open '%s': %s", ProgramFile, strerror (errno));
-    }
+    char BoundsCheck;
 
-    /* Verify the header signature */
-    for (I = 0; I < HEADER_SIGNATURE_LENGTH; ++I) {
-        if ((Val = fgetc(F)) != HeaderSignature[I]) {
-            Error ("'%s': Invalid header signature.", ProgramFile);
-        }
+    /* Numeric argument expected */
+    if (sscanf (Arg, "%u%c", &Jobs, &BoundsCheck) != 1 ||
+        Jobs < 1 || Jobs > 256) {
+        AbEnd ("Argument for %s is invalid", Opt);
     }
+}
 
-    /* Get header version */
-    if ((Version = fgetc(F)) != HeaderVersion) {
-        Error ("'%s': Invalid header version.", ProgramFile);
-    }
 
-    /* Get the CPU type from the file header */
-    if ((Val = fgetc(F)) != EOF) {
-        if (Val != CPU_6502 && Val != CPU_65C02) {
-            Error ("'%s': Invalid CPU type", ProgramFile);
-        }
-        CPU = Val;
-    }
 
-    /* Get the address of sp from the file header */
-    if ((Val = fgetc(F)) != EOF) {
-        SPAddr = Val;
-    }
+static void OptProfile (const char* Opt attribute ((unused)), const char* Arg)
+/* Write an execution profile */
+{
+    ProfileFile = Arg;
+}
 
-    /* Get load address */
-    if (((Val = fgetc(F)) == EOF) ||
-        ((Val2 = fgetc(F)) == EOF)) {
-        Error ("'%s': Header missing load address", ProgramFile);
-    }
-    Load = Val | (Val2 << 8);
 
-    /* Get reset address */
-    if (((Val = fgetc(F)) == EOF) ||
-        ((Val2 = fgetc(F)) == EOF)) {
-        Error ("'%s': Header missing reset address", ProgramFile);
-    }
-    Reset = Val | (Val2 << 8);
 
-    /* Read the file body into memory */
-    Addr = Load;
-    while ((Val = fgetc(F)) != EOF) {
-        if (Addr >= PARAVIRT_BASE) {
-            Error ("'%s': To large to fit into $%04X-$%04X", ProgramFile, Addr, PARAVIRT_BASE);
-        }
-        MemWriteByte (Addr++, (unsigned char) Val);
-    }
+static void OptTrace (const char* Opt attribute ((unused)), const char* Arg)
+/* Write a memory trace */
+{
+    TraceFile = Arg;
+}
 
-    /* Check for errors */
-    if (ferror (F)) {
-        Error ("Error reading from '%s': %s", ProgramFile, strerror (errno));
+
+
+static void OptWatch (const char* Opt, const char* Arg)
+/* Add a watchpoint */
+{
+    unsigned First, Last, Access;
+
+    if (!TraceParseWatch (Arg, &First, &Last, &Access)) {
+        AbEnd ("Argument for %s is invalid: '%s'", Opt, Arg);
     }
+    CollAppend (&Watchpoints, (void*) Arg);
+}
+
 
-    /* Close the file */
-    fclose (F);
 
-    Print (stderr, 1, "Loaded '%s' at $%04X-$%04X\n", ProgramFile, Load, Addr - 1);
-    Print (stderr, 1, "File version: %d\n", Version);
-    Print (stderr, 1, "Reset: $%04X\n", Reset);
+static void OptVersion (const char* Opt attribute ((unused)),
+                        const char* Arg attribute ((unused)))
+/* Print the simulator version */
+{
+    fprintf (stderr, "%s V%s\n", ProgName, GetVersionAsString ());
+    exit(EXIT_SUCCESS);
+}
 
-    MemWriteWord(0xFFFC, Reset);
-    return SPAddr;
+static void OptQuitXIns (const char* Opt attribute ((unused)),
+                        const char* Arg attribute ((unused)))
+/* quit after MaxCycles cycles */
+{
+    MaxCycles = strtoul(Arg, NULL, 0);
+}
+
+
+
+static void CheckBatchFiles (unsigned Count, char** Files)
+/* Make sure no program is given twice in batch mode. Both runs would write
+** the same output file at the same time.
+*/
+{
+    unsigned I, J;
+
+    for (I = 1; I < Count; ++I) {
+        for (J = 0; J < I; ++J) {
+            if (strcmp (Files[I], Files[J]) == 0) {
+                AbEnd ("'%s' is given more than once", Files[I]);
+            }
+        }
+    }
 }
 
 
@@ -229,13 +277,22 @@ int main (int argc, char* argv[])
     /* Program long options */
     static const LongOpt OptTab[] = {
         { "--help",             0,      OptHelp                 },
+        { "--batch",            0,      OptBatch                },
+        { "--core",             1,      OptCore                 },
         { "--cycles",           0,      OptCycles               },
+        { "--dbgfile",          1,      OptDbgFile              },
+        { "--fork",             1,      OptFork                 },
+        { "--jobs",             1,      OptJobs                 },
+        { "--profile",          1,      OptProfile              },
+        { "--trace",            1,      OptTrace                },
         { "--verbose",          0,      OptVerbose              },
         { "--version",          0,      OptVersion              },
+        { "--watch",            1,      OptWatch                },
     };
 
     unsigned I;
-    unsigned char SPAddr;
+    Machine* M;
+    int Code;
 
     /* Initialize the cmdline module */
     InitCmdLine (&argc, &argv, "sim65");
@@ -295,21 +352,77 @@ int main (int argc, char* argv[])
         AbEnd ("No program file");
     }
 
-    MemInit ();
+    /* Tracing works only for a single program */
+    if ((Batch || CaseFile) && (TraceFile || CollCount (&Watchpoints) > 0)) {
+        AbEnd ("--trace and --watch cannot be used together with %s",
+               Batch? "--batch" : "--fork");
+    }
 
-    SPAddr = ReadProgramFile ();
+    /* Debug info is only used for the profile */
+    if (DbgInfoFile && !ProfileFile) {
+        Warning ("Debug info is only used together with --profile");
+    }
 
-    ParaVirtInit (I, SPAddr);
+    /* In batch mode, all remaining arguments are program files */
+    if (Batch) {
+        if (CaseFile) {
+            AbEnd ("--fork cannot be used together with --batch");
+        }
+        if (DbgInfoFile) {
+            AbEnd ("--dbgfile cannot be used together with --batch");
+        }
+        CheckBatchFiles (ArgCount - I, ArgVec + I);
+        return RunBatch (ArgCount - I, ArgVec + I, Core, MaxCycles, Jobs,
+                         ProfileFile);
+    }
 
-    Reset ();
+    /* With --fork, the arguments come from the case file */
+    if (CaseFile) {
+        if (I + 1 < ArgCount) {
+            AbEnd ("Program arguments cannot be used together with --fork");
+        }
+        return RunForks (ProgramFile, CaseFile, Core, MaxCycles, Jobs,
+                         ProfileFile, DbgInfoFile);
+    }
+
+    /* Create the machine and load the program */
+    M = NewMachine (Core);
+    if (!LoadProgram (M, ProgramFile, ArgCount - I, ArgVec + I)) {
+        Error ("%s", SB_GetConstBuf (&M->Msg));
+    }
+
+    if (ProfileFile) {
+        ProfileStart (M);
+    }
 
-    while (1) {
-        ExecuteInsn ();
-        if (MaxCycles && (GetCycles () >= MaxCycles)) {
-            ErrorCode (SIM65_ERROR_TIMEOUT, "Maximum number of cycles reached.");
+    /* Setup the memory trace and the watchpoints */
+    if (TraceFile && !TraceOpen (M, TraceFile)) {
+        Error ("%s", SB_GetConstBuf (&M->Msg));
+    }
+    for (I = 0; I < CollCount (&Watchpoints); ++I) {
+        unsigned First, Last, Access;
+        TraceParseWatch (CollConstAt (&Watchpoints, I), &First, &Last, &Access);
+        TraceWatch (M, First, Last, Access);
+    }
+
+    /* Run the program */
+    Code = RunMachine (M, MaxCycles);
+    if (PrintCycles && SB_IsEmpty (&M->Msg)) {
+        Print (stdout, 0, "%lu cycles\n", GetCycles (M));
+    }
+    if (ProfileFile) {
+        StrBuf Msg = STATIC_STRBUF_INITIALIZER;
+        if (!ProfileWrite (M, ProfileFile, DbgInfoFile, &Msg)) {
+            SB_Terminate (&Msg);
+            Error ("%s", SB_GetConstBuf (&Msg));
         }
+        SB_Done (&Msg);
+    }
+    if (SB_NotEmpty (&M->Msg)) {
+        ErrorCode (Code, "%s", SB_GetConstBuf (&M->Msg));
     }
+    FreeMachine (M);
 
-    /* Return an apropriate exit code */
-    return EXIT_SUCCESS;
+    /* Return the exit code of the program */
+    return Code;
 }
@@ -35,76 +35,237 @@
 
 #include <string.h>
 
+/* common */
+#include "check.h"
+
+/* sim65 */
+#include "fastcore.h"
+#include "machine.h"
 #include "memory.h"
 
 
 
 /*****************************************************************************/
-/*                                   Data                                    */
+/*                                   Code                                    */
 /*****************************************************************************/
 
 
 
-/* THE memory */
-static unsigned char Mem[0x10000];
+void MemWriteByte (Machine* M, unsigned Addr, unsigned char Val)
+/* Write a byte to a memory location */
+{
+    if (M->MemWatch[Addr >> 8]) {
+        MemWatchedWrite (M, Addr, Val);
+    } else {
+        M->Mem[Addr] = Val;
+    }
+}
 
 
 
-/*****************************************************************************/
-/*                                   Code                                    */
-/*****************************************************************************/
+void MemWatchedWrite (Machine* M, unsigned Addr, unsigned char Val)
+/* Write a byte to a memory location in a page with a non zero MemWatch entry */
+{
+    const MemHook* H = M->Hooks + (Addr >> 8);
 
+    /* Let the hook see or change the value */
+    if (M->MemWatch[Addr >> 8] & MEM_WATCH_WRITE) {
+        Val = H->Func (M, H->Data, MEM_WRITE, Addr, Val);
+    }
 
+    /* Record the write if requested */
+    if (M->Logging) {
+        if (M->LogCount < sizeof (M->Log) / sizeof (M->Log[0])) {
+            M->Log[M->LogCount].Addr = Addr;
+            M->Log[M->LogCount].Old  = M->Mem[Addr];
+            M->Log[M->LogCount].New  = Val;
+        }
+        ++M->LogCount;
+    }
 
-void MemWriteByte (unsigned Addr, unsigned char Val)
-/* Write a byte to a memory location */
-{
-    Mem[Addr] = Val;
+    M->Mem[Addr] = Val;
+
+    /* Drop predecoded instructions that contain this byte */
+    if (M->MemWatch[Addr >> 8] & MEM_WATCH_CODE) {
+        FastInvalidate (M, Addr);
+    }
 }
 
 
 
-void MemWriteWord (unsigned Addr, unsigned Val)
+void MemWriteWord (Machine* M, unsigned Addr, unsigned Val)
 /* Write a word to a memory location */
 {
-    MemWriteByte (Addr, Val & 0xFF);
-    MemWriteByte (Addr + 1, Val >> 8);
+    MemWriteByte (M, Addr, Val & 0xFF);
+    MemWriteByte (M, Addr + 1, Val >> 8);
 }
 
 
 
-unsigned char MemReadByte (unsigned Addr)
+unsigned char MemReadByte (Machine* M, unsigned Addr)
 /* Read a byte from a memory location */
 {
-    return Mem[Addr];
+    if (M->MemWatch[Addr >> 8] & MEM_WATCH_READ) {
+        const MemHook* H = M->Hooks + (Addr >> 8);
+        return H->Func (M, H->Data, MEM_READ, Addr, M->Mem[Addr]);
+    }
+    return M->Mem[Addr];
 }
 
 
 
-unsigned MemReadWord (unsigned Addr)
+unsigned char MemFetchOpcode (Machine* M, unsigned Addr)
+/* Read the opcode of the instruction at Addr. If the page hooks execs, the
+** hook is called for an exec instead of a read. Otherwise this is the same as
+** MemReadByte.
+*/
+{
+    if (M->MemWatch[Addr >> 8] & MEM_WATCH_EXEC) {
+        const MemHook* H = M->Hooks + (Addr >> 8);
+        H->Func (M, H->Data, MEM_EXEC, Addr, M->Mem[Addr]);
+        return M->Mem[Addr];
+    }
+    return MemReadByte (M, Addr);
+}
+
+
+
+unsigned MemReadWord (Machine* M, unsigned Addr)
 /* Read a word from a memory location */
 {
-    unsigned W = MemReadByte (Addr++);
-    return (W | (MemReadByte (Addr) << 8));
+    unsigned W = MemReadByte (M, Addr++);
+    return (W | (MemReadByte (M, Addr) << 8));
 }
 
 
 
-unsigned MemReadZPWord (unsigned char Addr)
+unsigned MemReadZPWord (Machine* M, unsigned char Addr)
 /* Read a word from the zero page. This function differs from MemReadWord in that
 ** the read will always be in the zero page, even in case of an address
 ** overflow.
 */
 {
-    unsigned W = MemReadByte (Addr++);
-    return (W | (MemReadByte (Addr) << 8));
+    unsigned W = MemReadByte (M, Addr++);
+    return (W | (MemReadByte (M, Addr) << 8));
 }
 
 
 
-void MemInit (void)
-/* Initialize the memory subsystem */
+void MemLogStart (Machine* M)
+/* Start recording writes to memory */
+{
+    unsigned I;
+
+    /* All writes have to go through MemWatchedWrite while logging */
+    if (!(M->MemWatch[0] & MEM_WATCH_LOG)) {
+        for (I = 0; I < sizeof (M->MemWatch); ++I) {
+            M->MemWatch[I] |= MEM_WATCH_LOG;
+        }
+    }
+
+    M->Logging  = 1;
+    M->LogCount = 0;
+}
+
+
+
+unsigned MemLogStop (Machine* M, MemWrite* Writes, unsigned Max)
+/* Stop recording writes to memory. Copy up to Max of the recorded writes into
+** Writes, and return the total number of writes since MemLogStart.
+*/
+{
+    unsigned Count = M->LogCount;
+    if (Count > sizeof (M->Log) / sizeof (M->Log[0])) {
+        Count = sizeof (M->Log) / sizeof (M->Log[0]);
+    }
+    if (Count > Max) {
+        Count = Max;
+    }
+    memcpy (Writes, M->Log, Count * sizeof (M->Log[0]));
+
+    M->Logging = 0;
+    return M->LogCount;
+}
+
+
+
+void MemSetHook (Machine* M, unsigned First, unsigned Last, unsigned Access,
+                 MemHookFunc Func, void* Data)
+/* Let accesses of the given kinds to all pages containing the addresses from
+** First to Last call Func. The function has to check the address itself if
+** the range doesn't cover whole pages. Each page has one hook, which replaces
+** an earlier one for the page. If Access is zero, the hooks are removed. As
+** long as there are hooks, the machine runs the table core, since the fast
+** core accesses memory directly.
+*/
+{
+    unsigned Page;
+
+    PRECONDITION (First <= Last && Last <= 0xFFFF);
+    PRECONDITION ((Access & ~MEM_WATCH_HOOK) == 0 && (Access == 0 || Func != 0));
+
+    for (Page = First >> 8; Page <= (Last >> 8); ++Page) {
+        if (M->MemWatch[Page] & MEM_WATCH_HOOK) {
+            --M->HookCount;
+        }
+        M->MemWatch[Page] = (M->MemWatch[Page] & ~MEM_WATCH_HOOK) | Access;
+        M->Hooks[Page].Func = Access? Func : 0;
+        M->Hooks[Page].Data = Access? Data : 0;
+        if (Access) {
+            ++M->HookCount;
+        }
+    }
+}
+
+
+
+void MemSave (const Machine* M, unsigned char* Mem)
+/* Copy the complete memory of the machine to Mem, which has room for 64K */
+{
+    memcpy (Mem, M->Mem, sizeof (M->Mem));
+}
+
+
+
+void MemRestore (Machine* M, const unsigned char* Mem)
+/* Replace the complete memory of the machine by the 64K at Mem. Only pages
+** that differ are copied, and predecoded instructions are dropped only where
+** bytes actually change, so restoring a machine that ran for a short time is
+** cheap and keeps most of its instruction cache.
+*/
+{
+    unsigned Page;
+    unsigned Addr;
+
+    for (Page = 0; Page < 0x10000; Page += 0x100) {
+        if (memcmp (M->Mem + Page, Mem + Page, 0x100) == 0) {
+            continue;
+        }
+        if (M->MemWatch[Page >> 8] & MEM_WATCH_CODE) {
+            for (Addr = Page; Addr < Page + 0x100; ++Addr) {
+                if (M->Mem[Addr] != Mem[Addr]) {
+                    M->Mem[Addr] = Mem[Addr];
+                    FastInvalidate (M, Addr);
+                }
+            }
+        } else {
+            memcpy (M->Mem + Page, Mem + Page, 0x100);
+        }
+    }
+}
+
+
+
+void MemInit (Machine* M)
+/* Initialize the memory of a machine */
 {
     /* Fill memory with illegal opcode */
-    memset (Mem, 0xFF, sizeof (Mem));
+    memset (M->Mem, 0xFF, sizeof (M->Mem));
+
+    /* Nothing is watched, hooked or logged */
+    memset (M->MemWatch, 0, sizeof (M->MemWatch));
+    memset (M->Hooks, 0, sizeof (M->Hooks));
+    M->HookCount = 0;
+    M->Logging  = 0;
+    M->LogCount = 0;
 }
@@ -38,32 +38,128 @@
 
 
 
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* The memory of a machine is in Machine.Mem. Only the fast CPU core accesses
+** it directly, everyone else must use the functions below.
+*/
+
+/* Write watch flags for each memory page in Machine.MemWatch. Writes to a page
+** with a non zero entry must go through MemWatchedWrite.
+*/
+#define MEM_WATCH_CODE  0x01U           /* Page contains predecoded code */
+#define MEM_WATCH_LOG   0x02U           /* Writes may have to be logged */
+#define MEM_WATCH_READ  0x04U           /* Reads call the hook of the page */
+#define MEM_WATCH_WRITE 0x08U           /* Writes call the hook of the page */
+#define MEM_WATCH_EXEC  0x10U           /* Opcode fetches call the hook */
+#define MEM_WATCH_HOOK  (MEM_WATCH_READ | MEM_WATCH_WRITE | MEM_WATCH_EXEC)
+
+/* Kinds of memory accesses passed to a hook. These are the MemWatch bits. */
+#define MEM_READ        MEM_WATCH_READ
+#define MEM_WRITE       MEM_WATCH_WRITE
+#define MEM_EXEC        MEM_WATCH_EXEC
+
+/* A function that is called for accesses to a hooked page. Access is one of
+** MEM_READ, MEM_WRITE or MEM_EXEC. Val is the byte in memory for a read, the
+** byte written for a write, and the opcode for an exec, which is reported
+** before the instruction runs. For a read, the return value is passed to the CPU
+** instead of the memory contents; for a write, it is stored in memory. So a
+** hook that returns Val doesn't change anything. The return value for an
+** exec is ignored. M->InsnPC is the address of the current instruction, and
+** M->TotalCycles the cycle count at its start.
+*/
+typedef unsigned char (*MemHookFunc) (Machine* M, void* Data, unsigned Access,
+                                      unsigned Addr, unsigned char Val);
+
+/* The hook of a page */
+typedef struct MemHook MemHook;
+struct MemHook {
+    MemHookFunc         Func;           /* Function to call */
+    void*               Data;           /* Passed to Func */
+};
+
+/* A logged memory write */
+typedef struct MemWrite MemWrite;
+struct MemWrite {
+    unsigned            Addr;           /* Address written to */
+    unsigned char       Old;            /* Old contents */
+    unsigned char       New;            /* Value written */
+};
+
+
+
 /*****************************************************************************/
 /*                                   Code                                    */
 /*****************************************************************************/
 
 
 
-void MemWriteByte (unsigned Addr, unsigned char Val);
+void MemWriteByte (Machine* M, unsigned Addr, unsigned char Val);
 /* Write a byte to a memory location */
 
-void MemWriteWord (unsigned Addr, unsigned Val);
+void MemWatchedWrite (Machine* M, unsigned Addr, unsigned char Val);
+/* Write a byte to a memory location in a page with a non zero MemWatch entry */
+
+void MemWriteWord (Machine* M, unsigned Addr, unsigned Val);
 /* Write a word to a memory location */
 
-unsigned char MemReadByte (unsigned Addr);
+unsigned char MemReadByte (Machine* M, unsigned Addr);
 /* Read a byte from a memory location */
 
-unsigned MemReadWord (unsigned Addr);
+unsigned char MemFetchOpcode (Machine* M, unsigned Addr);
+/* Read the opcode of the instruction at Addr. If the page hooks execs, the
+** hook is called for an exec instead of a read. Otherwise this is the same as
+** MemReadByte.
+*/
+
+unsigned MemReadWord (Machine* M, unsigned Addr);
 /* Read a word from a memory location */
 
-unsigned MemReadZPWord (unsigned char Addr);
+unsigned MemReadZPWord (Machine* M, unsigned char Addr);
 /* Read a word from the zero page. This function differs from MemReadWord in that
 ** the read will always be in the zero page, even in case of an address
 ** overflow.
 */
 
-void MemInit (void);
-/* Initialize the memory subsystem */
+void MemLogStart (Machine* M);
+/* Start recording writes to memory */
+
+unsigned MemLogStop (Machine* M, MemWrite* Writes, unsigned Max);
+/* Stop recording writes to memory. Copy up to Max of the recorded writes into
+** Writes, and return the total number of writes since MemLogStart.
+*/
+
+void MemSetHook (Machine* M, unsigned First, unsigned Last, unsigned Access,
+                 MemHookFunc Func, void* Data);
+/* Let accesses of the given kinds to all pages containing the addresses from
+** First to Last call Func. The function has to check the address itself if
+** the range doesn't cover whole pages. Each page has one hook, which replaces
+** an earlier one for the page. If Access is zero, the hooks are removed. As
+** long as there are hooks, the machine runs the table core, since the fast
+** core accesses memory directly.
+*/
+
+void MemSave (const Machine* M, unsigned char* Mem);
+/* Copy the complete memory of the machine to Mem, which has room for 64K */
+
+void MemRestore (Machine* M, const unsigned char* Mem);
+/* Replace the complete memory of the machine by the 64K at Mem. Only pages
+** that differ are copied, and predecoded instructions are dropped only where
+** bytes actually change, so restoring a machine that ran for a short time is
+** cheap and keeps most of its instruction cache.
+*/
+
+void MemInit (Machine* M);
+/* Initialize the memory of a machine */
 
 
 
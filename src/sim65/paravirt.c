@@ -57,12 +57,13 @@
 #endif
 
 /* common */
-#include "cmdline.h"
+#include "check.h"
 #include "print.h"
 #include "xmalloc.h"
 
 /* sim65 */
 #include "6502.h"
+#include "machine.h"
 #include "memory.h"
 #include "paravirt.h"
 
@@ -74,10 +75,7 @@
 
 
 
-typedef void (*PVFunc) (CPURegs* Regs);
-
-static unsigned ArgStart;
-static unsigned char SPAddr;
+typedef void (*PVFunc) (Machine* M, CPURegs* Regs);
 
 
 
@@ -98,82 +96,98 @@ static void SetAX (CPURegs* Regs, unsigned Val)
 {
     Regs->AC = Val & 0xFF;
     Val >>= 8;
-    Regs->XR = Val;
+    Regs->XR = Val & 0xFF;
 }
 
 
 
-static unsigned char Pop (CPURegs* Regs)
+static unsigned char Pop (Machine* M, CPURegs* Regs)
 {
-    return MemReadByte (0x0100 + ++Regs->SP);
+    Regs->SP = (Regs->SP + 1) & 0xFF;
+    return MemReadByte (M, 0x0100 + Regs->SP);
 }
 
 
 
-static unsigned PopParam (unsigned char Incr)
+static unsigned PopParam (Machine* M, unsigned char Incr)
 {
-    unsigned SP = MemReadZPWord (SPAddr);
-    unsigned Val = MemReadWord (SP);
-    MemWriteWord (SPAddr, SP + Incr);
+    unsigned SP = MemReadZPWord (M, M->SPAddr);
+    unsigned Val = MemReadWord (M, SP);
+    MemWriteWord (M, M->SPAddr, SP + Incr);
     return Val;
 }
 
 
 
-static void PVExit (CPURegs* Regs)
+static int GetFile (const Machine* M, unsigned FD)
+/* Return the host file for a file descriptor of the simulated program, or -1
+** if it isn't open.
+*/
+{
+    return (FD < MAX_FILES)? M->Files[FD] : -1;
+}
+
+
+
+static void PVExit (Machine* M, CPURegs* Regs)
 {
     Print (stderr, 1, "PVExit ($%02X)\n", Regs->AC);
-    if (PrintCycles) {
-        Print (stdout, 0, "%lu cycles\n", GetCycles ());
-    }
 
-    exit (Regs->AC);
+    StopMachine (M, Regs->AC);
 }
 
 
 
-static void PVArgs (CPURegs* Regs)
+static void PVArgs (Machine* M, CPURegs* Regs)
 {
-    unsigned ArgC = ArgCount - ArgStart;
+    unsigned ArgC = M->ArgCount;
     unsigned ArgV = GetAX (Regs);
-    unsigned SP   = MemReadZPWord (SPAddr);
+    unsigned SP   = MemReadZPWord (M, M->SPAddr);
     unsigned Args = SP - (ArgC + 1) * 2;
+    unsigned N;
+
+    /* A fork server takes its snapshot here, see RunForks */
+    if (M->PauseAtArgs) {
+        M->PauseAtArgs = 0;
+        PauseMachine (M);
+    }
 
     Print (stderr, 2, "PVArgs ($%04X)\n", ArgV);
 
-    MemWriteWord (ArgV, Args);
+    MemWriteWord (M, ArgV, Args);
 
     SP = Args;
-    while (ArgStart < ArgCount) {
+    for (N = 0; N < ArgC; ++N) {
         unsigned I = 0;
-        const char* Arg = ArgVec[ArgStart++];
+        const char* Arg = M->ArgVec[N];
         SP -= strlen (Arg) + 1;
         do {
-            MemWriteByte (SP + I, Arg[I]);
+            MemWriteByte (M, SP + I, Arg[I]);
         }
         while (Arg[I++]);
 
-        MemWriteWord (Args, SP);
+        MemWriteWord (M, Args, SP);
         Args += 2;
     }
-    MemWriteWord (Args, SPAddr);
+    MemWriteWord (M, Args, M->SPAddr);
 
-    MemWriteWord (SPAddr, SP);
+    MemWriteWord (M, M->SPAddr, SP);
     SetAX (Regs, ArgC);
 }
 
 
 
-static void PVOpen (CPURegs* Regs)
+static void PVOpen (Machine* M, CPURegs* Regs)
 {
     char Path[1024];
     int OFlag = O_INITIAL;
     int OMode = 0;
+    int F;
     unsigned RetVal, I = 0;
 
-    unsigned Mode  = PopParam (Regs->YR - 4);
-    unsigned Flags = PopParam (2);
-    unsigned Name  = PopParam (2);
+    unsigned Mode  = PopParam (M, Regs->YR - 4);
+    unsigned Flags = PopParam (M, 2);
+    unsigned Name  = PopParam (M, 2);
 
     if (Regs->YR - 4 < 2) {
         /* If the caller didn't supply the mode
@@ -183,7 +197,7 @@ static void PVOpen (CPURegs* Regs)
     }
 
     do {
-        Path[I] = MemReadByte (Name++);
+        Path[I] = MemReadByte (M, Name++);
     }
     while (Path[I++]);
 
@@ -220,46 +234,70 @@ static void PVOpen (CPURegs* Regs)
         OMode |= S_IWRITE;
     }
 
-    RetVal = open (Path, OFlag, OMode);
+    /* Use the lowest free file descriptor of the program */
+    RetVal = 0;
+    while (RetVal < MAX_FILES && M->Files[RetVal] >= 0) {
+        ++RetVal;
+    }
+
+    if (RetVal < MAX_FILES && (F = open (Path, OFlag, OMode)) >= 0) {
+        M->Files[RetVal] = F;
+        M->OwnedFiles |= (1UL << RetVal);
+    } else {
+        RetVal = (unsigned) -1;
+    }
 
     SetAX (Regs, RetVal);
 }
 
 
 
-static void PVClose (CPURegs* Regs)
+static void PVClose (Machine* M, CPURegs* Regs)
 {
     unsigned RetVal;
 
     unsigned FD = GetAX (Regs);
+    int      F  = GetFile (M, FD);
 
     Print (stderr, 2, "PVClose ($%04X)\n", FD);
 
-    RetVal = close (FD);
+    if (F < 0) {
+        RetVal = (unsigned) -1;
+    } else {
+        /* Files of the simulator itself are left open */
+        if (M->OwnedFiles & (1UL << FD)) {
+            RetVal = close (F);
+        } else {
+            RetVal = 0;
+        }
+        M->Files[FD] = -1;
+        M->OwnedFiles &= ~(1UL << FD);
+    }
 
     SetAX (Regs, RetVal);
 }
 
 
 
-static void PVRead (CPURegs* Regs)
+static void PVRead (Machine* M, CPURegs* Regs)
 {
     unsigned char* Data;
     unsigned RetVal, I = 0;
 
     unsigned Count = GetAX (Regs);
-    unsigned Buf   = PopParam (2);
-    unsigned FD    = PopParam (2);
+    unsigned Buf   = PopParam (M, 2);
+    unsigned FD    = PopParam (M, 2);
+    int      F     = GetFile (M, FD);
 
     Print (stderr, 2, "PVRead ($%04X, $%04X, $%04X)\n", FD, Buf, Count);
 
     Data = xmalloc (Count);
 
-    RetVal = read (FD, Data, Count);
+    RetVal = (F < 0)? (unsigned) -1 : (unsigned) read (F, Data, Count);
 
     if (RetVal != (unsigned) -1) {
         while (I < RetVal) {
-            MemWriteByte (Buf++, Data[I++]);
+            MemWriteByte (M, Buf++, Data[I++]);
         }
     }
     xfree (Data);
@@ -269,23 +307,24 @@ static void PVRead (CPURegs* Regs)
 
 
 
-static void PVWrite (CPURegs* Regs)
+static void PVWrite (Machine* M, CPURegs* Regs)
 {
     unsigned char* Data;
     unsigned RetVal, I = 0;
 
     unsigned Count = GetAX (Regs);
-    unsigned Buf   = PopParam (2);
-    unsigned FD    = PopParam (2);
+    unsigned Buf   = PopParam (M, 2);
+    unsigned FD    = PopParam (M, 2);
+    int      F     = GetFile (M, FD);
 
     Print (stderr, 2, "PVWrite ($%04X, $%04X, $%04X)\n", FD, Buf, Count);
 
     Data = xmalloc (Count);
     while (I < Count) {
-        Data[I++] = MemReadByte (Buf++);
+        Data[I++] = MemReadByte (M, Buf++);
     }
 
-    RetVal = write (FD, Data, Count);
+    RetVal = (F < 0)? (unsigned) -1 : (unsigned) write (F, Data, Count);
 
     xfree (Data);
 
@@ -305,18 +344,91 @@ static const PVFunc Hooks[] = {
 
 
 
-void ParaVirtInit (unsigned aArgStart, unsigned char aSPAddr)
-/* Initialize the paravirtualization subsystem */
+void ParaVirtInit (Machine* M)
+/* Initialize the paravirtualization subsystem of a machine. The standard files
+** of the simulated program are the ones of the simulator.
+*/
 {
-    ArgStart = aArgStart;
-    SPAddr = aSPAddr;
-};
+    unsigned I;
+
+    for (I = 0; I < MAX_FILES; ++I) {
+        M->Files[I] = -1;
+    }
+    M->Files[0] = 0;
+    M->Files[1] = 1;
+    M->Files[2] = 2;
+    M->OwnedFiles = 0;
+}
 
 
 
-void ParaVirtHooks (CPURegs* Regs)
+void ParaVirtDone (Machine* M)
+/* Close all files that were opened by the simulated program */
+{
+    ParaVirtCloseFiles (M->Files, M->OwnedFiles);
+    M->OwnedFiles = 0;
+}
+
+
+
+void ParaVirtCopyFiles (int* Dst, const int* Src, unsigned long Owned)
+/* Copy the MAX_FILES entries of the file table Src to Dst. The host files in
+** Owned are duplicated, so both tables may be closed independently. Note that
+** the duplicates share the file position with the originals.
+*/
+{
+    unsigned I;
+
+    for (I = 0; I < MAX_FILES; ++I) {
+        if (Owned & (1UL << I)) {
+            Dst[I] = dup (Src[I]);
+        } else {
+            Dst[I] = Src[I];
+        }
+    }
+}
+
+
+
+void ParaVirtCloseFiles (int* Files, unsigned long Owned)
+/* Close the host files in Owned and mark all MAX_FILES entries of the file
+** table Files as not open.
+*/
+{
+    unsigned I;
+
+    for (I = 0; I < MAX_FILES; ++I) {
+        if ((Owned & (1UL << I)) && Files[I] >= 0) {
+            close (Files[I]);
+        }
+        Files[I] = -1;
+    }
+}
+
+
+
+void ParaVirtSetFile (Machine* M, unsigned FD, int HostFD)
+/* Let the file descriptor FD of the simulated program refer to the file HostFD
+** of the simulator. HostFD may be -1, which means that FD isn't open. The host
+** file is never closed by the machine.
+*/
+{
+    PRECONDITION (FD < MAX_FILES);
+
+    if (M->OwnedFiles & (1UL << FD)) {
+        close (M->Files[FD]);
+        M->OwnedFiles &= ~(1UL << FD);
+    }
+    M->Files[FD] = HostFD;
+}
+
+
+
+void ParaVirtHooks (Machine* M)
 /* Potentially execute paravirtualization hooks */
 {
+    CPURegs* Regs = &M->Regs;
+
     /* Check for paravirtualization address range */
     if (Regs->PC <  PARAVIRT_BASE ||
         Regs->PC >= PARAVIRT_BASE + sizeof (Hooks) / sizeof (Hooks[0])) {
@@ -324,8 +436,8 @@ void ParaVirtHooks (CPURegs* Regs)
     }
 
     /* Call paravirtualization hook */
-    Hooks[Regs->PC - PARAVIRT_BASE] (Regs);
+    Hooks[Regs->PC - PARAVIRT_BASE] (M, Regs);
 
     /* Simulate RTS */
-    Regs->PC = Pop(Regs) + (Pop(Regs) << 8) + 1;
+    Regs->PC = Pop (M, Regs) + (Pop (M, Regs) << 8) + 1;
 }
@@ -38,6 +38,11 @@
 
 
 
+/* sim65 */
+#include "6502.h"
+
+
+
 /*****************************************************************************/
 /*                                   Data                                    */
 /*****************************************************************************/
@@ -55,10 +60,32 @@
 
 
 
-void ParaVirtInit (unsigned aArgStart, unsigned char aSPAddr);
-/* Initialize the paravirtualization subsystem */
+void ParaVirtInit (Machine* M);
+/* Initialize the paravirtualization subsystem of a machine. The standard files
+** of the simulated program are the ones of the simulator.
+*/
+
+void ParaVirtDone (Machine* M);
+/* Close all files that were opened by the simulated program */
+
+void ParaVirtSetFile (Machine* M, unsigned FD, int HostFD);
+/* Let the file descriptor FD of the simulated program refer to the file HostFD
+** of the simulator. HostFD may be -1, which means that FD isn't open. The host
+** file is never closed by the machine.
+*/
+
+void ParaVirtCopyFiles (int* Dst, const int* Src, unsigned long Owned);
+/* Copy the MAX_FILES entries of the file table Src to Dst. The host files in
+** Owned are duplicated, so both tables may be closed independently. Note that
+** the duplicates share the file position with the originals.
+*/
+
+void ParaVirtCloseFiles (int* Files, unsigned long Owned);
+/* Close the host files in Owned and mark all MAX_FILES entries of the file
+** table Files as not open.
+*/
 
-void ParaVirtHooks (CPURegs* Regs);
+void ParaVirtHooks (Machine* M);
 /* Potentially execute paravirtualization hooks */
 
 
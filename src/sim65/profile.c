@@ -0,0 +1,703 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 profile.c                                 */
+/*                                                                           */
+/*              Execution profiler for the sim65 6502 simulator              */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* common */
+#include "attrib.h"
+#include "coll.h"
+#include "hashtab.h"
+#include "strbuf.h"
+#include "xmalloc.h"
+#include "xsprintf.h"
+
+/* dbginfo */
+#include "dbginfo.h"
+
+/* sim65 */
+#include "error.h"
+#include "machine.h"
+#include "memory.h"
+#include "profile.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* Opcode of the JSR insn */
+#define OPC_JSR         0x20
+
+/* Stack pointer value for the frame of the main program. It is above any
+** value of the 8 bit stack pointer, so the frame is never left.
+*/
+#define ROOT_SP         0x100
+
+/* Maximum number of active calls. Since each call needs two bytes on the
+** stack, there cannot be more than 128 plus the main program.
+*/
+#define MAX_FRAMES      256
+
+/* Counters for one address */
+typedef struct ProfAddr ProfAddr;
+struct ProfAddr {
+    unsigned long       Count;          /* Executions of the insn here */
+    unsigned long       Cycles;         /* Cycles used by the insn here */
+    unsigned long       Calls;          /* Calls of a routine at this address */
+    unsigned long       Self;           /* Cycles spent in the routine itself */
+    unsigned long       Total;          /* Cycles including called routines */
+    unsigned            Active;         /* Number of active calls */
+};
+
+/* An active subroutine call */
+typedef struct CallFrame CallFrame;
+struct CallFrame {
+    unsigned            Caller;         /* Address of the calling routine */
+    unsigned            Callee;         /* Address of the called routine */
+    unsigned            SP;             /* Stack pointer after the call */
+    unsigned long       Start;          /* Cycle count when called */
+};
+
+/* An edge in the call graph */
+typedef struct CallEdge CallEdge;
+struct CallEdge {
+    HashNode            Node;           /* Node in the hash table */
+    unsigned            Key;            /* Caller and callee */
+    unsigned long       Count;          /* Number of calls */
+    unsigned long       Cycles;         /* Cycles spent in the calls */
+};
+
+/* Execution counts for a source line */
+typedef struct LineCount LineCount;
+struct LineCount {
+    unsigned            Source;         /* Id of the source file */
+    unsigned            Line;           /* Line number */
+    unsigned long       Count;          /* Number of executed insns */
+    unsigned long       Cycles;         /* Cycles used by the insns */
+};
+
+/* Hash table functions for call graph edges */
+static unsigned HT_GenHash (const void* Key);
+static const void* HT_GetKey (const void* Entry);
+static int HT_Compare (const void* Key1, const void* Key2);
+static const HashFunctions EdgeFunctions = {
+    HT_GenHash,
+    HT_GetKey,
+    HT_Compare
+};
+
+/* The profiler of one machine */
+typedef struct Profiler Profiler;
+struct Profiler {
+    ProfAddr            Prof[0x10000];  /* Counters for all addresses */
+    CallFrame           Frames[MAX_FRAMES];/* Stack of active calls */
+    unsigned            FrameCount;     /* Number of active calls */
+    HashTable           Edges;          /* Edges of the call graph */
+    unsigned long       Clock;          /* Cycles counted by the profiler */
+    cc65_dbginfo        DbgInfo;        /* Debug info used for the report */
+};
+
+
+
+/*****************************************************************************/
+/*                              Hash table functions                         */
+/*****************************************************************************/
+
+
+
+static unsigned HT_GenHash (const void* Key)
+/* Generate the hash over a key. */
+{
+    unsigned K = *(const unsigned*) Key;
+    return (K >> 16) * 31 + (K & 0xFFFF);
+}
+
+
+
+static const void* HT_GetKey (const void* Entry)
+/* Given a pointer to the user entry data, return a pointer to the key */
+{
+    return &((const CallEdge*) Entry)->Key;
+}
+
+
+
+static int HT_Compare (const void* Key1, const void* Key2)
+/* Compare two keys. The function must return a value less than zero if
+** Key1 is smaller than Key2, zero if both are equal, and a value greater
+** than zero if Key1 is greater then Key2.
+*/
+{
+    unsigned K1 = *(const unsigned*) Key1;
+    unsigned K2 = *(const unsigned*) Key2;
+    return (K1 < K2)? -1 : (K1 > K2);
+}
+
+
+
+/*****************************************************************************/
+/*                                Call tracking                              */
+/*****************************************************************************/
+
+
+
+static CallEdge* GetEdge (Profiler* P, unsigned Caller, unsigned Callee)
+/* Return the call graph edge from Caller to Callee, create it if needed */
+{
+    unsigned Key = (Caller << 16) | Callee;
+    CallEdge* E = HT_Find (&P->Edges, &Key);
+    if (E == 0) {
+        E = xmalloc (sizeof (CallEdge));
+        InitHashNode (&E->Node);
+        E->Key    = Key;
+        E->Count  = 0;
+        E->Cycles = 0;
+        HT_Insert (&P->Edges, E);
+    }
+    return E;
+}
+
+
+
+static void PushFrame (Profiler* P, unsigned Caller, unsigned Callee,
+                       unsigned SP)
+/* Remember a call of Callee */
+{
+    if (P->FrameCount < MAX_FRAMES) {
+        CallFrame* F = P->Frames + P->FrameCount++;
+        F->Caller = Caller;
+        F->Callee = Callee;
+        F->SP     = SP;
+        F->Start  = P->Clock;
+        ++P->Prof[Callee].Calls;
+        ++P->Prof[Callee].Active;
+    }
+}
+
+
+
+static void PopFrame (Profiler* P)
+/* Remove the innermost call and account the cycles used */
+{
+    const CallFrame* F = P->Frames + --P->FrameCount;
+    ProfAddr* A = P->Prof + F->Callee;
+    unsigned long Cycles = P->Clock - F->Start;
+
+    /* For recursive routines, count the outermost call only */
+    if (--A->Active == 0) {
+        A->Total += Cycles;
+    }
+
+    /* The main program has no caller */
+    if (P->FrameCount > 0) {
+        CallEdge* E = GetEdge (P, F->Caller, F->Callee);
+        ++E->Count;
+        E->Cycles += Cycles;
+    }
+}
+
+
+
+static int FreeEdge (void* Entry, void* Data attribute ((unused)))
+/* Free a call graph edge and remove it from the table */
+{
+    xfree (Entry);
+    return 1;
+}
+
+
+
+static void ClearProfile (Profiler* P)
+/* Remove all counters and the call graph */
+{
+    memset (P->Prof, 0, sizeof (P->Prof));
+    P->FrameCount = 0;
+    P->Clock      = 0;
+    HT_Walk (&P->Edges, FreeEdge, 0);
+}
+
+
+
+/*****************************************************************************/
+/*                                 Debug info                                */
+/*****************************************************************************/
+
+
+
+static void DbgInfoError (const cc65_parseerror* E)
+/* Report errors from reading the debug info file */
+{
+    Warning ("%s:%u: %s", E->name, E->line, E->errormsg);
+}
+
+
+
+static const char* GetName (const Profiler* P, unsigned Addr, char* Buf,
+                            size_t Size)
+/* Return a name for the routine at the given address. The name is created in
+** the given buffer.
+*/
+{
+    const cc65_symbolinfo* S;
+    const char* Name = 0;
+    unsigned I;
+
+    /* Without debug info, just use the address */
+    if (P->DbgInfo == 0 ||
+        (S = cc65_symbol_inrange (P->DbgInfo, Addr, Addr)) == 0) {
+        xsprintf (Buf, Size, "$%04X", Addr);
+        return Buf;
+    }
+
+    /* Prefer a label that is not local to a .proc, since the name of the
+    ** .proc itself lives in the enclosing scope.
+    */
+    for (I = 0; I < S->count; ++I) {
+        const cc65_symboldata* D = S->data + I;
+        const cc65_scopeinfo* Scope;
+        if (D->symbol_type != CC65_SYM_LABEL || D->parent_id != CC65_INV_ID) {
+            continue;
+        }
+        if (Name == 0) {
+            Name = D->symbol_name;
+        }
+        Scope = cc65_scope_byid (P->DbgInfo, D->scope_id);
+        if (Scope) {
+            int Local = (Scope->data[0].scope_type == CC65_SCOPE_SCOPE);
+            cc65_free_scopeinfo (P->DbgInfo, Scope);
+            if (!Local) {
+                Name = D->symbol_name;
+                break;
+            }
+        }
+    }
+    if (Name) {
+        xsprintf (Buf, Size, "%s", Name);
+    } else {
+        xsprintf (Buf, Size, "$%04X", Addr);
+    }
+    cc65_free_symbolinfo (P->DbgInfo, S);
+    return Buf;
+}
+
+
+
+/*****************************************************************************/
+/*                                   Report                                  */
+/*****************************************************************************/
+
+
+
+static double Percent (const Profiler* P, unsigned long Cycles)
+/* Return Cycles as percentage of the cycles of the complete run */
+{
+    return P->Clock? (100.0 * Cycles) / P->Clock : 0.0;
+}
+
+
+
+static int CompareRoutines (void* Data, const void* Left, const void* Right)
+/* Sort routines by the cycles spent in them. Data is the profiler. */
+{
+    const Profiler* P = Data;
+    const ProfAddr* L = P->Prof + (unsigned) (size_t) Left;
+    const ProfAddr* R = P->Prof + (unsigned) (size_t) Right;
+    if (L->Self != R->Self) {
+        return (L->Self < R->Self)? 1 : -1;
+    }
+    return (L->Total < R->Total) - (L->Total > R->Total);
+}
+
+
+
+static int CompareEdges (void* Data attribute ((unused)),
+                         const void* Left, const void* Right)
+/* Sort call graph edges by the cycles spent in the calls */
+{
+    const CallEdge* L = Left;
+    const CallEdge* R = Right;
+    return (L->Cycles < R->Cycles) - (L->Cycles > R->Cycles);
+}
+
+
+
+static int CollectEdge (void* Entry, void* Data)
+/* Add a call graph edge to a collection */
+{
+    CollAppend (Data, Entry);
+    return 0;
+}
+
+
+
+static int CompareLines (const void* Left, const void* Right)
+/* Sort source lines by source file and line number */
+{
+    const LineCount* L = Left;
+    const LineCount* R = Right;
+    if (L->Source != R->Source) {
+        return (L->Source < R->Source)? -1 : 1;
+    }
+    return (L->Line > R->Line) - (L->Line < R->Line);
+}
+
+
+
+static int CompareLineCycles (const void* Left, const void* Right)
+/* Sort source lines by the cycles spent in them */
+{
+    const LineCount* L = Left;
+    const LineCount* R = Right;
+    if (L->Cycles != R->Cycles) {
+        return (L->Cycles < R->Cycles)? 1 : -1;
+    }
+    return CompareLines (Left, Right);
+}
+
+
+
+static void WriteFlatProfile (const Profiler* P, FILE* F, Collection* Routines)
+/* Write the cycles spent per routine */
+{
+    char     Name[256];
+    unsigned I;
+
+    fprintf (F,
+             "Flat profile (%lu cycles):\n"
+             "\n"
+             "  %%time        self       total       calls  routine\n",
+             P->Clock);
+    for (I = 0; I < CollCount (Routines); ++I) {
+        unsigned Addr = (unsigned) (size_t) CollAt (Routines, I);
+        const ProfAddr* A = P->Prof + Addr;
+        fprintf (F, "%7.2f %11lu %11lu %11lu  %s\n",
+                 Percent (P, A->Self), A->Self, A->Total, A->Calls,
+                 GetName (P, Addr, Name, sizeof (Name)));
+    }
+    fputc ('\n', F);
+}
+
+
+
+static void WriteCallGraph (Profiler* P, FILE* F, Collection* Routines)
+/* Write callers and callees of all routines */
+{
+    Collection Calls = STATIC_COLLECTION_INITIALIZER;
+    char Name[256];
+    unsigned I, J;
+
+    /* Get all edges, most expensive first */
+    HT_Walk (&P->Edges, CollectEdge, &Calls);
+    CollSort (&Calls, CompareEdges, 0);
+
+    fprintf (F,
+             "Call graph:\n"
+             "\n"
+             "                                       calls      cycles\n");
+    for (I = 0; I < CollCount (Routines); ++I) {
+
+        unsigned Addr = (unsigned) (size_t) CollAt (Routines, I);
+        const ProfAddr* A = P->Prof + Addr;
+
+        fprintf (F, "%s ($%04X): %.2f%% self, %.2f%% total\n",
+                 GetName (P, Addr, Name, sizeof (Name)), Addr,
+                 Percent (P, A->Self), Percent (P, A->Total));
+
+        for (J = 0; J < CollCount (&Calls); ++J) {
+            const CallEdge* E = CollConstAt (&Calls, J);
+            if ((E->Key & 0xFFFF) == Addr) {
+                fprintf (F, "    <- %-28s %11lu %11lu\n",
+                         GetName (P, E->Key >> 16, Name, sizeof (Name)),
+                         E->Count, E->Cycles);
+            }
+        }
+        for (J = 0; J < CollCount (&Calls); ++J) {
+            const CallEdge* E = CollConstAt (&Calls, J);
+            if ((E->Key >> 16) == Addr) {
+                fprintf (F, "    -> %-28s %11lu %11lu\n",
+                         GetName (P, E->Key & 0xFFFF, Name, sizeof (Name)),
+                         E->Count, E->Cycles);
+            }
+        }
+        fputc ('\n', F);
+    }
+
+    DoneCollection (&Calls);
+}
+
+
+
+static void WriteLineProfile (const Profiler* P, FILE* F)
+/* Write the cycles spent per source line */
+{
+    LineCount* Lines;
+    cc65_addr* Addrs;
+    cc65_addrdata* Data;
+    unsigned AddrCount = 0;
+    unsigned Count = 0;
+    unsigned Addr;
+    unsigned I;
+
+    /* Get all executed addresses. They are sorted, so the debug info can
+    ** resolve them in one pass.
+    */
+    Addrs = xmalloc (0x10000 * sizeof (Addrs[0]));
+    for (Addr = 0; Addr < 0x10000; ++Addr) {
+        if (P->Prof[Addr].Count) {
+            Addrs[AddrCount++] = Addr;
+        }
+    }
+    Data = xmalloc (AddrCount * sizeof (Data[0]));
+    cc65_lookup_addresses (P->DbgInfo, Addrs, AddrCount, Data);
+
+    /* Get the line for each executed address */
+    Lines = xmalloc (AddrCount * sizeof (Lines[0]));
+    for (I = 0; I < AddrCount; ++I) {
+        if (Data[I].line_id == CC65_INV_ID) {
+            continue;
+        }
+        Addr = Addrs[I];
+        Lines[Count].Source = Data[I].source_id;
+        Lines[Count].Line   = Data[I].source_line;
+        Lines[Count].Count  = P->Prof[Addr].Count;
+        Lines[Count].Cycles = P->Prof[Addr].Cycles;
+        ++Count;
+    }
+    xfree (Data);
+    xfree (Addrs);
+
+    /* Merge the counts for identical lines */
+    if (Count > 0) {
+        unsigned Last = 0;
+        qsort (Lines, Count, sizeof (Lines[0]), CompareLines);
+        for (I = 1; I < Count; ++I) {
+            if (CompareLines (Lines + Last, Lines + I) == 0) {
+                Lines[Last].Count  += Lines[I].Count;
+                Lines[Last].Cycles += Lines[I].Cycles;
+            } else {
+                Lines[++Last] = Lines[I];
+            }
+        }
+        Count = Last + 1;
+        qsort (Lines, Count, sizeof (Lines[0]), CompareLineCycles);
+    }
+
+    fprintf (F,
+             "Source lines:\n"
+             "\n"
+             "  %%time      cycles       insns  line\n");
+    for (I = 0; I < Count; ++I) {
+        const cc65_sourceinfo* S = cc65_source_byid (P->DbgInfo, Lines[I].Source);
+        fprintf (F, "%7.2f %11lu %11lu  %s:%u\n",
+                 Percent (P, Lines[I].Cycles), Lines[I].Cycles, Lines[I].Count,
+                 S? S->data[0].source_name : "???", Lines[I].Line);
+        if (S) {
+            cc65_free_sourceinfo (P->DbgInfo, S);
+        }
+    }
+    fputc ('\n', F);
+
+    xfree (Lines);
+}
+
+
+
+static void WriteAddrProfile (const Profiler* P, FILE* F)
+/* Write the counts for each executed address */
+{
+    unsigned Addr;
+
+    fprintf (F,
+             "Addresses:\n"
+             "\n"
+             "   addr       count      cycles\n");
+    for (Addr = 0; Addr < 0x10000; ++Addr) {
+        const ProfAddr* A = P->Prof + Addr;
+        if (A->Count) {
+            fprintf (F, "  $%04X %11lu %11lu\n", Addr, A->Count, A->Cycles);
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void ProfileStart (Machine* M)
+/* Start counting the instructions executed on machine M. If the profiler of
+** the machine is already running, its counters are cleared.
+*/
+{
+    Profiler* P = M->Profiler;
+    if (P == 0) {
+        P = xmalloc (sizeof (Profiler));
+        InitHashTable (&P->Edges, 1024, &EdgeFunctions);
+        P->DbgInfo = 0;
+        M->Profiler = P;
+    }
+    ClearProfile (P);
+}
+
+
+
+void ProfileInsn (Machine* M, unsigned PC, unsigned char OPC, unsigned Cycles,
+                  const CPURegs* Regs)
+/* Account for an instruction at PC that has just been executed on machine M.
+** Regs are the CPU registers after execution.
+*/
+{
+    Profiler* P = M->Profiler;
+    unsigned SP = Regs->SP & 0xFF;
+
+    /* Count the insn */
+    ++P->Prof[PC].Count;
+    P->Prof[PC].Cycles += Cycles;
+    P->Clock += Cycles;
+
+    /* The first insn is the entry of the main program */
+    if (P->FrameCount == 0) {
+        PushFrame (P, PC, PC, ROOT_SP);
+    }
+
+    /* The insn belongs to the innermost active routine */
+    P->Prof[P->Frames[P->FrameCount-1].Callee].Self += Cycles;
+
+    /* If the stack pointer is above the frame of a routine, the routine has
+    ** returned.
+    */
+    while (P->Frames[P->FrameCount-1].SP < SP) {
+        PopFrame (P);
+    }
+
+    /* Check for a new call */
+    if (OPC == OPC_JSR) {
+        unsigned Target = MemReadWord (M, (PC + 1) & 0xFFFF);
+        PushFrame (P, P->Frames[P->FrameCount-1].Callee, Target, SP);
+        if (Regs->PC != Target) {
+            /* Paravirtualization hook, has returned already */
+            PopFrame (P);
+        }
+    }
+}
+
+
+
+int ProfileWrite (Machine* M, const char* OutName, const char* DbgName,
+                  StrBuf* Msg)
+/* Write the profile report of machine M to the file OutName. If DbgName is
+** not NULL, it is the name of an ld65 debug info file used to add symbol
+** names and source lines to the report. Return true if the report was
+** written. Otherwise Msg contains an error message.
+*/
+{
+    Collection Routines = STATIC_COLLECTION_INITIALIZER;
+    Profiler* P = M->Profiler;
+    FILE* F;
+    unsigned Addr;
+    int Ok;
+
+    /* Terminate all active calls */
+    while (P->FrameCount > 0) {
+        PopFrame (P);
+    }
+
+    /* Open the output file */
+    F = fopen (OutName, "w");
+    if (F == 0) {
+        SB_Printf (Msg, "Cannot open '%s': %s", OutName, strerror (errno));
+        return 0;
+    }
+
+    /* Read the debug info */
+    if (DbgName) {
+        P->DbgInfo = cc65_read_dbginfo (DbgName, DbgInfoError);
+        if (P->DbgInfo == 0) {
+            Warning ("Cannot read debug info from '%s'", DbgName);
+        }
+    }
+
+    /* Get all routines that were called */
+    for (Addr = 0; Addr < 0x10000; ++Addr) {
+        if (P->Prof[Addr].Calls) {
+            CollAppend (&Routines, (void*) (size_t) Addr);
+        }
+    }
+    CollSort (&Routines, CompareRoutines, P);
+
+    /* Write the report */
+    WriteFlatProfile (P, F, &Routines);
+    WriteCallGraph (P, F, &Routines);
+    if (P->DbgInfo) {
+        WriteLineProfile (P, F);
+    }
+    WriteAddrProfile (P, F);
+    Ok = (fclose (F) == 0);
+    if (!Ok) {
+        SB_Printf (Msg, "Error writing '%s': %s", OutName, strerror (errno));
+    }
+
+    /* Cleanup */
+    DoneCollection (&Routines);
+    if (P->DbgInfo) {
+        cc65_free_dbginfo (P->DbgInfo);
+        P->DbgInfo = 0;
+    }
+
+    /* Return the result */
+    return Ok;
+}
+
+
+
+void ProfileDone (Machine* M)
+/* Stop the profiler of machine M and free the profile data */
+{
+    Profiler* P = M->Profiler;
+    if (P) {
+        HT_Walk (&P->Edges, FreeEdge, 0);
+        DoneHashTable (&P->Edges);
+        xfree (P);
+        M->Profiler = 0;
+    }
+}
@@ -0,0 +1,80 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 profile.h                                 */
+/*                                                                           */
+/*              Execution profiler for the sim65 6502 simulator              */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+
+
+/* common */
+#include "strbuf.h"
+
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+void ProfileStart (Machine* M);
+/* Start counting the instructions executed on machine M. If the profiler of
+** the machine is already running, its counters are cleared.
+*/
+
+void ProfileInsn (Machine* M, unsigned PC, unsigned char OPC, unsigned Cycles,
+                  const CPURegs* Regs);
+/* Account for an instruction at PC that has just been executed on machine M.
+** Regs are the CPU registers after execution.
+*/
+
+int ProfileWrite (Machine* M, const char* OutName, const char* DbgName,
+                  StrBuf* Msg);
+/* Write the profile report of machine M to the file OutName. If DbgName is
+** not NULL, it is the name of an ld65 debug info file used to add symbol
+** names and source lines to the report. Return true if the report was
+** written. Otherwise Msg contains an error message.
+*/
+
+void ProfileDone (Machine* M);
+/* Stop the profiler of machine M and free the profile data */
+
+
+
+/* End of profile.h */
+
+#endif
@@ -0,0 +1,148 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 snapshot.c                                */
+/*                                                                           */
+/*                     Saved state of a simulated machine                    */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+#include <string.h>
+
+/* common */
+#include "xmalloc.h"
+
+/* sim65 */
+#include "machine.h"
+#include "memory.h"
+#include "paravirt.h"
+#include "snapshot.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+struct Snapshot {
+
+    /* CPU */
+    CPUType             CPU;            /* Simulated CPU */
+    CPURegs             Regs;           /* The CPU registers */
+    unsigned            Cycles;         /* Cycles for the current insn */
+    unsigned long       TotalCycles;    /* Total number of CPU cycles exec'd */
+    unsigned            HaveNMIRequest; /* NMI request active */
+    unsigned            HaveIRQRequest; /* IRQ request active */
+    int                 Paused;         /* Machine was paused */
+
+    /* Memory */
+    unsigned char       Mem[0x10000];
+
+    /* Paravirtualization */
+    unsigned char       SPAddr;         /* Zero page location of the C sp */
+    int                 Files[MAX_FILES];/* Host files for the program's fds */
+    unsigned long       OwnedFiles;     /* Files opened by the program */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+Snapshot* TakeSnapshot (const Machine* M)
+/* Save the state of the machine and return it. If the machine is paused, it
+** can be resumed after restoring the snapshot.
+*/
+{
+    Snapshot* S = xmalloc (sizeof (Snapshot));
+
+    S->CPU            = M->CPU;
+    S->Regs           = M->Regs;
+    S->Cycles         = M->Cycles;
+    S->TotalCycles    = M->TotalCycles;
+    S->HaveNMIRequest = M->HaveNMIRequest;
+    S->HaveIRQRequest = M->HaveIRQRequest;
+    S->Paused         = M->Paused;
+    MemSave (M, S->Mem);
+    S->SPAddr         = M->SPAddr;
+    ParaVirtCopyFiles (S->Files, M->Files, M->OwnedFiles);
+    S->OwnedFiles     = M->OwnedFiles;
+
+    return S;
+}
+
+
+
+void RestoreSnapshot (Machine* M, const Snapshot* S)
+/* Set the state of the machine to the one saved in S. The CPU core of the
+** machine and the program arguments don't change. Since only memory pages
+** that differ are copied, restoring the same snapshot into one machine over
+** and over is much cheaper than creating a new machine each time.
+*/
+{
+    M->CPU            = S->CPU;
+    M->Regs           = S->Regs;
+    M->Cycles         = S->Cycles;
+    M->TotalCycles    = S->TotalCycles;
+    M->HaveNMIRequest = S->HaveNMIRequest;
+    M->HaveIRQRequest = S->HaveIRQRequest;
+    M->Paused         = S->Paused;
+    MemRestore (M, S->Mem);
+    M->SPAddr         = S->SPAddr;
+    ParaVirtDone (M);
+    ParaVirtCopyFiles (M->Files, S->Files, S->OwnedFiles);
+    M->OwnedFiles     = S->OwnedFiles;
+
+    /* Forget the results of earlier runs */
+    M->PauseAtArgs    = 0;
+    M->ExitCode       = 0;
+    SB_Clear (&M->Msg);
+}
+
+
+
+Machine* ForkMachine (const Snapshot* S, CPUCore Core)
+/* Create a new machine with the given CPU core from a snapshot */
+{
+    Machine* M = NewMachine (Core);
+    RestoreSnapshot (M, S);
+    return M;
+}
+
+
+
+void FreeSnapshot (Snapshot* S)
+/* Free a snapshot */
+{
+    ParaVirtCloseFiles (S->Files, S->OwnedFiles);
+    xfree (S);
+}
@@ -0,0 +1,86 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                 snapshot.h                                */
+/*                                                                           */
+/*                     Saved state of a simulated machine                    */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+
+
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* The saved state of a machine: CPU registers, cycle counters, memory and the
+** file table of the simulated program. The program arguments are not part of
+** a snapshot.
+*/
+typedef struct Snapshot Snapshot;
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+Snapshot* TakeSnapshot (const Machine* M);
+/* Save the state of the machine and return it. If the machine is paused, it
+** can be resumed after restoring the snapshot.
+*/
+
+void RestoreSnapshot (Machine* M, const Snapshot* S);
+/* Set the state of the machine to the one saved in S. The CPU core of the
+** machine and the program arguments don't change. Since only memory pages
+** that differ are copied, restoring the same snapshot into one machine over
+** and over is much cheaper than creating a new machine each time.
+*/
+
+Machine* ForkMachine (const Snapshot* S, CPUCore Core);
+/* Create a new machine with the given CPU core from a snapshot */
+
+void FreeSnapshot (Snapshot* S);
+/* Free a snapshot */
+
+
+
+/* End of snapshot.h */
+
+#endif
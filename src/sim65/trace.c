@@ -0,0 +1,306 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  trace.c                                  */
+/*                                                                           */
+/*                       Memory tracing and watchpoints                      */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* common */
+#include "check.h"
+#include "coll.h"
+#include "xmalloc.h"
+
+/* sim65 */
+#include "error.h"
+#include "machine.h"
+#include "memory.h"
+#include "trace.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* A watchpoint */
+typedef struct Watchpoint Watchpoint;
+struct Watchpoint {
+    unsigned            First;          /* First address watched */
+    unsigned            Last;           /* Last address watched */
+    unsigned            Access;         /* Kinds of accesses watched */
+};
+
+/* Tracing state of a machine */
+typedef struct Tracer Tracer;
+struct Tracer {
+    FILE*               F;              /* Trace file or NULL */
+    Collection          Watchpoints;    /* List of watchpoints */
+};
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+static const char* AccessName (unsigned Access)
+/* Return a name for the kind of access */
+{
+    switch (Access) {
+        case MEM_READ:  return "Read";
+        case MEM_WRITE: return "Write";
+        default:        return "Execution";
+    }
+}
+
+
+
+static void WriteRecord (Machine* M, FILE* F, unsigned Access, unsigned Addr,
+                         unsigned char Val)
+/* Write a trace record */
+{
+    unsigned char       Buf[TRACE_RECORD_SIZE];
+    unsigned long       Cycles = M->TotalCycles;
+    unsigned            I;
+
+    Buf[0] = (Access == MEM_READ)? 'r' : (Access == MEM_WRITE)? 'w' : 'x';
+    Buf[1] = Val;
+    Buf[2] = (unsigned char) M->InsnPC;
+    Buf[3] = (unsigned char) (M->InsnPC >> 8);
+    Buf[4] = (unsigned char) Addr;
+    Buf[5] = (unsigned char) (Addr >> 8);
+    for (I = 6; I < TRACE_RECORD_SIZE; ++I) {
+        Buf[I] = (unsigned char) Cycles;
+        Cycles >>= 8;
+    }
+    fwrite (Buf, sizeof (Buf), 1, F);
+}
+
+
+
+static unsigned char TraceHook (Machine* M, void* Data, unsigned Access,
+                                unsigned Addr, unsigned char Val)
+/* Memory hook used for tracing and watchpoints */
+{
+    const Tracer* T = Data;
+    unsigned      I;
+
+    if (T->F) {
+        WriteRecord (M, T->F, Access, Addr, Val);
+    }
+
+    for (I = 0; I < CollCount (&T->Watchpoints); ++I) {
+        const Watchpoint* W = CollConstAt (&T->Watchpoints, I);
+        if ((W->Access & Access) != 0 && Addr >= W->First && Addr <= W->Last) {
+            if (T->F) {
+                fflush (T->F);
+            }
+            MachineError (M, SIM65_ERROR,
+                          "Watchpoint: %s of $%02X at $%04X by the "
+                          "instruction at $%04X after %lu cycles",
+                          AccessName (Access), Val, Addr, M->InsnPC,
+                          M->TotalCycles);
+        }
+    }
+
+    return Val;
+}
+
+
+
+static Tracer* GetTracer (Machine* M)
+/* Return the tracing state of the machine, creating it if necessary */
+{
+    if (M->Tracer == 0) {
+        Tracer* T = xmalloc (sizeof (Tracer));
+        T->F = 0;
+        InitCollection (&T->Watchpoints);
+        M->Tracer = T;
+    }
+    return M->Tracer;
+}
+
+
+
+static void UpdateHooks (Machine* M)
+/* Set the memory hooks of all pages according to the tracing state */
+{
+    Tracer*  T = M->Tracer;
+    unsigned Page;
+    unsigned I;
+
+    for (Page = 0; Page < 0x100; ++Page) {
+        unsigned First  = Page << 8;
+        unsigned Last   = First + 0xFF;
+        unsigned Access = T->F? MEM_WATCH_HOOK : 0;
+        for (I = 0; I < CollCount (&T->Watchpoints); ++I) {
+            const Watchpoint* W = CollConstAt (&T->Watchpoints, I);
+            if (W->First <= Last && W->Last >= First) {
+                Access |= W->Access;
+            }
+        }
+        MemSetHook (M, First, Last, Access, TraceHook, T);
+    }
+}
+
+
+
+int TraceOpen (Machine* M, const char* Name)
+/* Write a record for each memory access of the CPU to the file with the given
+** name. Opcode fetches are written as execs, all other accesses as reads or
+** writes. Return true if the file was created. Otherwise M->Msg contains an
+** error message.
+*/
+{
+    static const unsigned char Header[TRACE_HEADER_SIZE] = {
+        'S', '6', '5', 'T', TRACE_VERSION, TRACE_RECORD_SIZE, 0, 0
+    };
+
+    Tracer* T = GetTracer (M);
+    PRECONDITION (T->F == 0);
+
+    T->F = fopen (Name, "wb");
+    if (T->F == 0) {
+        SB_Printf (&M->Msg, "Cannot create '%s': %s", Name, strerror (errno));
+        return 0;
+    }
+    fwrite (Header, sizeof (Header), 1, T->F);
+
+    UpdateHooks (M);
+    return 1;
+}
+
+
+
+void TraceWatch (Machine* M, unsigned First, unsigned Last, unsigned Access)
+/* Stop the machine with an error when the CPU accesses one of the addresses
+** from First to Last. Access is a combination of MEM_READ, MEM_WRITE and
+** MEM_EXEC. The machine is stopped before a write changes memory, and before
+** an instruction executes.
+*/
+{
+    Tracer*     T = GetTracer (M);
+    Watchpoint* W = xmalloc (sizeof (Watchpoint));
+
+    W->First  = First;
+    W->Last   = Last;
+    W->Access = Access;
+    CollAppend (&T->Watchpoints, W);
+
+    UpdateHooks (M);
+}
+
+
+
+int TraceParseWatch (const char* Spec, unsigned* First, unsigned* Last,
+                     unsigned* Access)
+/* Parse a watchpoint given as "addr[-addr][:access]". Addresses may be given
+** in C notation or with a leading '$' for hex. The access is a combination of
+** the letters r, w and x, and defaults to w. Return true if the spec is valid.
+*/
+{
+    char*         End;
+    unsigned long Val;
+
+    /* First address */
+    if (*Spec == '$') {
+        Val = strtoul (Spec + 1, &End, 16);
+    } else {
+        Val = strtoul (Spec, &End, 0);
+    }
+    if (End == Spec || Val > 0xFFFF) {
+        return 0;
+    }
+    *First = *Last = (unsigned) Val;
+    Spec = End;
+
+    /* Optional last address */
+    if (*Spec == '-') {
+        ++Spec;
+        if (*Spec == '$') {
+            Val = strtoul (Spec + 1, &End, 16);
+        } else {
+            Val = strtoul (Spec, &End, 0);
+        }
+        if (End == Spec || Val > 0xFFFF || Val < *First) {
+            return 0;
+        }
+        *Last = (unsigned) Val;
+        Spec = End;
+    }
+
+    /* Optional kind of access */
+    *Access = MEM_WRITE;
+    if (*Spec == ':') {
+        *Access = 0;
+        while (*++Spec) {
+            switch (*Spec) {
+                case 'r':   *Access |= MEM_READ;    break;
+                case 'w':   *Access |= MEM_WRITE;   break;
+                case 'x':   *Access |= MEM_EXEC;    break;
+                default:    return 0;
+            }
+        }
+    }
+
+    return *Spec == '\0' && *Access != 0;
+}
+
+
+
+void TraceDone (Machine* M)
+/* Close the trace file, remove all watchpoints and the memory hooks */
+{
+    Tracer*  T = M->Tracer;
+    unsigned I;
+
+    if (T == 0) {
+        return;
+    }
+
+    MemSetHook (M, 0, 0xFFFF, 0, 0, 0);
+    if (T->F) {
+        fclose (T->F);
+    }
+    for (I = 0; I < CollCount (&T->Watchpoints); ++I) {
+        xfree (CollAtUnchecked (&T->Watchpoints, I));
+    }
+    DoneCollection (&T->Watchpoints);
+    xfree (T);
+    M->Tracer = 0;
+}
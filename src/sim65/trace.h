@@ -0,0 +1,102 @@
+/*****************************************************************************/
+/*                                                                           */
+/*                                  trace.h                                  */
+/*                                                                           */
+/*                       Memory tracing and watchpoints                      */
+/*                                                                           */
+/*                                                                           */
+/*                                                                           */
+/* (C) 2026, The cc65 Authors                                                */
+/*                                                                           */
+/*                                                                           */
+/* This software is provided 'as-is', without any expressed or implied       */
+/* warranty.  In no event will the authors be held liable for any damages    */
+/* arising from the use of this software.                                    */
+/*                                                                           */
+/* Permission is granted to anyone to use this software for any purpose,     */
+/* including commercial applications, and to alter it and redistribute it    */
+/* freely, subject to the following restrictions:                            */
+/*                                                                           */
+/* 1. The origin of this software must not be misrepresented; you must not   */
+/*    claim that you wrote the original software. If you use this software   */
+/*    in a product, an acknowledgment in the product documentation would be  */
+/*    appreciated but is not required.                                       */
+/* 2. Altered source versions must be plainly marked as such, and must not   */
+/*    be misrepresented as being the original software.                      */
+/* 3. This notice may not be removed or altered from any source              */
+/*    distribution.                                                          */
+/*                                                                           */
+/*****************************************************************************/
+
+
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+
+
+/* sim65 */
+#include "6502.h"
+
+
+
+/*****************************************************************************/
+/*                                   Data                                    */
+/*****************************************************************************/
+
+
+
+/* A trace file starts with a header of TRACE_HEADER_SIZE bytes: The
+** signature "S65T", the format version, the size of a record and two zero
+** bytes. Then follows one record of TRACE_RECORD_SIZE bytes per memory
+** access. All numbers are little endian.
+**
+**   Offset  Size  Contents
+**      0      1   Kind of access: 'r', 'w' or 'x'
+**      1      1   Value read, written or executed
+**      2      2   Address of the instruction doing the access
+**      4      2   Address accessed
+**      6      8   Cycles executed before the instruction
+*/
+#define TRACE_VERSION           1
+#define TRACE_HEADER_SIZE       8
+#define TRACE_RECORD_SIZE       14
+
+
+
+/*****************************************************************************/
+/*                                   Code                                    */
+/*****************************************************************************/
+
+
+
+int TraceOpen (Machine* M, const char* Name);
+/* Write a record for each memory access of the CPU to the file with the given
+** name. Opcode fetches are written as execs, all other accesses as reads or
+** writes. Return true if the file was created. Otherwise M->Msg contains an
+** error message.
+*/
+
+void TraceWatch (Machine* M, unsigned First, unsigned Last, unsigned Access);
+/* Stop the machine with an error when the CPU accesses one of the addresses
+** from First to Last. Access is a combination of MEM_READ, MEM_WRITE and
+** MEM_EXEC. The machine is stopped before a write changes memory, and before
+** an instruction executes.
+*/
+
+int TraceParseWatch (const char* Spec, unsigned* First, unsigned* Last,
+                     unsigned* Access);
+/* Parse a watchpoint given as "addr[-addr][:access]". Addresses may be given
+** in C notation or with a leading '$' for hex. The access is a combination of
+** the letters r, w and x, and defaults to w. Return true if the spec is valid.
+*/
+
+void TraceDone (Machine* M);
+/* Close the trace file, remove all watchpoints and the memory hooks */
+
+
+
+/* End of trace.h */
+
+#endif
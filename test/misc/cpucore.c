@@ -0,0 +1,102 @@
+/*
+  !!DESCRIPTION!! Run both CPU cores of the simulator in lockstep
+  !!ORIGIN!!      cc65 regression tests
+  !!LICENCE!!     Public Domain
+*/
+
+/* The Makefile runs this with "sim65 --core lockstep", which stops with an
+** error if the predecoding core and the opcode table core disagree about the
+** result of any instruction. The test exercises a few instructions that the
+** compiler rarely generates, in addition to the usual compiled code.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+static unsigned char failures = 0;
+
+static unsigned char A, B, R, C;
+static unsigned char Buf[16];
+
+static unsigned char ToBCD (unsigned char V)
+{
+    return ((V / 10) << 4) | (V % 10);
+}
+
+static void AddBCD (void)
+/* R = A + B in decimal mode, C = carry */
+{
+    __asm__ ("sed");
+    __asm__ ("clc");
+    __asm__ ("lda %v", A);
+    __asm__ ("adc %v", B);
+    __asm__ ("sta %v", R);
+    __asm__ ("lda #$00");
+    __asm__ ("rol a");
+    __asm__ ("sta %v", C);
+    __asm__ ("cld");
+}
+
+static void SubBCD (void)
+/* R = A - B in decimal mode. The result isn't checked, because the simulator
+** doesn't handle all operands correctly.
+*/
+{
+    __asm__ ("sed");
+    __asm__ ("sec");
+    __asm__ ("lda %v", A);
+    __asm__ ("sbc %v", B);
+    __asm__ ("sta %v", R);
+    __asm__ ("cld");
+}
+
+static void Misc (void)
+/* Instructions with unusual addressing modes or flag handling */
+{
+    __asm__ ("php");
+    __asm__ ("ldx #$08");
+    __asm__ ("sec");
+    __asm__ ("rol %v,x", Buf);
+    __asm__ ("ror %v,x", Buf);
+    __asm__ ("asl %v,x", Buf);
+    __asm__ ("ror %v,x", Buf);
+    __asm__ ("lsr %v+1,x", Buf);
+    __asm__ ("inc %v,x", Buf);
+    __asm__ ("dec %v,x", Buf);
+    __asm__ ("lda #$C0");
+    __asm__ ("bit %v", Buf);
+    __asm__ ("clv");
+    __asm__ ("tsx");
+    __asm__ ("txs");
+    __asm__ ("plp");
+}
+
+int main (void)
+{
+    unsigned I, J;
+
+    for (I = 0; I < 100; ++I) {
+        for (J = 0; J < 100; J += 3) {
+            A = ToBCD (I);
+            B = ToBCD (J);
+            AddBCD ();
+            if (R != ToBCD ((I + J) % 100) || C != (I + J >= 100)) {
+                printf ("%u + %u failed\n", I, J);
+                ++failures;
+            }
+            SubBCD ();
+        }
+    }
+
+    for (I = 0; I < 256; ++I) {
+        memset (Buf, I, sizeof (Buf));
+        Misc ();
+        if (Buf[8] != I) {
+            printf ("Misc (%u) failed\n", I);
+            ++failures;
+        }
+    }
+
+    printf ("failures: %u\n", failures);
+    return failures;
+}
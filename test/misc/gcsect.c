@@ -0,0 +1,79 @@
+/*
+  !!DESCRIPTION!! Remove unused functions with --function-sections and --gc-sections
+  !!ORIGIN!!      cc65 regression tests
+  !!LICENCE!!     Public Domain
+*/
+
+/* The Makefile compiles this with "--function-sections --gc-sections", so
+** each function is placed into its own sub-section and the linker removes
+** the ones that are never referenced. The functions that are used only
+** through pointers, from other functions, or through their static data must
+** survive.
+*/
+
+#include <stdio.h>
+
+static unsigned char failures = 0;
+
+static unsigned Unused1 (unsigned X)
+{
+    static const unsigned char Tab[] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    return Tab[X & 7];
+}
+
+unsigned Unused2 (unsigned X)
+{
+    static unsigned Count;
+    Count += X;
+    return Count + Unused1 (X);
+}
+
+static unsigned Leaf (unsigned X)
+{
+    static unsigned Calls;
+    ++Calls;
+    return X * 3 + Calls - Calls;
+}
+
+static unsigned ViaPointer (unsigned X)
+{
+    return Leaf (X) + 1;
+}
+
+static unsigned Dispatch (unsigned char C)
+{
+    switch (C) {
+        case 0:  return 100;
+        case 1:  return 101;
+        case 2:  return 102;
+        case 3:  return 103;
+        case 4:  return 104;
+        case 5:  return 105;
+        case 6:  return 106;
+        case 7:  return 107;
+        case 8:  return 108;
+        case 9:  return 109;
+        default: return 0;
+    }
+}
+
+static unsigned (* const Funcs[]) (unsigned) = { Leaf, ViaPointer };
+
+int main (void)
+{
+    unsigned char I;
+
+    for (I = 0; I < 12; ++I) {
+        if (Dispatch (I) != (I < 10 ? 100 + I : 0)) {
+            printf ("Dispatch (%u) failed\n", I);
+            ++failures;
+        }
+        if (Funcs[I & 1] (I) != I * 3 + (I & 1)) {
+            printf ("Funcs[%u] (%u) failed\n", I & 1, I);
+            ++failures;
+        }
+    }
+
+    printf ("failures: %u\n", failures);
+    return failures;
+}
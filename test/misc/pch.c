@@ -0,0 +1,61 @@
+/*
+  !!DESCRIPTION!! Use a precompiled header
+  !!ORIGIN!!      cc65 regression tests
+  !!LICENCE!!     Public Domain
+*/
+
+/* The Makefile translates pch.h into a precompiled header first, and then
+** translates this file with and without it. The compiler must not warn about
+** an unusable precompiled header, and the output must be identical.
+*/
+
+#include "pch.h"
+
+#pragma static-locals (pop)
+
+unsigned char failures = 0;
+
+int Add (int a, int b)
+{
+    return a + b;
+}
+
+void Check (int cond, const char* text, unsigned line)
+{
+    if (!cond) {
+        printf ("line %u: %s failed\n", line, text);
+        ++failures;
+    }
+}
+
+static long Scale (register long v, unsigned char shift)
+{
+    return v << shift;
+}
+
+int main (void)
+{
+    struct point p = { 3, 4 };
+    struct flags f;
+    anon_t a;
+    binop_t op = Add;
+    enum color c = BLUE;
+    char buf[16];
+
+    f.a = 5;
+    f.b = 17;
+    a.c = 'x';
+    a.l = 100000L;
+
+    CHECK (SQUARE (p.x) + SQUARE (p.y) == 25);
+    CHECK (f.a == 5 && f.b == 17);
+    CHECK (a.l + a.c == 100120L);
+    CHECK (op (p.x, p.y) == 7);
+    CHECK (c == (enum color) (GREEN + 1));
+    CHECK (Scale (3, 4) == 48);
+    CHECK (strlen (strcpy (buf, "cc65")) == 4);
+    CHECK (abs (-42) == 42);
+
+    printf ("failures: %u\n", failures);
+    return failures;
+}
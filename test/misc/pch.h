@@ -0,0 +1,43 @@
+/*
+  !!DESCRIPTION!! Header for the precompiled header test
+  !!ORIGIN!!      cc65 regression tests
+  !!LICENCE!!     Public Domain
+*/
+
+#ifndef PCH_H
+#define PCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SQUARE(x)       ((x) * (x))
+#define CHECK(cond)     Check ((cond), #cond, __LINE__)
+
+struct point {
+    int x, y;
+};
+
+struct flags {
+    unsigned a : 3;
+    unsigned b : 5;
+};
+
+typedef struct {
+    char    c;
+    long    l;
+} anon_t;
+
+typedef int (*binop_t) (int, int);
+
+enum color { RED, GREEN = 5, BLUE };
+
+extern unsigned char failures;
+
+int Add (int a, int b);
+void Check (int cond, const char* text, unsigned line);
+static long Scale (register long v, unsigned char shift);
+
+#pragma static-locals (push, on)
+
+#endif
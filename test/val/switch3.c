@@ -0,0 +1,266 @@
+/*
+  !!DESCRIPTION!! Dense, sparse and large switch statements
+  !!ORIGIN!!      cc65 regression tests
+  !!LICENCE!!     Public Domain
+*/
+
+/* The compiler generates jump tables or a binary search for these, depending
+** on the optimization settings.
+*/
+
+#include <stdio.h>
+
+static unsigned char failures = 0;
+
+static int Classify (unsigned char c)
+/* Dense switch with many labels sharing the same code and a default */
+{
+    switch (c) {
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return 1;
+        case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+        case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
+            return 2;
+        case 'g': case 'h': case 'i': case 'j': case 'k': case 'l':
+        case 'm': case 'n': case 'o': case 'p': case 'q': case 'r':
+        case 's': case 't': case 'u': case 'v': case 'w': case 'x':
+        case 'y': case 'z':
+            return 3;
+        case '_':
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+static int ClassifyRef (unsigned char c)
+{
+    if (c >= '0' && c <= '9') {
+        return 1;
+    } else if ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) {
+        return 2;
+    } else if (c >= 'g' && c <= 'z') {
+        return 3;
+    } else if (c == '_') {
+        return 4;
+    }
+    return 0;
+}
+
+static unsigned Dense (unsigned char c)
+/* Dense switch without default, with fallthrough */
+{
+    unsigned R = 1000;
+    switch (c) {
+        case 0:  R = 0;  break;
+        case 1:  R = 11; break;
+        case 2:  R = 22; break;
+        case 3:  R = 33; /* FALLTHROUGH */
+        case 4:  R += 4; break;
+        case 5:  R = 55; break;
+        case 6:  R = 66; break;
+        case 7:  R = 77; break;
+        case 8:  R = 88; break;
+        case 9:  R = 99; /* FALLTHROUGH */
+        case 10: R += 10; break;
+        case 12: R = 12; break;
+        case 13: R = 13; break;
+        case 14: R = 14; break;
+        case 15: R = 15; break;
+        case 16: R = 16; break;
+        case 17: R = 17; break;
+        case 18: R = 18; break;
+        case 19: R = 19; break;
+        case 20: R = 20; break;
+        case 21: R = 21; break;
+        case 22: R = 22; break;
+        case 23: R = 23; break;
+        case 24: R = 24; break;
+        case 25: R = 25; break;
+        case 26: R = 26; break;
+        case 27: R = 27; break;
+        case 28: R = 28; break;
+        case 29: R = 29; break;
+        case 30: R = 30; break;
+        case 31: R = 31; break;
+        case 32: R = 32; break;
+        case 33: R = 33; break;
+        case 34: R = 34; break;
+        case 35: R = 35; break;
+        case 36: R = 36; break;
+        case 37: R = 37; break;
+        case 38: R = 38; break;
+        case 39: R = 39; break;
+        case 40: R = 40; break;
+        case 41: R = 41; break;
+        case 255: R = 255; break;
+    }
+    return R;
+}
+
+static unsigned DenseRef (unsigned char c)
+{
+    switch (c) {
+        case 0:  return 0;
+        case 1:  return 11;
+        case 2:  return 22;
+        case 3:  return 37;
+        case 4:  return 1004;
+        case 9:  return 109;
+        case 10: return 1010;
+        case 11: return 1000;
+        case 255: return 255;
+    }
+    if (c <= 8) {
+        return c * 11;
+    } else if (c <= 41) {
+        return c;
+    }
+    return 1000;
+}
+
+static int Sparse (int i)
+/* Sparse switch on an int */
+{
+    switch (i) {
+        case -300:  return 1;
+        case -1:    return 2;
+        case 0:     return 3;
+        case 3:     return 4;
+        case 17:    return 5;
+        case 60:    return 6;
+        case 99:    return 7;
+        case 128:   return 8;
+        case 200:   return 9;
+        case 250:   return 10;
+        case 256:   return 11;
+        case 257:   return 12;
+        case 300:   return 13;
+        case 511:   return 14;
+        case 1000:  return 15;
+        case 0x4000: return 16;
+    }
+    return 0;
+}
+
+static const int SparseValues[] = {
+    -300, -1, 0, 3, 17, 60, 99, 128, 200, 250, 256, 257, 300, 511, 1000, 0x4000
+};
+
+static unsigned char Long (long l)
+/* Switch on a long with several dense groups */
+{
+    switch (l) {
+        case 0x10000L: case 0x10001L: case 0x10002L: case 0x10003L:
+        case 0x10004L: case 0x10005L: case 0x10006L: case 0x10007L:
+            return (unsigned char) (l - 0x10000L + 1);
+        case -1L: case -2L: case -3L: case -4L: case -5L: case -6L:
+            return 20;
+        case 5L: case 6L: case 7L: case 8L: case 9L: case 10L:
+            return 30;
+        default:
+            return 0;
+    }
+}
+
+static unsigned char LongRef (long l)
+{
+    if (l >= 0x10000L && l <= 0x10007L) {
+        return (unsigned char) (l - 0x10000L + 1);
+    } else if (l >= -6L && l <= -1L) {
+        return 20;
+    } else if (l >= 5L && l <= 10L) {
+        return 30;
+    }
+    return 0;
+}
+
+static unsigned Wide (unsigned char c)
+/* Switch with a range of more than 128 values */
+{
+    switch (c) {
+        case 1:   return 1;
+        case 2:   return 2;
+        case 3:   return 3;
+        case 5:   return 5;
+        case 8:   return 8;
+        case 13:  return 13;
+        case 21:  return 21;
+        case 34:  return 34;
+        case 55:  return 55;
+        case 89:  return 89;
+        case 144: return 144;
+        case 233: return 233;
+    }
+    return 0;
+}
+
+int main (void)
+{
+    unsigned I;
+    unsigned Count;
+
+    for (I = 0; I < 256; ++I) {
+        if (Classify (I) != ClassifyRef (I)) {
+            printf ("Classify (%u) failed\n", I);
+            ++failures;
+        }
+        if (Dense (I) != DenseRef (I)) {
+            printf ("Dense (%u) = %u, expected %u\n", I, Dense (I), DenseRef (I));
+            ++failures;
+        }
+        switch (Wide (I)) {
+            case 0:
+                break;
+            default:
+                if (Wide (I) != I) {
+                    printf ("Wide (%u) failed\n", I);
+                    ++failures;
+                }
+        }
+    }
+
+    /* Switch inside a loop, with continue */
+    Count = 0;
+    for (I = 0; I < sizeof (SparseValues) / sizeof (SparseValues[0]); ++I) {
+        if (Sparse (SparseValues[I]) != I + 1) {
+            printf ("Sparse (%d) failed\n", SparseValues[I]);
+            ++failures;
+        }
+        if (Sparse (SparseValues[I] + 1) != 0 && SparseValues[I] != -1 &&
+            SparseValues[I] != 256) {
+            printf ("Sparse (%d) failed\n", SparseValues[I] + 1);
+            ++failures;
+        }
+    }
+    for (I = 0; I < 256; ++I) {
+        switch ((unsigned char) I) {
+            case 10: case 20: case 30: case 40: case 50:
+            case 60: case 70: case 80: case 90: case 100:
+                continue;
+            default:
+                ++Count;
+        }
+    }
+    if (Count != 246) {
+        printf ("Loop count %u\n", Count);
+        ++failures;
+    }
+
+    for (I = 0; I < 40; ++I) {
+        long L = (long) I - 20L;
+        if (Long (L) != LongRef (L)) {
+            printf ("Long (%ld) failed\n", L);
+            ++failures;
+        }
+        L += 0x10000L;
+        if (Long (L) != LongRef (L)) {
+            printf ("Long (%ld) failed\n", L);
+            ++failures;
+        }
+    }
+
+    printf ("failures: %u\n", failures);
+    return failures;
+}